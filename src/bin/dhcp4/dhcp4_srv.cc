@@ -133,6 +133,44 @@ std::set<std::string> dhcp4_statistics = {
     "pkt4-receive-drop"
 };
 
+/// Structure that holds the counters of the statistics updated for each
+/// received or sent packet.
+struct Dhcp4PacketCounters {
+    StatCounterPtr received_;
+    StatCounterPtr discover_received_;
+    StatCounterPtr offer_received_;
+    StatCounterPtr request_received_;
+    StatCounterPtr ack_received_;
+    StatCounterPtr nak_received_;
+    StatCounterPtr release_received_;
+    StatCounterPtr decline_received_;
+    StatCounterPtr inform_received_;
+    StatCounterPtr unknown_received_;
+    StatCounterPtr sent_;
+    StatCounterPtr offer_sent_;
+    StatCounterPtr ack_sent_;
+    StatCounterPtr nak_sent_;
+
+    /// Constructor that gets the counters from the statistics manager
+    Dhcp4PacketCounters() {
+        StatsMgr& stats_mgr = StatsMgr::instance();
+        received_          = stats_mgr.getCounter("pkt4-received");
+        discover_received_ = stats_mgr.getCounter("pkt4-discover-received");
+        offer_received_    = stats_mgr.getCounter("pkt4-offer-received");
+        request_received_  = stats_mgr.getCounter("pkt4-request-received");
+        ack_received_      = stats_mgr.getCounter("pkt4-ack-received");
+        nak_received_      = stats_mgr.getCounter("pkt4-nak-received");
+        release_received_  = stats_mgr.getCounter("pkt4-release-received");
+        decline_received_  = stats_mgr.getCounter("pkt4-decline-received");
+        inform_received_   = stats_mgr.getCounter("pkt4-inform-received");
+        unknown_received_  = stats_mgr.getCounter("pkt4-unknown-received");
+        sent_              = stats_mgr.getCounter("pkt4-sent");
+        offer_sent_        = stats_mgr.getCounter("pkt4-offer-sent");
+        ack_sent_          = stats_mgr.getCounter("pkt4-ack-sent");
+        nak_sent_          = stats_mgr.getCounter("pkt4-nak-sent");
+    }
+};
+
 } // end of anonymous namespace
 
 // Declare a Hooks object. As this is outside any function or method, it
@@ -141,6 +179,10 @@ std::set<std::string> dhcp4_statistics = {
 // module is called.
 Dhcp4Hooks Hooks;
 
+// Declare the packet statistic counters in the same way. The counters are
+// incremented without locking the statistics manager.
+Dhcp4PacketCounters Counters;
+
 
 namespace isc {
 namespace dhcp {
@@ -557,7 +599,7 @@ void Dhcpv4Exchange::evaluateClasses(const Pkt4Ptr& pkt, bool depend_on_known) {
     for (ClientClassDefList::const_iterator it = defs_ptr->cbegin();
          it != defs_ptr->cend(); ++it) {
         // Note second cannot be null
-        const ExpressionPtr& expr_ptr = (*it)->getMatchExpr();
+        const CompiledExpressionPtr& expr_ptr = (*it)->getCompiledMatchExpr();
         // Nothing to do without an expression to evaluate
         if (!expr_ptr) {
             continue;
@@ -1081,8 +1123,7 @@ Dhcpv4Srv::processPacket(Pkt4Ptr& query, Pkt4Ptr& rsp, bool allow_packet_park) {
     // failures in unpacking will cause the packet to be dropped. We
     // will increase type specific statistic further down the road.
     // See processStatsReceived().
-    isc::stats::StatsMgr::instance().addValue("pkt4-received",
-                                              static_cast<int64_t>(1));
+    Counters.received_->add();
 
     bool skip_unpack = false;
 
@@ -3181,6 +3222,9 @@ Dhcpv4Srv::processRelease(Pkt4Ptr& release, AllocEngine::ClientContext4Ptr& cont
 
             if (success) {
 
+                // The released lease can be allocated again.
+                alloc_engine_->leaseFreed(lease);
+
                 context.reset(new AllocEngine::ClientContext4());
                 context->old_lease_ = lease;
 
@@ -3747,7 +3791,8 @@ void Dhcpv4Srv::requiredClassify(Dhcpv4Exchange& ex) {
                 .arg(*cclass);
             continue;
         }
-        const ExpressionPtr& expr_ptr = class_def->getMatchExpr();
+        const CompiledExpressionPtr& expr_ptr =
+            class_def->getCompiledMatchExpr();
         // Nothing to do without an expression to evaluate
         if (!expr_ptr) {
             LOG_DEBUG(dhcp4_logger, DBG_DHCP4_BASIC, DHCP4_CLASS_UNTESTABLE)
@@ -3921,35 +3966,35 @@ void Dhcpv4Srv::processStatsReceived(const Pkt4Ptr& query) {
     // Note that we're not bumping pkt4-received statistic as it was
     // increased early in the packet reception code.
 
-    string stat_name = "pkt4-unknown-received";
+    StatCounter* counter = Counters.unknown_received_.get();
     try {
         switch (query->getType()) {
         case DHCPDISCOVER:
-            stat_name = "pkt4-discover-received";
+            counter = Counters.discover_received_.get();
             break;
         case DHCPOFFER:
             // Should not happen, but let's keep a counter for it
-            stat_name = "pkt4-offer-received";
+            counter = Counters.offer_received_.get();
             break;
         case DHCPREQUEST:
-            stat_name = "pkt4-request-received";
+            counter = Counters.request_received_.get();
             break;
         case DHCPACK:
             // Should not happen, but let's keep a counter for it
-            stat_name = "pkt4-ack-received";
+            counter = Counters.ack_received_.get();
             break;
         case DHCPNAK:
             // Should not happen, but let's keep a counter for it
-            stat_name = "pkt4-nak-received";
+            counter = Counters.nak_received_.get();
             break;
         case DHCPRELEASE:
-            stat_name = "pkt4-release-received";
+            counter = Counters.release_received_.get();
         break;
         case DHCPDECLINE:
-            stat_name = "pkt4-decline-received";
+            counter = Counters.decline_received_.get();
             break;
         case DHCPINFORM:
-            stat_name = "pkt4-inform-received";
+            counter = Counters.inform_received_.get();
             break;
         default:
             ; // do nothing
@@ -3962,34 +4007,31 @@ void Dhcpv4Srv::processStatsReceived(const Pkt4Ptr& query) {
         // name of pkt4-unknown-received.
     }
 
-    isc::stats::StatsMgr::instance().addValue(stat_name,
-                                              static_cast<int64_t>(1));
+    counter->add();
 }
 
 void Dhcpv4Srv::processStatsSent(const Pkt4Ptr& response) {
     // Increase generic counter for sent packets.
-    isc::stats::StatsMgr::instance().addValue("pkt4-sent",
-                                              static_cast<int64_t>(1));
+    Counters.sent_->add();
 
     // Increase packet type specific counter for packets sent.
-    string stat_name;
+    StatCounter* counter = 0;
     switch (response->getType()) {
     case DHCPOFFER:
-        stat_name = "pkt4-offer-sent";
+        counter = Counters.offer_sent_.get();
         break;
     case DHCPACK:
-        stat_name = "pkt4-ack-sent";
+        counter = Counters.ack_sent_.get();
         break;
     case DHCPNAK:
-        stat_name = "pkt4-nak-sent";
+        counter = Counters.nak_sent_.get();
         break;
     default:
         // That should never happen
         return;
     }
 
-    isc::stats::StatsMgr::instance().addValue(stat_name,
-                                              static_cast<int64_t>(1));
+    counter->add();
 }
 
 int Dhcpv4Srv::getHookIndexBuffer4Receive() {
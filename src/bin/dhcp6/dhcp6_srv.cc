@@ -199,6 +199,63 @@ std::set<std::string> dhcp6_statistics = {
     "pkt6-receive-drop"
 };
 
+/// Structure that holds the counters of the statistics updated for each
+/// received or sent packet.
+struct Dhcp6PacketCounters {
+    StatCounterPtr received_;
+    StatCounterPtr solicit_received_;
+    StatCounterPtr advertise_received_;
+    StatCounterPtr request_received_;
+    StatCounterPtr confirm_received_;
+    StatCounterPtr renew_received_;
+    StatCounterPtr rebind_received_;
+    StatCounterPtr reply_received_;
+    StatCounterPtr release_received_;
+    StatCounterPtr decline_received_;
+    StatCounterPtr reconfigure_received_;
+    StatCounterPtr infrequest_received_;
+    StatCounterPtr dhcpv4_query_received_;
+    StatCounterPtr dhcpv4_response_received_;
+    StatCounterPtr unknown_received_;
+    StatCounterPtr sent_;
+    StatCounterPtr advertise_sent_;
+    StatCounterPtr reply_sent_;
+    StatCounterPtr dhcpv4_response_sent_;
+
+    /// Constructor that gets the counters from the statistics manager
+    Dhcp6PacketCounters() {
+        StatsMgr& stats_mgr = StatsMgr::instance();
+        received_ = stats_mgr.getCounter("pkt6-received");
+        solicit_received_ = stats_mgr.getCounter("pkt6-solicit-received");
+        advertise_received_ = stats_mgr.getCounter("pkt6-advertise-received");
+        request_received_ = stats_mgr.getCounter("pkt6-request-received");
+        confirm_received_ = stats_mgr.getCounter("pkt6-confirm-received");
+        renew_received_ = stats_mgr.getCounter("pkt6-renew-received");
+        rebind_received_ = stats_mgr.getCounter("pkt6-rebind-received");
+        reply_received_ = stats_mgr.getCounter("pkt6-reply-received");
+        release_received_ = stats_mgr.getCounter("pkt6-release-received");
+        decline_received_ = stats_mgr.getCounter("pkt6-decline-received");
+        reconfigure_received_ =
+            stats_mgr.getCounter("pkt6-reconfigure-received");
+        infrequest_received_ = stats_mgr.getCounter("pkt6-infrequest-received");
+        dhcpv4_query_received_ =
+            stats_mgr.getCounter("pkt6-dhcpv4-query-received");
+        dhcpv4_response_received_ =
+            stats_mgr.getCounter("pkt6-dhcpv4-response-received");
+        unknown_received_ = stats_mgr.getCounter("pkt6-unknown-received");
+        sent_ = stats_mgr.getCounter("pkt6-sent");
+        advertise_sent_ = stats_mgr.getCounter("pkt6-advertise-sent");
+        reply_sent_ = stats_mgr.getCounter("pkt6-reply-sent");
+        dhcpv4_response_sent_ =
+            stats_mgr.getCounter("pkt6-dhcpv4-response-sent");
+    }
+};
+
+// Declare the packet statistic counters. As for the Hooks object, the
+// constructor is run when the module is loaded. The counters are
+// incremented without locking the statistics manager.
+Dhcp6PacketCounters Counters;
+
 }  // namespace
 
 namespace isc {
@@ -564,7 +621,7 @@ void Dhcpv6Srv::run_one() {
             // any failures in unpacking will cause the packet to be dropped.
             // we will increase type specific packets further down the road.
             // See processStatsReceived().
-            StatsMgr::instance().addValue("pkt6-received", static_cast<int64_t>(1));
+            Counters.received_->add();
         }
 
         // We used to log that the wait was interrupted, but this is no longer
@@ -2823,6 +2880,10 @@ Dhcpv6Srv::releaseIA_NA(const DuidPtr& duid, const Pkt6Ptr& query,
 
     if (!skip) {
         success = LeaseMgrFactory::instance().deleteLease(lease);
+        if (success) {
+            // The released lease can be allocated again.
+            alloc_engine_->leaseFreed(lease);
+        }
     }
 
     // Here the success should be true if we removed lease successfully
@@ -2981,6 +3042,10 @@ Dhcpv6Srv::releaseIA_PD(const DuidPtr& duid, const Pkt6Ptr& query,
 
     if (!skip) {
         success = LeaseMgrFactory::instance().deleteLease(lease);
+        if (success) {
+            // The released lease can be allocated again.
+            alloc_engine_->leaseFreed(lease);
+        }
     } else {
         // Callouts decided to skip the next processing step. The next
         // processing step would to send the packet, so skip at this
@@ -3709,7 +3774,7 @@ void Dhcpv6Srv::evaluateClasses(const Pkt6Ptr& pkt, bool depend_on_known) {
     for (ClientClassDefList::const_iterator it = defs_ptr->cbegin();
          it != defs_ptr->cend(); ++it) {
         // Note second cannot be null
-        const ExpressionPtr& expr_ptr = (*it)->getMatchExpr();
+        const CompiledExpressionPtr& expr_ptr = (*it)->getCompiledMatchExpr();
         // Nothing to do without an expression to evaluate
         if (!expr_ptr) {
             continue;
@@ -3839,7 +3904,8 @@ Dhcpv6Srv::requiredClassify(const Pkt6Ptr& pkt, AllocEngine::ClientContext6& ctx
                 .arg(*cclass);
             continue;
         }
-        const ExpressionPtr& expr_ptr = class_def->getMatchExpr();
+        const CompiledExpressionPtr& expr_ptr =
+            class_def->getCompiledMatchExpr();
         // Nothing to do without an expression to evaluate
         if (!expr_ptr) {
             LOG_DEBUG(dhcp6_logger, DBG_DHCP6_BASIC, DHCP6_CLASS_UNTESTABLE)
@@ -4105,79 +4171,79 @@ void Dhcpv6Srv::processStatsReceived(const Pkt6Ptr& query) {
     // Note that we're not bumping pkt6-received statistic as it was
     // increased early in the packet reception code.
 
-    string stat_name = "pkt6-unknown-received";
+    StatCounter* counter = Counters.unknown_received_.get();
     switch (query->getType()) {
     case DHCPV6_SOLICIT:
-        stat_name = "pkt6-solicit-received";
+        counter = Counters.solicit_received_.get();
         break;
     case DHCPV6_ADVERTISE:
         // Should not happen, but let's keep a counter for it
-        stat_name = "pkt6-advertise-received";
+        counter = Counters.advertise_received_.get();
         break;
     case DHCPV6_REQUEST:
-        stat_name = "pkt6-request-received";
+        counter = Counters.request_received_.get();
         break;
     case DHCPV6_CONFIRM:
-        stat_name = "pkt6-confirm-received";
+        counter = Counters.confirm_received_.get();
         break;
     case DHCPV6_RENEW:
-        stat_name = "pkt6-renew-received";
+        counter = Counters.renew_received_.get();
         break;
     case DHCPV6_REBIND:
-        stat_name = "pkt6-rebind-received";
+        counter = Counters.rebind_received_.get();
         break;
     case DHCPV6_REPLY:
         // Should not happen, but let's keep a counter for it
-        stat_name = "pkt6-reply-received";
+        counter = Counters.reply_received_.get();
         break;
     case DHCPV6_RELEASE:
-        stat_name = "pkt6-release-received";
+        counter = Counters.release_received_.get();
         break;
     case DHCPV6_DECLINE:
-        stat_name = "pkt6-decline-received";
+        counter = Counters.decline_received_.get();
         break;
     case DHCPV6_RECONFIGURE:
-        stat_name = "pkt6-reconfigure-received";
+        counter = Counters.reconfigure_received_.get();
         break;
     case DHCPV6_INFORMATION_REQUEST:
-        stat_name = "pkt6-infrequest-received";
+        counter = Counters.infrequest_received_.get();
         break;
     case DHCPV6_DHCPV4_QUERY:
-        stat_name = "pkt6-dhcpv4-query-received";
+        counter = Counters.dhcpv4_query_received_.get();
         break;
     case DHCPV6_DHCPV4_RESPONSE:
         // Should not happen, but let's keep a counter for it
-        stat_name = "pkt6-dhcpv4-response-received";
+        counter = Counters.dhcpv4_response_received_.get();
         break;
     default:
             ; // do nothing
     }
 
-    StatsMgr::instance().addValue(stat_name, static_cast<int64_t>(1));
+    counter->add();
 }
 
 void Dhcpv6Srv::processStatsSent(const Pkt6Ptr& response) {
     // Increase generic counter for sent packets.
-    StatsMgr::instance().addValue("pkt6-sent", static_cast<int64_t>(1));
+    Counters.sent_->add();
 
     // Increase packet type specific counter for packets sent.
-    string stat_name;
+    StatCounter* counter = 0;
     switch (response->getType()) {
     case DHCPV6_ADVERTISE:
-        stat_name = "pkt6-advertise-sent";
+        counter = Counters.advertise_sent_.get();
         break;
     case DHCPV6_REPLY:
-        stat_name = "pkt6-reply-sent";
+        counter = Counters.reply_sent_.get();
         break;
     case DHCPV6_DHCPV4_RESPONSE:
-        stat_name = "pkt6-dhcpv4-response-sent";
+        counter = Counters.dhcpv4_response_sent_.get();
         break;
     default:
         // That should never happen
         return;
     }
 
-    StatsMgr::instance().addValue(stat_name, static_cast<int64_t>(1));
+    counter->add();
 }
 
 int Dhcpv6Srv::getHookIndexBuffer6Send() {
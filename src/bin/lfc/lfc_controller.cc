@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,6 +13,7 @@
 #include <exceptions/exceptions.h>
 #include <dhcpsrv/csv_lease_file4.h>
 #include <dhcpsrv/csv_lease_file6.h>
+#include <dhcpsrv/lease_journal.h>
 #include <dhcpsrv/memfile_lease_mgr.h>
 #include <dhcpsrv/memfile_lease_storage.h>
 #include <dhcpsrv/lease_mgr.h>
@@ -52,7 +53,8 @@ const char* LFCController::lfc_bin_name_ = "kea-lfc";
 
 LFCController::LFCController()
     : protocol_version_(0), verbose_(false), config_file_(""), previous_file_(""),
-      copy_file_(""), output_file_(""), finish_file_(""), pid_file_("") {
+      copy_file_(""), output_file_(""), finish_file_(""), pid_file_(""),
+      convert_format_("") {
 }
 
 LFCController::~LFCController() {
@@ -82,6 +84,30 @@ LFCController::launch(int argc, char* argv[], const bool test_mode) {
 
     LOG_INFO(lfc_logger, LFC_START);
 
+    // In the conversion mode only the output file is written so there
+    // is neither a PID file nor files to rotate.
+    if (!convert_format_.empty()) {
+        LOG_INFO(lfc_logger, LFC_CONVERTING)
+          .arg(copy_file_)
+          .arg(output_file_)
+          .arg(convert_format_);
+
+        try {
+            if (getProtocolVersion() == 4) {
+                convertLeases<Lease4, CSVLeaseFile4, LeaseJournal4,
+                              Lease4Storage>();
+            } else {
+                convertLeases<Lease6, CSVLeaseFile6, LeaseJournal6,
+                              Lease6Storage>();
+            }
+        } catch (const std::exception& conv_ex) {
+            LOG_FATAL(lfc_logger, LFC_FAIL_CONVERT).arg(conv_ex.what());
+        }
+
+        LOG_INFO(lfc_logger, LFC_TERMINATE);
+        return;
+    }
+
     // verify we are the only instance
     PIDFile pid_file(pid_file_);
 
@@ -110,9 +136,11 @@ LFCController::launch(int argc, char* argv[], const bool test_mode) {
 
         try {
             if (getProtocolVersion() == 4) {
-                processLeases<Lease4, CSVLeaseFile4, Lease4Storage>();
+                processLeases<Lease4, CSVLeaseFile4, LeaseJournal4,
+                              Lease4Storage>();
             } else {
-                processLeases<Lease6, CSVLeaseFile6, Lease6Storage>();
+                processLeases<Lease6, CSVLeaseFile6, LeaseJournal6,
+                              Lease6Storage>();
             }
         } catch (const std::exception& proc_ex) {
             // We don't want to do the cleanup but do want to get rid of the pid
@@ -151,7 +179,7 @@ LFCController::parseArgs(int argc, char* argv[]) {
 
     opterr = 0;
     optind = 1;
-    while ((ch = getopt(argc, argv, ":46dhvVWp:x:i:o:c:f:")) != -1) {
+    while ((ch = getopt(argc, argv, ":46dhvVWp:x:i:o:c:f:t:")) != -1) {
         switch (ch) {
         case '4':
             // Process DHCPv4 lease files.
@@ -231,6 +259,18 @@ LFCController::parseArgs(int argc, char* argv[]) {
             config_file_ = optarg;
             break;
 
+        case 't':
+            // Format of the converted lease file.
+            if (optarg == NULL) {
+                isc_throw(InvalidUsage, "Conversion format missing");
+            }
+            convert_format_ = optarg;
+            if ((convert_format_ != "csv") && (convert_format_ != "journal")) {
+                isc_throw(InvalidUsage, "Invalid conversion format: "
+                          << convert_format_);
+            }
+            break;
+
         case 'h':
             usage("");
             exit(EXIT_SUCCESS);
@@ -260,11 +300,12 @@ LFCController::parseArgs(int argc, char* argv[]) {
         isc_throw(InvalidUsage, "DHCP version required");
     }
 
-    if (pid_file_.empty()) {
+    // The conversion mode only uses the copy and output files.
+    if (pid_file_.empty() && convert_format_.empty()) {
         isc_throw(InvalidUsage, "PID file not specified");
     }
 
-    if (previous_file_.empty()) {
+    if (previous_file_.empty() && convert_format_.empty()) {
         isc_throw(InvalidUsage, "Previous file not specified");
     }
 
@@ -276,16 +317,22 @@ LFCController::parseArgs(int argc, char* argv[]) {
         isc_throw(InvalidUsage, "Output file not specified");
     }
 
-    if (finish_file_.empty()) {
+    if (finish_file_.empty() && convert_format_.empty()) {
         isc_throw(InvalidUsage, "Finish file not specified");
     }
 
-    if (config_file_.empty()) {
+    if (config_file_.empty() && convert_format_.empty()) {
         isc_throw(InvalidUsage, "Config file not specified");
     }
 
     // If verbose is set echo the input information
-    if (verbose_) {
+    if (verbose_ && !convert_format_.empty()) {
+        std::cout << "Protocol version:    DHCPv" << protocol_version_ << std::endl
+                  << "Input lease file:          " << copy_file_ << std::endl
+                  << "Output lease file:         " << output_file_ << std::endl
+                  << "Conversion format:         " << convert_format_ << std::endl
+                  << std::endl;
+    } else if (verbose_) {
         std::cout << "Protocol version:    DHCPv" << protocol_version_ << std::endl
                   << "Previous or ex lease file: " << previous_file_ << std::endl
                   << "Copy lease file:           " << copy_file_ << std::endl
@@ -305,6 +352,7 @@ LFCController::usage(const std::string& text) {
 
     std::cerr << "Usage: " << lfc_bin_name_ << std::endl
               << " [-4|-6] -p file -x file -i file -o file -f file -c file" << std::endl
+              << " [-4|-6] -t csv|journal -i file -o file" << std::endl
               << "   -4 or -6 clean a set of v4 or v6 lease files" << std::endl
               << "   -p <file>: PID file" << std::endl
               << "   -x <file>: previous or ex lease file" << std::endl
@@ -312,6 +360,8 @@ LFCController::usage(const std::string& text) {
               << "   -o <file>: output lease file" << std::endl
               << "   -f <file>: finish file" << std::endl
               << "   -c <file>: configuration file" << std::endl
+              << "   -t <format>: convert the lease file given with -i to the"
+              << " output file in the csv or journal format" << std::endl
               << "   -v: print version number and exit" << std::endl
               << "   -V: print extended version information and exit" << std::endl
               << "   -d: optional, verbose output " << std::endl
@@ -332,39 +382,81 @@ LFCController::getVersion(const bool extended) const{
     return (version_stream.str());
 }
 
-template<typename LeaseObjectType, typename LeaseFileType, typename StorageType>
+template<typename LeaseObjectType, typename CSVLeaseFileType,
+         typename LeaseJournalType, typename StorageType>
+boost::shared_ptr<LeaseFile<LeaseObjectType> >
+LFCController::readLeases(const std::string& filename,
+                          StorageType& storage) const {
+    boost::shared_ptr<LeaseFile<LeaseObjectType> > lease_file;
+    if (LeaseJournal::isJournal(filename)) {
+        boost::shared_ptr<LeaseJournalType> journal(new LeaseJournalType(filename));
+        LeaseFileLoader::load<LeaseObjectType>(*journal, storage,
+                                               MAX_LEASE_ERRORS);
+        lease_file = journal;
+
+    } else {
+        boost::shared_ptr<CSVLeaseFileType> csv_file(new CSVLeaseFileType(filename));
+        if (csv_file->exists()) {
+            LeaseFileLoader::load<LeaseObjectType>(*csv_file, storage,
+                                                   MAX_LEASE_ERRORS);
+        }
+        lease_file = csv_file;
+    }
+    return (lease_file);
+}
+
+template<typename LeaseObjectType, typename CSVLeaseFileType,
+         typename LeaseJournalType, typename StorageType>
+boost::shared_ptr<LeaseFile<LeaseObjectType> >
+LFCController::writeLeases(const std::string& filename,
+                           const StorageType& storage,
+                           const bool journal) const {
+    if (journal) {
+        boost::shared_ptr<LeaseJournalType> lease_journal(new LeaseJournalType(filename));
+        LeaseFileLoader::write<LeaseObjectType>(*lease_journal, storage);
+        return (lease_journal);
+    }
+
+    boost::shared_ptr<CSVLeaseFileType> csv_file(new CSVLeaseFileType(filename));
+    LeaseFileLoader::write<LeaseObjectType>(*csv_file, storage);
+    return (csv_file);
+}
+
+template<typename LeaseObjectType, typename CSVLeaseFileType,
+         typename LeaseJournalType, typename StorageType>
 void
 LFCController::processLeases() const {
     StorageType storage;
 
     // If a previous file exists read the entries into storage
-    LeaseFileType lf_prev(getPreviousFile());
-    if (lf_prev.exists()) {
-        LeaseFileLoader::load<LeaseObjectType>(lf_prev, storage,
-                                               MAX_LEASE_ERRORS);
-    }
+    boost::shared_ptr<LeaseFile<LeaseObjectType> > lf_prev =
+        readLeases<LeaseObjectType, CSVLeaseFileType,
+                   LeaseJournalType>(getPreviousFile(), storage);
 
     // Follow that with the copy of the current lease file
-    LeaseFileType lf_copy(getCopyFile());
-    if (lf_copy.exists()) {
-        LeaseFileLoader::load<LeaseObjectType>(lf_copy, storage,
-                                               MAX_LEASE_ERRORS);
-    }
-
-    // Write the result out to the output file
-    LeaseFileType lf_output(getOutputFile());
-    LeaseFileLoader::write<LeaseObjectType>(lf_output, storage);
+    boost::shared_ptr<LeaseFile<LeaseObjectType> > lf_copy =
+        readLeases<LeaseObjectType, CSVLeaseFileType,
+                   LeaseJournalType>(getCopyFile(), storage);
+
+    // Write the result out to the output file. It is written in the format
+    // of the copy of the lease file, i.e. the format used by the server, so
+    // as the previous file is converted when the server switches formats.
+    bool journal = LeaseJournal::isJournal(getCopyFile()) ||
+        (!lf_copy->exists() && LeaseJournal::isJournal(getPreviousFile()));
+    boost::shared_ptr<LeaseFile<LeaseObjectType> > lf_output =
+        writeLeases<LeaseObjectType, CSVLeaseFileType,
+                    LeaseJournalType>(getOutputFile(), storage, journal);
 
     // If desired log the stats
     LOG_INFO(lfc_logger, LFC_READ_STATS)
-      .arg(lf_prev.getReadLeases() + lf_copy.getReadLeases())
-      .arg(lf_prev.getReads() + lf_copy.getReads())
-      .arg(lf_prev.getReadErrs() + lf_copy.getReadErrs());
+      .arg(lf_prev->getReadLeases() + lf_copy->getReadLeases())
+      .arg(lf_prev->getReads() + lf_copy->getReads())
+      .arg(lf_prev->getReadErrs() + lf_copy->getReadErrs());
 
     LOG_INFO(lfc_logger, LFC_WRITE_STATS)
-      .arg(lf_output.getWriteLeases())
-      .arg(lf_output.getWrites())
-      .arg(lf_output.getWriteErrs());
+      .arg(lf_output->getWriteLeases())
+      .arg(lf_output->getWrites())
+      .arg(lf_output->getWriteErrs());
 
     // Once we've finished the output file move it to the complete file
     if (rename(getOutputFile().c_str(), getFinishFile().c_str()) != 0) {
@@ -374,6 +466,42 @@ LFCController::processLeases() const {
     }
 }
 
+template<typename LeaseObjectType, typename CSVLeaseFileType,
+         typename LeaseJournalType, typename StorageType>
+void
+LFCController::convertLeases() const {
+    // Don't append the leases to an existing file.
+    CSVFile lf_check(getOutputFile());
+    if (lf_check.exists()) {
+        isc_throw(RunTimeFail, "Output file (" << output_file_
+                  << ") already exists");
+    }
+
+    StorageType storage;
+    boost::shared_ptr<LeaseFile<LeaseObjectType> > lf_input =
+        readLeases<LeaseObjectType, CSVLeaseFileType,
+                   LeaseJournalType>(getCopyFile(), storage);
+    if (!lf_input->exists()) {
+        isc_throw(RunTimeFail, "Input file (" << copy_file_
+                  << ") doesn't exist");
+    }
+
+    boost::shared_ptr<LeaseFile<LeaseObjectType> > lf_output =
+        writeLeases<LeaseObjectType, CSVLeaseFileType,
+                    LeaseJournalType>(getOutputFile(), storage,
+                                      convert_format_ == "journal");
+
+    LOG_INFO(lfc_logger, LFC_READ_STATS)
+      .arg(lf_input->getReadLeases())
+      .arg(lf_input->getReads())
+      .arg(lf_input->getReadErrs());
+
+    LOG_INFO(lfc_logger, LFC_WRITE_STATS)
+      .arg(lf_output->getWriteLeases())
+      .arg(lf_output->getWrites())
+      .arg(lf_output->getWriteErrs());
+}
+
 void
 LFCController::fileRotate() const {
     // Remove the old previous file
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2018 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,7 +7,9 @@
 #ifndef LFC_CONTROLLER_H
 #define LFC_CONTROLLER_H
 
+#include <dhcpsrv/lease_file.h>
 #include <exceptions/exceptions.h>
+#include <boost/shared_ptr.hpp>
 #include <string>
 
 namespace isc {
@@ -34,6 +36,13 @@ public:
 /// manage the command line, check for already running instances,
 /// invoke the code to process the lease files and finally to rename
 /// the lease files as necessary.
+///
+/// The lease files may be CSV lease files or binary lease journals. The
+/// format of each input file is detected from its content and the output
+/// file is written in the format of the copy of the lease file, i.e. the
+/// format currently used by the server. The controller also provides a
+/// conversion mode, selected with the -t option, which converts a lease
+/// file into the specified format without rotating the files.
 class LFCController {
 public:
     /// @brief Defines the application name, it may be used to locate
@@ -75,6 +84,10 @@ public:
     /// have a default value to force test implementers to enable test
     /// mode explicitly.
     ///
+    /// In the conversion mode the leases are read from the copy file
+    /// and written to the output file in the specified format. The PID,
+    /// previous, finish and configuration files are not used.
+    ///
     /// @throw InvalidUsage if the command line parameters are invalid.
     void launch(int argc, char* argv[], const bool test_mode);
 
@@ -150,6 +163,14 @@ public:
     std::string getPidFile() const {
         return (pid_file_);
     }
+
+    /// @brief Gets the format of the converted lease file
+    ///
+    /// @return Returns "csv" or "journal" in the conversion mode and
+    /// an empty string otherwise.
+    std::string getConvertFormat() const {
+        return (convert_format_);
+    }
     //@}
 
 private:
@@ -163,6 +184,7 @@ private:
     std::string output_file_;   ///< The path to the output file
     std::string finish_file_;   ///< The path to the finished output file
     std::string pid_file_;      ///< The path to the pid file
+    std::string convert_format_; ///< The format of the converted file
 
     /// @brief Prints the program usage text to std error.
     ///
@@ -183,13 +205,58 @@ private:
     /// the write move the file to the finish file.
     ///
     /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
-    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam CSVLeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseJournalType A @c LeaseJournal4 or @c LeaseJournal6.
     /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
     ///
     /// @throw RunTimeFail if we can't move the file.
-    template<typename LeaseObjectType, typename LeaseFileType, typename StorageType>
+    template<typename LeaseObjectType, typename CSVLeaseFileType,
+             typename LeaseJournalType, typename StorageType>
     void processLeases() const;
 
+    /// @brief Convert a lease file.
+    ///
+    /// Read in the leases from the copy file and write them out to
+    /// the output file in the format specified with the -t option.
+    ///
+    /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+    /// @tparam CSVLeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseJournalType A @c LeaseJournal4 or @c LeaseJournal6.
+    /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
+    ///
+    /// @throw RunTimeFail if the copy file doesn't exist or the output
+    /// file exists.
+    template<typename LeaseObjectType, typename CSVLeaseFileType,
+             typename LeaseJournalType, typename StorageType>
+    void convertLeases() const;
+
+    /// @brief Read leases from a CSV lease file or a lease journal.
+    ///
+    /// @param filename The path to the lease file.
+    /// @param storage The storage receiving the leases.
+    ///
+    /// @return Returns the object representing the lease file, which
+    /// holds the read statistics.
+    template<typename LeaseObjectType, typename CSVLeaseFileType,
+             typename LeaseJournalType, typename StorageType>
+    boost::shared_ptr<dhcp::LeaseFile<LeaseObjectType> >
+    readLeases(const std::string& filename, StorageType& storage) const;
+
+    /// @brief Write leases to a CSV lease file or a lease journal.
+    ///
+    /// @param filename The path to the lease file.
+    /// @param storage The storage holding the leases.
+    /// @param journal A boolean value which indicates if the leases are
+    /// written to a lease journal (if true) or a CSV lease file.
+    ///
+    /// @return Returns the object representing the lease file, which
+    /// holds the write statistics.
+    template<typename LeaseObjectType, typename CSVLeaseFileType,
+             typename LeaseJournalType, typename StorageType>
+    boost::shared_ptr<dhcp::LeaseFile<LeaseObjectType> >
+    writeLeases(const std::string& filename, const StorageType& storage,
+                const bool journal) const;
+
     ///@brief Start up the logging system
     ///
     /// @param test_mode indicates if we have have been started from the test
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,11 +7,13 @@
 #include <config.h>
 
 #include <lfc/lfc_controller.h>
+#include <dhcpsrv/lease_journal.h>
 #include <util/csv_file.h>
 #include <gtest/gtest.h>
 #include <fstream>
 #include <cerrno>
 
+using namespace isc::dhcp;
 using namespace isc::lfc;
 using namespace std;
 
@@ -145,6 +147,7 @@ TEST_F(LFCControllerTest, initialValues) {
     EXPECT_TRUE(lfc_controller.getOutputFile().empty());
     EXPECT_TRUE(lfc_controller.getFinishFile().empty());
     EXPECT_TRUE(lfc_controller.getPidFile().empty());
+    EXPECT_TRUE(lfc_controller.getConvertFormat().empty());
 }
 
 /// @todo verify that parsing -v/V/W/h works well without ASSERT_EXIT
@@ -220,6 +223,41 @@ TEST_F(LFCControllerTest, notEnoughData) {
     ASSERT_NO_THROW(lfc_controller.parseArgs(argc, argv));
 }
 
+/// @brief Verify that parsing the conversion command line works.
+/// The conversion mode only requires the copy and output files.
+TEST_F(LFCControllerTest, convertCommandLine) {
+    LFCController lfc_controller;
+
+    char* argv[] = { const_cast<char*>("progName"),
+                     const_cast<char*>("-6"),
+                     const_cast<char*>("-t"),
+                     const_cast<char*>("journal"),
+                     const_cast<char*>("-i"),
+                     const_cast<char*>("copy"),
+                     const_cast<char*>("-o"),
+                     const_cast<char*>("output") };
+    int argc = 8;
+
+    ASSERT_NO_THROW(lfc_controller.parseArgs(argc, argv));
+    EXPECT_EQ(lfc_controller.getProtocolVersion(), 6);
+    EXPECT_EQ(lfc_controller.getConvertFormat(), "journal");
+    EXPECT_EQ(lfc_controller.getCopyFile(), "copy");
+    EXPECT_EQ(lfc_controller.getOutputFile(), "output");
+    EXPECT_TRUE(lfc_controller.getPidFile().empty());
+
+    // The output file is required.
+    for (argc = 1; argc < 8; ++argc) {
+        LFCController lfc_partial;
+        EXPECT_THROW(lfc_partial.parseArgs(argc, argv), InvalidUsage)
+            << "test failed for argc = " << argc;
+    }
+
+    // The format must be csv or journal.
+    LFCController lfc_invalid;
+    argv[3] = const_cast<char*>("xml");
+    EXPECT_THROW(lfc_invalid.parseArgs(argc, argv), InvalidUsage);
+}
+
 /// @brief Verify that extra arguments cause the parse to fail.
 /// Parse a full command line plus some extra arguments on the end
 /// to verify that we don't stop parsing when we find all of the
@@ -670,6 +708,78 @@ TEST_F(LFCControllerTest, launch6) {
     EXPECT_TRUE(noExistIOFP());
 }
 
+/// @brief Verify that the lease files are converted between the CSV
+/// and the journal formats and that the lease journals are cleaned up.
+TEST_F(LFCControllerTest, journal4) {
+    LFCController lfc_controller;
+
+    // Converts the copy file to the output file in the given format.
+    auto convert = [this](const string& format, const string& input,
+                          const string& output) {
+        LFCController lfc_convert;
+        char* argv[] = { const_cast<char*>("progName"),
+                         const_cast<char*>("-4"),
+                         const_cast<char*>("-t"),
+                         const_cast<char*>(format.c_str()),
+                         const_cast<char*>("-i"),
+                         const_cast<char*>(input.c_str()),
+                         const_cast<char*>("-o"),
+                         const_cast<char*>(output.c_str()) };
+        launch(lfc_convert, 8, argv);
+    };
+
+    string a_1 = "192.0.2.1,06:07:08:09:0a:bc,,"
+                 "200,200,8,1,1,host.example.com,1,\n";
+    string a_2 = "192.0.2.1,06:07:08:09:0a:bc,,"
+                 "200,800,8,1,1,host.example.com,1,{ \"foo\": true }\n";
+    string b_1 = "192.0.3.15,dd:de:ba:0d:1b:2e:3e:4f,0a:00:01:04,"
+                 "100,150,7,0,0,,1,\n";
+    string c_1 = "192.0.2.5,16:17:18:19:1a:bc,,"
+                 "200,200,8,1,1,host.example.com,1,\n";
+
+    // Convert a CSV lease file to a lease journal.
+    writeFile(istr_, v4_hdr_ + a_1 + c_1 + b_1 + a_2);
+    convert("journal", istr_, ostr_);
+    EXPECT_TRUE(LeaseJournal::isJournal(ostr_));
+
+    // The output file must not exist.
+    convert("csv", istr_, ostr_);
+    EXPECT_TRUE(LeaseJournal::isJournal(ostr_));
+
+    // Convert it back and check the leases.
+    convert("csv", ostr_, fstr_);
+    EXPECT_EQ(v4_hdr_ + a_2 + c_1 + b_1, readFile(fstr_));
+    removeTestFile();
+
+    // Clean up a CSV previous file and a lease journal copy file.
+    // The result is written in the format of the copy file.
+    writeFile(xstr_, v4_hdr_ + a_1 + c_1);
+    writeFile(fstr_, v4_hdr_ + b_1 + a_2);
+    convert("journal", fstr_, istr_);
+    remove(fstr_.c_str());
+
+    char* argv[] = { const_cast<char*>("progName"),
+                     const_cast<char*>("-4"),
+                     const_cast<char*>("-x"),
+                     const_cast<char*>(xstr_.c_str()),
+                     const_cast<char*>("-i"),
+                     const_cast<char*>(istr_.c_str()),
+                     const_cast<char*>("-o"),
+                     const_cast<char*>(ostr_.c_str()),
+                     const_cast<char*>("-c"),
+                     const_cast<char*>(cstr_.c_str()),
+                     const_cast<char*>("-f"),
+                     const_cast<char*>(fstr_.c_str()),
+                     const_cast<char*>("-p"),
+                     const_cast<char*>(pstr_.c_str()) };
+    launch(lfc_controller, 14, argv);
+
+    EXPECT_TRUE(LeaseJournal::isJournal(xstr_));
+    EXPECT_TRUE(noExistIOFP());
+    convert("csv", xstr_, ostr_);
+    EXPECT_EQ(v4_hdr_ + a_2 + c_1 + b_1, readFile(ostr_));
+}
+
 // @todo double launch (how to do that)
 
 } // end of anonymous namespace
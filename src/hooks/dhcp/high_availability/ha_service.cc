@@ -1684,6 +1684,11 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
                         .arg(leases_element.size())
                         .arg(server_name);
 
+                    // Collect the changes to the local lease database and apply
+                    // them in a single batch.
+                    LeaseChange4Collection changes4;
+                    LeaseChange6Collection changes6;
+
                     for (auto l = leases_element.begin(); l != leases_element.end(); ++l) {
                         try {
 
@@ -1694,7 +1699,7 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
                                 Lease4Ptr existing_lease = LeaseMgrFactory::instance().getLease4(lease->addr_);
                                 if (!existing_lease) {
                                     // There is no such lease, so let's add it.
-                                    LeaseMgrFactory::instance().addLease(lease);
+                                    changes4.push_back(LeaseChange4(LeaseChange4::ADD, lease));
 
                                 } else if (existing_lease->cltt_ < lease->cltt_) {
                                     // If the existing lease is older than the fetched lease, update
@@ -1703,7 +1708,7 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
                                     // database. Some database backends reject operations on the lease if
                                     // the current expiration time value does not match what is stored.
                                     Lease::syncCurrentExpirationTime(*existing_lease, *lease);
-                                    LeaseMgrFactory::instance().updateLease4(lease);
+                                    changes4.push_back(LeaseChange4(LeaseChange4::UPDATE, lease));
 
                                 } else {
                                     LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_SYNC_STALE_LEASE4_SKIP)
@@ -1727,7 +1732,7 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
                                                                                                  lease->addr_);
                                 if (!existing_lease) {
                                     // There is no such lease, so let's add it.
-                                    LeaseMgrFactory::instance().addLease(lease);
+                                    changes6.push_back(LeaseChange6(LeaseChange6::ADD, lease));
 
                                 } else if (existing_lease->cltt_ < lease->cltt_) {
                                     // If the existing lease is older than the fetched lease, update
@@ -1736,7 +1741,7 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
                                     // database. Some database backends reject operations on the lease if
                                     // the current expiration time value does not match what is stored.
                                     Lease::syncCurrentExpirationTime(*existing_lease, *lease);
-                                    LeaseMgrFactory::instance().updateLease6(lease);
+                                    changes6.push_back(LeaseChange6(LeaseChange6::UPDATE, lease));
 
                                 } else {
                                     LOG_DEBUG(ha_logger, DBGLVL_TRACE_BASIC, HA_LEASE_SYNC_STALE_LEASE6_SKIP)
@@ -1761,6 +1766,28 @@ HAService::asyncSyncLeasesInternal(http::HttpClient& http_client,
                         }
                     }
 
+                    if (!changes4.empty()) {
+                        LeaseMgrFactory::instance().applyLeaseChanges(changes4);
+                        for (auto const& change : changes4) {
+                            if (!change.error_.empty()) {
+                                LOG_WARN(ha_logger, HA_LEASE_SYNC_FAILED)
+                                    .arg(change.lease_->toElement()->str())
+                                    .arg(change.error_);
+                            }
+                        }
+                    }
+
+                    if (!changes6.empty()) {
+                        LeaseMgrFactory::instance().applyLeaseChanges(changes6);
+                        for (auto const& change : changes6) {
+                            if (!change.error_.empty()) {
+                                LOG_WARN(ha_logger, HA_LEASE_SYNC_FAILED)
+                                    .arg(change.lease_->toElement()->str())
+                                    .arg(change.error_);
+                            }
+                        }
+                    }
+
                 } catch (const std::exception& ex) {
                     error_message = ex.what();
                     LOG_ERROR(ha_logger, HA_LEASES_SYNC_FAILED)
@@ -0,0 +1,618 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <host_cache.h>
+#include <exceptions/exceptions.h>
+#include <stats/stats_mgr.h>
+#include <util/multi_threading_mgr.h>
+#include <boost/tuple/tuple.hpp>
+
+#include <iterator>
+#include <limits>
+#include <set>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::stats;
+using namespace isc::util;
+
+namespace isc {
+namespace host_cache {
+
+HostCache::HostCache(const size_t maximum, const uint32_t ttl)
+    : entries_(), maximum_(maximum), ttl_(ttl), mutex_(new std::mutex()) {
+}
+
+HostCache::~HostCache() {
+}
+
+HostCachePtr
+HostCache::create(ConstElementPtr config) {
+    int64_t maximum = 0;
+    int64_t ttl = 0;
+    if (config) {
+        if (config->getType() != Element::map) {
+            isc_throw(BadValue, "'parameters' must be a map");
+        }
+        ConstElementPtr value = config->get("maximum");
+        if (value) {
+            if (value->getType() != Element::integer) {
+                isc_throw(BadValue, "'maximum' must be an integer");
+            }
+            maximum = value->intValue();
+            if (maximum < 0) {
+                isc_throw(BadValue, "'maximum' must not be negative");
+            }
+        }
+        value = config->get("ttl");
+        if (value) {
+            if (value->getType() != Element::integer) {
+                isc_throw(BadValue, "'ttl' must be an integer");
+            }
+            ttl = value->intValue();
+            if ((ttl < 0) || (ttl > std::numeric_limits<uint32_t>::max())) {
+                isc_throw(BadValue, "'ttl' must be between 0 and "
+                          << std::numeric_limits<uint32_t>::max());
+            }
+        }
+    }
+    return (HostCachePtr(new HostCache(static_cast<size_t>(maximum),
+                                       static_cast<uint32_t>(ttl))));
+}
+
+ElementPtr
+HostCache::toElement() const {
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        return (toElementInternal());
+    } else {
+        return (toElementInternal());
+    }
+}
+
+ElementPtr
+HostCache::toElement(const Host::IdentifierType& identifier_type,
+                     const std::vector<uint8_t>& identifier) const {
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        return (toElementInternal(identifier_type, identifier));
+    } else {
+        return (toElementInternal(identifier_type, identifier));
+    }
+}
+
+ElementPtr
+HostCache::toElementInternal() const {
+    ElementPtr result = Element::createList();
+    const time_t now = time(0);
+    for (auto const& entry : entries_) {
+        if (!entry.expired(now)) {
+            result->add(entryToElement(entry, now));
+        }
+    }
+    return (result);
+}
+
+ElementPtr
+HostCache::toElementInternal(const Host::IdentifierType& identifier_type,
+                             const std::vector<uint8_t>& identifier) const {
+    ElementPtr result = Element::createList();
+    const time_t now = time(0);
+    // All the entries are in the IPv4 identifier index so a partial
+    // search on it finds the entries of both families.
+    auto const& idx = entries_.get<HostCacheIdentifier4IndexTag>();
+    auto range = idx.equal_range(boost::make_tuple(identifier,
+                                                   identifier_type));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (!it->expired(now)) {
+            result->add(entryToElement(*it, now));
+        }
+    }
+    return (result);
+}
+
+ElementPtr
+HostCache::entryToElement(const HostCacheEntry& entry, const time_t now) {
+    ElementPtr host;
+    if ((entry.getIPv4SubnetID() == SUBNET_ID_UNUSED) &&
+        (entry.getIPv6SubnetID() != SUBNET_ID_UNUSED)) {
+        host = entry.host_->toElement6();
+        host->set("subnet-id",
+                  Element::create(static_cast<int64_t>(entry.getIPv6SubnetID())));
+    } else {
+        host = entry.host_->toElement4();
+        host->set("subnet-id",
+                  Element::create(static_cast<int64_t>(entry.getIPv4SubnetID())));
+    }
+    if (entry.host_->getNegative()) {
+        host->set("negative", Element::create(true));
+    }
+    if (entry.expire_ != 0) {
+        host->set("expires-in",
+                  Element::create(static_cast<int64_t>(entry.expire_ - now)));
+    }
+    return (host);
+}
+
+size_t
+HostCache::removeByAddress(const SubnetID& subnet_id, const IOAddress& addr) {
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        return (delAddressInternal(subnet_id, addr));
+    } else {
+        return (delAddressInternal(subnet_id, addr));
+    }
+}
+
+size_t
+HostCache::removeByIdentifier(const SubnetID& subnet_id,
+                              const Host::IdentifierType& identifier_type,
+                              const std::vector<uint8_t>& identifier) {
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        return (delInternal<HostCacheIdentifier4IndexTag>(subnet_id,
+                                                          identifier_type,
+                                                          identifier) +
+                delInternal<HostCacheIdentifier6IndexTag>(subnet_id,
+                                                          identifier_type,
+                                                          identifier));
+    } else {
+        return (delInternal<HostCacheIdentifier4IndexTag>(subnet_id,
+                                                          identifier_type,
+                                                          identifier) +
+                delInternal<HostCacheIdentifier6IndexTag>(subnet_id,
+                                                          identifier_type,
+                                                          identifier));
+    }
+}
+
+void
+HostCache::updateStats(const ConstHostPtr& host) {
+    StatsMgr::instance().addValue(host ? "host-cache-hits" : "host-cache-misses",
+                                  static_cast<int64_t>(1));
+}
+
+ConstHostCollection
+HostCache::getAll(const Host::IdentifierType&, const uint8_t*,
+                  const size_t) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+HostCache::getAll4(const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+HostCache::getAll6(const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+HostCache::getAllbyHostname(const std::string&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+HostCache::getAllbyHostname4(const std::string&, const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+HostCache::getAllbyHostname6(const std::string&, const SubnetID&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+HostCache::getPage4(const SubnetID&, size_t&, uint64_t,
+                    const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+HostCache::getPage6(const SubnetID&, size_t&, uint64_t,
+                    const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+HostCache::getPage4(size_t&, uint64_t, const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+HostCache::getPage6(size_t&, uint64_t, const HostPageSize&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostCollection
+HostCache::getAll4(const IOAddress&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostPtr
+HostCache::get4(const SubnetID& subnet_id,
+                const Host::IdentifierType& identifier_type,
+                const uint8_t* identifier_begin,
+                const size_t identifier_len) const {
+    ConstHostPtr host;
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        host = getInternal<HostCacheIdentifier4IndexTag>(subnet_id,
+                                                         identifier_type,
+                                                         identifier_begin,
+                                                         identifier_len);
+    } else {
+        host = getInternal<HostCacheIdentifier4IndexTag>(subnet_id,
+                                                         identifier_type,
+                                                         identifier_begin,
+                                                         identifier_len);
+    }
+    updateStats(host);
+    return (host);
+}
+
+ConstHostPtr
+HostCache::get4(const SubnetID& subnet_id, const IOAddress& address) const {
+    ConstHostPtr host;
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        host = get4Internal(subnet_id, address);
+    } else {
+        host = get4Internal(subnet_id, address);
+    }
+    updateStats(host);
+    return (host);
+}
+
+ConstHostCollection
+HostCache::getAll4(const SubnetID&, const IOAddress&) const {
+    return (ConstHostCollection());
+}
+
+ConstHostPtr
+HostCache::get6(const SubnetID& subnet_id,
+                const Host::IdentifierType& identifier_type,
+                const uint8_t* identifier_begin,
+                const size_t identifier_len) const {
+    ConstHostPtr host;
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        host = getInternal<HostCacheIdentifier6IndexTag>(subnet_id,
+                                                         identifier_type,
+                                                         identifier_begin,
+                                                         identifier_len);
+    } else {
+        host = getInternal<HostCacheIdentifier6IndexTag>(subnet_id,
+                                                         identifier_type,
+                                                         identifier_begin,
+                                                         identifier_len);
+    }
+    updateStats(host);
+    return (host);
+}
+
+ConstHostPtr
+HostCache::get6(const IOAddress&, const uint8_t) const {
+    return (ConstHostPtr());
+}
+
+ConstHostPtr
+HostCache::get6(const SubnetID&, const IOAddress&) const {
+    return (ConstHostPtr());
+}
+
+ConstHostCollection
+HostCache::getAll6(const SubnetID&, const IOAddress&) const {
+    return (ConstHostCollection());
+}
+
+template<typename IndexTag>
+ConstHostPtr
+HostCache::getInternal(const SubnetID& subnet_id,
+                       const Host::IdentifierType& identifier_type,
+                       const uint8_t* identifier_begin,
+                       const size_t identifier_len) const {
+    const std::vector<uint8_t> identifier(identifier_begin,
+                                          identifier_begin + identifier_len);
+    auto& idx = entries_.template get<IndexTag>();
+    auto range = idx.equal_range(boost::make_tuple(identifier,
+                                                   identifier_type,
+                                                   subnet_id));
+    const time_t now = time(0);
+    for (auto it = range.first; it != range.second; ) {
+        if (it->expired(now)) {
+            it = idx.erase(it);
+            continue;
+        }
+        // Mark the entry as the most recently used.
+        entries_.relocate(entries_.begin(), entries_.template project<0>(it));
+        return (it->host_);
+    }
+    return (ConstHostPtr());
+}
+
+ConstHostPtr
+HostCache::get4Internal(const SubnetID& subnet_id,
+                        const IOAddress& address) const {
+    auto& idx = entries_.get<HostCacheAddress4IndexTag>();
+    auto range = idx.equal_range(boost::make_tuple(subnet_id, address));
+    const time_t now = time(0);
+    for (auto it = range.first; it != range.second; ) {
+        if (it->expired(now)) {
+            it = idx.erase(it);
+            continue;
+        }
+        entries_.relocate(entries_.begin(), entries_.project<0>(it));
+        return (it->host_);
+    }
+    return (ConstHostPtr());
+}
+
+void
+HostCache::add(const HostPtr&) {
+}
+
+bool
+HostCache::del(const SubnetID& subnet_id, const IOAddress& addr) {
+    static_cast<void>(removeByAddress(subnet_id, addr));
+    return (false);
+}
+
+bool
+HostCache::del4(const SubnetID& subnet_id,
+                const Host::IdentifierType& identifier_type,
+                const uint8_t* identifier_begin,
+                const size_t identifier_len) {
+    const std::vector<uint8_t> identifier(identifier_begin,
+                                          identifier_begin + identifier_len);
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        delInternal<HostCacheIdentifier4IndexTag>(subnet_id, identifier_type,
+                                                  identifier);
+    } else {
+        delInternal<HostCacheIdentifier4IndexTag>(subnet_id, identifier_type,
+                                                  identifier);
+    }
+    return (false);
+}
+
+bool
+HostCache::del6(const SubnetID& subnet_id,
+                const Host::IdentifierType& identifier_type,
+                const uint8_t* identifier_begin,
+                const size_t identifier_len) {
+    const std::vector<uint8_t> identifier(identifier_begin,
+                                          identifier_begin + identifier_len);
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        delInternal<HostCacheIdentifier6IndexTag>(subnet_id, identifier_type,
+                                                  identifier);
+    } else {
+        delInternal<HostCacheIdentifier6IndexTag>(subnet_id, identifier_type,
+                                                  identifier);
+    }
+    return (false);
+}
+
+template<typename IndexTag>
+size_t
+HostCache::delInternal(const SubnetID& subnet_id,
+                       const Host::IdentifierType& identifier_type,
+                       const std::vector<uint8_t>& identifier) {
+    auto& idx = entries_.template get<IndexTag>();
+    auto range = idx.equal_range(boost::make_tuple(identifier,
+                                                   identifier_type,
+                                                   subnet_id));
+    size_t erased = std::distance(range.first, range.second);
+    idx.erase(range.first, range.second);
+    return (erased);
+}
+
+size_t
+HostCache::delAddressInternal(const SubnetID& subnet_id,
+                              const IOAddress& addr) {
+    if (addr.isV4()) {
+        auto& idx = entries_.get<HostCacheAddress4IndexTag>();
+        auto range = idx.equal_range(boost::make_tuple(subnet_id, addr));
+        size_t erased = std::distance(range.first, range.second);
+        idx.erase(range.first, range.second);
+        return (erased);
+    }
+
+    // There is no index by IPv6 reservation: deletions are rare so
+    // all the entries are checked.
+    size_t erased = 0;
+    for (auto it = entries_.begin(); it != entries_.end(); ) {
+        bool found = false;
+        if (it->getIPv6SubnetID() == subnet_id) {
+            auto const& range = it->host_->getIPv6Reservations();
+            for (auto resrv = range.first; resrv != range.second; ++resrv) {
+                if (resrv->second.getPrefix() == addr) {
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (found) {
+            it = entries_.erase(it);
+            ++erased;
+        } else {
+            ++it;
+        }
+    }
+    return (erased);
+}
+
+bool
+HostCache::setIPReservationsUnique(const bool) {
+    return (true);
+}
+
+size_t
+HostCache::insert(const ConstHostPtr& host, bool overwrite) {
+    if (!host) {
+        isc_throw(BadValue, "null host can't be inserted into the host cache");
+    }
+    size_t evicted = 0;
+    size_t conflicts = 0;
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        conflicts = insertInternal(host, overwrite, evicted);
+    } else {
+        conflicts = insertInternal(host, overwrite, evicted);
+    }
+    if (evicted > 0) {
+        StatsMgr::instance().addValue("host-cache-evictions",
+                                      static_cast<int64_t>(evicted));
+    }
+    return (conflicts);
+}
+
+size_t
+HostCache::insertInternal(const ConstHostPtr& host, bool overwrite,
+                          size_t& evicted) {
+    // Collect the conflicting entries so an entry conflicting on
+    // several keys is counted once.
+    std::set<const HostCacheEntry*> conflicts;
+    const std::vector<uint8_t>& identifier = host->getIdentifier();
+    const Host::IdentifierType identifier_type = host->getIdentifierType();
+
+    if (host->getIPv4SubnetID() != SUBNET_ID_UNUSED) {
+        auto& idx = entries_.get<HostCacheIdentifier4IndexTag>();
+        auto range = idx.equal_range(boost::make_tuple(identifier,
+                                                       identifier_type,
+                                                       host->getIPv4SubnetID()));
+        for (auto it = range.first; it != range.second; ++it) {
+            conflicts.insert(&*it);
+        }
+        const IOAddress& address = host->getIPv4Reservation();
+        if (!address.isV4Zero()) {
+            auto& idx4 = entries_.get<HostCacheAddress4IndexTag>();
+            auto range4 = idx4.equal_range(boost::make_tuple(host->getIPv4SubnetID(),
+                                                             address));
+            for (auto it = range4.first; it != range4.second; ++it) {
+                conflicts.insert(&*it);
+            }
+        }
+    }
+
+    if (host->getIPv6SubnetID() != SUBNET_ID_UNUSED) {
+        auto& idx = entries_.get<HostCacheIdentifier6IndexTag>();
+        auto range = idx.equal_range(boost::make_tuple(identifier,
+                                                       identifier_type,
+                                                       host->getIPv6SubnetID()));
+        for (auto it = range.first; it != range.second; ++it) {
+            conflicts.insert(&*it);
+        }
+    }
+
+    if (!conflicts.empty()) {
+        if (!overwrite) {
+            return (1);
+        }
+        for (auto entry : conflicts) {
+            entries_.erase(entries_.iterator_to(*entry));
+        }
+    }
+
+    // Evict the least recently used entries to make room.
+    while ((maximum_ > 0) && (entries_.size() >= maximum_)) {
+        entries_.pop_back();
+        ++evicted;
+    }
+
+    const time_t expire = (ttl_ > 0 ? time(0) + ttl_ : 0);
+    entries_.push_front(HostCacheEntry(host, expire));
+    return (conflicts.size());
+}
+
+bool
+HostCache::remove(const HostPtr& host) {
+    if (!host) {
+        return (false);
+    }
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        return (removeInternal(host));
+    } else {
+        return (removeInternal(host));
+    }
+}
+
+bool
+HostCache::removeInternal(const HostPtr& host) {
+    // Look for the entry holding this host object using an identifier
+    // index of a subnet the host is connected to.
+    if (host->getIPv4SubnetID() != SUBNET_ID_UNUSED) {
+        auto& idx = entries_.get<HostCacheIdentifier4IndexTag>();
+        auto range = idx.equal_range(boost::make_tuple(host->getIdentifier(),
+                                                       host->getIdentifierType(),
+                                                       host->getIPv4SubnetID()));
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->host_ == host) {
+                idx.erase(it);
+                return (true);
+            }
+        }
+    }
+    if (host->getIPv6SubnetID() != SUBNET_ID_UNUSED) {
+        auto& idx = entries_.get<HostCacheIdentifier6IndexTag>();
+        auto range = idx.equal_range(boost::make_tuple(host->getIdentifier(),
+                                                       host->getIdentifierType(),
+                                                       host->getIPv6SubnetID()));
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->host_ == host) {
+                idx.erase(it);
+                return (true);
+            }
+        }
+    }
+    return (false);
+}
+
+void
+HostCache::flush(size_t count) {
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        flushInternal(count);
+    } else {
+        flushInternal(count);
+    }
+}
+
+void
+HostCache::flushInternal(size_t count) {
+    if ((count == 0) || (count >= entries_.size())) {
+        entries_.clear();
+        return;
+    }
+    for (; count > 0; --count) {
+        entries_.pop_back();
+    }
+}
+
+size_t
+HostCache::size() const {
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(*mutex_);
+        return (entries_.size());
+    } else {
+        return (entries_.size());
+    }
+}
+
+size_t
+HostCache::capacity() const {
+    return (maximum_);
+}
+
+} // end of namespace host_cache
+} // end of namespace isc
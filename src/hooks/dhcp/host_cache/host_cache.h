@@ -0,0 +1,620 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef HOST_CACHE_H
+#define HOST_CACHE_H
+
+#include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <dhcpsrv/cache_host_data_source.h>
+#include <dhcpsrv/host.h>
+#include <dhcpsrv/subnet_id.h>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace host_cache {
+
+/// @brief Entry of the host cache.
+///
+/// It holds a pointer to the cached host, which can be a negative
+/// host i.e. a host which records that a lookup found nothing, and
+/// the time the entry expires at.
+struct HostCacheEntry {
+
+    /// @brief Constructor.
+    ///
+    /// @param host Pointer to the cached host.
+    /// @param expire Expiration time, 0 when the entry never expires.
+    HostCacheEntry(const dhcp::ConstHostPtr& host, const time_t expire)
+        : host_(host), expire_(expire) {
+    }
+
+    /// @brief Returns the identifier of the cached host.
+    const std::vector<uint8_t>& getIdentifier() const {
+        return (host_->getIdentifier());
+    }
+
+    /// @brief Returns the identifier type of the cached host.
+    dhcp::Host::IdentifierType getIdentifierType() const {
+        return (host_->getIdentifierType());
+    }
+
+    /// @brief Returns the IPv4 subnet identifier of the cached host.
+    dhcp::SubnetID getIPv4SubnetID() const {
+        return (host_->getIPv4SubnetID());
+    }
+
+    /// @brief Returns the IPv6 subnet identifier of the cached host.
+    dhcp::SubnetID getIPv6SubnetID() const {
+        return (host_->getIPv6SubnetID());
+    }
+
+    /// @brief Returns the IPv4 reservation of the cached host.
+    const asiolink::IOAddress& getIPv4Reservation() const {
+        return (host_->getIPv4Reservation());
+    }
+
+    /// @brief Checks if the entry has expired.
+    ///
+    /// @param now Current time.
+    bool expired(const time_t now) const {
+        return ((expire_ != 0) && (expire_ <= now));
+    }
+
+    /// @brief Pointer to the cached host.
+    dhcp::ConstHostPtr host_;
+
+    /// @brief Expiration time, 0 when the entry never expires.
+    time_t expire_;
+};
+
+/// @brief Tag for the index by last use.
+struct HostCacheLruIndexTag { };
+
+/// @brief Tag for the index by identifier and IPv4 subnet.
+struct HostCacheIdentifier4IndexTag { };
+
+/// @brief Tag for the index by identifier and IPv6 subnet.
+struct HostCacheIdentifier6IndexTag { };
+
+/// @brief Tag for the index by IPv4 subnet and reserved address.
+struct HostCacheAddress4IndexTag { };
+
+/// @brief Multi index container holding the host cache entries.
+///
+/// The first index keeps the entries in the order of their last use:
+/// the most recently used entry is at the front and the least recently
+/// used entry, which is the first to be evicted, is at the back.
+typedef boost::multi_index_container<
+    HostCacheEntry,
+    boost::multi_index::indexed_by<
+        // First index keeps the entries ordered by last use.
+        boost::multi_index::sequenced<
+            boost::multi_index::tag<HostCacheLruIndexTag>
+        >,
+
+        // Second index is used to search by identifier and IPv4 subnet.
+        boost::multi_index::ordered_non_unique<
+            boost::multi_index::tag<HostCacheIdentifier4IndexTag>,
+            boost::multi_index::composite_key<
+                HostCacheEntry,
+                boost::multi_index::const_mem_fun<
+                    HostCacheEntry, const std::vector<uint8_t>&,
+                    &HostCacheEntry::getIdentifier
+                >,
+                boost::multi_index::const_mem_fun<
+                    HostCacheEntry, dhcp::Host::IdentifierType,
+                    &HostCacheEntry::getIdentifierType
+                >,
+                boost::multi_index::const_mem_fun<
+                    HostCacheEntry, dhcp::SubnetID,
+                    &HostCacheEntry::getIPv4SubnetID
+                >
+            >
+        >,
+
+        // Third index is used to search by identifier and IPv6 subnet.
+        boost::multi_index::ordered_non_unique<
+            boost::multi_index::tag<HostCacheIdentifier6IndexTag>,
+            boost::multi_index::composite_key<
+                HostCacheEntry,
+                boost::multi_index::const_mem_fun<
+                    HostCacheEntry, const std::vector<uint8_t>&,
+                    &HostCacheEntry::getIdentifier
+                >,
+                boost::multi_index::const_mem_fun<
+                    HostCacheEntry, dhcp::Host::IdentifierType,
+                    &HostCacheEntry::getIdentifierType
+                >,
+                boost::multi_index::const_mem_fun<
+                    HostCacheEntry, dhcp::SubnetID,
+                    &HostCacheEntry::getIPv6SubnetID
+                >
+            >
+        >,
+
+        // Fourth index is used to search by IPv4 subnet and address.
+        boost::multi_index::ordered_non_unique<
+            boost::multi_index::tag<HostCacheAddress4IndexTag>,
+            boost::multi_index::composite_key<
+                HostCacheEntry,
+                boost::multi_index::const_mem_fun<
+                    HostCacheEntry, dhcp::SubnetID,
+                    &HostCacheEntry::getIPv4SubnetID
+                >,
+                boost::multi_index::const_mem_fun<
+                    HostCacheEntry, const asiolink::IOAddress&,
+                    &HostCacheEntry::getIPv4Reservation
+                >
+            >
+        >
+    >
+> HostCacheContainer;
+
+/// @brief In memory cache of the host reservations.
+///
+/// This class implements the @c dhcp::CacheHostDataSource interface
+/// used by the @c dhcp::HostMgr when it is the first host backend:
+/// hosts returned by the other backends are inserted in the cache and
+/// the next lookups for them are answered from memory. When negative
+/// caching is enabled in the host manager the lookups which returned
+/// nothing are cached too.
+///
+/// The cache holds at most a configured number of entries and evicts
+/// the least recently used ones when it is full. The entries expire
+/// after a configured time to live so the changes made directly in
+/// the host databases are eventually seen by the server.
+///
+/// Only the lookups of a single host by identifier and of an IPv4
+/// host by reserved address are answered from the cache. The lookups
+/// returning collections of hosts and the IPv6 lookups by address or
+/// prefix are always forwarded to the other backends: the cache returns
+/// nothing for them.
+///
+/// The number of hits, misses and evictions are reported in the
+/// host-cache-hits, host-cache-misses and host-cache-evictions
+/// statistics.
+class HostCache : public dhcp::CacheHostDataSource {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param maximum Maximum number of entries, 0 means unbounded.
+    /// @param ttl Time to live of the entries in seconds, 0 means
+    /// the entries never expire.
+    HostCache(const size_t maximum = 0, const uint32_t ttl = 0);
+
+    /// @brief Destructor.
+    virtual ~HostCache();
+
+    /// @brief Creates the host cache from its configuration.
+    ///
+    /// The configuration is the map of the hook library parameters
+    /// with the optional "maximum" and "ttl" entries.
+    ///
+    /// @param config Hook library parameters, may be null.
+    /// @return Pointer to the new host cache.
+    /// @throw BadValue if the configuration is invalid.
+    static boost::shared_ptr<HostCache> create(data::ConstElementPtr config);
+
+    /// @brief Returns the time to live of the entries in seconds.
+    uint32_t getTtl() const {
+        return (ttl_);
+    }
+
+    /// @brief Returns the cached entries for the cache-get command.
+    ///
+    /// The entries are listed from the most recently used to the least
+    /// recently used one. The expired entries are not listed.
+    ///
+    /// @return List of the cached hosts.
+    data::ElementPtr toElement() const;
+
+    /// @brief Returns the cached entries with an identifier for the
+    /// cache-get-by-id command.
+    ///
+    /// @param identifier_type Identifier type.
+    /// @param identifier Identifier.
+    /// @return List of the cached hosts with the identifier.
+    data::ElementPtr toElement(const dhcp::Host::IdentifierType& identifier_type,
+                               const std::vector<uint8_t>& identifier) const;
+
+    /// @brief Removes the cached hosts having a reservation for an address.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param addr Reserved IPv4 or IPv6 address.
+    /// @return The number of removed entries.
+    size_t removeByAddress(const dhcp::SubnetID& subnet_id,
+                           const asiolink::IOAddress& addr);
+
+    /// @brief Removes the cached hosts with an identifier in a subnet.
+    ///
+    /// The entries connected to an IPv4 or an IPv6 subnet with this
+    /// identifier are removed.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier Identifier.
+    /// @return The number of removed entries.
+    size_t removeByIdentifier(const dhcp::SubnetID& subnet_id,
+                              const dhcp::Host::IdentifierType& identifier_type,
+                              const std::vector<uint8_t>& identifier);
+
+    /// @name Methods inherited from the BaseHostDataSource.
+    //@{
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getAll(const dhcp::Host::IdentifierType& identifier_type,
+           const uint8_t* identifier_begin,
+           const size_t identifier_len) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getAll4(const dhcp::SubnetID& subnet_id) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getAll6(const dhcp::SubnetID& subnet_id) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getAllbyHostname(const std::string& hostname) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getAllbyHostname4(const std::string& hostname,
+                      const dhcp::SubnetID& subnet_id) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getAllbyHostname6(const std::string& hostname,
+                      const dhcp::SubnetID& subnet_id) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getPage4(const dhcp::SubnetID& subnet_id,
+             size_t& source_index,
+             uint64_t lower_host_id,
+             const dhcp::HostPageSize& page_size) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getPage6(const dhcp::SubnetID& subnet_id,
+             size_t& source_index,
+             uint64_t lower_host_id,
+             const dhcp::HostPageSize& page_size) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getPage4(size_t& source_index,
+             uint64_t lower_host_id,
+             const dhcp::HostPageSize& page_size) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getPage6(size_t& source_index,
+             uint64_t lower_host_id,
+             const dhcp::HostPageSize& page_size) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getAll4(const asiolink::IOAddress& address) const;
+
+    /// @brief Returns a cached host connected to the IPv4 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return Const @c Host object, possibly negative, or null if the
+    /// host is not in the cache.
+    virtual dhcp::ConstHostPtr
+    get4(const dhcp::SubnetID& subnet_id,
+         const dhcp::Host::IdentifierType& identifier_type,
+         const uint8_t* identifier_begin,
+         const size_t identifier_len) const;
+
+    /// @brief Returns a cached host having a reservation for an address
+    /// in the IPv4 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param address Reserved IPv4 address.
+    ///
+    /// @return Const @c Host object or null if the host is not in the cache.
+    virtual dhcp::ConstHostPtr
+    get4(const dhcp::SubnetID& subnet_id,
+         const asiolink::IOAddress& address) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getAll4(const dhcp::SubnetID& subnet_id,
+            const asiolink::IOAddress& address) const;
+
+    /// @brief Returns a cached host connected to the IPv6 subnet.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return Const @c Host object, possibly negative, or null if the
+    /// host is not in the cache.
+    virtual dhcp::ConstHostPtr
+    get6(const dhcp::SubnetID& subnet_id,
+         const dhcp::Host::IdentifierType& identifier_type,
+         const uint8_t* identifier_begin,
+         const size_t identifier_len) const;
+
+    /// @brief Lookups by prefix are not cached: returns null.
+    virtual dhcp::ConstHostPtr
+    get6(const asiolink::IOAddress& prefix, const uint8_t prefix_len) const;
+
+    /// @brief Lookups by IPv6 address are not cached: returns null.
+    virtual dhcp::ConstHostPtr
+    get6(const dhcp::SubnetID& subnet_id,
+         const asiolink::IOAddress& address) const;
+
+    /// @brief Collections are not cached: returns an empty collection.
+    virtual dhcp::ConstHostCollection
+    getAll6(const dhcp::SubnetID& subnet_id,
+            const asiolink::IOAddress& address) const;
+
+    /// @brief Does nothing: the host manager inserts the added hosts.
+    ///
+    /// @param host Pointer to the new @c Host object being added.
+    virtual void add(const dhcp::HostPtr& host);
+
+    /// @brief Removes the cached hosts having a reservation for an address.
+    ///
+    /// The host manager stops at the first backend which deleted the
+    /// host so this method always returns false.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param addr Reserved IPv4 or IPv6 address.
+    /// @return false.
+    virtual bool del(const dhcp::SubnetID& subnet_id,
+                     const asiolink::IOAddress& addr);
+
+    /// @brief Removes the cached host connected to the IPv4 subnet.
+    ///
+    /// @param subnet_id IPv4 Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return false.
+    virtual bool del4(const dhcp::SubnetID& subnet_id,
+                      const dhcp::Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
+    /// @brief Removes the cached host connected to the IPv6 subnet.
+    ///
+    /// @param subnet_id IPv6 Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return false.
+    virtual bool del6(const dhcp::SubnetID& subnet_id,
+                      const dhcp::Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
+    /// @brief Return backend type.
+    ///
+    /// @return "cache".
+    virtual std::string getType() const {
+        return (std::string("cache"));
+    }
+
+    /// @brief The cache supports non unique IP reservations.
+    ///
+    /// @param unique Ignored.
+    /// @return always true.
+    virtual bool setIPReservationsUnique(const bool unique);
+
+    //@}
+
+    /// @name Methods inherited from the CacheHostDataSource.
+    //@{
+
+    /// @brief Insert a host into the cache.
+    ///
+    /// The conflicting entries are the entries with the same identifier
+    /// in the IPv4 or IPv6 subnet of the host and the entries with the
+    /// same reserved IPv4 address in the IPv4 subnet. When the cache is
+    /// full the least recently used entries are evicted.
+    ///
+    /// @param host Pointer to the new @c Host object being inserted.
+    /// @param overwrite false if doing nothing in case of conflicts
+    /// (and returning 1), true if removing conflicting entries
+    /// (and returning their number).
+    /// @return number of conflicts limited to one if overwrite is false.
+    virtual size_t insert(const dhcp::ConstHostPtr& host, bool overwrite);
+
+    /// @brief Remove a host from the cache.
+    ///
+    /// @param host Pointer to the existing @c Host object being removed.
+    /// @return true when found and removed.
+    virtual bool remove(const dhcp::HostPtr& host);
+
+    /// @brief Flush the least recently used entries.
+    ///
+    /// @param count number of entries to remove, 0 means all.
+    virtual void flush(size_t count);
+
+    /// @brief Return the number of entries.
+    ///
+    /// @return the current number of entries in the cache.
+    virtual size_t size() const;
+
+    /// @brief Return the maximum number of entries.
+    ///
+    /// @return the maximum number of entries, 0 means unbound.
+    virtual size_t capacity() const;
+
+    //@}
+
+private:
+
+    /// @brief Returns a cached host by identifier.
+    ///
+    /// It must be called with the mutex held when multi-threading is
+    /// enabled. An expired entry is removed.
+    ///
+    /// @tparam IndexTag Tag of the identifier index of the address family.
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a beginning of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    /// @return Const @c Host object or null.
+    template<typename IndexTag>
+    dhcp::ConstHostPtr
+    getInternal(const dhcp::SubnetID& subnet_id,
+                const dhcp::Host::IdentifierType& identifier_type,
+                const uint8_t* identifier_begin,
+                const size_t identifier_len) const;
+
+    /// @brief Returns a cached host by IPv4 reservation.
+    ///
+    /// It must be called with the mutex held when multi-threading is
+    /// enabled. An expired entry is removed.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param address Reserved IPv4 address.
+    /// @return Const @c Host object or null.
+    dhcp::ConstHostPtr
+    get4Internal(const dhcp::SubnetID& subnet_id,
+                 const asiolink::IOAddress& address) const;
+
+    /// @brief Removes the cached hosts by identifier.
+    ///
+    /// It must be called with the mutex held when multi-threading is
+    /// enabled.
+    ///
+    /// @tparam IndexTag Tag of the identifier index of the address family.
+    /// @param subnet_id Subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier Identifier.
+    /// @return The number of removed entries.
+    template<typename IndexTag>
+    size_t delInternal(const dhcp::SubnetID& subnet_id,
+                       const dhcp::Host::IdentifierType& identifier_type,
+                       const std::vector<uint8_t>& identifier);
+
+    /// @brief Removes the cached hosts having a reservation for an address.
+    ///
+    /// It must be called with the mutex held when multi-threading is
+    /// enabled.
+    ///
+    /// @param subnet_id Subnet identifier.
+    /// @param addr Reserved IPv4 or IPv6 address.
+    /// @return The number of removed entries.
+    size_t delAddressInternal(const dhcp::SubnetID& subnet_id,
+                              const asiolink::IOAddress& addr);
+
+    /// @brief Inserts a host into the cache.
+    ///
+    /// It must be called with the mutex held when multi-threading is
+    /// enabled.
+    ///
+    /// @param host Pointer to the new @c Host object being inserted.
+    /// @param overwrite Remove conflicting entries when true.
+    /// @param evicted Incremented by the number of evicted entries.
+    /// @return number of conflicts limited to one if overwrite is false.
+    size_t insertInternal(const dhcp::ConstHostPtr& host, bool overwrite,
+                          size_t& evicted);
+
+    /// @brief Removes a host from the cache.
+    ///
+    /// It must be called with the mutex held when multi-threading is
+    /// enabled.
+    ///
+    /// @param host Pointer to the existing @c Host object being removed.
+    /// @return true when found and removed.
+    bool removeInternal(const dhcp::HostPtr& host);
+
+    /// @brief Removes the least recently used entries.
+    ///
+    /// It must be called with the mutex held when multi-threading is
+    /// enabled.
+    ///
+    /// @param count number of entries to remove, 0 means all.
+    void flushInternal(size_t count);
+
+    /// @brief Returns the cached entries.
+    ///
+    /// It must be called with the mutex held when multi-threading is
+    /// enabled.
+    ///
+    /// @return List of the cached hosts.
+    data::ElementPtr toElementInternal() const;
+
+    /// @brief Returns the cached entries with an identifier.
+    ///
+    /// It must be called with the mutex held when multi-threading is
+    /// enabled.
+    ///
+    /// @param identifier_type Identifier type.
+    /// @param identifier Identifier.
+    /// @return List of the cached hosts with the identifier.
+    data::ElementPtr
+    toElementInternal(const dhcp::Host::IdentifierType& identifier_type,
+                      const std::vector<uint8_t>& identifier) const;
+
+    /// @brief Returns the representation of a cache entry.
+    ///
+    /// @param entry The cache entry.
+    /// @param now Current time.
+    /// @return The cached host with its subnet identifier, negative
+    /// flag and remaining lifetime.
+    static data::ElementPtr entryToElement(const HostCacheEntry& entry,
+                                           const time_t now);
+
+    /// @brief Updates the hit or miss statistic.
+    ///
+    /// @param host Result of a lookup.
+    static void updateStats(const dhcp::ConstHostPtr& host);
+
+    /// @brief The cache entries.
+    ///
+    /// Lookups move the found entries to the front of the last use
+    /// index and remove expired entries so the container is mutable.
+    mutable HostCacheContainer entries_;
+
+    /// @brief Maximum number of entries, 0 means unbounded.
+    size_t maximum_;
+
+    /// @brief Time to live of the entries in seconds, 0 means no expiry.
+    uint32_t ttl_;
+
+    /// @brief The mutex used to protect the entries.
+    const boost::scoped_ptr<std::mutex> mutex_;
+};
+
+/// @brief Pointer to the host cache.
+typedef boost::shared_ptr<HostCache> HostCachePtr;
+
+} // end of namespace host_cache
+} // end of namespace isc
+#endif // HOST_CACHE_H
@@ -0,0 +1,382 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <host_cache.h>
+#include <host_cache_log.h>
+#include <cc/command_interpreter.h>
+#include <dhcpsrv/host_data_source_factory.h>
+#include <dhcpsrv/host_mgr.h>
+#include <hooks/hooks.h>
+#include <stats/stats_mgr.h>
+
+#include <sstream>
+
+namespace isc {
+namespace host_cache {
+
+/// @brief The host cache.
+HostCachePtr impl;
+
+/// @brief Negative caching flag given to the host manager.
+bool negative_caching = false;
+
+/// @brief Factory of the "cache" host backend.
+///
+/// The host backends are recreated at each reconfiguration: the
+/// cache is flushed because its entries can refer to subnets which
+/// no longer exist or were changed.
+///
+/// @return The host cache.
+dhcp::HostDataSourcePtr
+factory(const db::DatabaseConnection::ParameterMap&) {
+    if (!impl) {
+        isc_throw(Unexpected, "the host cache is not initialized");
+    }
+    impl->flush(0);
+    dhcp::HostMgr::instance().setNegativeCaching(negative_caching);
+    return (impl);
+}
+
+/// @brief Checks that the host cache was created.
+///
+/// @throw Unexpected if the host cache is not initialized.
+void
+checkImpl() {
+    if (!impl) {
+        isc_throw(Unexpected, "the host cache is not initialized");
+    }
+}
+
+/// @brief Returns the arguments of the command.
+///
+/// @param handle Callout handle holding the command.
+/// @return The arguments, null when the command has none.
+data::ConstElementPtr
+getArguments(hooks::CalloutHandle& handle) {
+    data::ConstElementPtr command;
+    handle.getArgument("command", command);
+    data::ConstElementPtr args;
+    static_cast<void>(config::parseCommand(args, command));
+    return (args);
+}
+
+/// @brief Parses a host identifier from command arguments.
+///
+/// @param args Command arguments, a map with one of the "hw-address",
+/// "duid", "circuit-id", "client-id" or "flex-id" entries.
+/// @param[out] identifier_type Type of the identifier.
+/// @param[out] identifier Binary value of the identifier.
+/// @throw BadValue if there is no valid identifier.
+void
+parseIdentifier(data::ConstElementPtr args,
+                dhcp::Host::IdentifierType& identifier_type,
+                std::vector<uint8_t>& identifier) {
+    if (!args || (args->getType() != data::Element::map)) {
+        isc_throw(BadValue, "invalid (not a map) parameter");
+    }
+    for (auto const& item : args->mapValue()) {
+        if ((item.first == "subnet-id") || (item.first == "ip-address")) {
+            continue;
+        }
+        identifier_type = dhcp::Host::getIdentifierType(item.first);
+        if (item.second->getType() != data::Element::string) {
+            isc_throw(BadValue, "'" << item.first << "' must be a string");
+        }
+        // Use the host constructor to parse the textual identifier.
+        dhcp::Host host(item.second->stringValue(), item.first,
+                        dhcp::SUBNET_ID_UNUSED, dhcp::SUBNET_ID_UNUSED,
+                        asiolink::IOAddress::IPV4_ZERO_ADDRESS());
+        identifier = host.getIdentifier();
+        return;
+    }
+    isc_throw(BadValue, "missing identifier parameter");
+}
+
+} // end of namespace host_cache
+} // end of namespace isc
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::config;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::hooks;
+using namespace isc::host_cache;
+using namespace isc::stats;
+
+// Functions accessed by the hooks framework use C linkage to avoid the name
+// mangling that accompanies use of the C++ compiler as well as to avoid
+// issues related to namespaces.
+extern "C" {
+
+/// @brief This is a command callout for 'cache-get' command.
+///
+/// Returns the cached hosts from the most recently used to the least
+/// recently used one.
+///
+/// @param handle Callout handle used to retrieve a command and
+/// provide a response.
+/// @return 0 if this callout has been invoked successfully,
+/// 1 otherwise.
+int cache_get(CalloutHandle& handle) {
+    ConstElementPtr response;
+    try {
+        checkImpl();
+        ElementPtr hosts = impl->toElement();
+        std::ostringstream text;
+        text << hosts->size() << " entries returned.";
+        response = createAnswer(hosts->empty() ? CONTROL_RESULT_EMPTY :
+                                CONTROL_RESULT_SUCCESS, text.str(), hosts);
+    } catch (const std::exception& ex) {
+        response = createAnswer(CONTROL_RESULT_ERROR, ex.what());
+        handle.setArgument("response", response);
+        return (1);
+    }
+    handle.setArgument("response", response);
+    return (0);
+}
+
+/// @brief This is a command callout for 'cache-get-by-id' command.
+///
+/// Returns the cached hosts with the identifier given in arguments,
+/// e.g. { "hw-address": "01:02:03:04:05:06" }.
+///
+/// @param handle Callout handle used to retrieve a command and
+/// provide a response.
+/// @return 0 if this callout has been invoked successfully,
+/// 1 otherwise.
+int cache_get_by_id(CalloutHandle& handle) {
+    ConstElementPtr response;
+    try {
+        checkImpl();
+        ConstElementPtr args = getArguments(handle);
+        Host::IdentifierType identifier_type;
+        std::vector<uint8_t> identifier;
+        parseIdentifier(args, identifier_type, identifier);
+        ElementPtr hosts = impl->toElement(identifier_type, identifier);
+        std::ostringstream text;
+        text << hosts->size() << " entries returned.";
+        response = createAnswer(hosts->empty() ? CONTROL_RESULT_EMPTY :
+                                CONTROL_RESULT_SUCCESS, text.str(), hosts);
+    } catch (const std::exception& ex) {
+        response = createAnswer(CONTROL_RESULT_ERROR, ex.what());
+        handle.setArgument("response", response);
+        return (1);
+    }
+    handle.setArgument("response", response);
+    return (0);
+}
+
+/// @brief This is a command callout for 'cache-size' command.
+///
+/// Returns the number of entries, the maximum number of entries and
+/// the time to live of the entries.
+///
+/// @param handle Callout handle used to retrieve a command and
+/// provide a response.
+/// @return 0 if this callout has been invoked successfully,
+/// 1 otherwise.
+int cache_size(CalloutHandle& handle) {
+    ConstElementPtr response;
+    try {
+        checkImpl();
+        size_t size = impl->size();
+        ElementPtr args = Element::createMap();
+        args->set("size", Element::create(static_cast<int64_t>(size)));
+        args->set("maximum",
+                  Element::create(static_cast<int64_t>(impl->capacity())));
+        args->set("ttl", Element::create(static_cast<int64_t>(impl->getTtl())));
+        std::ostringstream text;
+        text << size << " entries.";
+        response = createAnswer(CONTROL_RESULT_SUCCESS, text.str(), args);
+    } catch (const std::exception& ex) {
+        response = createAnswer(CONTROL_RESULT_ERROR, ex.what());
+        handle.setArgument("response", response);
+        return (1);
+    }
+    handle.setArgument("response", response);
+    return (0);
+}
+
+/// @brief This is a command callout for 'cache-flush' command.
+///
+/// Removes the number of least recently used entries given in
+/// arguments.
+///
+/// @param handle Callout handle used to retrieve a command and
+/// provide a response.
+/// @return 0 if this callout has been invoked successfully,
+/// 1 otherwise.
+int cache_flush(CalloutHandle& handle) {
+    ConstElementPtr response;
+    try {
+        checkImpl();
+        ConstElementPtr args = getArguments(handle);
+        if (!args || (args->getType() != Element::integer)) {
+            isc_throw(BadValue, "invalid (not an integer) parameter");
+        }
+        int64_t count = args->intValue();
+        if (count <= 0) {
+            isc_throw(BadValue, "invalid (not positive) parameter");
+        }
+        impl->flush(static_cast<size_t>(count));
+        LOG_INFO(host_cache_logger, HOST_CACHE_FLUSH)
+            .arg(count);
+        response = createAnswer(CONTROL_RESULT_SUCCESS, "Cache flushed.");
+    } catch (const std::exception& ex) {
+        response = createAnswer(CONTROL_RESULT_ERROR, ex.what());
+        handle.setArgument("response", response);
+        return (1);
+    }
+    handle.setArgument("response", response);
+    return (0);
+}
+
+/// @brief This is a command callout for 'cache-clear' command.
+///
+/// Removes all the entries.
+///
+/// @param handle Callout handle used to retrieve a command and
+/// provide a response.
+/// @return 0 if this callout has been invoked successfully,
+/// 1 otherwise.
+int cache_clear(CalloutHandle& handle) {
+    ConstElementPtr response;
+    try {
+        checkImpl();
+        impl->flush(0);
+        LOG_INFO(host_cache_logger, HOST_CACHE_CLEAR);
+        response = createAnswer(CONTROL_RESULT_SUCCESS, "Cache cleared.");
+    } catch (const std::exception& ex) {
+        response = createAnswer(CONTROL_RESULT_ERROR, ex.what());
+        handle.setArgument("response", response);
+        return (1);
+    }
+    handle.setArgument("response", response);
+    return (0);
+}
+
+/// @brief This is a command callout for 'cache-remove' command.
+///
+/// Removes the cached hosts of a subnet by reserved address or by
+/// identifier, e.g. { "subnet-id": 1, "ip-address": "192.0.2.1" } or
+/// { "subnet-id": 1, "duid": "01:02:03:04" }.
+///
+/// @param handle Callout handle used to retrieve a command and
+/// provide a response.
+/// @return 0 if this callout has been invoked successfully,
+/// 1 otherwise.
+int cache_remove(CalloutHandle& handle) {
+    ConstElementPtr response;
+    try {
+        checkImpl();
+        ConstElementPtr args = getArguments(handle);
+        if (!args || (args->getType() != Element::map)) {
+            isc_throw(BadValue, "invalid (not a map) parameter");
+        }
+        ConstElementPtr subnet_id = args->get("subnet-id");
+        if (!subnet_id || (subnet_id->getType() != Element::integer)) {
+            isc_throw(BadValue, "missing or invalid 'subnet-id' parameter");
+        }
+        size_t removed = 0;
+        ConstElementPtr address = args->get("ip-address");
+        if (address) {
+            if (address->getType() != Element::string) {
+                isc_throw(BadValue, "invalid 'ip-address' parameter");
+            }
+            removed = impl->removeByAddress(subnet_id->intValue(),
+                                            IOAddress(address->stringValue()));
+        } else {
+            Host::IdentifierType identifier_type;
+            std::vector<uint8_t> identifier;
+            parseIdentifier(args, identifier_type, identifier);
+            removed = impl->removeByIdentifier(subnet_id->intValue(),
+                                               identifier_type, identifier);
+        }
+        if (removed == 0) {
+            response = createAnswer(CONTROL_RESULT_EMPTY, "Host not removed (not found).");
+        } else {
+            response = createAnswer(CONTROL_RESULT_SUCCESS, "Host removed.");
+        }
+    } catch (const std::exception& ex) {
+        response = createAnswer(CONTROL_RESULT_ERROR, ex.what());
+        handle.setArgument("response", response);
+        return (1);
+    }
+    handle.setArgument("response", response);
+    return (0);
+}
+
+/// @brief This function is called when the library is loaded.
+///
+/// It creates the host cache, registers the "cache" host backend
+/// factory which is used by the server to put the cache in front of
+/// the other host backends and registers the commands.
+///
+/// @param handle library handle
+/// @return 0 when initialization is successful, 1 otherwise
+int load(LibraryHandle& handle) {
+    try {
+        ConstElementPtr params = handle.getParameters();
+        impl = HostCache::create(params);
+        negative_caching = false;
+        if (params) {
+            ConstElementPtr value = params->get("negative-caching");
+            if (value) {
+                if (value->getType() != Element::boolean) {
+                    isc_throw(BadValue, "'negative-caching' must be a boolean");
+                }
+                negative_caching = value->boolValue();
+            }
+        }
+        HostDataSourceFactory::registerFactory("cache", factory, true);
+
+        StatsMgr& stats_mgr = StatsMgr::instance();
+        stats_mgr.setValue("host-cache-hits", static_cast<int64_t>(0));
+        stats_mgr.setValue("host-cache-misses", static_cast<int64_t>(0));
+        stats_mgr.setValue("host-cache-evictions", static_cast<int64_t>(0));
+
+        handle.registerCommandCallout("cache-clear", cache_clear);
+        handle.registerCommandCallout("cache-flush", cache_flush);
+        handle.registerCommandCallout("cache-get", cache_get);
+        handle.registerCommandCallout("cache-get-by-id", cache_get_by_id);
+        handle.registerCommandCallout("cache-remove", cache_remove);
+        handle.registerCommandCallout("cache-size", cache_size);
+    } catch (const std::exception& ex) {
+        impl.reset();
+        LOG_ERROR(host_cache_logger, HOST_CACHE_LOAD_ERROR)
+            .arg(ex.what());
+        return (1);
+    }
+
+    LOG_INFO(host_cache_logger, HOST_CACHE_INIT_OK)
+        .arg(impl->capacity())
+        .arg(impl->getTtl());
+    return (0);
+}
+
+/// @brief This function is called when the library is unloaded.
+///
+/// @return always 0.
+int unload() {
+    // The host manager must not keep the cache after the library is unloaded.
+    HostMgr::instance().delBackend("cache");
+    HostDataSourceFactory::deregisterFactory("cache", true);
+    impl.reset();
+    LOG_INFO(host_cache_logger, HOST_CACHE_UNLOAD);
+    return (0);
+}
+
+/// @brief This function is called to retrieve the multi-threading compatibility.
+///
+/// @return 1 which means compatible with multi-threading.
+int multi_threading_compatible() {
+    return (1);
+}
+
+} // end extern "C"
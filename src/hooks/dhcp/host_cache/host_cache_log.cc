@@ -0,0 +1,17 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <host_cache_log.h>
+
+namespace isc {
+namespace host_cache {
+
+isc::log::Logger host_cache_logger("host-cache-hooks");
+
+} // namespace host_cache
+} // namespace isc
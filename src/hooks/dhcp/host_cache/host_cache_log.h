@@ -0,0 +1,22 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef HOST_CACHE_LOG_H
+#define HOST_CACHE_LOG_H
+
+#include <log/logger_support.h>
+#include <log/macros.h>
+#include <log/log_dbglevels.h>
+#include <host_cache_messages.h>
+
+namespace isc {
+namespace host_cache {
+
+extern isc::log::Logger host_cache_logger;
+
+} // end of namespace host_cache
+} // end of namespace isc
+#endif
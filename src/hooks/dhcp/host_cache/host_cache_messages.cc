@@ -0,0 +1,27 @@
+// File created from ../../../../src/hooks/dhcp/host_cache/host_cache_messages.mes on Mon Jan 11 2021 10:12
+
+#include <cstddef>
+#include <log/message_types.h>
+#include <log/message_initializer.h>
+
+extern const isc::log::MessageID HOST_CACHE_CLEAR = "HOST_CACHE_CLEAR";
+extern const isc::log::MessageID HOST_CACHE_FLUSH = "HOST_CACHE_FLUSH";
+extern const isc::log::MessageID HOST_CACHE_INIT_OK = "HOST_CACHE_INIT_OK";
+extern const isc::log::MessageID HOST_CACHE_LOAD_ERROR = "HOST_CACHE_LOAD_ERROR";
+extern const isc::log::MessageID HOST_CACHE_UNLOAD = "HOST_CACHE_UNLOAD";
+
+namespace {
+
+const char* values[] = {
+    "HOST_CACHE_CLEAR", "host cache cleared",
+    "HOST_CACHE_FLUSH", "host cache flushed: %1 entries removed",
+    "HOST_CACHE_INIT_OK", "loading Host Cache hooks library successful: maximum %1 entries, ttl %2 seconds",
+    "HOST_CACHE_LOAD_ERROR", "loading Host Cache hooks library failed: %1",
+    "HOST_CACHE_UNLOAD", "Host Cache hooks library has been unloaded",
+    NULL
+};
+
+const isc::log::MessageInitializer initializer(values);
+
+} // Anonymous namespace
+
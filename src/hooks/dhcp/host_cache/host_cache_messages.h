@@ -0,0 +1,14 @@
+// File created from ../../../../src/hooks/dhcp/host_cache/host_cache_messages.mes on Mon Jan 11 2021 10:12
+
+#ifndef HOST_CACHE_MESSAGES_H
+#define HOST_CACHE_MESSAGES_H
+
+#include <log/message_types.h>
+
+extern const isc::log::MessageID HOST_CACHE_CLEAR;
+extern const isc::log::MessageID HOST_CACHE_FLUSH;
+extern const isc::log::MessageID HOST_CACHE_INIT_OK;
+extern const isc::log::MessageID HOST_CACHE_LOAD_ERROR;
+extern const isc::log::MessageID HOST_CACHE_UNLOAD;
+
+#endif // HOST_CACHE_MESSAGES_H
@@ -0,0 +1,290 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file This file contains tests which verify the host cache.
+
+#include <config.h>
+#include <host_cache.h>
+#include <asiolink/io_address.h>
+#include <dhcpsrv/host_data_source_factory.h>
+#include <dhcpsrv/host_mgr.h>
+#include <stats/stats_mgr.h>
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::host_cache;
+using namespace isc::stats;
+
+namespace {
+
+/// @brief Test fixture for testing the host cache.
+class HostCacheTest : public ::testing::Test {
+public:
+    /// @brief Constructor.
+    HostCacheTest() {
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Destructor.
+    virtual ~HostCacheTest() {
+        HostDataSourceFactory::deregisterFactory("cache", true);
+        HostMgr::create();
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Creates an IPv4 host.
+    ///
+    /// @param hwaddr Hardware address.
+    /// @param subnet_id IPv4 subnet identifier.
+    /// @param address Reserved IPv4 address.
+    static HostPtr createHost4(const string& hwaddr, const SubnetID& subnet_id,
+                               const string& address) {
+        return (HostPtr(new Host(hwaddr, "hw-address", subnet_id,
+                                 SUBNET_ID_UNUSED, IOAddress(address))));
+    }
+
+    /// @brief Creates an IPv6 host.
+    ///
+    /// @param duid DUID.
+    /// @param subnet_id IPv6 subnet identifier.
+    /// @param address Reserved IPv6 address.
+    static HostPtr createHost6(const string& duid, const SubnetID& subnet_id,
+                               const string& address) {
+        HostPtr host(new Host(duid, "duid", SUBNET_ID_UNUSED, subnet_id,
+                              IOAddress::IPV4_ZERO_ADDRESS()));
+        host->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA, IOAddress(address)));
+        return (host);
+    }
+
+    /// @brief Returns the IPv4 host from the cache by hardware address.
+    ///
+    /// @param cache The host cache.
+    /// @param hwaddr Hardware address.
+    /// @param subnet_id IPv4 subnet identifier.
+    static ConstHostPtr get4(const HostCache& cache, const string& hwaddr,
+                             const SubnetID& subnet_id) {
+        HostPtr key = createHost4(hwaddr, subnet_id, "0.0.0.0");
+        const vector<uint8_t>& id = key->getIdentifier();
+        return (cache.get4(subnet_id, Host::IDENT_HWADDR, &id[0], id.size()));
+    }
+
+    /// @brief Returns the value of an integer statistic.
+    ///
+    /// @param name Name of the statistic.
+    static int64_t getStat(const string& name) {
+        ObservationPtr stat = StatsMgr::instance().getObservation(name);
+        return (stat ? stat->getInteger().first : 0);
+    }
+};
+
+// Verifies the parameters of the library.
+TEST_F(HostCacheTest, create) {
+    HostCachePtr cache;
+    ASSERT_NO_THROW(cache = HostCache::create(ConstElementPtr()));
+    EXPECT_EQ(0, cache->capacity());
+    EXPECT_EQ(0, cache->getTtl());
+    EXPECT_EQ("cache", cache->getType());
+
+    ASSERT_NO_THROW(cache = HostCache::create(
+        Element::fromJSON("{ \"maximum\": 100, \"ttl\": 60 }")));
+    EXPECT_EQ(100, cache->capacity());
+    EXPECT_EQ(60, cache->getTtl());
+
+    EXPECT_THROW(HostCache::create(Element::fromJSON("[ ]")), BadValue);
+    EXPECT_THROW(HostCache::create(Element::fromJSON("{ \"maximum\": -1 }")),
+                 BadValue);
+    EXPECT_THROW(HostCache::create(Element::fromJSON("{ \"maximum\": \"1\" }")),
+                 BadValue);
+    EXPECT_THROW(HostCache::create(Element::fromJSON("{ \"ttl\": -1 }")),
+                 BadValue);
+}
+
+// Verifies that the cached hosts are returned and that the hits and
+// misses are counted.
+TEST_F(HostCacheTest, get) {
+    HostCache cache;
+    HostPtr host4 = createHost4("01:02:03:04:05:06", 1, "192.0.2.10");
+    HostPtr host6 = createHost6("01:02:03:04", 2, "2001:db8::10");
+    EXPECT_EQ(0, cache.insert(host4, false));
+    EXPECT_EQ(0, cache.insert(host6, false));
+    EXPECT_EQ(2, cache.size());
+
+    EXPECT_EQ(host4, get4(cache, "01:02:03:04:05:06", 1));
+    EXPECT_FALSE(get4(cache, "01:02:03:04:05:06", 2));
+    EXPECT_EQ(host4, cache.get4(1, IOAddress("192.0.2.10")));
+    EXPECT_FALSE(cache.get4(1, IOAddress("192.0.2.11")));
+
+    const vector<uint8_t>& duid = host6->getIdentifier();
+    EXPECT_EQ(host6, cache.get6(2, Host::IDENT_DUID, &duid[0], duid.size()));
+    EXPECT_FALSE(cache.get6(1, Host::IDENT_DUID, &duid[0], duid.size()));
+
+    EXPECT_EQ(3, getStat("host-cache-hits"));
+    EXPECT_EQ(3, getStat("host-cache-misses"));
+
+    // Collections and IPv6 lookups by address are not cached.
+    EXPECT_TRUE(cache.getAll4(1).empty());
+    EXPECT_TRUE(cache.getAll4(IOAddress("192.0.2.10")).empty());
+    EXPECT_FALSE(cache.get6(2, IOAddress("2001:db8::10")));
+}
+
+// Verifies the handling of conflicts on insertion.
+TEST_F(HostCacheTest, insertConflicts) {
+    HostCache cache;
+    HostPtr host = createHost4("01:02:03:04:05:06", 1, "192.0.2.10");
+    EXPECT_EQ(0, cache.insert(host, false));
+
+    // Same identifier in the same subnet.
+    HostPtr same_id = createHost4("01:02:03:04:05:06", 1, "192.0.2.11");
+    EXPECT_EQ(1, cache.insert(same_id, false));
+    EXPECT_EQ(host, get4(cache, "01:02:03:04:05:06", 1));
+
+    // Same address in the same subnet.
+    HostPtr same_addr = createHost4("01:02:03:04:05:07", 1, "192.0.2.10");
+    EXPECT_EQ(1, cache.insert(same_addr, false));
+    EXPECT_EQ(1, cache.size());
+
+    // Overwrite removes the conflicting entries.
+    EXPECT_EQ(1, cache.insert(same_id, true));
+    EXPECT_EQ(same_id, get4(cache, "01:02:03:04:05:06", 1));
+    EXPECT_FALSE(cache.get4(1, IOAddress("192.0.2.10")));
+    EXPECT_EQ(1, cache.size());
+
+    // Another subnet is not a conflict.
+    EXPECT_EQ(0, cache.insert(createHost4("01:02:03:04:05:06", 2,
+                                          "192.0.2.10"), false));
+    EXPECT_EQ(2, cache.size());
+}
+
+// Verifies that the least recently used entries are evicted.
+TEST_F(HostCacheTest, lru) {
+    HostCache cache(2);
+    EXPECT_EQ(2, cache.capacity());
+    cache.insert(createHost4("01:02:03:04:05:01", 1, "192.0.2.1"), false);
+    cache.insert(createHost4("01:02:03:04:05:02", 1, "192.0.2.2"), false);
+
+    // The lookup makes the first host the most recently used.
+    EXPECT_TRUE(get4(cache, "01:02:03:04:05:01", 1));
+
+    cache.insert(createHost4("01:02:03:04:05:03", 1, "192.0.2.3"), false);
+    EXPECT_EQ(2, cache.size());
+    EXPECT_TRUE(get4(cache, "01:02:03:04:05:01", 1));
+    EXPECT_FALSE(get4(cache, "01:02:03:04:05:02", 1));
+    EXPECT_TRUE(get4(cache, "01:02:03:04:05:03", 1));
+    EXPECT_EQ(1, getStat("host-cache-evictions"));
+
+    // Flush removes the least recently used entries.
+    cache.flush(1);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_TRUE(get4(cache, "01:02:03:04:05:03", 1));
+    cache.flush(0);
+    EXPECT_EQ(0, cache.size());
+}
+
+// Verifies that the entries expire.
+TEST_F(HostCacheTest, ttl) {
+    HostCache cache(0, 1);
+    cache.insert(createHost4("01:02:03:04:05:06", 1, "192.0.2.10"), false);
+    EXPECT_TRUE(get4(cache, "01:02:03:04:05:06", 1));
+    EXPECT_EQ(1, cache.toElement()->size());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+    EXPECT_EQ(0, cache.toElement()->size());
+    EXPECT_FALSE(get4(cache, "01:02:03:04:05:06", 1));
+    EXPECT_EQ(0, cache.size());
+    EXPECT_EQ(1, getStat("host-cache-misses"));
+}
+
+// Verifies the removal of the cached hosts.
+TEST_F(HostCacheTest, remove) {
+    HostCache cache;
+    HostPtr host4 = createHost4("01:02:03:04:05:06", 1, "192.0.2.10");
+    HostPtr host6 = createHost6("01:02:03:04", 2, "2001:db8::10");
+    cache.insert(host4, false);
+    cache.insert(host6, false);
+
+    // The deletions are propagated to the other backends.
+    const vector<uint8_t>& hwaddr = host4->getIdentifier();
+    EXPECT_FALSE(cache.del4(1, Host::IDENT_HWADDR, &hwaddr[0], hwaddr.size()));
+    EXPECT_EQ(1, cache.size());
+    EXPECT_FALSE(cache.del(2, IOAddress("2001:db8::10")));
+    EXPECT_EQ(0, cache.size());
+
+    cache.insert(host4, false);
+    cache.insert(host6, false);
+    EXPECT_EQ(1, cache.removeByAddress(1, IOAddress("192.0.2.10")));
+    EXPECT_EQ(1, cache.removeByIdentifier(2, Host::IDENT_DUID,
+                                          host6->getIdentifier()));
+    EXPECT_EQ(0, cache.size());
+
+    // A copy does not remove the cached host.
+    cache.insert(host4, false);
+    HostPtr copy(new Host(*host4));
+    EXPECT_FALSE(cache.remove(copy));
+    EXPECT_TRUE(cache.remove(host4));
+    EXPECT_EQ(0, cache.size());
+}
+
+// Verifies the list of the cached hosts.
+TEST_F(HostCacheTest, toElement) {
+    HostCache cache;
+    cache.insert(createHost4("01:02:03:04:05:06", 1, "192.0.2.10"), false);
+    cache.insert(createHost6("01:02:03:04", 2, "2001:db8::10"), false);
+
+    ElementPtr hosts = cache.toElement();
+    ASSERT_EQ(2, hosts->size());
+    EXPECT_EQ("01:02:03:04", hosts->get(0)->get("duid")->stringValue());
+    EXPECT_EQ(2, hosts->get(0)->get("subnet-id")->intValue());
+    EXPECT_EQ("192.0.2.10", hosts->get(1)->get("ip-address")->stringValue());
+    EXPECT_EQ(1, hosts->get(1)->get("subnet-id")->intValue());
+
+    hosts = cache.toElement(Host::IDENT_HWADDR,
+                            createHost4("01:02:03:04:05:06", 1,
+                                        "0.0.0.0")->getIdentifier());
+    ASSERT_EQ(1, hosts->size());
+    EXPECT_EQ("01:02:03:04:05:06", hosts->get(0)->get("hw-address")->stringValue());
+}
+
+// Verifies that the host manager uses the cache as the first backend
+// and caches negative answers.
+TEST_F(HostCacheTest, hostMgr) {
+    HostCachePtr cache(new HostCache());
+    HostDataSourceFactory::registerFactory("cache",
+        [cache](const db::DatabaseConnection::ParameterMap&) {
+            return (cache);
+        }, true);
+    HostMgr::create();
+    HostMgr::addBackend("type=cache");
+    ASSERT_TRUE(HostMgr::checkCacheBackend());
+    HostMgr::instance().setNegativeCaching(true);
+
+    HostPtr key = createHost4("01:02:03:04:05:06", 1, "0.0.0.0");
+    const vector<uint8_t>& id = key->getIdentifier();
+    EXPECT_FALSE(HostMgr::instance().get4(1, Host::IDENT_HWADDR,
+                                          &id[0], id.size()));
+    ASSERT_EQ(1, cache->size());
+    EXPECT_EQ(1, getStat("host-cache-misses"));
+
+    // The negative entry is returned by the cache.
+    EXPECT_FALSE(HostMgr::instance().get4(1, Host::IDENT_HWADDR,
+                                          &id[0], id.size()));
+    EXPECT_EQ(1, getStat("host-cache-hits"));
+    EXPECT_TRUE(cache->toElement()->get(0)->get("negative")->boolValue());
+
+    // A real host replaces the negative entry.
+    HostPtr host = createHost4("01:02:03:04:05:06", 1, "192.0.2.10");
+    EXPECT_EQ(1, cache->insert(host, true));
+    EXPECT_EQ(host, HostMgr::instance().get4(1, Host::IDENT_HWADDR,
+                                             &id[0], id.size()));
+}
+
+} // end of anonymous namespace
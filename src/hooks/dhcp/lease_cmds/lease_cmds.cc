@@ -32,6 +32,7 @@
 
 #include <boost/scoped_ptr.hpp>
 #include <boost/algorithm/string.hpp>
+#include <set>
 #include <string>
 #include <sstream>
 
@@ -1598,49 +1599,50 @@ LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
         ElementPtr failed_deleted_list;
         if (!parsed_deleted_list.empty()) {
 
-            // Iterate over leases to be deleted.
+            // Delete the leases in a single batch.
+            LeaseChange6Collection changes;
+            std::vector<Parameters> changes_params;
             for (auto lease_params_pair : parsed_deleted_list) {
+                if (lease_params_pair.second) {
+                    changes.push_back(LeaseChange6(LeaseChange6::DELETE,
+                                                   lease_params_pair.second));
+                    changes_params.push_back(lease_params_pair.first);
+                }
+            }
 
-                // This part is outside of the try-catch because an exception
-                // indicates that the command is malformed.
-                Parameters p = lease_params_pair.first;
-                auto lease = lease_params_pair.second;
+            LeaseMgrFactory::instance().applyLeaseChanges(changes);
 
-                try {
-                    if (lease) {
-                        // This may throw if the lease couldn't be deleted for
-                        // any reason, but we still want to proceed with other
-                        // leases.
-                        if (LeaseMgrFactory::instance().deleteLease(lease)) {
-                            ++success_count;
-                            LeaseCmdsImpl::updateStatsOnDelete(lease);
+            for (size_t i = 0; i < changes.size(); ++i) {
+                const Parameters& p = changes_params[i];
+                const LeaseChange6& change = changes[i];
 
-                        } else {
-                            // Lazy creation of the list of leases which failed to delete.
-                            if (!failed_deleted_list) {
-                                failed_deleted_list = Element::createList();
-                            }
-
-                            // If the lease doesn't exist we also want to put it
-                            // on the list of leases which failed to delete. That
-                            // corresponds to the lease6-del command which returns
-                            // an error when the lease doesn't exist.
-                            failed_deleted_list->add(createFailedLeaseMap(p.lease_type,
-                                                                          p.addr, p.duid,
-                                                                          CONTROL_RESULT_EMPTY,
-                                                                          "lease not found"));
-                        }
-                    }
+                if (change.applied_) {
+                    ++success_count;
+                    LeaseCmdsImpl::updateStatsOnDelete(change.lease_);
+                    continue;
+                }
 
-                } catch (const std::exception& ex) {
-                    // Lazy creation of the list of leases which failed to delete.
-                    if (!failed_deleted_list) {
-                         failed_deleted_list = Element::createList();
-                    }
+                // Lazy creation of the list of leases which failed to delete.
+                if (!failed_deleted_list) {
+                    failed_deleted_list = Element::createList();
+                }
+
+                if (!change.error_.empty()) {
+                    // The lease couldn't be deleted for any reason, but the
+                    // other leases have been processed.
                     failed_deleted_list->add(createFailedLeaseMap(p.lease_type,
                                                                   p.addr, p.duid,
                                                                   CONTROL_RESULT_ERROR,
-                                                                  ex.what()));
+                                                                  change.error_));
+                } else {
+                    // If the lease doesn't exist we also want to put it
+                    // on the list of leases which failed to delete. That
+                    // corresponds to the lease6-del command which returns
+                    // an error when the lease doesn't exist.
+                    failed_deleted_list->add(createFailedLeaseMap(p.lease_type,
+                                                                  p.addr, p.duid,
+                                                                  CONTROL_RESULT_EMPTY,
+                                                                  "lease not found"));
                 }
             }
         }
@@ -1648,29 +1650,92 @@ LeaseCmdsImpl::lease6BulkApplyHandler(CalloutHandle& handle) {
         // Process leases to be added or/and updated.
         ElementPtr failed_leases_list;
         if (!parsed_leases_list.empty()) {
-            ConstSrvConfigPtr config = CfgMgr::instance().getCurrentCfg();
 
-            // Iterate over all leases.
-            for (auto lease : parsed_leases_list) {
+            // Leases which are being processed by the packet processing
+            // threads in multi-threading mode and leases which appear more
+            // than once in the command are added or updated one by one after
+            // the other leases have been added or updated in a single batch.
+            std::list<Lease6Ptr> deferred_leases_list;
+            {
+                bool use_locks = (MultiThreadingMgr::instance().getMode() &&
+                                  !MultiThreadingMgr::instance().isInCriticalSection());
+                ResourceHandler resource_handler;
+                std::set<std::pair<Lease::Type, IOAddress> > batched;
+                LeaseChange6Collection changes;
+                Lease6Collection existing_leases;
+
+                for (auto lease : parsed_leases_list) {
+                    if (!batched.insert(std::make_pair(lease->type_, lease->addr_)).second ||
+                        (use_locks && !resource_handler.tryLock(lease->type_, lease->addr_))) {
+                        deferred_leases_list.push_back(lease);
+                        continue;
+                    }
+
+                    try {
+                        Lease6Ptr existing =
+                            LeaseMgrFactory::instance().getLease6(lease->type_, lease->addr_);
+                        if (existing) {
+                            // Update lease current expiration time with value received from the
+                            // database. Some database backends reject operations on the lease if
+                            // the current expiration time value does not match what is stored.
+                            Lease::syncCurrentExpirationTime(*existing, *lease);
+                            changes.push_back(LeaseChange6(LeaseChange6::UPDATE, lease));
+                        } else {
+                            changes.push_back(LeaseChange6(LeaseChange6::ADD, lease));
+                        }
+                        existing_leases.push_back(existing);
+
+                    } catch (const std::exception& ex) {
+                        // Lazy creation of the list of leases which failed to add/update.
+                        if (!failed_leases_list) {
+                            failed_leases_list = Element::createList();
+                        }
+                        failed_leases_list->add(createFailedLeaseMap(lease->type_,
+                                                                     lease->addr_,
+                                                                     lease->duid_,
+                                                                     CONTROL_RESULT_ERROR,
+                                                                     ex.what()));
+                    }
+                }
+
+                LeaseMgrFactory::instance().applyLeaseChanges(changes);
+
+                for (size_t i = 0; i < changes.size(); ++i) {
+                    const LeaseChange6& change = changes[i];
+                    if (change.applied_) {
+                        if (change.type_ == LeaseChange6::ADD) {
+                            LeaseCmdsImpl::updateStatsOnAdd(change.lease_);
+                        } else {
+                            LeaseCmdsImpl::updateStatsOnUpdate(existing_leases[i],
+                                                               change.lease_);
+                        }
+                        ++success_count;
+                        continue;
+                    }
+
+                    // Lazy creation of the list of leases which failed to add/update.
+                    if (!failed_leases_list) {
+                        failed_leases_list = Element::createList();
+                    }
+                    failed_leases_list->add(createFailedLeaseMap(change.lease_->type_,
+                                                                 change.lease_->addr_,
+                                                                 change.lease_->duid_,
+                                                                 CONTROL_RESULT_ERROR,
+                                                                 change.error_.empty() ?
+                                                                 "lost race between calls to get and add" :
+                                                                 change.error_));
+                }
+            }
+
+            // Iterate over the deferred leases.
+            for (auto lease : deferred_leases_list) {
 
                 try {
                     if (MultiThreadingMgr::instance().getMode() &&
                         !MultiThreadingMgr::instance().isInCriticalSection()) {
-                        bool use_cs = false;
-                        {
-                            // Try to avoid a race.
-                            ResourceHandler resource_handler;
-                            use_cs = !resource_handler.tryLock(lease->type_,
-                                                               lease->addr_);
-                            if (!use_cs) {
-                                addOrUpdate6(lease, true);
-                            }
-                        }
-                        if (use_cs) {
-                            // Failed to avoid the race.
-                            MultiThreadingCriticalSection cs;
-                            addOrUpdate6(lease, true);
-                        }
+                        // The lease may be in use by a packet processing thread.
+                        MultiThreadingCriticalSection cs;
+                        addOrUpdate6(lease, true);
                     } else {
                         // No multi-threading.
                         addOrUpdate6(lease, true);
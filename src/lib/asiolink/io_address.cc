@@ -180,8 +180,11 @@ hash_value(const IOAddress& address) {
         boost::hash<uint32_t> hasher;
         return (hasher(address.toUint32()));
     } else {
-        boost::hash<std::vector<uint8_t> > hasher;
-        return (hasher(address.toBytes()));
+        // Hash the bytes in place: this gives the same value as hashing
+        // the vector returned by toBytes() without allocating it.
+        const boost::asio::ip::address_v6::bytes_type bytes6 =
+            address.asio_address_.to_v6().to_bytes();
+        return (boost::hash_range(bytes6.begin(), bytes6.end()));
     }
 }
 
@@ -284,6 +284,9 @@ public:
 
 private:
     boost::asio::ip::address asio_address_;
+
+    /// \brief Hash the IOAddress without copying its bytes.
+    friend size_t hash_value(const IOAddress& address);
 };
 
 /// \brief Insert the IOAddress as a string into stream.
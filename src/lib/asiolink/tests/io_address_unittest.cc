@@ -11,6 +11,8 @@
 #include <asiolink/io_address.h>
 #include <exceptions/exceptions.h>
 
+#include <boost/functional/hash.hpp>
+
 #include <algorithm>
 #include <cstring>
 #include <vector>
@@ -339,3 +341,16 @@ TEST(IOAddressTest, increaseAddr) {
     EXPECT_EQ(IOAddress("::1"), IOAddress::increase(any6));
     EXPECT_EQ(IOAddress("::"), IOAddress::increase(the_last_one));
 }
+
+// Test checks that the hash of an address is the hash of its bytes.
+TEST(IOAddressTest, hashValue) {
+    IOAddress addr4("192.0.2.1");
+    IOAddress addr6("2001:db8::1");
+
+    boost::hash<uint32_t> hasher4;
+    EXPECT_EQ(hasher4(addr4.toUint32()), hash_value(addr4));
+
+    boost::hash<std::vector<uint8_t> > hasher6;
+    EXPECT_EQ(hasher6(addr6.toBytes()), hash_value(addr6));
+    EXPECT_NE(hash_value(addr6), hash_value(IOAddress("2001:db8::2")));
+}
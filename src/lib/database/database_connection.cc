@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -168,7 +168,10 @@ DatabaseConnection::toElement(const ParameterMap& params) {
             (keyword == "request-timeout") ||
             (keyword == "tcp-keepalive") ||
             (keyword == "port") ||
-            (keyword == "max-row-errors")) {
+            (keyword == "max-row-errors") ||
+            (keyword == "write-interval") ||
+            (keyword == "write-batch-size") ||
+            (keyword == "write-queue-size")) {
             // integer parameters
             int64_t int_value;
             try {
@@ -197,7 +200,8 @@ DatabaseConnection::toElement(const ParameterMap& params) {
                    (keyword == "contact-points") ||
                    (keyword == "consistency") ||
                    (keyword == "serial-consistency") ||
-                   (keyword == "keyspace")) {
+                   (keyword == "keyspace") ||
+                   (keyword == "write-policy")) {
             result->set(keyword, isc::data::Element::create(value));
         } else {
             LOG_ERROR(database_logger, DATABASE_TO_JSON_ERROR)
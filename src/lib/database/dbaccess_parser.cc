@@ -55,6 +55,9 @@ DbAccessParser::parse(std::string& access_string,
     int64_t request_timeout = 0;
     int64_t tcp_keepalive = 0;
     int64_t max_row_errors = 0;
+    int64_t write_interval = 0;
+    int64_t write_batch_size = 1;
+    int64_t write_queue_size = 1;
 
     // 2. Update the copy with the passed keywords.
     for (std::pair<std::string, ConstElementPtr> param : database_config->mapValue()) {
@@ -104,6 +107,21 @@ DbAccessParser::parse(std::string& access_string,
                 max_row_errors = param.second->intValue();
                 values_copy[param.first] =
                     boost::lexical_cast<std::string>(max_row_errors);
+
+            } else if (param.first == "write-interval") {
+                write_interval = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(write_interval);
+
+            } else if (param.first == "write-batch-size") {
+                write_batch_size = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(write_batch_size);
+
+            } else if (param.first == "write-queue-size") {
+                write_queue_size = param.second->intValue();
+                values_copy[param.first] =
+                    boost::lexical_cast<std::string>(write_queue_size);
             } else {
                 // all remaining string parameters
                 // type
@@ -115,6 +133,7 @@ DbAccessParser::parse(std::string& access_string,
                 // keyspace
                 // consistency
                 // serial-consistency
+                // write-policy
                 values_copy[param.first] = param.second->stringValue();
             }
         } catch (const isc::data::TypeError& ex) {
@@ -233,6 +252,36 @@ DbAccessParser::parse(std::string& access_string,
                   << "(" << value->getPosition() << ")");
     }
 
+    // Check that the write-interval is within a reasonable range.
+    if ((write_interval < 0) ||
+        (write_interval > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("write-interval");
+        isc_throw(DbConfigError, "write-interval value: " << write_interval
+                  << " is out of range, expected value: 0.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the write-batch-size is within a reasonable range.
+    if ((write_batch_size < 1) ||
+        (write_batch_size > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("write-batch-size");
+        isc_throw(DbConfigError, "write-batch-size value: " << write_batch_size
+                  << " is out of range, expected value: 1.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
+    // Check that the write-queue-size is within a reasonable range.
+    if ((write_queue_size < 1) ||
+        (write_queue_size > std::numeric_limits<uint32_t>::max())) {
+        ConstElementPtr value = database_config->get("write-queue-size");
+        isc_throw(DbConfigError, "write-queue-size value: " << write_queue_size
+                  << " is out of range, expected value: 1.."
+                  << std::numeric_limits<uint32_t>::max()
+                  << " (" << value->getPosition() << ")");
+    }
+
     // 4. If all is OK, update the stored keyword/value pairs.  We do this by
     // swapping contents - values_copy is destroyed immediately after the
     // operation (when the method exits), so we are not interested in its new
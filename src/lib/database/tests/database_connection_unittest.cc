@@ -280,7 +280,11 @@ TEST(DatabaseConnection, toElementDbAccessStringValid) {
         "\"tcp-nodelay\": false, \n"
         "\"type\": \"memfile\", \n"
         "\"user\": \"user_str\", \n"
-        "\"max-row-errors\": 50 \n"
+        "\"max-row-errors\": 50, \n"
+        "\"write-policy\": \"group-commit\", \n"
+        "\"write-interval\": 10, \n"
+        "\"write-batch-size\": 100, \n"
+        "\"write-queue-size\": 1000 \n"
         "}\n"
     };
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -169,6 +169,9 @@ private:
                  (parameter != "connect-timeout") &&
                  (parameter != "port") &&
                  (parameter != "max-row-errors") &&
+                 (parameter != "write-interval") &&
+                 (parameter != "write-batch-size") &&
+                 (parameter != "write-queue-size") &&
                  (parameter != "readonly"));
     }
 
@@ -353,6 +356,49 @@ TEST_F(DbAccessParserTest, largeLFCInterval) {
     EXPECT_THROW(parser.parse(json_elements), DbConfigError);
 }
 
+// This test checks that the parser accepts the valid values of the
+// lease file write parameters.
+TEST_F(DbAccessParserTest, validWriteParameters) {
+    const char* config[] = {"type", "memfile",
+                            "name", "/opt/var/lib/kea/kea-leases6.csv",
+                            "write-policy", "group-commit",
+                            "write-interval", "10",
+                            "write-batch-size", "100",
+                            "write-queue-size", "10000",
+                            NULL};
+
+    string json_config = toJson(config);
+    ConstElementPtr json_elements = Element::fromJSON(json_config);
+    EXPECT_TRUE(json_elements);
+
+    TestDbAccessParser parser;
+    EXPECT_NO_THROW(parser.parse(json_elements));
+    checkAccessString("Valid write parameters", parser.getDbAccessParameters(),
+                      config);
+}
+
+// This test checks that the parser rejects out of range values of the
+// lease file write parameters.
+TEST_F(DbAccessParserTest, invalidWriteParameters) {
+    const char* interval[] = {"type", "memfile",
+                              "write-interval", "-1",
+                              NULL};
+    const char* batch_size[] = {"type", "memfile",
+                                "write-batch-size", "0",
+                                NULL};
+    const char* queue_size[] = {"type", "memfile",
+                                "write-queue-size", "4294967296",
+                                NULL};
+
+    for (auto config : { interval, batch_size, queue_size }) {
+        ConstElementPtr json_elements = Element::fromJSON(toJson(config));
+        EXPECT_TRUE(json_elements);
+
+        TestDbAccessParser parser;
+        EXPECT_THROW(parser.parse(json_elements), DbConfigError);
+    }
+}
+
 // This test checks that the parser accepts the valid value of the
 // timeout parameter.
 TEST_F(DbAccessParserTest, validTimeout) {
@@ -12,9 +12,12 @@
 #include <dhcp/dhcp6.h>
 #include <dhcp/iface_mgr.h>
 #include <dhcp/iface_mgr_error_handler.h>
+#include <dhcp/packet_send_queue.h>
 #include <dhcp/pkt_filter_inet.h>
 #include <dhcp/pkt_filter_inet6.h>
 #include <exceptions/exceptions.h>
+#include <stats/stats_mgr.h>
+#include <util/fd_event_handler_factory.h>
 #include <util/io/pktinfo_utilities.h>
 #include <util/multi_threading_mgr.h>
 
@@ -33,22 +36,30 @@
 #include <sys/ioctl.h>
 #include <sys/select.h>
 
-#ifndef FD_COPY
-#define FD_COPY(orig, copy) \
-    do { \
-        memmove(copy, orig, sizeof(fd_set)); \
-    } while (0)
-#endif
-
 using namespace std;
 using namespace isc::asiolink;
+using namespace isc::stats;
 using namespace isc::util;
 using namespace isc::util::io;
 using namespace isc::util::io::internal;
 
+namespace {
+
+/// @brief Counter incremented each time an interface socket or an external
+/// socket is added or removed.
+///
+/// It is used by the interface manager to register the sockets to its
+/// event handler again only when they have changed.
+std::atomic<uint64_t> sockets_generation(1);
+
+} // end of anonymous namespace
+
 namespace isc {
 namespace dhcp {
 
+const size_t IfaceMgr::MAX_RECEIVE_BATCH_SIZE;
+const size_t IfaceMgr::MAX_SEND_BATCH_SIZE;
+
 IfaceMgr&
 IfaceMgr::instance() {
     return (*instancePtr());
@@ -110,6 +121,7 @@ Iface::closeSockets(const uint16_t family) {
                 close(sock->fallbackfd_);
             }
             sockets_.erase(sock++);
+            ++sockets_generation;
 
         } else {
             // Different type of socket. Let's move
@@ -166,6 +178,12 @@ bool Iface::delAddress(const isc::asiolink::IOAddress& addr) {
     return (false);
 }
 
+void
+Iface::addSocket(const SocketInfo& sock) {
+    sockets_.push_back(sock);
+    ++sockets_generation;
+}
+
 bool Iface::delSocket(const uint16_t sockfd) {
     list<SocketInfo>::iterator sock = sockets_.begin();
     while (sock!=sockets_.end()) {
@@ -176,6 +194,7 @@ bool Iface::delSocket(const uint16_t sockfd) {
                 close(sock->fallbackfd_);
             }
             sockets_.erase(sock);
+            ++sockets_generation;
             return (true); //socket found
         }
         ++sock;
@@ -187,7 +206,23 @@ IfaceMgr::IfaceMgr()
     : packet_filter_(new PktFilterInet()),
       packet_filter6_(new PktFilterInet6()),
       test_mode_(false),
-      allow_loopback_(false) {
+      allow_loopback_(false),
+      receive_batch_size_(1),
+      receive_batches4_(0),
+      receive_batch_pkts4_(0),
+      receive_batches6_(0),
+      receive_batch_pkts6_(0),
+      send_batch_size_(1),
+      send_batches4_(0),
+      send_batch_pkts4_(0),
+      send_batches6_(0),
+      send_batch_pkts6_(0),
+      raw_socket_ring_(false),
+      event_handler_type_(FDEventHandler::TYPE_SELECT),
+      fd_event_handler_(FDEventHandlerFactory::factoryFDEventHandler(event_handler_type_)),
+      fd_event_handler_generation_(0),
+      fd_event_handler_mode_(AF_UNSPEC),
+      event_sockets_() {
 
     // Ensure that PQMs have been created to guarantee we have
     // default packet queues in place.
@@ -290,6 +325,13 @@ void IfaceMgr::closeSockets() {
     // Stops the receiver thread if there is one.
     stopDHCPReceiver();
 
+    // Drop packets left over from batched reads on the closed sockets.
+    pending_pkts4_.clear();
+    pending_pkts6_.clear();
+
+    // Sockets descriptors may be reused by new sockets.
+    clearSendQueues();
+
     for (IfacePtr iface : ifaces_) {
         iface->closeSockets();
     }
@@ -301,6 +343,7 @@ void IfaceMgr::stopDHCPReceiver() {
     }
 
     dhcp_receiver_.reset();
+    ++sockets_generation;
 
     if (getPacketQueue4()) {
         getPacketQueue4()->clear();
@@ -341,6 +384,7 @@ IfaceMgr::addExternalSocket(int socketfd, SocketCallback callback) {
     x.socket_ = socketfd;
     x.callback_ = callback;
     callbacks_.push_back(x);
+    ++sockets_generation;
 }
 
 void
@@ -355,6 +399,7 @@ IfaceMgr::deleteExternalSocketInternal(int socketfd) {
          s != callbacks_.end(); ++s) {
         if (s->socket_ == socketfd) {
             callbacks_.erase(s);
+            ++sockets_generation;
             return;
         }
     }
@@ -382,6 +427,7 @@ void
 IfaceMgr::deleteAllExternalSockets() {
     std::lock_guard<std::mutex> lock(callbacks_mutex_);
     callbacks_.clear();
+    ++sockets_generation;
 }
 
 void
@@ -750,6 +796,7 @@ IfaceMgr::startDHCPReceiver(const uint16_t family) {
 
         dhcp_receiver_.reset(new WatchedThread());
         dhcp_receiver_->start(std::bind(&IfaceMgr::receiveDHCP4Packets, this));
+        ++sockets_generation;
         break;
     case AF_INET6:
         // If the queue doesn't exist, packet queing has been configured
@@ -760,6 +807,7 @@ IfaceMgr::startDHCPReceiver(const uint16_t family) {
 
         dhcp_receiver_.reset(new WatchedThread());
         dhcp_receiver_->start(std::bind(&IfaceMgr::receiveDHCP6Packets, this));
+        ++sockets_generation;
         break;
     default:
         isc_throw (BadValue, "startDHCPReceiver: invalid family: " << family);
@@ -778,6 +826,7 @@ IfaceMgr::addInterface(const IfacePtr& iface) {
         }
     }
     ifaces_.push_back(iface);
+    ++sockets_generation;
 }
 
 void
@@ -899,6 +948,7 @@ IfaceMgr::getIface(const PktPtr& pkt) {
 void
 IfaceMgr::clearIfaces() {
     ifaces_.clear();
+    ++sockets_generation;
 }
 
 void
@@ -1105,9 +1155,23 @@ IfaceMgr::send(const Pkt6Ptr& pkt) {
                   << pkt->getIface() << ") specified.");
     }
 
-    // Assuming that packet filter is not null, because its modifier checks it.
-    // The packet filter returns an int but in fact it either returns 0 or throws.
-    return (packet_filter6_->send(*iface, getSocket(pkt), pkt) == 0);
+    const uint16_t sockfd = getSocket(pkt);
+    if (send_batch_size_ <= 1) {
+        // Assuming that packet filter is not null, because its modifier checks it.
+        // The packet filter returns an int but in fact it either returns 0 or throws.
+        return (packet_filter6_->send(*iface, sockfd, pkt) == 0);
+    }
+
+    // Let the send queue coalesce this packet with the packets sent
+    // concurrently over the same socket. It throws if this packet
+    // can't be sent.
+    getSendQueue6(sockfd)->send(pkt,
+        [this, iface, sockfd](const std::vector<Pkt6Ptr>& pkts) -> size_t {
+            size_t sent = packet_filter6_->sendBatch(*iface, sockfd, pkts);
+            updateSendBatchStats(AF_INET6, sent);
+            return (sent);
+        });
+    return (true);
 }
 
 bool
@@ -1118,9 +1182,50 @@ IfaceMgr::send(const Pkt4Ptr& pkt) {
                   << pkt->getIface() << ") specified.");
     }
 
-    // Assuming that packet filter is not null, because its modifier checks it.
-    // The packet filter returns an int but in fact it either returns 0 or throws.
-    return (packet_filter_->send(*iface, getSocket(pkt).sockfd_, pkt) == 0);
+    const uint16_t sockfd = getSocket(pkt).sockfd_;
+    if (send_batch_size_ <= 1) {
+        // Assuming that packet filter is not null, because its modifier checks it.
+        // The packet filter returns an int but in fact it either returns 0 or throws.
+        return (packet_filter_->send(*iface, sockfd, pkt) == 0);
+    }
+
+    // Let the send queue coalesce this packet with the packets sent
+    // concurrently over the same socket. It throws if this packet
+    // can't be sent.
+    getSendQueue4(sockfd)->send(pkt,
+        [this, iface, sockfd](const std::vector<Pkt4Ptr>& pkts) -> size_t {
+            size_t sent = packet_filter_->sendBatch(*iface, sockfd, pkts);
+            updateSendBatchStats(AF_INET, sent);
+            return (sent);
+        });
+    return (true);
+}
+
+boost::shared_ptr<PacketSendQueue<Pkt4Ptr> >
+IfaceMgr::getSendQueue4(const int sockfd) {
+    std::lock_guard<std::mutex> lock(send_queues_mutex_);
+    boost::shared_ptr<PacketSendQueue<Pkt4Ptr> >& queue = send_queues4_[sockfd];
+    if (!queue) {
+        queue.reset(new PacketSendQueue<Pkt4Ptr>(send_batch_size_));
+    }
+    return (queue);
+}
+
+boost::shared_ptr<PacketSendQueue<Pkt6Ptr> >
+IfaceMgr::getSendQueue6(const int sockfd) {
+    std::lock_guard<std::mutex> lock(send_queues_mutex_);
+    boost::shared_ptr<PacketSendQueue<Pkt6Ptr> >& queue = send_queues6_[sockfd];
+    if (!queue) {
+        queue.reset(new PacketSendQueue<Pkt6Ptr>(send_batch_size_));
+    }
+    return (queue);
+}
+
+void
+IfaceMgr::clearSendQueues() {
+    std::lock_guard<std::mutex> lock(send_queues_mutex_);
+    send_queues4_.clear();
+    send_queues6_.clear();
 }
 
 Pkt4Ptr IfaceMgr::receive4(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */) {
@@ -1138,53 +1243,30 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
                   " one million microseconds");
     }
 
-    fd_set sockets;
-    int maxfd = 0;
-
-    FD_ZERO(&sockets);
-
-    // if there are any callbacks for external sockets registered...
-    {
-        std::lock_guard<std::mutex> lock(callbacks_mutex_);
-        if (!callbacks_.empty()) {
-            for (SocketCallbackInfo s : callbacks_) {
-                // Add this socket to listening set
-                addFDtoSet(s.socket_, maxfd, &sockets);
-            }
-        }
-    }
-
-    // Add Receiver ready watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::READY), maxfd, &sockets);
-
-    // Add Receiver error watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::ERROR), maxfd, &sockets);
+    // Make sure the event handler watches the external sockets and the
+    // receiver watch sockets. They are registered again only when the
+    // set of sockets has changed.
+    updateEventHandler(AF_UNSPEC);
 
-    // Set timeout for our next select() call.  If there are
+    // Set timeout for our next wait.  If there are
     // no DHCP packets to read, then we'll wait for a finite
     // amount of time for an IO event.  Otherwise, we'll
     // poll (timeout = 0 secs).  We need to poll, even if
     // DHCP packets are waiting so we don't starve external
     // sockets under heavy DHCP load.
-    struct timeval select_timeout;
-    if (getPacketQueue4()->empty()) {
-        select_timeout.tv_sec = timeout_sec;
-        select_timeout.tv_usec = timeout_usec;
-    } else {
-        select_timeout.tv_sec = 0;
-        select_timeout.tv_usec = 0;
-    }
+    const bool queue_empty = getPacketQueue4()->empty();
 
     // zero out the errno to be safe
     errno = 0;
 
-    int result = select(maxfd + 1, &sockets, 0, 0, &select_timeout);
+    int result = fd_event_handler_->waitEvent(queue_empty ? timeout_sec : 0,
+                                              queue_empty ? timeout_usec : 0);
 
     if ((result == 0) && getPacketQueue4()->empty()) {
         // nothing received and timeout has been reached
         return (Pkt4Ptr());
     } else if (result < 0) {
-        // In most cases we would like to know whether select() returned
+        // In most cases we would like to know whether the wait returned
         // an error because of a signal being received  or for some other
         // reason. This is because DHCP servers use signals to trigger
         // certain actions, like reconfiguration or graceful shutdown.
@@ -1203,7 +1285,7 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
         }
     }
 
-    // We only check external sockets if select detected an event.
+    // We only check external sockets if the wait detected an event.
     if (result > 0) {
         // Check for receiver thread read errors.
         if (dhcp_receiver_->isReady(WatchedThread::ERROR)) {
@@ -1218,7 +1300,7 @@ Pkt4Ptr IfaceMgr::receive4Indirect(uint32_t timeout_sec, uint32_t timeout_usec /
         {
             std::lock_guard<std::mutex> lock(callbacks_mutex_);
             for (SocketCallbackInfo s : callbacks_) {
-                if (!FD_ISSET(s.socket_, &sockets)) {
+                if (!fd_event_handler_->readReady(s.socket_)) {
                     continue;
                 }
                 found = true;
@@ -1259,51 +1341,32 @@ Pkt4Ptr IfaceMgr::receive4Direct(uint32_t timeout_sec, uint32_t timeout_usec /*
         isc_throw(BadValue, "fractional timeout must be shorter than"
                   " one million microseconds");
     }
-    boost::scoped_ptr<SocketInfo> candidate;
-    fd_set sockets;
-    int maxfd = 0;
 
-    FD_ZERO(&sockets);
-
-    /// @todo: marginal performance optimization. We could create the set once
-    /// and then use its copy for select(). Please note that select() modifies
-    /// provided set to indicated which sockets have something to read.
-    for (IfacePtr iface : ifaces_) {
-        for (SocketInfo s : iface->getSockets()) {
-            // Only deal with IPv4 addresses.
-            if (s.addr_.isV4()) {
-                // Add this socket to listening set
-                addFDtoSet(s.sockfd_, maxfd, &sockets);
-            }
-        }
+    // Return packets left over from the last batched read first.
+    if (!pending_pkts4_.empty()) {
+        Pkt4Ptr pkt = pending_pkts4_.front();
+        pending_pkts4_.pop_front();
+        return (pkt);
     }
 
-    // if there are any callbacks for external sockets registered...
-    {
-        std::lock_guard<std::mutex> lock(callbacks_mutex_);
-        if (!callbacks_.empty()) {
-            for (SocketCallbackInfo s : callbacks_) {
-                // Add this socket to listening set
-                addFDtoSet(s.socket_, maxfd, &sockets);
-            }
-        }
-    }
+    boost::scoped_ptr<SocketInfo> candidate;
 
-    struct timeval select_timeout;
-    select_timeout.tv_sec = timeout_sec;
-    select_timeout.tv_usec = timeout_usec;
+    // Make sure the event handler watches the IPv4 sockets and the
+    // external sockets. They are registered again only when the set of
+    // sockets has changed.
+    updateEventHandler(AF_INET);
 
     // zero out the errno to be safe
     errno = 0;
 
-    int result = select(maxfd + 1, &sockets, 0, 0, &select_timeout);
+    int result = fd_event_handler_->waitEvent(timeout_sec, timeout_usec);
 
     if (result == 0) {
         // nothing received and timeout has been reached
         return (Pkt4Ptr()); // null
 
     } else if (result < 0) {
-        // In most cases we would like to know whether select() returned
+        // In most cases we would like to know whether the wait returned
         // an error because of a signal being received  or for some other
         // reason. This is because DHCP servers use signals to trigger
         // certain actions, like reconfiguration or graceful shutdown.
@@ -1328,7 +1391,7 @@ Pkt4Ptr IfaceMgr::receive4Direct(uint32_t timeout_sec, uint32_t timeout_usec /*
     {
         std::lock_guard<std::mutex> lock(callbacks_mutex_);
         for (SocketCallbackInfo s : callbacks_) {
-            if (!FD_ISSET(s.socket_, &sockets)) {
+            if (!fd_event_handler_->readReady(s.socket_)) {
                 continue;
             }
             found = true;
@@ -1355,15 +1418,10 @@ Pkt4Ptr IfaceMgr::receive4Direct(uint32_t timeout_sec, uint32_t timeout_usec /*
 
     // Let's find out which interface/socket has the data
     IfacePtr recv_if;
-    for (IfacePtr iface : ifaces_) {
-        for (SocketInfo s : iface->getSockets()) {
-            if (FD_ISSET(s.sockfd_, &sockets)) {
-                candidate.reset(new SocketInfo(s));
-                break;
-            }
-        }
-        if (candidate) {
-            recv_if = iface;
+    for (auto const& s : event_sockets_) {
+        if (fd_event_handler_->readReady(s.second.sockfd_)) {
+            candidate.reset(new SocketInfo(s.second));
+            recv_if = s.first;
             break;
         }
     }
@@ -1374,7 +1432,19 @@ Pkt4Ptr IfaceMgr::receive4Direct(uint32_t timeout_sec, uint32_t timeout_usec /*
 
     // Now we have a socket, let's get some data from it!
     // Assuming that packet filter is not null, because its modifier checks it.
-    return (packet_filter_->receive(*recv_if, *candidate));
+    if (receive_batch_size_ <= 1) {
+        return (packet_filter_->receive(*recv_if, *candidate));
+    }
+
+    std::vector<Pkt4Ptr> pkts;
+    packet_filter_->receiveBatch(*recv_if, *candidate, receive_batch_size_,
+                                 pkts);
+    if (pkts.empty()) {
+        return (Pkt4Ptr());
+    }
+    updateReceiveBatchStats(AF_INET, pkts.size());
+    pending_pkts4_.insert(pending_pkts4_.end(), pkts.begin() + 1, pkts.end());
+    return (pkts.front());
 }
 
 Pkt6Ptr
@@ -1398,29 +1468,27 @@ IfaceMgr::addFDtoSet(int fd, int& maxfd, fd_set* sockets) {
     }
 }
 
-Pkt6Ptr
-IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ ) {
-    // Sanity check for microsecond timeout.
-    if (timeout_usec >= 1000000) {
-        isc_throw(BadValue, "fractional timeout must be shorter than"
-                  " one million microseconds");
+void
+IfaceMgr::updateEventHandler(const uint16_t mode) {
+    // Sockets may be added or removed concurrently: take the generation
+    // first so a change during the update triggers a new update.
+    const uint64_t generation = sockets_generation;
+    if ((generation == fd_event_handler_generation_) &&
+        (mode == fd_event_handler_mode_)) {
+        return;
     }
 
-    boost::scoped_ptr<SocketInfo> candidate;
-    fd_set sockets;
-    int maxfd = 0;
-
-    FD_ZERO(&sockets);
+    fd_event_handler_->clear();
+    event_sockets_.clear();
 
-    /// @todo: marginal performance optimization. We could create the set once
-    /// and then use its copy for select(). Please note that select() modifies
-    /// provided set to indicated which sockets have something to read.
-    for (IfacePtr iface : ifaces_) {
-        for (SocketInfo s : iface->getSockets()) {
-            // Only deal with IPv6 addresses.
-            if (s.addr_.isV6()) {
-                // Add this socket to listening set
-                addFDtoSet(s.sockfd_, maxfd, &sockets);
+    if (mode != AF_UNSPEC) {
+        for (IfacePtr iface : ifaces_) {
+            for (SocketInfo s : iface->getSockets()) {
+                // Only deal with addresses of the requested family.
+                if ((mode == AF_INET) ? s.addr_.isV4() : s.addr_.isV6()) {
+                    fd_event_handler_->add(s.sockfd_);
+                    event_sockets_.push_back(std::make_pair(iface, s));
+                }
             }
         }
     }
@@ -1428,29 +1496,56 @@ IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ )
     // if there are any callbacks for external sockets registered...
     {
         std::lock_guard<std::mutex> lock(callbacks_mutex_);
-        if (!callbacks_.empty()) {
-            for (SocketCallbackInfo s : callbacks_) {
-                // Add this socket to listening set
-                addFDtoSet(s.socket_, maxfd, &sockets);
-            }
+        for (SocketCallbackInfo s : callbacks_) {
+            fd_event_handler_->add(s.socket_);
         }
     }
 
-    struct timeval select_timeout;
-    select_timeout.tv_sec = timeout_sec;
-    select_timeout.tv_usec = timeout_usec;
+    if (mode == AF_UNSPEC) {
+        // Add Receiver ready watch socket
+        fd_event_handler_->add(dhcp_receiver_->getWatchFd(WatchedThread::READY));
+
+        // Add Receiver error watch socket
+        fd_event_handler_->add(dhcp_receiver_->getWatchFd(WatchedThread::ERROR));
+    }
+
+    fd_event_handler_generation_ = generation;
+    fd_event_handler_mode_ = mode;
+}
+
+Pkt6Ptr
+IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ ) {
+    // Sanity check for microsecond timeout.
+    if (timeout_usec >= 1000000) {
+        isc_throw(BadValue, "fractional timeout must be shorter than"
+                  " one million microseconds");
+    }
+
+    // Return packets left over from the last batched read first.
+    if (!pending_pkts6_.empty()) {
+        Pkt6Ptr pkt = pending_pkts6_.front();
+        pending_pkts6_.pop_front();
+        return (pkt);
+    }
+
+    boost::scoped_ptr<SocketInfo> candidate;
+
+    // Make sure the event handler watches the IPv6 sockets and the
+    // external sockets. They are registered again only when the set of
+    // sockets has changed.
+    updateEventHandler(AF_INET6);
 
     // zero out the errno to be safe
     errno = 0;
 
-    int result = select(maxfd + 1, &sockets, 0, 0, &select_timeout);
+    int result = fd_event_handler_->waitEvent(timeout_sec, timeout_usec);
 
     if (result == 0) {
         // nothing received and timeout has been reached
         return (Pkt6Ptr()); // null
 
     } else if (result < 0) {
-        // In most cases we would like to know whether select() returned
+        // In most cases we would like to know whether the wait returned
         // an error because of a signal being received  or for some other
         // reason. This is because DHCP servers use signals to trigger
         // certain actions, like reconfiguration or graceful shutdown.
@@ -1475,7 +1570,7 @@ IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ )
     {
         std::lock_guard<std::mutex> lock(callbacks_mutex_);
         for (SocketCallbackInfo s : callbacks_) {
-            if (!FD_ISSET(s.socket_, &sockets)) {
+            if (!fd_event_handler_->readReady(s.socket_)) {
                 continue;
             }
             found = true;
@@ -1501,14 +1596,9 @@ IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ )
     }
 
     // Let's find out which interface/socket has the data
-    for (IfacePtr iface : ifaces_) {
-        for (SocketInfo s : iface->getSockets()) {
-            if (FD_ISSET(s.sockfd_, &sockets)) {
-                candidate.reset(new SocketInfo(s));
-                break;
-            }
-        }
-        if (candidate) {
+    for (auto const& s : event_sockets_) {
+        if (fd_event_handler_->readReady(s.second.sockfd_)) {
+            candidate.reset(new SocketInfo(s.second));
             break;
         }
     }
@@ -1517,7 +1607,18 @@ IfaceMgr::receive6Direct(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */ )
         isc_throw(SocketReadError, "received data over unknown socket");
     }
     // Assuming that packet filter is not null, because its modifier checks it.
-    return (packet_filter6_->receive(*candidate));
+    if (receive_batch_size_ <= 1) {
+        return (packet_filter6_->receive(*candidate));
+    }
+
+    std::vector<Pkt6Ptr> pkts;
+    packet_filter6_->receiveBatch(*candidate, receive_batch_size_, pkts);
+    if (pkts.empty()) {
+        return (Pkt6Ptr());
+    }
+    updateReceiveBatchStats(AF_INET6, pkts.size());
+    pending_pkts6_.insert(pending_pkts6_.end(), pkts.begin() + 1, pkts.end());
+    return (pkts.front());
 }
 
 Pkt6Ptr
@@ -1528,53 +1629,30 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
                   " one million microseconds");
     }
 
-    fd_set sockets;
-    int maxfd = 0;
-
-    FD_ZERO(&sockets);
-
-    // if there are any callbacks for external sockets registered...
-    {
-        std::lock_guard<std::mutex> lock(callbacks_mutex_);
-        if (!callbacks_.empty()) {
-            for (SocketCallbackInfo s : callbacks_) {
-                // Add this socket to listening set
-                addFDtoSet(s.socket_, maxfd, &sockets);
-            }
-        }
-    }
-
-    // Add Receiver ready watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::READY), maxfd, &sockets);
+    // Make sure the event handler watches the external sockets and the
+    // receiver watch sockets. They are registered again only when the
+    // set of sockets has changed.
+    updateEventHandler(AF_UNSPEC);
 
-    // Add Receiver error watch socket
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::ERROR), maxfd, &sockets);
-
-    // Set timeout for our next select() call.  If there are
+    // Set timeout for our next wait.  If there are
     // no DHCP packets to read, then we'll wait for a finite
     // amount of time for an IO event.  Otherwise, we'll
     // poll (timeout = 0 secs).  We need to poll, even if
     // DHCP packets are waiting so we don't starve external
     // sockets under heavy DHCP load.
-    struct timeval select_timeout;
-    if (getPacketQueue6()->empty()) {
-        select_timeout.tv_sec = timeout_sec;
-        select_timeout.tv_usec = timeout_usec;
-    } else {
-        select_timeout.tv_sec = 0;
-        select_timeout.tv_usec = 0;
-    }
+    const bool queue_empty = getPacketQueue6()->empty();
 
     // zero out the errno to be safe
     errno = 0;
 
-    int result = select(maxfd + 1, &sockets, 0, 0, &select_timeout);
+    int result = fd_event_handler_->waitEvent(queue_empty ? timeout_sec : 0,
+                                              queue_empty ? timeout_usec : 0);
 
     if ((result == 0) && getPacketQueue6()->empty()) {
         // nothing received and timeout has been reached
         return (Pkt6Ptr());
     } else if (result < 0) {
-        // In most cases we would like to know whether select() returned
+        // In most cases we would like to know whether the wait returned
         // an error because of a signal being received  or for some other
         // reason. This is because DHCP servers use signals to trigger
         // certain actions, like reconfiguration or graceful shutdown.
@@ -1593,7 +1671,7 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
         }
     }
 
-    // We only check external sockets if select detected an event.
+    // We only check external sockets if the wait detected an event.
     if (result > 0) {
         // Check for receiver thread read errors.
         if (dhcp_receiver_->isReady(WatchedThread::ERROR)) {
@@ -1608,7 +1686,7 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
         {
             std::lock_guard<std::mutex> lock(callbacks_mutex_);
             for (SocketCallbackInfo s : callbacks_) {
-                if (!FD_ISSET(s.socket_, &sockets)) {
+                if (!fd_event_handler_->readReady(s.socket_)) {
                     continue;
                 }
                 found = true;
@@ -1645,21 +1723,23 @@ IfaceMgr::receive6Indirect(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
 
 void
 IfaceMgr::receiveDHCP4Packets() {
-    fd_set sockets;
-    int maxfd = 0;
-
-    FD_ZERO(&sockets);
+    // The sockets do not change while the receiver thread is running so
+    // the event handler is populated once.
+    FDEventHandlerPtr handler =
+        FDEventHandlerFactory::factoryFDEventHandler(event_handler_type_);
 
     // Add terminate watch socket.
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::TERMINATE), maxfd, &sockets);
+    handler->add(dhcp_receiver_->getWatchFd(WatchedThread::TERMINATE));
 
     // Add Interface sockets.
+    std::vector<std::pair<IfacePtr, SocketInfo> > sockets;
     for (IfacePtr iface : ifaces_) {
         for (SocketInfo s : iface->getSockets()) {
             // Only deal with IPv4 addresses.
             if (s.addr_.isV4()) {
                 // Add this socket to listening set.
-                addFDtoSet(s.sockfd_, maxfd, &sockets);
+                handler->add(s.sockfd_);
+                sockets.push_back(std::make_pair(iface, s));
             }
         }
     }
@@ -1670,14 +1750,11 @@ IfaceMgr::receiveDHCP4Packets() {
             return;
         }
 
-        fd_set rd_set;
-        FD_COPY(&sockets, &rd_set);
-
         // zero out the errno to be safe.
         errno = 0;
 
-        // Select with null timeouts to wait indefinetly an event
-        int result = select(maxfd + 1, &rd_set, 0, 0, 0);
+        // Note we wait until something happen.
+        int result = handler->waitEvent(0, 0, false);
 
         // Re-check the watch socket.
         if (dhcp_receiver_->shouldTerminate()) {
@@ -1702,38 +1779,37 @@ IfaceMgr::receiveDHCP4Packets() {
         }
 
         // Let's find out which interface/socket has data.
-        for (IfacePtr iface : ifaces_) {
-            for (SocketInfo s : iface->getSockets()) {
-                if (FD_ISSET(s.sockfd_, &sockets)) {
-                    receiveDHCP4Packet(*iface, s);
-                    // Can take time so check one more time the watch socket.
-                    if (dhcp_receiver_->shouldTerminate()) {
-                        return;
-                    }
+        for (auto const& s : sockets) {
+            if (handler->readReady(s.second.sockfd_)) {
+                receiveDHCP4Packet(*s.first, s.second);
+                // Can take time so check one more time the watch socket.
+                if (dhcp_receiver_->shouldTerminate()) {
+                    return;
                 }
             }
         }
     }
-
 }
 
 void
 IfaceMgr::receiveDHCP6Packets() {
-    fd_set sockets;
-    int maxfd = 0;
-
-    FD_ZERO(&sockets);
+    // The sockets do not change while the receiver thread is running so
+    // the event handler is populated once.
+    FDEventHandlerPtr handler =
+        FDEventHandlerFactory::factoryFDEventHandler(event_handler_type_);
 
     // Add terminate watch socket.
-    addFDtoSet(dhcp_receiver_->getWatchFd(WatchedThread::TERMINATE), maxfd, &sockets);
+    handler->add(dhcp_receiver_->getWatchFd(WatchedThread::TERMINATE));
 
     // Add Interface sockets.
+    std::vector<std::pair<IfacePtr, SocketInfo> > sockets;
     for (IfacePtr iface : ifaces_) {
         for (SocketInfo s : iface->getSockets()) {
             // Only deal with IPv6 addresses.
             if (s.addr_.isV6()) {
                 // Add this socket to listening set.
-                addFDtoSet(s.sockfd_ , maxfd, &sockets);
+                handler->add(s.sockfd_);
+                sockets.push_back(std::make_pair(iface, s));
             }
         }
     }
@@ -1744,14 +1820,11 @@ IfaceMgr::receiveDHCP6Packets() {
             return;
         }
 
-        fd_set rd_set;
-        FD_COPY(&sockets, &rd_set);
-
         // zero out the errno to be safe.
         errno = 0;
 
         // Note we wait until something happen.
-        int result = select(maxfd + 1, &rd_set, 0, 0, 0);
+        int result = handler->waitEvent(0, 0, false);
 
         // Re-check the watch socket.
         if (dhcp_receiver_->shouldTerminate()) {
@@ -1761,6 +1834,7 @@ IfaceMgr::receiveDHCP6Packets() {
         if (result == 0) {
             // nothing received?
             continue;
+
         } else if (result < 0) {
             // This thread should not get signals?
             if (errno != EINTR) {
@@ -1775,14 +1849,12 @@ IfaceMgr::receiveDHCP6Packets() {
         }
 
         // Let's find out which interface/socket has data.
-        for (IfacePtr iface : ifaces_) {
-            for (SocketInfo s : iface->getSockets()) {
-                if (FD_ISSET(s.sockfd_, &sockets)) {
-                    receiveDHCP6Packet(s);
-                    // Can take time so check one more time the watch socket.
-                    if (dhcp_receiver_->shouldTerminate()) {
-                        return;
-                    }
+        for (auto const& s : sockets) {
+            if (handler->readReady(s.second.sockfd_)) {
+                receiveDHCP6Packet(s.second);
+                // Can take time so check one more time the watch socket.
+                if (dhcp_receiver_->shouldTerminate()) {
+                    return;
                 }
             }
         }
@@ -1804,18 +1876,22 @@ IfaceMgr::receiveDHCP4Packet(Iface& iface, const SocketInfo& socket_info) {
         return;
     }
 
-    Pkt4Ptr pkt;
+    std::vector<Pkt4Ptr> pkts;
 
     try {
-        pkt = packet_filter_->receive(iface, socket_info);
+        packet_filter_->receiveBatch(iface, socket_info, receive_batch_size_,
+                                     pkts);
     } catch (const std::exception& ex) {
         dhcp_receiver_->setError(strerror(errno));
     } catch (...) {
         dhcp_receiver_->setError("packet filter receive() failed");
     }
 
-    if (pkt) {
-        getPacketQueue4()->enqueuePacket(pkt, socket_info);
+    if (!pkts.empty()) {
+        for (Pkt4Ptr pkt : pkts) {
+            getPacketQueue4()->enqueuePacket(pkt, socket_info);
+        }
+        updateReceiveBatchStats(AF_INET, pkts.size());
         dhcp_receiver_->markReady(WatchedThread::READY);
     }
 }
@@ -1835,22 +1911,71 @@ IfaceMgr::receiveDHCP6Packet(const SocketInfo& socket_info) {
         return;
     }
 
-    Pkt6Ptr pkt;
+    std::vector<Pkt6Ptr> pkts;
 
     try {
-        pkt = packet_filter6_->receive(socket_info);
+        packet_filter6_->receiveBatch(socket_info, receive_batch_size_, pkts);
     } catch (const std::exception& ex) {
         dhcp_receiver_->setError(ex.what());
     } catch (...) {
         dhcp_receiver_->setError("packet filter receive() failed");
     }
 
-    if (pkt) {
-        getPacketQueue6()->enqueuePacket(pkt, socket_info);
+    if (!pkts.empty()) {
+        for (Pkt6Ptr pkt : pkts) {
+            getPacketQueue6()->enqueuePacket(pkt, socket_info);
+        }
+        updateReceiveBatchStats(AF_INET6, pkts.size());
         dhcp_receiver_->markReady(WatchedThread::READY);
     }
 }
 
+void
+IfaceMgr::updateReceiveBatchStats(const uint16_t family, const size_t count) {
+    if (receive_batch_size_ <= 1) {
+        return;
+    }
+
+    uint64_t batches;
+    uint64_t pkts;
+    std::string prefix;
+    if (family == AF_INET) {
+        batches = ++receive_batches4_;
+        pkts = (receive_batch_pkts4_ += count);
+        prefix = "pkt4";
+    } else {
+        batches = ++receive_batches6_;
+        pkts = (receive_batch_pkts6_ += count);
+        prefix = "pkt6";
+    }
+
+    StatsMgr::instance().addValue(prefix + "-receive-batches",
+                                  static_cast<int64_t>(1));
+    StatsMgr::instance().setValue(prefix + "-receive-batch-size-avg",
+                                  static_cast<double>(pkts) / batches);
+}
+
+void
+IfaceMgr::updateSendBatchStats(const uint16_t family, const size_t count) {
+    uint64_t batches;
+    uint64_t pkts;
+    std::string prefix;
+    if (family == AF_INET) {
+        batches = ++send_batches4_;
+        pkts = (send_batch_pkts4_ += count);
+        prefix = "pkt4";
+    } else {
+        batches = ++send_batches6_;
+        pkts = (send_batch_pkts6_ += count);
+        prefix = "pkt6";
+    }
+
+    StatsMgr::instance().addValue(prefix + "-send-batches",
+                                  static_cast<int64_t>(1));
+    StatsMgr::instance().setValue(prefix + "-send-batch-size-avg",
+                                  static_cast<double>(pkts) / batches);
+}
+
 uint16_t
 IfaceMgr::getSocket(const isc::dhcp::Pkt6Ptr& pkt) {
     IfacePtr iface = getIface(pkt);
@@ -1941,6 +2066,52 @@ IfaceMgr::getSocket(const isc::dhcp::Pkt4Ptr& pkt) {
     return (*candidate);
 }
 
+void
+IfaceMgr::setReceiveBatchSize(const size_t batch_size) {
+    if ((batch_size == 0) || (batch_size > MAX_RECEIVE_BATCH_SIZE)) {
+        isc_throw(BadValue, "invalid receive batch size " << batch_size
+                  << ", it must be in range 1.." << MAX_RECEIVE_BATCH_SIZE);
+    }
+
+    if (isDHCPReceiverRunning()) {
+        isc_throw(InvalidOperation, "Cannot change the receive batch size"
+                  " while DHCP receiver thread is running");
+    }
+
+    receive_batch_size_ = batch_size;
+}
+
+void
+IfaceMgr::setSendBatchSize(const size_t batch_size) {
+    if ((batch_size == 0) || (batch_size > MAX_SEND_BATCH_SIZE)) {
+        isc_throw(BadValue, "invalid send batch size " << batch_size
+                  << ", it must be in range 1.." << MAX_SEND_BATCH_SIZE);
+    }
+
+    if (batch_size == send_batch_size_) {
+        return;
+    }
+
+    send_batch_size_ = batch_size;
+
+    // The queues are created again with the new batch size.
+    clearSendQueues();
+}
+
+void
+IfaceMgr::setEventHandlerType(const FDEventHandler::HandlerType type) {
+    if (type == event_handler_type_) {
+        return;
+    }
+
+    // This throws if the type is not supported.
+    fd_event_handler_ = FDEventHandlerFactory::factoryFDEventHandler(type);
+    event_handler_type_ = type;
+
+    // Force the new handler to be populated.
+    fd_event_handler_generation_ = 0;
+}
+
 bool
 IfaceMgr::configureDHCPPacketQueue(uint16_t family, data::ConstElementPtr queue_control) {
     if (isDHCPReceiverRunning()) {
@@ -1949,6 +2120,10 @@ IfaceMgr::configureDHCPPacketQueue(uint16_t family, data::ConstElementPtr queue_
     }
 
     bool enable_queue = false;
+    size_t batch_size = 1;
+    size_t send_batch_size = 1;
+    bool raw_socket_ring = false;
+    FDEventHandler::HandlerType handler_type = FDEventHandler::TYPE_SELECT;
     if (queue_control) {
         try {
             enable_queue = data::SimpleParser::getBoolean(queue_control, "enable-queue");
@@ -1956,8 +2131,38 @@ IfaceMgr::configureDHCPPacketQueue(uint16_t family, data::ConstElementPtr queue_
             // @todo - for now swallow not found errors.
             // if not present we assume default
         }
+
+        if (queue_control->contains("receive-batch-size")) {
+            batch_size = data::SimpleParser::getInteger(queue_control,
+                                                        "receive-batch-size",
+                                                        1,
+                                                        MAX_RECEIVE_BATCH_SIZE);
+        }
+
+        if (queue_control->contains("send-batch-size")) {
+            send_batch_size = data::SimpleParser::getInteger(queue_control,
+                                                             "send-batch-size",
+                                                             1,
+                                                             MAX_SEND_BATCH_SIZE);
+        }
+
+        if (queue_control->contains("raw-socket-ring")) {
+            raw_socket_ring = data::SimpleParser::getBoolean(queue_control,
+                                                             "raw-socket-ring");
+        }
+
+        if (queue_control->contains("event-handler")) {
+            std::string name = data::SimpleParser::getString(queue_control,
+                                                             "event-handler");
+            handler_type = FDEventHandlerFactory::typeFromText(name);
+        }
     }
 
+    setReceiveBatchSize(batch_size);
+    setSendBatchSize(send_batch_size);
+    setRawSocketRing(raw_socket_ring);
+    setEventHandlerType(handler_type);
+
     if (enable_queue) {
         // Try to create the queue as configured.
         if (family == AF_INET) {
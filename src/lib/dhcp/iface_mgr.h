@@ -16,6 +16,7 @@
 #include <dhcp/packet_queue_mgr6.h>
 #include <dhcp/pkt_filter.h>
 #include <dhcp/pkt_filter6.h>
+#include <util/fd_event_handler.h>
 #include <util/optional.h>
 #include <util/watch_socket.h>
 #include <util/watched_thread.h>
@@ -28,8 +29,10 @@
 #include <boost/scoped_array.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <atomic>
 #include <functional>
 #include <list>
+#include <map>
 #include <vector>
 #include <mutex>
 
@@ -315,9 +318,7 @@ public:
     /// @brief Adds socket descriptor to an interface.
     ///
     /// @param sock SocketInfo structure that describes socket.
-    void addSocket(const SocketInfo& sock) {
-        sockets_.push_back(sock);
-    }
+    void addSocket(const SocketInfo& sock);
 
     /// @brief Closes socket.
     ///
@@ -610,6 +611,10 @@ typedef boost::multi_index_container<
     >
 > BoundAddresses;
 
+/// @brief Forward declaration to the @c PacketSendQueue.
+template<typename PacketTypePtr>
+class PacketSendQueue;
+
 /// @brief Forward declaration to the @c IfaceMgr.
 class IfaceMgr;
 
@@ -656,6 +661,16 @@ public:
     /// we don't support packets larger than 1500.
     static const uint32_t RCVBUFSIZE = 1500;
 
+    /// @brief Maximum number of packets read from a socket at once.
+    ///
+    /// It limits the value which can be set with @c setReceiveBatchSize.
+    static const size_t MAX_RECEIVE_BATCH_SIZE = 1024;
+
+    /// @brief Maximum number of packets sent over a socket at once.
+    ///
+    /// It limits the value which can be set with @c setSendBatchSize.
+    static const size_t MAX_SEND_BATCH_SIZE = 1024;
+
     /// IfaceMgr is a singleton class. This method returns reference
     /// to its sole instance.
     ///
@@ -1160,6 +1175,10 @@ public:
     /// argument is set to 'false', PktFilterInet object instance will
     /// be set as the Packet Filter regardless of the OS type.
     ///
+    /// On Linux, the packet filter supporting direct responses receives
+    /// the packets through a memory-mapped ring when it has been enabled
+    /// with @c setRawSocketRing.
+    ///
     /// @param direct_response_desired specifies whether the Packet Filter
     /// object being set should support direct traffic to the host
     /// not having address assigned.
@@ -1268,6 +1287,100 @@ public:
     bool configureDHCPPacketQueue(const uint16_t family,
                                   data::ConstElementPtr queue_control);
 
+    /// @brief Sets the maximum number of packets read from a socket at once.
+    ///
+    /// When the batch size is greater than 1, the packet filter is requested
+    /// to read all packets waiting on a ready socket, up to the batch size,
+    /// with a single system call (e.g. recvmmsg on Linux). The receiver
+    /// thread adds all of them to the packet queue. When no receiver thread
+    /// is running the packets are returned one by one by subsequent calls to
+    /// @c receive4 or @c receive6 before the sockets are polled again.
+    ///
+    /// The batch size is usually configured with the "receive-batch-size"
+    /// parameter of the "dhcp-queue-control" map.
+    ///
+    /// @param batch_size new batch size. The value of 1 disables batching.
+    /// @throw BadValue if the value is 0 or greater than
+    /// @c MAX_RECEIVE_BATCH_SIZE.
+    /// @throw InvalidOperation if the receiver thread is currently running.
+    void setReceiveBatchSize(const size_t batch_size);
+
+    /// @brief Returns the maximum number of packets read from a socket
+    /// at once.
+    size_t getReceiveBatchSize() const {
+        return (receive_batch_size_);
+    }
+
+    /// @brief Sets the maximum number of packets sent over a socket at once.
+    ///
+    /// When the batch size is greater than 1, packets sent concurrently
+    /// over the same socket, e.g. by the threads of the packet processing
+    /// thread pool, are queued in a per-socket send queue and transmitted
+    /// together by the packet filter with a single system call (e.g.
+    /// sendmmsg on Linux). The @c send functions still return only when
+    /// the packet has been sent.
+    ///
+    /// The batch size is usually configured with the "send-batch-size"
+    /// parameter of the "dhcp-queue-control" map.
+    ///
+    /// @param batch_size new batch size. The value of 1 disables batching.
+    /// @throw BadValue if the value is 0 or greater than
+    /// @c MAX_SEND_BATCH_SIZE.
+    void setSendBatchSize(const size_t batch_size);
+
+    /// @brief Returns the maximum number of packets sent over a socket
+    /// at once.
+    size_t getSendBatchSize() const {
+        return (send_batch_size_);
+    }
+
+    /// @brief Enables or disables the memory-mapped receive ring of the
+    /// raw sockets.
+    ///
+    /// When enabled, the packet filter set by @c setMatchingPacketFilter
+    /// for direct responses receives the packets through a TPACKET_V3
+    /// memory-mapped ring shared with the kernel instead of reading each
+    /// frame with a system call. It is only supported on Linux and takes
+    /// effect at the next call to @c setMatchingPacketFilter.
+    ///
+    /// The ring is usually enabled with the "raw-socket-ring" parameter
+    /// of the "dhcp-queue-control" map.
+    ///
+    /// @param enable true to use the ring.
+    void setRawSocketRing(const bool enable) {
+        raw_socket_ring_ = enable;
+    }
+
+    /// @brief Checks if the memory-mapped receive ring of the raw sockets
+    /// is enabled.
+    bool getRawSocketRing() const {
+        return (raw_socket_ring_);
+    }
+
+    /// @brief Sets the type of the event handler used to wait for
+    /// events on the sockets.
+    ///
+    /// The "select" handler is the default and is available on all
+    /// systems. The "epoll" handler is available on Linux: the sockets
+    /// are registered once in the kernel instead of being scanned at each
+    /// wait, and there is no limit on descriptor values. With both handlers
+    /// the set of watched sockets is persistent and is only rebuilt when
+    /// interface or external sockets are added or removed.
+    ///
+    /// The type is usually configured with the "event-handler" parameter
+    /// of the "dhcp-queue-control" map. It is used by a receiver thread
+    /// started after the call.
+    ///
+    /// @param type new event handler type.
+    /// @throw NotImplemented if the type is not supported on this system.
+    void setEventHandlerType(const util::FDEventHandler::HandlerType type);
+
+    /// @brief Returns the type of the event handler used to wait for
+    /// events on the sockets.
+    util::FDEventHandler::HandlerType getEventHandlerType() const {
+        return (event_handler_type_);
+    }
+
     /// @brief Convenience method for adding an descriptor to a set
     ///
     /// @param fd descriptor to add
@@ -1486,13 +1599,14 @@ private:
     /// it marks the "error" watch socket as ready.
     void receiveDHCP4Packets();
 
-    /// @brief Receives a single DHCPv4 packet from an interface socket
+    /// @brief Receives DHCPv4 packets from an interface socket
     ///
     /// Called by @c receiveDHPC4Packets when a socket fd is flagged as
-    /// ready. It uses the DHCPv4 packet filter to receive a single packet
-    /// from the given interface socket, adds it to the packet queue, and
-    /// marks the "receive" watch socket ready. If an error occurs during
-    /// the read, the "error" watch socket is marked ready.
+    /// ready. It uses the DHCPv4 packet filter to receive up to the
+    /// configured batch size of packets from the given interface socket,
+    /// adds them to the packet queue, and marks the "receive" watch socket
+    /// ready. If an error occurs during the read, the "error" watch socket
+    /// is marked ready.
     ///
     /// @param iface interface
     /// @param socket_info structure holding socket information
@@ -1509,17 +1623,70 @@ private:
     /// it marks the "error" watch socket as ready.
     void receiveDHCP6Packets();
 
-    /// @brief Receives a single DHCPv6 packet from an interface socket
+    /// @brief Receives DHCPv6 packets from an interface socket
     ///
     /// Called by @c receiveDHPC6Packets when a socket fd is flagged as
-    /// ready. It uses the DHCPv6 packet filter to receive a single packet
-    /// from the given interface socket, adds it to the packet queue, and
-    /// marks the "receive" watch socket ready. If an error occurs during
-    /// the read, the "error" watch socket is marked ready.
+    /// ready. It uses the DHCPv6 packet filter to receive up to the
+    /// configured batch size of packets from the given interface socket,
+    /// adds them to the packet queue, and marks the "receive" watch socket
+    /// ready. If an error occurs during the read, the "error" watch socket
+    /// is marked ready.
     ///
     /// @param socket_info structure holding socket information
     void receiveDHCP6Packet(const SocketInfo& socket_info);
 
+    /// @brief Updates the statistics of the batched packet reception.
+    ///
+    /// It increments the "pktX-receive-batches" statistic and recomputes
+    /// the "pktX-receive-batch-size-avg" statistic holding the average
+    /// number of packets read from a socket at once. It does nothing if
+    /// batching is disabled.
+    ///
+    /// @param family protocol family (AF_INET or AF_INET6).
+    /// @param count number of packets received in the batch.
+    void updateReceiveBatchStats(const uint16_t family, const size_t count);
+
+    /// @brief Updates the statistics of the batched packet transmission.
+    ///
+    /// It increments the "pktX-send-batches" statistic and recomputes
+    /// the "pktX-send-batch-size-avg" statistic holding the average
+    /// number of packets sent over a socket at once, i.e. the coalescing
+    /// efficiency of the send queues.
+    ///
+    /// @param family protocol family (AF_INET or AF_INET6).
+    /// @param count number of packets sent in the batch.
+    void updateSendBatchStats(const uint16_t family, const size_t count);
+
+    /// @brief Returns the send queue of a DHCPv4 socket.
+    ///
+    /// The queue is created if it doesn't exist.
+    ///
+    /// @param sockfd socket descriptor.
+    /// @return pointer to the send queue.
+    boost::shared_ptr<PacketSendQueue<Pkt4Ptr> > getSendQueue4(const int sockfd);
+
+    /// @brief Returns the send queue of a DHCPv6 socket.
+    ///
+    /// The queue is created if it doesn't exist.
+    ///
+    /// @param sockfd socket descriptor.
+    /// @return pointer to the send queue.
+    boost::shared_ptr<PacketSendQueue<Pkt6Ptr> > getSendQueue6(const int sockfd);
+
+    /// @brief Removes all send queues.
+    void clearSendQueues();
+
+    /// @brief Populates the event handler used by receive4 and receive6.
+    ///
+    /// The sockets are registered again only when they were changed since
+    /// the last call or when a different receive path is used.
+    ///
+    /// @param mode AF_INET or AF_INET6 to watch the interface sockets of
+    /// this family and the external sockets (direct reception), AF_UNSPEC
+    /// to watch the external sockets and the receiver thread watch sockets
+    /// (indirect reception).
+    void updateEventHandler(const uint16_t mode);
+
     /// @brief Deletes external socket with the callbacks_mutex_ taken
     ///
     /// @param socketfd socket descriptor
@@ -1561,6 +1728,73 @@ private:
 
     /// DHCP packet receiver.
     isc::util::WatchedThreadPtr dhcp_receiver_;
+
+    /// @brief Maximum number of packets read from a socket at once.
+    size_t receive_batch_size_;
+
+    /// @brief DHCPv4 packets read in a batch but not yet returned by
+    /// @c receive4Direct.
+    std::list<Pkt4Ptr> pending_pkts4_;
+
+    /// @brief DHCPv6 packets read in a batch but not yet returned by
+    /// @c receive6Direct.
+    std::list<Pkt6Ptr> pending_pkts6_;
+
+    /// @brief Number of batched reads of DHCPv4 packets.
+    std::atomic<uint64_t> receive_batches4_;
+
+    /// @brief Number of DHCPv4 packets received in batched reads.
+    std::atomic<uint64_t> receive_batch_pkts4_;
+
+    /// @brief Number of batched reads of DHCPv6 packets.
+    std::atomic<uint64_t> receive_batches6_;
+
+    /// @brief Number of DHCPv6 packets received in batched reads.
+    std::atomic<uint64_t> receive_batch_pkts6_;
+
+    /// @brief Maximum number of packets sent over a socket at once.
+    size_t send_batch_size_;
+
+    /// @brief Send queues of the DHCPv4 sockets indexed by descriptor.
+    std::map<int, boost::shared_ptr<PacketSendQueue<Pkt4Ptr> > > send_queues4_;
+
+    /// @brief Send queues of the DHCPv6 sockets indexed by descriptor.
+    std::map<int, boost::shared_ptr<PacketSendQueue<Pkt6Ptr> > > send_queues6_;
+
+    /// @brief Mutex to protect the send queue maps.
+    std::mutex send_queues_mutex_;
+
+    /// @brief Number of batched transmissions of DHCPv4 packets.
+    std::atomic<uint64_t> send_batches4_;
+
+    /// @brief Number of DHCPv4 packets sent in batched transmissions.
+    std::atomic<uint64_t> send_batch_pkts4_;
+
+    /// @brief Number of batched transmissions of DHCPv6 packets.
+    std::atomic<uint64_t> send_batches6_;
+
+    /// @brief Number of DHCPv6 packets sent in batched transmissions.
+    std::atomic<uint64_t> send_batch_pkts6_;
+
+    /// @brief Enables the memory-mapped receive ring of the raw sockets.
+    bool raw_socket_ring_;
+
+    /// @brief Type of the event handlers used to wait for socket events.
+    util::FDEventHandler::HandlerType event_handler_type_;
+
+    /// @brief Event handler watching the sockets for receive4 and receive6.
+    util::FDEventHandlerPtr fd_event_handler_;
+
+    /// @brief Sockets generation the event handler was populated for.
+    uint64_t fd_event_handler_generation_;
+
+    /// @brief Receive path the event handler was populated for (see
+    /// @c updateEventHandler).
+    uint16_t fd_event_handler_mode_;
+
+    /// @brief Interface sockets watched by the event handler with their
+    /// interfaces.
+    std::vector<std::pair<IfacePtr, SocketInfo> > event_sockets_;
 };
 
 }; // namespace isc::dhcp
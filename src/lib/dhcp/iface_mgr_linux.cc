@@ -526,7 +526,7 @@ void Iface::setFlags(uint64_t flags) {
 void
 IfaceMgr::setMatchingPacketFilter(const bool direct_response_desired) {
     if (direct_response_desired) {
-        setPacketFilter(PktFilterPtr(new PktFilterLPF()));
+        setPacketFilter(PktFilterPtr(new PktFilterLPF(raw_socket_ring_)));
 
     } else {
         setPacketFilter(PktFilterPtr(new PktFilterInet()));
@@ -0,0 +1,185 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PACKET_SEND_QUEUE_H
+#define PACKET_SEND_QUEUE_H
+
+#include <dhcp/iface_mgr.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace isc {
+
+namespace dhcp {
+
+/// @brief Coalesces packets sent concurrently over the same socket.
+///
+/// When several threads send packets over the same socket at the same
+/// time, the packets are appended to the queue and the first thread
+/// finding no transmission in progress sends all queued packets, up to
+/// the maximum batch size, with a single call to the batch send function.
+/// Other threads wait until their packets have been sent, or until they
+/// can send the next batch themselves. When a single thread sends packets
+/// each batch holds one packet.
+///
+/// The @c send function returns when the packet has been sent. If the
+/// packet can't be sent, the exception thrown by the batch send function
+/// is rethrown to the thread which queued the packet.
+///
+/// @tparam PacketTypePtr Type of packet the queue contains.
+/// This expected to be either isc::dhcp::Pkt4Ptr or isc::dhcp::Pkt6Ptr
+template<typename PacketTypePtr>
+class PacketSendQueue : public boost::noncopyable {
+public:
+
+    /// @brief Function sending a batch of packets.
+    ///
+    /// It returns the number of packets sent from the beginning of the
+    /// batch and throws if the first packet can't be sent.
+    typedef std::function<size_t(const std::vector<PacketTypePtr>&)> SendBatchCallback;
+
+    /// @brief Constructor
+    ///
+    /// @param max_batch_size maximum number of packets sent at once.
+    explicit PacketSendQueue(const size_t max_batch_size)
+        : max_batch_size_(std::max(max_batch_size, static_cast<size_t>(1))),
+          flushing_(false), requests_() {
+    }
+
+    /// @brief Sends a packet, possibly together with other queued packets.
+    ///
+    /// @param pkt packet to be sent.
+    /// @param send_batch function used to send the batches.
+    /// @throw the exception thrown by @c send_batch for this packet.
+    void send(const PacketTypePtr& pkt, const SendBatchCallback& send_batch) {
+        Request request(pkt);
+        std::unique_lock<std::mutex> lock(mutex_);
+        requests_.push_back(&request);
+        while (!request.done_) {
+            if (!flushing_) {
+                flush(lock, send_batch);
+            } else {
+                cv_.wait(lock);
+            }
+        }
+
+        if (request.error_) {
+            std::rethrow_exception(request.error_);
+        }
+    }
+
+    /// @brief Returns the maximum number of packets sent at once.
+    size_t getMaxBatchSize() const {
+        return (max_batch_size_);
+    }
+
+    /// @brief Returns the number of packets in the queue.
+    ///
+    /// It includes the packets being sent.
+    size_t getSize() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return (requests_.size());
+    }
+
+private:
+
+    /// @brief Packet waiting in the queue.
+    struct Request {
+        /// @brief Constructor
+        ///
+        /// @param pkt packet to be sent.
+        explicit Request(const PacketTypePtr& pkt)
+            : pkt_(pkt), done_(false), error_() {
+        }
+
+        /// @brief Packet to be sent.
+        PacketTypePtr pkt_;
+
+        /// @brief Flag set when the packet was sent or could not be sent.
+        bool done_;
+
+        /// @brief Error which occurred when sending the packet.
+        std::exception_ptr error_;
+    };
+
+    /// @brief Sends the batch of packets at the front of the queue.
+    ///
+    /// The mutex is released while the packets are sent.
+    ///
+    /// @param lock lock holding the mutex.
+    /// @param send_batch function used to send the batch.
+    void flush(std::unique_lock<std::mutex>& lock,
+               const SendBatchCallback& send_batch) {
+        flushing_ = true;
+        const size_t count = std::min(requests_.size(), max_batch_size_);
+        std::vector<PacketTypePtr> pkts;
+        pkts.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            pkts.push_back(requests_[i]->pkt_);
+        }
+
+        lock.unlock();
+        size_t sent = 0;
+        std::exception_ptr error;
+        try {
+            sent = std::min(send_batch(pkts), count);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        for (size_t i = 0; i < sent; ++i) {
+            requests_[i]->done_ = true;
+        }
+
+        if (sent == 0) {
+            // The first packet can't be sent: report the error to its
+            // sender. The remaining packets are sent in the next batch.
+            if (!error) {
+                error = std::make_exception_ptr(
+                    SocketWriteError(__FILE__, __LINE__,
+                                     "no packet of the batch was sent"));
+            }
+            requests_[0]->error_ = error;
+            requests_[0]->done_ = true;
+            sent = 1;
+        }
+
+        requests_.erase(requests_.begin(), requests_.begin() + sent);
+        flushing_ = false;
+        cv_.notify_all();
+    }
+
+    /// @brief Maximum number of packets sent at once.
+    size_t max_batch_size_;
+
+    /// @brief Flag set when a thread is sending a batch.
+    bool flushing_;
+
+    /// @brief Packets waiting to be sent.
+    ///
+    /// The requests are owned by the threads waiting in @c send.
+    std::deque<Request*> requests_;
+
+    /// @brief Mutex protecting the queue.
+    mutable std::mutex mutex_;
+
+    /// @brief Condition variable used to wait for the end of a batch.
+    std::condition_variable cv_;
+};
+
+}; // namespace isc::dhcp
+}; // namespace isc
+
+#endif // PACKET_SEND_QUEUE_H
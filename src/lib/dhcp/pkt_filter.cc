@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -67,6 +67,39 @@ PktFilter::openFallbackSocket(const isc::asiolink::IOAddress& addr,
     return (sock);
 }
 
+size_t
+PktFilter::receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                        const size_t max_count, std::vector<Pkt4Ptr>& pkts) {
+    if (max_count == 0) {
+        return (0);
+    }
+    Pkt4Ptr pkt = receive(iface, socket_info);
+    if (!pkt) {
+        return (0);
+    }
+    pkts.push_back(pkt);
+    return (1);
+}
+
+size_t
+PktFilter::sendBatch(const Iface& iface, uint16_t sockfd,
+                     const std::vector<Pkt4Ptr>& pkts) {
+    size_t sent = 0;
+    for (auto const& pkt : pkts) {
+        try {
+            send(iface, sockfd, pkt);
+        } catch (...) {
+            // Report the error only if nothing was sent.
+            if (sent == 0) {
+                throw;
+            }
+            break;
+        }
+        ++sent;
+    }
+    return (sent);
+}
+
 
 } // end of isc::dhcp namespace
 } // end of isc namespace
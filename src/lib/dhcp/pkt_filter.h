@@ -10,6 +10,7 @@
 #include <dhcp/pkt4.h>
 #include <asiolink/io_address.h>
 #include <boost/shared_ptr.hpp>
+#include <vector>
 
 namespace isc {
 namespace dhcp {
@@ -93,6 +94,25 @@ public:
     virtual Pkt4Ptr receive(Iface& iface,
                             const SocketInfo& socket_info) = 0;
 
+    /// @brief Receive a batch of packets over specified socket.
+    ///
+    /// This function receives up to @c max_count packets which are already
+    /// queued on the socket. It must only be called when there is at least
+    /// one packet waiting on the socket. The default implementation receives
+    /// a single packet using @c receive. Derived classes may override it
+    /// to pull several datagrams with a single system call.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param max_count maximum number of packets to be received.
+    /// @param [out] pkts collection to which received packets are appended.
+    ///
+    /// @return number of packets appended to @c pkts.
+    virtual size_t receiveBatch(Iface& iface,
+                                const SocketInfo& socket_info,
+                                const size_t max_count,
+                                std::vector<Pkt4Ptr>& pkts);
+
     /// @brief Send packet over specified socket.
     ///
     /// @param iface interface to be used to send packet
@@ -103,6 +123,24 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt4Ptr& pkt) = 0;
 
+    /// @brief Send a batch of packets over specified socket.
+    ///
+    /// The packets are sent in order until all of them are sent or one of
+    /// them can't be sent. The default implementation sends the packets one
+    /// by one using @c send. Derived classes may override it to transmit
+    /// several datagrams with a single system call.
+    ///
+    /// @param iface interface to be used to send packets
+    /// @param sockfd socket descriptor
+    /// @param pkts packets to be sent
+    ///
+    /// @return number of packets sent from the beginning of @c pkts. When
+    /// it is lower than the number of packets, the first packet which was
+    /// not sent could not be sent.
+    /// @throw isc::dhcp::SocketWriteError if the first packet can't be sent.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt4Ptr>& pkts);
+
 protected:
 
     /// @brief Default implementation to open a fallback socket.
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -33,6 +33,39 @@ PktFilter6::joinMulticast(int sock, const std::string& ifname,
     return (true);
 }
 
+size_t
+PktFilter6::receiveBatch(const SocketInfo& socket_info, const size_t max_count,
+                         std::vector<Pkt6Ptr>& pkts) {
+    if (max_count == 0) {
+        return (0);
+    }
+    Pkt6Ptr pkt = receive(socket_info);
+    if (!pkt) {
+        return (0);
+    }
+    pkts.push_back(pkt);
+    return (1);
+}
+
+size_t
+PktFilter6::sendBatch(const Iface& iface, uint16_t sockfd,
+                      const std::vector<Pkt6Ptr>& pkts) {
+    size_t sent = 0;
+    for (auto const& pkt : pkts) {
+        try {
+            send(iface, sockfd, pkt);
+        } catch (...) {
+            // Report the error only if nothing was sent.
+            if (sent == 0) {
+                throw;
+            }
+            break;
+        }
+        ++sent;
+    }
+    return (sent);
+}
+
 
 } // end of isc::dhcp namespace
 } // end of isc namespace
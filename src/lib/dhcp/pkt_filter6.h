@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,8 @@
 #include <asiolink/io_address.h>
 #include <dhcp/pkt6.h>
 
+#include <vector>
+
 namespace isc {
 namespace dhcp {
 
@@ -101,6 +103,24 @@ public:
     /// @return A pointer to received message.
     virtual Pkt6Ptr receive(const SocketInfo& socket_info) = 0;
 
+    /// @brief Receives a batch of DHCPv6 messages on the interface.
+    ///
+    /// This function receives up to @c max_count DHCPv6 messages which are
+    /// already queued on the socket. It must only be called when there is
+    /// at least one message waiting on the socket. The default
+    /// implementation receives a single message using @c receive. Derived
+    /// classes may override it to pull several datagrams with a single
+    /// system call.
+    ///
+    /// @param socket_info A structure holding socket information.
+    /// @param max_count Maximum number of messages to be received.
+    /// @param [out] pkts Collection to which received messages are appended.
+    ///
+    /// @return Number of messages appended to @c pkts.
+    virtual size_t receiveBatch(const SocketInfo& socket_info,
+                                const size_t max_count,
+                                std::vector<Pkt6Ptr>& pkts);
+
     /// @brief Sends DHCPv6 message through a specified interface and socket.
     ///
     /// This function sends a DHCPv6 message through a specified interface and
@@ -115,6 +135,25 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt6Ptr& pkt) = 0;
 
+    /// @brief Sends a batch of DHCPv6 messages through a specified interface
+    /// and socket.
+    ///
+    /// The messages are sent in order until all of them are sent or one of
+    /// them can't be sent. The default implementation sends the messages
+    /// one by one using @c send. Derived classes may override it to transmit
+    /// several datagrams with a single system call.
+    ///
+    /// @param iface Interface to be used to send packets.
+    /// @param sockfd A socket descriptor
+    /// @param pkts Packets to be sent.
+    ///
+    /// @return number of packets sent from the beginning of @c pkts. When
+    /// it is lower than the number of packets, the first packet which was
+    /// not sent could not be sent.
+    /// @throw isc::dhcp::SocketWriteError if the first packet can't be sent.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt6Ptr>& pkts);
+
     /// @brief Joins IPv6 multicast group on a socket.
     ///
     /// This function joins the socket to the specified multicast group.
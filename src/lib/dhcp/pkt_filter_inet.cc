@@ -140,15 +140,90 @@ PktFilterInet::receive(Iface& iface, const SocketInfo& socket_info) {
         isc_throw(SocketReadError, "failed to receive UDP4 data");
     }
 
+    return (createPacket(iface, socket_info, buf, result, m));
+}
+
+size_t
+PktFilterInet::receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                            const size_t max_count,
+                            std::vector<Pkt4Ptr>& pkts) {
+#if defined (OS_LINUX)
+    if (max_count <= 1) {
+        return (PktFilter::receiveBatch(iface, socket_info, max_count, pkts));
+    }
+
+    // Prepare one message header per datagram. All buffers are allocated
+    // at once for the whole batch.
+    std::vector<uint8_t> bufs(max_count * IfaceMgr::RCVBUFSIZE);
+    std::vector<uint8_t> control_bufs(max_count * CONTROL_BUF_LEN, 0);
+    std::vector<struct sockaddr_in> from_addrs(max_count);
+    std::vector<struct iovec> iovs(max_count);
+    std::vector<struct mmsghdr> msgs(max_count);
+    memset(&from_addrs[0], 0, max_count * sizeof(struct sockaddr_in));
+    memset(&msgs[0], 0, max_count * sizeof(struct mmsghdr));
+
+    for (size_t i = 0; i < max_count; ++i) {
+        iovs[i].iov_base = static_cast<void*>(&bufs[i * IfaceMgr::RCVBUFSIZE]);
+        iovs[i].iov_len = IfaceMgr::RCVBUFSIZE;
+        struct msghdr& m = msgs[i].msg_hdr;
+        m.msg_name = &from_addrs[i];
+        m.msg_namelen = sizeof(struct sockaddr_in);
+        m.msg_iov = &iovs[i];
+        m.msg_iovlen = 1;
+        m.msg_control = &control_bufs[i * CONTROL_BUF_LEN];
+        m.msg_controllen = CONTROL_BUF_LEN;
+    }
+
+    // The caller guarantees that at least one datagram is waiting so
+    // MSG_WAITFORONE makes the call return with whatever is queued
+    // without blocking for the remaining slots.
+    int result = recvmmsg(socket_info.sockfd_, &msgs[0], max_count,
+                          MSG_WAITFORONE, 0);
+    if (result < 0) {
+        isc_throw(SocketReadError, "failed to receive UDP4 data");
+    }
+
+    // A malformed datagram must not cause the loss of the other datagrams
+    // from the batch. The error is reported only when none of the received
+    // datagrams could be turned into a packet.
+    std::string error;
+    size_t count = 0;
+    for (int i = 0; i < result; ++i) {
+        try {
+            pkts.push_back(createPacket(iface, socket_info,
+                                        &bufs[i * IfaceMgr::RCVBUFSIZE],
+                                        msgs[i].msg_len, msgs[i].msg_hdr));
+            ++count;
+        } catch (const std::exception& ex) {
+            error = ex.what();
+        }
+    }
+
+    if ((count == 0) && !error.empty()) {
+        isc_throw(SocketReadError, error);
+    }
+
+    return (count);
+#else
+    return (PktFilter::receiveBatch(iface, socket_info, max_count, pkts));
+#endif
+}
+
+Pkt4Ptr
+PktFilterInet::createPacket(Iface& iface, const SocketInfo& socket_info,
+                            const uint8_t* buf, const size_t len,
+                            struct msghdr& m) {
     // We have all data let's create Pkt4 object.
-    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(buf, result));
+    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(buf, len));
 
     pkt->updateTimestamp();
 
     unsigned int ifindex = iface.getIndex();
 
-    IOAddress from(htonl(from_addr.sin_addr.s_addr));
-    uint16_t from_port = htons(from_addr.sin_port);
+    const struct sockaddr_in* from_addr =
+        static_cast<const struct sockaddr_in*>(m.msg_name);
+    IOAddress from(htonl(from_addr->sin_addr.s_addr));
+    uint16_t from_port = htons(from_addr->sin_port);
 
     // Set receiving interface based on information, which socket was used to
     // receive data. OS-specific info (see os_receive4()) may be more reliable,
@@ -208,16 +283,72 @@ PktFilterInet::receive(Iface& iface, const SocketInfo& socket_info) {
 int
 PktFilterInet::send(const Iface&, uint16_t sockfd, const Pkt4Ptr& pkt) {
     uint8_t control_buf[CONTROL_BUF_LEN];
-    memset(&control_buf[0], 0, CONTROL_BUF_LEN);
+    sockaddr_in to;
+    struct iovec v;
+    struct msghdr m;
+    prepareMessage(pkt, to, v, control_buf, m);
+
+    pkt->updateTimestamp();
+
+    int result = sendmsg(sockfd, &m, 0);
+    if (result < 0) {
+        isc_throw(SocketWriteError, "pkt4 send failed: sendmsg() returned "
+                  " with an error: " << strerror(errno));
+    }
+
+    return (0);
+}
+
+size_t
+PktFilterInet::sendBatch(const Iface& iface, uint16_t sockfd,
+                         const std::vector<Pkt4Ptr>& pkts) {
+#if defined (OS_LINUX)
+    const size_t count = pkts.size();
+    if (count <= 1) {
+        return (PktFilter::sendBatch(iface, sockfd, pkts));
+    }
+
+    // Prepare one message header per packet. All buffers are allocated
+    // at once for the whole batch.
+    std::vector<uint8_t> control_bufs(count * CONTROL_BUF_LEN);
+    std::vector<struct sockaddr_in> to_addrs(count);
+    std::vector<struct iovec> iovs(count);
+    std::vector<struct mmsghdr> msgs(count);
+    memset(&msgs[0], 0, count * sizeof(struct mmsghdr));
+
+    for (size_t i = 0; i < count; ++i) {
+        prepareMessage(pkts[i], to_addrs[i], iovs[i],
+                       &control_bufs[i * CONTROL_BUF_LEN], msgs[i].msg_hdr);
+        pkts[i]->updateTimestamp();
+    }
+
+    // sendmmsg() returns the number of messages sent, which may be lower
+    // than requested when a message can't be sent. It fails only when the
+    // first message can't be sent.
+    int result = sendmmsg(sockfd, &msgs[0], count, 0);
+    if (result < 0) {
+        isc_throw(SocketWriteError, "pkt4 send failed: sendmmsg() returned "
+                  " with an error: " << strerror(errno));
+    }
+
+    return (static_cast<size_t>(result));
+#else
+    return (PktFilter::sendBatch(iface, sockfd, pkts));
+#endif
+}
+
+void
+PktFilterInet::prepareMessage(const Pkt4Ptr& pkt, sockaddr_in& to,
+                              struct iovec& v, uint8_t* control_buf,
+                              struct msghdr& m) {
+    memset(control_buf, 0, CONTROL_BUF_LEN);
 
     // Set the target address we're sending to.
-    sockaddr_in to;
     memset(&to, 0, sizeof(to));
     to.sin_family = AF_INET;
     to.sin_port = htons(pkt->getRemotePort());
     to.sin_addr.s_addr = htonl(pkt->getRemoteAddr().toUint32());
 
-    struct msghdr m;
     // Initialize our message header structure.
     memset(&m, 0, sizeof(m));
     m.msg_name = &to;
@@ -226,7 +357,6 @@ PktFilterInet::send(const Iface&, uint16_t sockfd, const Pkt4Ptr& pkt) {
     // Set the data buffer we're sending. (Using this wacky
     // "scatter-gather" stuff... we only have a single chunk
     // of data to send, so we declare a single vector entry.)
-    struct iovec v;
     memset(&v, 0, sizeof(v));
     // iov_base field is of void * type. We use it for packet
     // transmission, so this buffer will not be modified.
@@ -244,7 +374,7 @@ PktFilterInet::send(const Iface&, uint16_t sockfd, const Pkt4Ptr& pkt) {
     // We have to create a "control message", and set that to
     // define the IPv4 packet information. We set the source address
     // to handle correctly interfaces with multiple addresses.
-    m.msg_control = &control_buf[0];
+    m.msg_control = control_buf;
     m.msg_controllen = CONTROL_BUF_LEN;
     struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
     cmsg->cmsg_level = IPPROTO_IP;
@@ -269,16 +399,6 @@ PktFilterInet::send(const Iface&, uint16_t sockfd, const Pkt4Ptr& pkt) {
 
     m.msg_controllen = CMSG_SPACE(sizeof(struct in_pktinfo));
 #endif
-
-    pkt->updateTimestamp();
-
-    int result = sendmsg(sockfd, &m, 0);
-    if (result < 0) {
-        isc_throw(SocketWriteError, "pkt4 send failed: sendmsg() returned "
-                  " with an error: " << strerror(errno));
-    }
-
-    return (0);
 }
 
 } // end of isc::dhcp namespace
@@ -9,6 +9,8 @@
 
 #include <dhcp/pkt_filter.h>
 #include <boost/scoped_array.hpp>
+#include <netinet/in.h>
+#include <sys/socket.h>
 
 namespace isc {
 namespace dhcp {
@@ -60,6 +62,27 @@ public:
     /// message parsing fails.
     virtual Pkt4Ptr receive(Iface& iface, const SocketInfo& socket_info);
 
+    /// @brief Receive a batch of packets over specified socket.
+    ///
+    /// On Linux this function uses recvmmsg() to receive all datagrams
+    /// queued on the socket, up to @c max_count, with a single system call.
+    /// On other systems it falls back to receiving a single packet.
+    ///
+    /// A datagram which can't be parsed is dropped without affecting other
+    /// datagrams from the same batch.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param max_count maximum number of packets to be received.
+    /// @param [out] pkts collection to which received packets are appended.
+    ///
+    /// @return number of packets appended to @c pkts.
+    /// @throw isc::dhcp::SocketReadError if an error occurs during reception
+    /// of the packets or if none of the received datagrams could be parsed.
+    virtual size_t receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                                const size_t max_count,
+                                std::vector<Pkt4Ptr>& pkts);
+
     /// @brief Send packet over specified socket.
     ///
     /// This function will use local address specified in the @c pkt as a source
@@ -78,7 +101,49 @@ public:
     /// a DHCP message through the socket.
     virtual int send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt);
 
+    /// @brief Send a batch of packets over specified socket.
+    ///
+    /// On Linux this function uses sendmmsg() to transmit all packets with
+    /// a single system call. On other systems it sends the packets one by
+    /// one. The source address and outbound interface of each packet are
+    /// selected as in @c send.
+    ///
+    /// @param iface interface to be used to send packets
+    /// @param sockfd socket descriptor
+    /// @param pkts packets to be sent
+    ///
+    /// @return number of packets sent from the beginning of @c pkts.
+    /// @throw isc::dhcp::SocketWriteError if the first packet can't be sent.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt4Ptr>& pkts);
+
 private:
+
+    /// @brief Creates a packet from the received datagram.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param buf buffer holding the received datagram.
+    /// @param len length of the received datagram.
+    /// @param m message header filled by the kernel on reception.
+    ///
+    /// @return Received packet
+    /// @throw An exception thrown by the isc::dhcp::Pkt4 object if DHCPv4
+    /// message parsing fails.
+    Pkt4Ptr createPacket(Iface& iface, const SocketInfo& socket_info,
+                         const uint8_t* buf, const size_t len,
+                         struct msghdr& m);
+
+    /// @brief Prepares the message header used to send a packet.
+    ///
+    /// @param pkt packet to be sent.
+    /// @param [out] to destination address.
+    /// @param [out] v vector describing the packet data.
+    /// @param [out] control_buf control buffer of @c CONTROL_BUF_LEN bytes.
+    /// @param [out] m message header referencing the other parameters.
+    void prepareMessage(const Pkt4Ptr& pkt, sockaddr_in& to, struct iovec& v,
+                        uint8_t* control_buf, struct msghdr& m);
+
     /// Length of the socket control buffer.
     static const size_t CONTROL_BUF_LEN;
 };
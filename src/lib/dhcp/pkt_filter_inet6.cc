@@ -178,39 +178,114 @@ PktFilterInet6::receive(const SocketInfo& socket_info) {
     m.msg_controllen = CONTROL_BUF_LEN;
 
     int result = recvmsg(socket_info.sockfd_, &m, 0);
+    if (result < 0) {
+        isc_throw(SocketReadError, "failed to receive data");
+    }
+
+    return (createPacket(socket_info, buf, result, m));
+}
+
+size_t
+PktFilterInet6::receiveBatch(const SocketInfo& socket_info,
+                             const size_t max_count,
+                             std::vector<Pkt6Ptr>& pkts) {
+#if defined (OS_LINUX)
+    if (max_count <= 1) {
+        return (PktFilter6::receiveBatch(socket_info, max_count, pkts));
+    }
+
+    // Prepare one message header per datagram. All buffers are allocated
+    // at once for the whole batch.
+    std::vector<uint8_t> bufs(max_count * IfaceMgr::RCVBUFSIZE);
+    std::vector<uint8_t> control_bufs(max_count * CONTROL_BUF_LEN, 0);
+    std::vector<struct sockaddr_in6> from_addrs(max_count);
+    std::vector<struct iovec> iovs(max_count);
+    std::vector<struct mmsghdr> msgs(max_count);
+    memset(&from_addrs[0], 0, max_count * sizeof(struct sockaddr_in6));
+    memset(&msgs[0], 0, max_count * sizeof(struct mmsghdr));
+
+    for (size_t i = 0; i < max_count; ++i) {
+        iovs[i].iov_base = static_cast<void*>(&bufs[i * IfaceMgr::RCVBUFSIZE]);
+        iovs[i].iov_len = IfaceMgr::RCVBUFSIZE;
+        struct msghdr& m = msgs[i].msg_hdr;
+        m.msg_name = &from_addrs[i];
+        m.msg_namelen = sizeof(struct sockaddr_in6);
+        m.msg_iov = &iovs[i];
+        m.msg_iovlen = 1;
+        m.msg_control = &control_bufs[i * CONTROL_BUF_LEN];
+        m.msg_controllen = CONTROL_BUF_LEN;
+    }
+
+    // The caller guarantees that at least one datagram is waiting so
+    // MSG_WAITFORONE makes the call return with whatever is queued
+    // without blocking for the remaining slots.
+    int result = recvmmsg(socket_info.sockfd_, &msgs[0], max_count,
+                          MSG_WAITFORONE, 0);
+    if (result < 0) {
+        isc_throw(SocketReadError, "failed to receive data");
+    }
+
+    // A malformed datagram must not cause the loss of the other datagrams
+    // from the batch. The error is reported only when none of the received
+    // datagrams could be turned into a packet.
+    std::string error;
+    size_t count = 0;
+    for (int i = 0; i < result; ++i) {
+        try {
+            Pkt6Ptr pkt = createPacket(socket_info,
+                                       &bufs[i * IfaceMgr::RCVBUFSIZE],
+                                       msgs[i].msg_len, msgs[i].msg_hdr);
+            // Packets sent to the global unicast address over the socket
+            // listening to the multicast traffic are silently dropped.
+            if (pkt) {
+                pkts.push_back(pkt);
+                ++count;
+            }
+        } catch (const std::exception& ex) {
+            error = ex.what();
+        }
+    }
+
+    if ((count == 0) && !error.empty()) {
+        isc_throw(SocketReadError, error);
+    }
 
+    return (count);
+#else
+    return (PktFilter6::receiveBatch(socket_info, max_count, pkts));
+#endif
+}
+
+Pkt6Ptr
+PktFilterInet6::createPacket(const SocketInfo& socket_info,
+                             const uint8_t* buf, const size_t len,
+                             struct msghdr& m) {
     struct in6_addr to_addr;
     memset(&to_addr, 0, sizeof(to_addr));
 
     int ifindex = -1;
-    if (result >= 0) {
-        struct in6_pktinfo* pktinfo = NULL;
-
-
-        // If we did read successfully, then we need to loop
-        // through the control messages we received and
-        // find the one with our destination address.
-        //
-        // We also keep a flag to see if we found it. If we
-        // didn't, then we consider this to be an error.
-        bool found_pktinfo = false;
-        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
-        while (cmsg != NULL) {
-            if ((cmsg->cmsg_level == IPPROTO_IPV6) &&
-                (cmsg->cmsg_type == IPV6_PKTINFO)) {
-                pktinfo = util::io::internal::convertPktInfo6(CMSG_DATA(cmsg));
-                to_addr = pktinfo->ipi6_addr;
-                ifindex = pktinfo->ipi6_ifindex;
-                found_pktinfo = true;
-                break;
-            }
-            cmsg = CMSG_NXTHDR(&m, cmsg);
-        }
-        if (!found_pktinfo) {
-            isc_throw(SocketReadError, "unable to find pktinfo");
+    struct in6_pktinfo* pktinfo = NULL;
+
+    // We did read successfully, so we need to loop through the control
+    // messages we received and find the one with our destination address.
+    //
+    // We also keep a flag to see if we found it. If we didn't, then we
+    // consider this to be an error.
+    bool found_pktinfo = false;
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m);
+    while (cmsg != NULL) {
+        if ((cmsg->cmsg_level == IPPROTO_IPV6) &&
+            (cmsg->cmsg_type == IPV6_PKTINFO)) {
+            pktinfo = util::io::internal::convertPktInfo6(CMSG_DATA(cmsg));
+            to_addr = pktinfo->ipi6_addr;
+            ifindex = pktinfo->ipi6_ifindex;
+            found_pktinfo = true;
+            break;
         }
-    } else {
-        isc_throw(SocketReadError, "failed to receive data");
+        cmsg = CMSG_NXTHDR(&m, cmsg);
+    }
+    if (!found_pktinfo) {
+        isc_throw(SocketReadError, "unable to find pktinfo");
     }
 
     // Filter out packets sent to global unicast address (not link local and
@@ -227,18 +302,20 @@ PktFilterInet6::receive(const SocketInfo& socket_info) {
     // Let's create a packet.
     Pkt6Ptr pkt;
     try {
-        pkt = Pkt6Ptr(new Pkt6(buf, result));
+        pkt = Pkt6Ptr(new Pkt6(buf, len));
     } catch (const std::exception& ex) {
         isc_throw(SocketReadError, "failed to create new packet");
     }
 
     pkt->updateTimestamp();
 
+    const struct sockaddr_in6* from =
+        static_cast<const struct sockaddr_in6*>(m.msg_name);
     pkt->setLocalAddr(IOAddress::fromBytes(AF_INET6,
                       reinterpret_cast<const uint8_t*>(&to_addr)));
     pkt->setRemoteAddr(IOAddress::fromBytes(AF_INET6,
-                       reinterpret_cast<const uint8_t*>(&from.sin6_addr)));
-    pkt->setRemotePort(ntohs(from.sin6_port));
+                       reinterpret_cast<const uint8_t*>(&from->sin6_addr)));
+    pkt->setRemotePort(ntohs(from->sin6_port));
     pkt->setIndex(ifindex);
 
     IfacePtr received = IfaceMgr::instance().getIface(pkt->getIndex());
@@ -256,10 +333,67 @@ PktFilterInet6::receive(const SocketInfo& socket_info) {
 int
 PktFilterInet6::send(const Iface&, uint16_t sockfd, const Pkt6Ptr& pkt) {
     uint8_t control_buf[CONTROL_BUF_LEN];
-    memset(&control_buf[0], 0, CONTROL_BUF_LEN);
+    sockaddr_in6 to;
+    struct iovec v;
+    struct msghdr m;
+    prepareMessage(pkt, to, v, control_buf, m);
+
+    pkt->updateTimestamp();
+
+    int result = sendmsg(sockfd, &m, 0);
+    if (result < 0) {
+        isc_throw(SocketWriteError, "pkt6 send failed: sendmsg() returned"
+                  " with an error: " << strerror(errno));
+    }
+
+    return (0);
+}
+
+size_t
+PktFilterInet6::sendBatch(const Iface& iface, uint16_t sockfd,
+                          const std::vector<Pkt6Ptr>& pkts) {
+#if defined (OS_LINUX)
+    const size_t count = pkts.size();
+    if (count <= 1) {
+        return (PktFilter6::sendBatch(iface, sockfd, pkts));
+    }
+
+    // Prepare one message header per packet. All buffers are allocated
+    // at once for the whole batch.
+    std::vector<uint8_t> control_bufs(count * CONTROL_BUF_LEN);
+    std::vector<struct sockaddr_in6> to_addrs(count);
+    std::vector<struct iovec> iovs(count);
+    std::vector<struct mmsghdr> msgs(count);
+    memset(&msgs[0], 0, count * sizeof(struct mmsghdr));
+
+    for (size_t i = 0; i < count; ++i) {
+        prepareMessage(pkts[i], to_addrs[i], iovs[i],
+                       &control_bufs[i * CONTROL_BUF_LEN], msgs[i].msg_hdr);
+        pkts[i]->updateTimestamp();
+    }
+
+    // sendmmsg() returns the number of messages sent, which may be lower
+    // than requested when a message can't be sent. It fails only when the
+    // first message can't be sent.
+    int result = sendmmsg(sockfd, &msgs[0], count, 0);
+    if (result < 0) {
+        isc_throw(SocketWriteError, "pkt6 send failed: sendmmsg() returned"
+                  " with an error: " << strerror(errno));
+    }
+
+    return (static_cast<size_t>(result));
+#else
+    return (PktFilter6::sendBatch(iface, sockfd, pkts));
+#endif
+}
+
+void
+PktFilterInet6::prepareMessage(const Pkt6Ptr& pkt, sockaddr_in6& to,
+                               struct iovec& v, uint8_t* control_buf,
+                               struct msghdr& m) {
+    memset(control_buf, 0, CONTROL_BUF_LEN);
 
     // Set the target address we're sending to.
-    sockaddr_in6 to;
     memset(&to, 0, sizeof(to));
     to.sin6_family = AF_INET6;
     to.sin6_port = htons(pkt->getRemotePort());
@@ -269,7 +403,6 @@ PktFilterInet6::send(const Iface&, uint16_t sockfd, const Pkt6Ptr& pkt) {
     to.sin6_scope_id = pkt->getIndex();
 
     // Initialize our message header structure.
-    struct msghdr m;
     memset(&m, 0, sizeof(m));
     m.msg_name = &to;
     m.msg_namelen = sizeof(to);
@@ -285,7 +418,6 @@ PktFilterInet6::send(const Iface&, uint16_t sockfd, const Pkt6Ptr& pkt) {
     // (defined as void*) we must use const cast from void *.
     // Otherwise C++ compiler would complain that we are trying
     // to assign const void* to void*.
-    struct iovec v;
     memset(&v, 0, sizeof(v));
     v.iov_base = const_cast<void *>(pkt->getBuffer().getData());
     v.iov_len = pkt->getBuffer().getLength();
@@ -298,7 +430,7 @@ PktFilterInet6::send(const Iface&, uint16_t sockfd, const Pkt6Ptr& pkt) {
     // define the IPv6 packet information. We could set the
     // source address if we wanted, but we can safely let the
     // kernel decide what that should be.
-    m.msg_control = &control_buf[0];
+    m.msg_control = control_buf;
     m.msg_controllen = CONTROL_BUF_LEN;
     struct cmsghdr *cmsg = CMSG_FIRSTHDR(&m);
 
@@ -324,16 +456,6 @@ PktFilterInet6::send(const Iface&, uint16_t sockfd, const Pkt6Ptr& pkt) {
     // which causes sendmsg to return EINVAL if the CMSG_LEN is
     // used to set the msg_controllen value.
     m.msg_controllen = CMSG_SPACE(sizeof(struct in6_pktinfo));
-
-    pkt->updateTimestamp();
-
-    int result = sendmsg(sockfd, &m, 0);
-    if (result < 0) {
-        isc_throw(SocketWriteError, "pkt6 send failed: sendmsg() returned"
-                  " with an error: " << strerror(errno));
-    }
-
-    return (0);
 }
 
 }
@@ -8,6 +8,9 @@
 #define PKT_FILTER_INET6_H
 
 #include <dhcp/pkt_filter6.h>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
 #include <boost/scoped_array.hpp>
 
 namespace isc {
@@ -62,6 +65,27 @@ public:
     /// reception.
     virtual Pkt6Ptr receive(const SocketInfo& socket_info);
 
+    /// @brief Receives a batch of DHCPv6 messages on the interface.
+    ///
+    /// On Linux this function uses recvmmsg() to receive all datagrams
+    /// queued on the socket, up to @c max_count, with a single system call.
+    /// On other systems it falls back to receiving a single message.
+    ///
+    /// Messages dropped by the @c receive function are dropped here too.
+    /// A datagram which can't be parsed is dropped without affecting other
+    /// datagrams from the same batch.
+    ///
+    /// @param socket_info A structure holding socket information.
+    /// @param max_count Maximum number of messages to be received.
+    /// @param [out] pkts Collection to which received messages are appended.
+    ///
+    /// @return Number of messages appended to @c pkts.
+    /// @throw isc::dhcp::SocketReadError if error occurred during packet
+    /// reception or if none of the received datagrams could be parsed.
+    virtual size_t receiveBatch(const SocketInfo& socket_info,
+                                const size_t max_count,
+                                std::vector<Pkt6Ptr>& pkts);
+
     /// @brief Sends DHCPv6 message through a specified interface and socket.
     ///
     /// The function sends a DHCPv6 message through a specified interface and
@@ -77,7 +101,48 @@ public:
     /// packet.
     virtual int send(const Iface& iface, uint16_t sockfd, const Pkt6Ptr& pkt);
 
+    /// @brief Sends a batch of DHCPv6 messages through a specified socket.
+    ///
+    /// On Linux this function uses sendmmsg() to transmit all messages with
+    /// a single system call. On other systems it sends the messages one by
+    /// one. The outbound interface of each message is selected as in
+    /// @c send.
+    ///
+    /// @param iface Interface to be used to send packets.
+    /// @param sockfd A socket descriptor
+    /// @param pkts Packets to be sent.
+    ///
+    /// @return Number of packets sent from the beginning of @c pkts.
+    /// @throw isc::dhcp::SocketWriteError if the first packet can't be sent.
+    virtual size_t sendBatch(const Iface& iface, uint16_t sockfd,
+                             const std::vector<Pkt6Ptr>& pkts);
+
 private:
+
+    /// @brief Creates a DHCPv6 message from the received datagram.
+    ///
+    /// @param socket_info A structure holding socket information.
+    /// @param buf Buffer holding the received datagram.
+    /// @param len Length of the received datagram.
+    /// @param m Message header filled by the kernel on reception.
+    ///
+    /// @return A pointer to received message or null pointer if the
+    /// message has been dropped.
+    /// @throw isc::dhcp::SocketReadError if the message can't be created.
+    Pkt6Ptr createPacket(const SocketInfo& socket_info,
+                         const uint8_t* buf, const size_t len,
+                         struct msghdr& m);
+
+    /// @brief Prepares the message header used to send a DHCPv6 message.
+    ///
+    /// @param pkt Packet to be sent.
+    /// @param [out] to Destination address.
+    /// @param [out] v Vector describing the packet data.
+    /// @param [out] control_buf Control buffer of @c CONTROL_BUF_LEN bytes.
+    /// @param [out] m Message header referencing the other parameters.
+    void prepareMessage(const Pkt6Ptr& pkt, sockaddr_in6& to, struct iovec& v,
+                        uint8_t* control_buf, struct msghdr& m);
+
     /// Length of the socket control buffer.
     static const size_t CONTROL_BUF_LEN;
 };
@@ -11,11 +11,16 @@
 #include <dhcp/pkt_filter_lpf.h>
 #include <dhcp/protocol_util.h>
 #include <exceptions/exceptions.h>
+
+#include <boost/noncopyable.hpp>
+
 #include <fcntl.h>
 #include <net/ethernet.h>
 #include <linux/filter.h>
 #include <linux/if_ether.h>
 #include <linux/if_packet.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace {
 
@@ -128,6 +133,230 @@ using namespace isc::util;
 namespace isc {
 namespace dhcp {
 
+const uint32_t PktFilterLPF::RING_BLOCK_SIZE;
+const uint32_t PktFilterLPF::RING_BLOCK_NUM;
+const uint32_t PktFilterLPF::RING_FRAME_SIZE;
+const uint32_t PktFilterLPF::RING_BLOCK_TIMEOUT;
+
+/// @brief Memory-mapped TPACKET_V3 receive ring of a socket.
+///
+/// The ring is made of blocks which are filled with frames by the kernel.
+/// A block is handed over to the user space when it is full or when the
+/// block timeout expires. The frames of the current block are returned
+/// one by one and the block is given back to the kernel once its last
+/// frame has been released.
+class PktFilterLPF::PacketRing : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param sockfd socket descriptor.
+    /// @param inode inode number of the socket.
+    /// @param map address of the mapped ring.
+    /// @param map_size size of the mapped ring.
+    PacketRing(const int sockfd, const ino_t inode, uint8_t* map,
+               const size_t map_size)
+        : sockfd_(sockfd), inode_(inode), map_(map), map_size_(map_size),
+          block_index_(0), frame_(0), frames_left_(0) {
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Unmaps the ring.
+    ~PacketRing() {
+        munmap(map_, map_size_);
+    }
+
+    /// @brief Returns the next frame available in the ring.
+    ///
+    /// The frames sent by this host, which are also captured by the raw
+    /// socket, are skipped. The frame remains valid until @c releaseFrame
+    /// is called.
+    ///
+    /// @param [out] len length of the frame.
+    /// @return pointer to the frame data or null if no frame is available.
+    const uint8_t* nextFrame(size_t& len) {
+        for (;;) {
+            if (frames_left_ == 0) {
+                struct tpacket_block_desc* block = currentBlock();
+                uint32_t status = __atomic_load_n(&block->hdr.bh1.block_status,
+                                                  __ATOMIC_ACQUIRE);
+                if ((status & TP_STATUS_USER) == 0) {
+                    return (0);
+                }
+                frames_left_ = block->hdr.bh1.num_pkts;
+                if (frames_left_ == 0) {
+                    releaseBlock();
+                    continue;
+                }
+                frame_ = reinterpret_cast<struct tpacket3_hdr*>
+                    (reinterpret_cast<uint8_t*>(block) +
+                     block->hdr.bh1.offset_to_first_pkt);
+            }
+
+            // The link layer address follows the frame header.
+            const struct sockaddr_ll* sll =
+                reinterpret_cast<const struct sockaddr_ll*>
+                (reinterpret_cast<const uint8_t*>(frame_) +
+                 TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+            if (sll->sll_pkttype == PACKET_OUTGOING) {
+                releaseFrame();
+                continue;
+            }
+
+            len = frame_->tp_snaplen;
+            return (reinterpret_cast<const uint8_t*>(frame_) + frame_->tp_mac);
+        }
+    }
+
+    /// @brief Releases the frame returned by @c nextFrame.
+    ///
+    /// The block is returned to the kernel when its last frame is released.
+    void releaseFrame() {
+        if (frames_left_ == 0) {
+            return;
+        }
+        if (--frames_left_ == 0) {
+            releaseBlock();
+        } else {
+            frame_ = reinterpret_cast<struct tpacket3_hdr*>
+                (reinterpret_cast<uint8_t*>(frame_) + frame_->tp_next_offset);
+        }
+    }
+
+    /// @brief Socket descriptor.
+    int sockfd_;
+
+    /// @brief Inode number of the socket.
+    ///
+    /// It is used to detect rings of the sockets which have been closed.
+    ino_t inode_;
+
+private:
+
+    /// @brief Returns the current block.
+    struct tpacket_block_desc* currentBlock() const {
+        return (reinterpret_cast<struct tpacket_block_desc*>
+                (map_ + block_index_ * RING_BLOCK_SIZE));
+    }
+
+    /// @brief Returns the current block to the kernel and moves to the
+    /// next block.
+    void releaseBlock() {
+        __atomic_store_n(&currentBlock()->hdr.bh1.block_status,
+                         TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        block_index_ = (block_index_ + 1) % RING_BLOCK_NUM;
+        frames_left_ = 0;
+        frame_ = 0;
+    }
+
+    /// @brief Address of the mapped ring.
+    uint8_t* map_;
+
+    /// @brief Size of the mapped ring.
+    size_t map_size_;
+
+    /// @brief Index of the current block.
+    uint32_t block_index_;
+
+    /// @brief Current frame in the current block.
+    struct tpacket3_hdr* frame_;
+
+    /// @brief Number of frames not yet released in the current block.
+    uint32_t frames_left_;
+};
+
+namespace {
+
+/// @brief Returns the inode number of a socket.
+///
+/// @param sock socket descriptor.
+/// @return inode number or 0 if the socket is not open.
+ino_t
+getSocketInode(const int sock) {
+    struct stat st;
+    if (fstat(sock, &st) < 0) {
+        return (0);
+    }
+    return (st.st_ino);
+}
+
+}
+
+PktFilterLPF::PktFilterLPF(const bool use_ring)
+    : use_ring_(use_ring) {
+}
+
+PktFilterLPF::~PktFilterLPF() {
+}
+
+bool
+PktFilterLPF::hasRing(const int sockfd) const {
+    return (static_cast<bool>(getRing(sockfd)));
+}
+
+PktFilterLPF::PacketRingPtr
+PktFilterLPF::getRing(const int sockfd) const {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    auto ring = rings_.find(sockfd);
+    if (ring == rings_.end()) {
+        return (PacketRingPtr());
+    }
+    return (ring->second);
+}
+
+void
+PktFilterLPF::openRing(const int sock) {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+
+    // The sockets are closed by the interface manager. Remove the rings
+    // of the closed sockets, including the one which had the same
+    // descriptor as the new socket.
+    for (auto ring = rings_.begin(); ring != rings_.end(); ) {
+        if ((ring->first == sock) ||
+            (getSocketInode(ring->first) != ring->second->inode_)) {
+            ring = rings_.erase(ring);
+        } else {
+            ++ring;
+        }
+    }
+
+    int version = TPACKET_V3;
+    if (setsockopt(sock, SOL_PACKET, PACKET_VERSION, &version,
+                   sizeof(version)) < 0) {
+        return;
+    }
+
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = RING_BLOCK_SIZE;
+    req.tp_block_nr = RING_BLOCK_NUM;
+    req.tp_frame_size = RING_FRAME_SIZE;
+    req.tp_frame_nr = (RING_BLOCK_SIZE / RING_FRAME_SIZE) * RING_BLOCK_NUM;
+    req.tp_retire_blk_tov = RING_BLOCK_TIMEOUT;
+    if (setsockopt(sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        return;
+    }
+
+    const size_t map_size = static_cast<size_t>(RING_BLOCK_SIZE) * RING_BLOCK_NUM;
+    void* map = mmap(0, map_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_LOCKED, sock, 0);
+    if (map == MAP_FAILED) {
+        // Locking the ring in memory may be denied by the limits.
+        map = mmap(0, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, sock, 0);
+    }
+    if (map == MAP_FAILED) {
+        // The frames can't be read with read() while the ring is set up.
+        // Remove the ring.
+        memset(&req, 0, sizeof(req));
+        setsockopt(sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+        return;
+    }
+
+    rings_[sock].reset(new PacketRing(sock, getSocketInode(sock),
+                                      static_cast<uint8_t*>(map), map_size));
+}
+
 SocketInfo
 PktFilterLPF::openSocket(Iface& iface,
                          const isc::asiolink::IOAddress& addr,
@@ -180,6 +409,11 @@ PktFilterLPF::openSocket(Iface& iface,
                   << " on the socket " << sock);
     }
 
+    // The receive ring must be set up before the socket is bound.
+    if (use_ring_) {
+        openRing(sock);
+    }
+
     struct sockaddr_ll sa;
     memset(&sa, 0, sizeof(sockaddr_ll));
     sa.sll_family = AF_PACKET;
@@ -213,8 +447,8 @@ PktFilterLPF::openSocket(Iface& iface,
 
 }
 
-Pkt4Ptr
-PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
+void
+PktFilterLPF::drainFallbackSocket(const SocketInfo& socket_info) {
     uint8_t raw_buf[IfaceMgr::RCVBUFSIZE];
     // First let's get some data from the fallback socket. The data will be
     // discarded but we don't want the socket buffer to bloat. We get the
@@ -234,9 +468,35 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
     do {
         datalen = recv(socket_info.fallbackfd_, raw_buf, sizeof(raw_buf), 0);
     } while (datalen > 0);
+}
+
+Pkt4Ptr
+PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
+    drainFallbackSocket(socket_info);
+
+    PacketRingPtr ring = getRing(socket_info.sockfd_);
+    if (ring) {
+        size_t frame_len = 0;
+        const uint8_t* frame = ring->nextFrame(frame_len);
+        if (!frame) {
+            return (Pkt4Ptr());
+        }
+
+        // The frame is released after parsing, even if it is malformed.
+        Pkt4Ptr pkt;
+        try {
+            pkt = createPacket(iface, frame, frame_len);
+        } catch (...) {
+            ring->releaseFrame();
+            throw;
+        }
+        ring->releaseFrame();
+        return (pkt);
+    }
 
     // Now that we finished getting data from the fallback socket, we
     // have to get the data from the raw socket too.
+    uint8_t raw_buf[IfaceMgr::RCVBUFSIZE];
     int data_len = read(socket_info.sockfd_, raw_buf, sizeof(raw_buf));
     // If negative value is returned by read(), it indicates that an
     // error occurred. If returned value is 0, no data was read from the
@@ -247,7 +507,51 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
         return Pkt4Ptr();
     }
 
-    InputBuffer buf(raw_buf, data_len);
+    return (createPacket(iface, raw_buf, data_len));
+}
+
+size_t
+PktFilterLPF::receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                           const size_t max_count,
+                           std::vector<Pkt4Ptr>& pkts) {
+    PacketRingPtr ring = getRing(socket_info.sockfd_);
+    if (!ring || (max_count <= 1)) {
+        return (PktFilter::receiveBatch(iface, socket_info, max_count, pkts));
+    }
+
+    drainFallbackSocket(socket_info);
+
+    // A malformed frame must not cause the loss of the other frames
+    // from the batch. The error is reported only when none of the received
+    // frames could be turned into a packet.
+    std::string error;
+    size_t count = 0;
+    for (size_t i = 0; i < max_count; ++i) {
+        size_t frame_len = 0;
+        const uint8_t* frame = ring->nextFrame(frame_len);
+        if (!frame) {
+            break;
+        }
+        try {
+            pkts.push_back(createPacket(iface, frame, frame_len));
+            ++count;
+        } catch (const std::exception& ex) {
+            error = ex.what();
+        }
+        ring->releaseFrame();
+    }
+
+    if ((count == 0) && !error.empty()) {
+        isc_throw(SocketReadError, error);
+    }
+
+    return (count);
+}
+
+Pkt4Ptr
+PktFilterLPF::createPacket(const Iface& iface, const uint8_t* frame,
+                           const size_t len) {
+    InputBuffer buf(frame, len);
 
     // @todo: This is awkward way to solve the chicken and egg problem
     // whereby we don't know the offset where DHCP data start in the
@@ -267,12 +571,10 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
     decodeEthernetHeader(buf, dummy_pkt);
     decodeIpUdpHeader(buf, dummy_pkt);
 
-    // Read the DHCP data.
-    std::vector<uint8_t> dhcp_buf;
-    buf.readVector(dhcp_buf, buf.getLength() - buf.getPosition());
-
-    // Decode DHCP data into the Pkt4 object.
-    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(&dhcp_buf[0], dhcp_buf.size()));
+    // Decode DHCP data into the Pkt4 object. The DHCP data are copied
+    // straight from the received frame.
+    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(frame + buf.getPosition(),
+                                   buf.getLength() - buf.getPosition()));
 
     // Set the appropriate packet members using data collected from
     // the decoded headers.
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,6 +11,11 @@
 
 #include <util/buffer.h>
 
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <mutex>
+
 namespace isc {
 namespace dhcp {
 
@@ -20,9 +25,55 @@ namespace dhcp {
 /// sockets and Linux Packet Filtering. It is used by @c isc::dhcp::IfaceMgr
 /// to send DHCPv4 messages to the hosts which don't have an IPv4 address
 /// assigned yet.
+///
+/// Packets are received with one read() per frame by default. Optionally,
+/// the frames are received through a memory-mapped ring (TPACKET_V3)
+/// shared with the kernel: the packets are parsed straight from the ring
+/// blocks without system calls, and each block is returned to the kernel
+/// once all its frames have been parsed.
 class PktFilterLPF : public PktFilter {
 public:
 
+    /// @brief Size of a block of the receive ring in bytes.
+    static const uint32_t RING_BLOCK_SIZE = 1 << 16;
+
+    /// @brief Number of blocks of the receive ring.
+    static const uint32_t RING_BLOCK_NUM = 16;
+
+    /// @brief Nominal size of a frame in the receive ring in bytes.
+    static const uint32_t RING_FRAME_SIZE = 1 << 11;
+
+    /// @brief Timeout after which a partially filled block is returned
+    /// to the user space in milliseconds.
+    static const uint32_t RING_BLOCK_TIMEOUT = 1;
+
+    /// @brief Constructor.
+    ///
+    /// @param use_ring Receive the packets through a memory-mapped ring
+    /// rather than with read(). If the ring can't be set up for a socket,
+    /// the packets are received with read() from this socket.
+    explicit PktFilterLPF(const bool use_ring = false);
+
+    /// @brief Destructor.
+    ///
+    /// Unmaps the receive rings.
+    virtual ~PktFilterLPF();
+
+    /// @brief Checks if the packets are received through a memory-mapped
+    /// ring.
+    ///
+    /// @return true if the ring is used.
+    bool usesRing() const {
+        return (use_ring_);
+    }
+
+    /// @brief Checks if a memory-mapped ring is set up for a socket.
+    ///
+    /// @param sockfd socket descriptor.
+    /// @return true if the packets are received from the socket through a
+    /// memory-mapped ring.
+    bool hasRing(const int sockfd) const;
+
     /// @brief Check if packet can be sent to the host without address directly.
     ///
     /// This class supports direct responses to the host without address.
@@ -56,6 +107,22 @@ public:
     /// @return Received packet
     virtual Pkt4Ptr receive(Iface& iface, const SocketInfo& socket_info);
 
+    /// @brief Receive a batch of packets over specified socket.
+    ///
+    /// When the socket uses a memory-mapped ring, the frames available in
+    /// the ring, up to @c max_count, are parsed without any system call.
+    /// Otherwise a single packet is received with @c receive.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param max_count maximum number of packets to be received.
+    /// @param [out] pkts collection to which received packets are appended.
+    ///
+    /// @return number of packets appended to @c pkts.
+    virtual size_t receiveBatch(Iface& iface, const SocketInfo& socket_info,
+                                const size_t max_count,
+                                std::vector<Pkt4Ptr>& pkts);
+
     /// @brief Send packet over specified socket.
     ///
     /// @param iface interface to be used to send packet
@@ -67,6 +134,51 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt4Ptr& pkt);
 
+private:
+
+    /// @brief Memory-mapped receive ring of a socket.
+    class PacketRing;
+
+    /// @brief Pointer to the @c PacketRing.
+    typedef boost::shared_ptr<PacketRing> PacketRingPtr;
+
+    /// @brief Sets up a memory-mapped receive ring for a socket.
+    ///
+    /// It must be called before the socket is bound. Errors are not
+    /// reported: the socket is then used without a ring.
+    ///
+    /// @param sock socket descriptor.
+    void openRing(const int sock);
+
+    /// @brief Returns the memory-mapped ring of a socket.
+    ///
+    /// @param sockfd socket descriptor.
+    /// @return pointer to the ring or null if the socket has no ring.
+    PacketRingPtr getRing(const int sockfd) const;
+
+    /// @brief Discards data received on the fallback socket.
+    ///
+    /// @param socket_info structure holding socket information
+    void drainFallbackSocket(const SocketInfo& socket_info);
+
+    /// @brief Creates a DHCPv4 packet from a received Ethernet frame.
+    ///
+    /// @param iface interface
+    /// @param frame pointer to the frame data.
+    /// @param len length of the frame.
+    ///
+    /// @return pointer to the packet.
+    Pkt4Ptr createPacket(const Iface& iface, const uint8_t* frame,
+                         const size_t len);
+
+    /// @brief Flag indicating if the memory-mapped rings are used.
+    bool use_ring_;
+
+    /// @brief Memory-mapped rings indexed by socket descriptor.
+    std::map<int, PacketRingPtr> rings_;
+
+    /// @brief Mutex protecting the rings map.
+    mutable std::mutex rings_mutex_;
 };
 
 } // namespace isc::dhcp
@@ -15,6 +15,7 @@
 #include <dhcp/tests/iface_mgr_test_config.h>
 #include <dhcp/tests/pkt_filter6_test_utils.h>
 #include <dhcp/tests/packet_queue_testutils.h>
+#include <stats/stats_mgr.h>
 #include <testutils/gtest_utils.h>
 
 #include <boost/foreach.hpp>
@@ -25,7 +26,9 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <set>
 #include <sstream>
+#include <thread>
 
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -35,6 +38,8 @@ using namespace isc;
 using namespace isc::asiolink;
 using namespace isc::dhcp;
 using namespace isc::dhcp::test;
+using namespace isc::stats;
+using namespace isc::util;
 using boost::scoped_ptr;
 namespace ph = std::placeholders;
 
@@ -1553,6 +1558,501 @@ TEST_F(IfaceMgrTest, sendReceive4) {
     sendReceive4Test(queue_control, true);
 }
 
+// Verifies that the receive batch size can be set directly and through
+// the dhcp-queue-control configuration.
+TEST_F(IfaceMgrTest, receiveBatchSize) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+
+    // Batching is disabled by default.
+    EXPECT_EQ(1, ifacemgr->getReceiveBatchSize());
+
+    // Out of range values are rejected.
+    EXPECT_THROW(ifacemgr->setReceiveBatchSize(0), BadValue);
+    EXPECT_THROW(ifacemgr->setReceiveBatchSize(IfaceMgr::MAX_RECEIVE_BATCH_SIZE + 1),
+                 BadValue);
+    EXPECT_EQ(1, ifacemgr->getReceiveBatchSize());
+
+    ASSERT_NO_THROW(ifacemgr->setReceiveBatchSize(IfaceMgr::MAX_RECEIVE_BATCH_SIZE));
+    EXPECT_EQ(IfaceMgr::MAX_RECEIVE_BATCH_SIZE, ifacemgr->getReceiveBatchSize());
+
+    // The batch size is taken from the queue control.
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, false);
+    queue_control->set("receive-batch-size", data::Element::create(32));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_EQ(32, ifacemgr->getReceiveBatchSize());
+
+    // Invalid value in the queue control is rejected.
+    queue_control->set("receive-batch-size", data::Element::create(0));
+    EXPECT_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control),
+                 OutOfRange);
+
+    // Batching is disabled when the parameter is not specified.
+    queue_control->remove("receive-batch-size");
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_EQ(1, ifacemgr->getReceiveBatchSize());
+
+    ASSERT_NO_THROW(ifacemgr->setReceiveBatchSize(8));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET6, data::ConstElementPtr()));
+    EXPECT_EQ(1, ifacemgr->getReceiveBatchSize());
+}
+
+// Verifies that DHCPv4 packets waiting on a socket are read at once when
+// batching is enabled and returned one by one by subsequent calls to
+// receive4 in direct mode.
+TEST_F(IfaceMgrTest, receiveBatch4) {
+    StatsMgr::instance().removeAll();
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    ASSERT_NO_THROW(ifacemgr->setReceiveBatchSize(8));
+
+    IOAddress lo_addr("127.0.0.1");
+    int socket1 = -1;
+    ASSERT_NO_THROW(socket1 = ifacemgr->openSocket(LOOPBACK_NAME, lo_addr,
+                                                   DHCP4_SERVER_PORT + 10000));
+    ASSERT_GE(socket1, 0);
+
+    // Send three packets to ourselves.
+    for (uint32_t transid = 1; transid <= 3; ++transid) {
+        Pkt4Ptr send_pkt(new Pkt4(DHCPDISCOVER, transid));
+        send_pkt->setLocalAddr(IOAddress("127.0.0.1"));
+        send_pkt->setRemotePort(DHCP4_SERVER_PORT + 10000);
+        send_pkt->setRemoteAddr(IOAddress("127.0.0.1"));
+        send_pkt->setIndex(LOOPBACK_INDEX);
+        send_pkt->setIface(string(LOOPBACK_NAME));
+        ASSERT_NO_THROW(send_pkt->pack());
+        ASSERT_TRUE(ifacemgr->send(send_pkt));
+    }
+
+    // All packets should be returned in order.
+    for (uint32_t transid = 1; transid <= 3; ++transid) {
+        Pkt4Ptr rcv_pkt;
+        ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive4(1));
+        ASSERT_TRUE(rcv_pkt);
+        ASSERT_NO_THROW(rcv_pkt->unpack());
+        EXPECT_EQ(transid, rcv_pkt->getTransid());
+    }
+
+    // There is nothing more to receive.
+    Pkt4Ptr rcv_pkt;
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive4(0, 1000));
+    EXPECT_FALSE(rcv_pkt);
+
+    // All packets should have been read at once.
+    ObservationPtr batches = StatsMgr::instance().getObservation("pkt4-receive-batches");
+    ASSERT_TRUE(batches);
+    EXPECT_EQ(1, batches->getInteger().first);
+    ObservationPtr avg = StatsMgr::instance().getObservation("pkt4-receive-batch-size-avg");
+    ASSERT_TRUE(avg);
+    EXPECT_DOUBLE_EQ(3.0, avg->getFloat().first);
+
+    StatsMgr::instance().removeAll();
+}
+
+// Verifies that DHCPv6 packets waiting on a socket are read at once when
+// batching is enabled and returned one by one by subsequent calls to
+// receive6 in direct mode.
+TEST_F(IfaceMgrTest, receiveBatch6) {
+    StatsMgr::instance().removeAll();
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    ASSERT_NO_THROW(ifacemgr->setReceiveBatchSize(8));
+
+    IOAddress lo_addr("::1");
+    int socket1 = -1;
+    ASSERT_NO_THROW(socket1 = ifacemgr->openSocket(LOOPBACK_NAME, lo_addr,
+                                                   10547));
+    ASSERT_GE(socket1, 0);
+
+    // Send three packets to ourselves.
+    for (uint32_t transid = 1; transid <= 3; ++transid) {
+        Pkt6Ptr send_pkt(new Pkt6(DHCPV6_SOLICIT, transid));
+        send_pkt->setRemotePort(10547);
+        send_pkt->setRemoteAddr(IOAddress("::1"));
+        send_pkt->setIndex(LOOPBACK_INDEX);
+        send_pkt->setIface(LOOPBACK_NAME);
+        ASSERT_NO_THROW(send_pkt->pack());
+        ASSERT_TRUE(ifacemgr->send(send_pkt));
+    }
+
+    // All packets should be returned in order.
+    for (uint32_t transid = 1; transid <= 3; ++transid) {
+        Pkt6Ptr rcv_pkt;
+        ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive6(1));
+        ASSERT_TRUE(rcv_pkt);
+        ASSERT_NO_THROW(rcv_pkt->unpack());
+        EXPECT_EQ(transid, rcv_pkt->getTransid());
+    }
+
+    // There is nothing more to receive.
+    Pkt6Ptr rcv_pkt;
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive6(0, 1000));
+    EXPECT_FALSE(rcv_pkt);
+
+    // All packets should have been read at once.
+    ObservationPtr batches = StatsMgr::instance().getObservation("pkt6-receive-batches");
+    ASSERT_TRUE(batches);
+    EXPECT_EQ(1, batches->getInteger().first);
+    ObservationPtr avg = StatsMgr::instance().getObservation("pkt6-receive-batch-size-avg");
+    ASSERT_TRUE(avg);
+    EXPECT_DOUBLE_EQ(3.0, avg->getFloat().first);
+
+    StatsMgr::instance().removeAll();
+}
+
+// Verifies that the send batch size can be set directly and through
+// the dhcp-queue-control configuration.
+TEST_F(IfaceMgrTest, sendBatchSize) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+
+    // Batching is disabled by default.
+    EXPECT_EQ(1, ifacemgr->getSendBatchSize());
+
+    // Out of range values are rejected.
+    EXPECT_THROW(ifacemgr->setSendBatchSize(0), BadValue);
+    EXPECT_THROW(ifacemgr->setSendBatchSize(IfaceMgr::MAX_SEND_BATCH_SIZE + 1),
+                 BadValue);
+    EXPECT_EQ(1, ifacemgr->getSendBatchSize());
+
+    ASSERT_NO_THROW(ifacemgr->setSendBatchSize(IfaceMgr::MAX_SEND_BATCH_SIZE));
+    EXPECT_EQ(IfaceMgr::MAX_SEND_BATCH_SIZE, ifacemgr->getSendBatchSize());
+
+    // The batch size is taken from the queue control.
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, false);
+    queue_control->set("send-batch-size", data::Element::create(16));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_EQ(16, ifacemgr->getSendBatchSize());
+
+    // Invalid value in the queue control is rejected.
+    queue_control->set("send-batch-size", data::Element::create(0));
+    EXPECT_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control),
+                 OutOfRange);
+
+    // Batching is disabled when the parameter is not specified.
+    queue_control->remove("send-batch-size");
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_EQ(1, ifacemgr->getSendBatchSize());
+}
+
+// Verifies that the memory-mapped ring of the raw sockets can be enabled
+// directly and through the dhcp-queue-control configuration.
+TEST_F(IfaceMgrTest, rawSocketRing) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+
+    // The ring is disabled by default.
+    EXPECT_FALSE(ifacemgr->getRawSocketRing());
+
+    ifacemgr->setRawSocketRing(true);
+    EXPECT_TRUE(ifacemgr->getRawSocketRing());
+
+    // The ring is disabled when the parameter is not specified.
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, false);
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_FALSE(ifacemgr->getRawSocketRing());
+
+    queue_control->set("raw-socket-ring", data::Element::create(true));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_TRUE(ifacemgr->getRawSocketRing());
+
+    // Invalid value in the queue control is rejected.
+    queue_control->set("raw-socket-ring", data::Element::create(1));
+    EXPECT_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control),
+                 DhcpConfigError);
+}
+
+// Verifies that DHCPv4 packets sent concurrently by several threads are
+// all transmitted when batching is enabled and that the batches are
+// accounted in the statistics.
+TEST_F(IfaceMgrTest, sendBatch4) {
+    StatsMgr::instance().removeAll();
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    ASSERT_NO_THROW(ifacemgr->setSendBatchSize(8));
+    ASSERT_NO_THROW(ifacemgr->setReceiveBatchSize(16));
+
+    IOAddress lo_addr("127.0.0.1");
+    int socket1 = -1;
+    ASSERT_NO_THROW(socket1 = ifacemgr->openSocket(LOOPBACK_NAME, lo_addr,
+                                                   DHCP4_SERVER_PORT + 10000));
+    ASSERT_GE(socket1, 0);
+
+    // Send eight packets to ourselves from different threads.
+    std::vector<std::thread> threads;
+    for (uint32_t transid = 1; transid <= 8; ++transid) {
+        threads.push_back(std::thread([&ifacemgr, transid]() {
+            Pkt4Ptr send_pkt(new Pkt4(DHCPOFFER, transid));
+            send_pkt->setLocalAddr(IOAddress("127.0.0.1"));
+            send_pkt->setRemotePort(DHCP4_SERVER_PORT + 10000);
+            send_pkt->setRemoteAddr(IOAddress("127.0.0.1"));
+            send_pkt->setIndex(LOOPBACK_INDEX);
+            send_pkt->setIface(string(LOOPBACK_NAME));
+            send_pkt->pack();
+            EXPECT_TRUE(ifacemgr->send(send_pkt));
+        }));
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    // All packets should be received.
+    std::set<uint32_t> transids;
+    for (int i = 0; i < 8; ++i) {
+        Pkt4Ptr rcv_pkt;
+        ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive4(1));
+        ASSERT_TRUE(rcv_pkt);
+        ASSERT_NO_THROW(rcv_pkt->unpack());
+        transids.insert(rcv_pkt->getTransid());
+    }
+    EXPECT_EQ(8, transids.size());
+
+    // Each packet was sent in a batch.
+    ObservationPtr batches = StatsMgr::instance().getObservation("pkt4-send-batches");
+    ASSERT_TRUE(batches);
+    int64_t batch_count = batches->getInteger().first;
+    EXPECT_GE(batch_count, 1);
+    EXPECT_LE(batch_count, 8);
+    ObservationPtr avg = StatsMgr::instance().getObservation("pkt4-send-batch-size-avg");
+    ASSERT_TRUE(avg);
+    EXPECT_DOUBLE_EQ(8.0 / batch_count, avg->getFloat().first);
+
+    StatsMgr::instance().removeAll();
+}
+
+// Verifies that DHCPv6 packets sent concurrently by several threads are
+// all transmitted when batching is enabled and that the batches are
+// accounted in the statistics.
+TEST_F(IfaceMgrTest, sendBatch6) {
+    StatsMgr::instance().removeAll();
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    ASSERT_NO_THROW(ifacemgr->setSendBatchSize(8));
+    ASSERT_NO_THROW(ifacemgr->setReceiveBatchSize(16));
+
+    IOAddress lo_addr("::1");
+    int socket1 = -1;
+    ASSERT_NO_THROW(socket1 = ifacemgr->openSocket(LOOPBACK_NAME, lo_addr,
+                                                   10547));
+    ASSERT_GE(socket1, 0);
+
+    // Send eight packets to ourselves from different threads.
+    std::vector<std::thread> threads;
+    for (uint32_t transid = 1; transid <= 8; ++transid) {
+        threads.push_back(std::thread([&ifacemgr, transid]() {
+            Pkt6Ptr send_pkt(new Pkt6(DHCPV6_ADVERTISE, transid));
+            send_pkt->setRemotePort(10547);
+            send_pkt->setRemoteAddr(IOAddress("::1"));
+            send_pkt->setIndex(LOOPBACK_INDEX);
+            send_pkt->setIface(LOOPBACK_NAME);
+            send_pkt->pack();
+            EXPECT_TRUE(ifacemgr->send(send_pkt));
+        }));
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    // All packets should be received.
+    std::set<uint32_t> transids;
+    for (int i = 0; i < 8; ++i) {
+        Pkt6Ptr rcv_pkt;
+        ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive6(1));
+        ASSERT_TRUE(rcv_pkt);
+        ASSERT_NO_THROW(rcv_pkt->unpack());
+        transids.insert(rcv_pkt->getTransid());
+    }
+    EXPECT_EQ(8, transids.size());
+
+    // Each packet was sent in a batch.
+    ObservationPtr batches = StatsMgr::instance().getObservation("pkt6-send-batches");
+    ASSERT_TRUE(batches);
+    int64_t batch_count = batches->getInteger().first;
+    EXPECT_GE(batch_count, 1);
+    EXPECT_LE(batch_count, 8);
+    ObservationPtr avg = StatsMgr::instance().getObservation("pkt6-send-batch-size-avg");
+    ASSERT_TRUE(avg);
+    EXPECT_DOUBLE_EQ(8.0 / batch_count, avg->getFloat().first);
+
+    StatsMgr::instance().removeAll();
+}
+
+// Verifies that the event handler type can be set directly and through
+// the dhcp-queue-control configuration.
+TEST_F(IfaceMgrTest, eventHandlerType) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+
+    // select() is used by default.
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT, ifacemgr->getEventHandlerType());
+
+    // Unsupported types are rejected.
+    EXPECT_THROW(ifacemgr->setEventHandlerType(FDEventHandler::TYPE_UNKNOWN),
+                 NotImplemented);
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT, ifacemgr->getEventHandlerType());
+
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, false);
+    queue_control->set("event-handler", data::Element::create("select"));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT, ifacemgr->getEventHandlerType());
+
+#if defined (OS_LINUX)
+    queue_control->set("event-handler", data::Element::create("epoll"));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_EQ(FDEventHandler::TYPE_EPOLL, ifacemgr->getEventHandlerType());
+
+    // The default is restored when the parameter is not specified.
+    queue_control->remove("event-handler");
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT, ifacemgr->getEventHandlerType());
+#endif
+
+    // Unknown names are rejected.
+    queue_control->set("event-handler", data::Element::create("kqueue"));
+    EXPECT_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control),
+                 BadValue);
+}
+
+#if defined (OS_LINUX)
+
+// Verifies that DHCPv4 packets and external socket events are received
+// using the epoll event handler and that the watched sockets follow the
+// changes of interface and external sockets.
+TEST_F(IfaceMgrTest, receiveEpoll4) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    ASSERT_NO_THROW(ifacemgr->setEventHandlerType(FDEventHandler::TYPE_EPOLL));
+
+    IOAddress lo_addr("127.0.0.1");
+    int socket1 = -1;
+    ASSERT_NO_THROW(socket1 = ifacemgr->openSocket(LOOPBACK_NAME, lo_addr,
+                                                   DHCP4_SERVER_PORT + 10000));
+    ASSERT_GE(socket1, 0);
+
+    // Register an external socket which drains the pipe.
+    int pipefd[2];
+    ASSERT_EQ(0, pipe(pipefd));
+    int callback_calls = 0;
+    ASSERT_NO_THROW(ifacemgr->addExternalSocket(pipefd[0],
+                    [&callback_calls](int fd) {
+                        char buf[64];
+                        EXPECT_LT(0, read(fd, buf, sizeof(buf)));
+                        ++callback_calls;
+                    }));
+
+    // Nothing to receive.
+    Pkt4Ptr rcv_pkt;
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive4(0, 1000));
+    EXPECT_FALSE(rcv_pkt);
+    EXPECT_EQ(0, callback_calls);
+
+    // Sends a packet to the given port of the loopback interface.
+    auto send = [&ifacemgr](uint16_t port, uint32_t transid) {
+        Pkt4Ptr send_pkt(new Pkt4(DHCPDISCOVER, transid));
+        send_pkt->setLocalAddr(IOAddress("127.0.0.1"));
+        send_pkt->setRemotePort(port);
+        send_pkt->setRemoteAddr(IOAddress("127.0.0.1"));
+        send_pkt->setIndex(LOOPBACK_INDEX);
+        send_pkt->setIface(string(LOOPBACK_NAME));
+        ASSERT_NO_THROW(send_pkt->pack());
+        ASSERT_TRUE(ifacemgr->send(send_pkt));
+    };
+
+    send(DHCP4_SERVER_PORT + 10000, 1);
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive4(1));
+    ASSERT_TRUE(rcv_pkt);
+    ASSERT_NO_THROW(rcv_pkt->unpack());
+    EXPECT_EQ(1, rcv_pkt->getTransid());
+
+    // The external socket is watched too.
+    ASSERT_EQ(4, write(pipefd[1], "test", 4));
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive4(1));
+    EXPECT_FALSE(rcv_pkt);
+    EXPECT_EQ(1, callback_calls);
+
+    // A socket opened after the first wait is watched as well.
+    int socket2 = -1;
+    ASSERT_NO_THROW(socket2 = ifacemgr->openSocket(LOOPBACK_NAME, lo_addr,
+                                                   DHCP4_SERVER_PORT + 10001));
+    ASSERT_GE(socket2, 0);
+    send(DHCP4_SERVER_PORT + 10001, 2);
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive4(1));
+    ASSERT_TRUE(rcv_pkt);
+    ASSERT_NO_THROW(rcv_pkt->unpack());
+    EXPECT_EQ(2, rcv_pkt->getTransid());
+
+    // A deleted external socket is no longer watched.
+    ASSERT_NO_THROW(ifacemgr->deleteExternalSocket(pipefd[0]));
+    ASSERT_EQ(4, write(pipefd[1], "test", 4));
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive4(0, 1000));
+    EXPECT_FALSE(rcv_pkt);
+    EXPECT_EQ(1, callback_calls);
+
+    // The receiver thread uses the epoll event handler too.
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr4::DEFAULT_QUEUE_TYPE4, 500, true);
+    queue_control->set("event-handler", data::Element::create("epoll"));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET, queue_control));
+    ASSERT_NO_THROW(ifacemgr->startDHCPReceiver(AF_INET));
+    ASSERT_TRUE(ifacemgr->isDHCPReceiverRunning());
+
+    send(DHCP4_SERVER_PORT + 10000, 3);
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive4(1));
+    ASSERT_TRUE(rcv_pkt);
+    ASSERT_NO_THROW(rcv_pkt->unpack());
+    EXPECT_EQ(3, rcv_pkt->getTransid());
+
+    ASSERT_NO_THROW(ifacemgr->stopDHCPReceiver());
+    close(pipefd[0]);
+    close(pipefd[1]);
+}
+
+// Verifies that DHCPv6 packets are received using the epoll event handler
+// in direct and indirect modes.
+TEST_F(IfaceMgrTest, receiveEpoll6) {
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+    ASSERT_NO_THROW(ifacemgr->setEventHandlerType(FDEventHandler::TYPE_EPOLL));
+
+    IOAddress lo_addr("::1");
+    int socket1 = -1;
+    ASSERT_NO_THROW(socket1 = ifacemgr->openSocket(LOOPBACK_NAME, lo_addr,
+                                                   10547));
+    ASSERT_GE(socket1, 0);
+
+    // Sends a packet to the loopback interface.
+    auto send = [&ifacemgr](uint32_t transid) {
+        Pkt6Ptr send_pkt(new Pkt6(DHCPV6_SOLICIT, transid));
+        send_pkt->setRemotePort(10547);
+        send_pkt->setRemoteAddr(IOAddress("::1"));
+        send_pkt->setIndex(LOOPBACK_INDEX);
+        send_pkt->setIface(LOOPBACK_NAME);
+        ASSERT_NO_THROW(send_pkt->pack());
+        ASSERT_TRUE(ifacemgr->send(send_pkt));
+    };
+
+    Pkt6Ptr rcv_pkt;
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive6(0, 1000));
+    EXPECT_FALSE(rcv_pkt);
+
+    send(1);
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive6(1));
+    ASSERT_TRUE(rcv_pkt);
+    ASSERT_NO_THROW(rcv_pkt->unpack());
+    EXPECT_EQ(1, rcv_pkt->getTransid());
+
+    data::ElementPtr queue_control =
+        makeQueueConfig(PacketQueueMgr6::DEFAULT_QUEUE_TYPE6, 500, true);
+    queue_control->set("event-handler", data::Element::create("epoll"));
+    ASSERT_NO_THROW(ifacemgr->configureDHCPPacketQueue(AF_INET6, queue_control));
+    ASSERT_NO_THROW(ifacemgr->startDHCPReceiver(AF_INET6));
+    ASSERT_TRUE(ifacemgr->isDHCPReceiverRunning());
+
+    send(2);
+    ASSERT_NO_THROW(rcv_pkt = ifacemgr->receive6(1));
+    ASSERT_TRUE(rcv_pkt);
+    ASSERT_NO_THROW(rcv_pkt->unpack());
+    EXPECT_EQ(2, rcv_pkt->getTransid());
+
+    ASSERT_NO_THROW(ifacemgr->stopDHCPReceiver());
+}
+
+#endif
+
 // Verifies that it is possible to set custom packet filter object
 // to handle sockets opening and send/receive operation.
 TEST_F(IfaceMgrTest, setPacketFilter) {
@@ -0,0 +1,184 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/packet_send_queue.h>
+#include <dhcp/pkt4.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace isc;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture recording the batches sent by a send queue.
+class PacketSendQueueTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor
+    PacketSendQueueTest()
+        : queue_(4), block_(false), failures_(0) {
+    }
+
+    /// @brief Batch send function recording the batches.
+    ///
+    /// It waits while @c block_ is set and throws while @c failures_ is
+    /// not zero.
+    ///
+    /// @param pkts packets of the batch.
+    /// @return number of packets in the batch.
+    size_t sendBatch(const vector<Pkt4Ptr>& pkts) {
+        unique_lock<mutex> lock(mutex_);
+        batches_.push_back(pkts.size());
+        cv_.wait(lock, [this]() { return (!block_); });
+        if (failures_ > 0) {
+            --failures_;
+            isc_throw(SocketWriteError, "send failed");
+        }
+        return (pkts.size());
+    }
+
+    /// @brief Sends a packet through the queue.
+    ///
+    /// @param transid transaction id of the packet.
+    void send(uint32_t transid) {
+        Pkt4Ptr pkt(new Pkt4(DHCPOFFER, transid));
+        try {
+            queue_.send(pkt, [this](const vector<Pkt4Ptr>& pkts) {
+                return (sendBatch(pkts));
+            });
+            ++sent_;
+        } catch (const SocketWriteError&) {
+            ++failed_;
+        }
+    }
+
+    /// @brief Waits until the queue holds the given number of packets.
+    ///
+    /// @param size expected number of packets.
+    void waitSize(size_t size) {
+        for (int i = 0; (i < 1000) && (queue_.getSize() != size); ++i) {
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+        ASSERT_EQ(size, queue_.getSize());
+    }
+
+    /// @brief Waits until the send function was called the given number
+    /// of times.
+    ///
+    /// @param count expected number of calls.
+    void waitBatches(size_t count) {
+        unique_lock<mutex> lock(mutex_);
+        for (int i = 0; (i < 1000) && (batches_.size() != count); ++i) {
+            lock.unlock();
+            this_thread::sleep_for(chrono::milliseconds(5));
+            lock.lock();
+        }
+        ASSERT_EQ(count, batches_.size());
+    }
+
+    /// @brief Unblocks the batch send function.
+    void unblock() {
+        lock_guard<mutex> lock(mutex_);
+        block_ = false;
+        cv_.notify_all();
+    }
+
+    /// @brief Send queue under test.
+    PacketSendQueue<Pkt4Ptr> queue_;
+
+    /// @brief Sizes of the batches passed to the send function.
+    vector<size_t> batches_;
+
+    /// @brief Blocks the send function when set.
+    bool block_;
+
+    /// @brief Number of calls to the send function which throw.
+    size_t failures_;
+
+    /// @brief Number of packets successfully sent.
+    atomic<size_t> sent_{0};
+
+    /// @brief Number of packets which could not be sent.
+    atomic<size_t> failed_{0};
+
+    /// @brief Mutex protecting the test state.
+    mutex mutex_;
+
+    /// @brief Condition variable used to unblock the send function.
+    condition_variable cv_;
+};
+
+// Verifies that packets sent by a single thread are sent one by one.
+TEST_F(PacketSendQueueTest, singleThread) {
+    EXPECT_EQ(4, queue_.getMaxBatchSize());
+
+    for (uint32_t transid = 1; transid <= 3; ++transid) {
+        send(transid);
+    }
+    EXPECT_EQ(3, sent_);
+    EXPECT_EQ(0, queue_.getSize());
+    EXPECT_EQ(vector<size_t>({1, 1, 1}), batches_);
+}
+
+// Verifies that packets queued while a batch is sent are coalesced
+// and that the maximum batch size is honored.
+TEST_F(PacketSendQueueTest, coalesce) {
+    block_ = true;
+    vector<thread> threads;
+    threads.push_back(thread([this]() { send(1); }));
+
+    // Wait for the first batch to be in flight and queue more packets.
+    waitBatches(1);
+    for (uint32_t transid = 2; transid <= 7; ++transid) {
+        threads.push_back(thread([this, transid]() { send(transid); }));
+    }
+    waitSize(7);
+
+    unblock();
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    EXPECT_EQ(7, sent_);
+    EXPECT_EQ(0, queue_.getSize());
+    EXPECT_EQ(vector<size_t>({1, 4, 2}), batches_);
+}
+
+// Verifies that the error is reported to the sender of the first packet
+// of the batch and that the other packets are sent with the next batch.
+TEST_F(PacketSendQueueTest, error) {
+    block_ = true;
+    failures_ = 1;
+    vector<thread> threads;
+    threads.push_back(thread([this]() { send(1); }));
+    waitBatches(1);
+    for (uint32_t transid = 2; transid <= 3; ++transid) {
+        threads.push_back(thread([this, transid]() { send(transid); }));
+    }
+    waitSize(3);
+
+    unblock();
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    EXPECT_EQ(1, failed_);
+    EXPECT_EQ(2, sent_);
+    EXPECT_EQ(vector<size_t>({1, 2}), batches_);
+}
+
+} // end of anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -145,4 +145,86 @@ TEST_F(PktFilterInetTest, receive) {
     testRcvdMessageAddressPort(rcvd_pkt);
 }
 
+// This test verifies that multiple DHCPv4 packets waiting on the INET
+// datagram socket are received at once and that the batch size is honored.
+TEST_F(PktFilterInetTest, receiveBatch) {
+
+    // Packets will be received over loopback interface.
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    // Create an instance of the class which we are testing.
+    PktFilterInet pkt_filter;
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+
+    // Send three DHCPv4 messages to the local loopback address and
+    // server's port.
+    for (int i = 0; i < 3; ++i) {
+        sendMessage();
+    }
+
+    // Receive at most two packets.
+    std::vector<Pkt4Ptr> pkts;
+    size_t count = 0;
+    ASSERT_NO_THROW(count = pkt_filter.receiveBatch(iface, sock_info_, 2, pkts));
+    EXPECT_EQ(2, count);
+    ASSERT_EQ(2, pkts.size());
+
+    // The remaining packet should be returned by the next call even if
+    // the batch size is greater.
+    ASSERT_NO_THROW(count = pkt_filter.receiveBatch(iface, sock_info_, 10, pkts));
+    EXPECT_EQ(1, count);
+    ASSERT_EQ(3, pkts.size());
+
+    // Check that the packets have been correctly received.
+    for (auto const& rcvd_pkt : pkts) {
+        ASSERT_TRUE(rcvd_pkt);
+        ASSERT_NO_THROW(rcvd_pkt->unpack());
+        testRcvdMessage(rcvd_pkt);
+        testRcvdMessageAddressPort(rcvd_pkt);
+    }
+}
+
+// This test verifies that a batch of DHCPv4 packets is correctly sent over
+// the INET datagram socket.
+TEST_F(PktFilterInetTest, sendBatch) {
+    // Packets will be sent over loopback interface.
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    // Create an instance of the class which we are testing.
+    PktFilterInet pkt_filter;
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+
+    // Send the same message three times at once.
+    std::vector<Pkt4Ptr> batch(3, test_message_);
+    size_t count = 0;
+    ASSERT_NO_THROW(count = pkt_filter.sendBatch(iface, sock_info_.sockfd_, batch));
+    EXPECT_EQ(3, count);
+
+    // Wait for the data on the socket.
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    FD_SET(sock_info_.sockfd_, &readfds);
+
+    struct timeval timeout;
+    timeout.tv_sec = 5;
+    timeout.tv_usec = 0;
+    int result = select(sock_info_.sockfd_ + 1, &readfds, NULL, NULL, &timeout);
+    ASSERT_GT(result, 0);
+
+    // All packets should have been received.
+    std::vector<Pkt4Ptr> pkts;
+    ASSERT_NO_THROW(count = pkt_filter.receiveBatch(iface, sock_info_, 10, pkts));
+    EXPECT_EQ(3, count);
+    ASSERT_EQ(3, pkts.size());
+    for (auto const& rcvd_pkt : pkts) {
+        ASSERT_TRUE(rcvd_pkt);
+        ASSERT_NO_THROW(rcvd_pkt->unpack());
+        testRcvdMessage(rcvd_pkt);
+    }
+}
+
 } // anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -219,4 +219,78 @@ TEST_F(PktFilterLPFTest, DISABLED_filterOutUnicast) {
     ASSERT_LE(result, 0);
 }
 
+// This test verifies that the memory-mapped receive ring is set up for
+// the raw socket when requested.
+TEST_F(PktFilterLPFTest, DISABLED_openSocketRing) {
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    // The ring is not used by default.
+    PktFilterLPF pkt_filter_no_ring;
+    EXPECT_FALSE(pkt_filter_no_ring.usesRing());
+
+    PktFilterLPF pkt_filter(true);
+    EXPECT_TRUE(pkt_filter.usesRing());
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+    EXPECT_TRUE(pkt_filter.hasRing(sock_info_.sockfd_));
+
+    // Verify that the TPACKET_V3 ring is in use.
+    int version = 0;
+    socklen_t version_len = sizeof(version);
+    ASSERT_EQ(0, getsockopt(sock_info_.sockfd_, SOL_PACKET, PACKET_VERSION,
+                            &version, &version_len));
+    EXPECT_EQ(TPACKET_V3, version);
+}
+
+// This test verifies correctness of reception of the DHCP packets
+// through the memory-mapped receive ring.
+TEST_F(PktFilterLPFTest, DISABLED_receiveRing) {
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    PktFilterLPF pkt_filter(true);
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+    ASSERT_TRUE(pkt_filter.hasRing(sock_info_.sockfd_));
+
+    // Send three DHCPv4 messages to the local loopback address and
+    // server's port.
+    for (int i = 0; i < 3; ++i) {
+        sendMessage();
+    }
+
+    // The socket becomes readable when a block of the ring is handed
+    // over to the user space.
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    FD_SET(sock_info_.sockfd_, &readfds);
+    struct timeval timeout;
+    timeout.tv_sec = 5;
+    timeout.tv_usec = 0;
+    int result = select(sock_info_.sockfd_ + 1, &readfds, NULL, NULL, &timeout);
+    ASSERT_GT(result, 0);
+
+    // Receive the first packet alone and the remaining ones in a batch.
+    std::vector<Pkt4Ptr> pkts;
+    Pkt4Ptr rcvd_pkt = pkt_filter.receive(iface, sock_info_);
+    ASSERT_TRUE(rcvd_pkt);
+    pkts.push_back(rcvd_pkt);
+    size_t count = 0;
+    ASSERT_NO_THROW(count = pkt_filter.receiveBatch(iface, sock_info_, 10, pkts));
+    EXPECT_EQ(2, count);
+    ASSERT_EQ(3, pkts.size());
+
+    // Check that the packets have been correctly received.
+    for (auto const& pkt : pkts) {
+        ASSERT_TRUE(pkt);
+        ASSERT_NO_THROW(pkt->unpack());
+        testRcvdMessage(pkt);
+        testRcvdMessageAddressPort(pkt);
+    }
+
+    // There is nothing more to receive.
+    EXPECT_FALSE(pkt_filter.receive(iface, sock_info_));
+}
+
 } // anonymous namespace
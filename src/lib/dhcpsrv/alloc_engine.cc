@@ -6,6 +6,7 @@
 
 #include <config.h>
 
+#include <asiolink/addr_utilities.h>
 #include <dhcp/dhcp6.h>
 #include <dhcp/pkt4.h>
 #include <dhcp/pkt6.h>
@@ -36,6 +37,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <iterator>
 #include <limits>
 #include <sstream>
 #include <stdint.h>
@@ -86,11 +88,32 @@ struct AllocEngineHooks {
 // module is called.
 AllocEngineHooks Hooks;
 
+/// Maximum number of expired leases reclaimed with a single update of the
+/// lease database.
+const size_t RECLAIM_BATCH_SIZE = 100;
+
 }  // namespace
 
 namespace isc {
 namespace dhcp {
 
+std::unique_lock<std::mutex>
+AllocEngine::Allocator::lockSubnet(const SubnetPtr& subnet) {
+    std::unique_lock<std::mutex> lock(subnet->getAllocationMutex(),
+                                      std::try_to_lock);
+    if (!lock.owns_lock()) {
+        // Another thread allocates in the subnet: count it and wait.
+        StatsMgr::instance().addValue("allocation-lock-contention",
+                                      static_cast<int64_t>(1));
+        StatsMgr::instance().addValue(StatsMgr::generateName("subnet",
+                                                             subnet->getID(),
+                                                             "allocation-lock-contention"),
+                                      static_cast<int64_t>(1));
+        lock.lock();
+    }
+    return (lock);
+}
+
 AllocEngine::IterativeAllocator::IterativeAllocator(Lease::Type lease_type)
     : Allocator(lease_type) {
 }
@@ -287,6 +310,279 @@ AllocEngine::IterativeAllocator::pickAddressInternal(const SubnetPtr& subnet,
     return (last);
 }
 
+const uint64_t AllocEngine::FreeLeaseQueueAllocator::MAX_CAPACITY = 1 << 20;
+
+const int64_t AllocEngine::FreeLeaseQueueAllocator::REBUILD_INTERVAL = 60;
+
+AllocEngine::FreeLeaseQueueAllocator::FreeLeaseQueueAllocator(Lease::Type lease_type)
+    : IterativeAllocator(lease_type), queues_() {
+}
+
+isc::asiolink::IOAddress
+AllocEngine::FreeLeaseQueueAllocator::pickAddressInternal(const SubnetPtr& subnet,
+                                                          const ClientClasses& client_classes,
+                                                          const DuidPtr& duid,
+                                                          const IOAddress& hint) {
+    SubnetQueuePtr subnet_queue = getSubnetQueue(subnet);
+    if (!subnet_queue->queue_) {
+        return (IterativeAllocator::pickAddressInternal(subnet, client_classes,
+                                                        duid, hint));
+    }
+
+    IOAddress candidate = nextFreeAddress(subnet, subnet_queue->queue_,
+                                          client_classes);
+    if (candidate.isV4Zero() || candidate.isV6Zero()) {
+        // The leases freed outside of the allocation engine are recovered
+        // by rebuilding the queue. Limit the rate of the rebuilds because
+        // the pools may simply be exhausted.
+        if (time(NULL) - subnet_queue->built_ >= REBUILD_INTERVAL) {
+            buildSubnetQueue(subnet, *subnet_queue);
+            if (subnet_queue->queue_) {
+                candidate = nextFreeAddress(subnet, subnet_queue->queue_,
+                                            client_classes);
+            }
+        }
+    }
+    return (candidate);
+}
+
+AllocEngine::FreeLeaseQueueAllocator::SubnetQueuePtr
+AllocEngine::FreeLeaseQueueAllocator::getSubnetQueue(const SubnetPtr& subnet) {
+    // The map is shared by all subnets so it is locked only to find or
+    // insert the queue. A subnet replaced by a reconfiguration gets a new
+    // queue so the threads still using the old one are not disturbed.
+    SubnetQueuePtr subnet_queue;
+    {
+        std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+        if (MultiThreadingMgr::instance().getMode()) {
+            lock.lock();
+        }
+        auto it = queues_.find(subnet->getID());
+        if ((it != queues_.end()) && (it->second->subnet_.lock() == subnet)) {
+            return (it->second);
+        }
+        subnet_queue.reset(new SubnetQueue());
+        subnet_queue->subnet_ = subnet;
+        subnet_queue->built_ = 0;
+        if (it != queues_.end()) {
+            it->second = subnet_queue;
+        } else {
+            // Forget the subnets removed by reconfigurations.
+            for (auto q = queues_.begin(); q != queues_.end(); ) {
+                if (q->second->subnet_.expired()) {
+                    q = queues_.erase(q);
+                } else {
+                    ++q;
+                }
+            }
+            queues_.insert(std::make_pair(subnet->getID(), subnet_queue));
+        }
+    }
+    buildSubnetQueue(subnet, *subnet_queue);
+    return (subnet_queue);
+}
+
+void
+AllocEngine::FreeLeaseQueueAllocator::buildSubnetQueue(const SubnetPtr& subnet,
+                                                        SubnetQueue& subnet_queue) {
+    subnet_queue.subnet_ = subnet;
+    subnet_queue.queue_.reset();
+    subnet_queue.built_ = time(NULL);
+
+    uint64_t capacity = subnet->getPoolCapacity(pool_type_);
+    if (capacity > MAX_CAPACITY) {
+        LOG_WARN(alloc_engine_logger, ALLOC_ENGINE_FREE_LEASE_QUEUE_TOO_LARGE)
+            .arg(subnet->toText())
+            .arg(capacity)
+            .arg(MAX_CAPACITY);
+        return;
+    }
+
+    // Collect the leases in use.
+    std::set<IOAddress> used;
+    if (pool_type_ == Lease::TYPE_V4) {
+        Lease4Collection leases = LeaseMgrFactory::instance().getLeases4(subnet->getID());
+        for (auto lease : leases) {
+            if (!lease->expired()) {
+                used.insert(lease->addr_);
+            }
+        }
+    } else {
+        Lease6Collection leases = LeaseMgrFactory::instance().getLeases6(subnet->getID());
+        for (auto lease : leases) {
+            if ((lease->type_ == pool_type_) && !lease->expired()) {
+                used.insert(lease->addr_);
+            }
+        }
+    }
+
+    // Append the other addresses or prefixes of the pools.
+    FreeLeaseQueuePtr queue(new FreeLeaseQueue());
+    bool prefix = (pool_type_ == Lease::TYPE_PD);
+    uint64_t free_leases = 0;
+    try {
+        for (auto pool : subnet->getPools(pool_type_)) {
+            IOAddress first = pool->getFirstAddress();
+            IOAddress last = pool->getLastAddress();
+            uint8_t prefix_len = 128;
+            uint64_t range_index = 0;
+            if (prefix) {
+                Pool6Ptr pool6 = boost::dynamic_pointer_cast<Pool6>(pool);
+                if (!pool6) {
+                    isc_throw(Unexpected, "Wrong type of pool: "
+                              << pool->toText() << " is not Pool6");
+                }
+                // The last prefix of the pool.
+                prefix_len = pool6->getLength();
+                last = firstAddrInPrefix(last, prefix_len);
+                PrefixRange range(first, last, prefix_len);
+                queue->addRange(range);
+                range_index = queue->getRangeIndex(range);
+            } else {
+                AddressRange range(first, last);
+                queue->addRange(range);
+                range_index = queue->getRangeIndex(range);
+            }
+            for (IOAddress address = first; ;
+                 address = increaseAddress(address, prefix, prefix_len)) {
+                if (used.count(address) == 0) {
+                    queue->append(range_index, address);
+                    ++free_leases;
+                }
+                if (address == last) {
+                    break;
+                }
+            }
+        }
+    } catch (const std::exception& ex) {
+        LOG_ERROR(alloc_engine_logger, ALLOC_ENGINE_FREE_LEASE_QUEUE_FAILED)
+            .arg(subnet->toText())
+            .arg(ex.what());
+        return;
+    }
+
+    subnet_queue.queue_ = queue;
+    LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+              ALLOC_ENGINE_FREE_LEASE_QUEUE_BUILT)
+        .arg(subnet->toText())
+        .arg(free_leases)
+        .arg(capacity);
+}
+
+isc::asiolink::IOAddress
+AllocEngine::FreeLeaseQueueAllocator::nextFreeAddress(const SubnetPtr& subnet,
+                                                      const FreeLeaseQueuePtr& queue,
+                                                      const ClientClasses& client_classes) const {
+    for (auto pool : subnet->getPools(pool_type_)) {
+        if (!pool->clientSupported(client_classes)) {
+            continue;
+        }
+        IOAddress candidate = pool->getFirstAddress();
+        if (pool_type_ == Lease::TYPE_PD) {
+            Pool6Ptr pool6 = boost::dynamic_pointer_cast<Pool6>(pool);
+            if (!pool6) {
+                continue;
+            }
+            candidate = queue->next(PrefixRange(pool6->getFirstAddress(),
+                                                firstAddrInPrefix(pool6->getLastAddress(),
+                                                                  pool6->getLength()),
+                                                pool6->getLength()));
+        } else {
+            candidate = queue->next(AddressRange(pool->getFirstAddress(),
+                                                 pool->getLastAddress()));
+        }
+        if (!candidate.isV4Zero() && !candidate.isV6Zero()) {
+            return (candidate);
+        }
+    }
+    return (pool_type_ == Lease::TYPE_V4 ? IOAddress::IPV4_ZERO_ADDRESS() :
+            IOAddress::IPV6_ZERO_ADDRESS());
+}
+
+void
+AllocEngine::FreeLeaseQueueAllocator::leaseUsed(const SubnetID& subnet_id,
+                                                const IOAddress& address) {
+    update(subnet_id, address, false);
+}
+
+void
+AllocEngine::FreeLeaseQueueAllocator::leaseFreed(const SubnetID& subnet_id,
+                                                 const IOAddress& address) {
+    update(subnet_id, address, true);
+}
+
+void
+AllocEngine::FreeLeaseQueueAllocator::update(const SubnetID& subnet_id,
+                                             const IOAddress& address,
+                                             const bool free) {
+    // The queue is built when the first address is picked in the subnet
+    // and it is up to date with the lease database at that time.
+    SubnetQueuePtr subnet_queue;
+    SubnetPtr subnet;
+    if (MultiThreadingMgr::instance().getMode()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = queues_.find(subnet_id);
+            if (it == queues_.end()) {
+                return;
+            }
+            subnet_queue = it->second;
+        }
+        subnet = subnet_queue->subnet_.lock();
+        if (!subnet) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(lockSubnet(subnet));
+        updateInternal(subnet, subnet_queue->queue_, address, free);
+    } else {
+        auto it = queues_.find(subnet_id);
+        if (it == queues_.end()) {
+            return;
+        }
+        subnet = it->second->subnet_.lock();
+        if (!subnet) {
+            return;
+        }
+        updateInternal(subnet, it->second->queue_, address, free);
+    }
+}
+
+void
+AllocEngine::FreeLeaseQueueAllocator::updateInternal(const SubnetPtr& subnet,
+                                                     const FreeLeaseQueuePtr& queue,
+                                                     const IOAddress& address,
+                                                     const bool free) {
+    if (!queue) {
+        return;
+    }
+    PoolPtr pool = subnet->getPool(pool_type_, address, false);
+    if (!pool) {
+        return;
+    }
+    if (pool_type_ == Lease::TYPE_PD) {
+        Pool6Ptr pool6 = boost::dynamic_pointer_cast<Pool6>(pool);
+        if (!pool6) {
+            return;
+        }
+        PrefixRange range(pool6->getFirstAddress(),
+                          firstAddrInPrefix(pool6->getLastAddress(),
+                                            pool6->getLength()),
+                          pool6->getLength());
+        if (free) {
+            queue->append(range, address);
+        } else {
+            static_cast<void>(queue->use(range, address));
+        }
+    } else {
+        AddressRange range(pool->getFirstAddress(), pool->getLastAddress());
+        if (free) {
+            queue->append(range, address);
+        } else {
+            static_cast<void>(queue->use(range, address));
+        }
+    }
+}
+
 AllocEngine::HashedAllocator::HashedAllocator(Lease::Type lease_type)
     : Allocator(lease_type) {
     isc_throw(NotImplemented, "Hashed allocator is not implemented");
@@ -301,16 +597,73 @@ AllocEngine::HashedAllocator::pickAddressInternal(const SubnetPtr&,
 }
 
 AllocEngine::RandomAllocator::RandomAllocator(Lease::Type lease_type)
-    : Allocator(lease_type) {
-    isc_throw(NotImplemented, "Random allocator is not implemented");
+    : Allocator(lease_type), generator_() {
+    std::random_device rd;
+    generator_.seed(rd());
 }
 
 isc::asiolink::IOAddress
-AllocEngine::RandomAllocator::pickAddressInternal(const SubnetPtr&,
-                                                  const ClientClasses&,
+AllocEngine::RandomAllocator::pickAddressInternal(const SubnetPtr& subnet,
+                                                  const ClientClasses& client_classes,
                                                   const DuidPtr&,
                                                   const IOAddress&) {
-    isc_throw(NotImplemented, "Random allocator is not implemented");
+    const PoolCollection& pools = subnet->getPools(pool_type_);
+
+    if (pools.empty()) {
+        isc_throw(AllocFailed, "No pools defined in selected subnet");
+    }
+
+    // Collect the pools allowed for the client and, among them, the pools
+    // which still have addresses or prefixes to walk over. The permutations
+    // are created when the pools are used for the first time.
+    std::vector<PoolPtr> allowed;
+    std::vector<PoolPtr> available;
+    for (auto pool : pools) {
+        if (!pool->clientSupported(client_classes)) {
+            continue;
+        }
+        allowed.push_back(pool);
+        if (!pool->getPermutation()) {
+            pool->resetPermutation();
+        }
+        if (!pool->getPermutation()->exhausted()) {
+            available.push_back(pool);
+        }
+    }
+
+    if (allowed.empty()) {
+        isc_throw(AllocFailed, "No allowed pools defined in selected subnet");
+    }
+
+    // All allowed pools have been walked over. Start new permutations so
+    // the addresses or prefixes released in the meantime are offered again.
+    if (available.empty()) {
+        for (auto pool : allowed) {
+            pool->resetPermutation();
+        }
+        available.swap(allowed);
+    }
+
+    // Select a random pool and return the next candidate from it.
+    bool done = false;
+    return (selectPool(available)->getPermutation()->next(done));
+}
+
+PoolPtr
+AllocEngine::RandomAllocator::selectPool(const std::vector<PoolPtr>& pools) {
+    // The pool permutations are protected by the subnet lock but the
+    // generator is shared by all subnets. It is only used when there is
+    // a choice.
+    if (pools.size() == 1) {
+        return (pools.front());
+    }
+    std::uniform_int_distribution<size_t> dist(0, pools.size() - 1);
+    if (MultiThreadingMgr::instance().getMode()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return (pools[dist(generator_)]);
+    } else {
+        return (pools[dist(generator_)]);
+    }
 }
 
 AllocEngine::AllocEngine(AllocType engine_type, uint64_t attempts,
@@ -357,6 +710,26 @@ AllocEngine::AllocEngine(AllocType engine_type, uint64_t attempts,
         }
     }
 
+    // Initialize the free lease queue allocators which can be selected
+    // for each subnet.
+    queue_allocators_[basic_type] = AllocatorPtr(new FreeLeaseQueueAllocator(basic_type));
+    if (ipv6) {
+        queue_allocators_[Lease::TYPE_TA] =
+            AllocatorPtr(new FreeLeaseQueueAllocator(Lease::TYPE_TA));
+        queue_allocators_[Lease::TYPE_PD] =
+            AllocatorPtr(new FreeLeaseQueueAllocator(Lease::TYPE_PD));
+    }
+
+    // Initialize the random allocators which can be selected for each
+    // subnet.
+    random_allocators_[basic_type] = AllocatorPtr(new RandomAllocator(basic_type));
+    if (ipv6) {
+        random_allocators_[Lease::TYPE_TA] =
+            AllocatorPtr(new RandomAllocator(Lease::TYPE_TA));
+        random_allocators_[Lease::TYPE_PD] =
+            AllocatorPtr(new RandomAllocator(Lease::TYPE_PD));
+    }
+
     // Register hook points
     hook_index_lease4_select_ = Hooks.hook_index_lease4_select_;
     hook_index_lease6_select_ = Hooks.hook_index_lease6_select_;
@@ -372,6 +745,41 @@ AllocEngine::AllocatorPtr AllocEngine::getAllocator(Lease::Type type) {
     return (alloc->second);
 }
 
+AllocEngine::AllocatorPtr
+AllocEngine::getAllocator(Lease::Type type, const SubnetPtr& subnet) {
+    if (subnet) {
+        std::string allocator = subnet->getAllocatorType().get();
+        if (allocator == "free-lease-queue") {
+            auto alloc = queue_allocators_.find(type);
+            if (alloc != queue_allocators_.end()) {
+                return (alloc->second);
+            }
+        } else if (allocator == "random") {
+            auto alloc = random_allocators_.find(type);
+            if (alloc != random_allocators_.end()) {
+                return (alloc->second);
+            }
+        }
+    }
+    return (getAllocator(type));
+}
+
+void
+AllocEngine::leaseFreed(const LeasePtr& lease) {
+    if (!lease) {
+        return;
+    }
+    Lease::Type type = Lease::TYPE_V4;
+    Lease6Ptr lease6 = boost::dynamic_pointer_cast<Lease6>(lease);
+    if (lease6) {
+        type = lease6->type_;
+    }
+    auto alloc = queue_allocators_.find(type);
+    if (alloc != queue_allocators_.end()) {
+        alloc->second->leaseFreed(lease->subnet_id_, lease->addr_);
+    }
+}
+
 } // end of namespace isc::dhcp
 } // end of namespace isc
 
@@ -1038,6 +1446,9 @@ AllocEngine::allocateUnreservedLeases6(ClientContext6& ctx) {
             continue;
         }
 
+        // The allocator may be configured for the subnet.
+        allocator = getAllocator(ctx.currentIA().type_, subnet);
+
         // The hint was useless (it was not provided at all, was used by someone else,
         // was out of pool or reserved for someone else). Search the pool until first
         // of the following occurs:
@@ -1070,6 +1481,12 @@ AllocEngine::allocateUnreservedLeases6(ClientContext6& ctx) {
                                                          ctx.query_->getClasses(),
                                                          ctx.duid_,
                                                          hint);
+            // The free lease queue allocator returns the zero address when
+            // there are no free leases in the subnet.
+            if (candidate.isV6Zero()) {
+                break;
+            }
+
             // The first step is to find out prefix length. It is 128 for
             // non-PD leases.
             uint8_t prefix_len = 128;
@@ -1123,6 +1540,10 @@ AllocEngine::allocateUnreservedLeases6(ClientContext6& ctx) {
                 ctx.subnet_ = subnet;
                 Lease6Ptr lease = createLease6(ctx, candidate, prefix_len, callout_status);
                 if (lease) {
+                    if (!ctx.fake_allocation_) {
+                        allocator->leaseUsed(subnet->getID(), candidate);
+                    }
+
                     // We are allocating a new lease (not renewing). So, the
                     // old lease should be NULL.
                     ctx.currentIA().old_leases_.clear();
@@ -1157,9 +1578,16 @@ AllocEngine::allocateUnreservedLeases6(ClientContext6& ctx) {
                 ctx.subnet_ = subnet;
                 existing = reuseExpiredLease(existing, ctx, prefix_len,
                                              callout_status);
+                if (!ctx.fake_allocation_) {
+                    allocator->leaseUsed(subnet->getID(), candidate);
+                }
 
                 leases.push_back(existing);
                 return (leases);
+
+            } else {
+                // The lease is in use so don't pick it again.
+                allocator->leaseUsed(subnet->getID(), candidate);
             }
         }
     }
@@ -2358,25 +2786,23 @@ AllocEngine::reclaimExpiredLeases6(const size_t max_leases, const uint16_t timeo
     }
 
     size_t leases_processed = 0;
-    BOOST_FOREACH(Lease6Ptr lease, leases) {
-
-        try {
-            // Reclaim the lease.
-            if (MultiThreadingMgr::instance().getMode()) {
-                // The reclamation is exclusive of packet processing.
-                WriteLockGuard exclusive(rw_mutex_);
-
-                reclaimExpiredLease(lease, remove_lease, callout_handle);
-                ++leases_processed;
-            } else {
-                reclaimExpiredLease(lease, remove_lease, callout_handle);
-                ++leases_processed;
-            }
-
-        } catch (const std::exception& ex) {
-            LOG_ERROR(alloc_engine_logger, ALLOC_ENGINE_V6_LEASE_RECLAMATION_FAILED)
-                .arg(lease->addr_.toText())
-                .arg(ex.what());
+    for (auto lease = leases.begin(); lease != leases.end(); ) {
+
+        // Reclaim the leases in batches, each updating the lease database
+        // once.
+        if (MultiThreadingMgr::instance().getMode()) {
+            // The reclamation is exclusive of packet processing.
+            WriteLockGuard exclusive(rw_mutex_);
+
+            leases_processed +=
+                reclaimExpiredLeasesBatch(lease, leases.end(), remove_lease,
+                                          callout_handle, stopwatch, timeout,
+                                          ALLOC_ENGINE_V6_LEASE_RECLAMATION_FAILED);
+        } else {
+            leases_processed +=
+                reclaimExpiredLeasesBatch(lease, leases.end(), remove_lease,
+                                          callout_handle, stopwatch, timeout,
+                                          ALLOC_ENGINE_V6_LEASE_RECLAMATION_FAILED);
         }
 
         // Check if we have hit the timeout for running reclamation routine and
@@ -2504,25 +2930,23 @@ AllocEngine::reclaimExpiredLeases4(const size_t max_leases, const uint16_t timeo
     }
 
     size_t leases_processed = 0;
-    BOOST_FOREACH(Lease4Ptr lease, leases) {
-
-        try {
-            // Reclaim the lease.
-            if (MultiThreadingMgr::instance().getMode()) {
-                // The reclamation is exclusive of packet processing.
-                WriteLockGuard exclusive(rw_mutex_);
-
-                reclaimExpiredLease(lease, remove_lease, callout_handle);
-                ++leases_processed;
-            } else {
-                reclaimExpiredLease(lease, remove_lease, callout_handle);
-                ++leases_processed;
-            }
-
-        } catch (const std::exception& ex) {
-            LOG_ERROR(alloc_engine_logger, ALLOC_ENGINE_V4_LEASE_RECLAMATION_FAILED)
-                .arg(lease->addr_.toText())
-                .arg(ex.what());
+    for (auto lease = leases.begin(); lease != leases.end(); ) {
+
+        // Reclaim the leases in batches, each updating the lease database
+        // once.
+        if (MultiThreadingMgr::instance().getMode()) {
+            // The reclamation is exclusive of packet processing.
+            WriteLockGuard exclusive(rw_mutex_);
+
+            leases_processed +=
+                reclaimExpiredLeasesBatch(lease, leases.end(), remove_lease,
+                                          callout_handle, stopwatch, timeout,
+                                          ALLOC_ENGINE_V4_LEASE_RECLAMATION_FAILED);
+        } else {
+            leases_processed +=
+                reclaimExpiredLeasesBatch(lease, leases.end(), remove_lease,
+                                          callout_handle, stopwatch, timeout,
+                                          ALLOC_ENGINE_V4_LEASE_RECLAMATION_FAILED);
         }
 
         // Check if we have hit the timeout for running reclamation routine and
@@ -2577,12 +3001,75 @@ AllocEngine::reclaimExpiredLeases4(const size_t max_leases, const uint16_t timeo
     }
 }
 
-template<typename LeasePtrType>
-void
-AllocEngine::reclaimExpiredLease(const LeasePtrType& lease, const bool remove_lease,
-                                 const CalloutHandlePtr& callout_handle) {
-    reclaimExpiredLease(lease, remove_lease ? DB_RECLAIM_REMOVE : DB_RECLAIM_UPDATE,
-                        callout_handle);
+template<typename LeaseIterator>
+size_t
+AllocEngine::reclaimExpiredLeasesBatch(LeaseIterator& lease,
+                                       const LeaseIterator& end,
+                                       const bool remove_lease,
+                                       const CalloutHandlePtr& callout_handle,
+                                       const util::Stopwatch& stopwatch,
+                                       const uint16_t timeout,
+                                       const isc::log::MessageID& failed_message) {
+    typedef typename std::iterator_traits<LeaseIterator>::value_type LeasePtrType;
+
+    const DbReclaimMode reclaim_mode = remove_lease ? DB_RECLAIM_REMOVE :
+        DB_RECLAIM_UPDATE;
+
+    std::vector<LeaseChange<LeasePtrType> > changes;
+    std::vector<LeasePtrType> reclaimed;
+
+    for (size_t count = 0; (lease != end) && (count < RECLAIM_BATCH_SIZE); ++count) {
+        LeasePtrType current = *lease;
+        ++lease;
+
+        try {
+            bool remove_current = remove_lease;
+            if (reclaimExpiredLeaseStart(current, reclaim_mode, callout_handle,
+                                         remove_current)) {
+                changes.push_back(reclaimLeaseChange(current, remove_current));
+            } else {
+                // The callouts have reclaimed the lease.
+                reclaimed.push_back(current);
+            }
+
+        } catch (const std::exception& ex) {
+            LOG_ERROR(alloc_engine_logger, failed_message)
+                .arg(current->addr_.toText())
+                .arg(ex.what());
+        }
+
+        // Leave the rest of the leases to the caller on timeout.
+        if ((timeout > 0) && (stopwatch.getTotalMilliseconds() >= timeout)) {
+            break;
+        }
+    }
+
+    // Reclaim the leases in the lease database.
+    if (!changes.empty()) {
+        LeaseMgrFactory::instance().applyLeaseChanges(changes);
+    }
+
+    for (auto const& change : changes) {
+        if (!change.error_.empty()) {
+            LOG_ERROR(alloc_engine_logger, failed_message)
+                .arg(change.lease_->addr_.toText())
+                .arg(change.error_);
+            continue;
+        }
+
+        // Lease has been reclaimed.
+        LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+                  ALLOC_ENGINE_LEASE_RECLAIMED)
+            .arg(change.lease_->addr_.toText());
+
+        reclaimed.push_back(change.lease_);
+    }
+
+    for (auto const& reclaimed_lease : reclaimed) {
+        reclaimExpiredLeaseFinish(reclaimed_lease);
+    }
+
+    return (reclaimed.size());
 }
 
 template<typename LeasePtrType>
@@ -2601,6 +3088,31 @@ void
 AllocEngine::reclaimExpiredLease(const Lease6Ptr& lease,
                                  const DbReclaimMode& reclaim_mode,
                                  const CalloutHandlePtr& callout_handle) {
+    bool remove_lease = false;
+    if (reclaimExpiredLeaseStart(lease, reclaim_mode, callout_handle, remove_lease) &&
+        (reclaim_mode != DB_RECLAIM_LEAVE_UNCHANGED)) {
+        // Reclaim the lease - depending on the configuration, set the
+        // expired-reclaimed state or simply remove it.
+        LeaseChange6Collection changes(1, reclaimLeaseChange(lease, remove_lease));
+        LeaseMgrFactory::instance().applyLeaseChanges(changes);
+        if (!changes[0].error_.empty()) {
+            isc_throw(isc::db::DbOperationError, changes[0].error_);
+        }
+
+        // Lease has been reclaimed.
+        LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+                  ALLOC_ENGINE_LEASE_RECLAIMED)
+            .arg(lease->addr_.toText());
+    }
+
+    reclaimExpiredLeaseFinish(lease);
+}
+
+bool
+AllocEngine::reclaimExpiredLeaseStart(const Lease6Ptr& lease,
+                                      const DbReclaimMode& reclaim_mode,
+                                      const CalloutHandlePtr& callout_handle,
+                                      bool& remove_lease) {
 
     LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
               ALLOC_ENGINE_V6_LEASE_RECLAIM)
@@ -2634,38 +3146,38 @@ AllocEngine::reclaimExpiredLease(const Lease6Ptr& lease,
     /// DROP status does not make sense here.
     /// Not sure if we need to support every possible status everywhere.
 
-    if (!skipped) {
-
-        // Generate removal name change request for D2, if required.
-        // This will return immediately if the DNS wasn't updated
-        // when the lease was created.
-        queueNCR(CHG_REMOVE, lease);
+    if (skipped) {
+        return (false);
+    }
 
-        // Let's check if the lease that just expired is in DECLINED state.
-        // If it is, we need to perform a couple extra steps.
-        bool remove_lease = (reclaim_mode == DB_RECLAIM_REMOVE);
-        if (lease->state_ == Lease::STATE_DECLINED) {
-            // Do extra steps required for declined lease reclamation:
-            // - call the recover hook
-            // - bump decline-related stats
-            // - log separate message
-            // There's no point in keeping a declined lease after its
-            // reclamation. A declined lease doesn't have any client
-            // identifying information anymore.  So we'll flag it for
-            // removal unless the hook has set the skip flag.
-            remove_lease = reclaimDeclined(lease);
-        }
+    // Generate removal name change request for D2, if required.
+    // This will return immediately if the DNS wasn't updated
+    // when the lease was created.
+    queueNCR(CHG_REMOVE, lease);
 
-        if (reclaim_mode != DB_RECLAIM_LEAVE_UNCHANGED) {
-            // Reclaim the lease - depending on the configuration, set the
-            // expired-reclaimed state or simply remove it.
-            LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
-            reclaimLeaseInDatabase<Lease6Ptr>(lease, remove_lease,
-                                              std::bind(&LeaseMgr::updateLease6,
-                                                        &lease_mgr, ph::_1));
-        }
+    // Let's check if the lease that just expired is in DECLINED state.
+    // If it is, we need to perform a couple extra steps.
+    remove_lease = (reclaim_mode == DB_RECLAIM_REMOVE);
+    if (lease->state_ == Lease::STATE_DECLINED) {
+        // Do extra steps required for declined lease reclamation:
+        // - call the recover hook
+        // - bump decline-related stats
+        // - log separate message
+        // There's no point in keeping a declined lease after its
+        // reclamation. A declined lease doesn't have any client
+        // identifying information anymore.  So we'll flag it for
+        // removal unless the hook has set the skip flag.
+        remove_lease = reclaimDeclined(lease);
     }
 
+    return (true);
+}
+
+void
+AllocEngine::reclaimExpiredLeaseFinish(const Lease6Ptr& lease) {
+    // The lease can be allocated again.
+    leaseFreed(lease);
+
     // Update statistics.
 
     // Decrease number of assigned leases.
@@ -2699,6 +3211,31 @@ void
 AllocEngine::reclaimExpiredLease(const Lease4Ptr& lease,
                                  const DbReclaimMode& reclaim_mode,
                                  const CalloutHandlePtr& callout_handle) {
+    bool remove_lease = false;
+    if (reclaimExpiredLeaseStart(lease, reclaim_mode, callout_handle, remove_lease) &&
+        (reclaim_mode != DB_RECLAIM_LEAVE_UNCHANGED)) {
+        // Reclaim the lease - depending on the configuration, set the
+        // expired-reclaimed state or simply remove it.
+        LeaseChange4Collection changes(1, reclaimLeaseChange(lease, remove_lease));
+        LeaseMgrFactory::instance().applyLeaseChanges(changes);
+        if (!changes[0].error_.empty()) {
+            isc_throw(isc::db::DbOperationError, changes[0].error_);
+        }
+
+        // Lease has been reclaimed.
+        LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+                  ALLOC_ENGINE_LEASE_RECLAIMED)
+            .arg(lease->addr_.toText());
+    }
+
+    reclaimExpiredLeaseFinish(lease);
+}
+
+bool
+AllocEngine::reclaimExpiredLeaseStart(const Lease4Ptr& lease,
+                                      const DbReclaimMode& reclaim_mode,
+                                      const CalloutHandlePtr& callout_handle,
+                                      bool& remove_lease) {
 
     LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
               ALLOC_ENGINE_V4_LEASE_RECLAIM)
@@ -2730,42 +3267,42 @@ AllocEngine::reclaimExpiredLease(const Lease4Ptr& lease,
     /// DROP status does not make sense here.
     /// Not sure if we need to support every possible status everywhere.
 
-    if (!skipped) {
+    if (skipped) {
+        return (false);
+    }
 
-        // Generate removal name change request for D2, if required.
-        // This will return immediately if the DNS wasn't updated
-        // when the lease was created.
-        queueNCR(CHG_REMOVE, lease);
-        // Clear DNS fields so we avoid redundant removes.
-        lease->hostname_.clear();
-        lease->fqdn_fwd_ = false;
-        lease->fqdn_rev_ = false;
-
-        // Let's check if the lease that just expired is in DECLINED state.
-        // If it is, we need to perform a couple extra steps.
-        bool remove_lease = (reclaim_mode == DB_RECLAIM_REMOVE);
-        if (lease->state_ == Lease::STATE_DECLINED) {
-            // Do extra steps required for declined lease reclamation:
-            // - call the recover hook
-            // - bump decline-related stats
-            // - log separate message
-            // There's no point in keeping a declined lease after its
-            // reclamation. A declined lease doesn't have any client
-            // identifying information anymore.  So we'll flag it for
-            // removal unless the hook has set the skip flag.
-            remove_lease = reclaimDeclined(lease);
-        }
-
-        if (reclaim_mode != DB_RECLAIM_LEAVE_UNCHANGED) {
-            // Reclaim the lease - depending on the configuration, set the
-            // expired-reclaimed state or simply remove it.
-            LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
-            reclaimLeaseInDatabase<Lease4Ptr>(lease, remove_lease,
-                                              std::bind(&LeaseMgr::updateLease4,
-                                                        &lease_mgr, ph::_1));
-        }
+    // Generate removal name change request for D2, if required.
+    // This will return immediately if the DNS wasn't updated
+    // when the lease was created.
+    queueNCR(CHG_REMOVE, lease);
+    // Clear DNS fields so we avoid redundant removes.
+    lease->hostname_.clear();
+    lease->fqdn_fwd_ = false;
+    lease->fqdn_rev_ = false;
+
+    // Let's check if the lease that just expired is in DECLINED state.
+    // If it is, we need to perform a couple extra steps.
+    remove_lease = (reclaim_mode == DB_RECLAIM_REMOVE);
+    if (lease->state_ == Lease::STATE_DECLINED) {
+        // Do extra steps required for declined lease reclamation:
+        // - call the recover hook
+        // - bump decline-related stats
+        // - log separate message
+        // There's no point in keeping a declined lease after its
+        // reclamation. A declined lease doesn't have any client
+        // identifying information anymore.  So we'll flag it for
+        // removal unless the hook has set the skip flag.
+        remove_lease = reclaimDeclined(lease);
     }
 
+    return (true);
+}
+
+void
+AllocEngine::reclaimExpiredLeaseFinish(const Lease4Ptr& lease) {
+    // The lease can be allocated again.
+    leaseFreed(lease);
+
     // Update statistics.
 
     // Decrease number of assigned addresses.
@@ -2916,34 +3453,24 @@ AllocEngine::reclaimDeclined(const Lease6Ptr& lease) {
 }
 
 template<typename LeasePtrType>
-void AllocEngine::reclaimLeaseInDatabase(const LeasePtrType& lease,
-                                         const bool remove_lease,
-                                         const std::function<void (const LeasePtrType&)>&
-                                         lease_update_fun) const {
+LeaseChange<LeasePtrType>
+AllocEngine::reclaimLeaseChange(const LeasePtrType& lease,
+                                const bool remove_lease) const {
+    typedef LeaseChange<LeasePtrType> LeaseChangeType;
 
-    LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
-
-    // Reclaim the lease - depending on the configuration, set the
-    // expired-reclaimed state or simply remove it.
+    // Depending on the configuration, set the expired-reclaimed state or
+    // simply remove the lease.
     if (remove_lease) {
-        lease_mgr.deleteLease(lease);
-    } else if (lease_update_fun) {
-        // Clear FQDN information as we have already sent the
-        // name change request to remove the DNS record.
-        lease->hostname_.clear();
-        lease->fqdn_fwd_ = false;
-        lease->fqdn_rev_ = false;
-        lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
-        lease_update_fun(lease);
-
-    } else {
-        return;
+        return (LeaseChangeType(LeaseChangeType::DELETE, lease));
     }
 
-    // Lease has been reclaimed.
-    LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
-              ALLOC_ENGINE_LEASE_RECLAIMED)
-        .arg(lease->addr_.toText());
+    // Clear FQDN information as we have already sent the
+    // name change request to remove the DNS record.
+    lease->hostname_.clear();
+    lease->fqdn_fwd_ = false;
+    lease->fqdn_rev_ = false;
+    lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+    return (LeaseChangeType(LeaseChangeType::UPDATE, lease));
 }
 
 }  // namespace dhcp
@@ -4137,6 +4664,9 @@ AllocEngine::allocateUnreservedLease4(ClientContext4& ctx) {
     uint64_t total_attempts = 0;
     while (subnet) {
 
+        // The allocator may be configured for the subnet.
+        allocator = getAllocator(Lease::TYPE_V4, subnet);
+
         ClientIdPtr client_id;
         if (subnet->getMatchClientId()) {
             client_id = ctx.clientid_;
@@ -4161,6 +4691,12 @@ AllocEngine::allocateUnreservedLease4(ClientContext4& ctx) {
                                                          ctx.query_->getClasses(),
                                                          client_id,
                                                          ctx.requested_address_);
+            // The free lease queue allocator returns the zero address when
+            // there are no free leases in the subnet.
+            if (candidate.isV4Zero()) {
+                break;
+            }
+
             // First check for reservation when it is the choice.
             if (check_reservation_first && addressReserved(candidate, ctx)) {
                 // Don't allocate.
@@ -4190,11 +4726,17 @@ AllocEngine::allocateUnreservedLease4(ClientContext4& ctx) {
                     (check_reservation_first || !addressReserved(candidate, ctx))) {
                     ctx.old_lease_ = Lease4Ptr(new Lease4(*exist_lease));
                     new_lease = reuseExpiredLease4(exist_lease, ctx, callout_status);
+                } else if (!exist_lease->expired()) {
+                    // The lease is in use so don't pick it again.
+                    allocator->leaseUsed(subnet->getID(), candidate);
                 }
             }
 
             // We found a lease we can use, return it.
             if (new_lease) {
+                if (!ctx.fake_allocation_) {
+                    allocator->leaseUsed(subnet->getID(), candidate);
+                }
                 return (new_lease);
             }
 
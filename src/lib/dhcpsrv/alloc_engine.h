@@ -17,21 +17,26 @@
 #include <dhcp/option6_iaaddr.h>
 #include <dhcp/option6_iaprefix.h>
 #include <dhcpsrv/d2_client_cfg.h>
+#include <dhcpsrv/free_lease_queue.h>
 #include <dhcpsrv/host.h>
 #include <dhcpsrv/subnet.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <dhcpsrv/srv_config.h>
 #include <hooks/callout_handle.h>
+#include <log/message_types.h>
 #include <util/multi_threading_mgr.h>
 #include <util/readwrite_mutex.h>
+#include <util/stopwatch.h>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/weak_ptr.hpp>
 
 #include <functional>
 #include <list>
 #include <map>
 #include <mutex>
+#include <random>
 #include <set>
 #include <utility>
 
@@ -88,6 +93,10 @@ protected:
         ///
         /// Pools which are not allowed for client classes are skipped.
         ///
+        /// In multi-threading mode the allocation state of the subnet is
+        /// locked while the address is picked, so the allocations in
+        /// different subnets run in parallel.
+        ///
         /// @param subnet next address will be returned from pool of that subnet
         /// @param client_classes list of classes client belongs to
         /// @param duid Client's DUID
@@ -100,13 +109,40 @@ protected:
                     const DuidPtr& duid,
                     const isc::asiolink::IOAddress& hint) {
             if (isc::util::MultiThreadingMgr::instance().getMode()) {
-                std::lock_guard<std::mutex> lock(mutex_);
+                std::unique_lock<std::mutex> lock(lockSubnet(subnet));
                 return pickAddressInternal(subnet, client_classes, duid, hint);
             } else {
                 return pickAddressInternal(subnet, client_classes, duid, hint);
             }
         }
 
+        /// @brief Indicates that an address or prefix is in use.
+        ///
+        /// The allocation engine calls this method when it allocated a picked
+        /// address or prefix, or found it leased. This implementation does
+        /// nothing.
+        ///
+        /// @param subnet_id identifier of the subnet the lease belongs to
+        /// @param address the leased address or prefix
+        virtual void leaseUsed(const SubnetID& subnet_id,
+                               const isc::asiolink::IOAddress& address) {
+            static_cast<void>(subnet_id);
+            static_cast<void>(address);
+        }
+
+        /// @brief Indicates that an address or prefix is no longer in use.
+        ///
+        /// The allocation engine calls this method when a lease was reclaimed
+        /// or released. This implementation does nothing.
+        ///
+        /// @param subnet_id identifier of the subnet the lease belonged to
+        /// @param address the freed address or prefix
+        virtual void leaseFreed(const SubnetID& subnet_id,
+                                const isc::asiolink::IOAddress& address) {
+            static_cast<void>(subnet_id);
+            static_cast<void>(address);
+        }
+
         /// @brief Default constructor
         ///
         /// Specifies which type of leases this allocator will assign
@@ -127,13 +163,18 @@ protected:
 
     protected:
 
+        /// @brief Locks the allocation state of a subnet.
+        ///
+        /// When the lock is held by another thread the global and the subnet
+        /// "allocation-lock-contention" statistics are incremented before
+        /// waiting for it.
+        ///
+        /// @param subnet the subnet
+        /// @return the lock owning the allocation mutex of the subnet
+        static std::unique_lock<std::mutex> lockSubnet(const SubnetPtr& subnet);
+
         /// @brief Defines pool type allocation
         Lease::Type pool_type_;
-
-    private:
-
-        /// @brief The mutex to protect the allocated lease
-        std::mutex mutex_;
     };
 
     /// defines a pointer to allocator
@@ -154,7 +195,7 @@ protected:
         /// @param type - specifies allocation type
         IterativeAllocator(Lease::Type type);
 
-    private:
+    protected:
 
         /// @brief Returns the next address from pools in a subnet
         ///
@@ -202,6 +243,149 @@ protected:
                         bool prefix, const uint8_t prefix_len);
     };
 
+    /// @brief Address/prefix allocator picking free leases from queues
+    ///
+    /// This allocator keeps a @c FreeLeaseQueue per subnet, holding the
+    /// addresses or prefixes of the subnet pools which are not leased. The
+    /// queue is populated from the lease database when the first address is
+    /// picked in the subnet, and again when a reconfiguration replaced the
+    /// subnet. The allocation engine keeps it in sync: it removes the picked
+    /// leases it allocates or finds in use, and it returns the reclaimed and
+    /// released leases. The picked address is therefore almost always free,
+    /// regardless of the pool utilization, instead of requiring a lease
+    /// database lookup for each of many candidates when the pools are nearly
+    /// exhausted.
+    ///
+    /// When the queues of all pools allowed for the client are empty the zero
+    /// address is returned to indicate that there are no free leases in the
+    /// subnet. The queues are then rebuilt from the lease database, at most
+    /// once per @c REBUILD_INTERVAL seconds, to recover the leases freed
+    /// outside of the allocation engine, e.g. deleted with the lease commands.
+    ///
+    /// The subnets with pools holding more than @c MAX_CAPACITY leases in
+    /// total are handled by the iterative allocator.
+    class FreeLeaseQueueAllocator : public IterativeAllocator {
+    public:
+
+        /// @brief Maximum number of leases in the pools of a subnet.
+        static const uint64_t MAX_CAPACITY;
+
+        /// @brief Minimum time in seconds between two rebuilds of the
+        /// queue of a subnet.
+        static const int64_t REBUILD_INTERVAL;
+
+        /// @brief Default constructor
+        ///
+        /// @param type - specifies allocation type
+        FreeLeaseQueueAllocator(Lease::Type type);
+
+        /// @brief Removes an address or prefix from the queue of its subnet.
+        ///
+        /// @param subnet_id identifier of the subnet the lease belongs to
+        /// @param address the leased address or prefix
+        virtual void leaseUsed(const SubnetID& subnet_id,
+                               const isc::asiolink::IOAddress& address);
+
+        /// @brief Appends an address or prefix to the queue of its subnet.
+        ///
+        /// @param subnet_id identifier of the subnet the lease belonged to
+        /// @param address the freed address or prefix
+        virtual void leaseFreed(const SubnetID& subnet_id,
+                                const isc::asiolink::IOAddress& address);
+
+    private:
+
+        /// @brief Returns the next free address from pools in a subnet
+        ///
+        /// @param subnet next address will be returned from pool of that subnet
+        /// @param client_classes list of classes client belongs to
+        /// @param duid Client's DUID (ignored)
+        /// @param hint Client's hint (ignored)
+        ///
+        /// @return the next free address or the zero address when there
+        /// are no free leases in the allowed pools of the subnet
+        virtual isc::asiolink::IOAddress
+        pickAddressInternal(const SubnetPtr& subnet,
+                            const ClientClasses& client_classes,
+                            const DuidPtr& duid,
+                            const isc::asiolink::IOAddress& hint);
+
+        /// @brief Free leases of a subnet.
+        ///
+        /// The queue is accessed with the allocation state of the subnet
+        /// locked.
+        struct SubnetQueue {
+            /// @brief The subnet the queue was built for.
+            boost::weak_ptr<Subnet> subnet_;
+
+            /// @brief The queue or null when the subnet is handled by the
+            /// iterative allocator.
+            FreeLeaseQueuePtr queue_;
+
+            /// @brief Time when the queue was built.
+            time_t built_;
+        };
+
+        /// @brief Pointer to the free leases of a subnet.
+        typedef boost::shared_ptr<SubnetQueue> SubnetQueuePtr;
+
+        /// @brief Returns the free leases of a subnet.
+        ///
+        /// Builds the queue when the subnet is new or was replaced. It must
+        /// be called with the allocation state of the subnet locked.
+        ///
+        /// @param subnet the subnet
+        /// @return the free leases of the subnet
+        SubnetQueuePtr getSubnetQueue(const SubnetPtr& subnet);
+
+        /// @brief Builds the queue of a subnet from the lease database.
+        ///
+        /// @param subnet the subnet
+        /// @param [out] subnet_queue the free leases of the subnet
+        void buildSubnetQueue(const SubnetPtr& subnet, SubnetQueue& subnet_queue);
+
+        /// @brief Returns the next free address from the pools of a subnet.
+        ///
+        /// @param subnet the subnet
+        /// @param queue the free leases of the subnet
+        /// @param client_classes list of classes client belongs to
+        ///
+        /// @return the next free address or the zero address
+        isc::asiolink::IOAddress
+        nextFreeAddress(const SubnetPtr& subnet, const FreeLeaseQueuePtr& queue,
+                        const ClientClasses& client_classes) const;
+
+        /// @brief Adds or removes an address or prefix in its queue.
+        ///
+        /// @param subnet_id identifier of the subnet
+        /// @param address the address or prefix
+        /// @param free true when the address is appended, false when it
+        /// is removed
+        void update(const SubnetID& subnet_id,
+                    const isc::asiolink::IOAddress& address,
+                    const bool free);
+
+        /// @brief Adds or removes an address or prefix in a queue.
+        ///
+        /// Should be called with the allocation state of the subnet locked.
+        ///
+        /// @param subnet the subnet
+        /// @param queue the free leases of the subnet
+        /// @param address the address or prefix
+        /// @param free true when the address is appended, false when it
+        /// is removed
+        void updateInternal(const SubnetPtr& subnet,
+                            const FreeLeaseQueuePtr& queue,
+                            const isc::asiolink::IOAddress& address,
+                            const bool free);
+
+        /// @brief Free leases by subnet identifier.
+        std::map<SubnetID, SubnetQueuePtr> queues_;
+
+        /// @brief The mutex to protect the map of the free leases.
+        std::mutex mutex_;
+    };
+
     /// @brief Address/prefix allocator that gets an address based on a hash
     ///
     /// @todo: This is a skeleton class for now and is missing an implementation.
@@ -234,11 +418,19 @@ protected:
 
     /// @brief Random allocator that picks address randomly
     ///
-    /// @todo: This is a skeleton class for now and is missing an implementation.
+    /// The allocator randomly selects one of the pools allowed for the
+    /// client and returns the next address or delegated prefix from the
+    /// random permutation of this pool. The permutation guarantees that
+    /// each address or prefix is returned once before the pool is
+    /// exhausted. When all allowed pools are exhausted their permutations
+    /// are reset, so the addresses released in the meantime are offered
+    /// again. Unlike the iterative allocator, the candidates are spread
+    /// over the whole pools, so the threads allocating in the same subnet
+    /// rarely try the same candidate.
     class RandomAllocator : public Allocator {
     public:
 
-        /// @brief Default constructor (does nothing)
+        /// @brief Default constructor
         ///
         /// @param type - specifies allocation type
         RandomAllocator(Lease::Type type);
@@ -247,19 +439,33 @@ protected:
 
         /// @brief Returns a random address from pool of specified subnet
         ///
-        /// @todo: Implement this method
-        ///
         /// @param subnet an address will be picked from pool of that subnet
         /// @param client_classes list of classes client belongs to
         /// @param duid Client's DUID (ignored)
         /// @param hint the last address that was picked (ignored)
         ///
+        /// @throw AllocFailed if the subnet has no pools allowed for the
+        /// client.
+        ///
         /// @return a random address from the pool
         virtual isc::asiolink::IOAddress
         pickAddressInternal(const SubnetPtr& subnet,
                             const ClientClasses& client_classes,
                             const DuidPtr& duid,
                             const isc::asiolink::IOAddress& hint);
+
+        /// @brief Selects one of the pools at random.
+        ///
+        /// @param pools the pools
+        /// @return the selected pool
+        PoolPtr selectPool(const std::vector<PoolPtr>& pools);
+
+        /// @brief Random generator used to select the pools.
+        std::mt19937 generator_;
+
+        /// @brief The mutex to protect the random generator shared by the
+        /// subnets.
+        std::mutex mutex_;
     };
 
 public:
@@ -296,6 +502,27 @@ public:
     /// @return pointer to allocator handling a given resource types
     AllocatorPtr getAllocator(Lease::Type type);
 
+    /// @brief Returns allocator for a given pool type and subnet
+    ///
+    /// Returns the free lease queue or the random allocator when the subnet
+    /// is configured to use it, the allocator for the pool type otherwise.
+    ///
+    /// @param type type of pool (V4, IA, TA or PD)
+    /// @param subnet subnet the lease is allocated in
+    ///
+    /// @throw BadValue if allocator for a given type is missing
+    ///
+    /// @return pointer to allocator handling a given resource types
+    AllocatorPtr getAllocator(Lease::Type type, const SubnetPtr& subnet);
+
+    /// @brief Makes a released or reclaimed lease available to the allocators.
+    ///
+    /// The free lease queue allocator appends the address or prefix of
+    /// the lease to the queue of its subnet.
+    ///
+    /// @param lease the lease which is no longer in use
+    void leaseFreed(const LeasePtr& lease);
+
 private:
 
     /// @brief A pointer to currently used allocator
@@ -304,6 +531,17 @@ private:
     /// For IPv6, there will be 3 allocators: TYPE_NA, TYPE_TA, TYPE_PD
     std::map<Lease::Type, AllocatorPtr> allocators_;
 
+    /// @brief Free lease queue allocators by pool type
+    ///
+    /// They are used for the subnets configured with the "free-lease-queue"
+    /// allocator.
+    std::map<Lease::Type, AllocatorPtr> queue_allocators_;
+
+    /// @brief Random allocators by pool type
+    ///
+    /// They are used for the subnets configured with the "random" allocator.
+    std::map<Lease::Type, AllocatorPtr> random_allocators_;
+
     /// @brief number of attempts before we give up lease allocation (0=unlimited)
     uint64_t attempts_;
 
@@ -1205,21 +1443,40 @@ private:
         DB_RECLAIM_LEAVE_UNCHANGED
     };
 
-    /// @brief Reclaim DHCPv4 or DHCPv6 lease with updating lease database.
+    /// @brief Reclaim a batch of DHCPv4 or DHCPv6 leases with updating
+    /// lease database.
     ///
-    /// This method is called by the lease reclamation routine to reclaim the
-    /// lease and update the lease database according to the value of the
-    /// @c remove_lease parameter.
+    /// This method is called by the lease reclamation routine to reclaim
+    /// at most @c RECLAIM_BATCH_SIZE leases and update the lease database
+    /// according to the value of the @c remove_lease parameter. The leases
+    /// are reclaimed in the lease database with a single call to
+    /// @c LeaseMgr::applyLeaseChanges.
     ///
-    /// @param lease Pointer to the DHCPv4 or DHCPv6 lease.
+    /// The batch is cut short when the @c timeout is hit, though at least
+    /// one lease is always reclaimed. Errors are logged using the
+    /// @c failed_message.
+    ///
+    /// @param [in,out] lease Iterator pointing to the first lease of the
+    /// batch. It is moved past the last lease of the batch.
+    /// @param end Iterator pointing past the last expired lease.
     /// @param remove_lease A boolean flag indicating if the lease should be
     /// removed from the lease database (if true) upon reclamation.
     /// @param callout_handle Pointer to the callout handle.
-    /// @tparam LeasePtrPtr Lease type, i.e. @c Lease4Ptr or @c Lease6Ptr.
-    template<typename LeasePtrType>
-    void reclaimExpiredLease(const LeasePtrType& lease,
-                             const bool remove_lease,
-                             const hooks::CalloutHandlePtr& callout_handle);
+    /// @param stopwatch Stopwatch measuring the duration of the reclamation.
+    /// @param timeout Timeout of the reclamation in milliseconds, 0 for none.
+    /// @param failed_message Identifier of the message logged when the
+    /// reclamation of a lease fails.
+    /// @return Number of reclaimed leases.
+    /// @tparam LeaseIterator Iterator of a @c Lease4Collection or
+    /// @c Lease6Collection.
+    template<typename LeaseIterator>
+    size_t reclaimExpiredLeasesBatch(LeaseIterator& lease,
+                                     const LeaseIterator& end,
+                                     const bool remove_lease,
+                                     const hooks::CalloutHandlePtr& callout_handle,
+                                     const util::Stopwatch& stopwatch,
+                                     const uint16_t timeout,
+                                     const isc::log::MessageID& failed_message);
 
     /// @brief Reclaim DHCPv4 or DHCPv6 lease without updating lease database.
     ///
@@ -1263,29 +1520,76 @@ private:
                              const DbReclaimMode& reclaim_mode,
                              const hooks::CalloutHandlePtr& callout_handle);
 
-    /// @brief Marks lease as reclaimed in the database.
+    /// @brief Conducts the steps of the DHCPv6 lease reclamation preceding
+    /// the update of the lease database.
     ///
-    /// This method is called internally by the leases reclamation routines.
-    /// Depending on the value of the @c remove_lease parameter this method
-    /// will delete the reclaimed lease from the database or set its sate
-    /// to "expired-reclaimed". In the latter case it will also clear the
-    /// FQDN information.
+    /// Calls the lease6_expire callouts and, unless they have reclaimed the
+    /// lease themselves, removes the DNS entries and recovers a declined
+    /// lease.
+    ///
+    /// @param lease Pointer to the DHCPv6 lease.
+    /// @param reclaim_mode Indicates what should be done with the reclaimed
+    /// lease in the lease database.
+    /// @param callout_handle Pointer to the callout handle.
+    /// @param [out] remove_lease Set to true if the lease should be removed
+    /// from the lease database.
+    /// @return false if the callouts have reclaimed the lease, true otherwise.
+    bool reclaimExpiredLeaseStart(const Lease6Ptr& lease,
+                                  const DbReclaimMode& reclaim_mode,
+                                  const hooks::CalloutHandlePtr& callout_handle,
+                                  bool& remove_lease);
+
+    /// @brief Conducts the steps of the DHCPv4 lease reclamation preceding
+    /// the update of the lease database.
+    ///
+    /// Calls the lease4_expire callouts and, unless they have reclaimed the
+    /// lease themselves, removes the DNS entries and recovers a declined
+    /// lease.
+    ///
+    /// @param lease Pointer to the DHCPv4 lease.
+    /// @param reclaim_mode Indicates what should be done with the reclaimed
+    /// lease in the lease database.
+    /// @param callout_handle Pointer to the callout handle.
+    /// @param [out] remove_lease Set to true if the lease should be removed
+    /// from the lease database.
+    /// @return false if the callouts have reclaimed the lease, true otherwise.
+    bool reclaimExpiredLeaseStart(const Lease4Ptr& lease,
+                                  const DbReclaimMode& reclaim_mode,
+                                  const hooks::CalloutHandlePtr& callout_handle,
+                                  bool& remove_lease);
+
+    /// @brief Conducts the steps of the DHCPv6 lease reclamation following
+    /// the update of the lease database.
+    ///
+    /// Frees the lease for allocation and updates the statistics.
+    ///
+    /// @param lease Pointer to the reclaimed DHCPv6 lease.
+    void reclaimExpiredLeaseFinish(const Lease6Ptr& lease);
+
+    /// @brief Conducts the steps of the DHCPv4 lease reclamation following
+    /// the update of the lease database.
+    ///
+    /// Frees the lease for allocation and updates the statistics.
+    ///
+    /// @param lease Pointer to the reclaimed DHCPv4 lease.
+    void reclaimExpiredLeaseFinish(const Lease4Ptr& lease);
+
+    /// @brief Creates the change marking a lease as reclaimed in the database.
     ///
-    /// This method may throw exceptions if the operation on the lease database
-    /// fails for any reason.
+    /// Depending on the value of the @c remove_lease parameter the change
+    /// deletes the reclaimed lease from the database or sets its state to
+    /// "expired-reclaimed". In the latter case the FQDN information of the
+    /// lease is cleared.
     ///
     /// @param lease Pointer to the lease.
     /// @param remove_lease Boolean flag indicating if the lease should be
     /// removed from the database (if true).
-    /// @param lease_update_fun Pointer to the function in the @c LeaseMgr to
-    /// be used to update the lease if the @c remove_lease is set to false.
+    /// @return The change to be applied using @c LeaseMgr::applyLeaseChanges.
     ///
     /// @tparam LeasePtrType One of the @c Lease6Ptr or @c Lease4Ptr.
     template<typename LeasePtrType>
-    void reclaimLeaseInDatabase(const LeasePtrType& lease,
-                                const bool remove_lease,
-                                const std::function<void (const LeasePtrType&)>&
-                                lease_update_fun) const;
+    LeaseChange<LeasePtrType> reclaimLeaseChange(const LeasePtrType& lease,
+                                                 const bool remove_lease) const;
 
     /// @anchor reclaimDeclinedLease4
     /// @brief Conducts steps necessary for reclaiming declined IPv4 lease.
@@ -7,6 +7,9 @@
 namespace isc {
 namespace dhcp {
 
+extern const isc::log::MessageID ALLOC_ENGINE_FREE_LEASE_QUEUE_BUILT = "ALLOC_ENGINE_FREE_LEASE_QUEUE_BUILT";
+extern const isc::log::MessageID ALLOC_ENGINE_FREE_LEASE_QUEUE_FAILED = "ALLOC_ENGINE_FREE_LEASE_QUEUE_FAILED";
+extern const isc::log::MessageID ALLOC_ENGINE_FREE_LEASE_QUEUE_TOO_LARGE = "ALLOC_ENGINE_FREE_LEASE_QUEUE_TOO_LARGE";
 extern const isc::log::MessageID ALLOC_ENGINE_LEASE_RECLAIMED = "ALLOC_ENGINE_LEASE_RECLAIMED";
 extern const isc::log::MessageID ALLOC_ENGINE_REMOVAL_NCR_FAILED = "ALLOC_ENGINE_REMOVAL_NCR_FAILED";
 extern const isc::log::MessageID ALLOC_ENGINE_V4_ALLOC_ERROR = "ALLOC_ENGINE_V4_ALLOC_ERROR";
@@ -81,6 +84,9 @@ extern const isc::log::MessageID ALLOC_ENGINE_V6_REVOKED_SHARED_PREFIX_LEASE = "
 namespace {
 
 const char* values[] = {
+    "ALLOC_ENGINE_FREE_LEASE_QUEUE_BUILT", "free lease queue built for subnet %1 with %2 free leases out of %3",
+    "ALLOC_ENGINE_FREE_LEASE_QUEUE_FAILED", "building free lease queue for subnet %1 failed: %2",
+    "ALLOC_ENGINE_FREE_LEASE_QUEUE_TOO_LARGE", "pools of subnet %1 hold %2 leases, more than the %3 supported by the free lease queue allocator",
     "ALLOC_ENGINE_LEASE_RECLAIMED", "successfully reclaimed lease %1",
     "ALLOC_ENGINE_REMOVAL_NCR_FAILED", "sending removal name change request failed for lease %1: %2",
     "ALLOC_ENGINE_V4_ALLOC_ERROR", "%1: error during attempt to allocate an IPv4 address: %2",
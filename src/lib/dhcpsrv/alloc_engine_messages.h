@@ -8,6 +8,9 @@
 namespace isc {
 namespace dhcp {
 
+extern const isc::log::MessageID ALLOC_ENGINE_FREE_LEASE_QUEUE_BUILT;
+extern const isc::log::MessageID ALLOC_ENGINE_FREE_LEASE_QUEUE_FAILED;
+extern const isc::log::MessageID ALLOC_ENGINE_FREE_LEASE_QUEUE_TOO_LARGE;
 extern const isc::log::MessageID ALLOC_ENGINE_LEASE_RECLAIMED;
 extern const isc::log::MessageID ALLOC_ENGINE_REMOVAL_NCR_FAILED;
 extern const isc::log::MessageID ALLOC_ENGINE_V4_ALLOC_ERROR;
@@ -0,0 +1,116 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/dhcp4.h>
+#include <dhcp/option_string.h>
+#include <dhcp/pkt4.h>
+#include <dhcpsrv/benchmarks/parameters.h>
+#include <eval/compiled_expression.h>
+#include <eval/eval_context.h>
+#include <eval/evaluate.h>
+
+#include <sstream>
+#include <vector>
+
+using namespace isc::dhcp;
+using namespace isc::dhcp::bench;
+using namespace std;
+
+namespace {
+
+/// @brief Number of evaluated client classes.
+constexpr size_t CLASS_COUNT = 40;
+
+/// @brief Fixture class benchmarking the evaluation of client classes.
+///
+/// It parses the expressions of the classes of a configuration which
+/// classifies the clients by vendor class, by relay agent and by hardware
+/// address, and evaluates them on a DHCPDISCOVER as the server does for
+/// each received packet.
+class ClientClassBenchmark : public ::benchmark::Fixture {
+public:
+
+    /// @brief Parses the expressions and creates the packet.
+    ///
+    /// It is called before the measured loop of the benchmarks.
+    void setUp() {
+        expressions_.clear();
+        compiled_.clear();
+        for (size_t i = 0; i < CLASS_COUNT; ++i) {
+            ostringstream expr;
+            switch (i % 4) {
+            case 0:
+                expr << "substring(option[60].hex, 0, 9) == 'PXEClient'"
+                     << " and option[93].hex == 0x" << std::hex << (0x1000 + i);
+                break;
+            case 1:
+                expr << "option[60].text == 'vendor-" << i << "'";
+                break;
+            case 2:
+                expr << "relay4[1].hex == 'circuit-" << i << "'"
+                     << " or pkt4.giaddr == 10.0." << i << ".1";
+                break;
+            default:
+                expr << "substring(pkt4.mac, 0, 3) == 0x0011" << std::hex
+                     << (0x10 + i) << " and not member('KNOWN')";
+            }
+            EvalContext eval(Option::V4);
+            eval.parseString(expr.str());
+            expressions_.push_back(eval.expression);
+            compiled_.push_back(CompiledExpressionPtr(
+                new CompiledExpression(eval.expression)));
+        }
+
+        pkt_.reset(new Pkt4(DHCPDISCOVER, 1234));
+        vector<uint8_t> hw = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55 };
+        pkt_->setHWAddr(HTYPE_ETHER, hw.size(), hw);
+        pkt_->addOption(OptionPtr(new OptionString(Option::V4, 60,
+                                                   "PXEClient:Arch:00000")));
+        OptionPtr rai(new Option(Option::V4, DHO_DHCP_AGENT_OPTIONS));
+        rai->addOption(OptionPtr(new OptionString(Option::V4, 1,
+                                                  "circuit-0")));
+        pkt_->addOption(rai);
+    }
+
+    /// @brief The parsed expressions.
+    vector<Expression> expressions_;
+
+    /// @brief The compiled expressions.
+    vector<CompiledExpressionPtr> compiled_;
+
+    /// @brief The classified packet.
+    Pkt4Ptr pkt_;
+};
+
+// Defines a benchmark that measures the classification of a packet by
+// walking the tokens of the expressions.
+BENCHMARK_DEFINE_F(ClientClassBenchmark, evaluate_tokens)(benchmark::State& state) {
+    setUp();
+    while (state.KeepRunning()) {
+        for (auto const& expr : expressions_) {
+            benchmark::DoNotOptimize(evaluateBool(expr, *pkt_));
+        }
+    }
+}
+
+// Defines a benchmark that measures the classification of a packet by
+// evaluating the compiled expressions.
+BENCHMARK_DEFINE_F(ClientClassBenchmark, evaluate_compiled)(benchmark::State& state) {
+    setUp();
+    while (state.KeepRunning()) {
+        for (auto const& compiled : compiled_) {
+            benchmark::DoNotOptimize(evaluateBool(*compiled, *pkt_));
+        }
+    }
+}
+
+/// Register the benchmarks.
+BENCHMARK_REGISTER_F(ClientClassBenchmark, evaluate_tokens)->Unit(UNIT);
+BENCHMARK_REGISTER_F(ClientClassBenchmark, evaluate_compiled)->Unit(UNIT);
+
+}  // namespace
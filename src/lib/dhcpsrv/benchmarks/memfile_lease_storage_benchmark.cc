@@ -0,0 +1,384 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/benchmarks/parameters.h>
+#include <dhcpsrv/memfile_lease_storage.h>
+
+#include <boost/multi_index/ordered_index.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace isc::dhcp::bench;
+using namespace std;
+
+namespace {
+
+/// @brief Container using ordered indexes for the exact match lookups.
+///
+/// This is the layout the DHCPv4 lease storage used before the exact
+/// match indexes became hashed. It is used as the reference to measure
+/// the gain brought by the hashed indexes of @c Lease4Storage.
+typedef boost::multi_index_container<
+    Lease4Ptr,
+    boost::multi_index::indexed_by<
+        boost::multi_index::ordered_unique<
+            boost::multi_index::tag<AddressIndexTag>,
+            boost::multi_index::member<Lease, IOAddress, &Lease::addr_>
+        >,
+        boost::multi_index::ordered_non_unique<
+            boost::multi_index::tag<HWAddressIndexTag>,
+            boost::multi_index::composite_key<
+                Lease4,
+                boost::multi_index::const_mem_fun<Lease, const std::vector<uint8_t>&,
+                                                  &Lease::getHWAddrVector>,
+                boost::multi_index::member<Lease, SubnetID, &Lease::subnet_id_>
+            >
+        >,
+        boost::multi_index::ordered_non_unique<
+            boost::multi_index::tag<ClientIdIndexTag>,
+            boost::multi_index::composite_key<
+                Lease4,
+                boost::multi_index::const_mem_fun<Lease4, const std::vector<uint8_t>&,
+                                                  &Lease4::getClientIdVector>,
+                boost::multi_index::member<Lease, SubnetID, &Lease::subnet_id_>
+            >
+        >
+    >
+> OrderedLease4Storage;
+
+/// @brief Container using ordered indexes for the exact match lookups.
+///
+/// This is the DHCPv6 counterpart of @c OrderedLease4Storage.
+typedef boost::multi_index_container<
+    Lease6Ptr,
+    boost::multi_index::indexed_by<
+        boost::multi_index::ordered_unique<
+            boost::multi_index::tag<AddressIndexTag>,
+            boost::multi_index::member<Lease, IOAddress, &Lease::addr_>
+        >,
+        boost::multi_index::ordered_non_unique<
+            boost::multi_index::tag<DuidIaidTypeIndexTag>,
+            boost::multi_index::composite_key<
+                Lease6,
+                boost::multi_index::const_mem_fun<Lease6, const std::vector<uint8_t>&,
+                                                  &Lease6::getDuidVector>,
+                boost::multi_index::member<Lease6, uint32_t, &Lease6::iaid_>,
+                boost::multi_index::member<Lease6, Lease::Type, &Lease6::type_>
+            >
+        >
+    >
+> OrderedLease6Storage;
+
+/// @brief Returns a vector of bytes unique for the given number.
+///
+/// @param prefix first byte of the vector.
+/// @param i number.
+/// @param len length of the vector.
+vector<uint8_t> makeId(uint8_t prefix, size_t i, size_t len) {
+    vector<uint8_t> id(len, 0);
+    id[0] = prefix;
+    for (size_t pos = len - 1; (pos > 0) && (i > 0); --pos, i >>= 8) {
+        id[pos] = static_cast<uint8_t>(i);
+    }
+    return (id);
+}
+
+/// @brief Fixture class benchmarking the lookups in the lease storages.
+///
+/// It fills the lease storages used by the Memfile backend and the
+/// reference containers using ordered indexes with the same leases,
+/// so the lookups by the same keys can be compared.
+class MemfileLeaseStorageBenchmark : public ::benchmark::Fixture {
+public:
+
+    /// @brief Fills the containers with IPv4 leases.
+    ///
+    /// It is called before the measured loop of the benchmarks.
+    ///
+    /// @param lease_count number of leases.
+    void setUp4(size_t const& lease_count) {
+        leases4_.clear();
+        storage4_.clear();
+        ordered4_.clear();
+        for (size_t i = 0; i < lease_count; ++i) {
+            Lease4Ptr lease(new Lease4());
+            lease->addr_ = IOAddress(0x0a000001u + i);
+            lease->hwaddr_.reset(new HWAddr(makeId(0x08, i, 6), HTYPE_ETHER));
+            lease->client_id_.reset(new ClientId(makeId(0x01, i, 7)));
+            lease->valid_lft_ = 3600;
+            lease->cltt_ = i;
+            lease->subnet_id_ = 1 + i % 16;
+            leases4_.push_back(lease);
+            storage4_.insert(lease);
+            ordered4_.insert(lease);
+        }
+
+        // Look the leases up in random order as the clients send their
+        // packets, so the locality of the insertion order doesn't bias
+        // the results in favor of the ordered indexes.
+        shuffle(leases4_.begin(), leases4_.end(), mt19937(lease_count));
+    }
+
+    /// @brief Fills the containers with IPv6 leases.
+    ///
+    /// It is called before the measured loop of the benchmarks.
+    ///
+    /// @param lease_count number of leases.
+    void setUp6(size_t const& lease_count) {
+        leases6_.clear();
+        storage6_.clear();
+        ordered6_.clear();
+        vector<uint8_t> bytes = IOAddress("2001:db8::").toBytes();
+        for (size_t i = 0; i < lease_count; ++i) {
+            vector<uint8_t> id = makeId(0, i, 8);
+            copy(id.begin(), id.end(), bytes.begin() + 8);
+            Lease6Ptr lease(new Lease6());
+            lease->addr_ = IOAddress::fromBytes(AF_INET6, &bytes[0]);
+            lease->type_ = Lease::TYPE_NA;
+            lease->duid_.reset(new DUID(makeId(0x00, i, 14)));
+            lease->iaid_ = i;
+            lease->valid_lft_ = 3600;
+            lease->cltt_ = i;
+            lease->subnet_id_ = 1 + i % 16;
+            leases6_.push_back(lease);
+            storage6_.insert(lease);
+            ordered6_.insert(lease);
+        }
+
+        // Look the leases up in random order as the clients send their
+        // packets, so the locality of the insertion order doesn't bias
+        // the results in favor of the ordered indexes.
+        shuffle(leases6_.begin(), leases6_.end(), mt19937(lease_count));
+    }
+
+    /// @brief Leases inserted in the containers.
+    Lease4Collection leases4_;
+
+    /// @brief IPv4 lease storage used by the Memfile backend.
+    Lease4Storage storage4_;
+
+    /// @brief IPv4 reference container using ordered indexes.
+    OrderedLease4Storage ordered4_;
+
+    /// @brief Leases inserted in the containers.
+    Lease6Collection leases6_;
+
+    /// @brief IPv6 lease storage used by the Memfile backend.
+    Lease6Storage storage6_;
+
+    /// @brief IPv6 reference container using ordered indexes.
+    OrderedLease6Storage ordered6_;
+};
+
+// Defines a benchmark that measures IPv4 leases retrieval by address
+// using an ordered index.
+BENCHMARK_DEFINE_F(MemfileLeaseStorageBenchmark, getLease4_address_ordered)(benchmark::State& state) {
+    const size_t lease_count = state.range(0);
+    setUp4(lease_count);
+    const auto& idx = ordered4_.get<AddressIndexTag>();
+    while (state.KeepRunning()) {
+        for (Lease4Ptr const& lease : leases4_) {
+            benchmark::DoNotOptimize(idx.find(lease->addr_));
+        }
+    }
+}
+
+// Defines a benchmark that measures IPv4 leases retrieval by address
+// using the hashed index.
+BENCHMARK_DEFINE_F(MemfileLeaseStorageBenchmark, getLease4_address_hashed)(benchmark::State& state) {
+    const size_t lease_count = state.range(0);
+    setUp4(lease_count);
+    const auto& idx = storage4_.get<HashedAddressIndexTag>();
+    while (state.KeepRunning()) {
+        for (Lease4Ptr const& lease : leases4_) {
+            benchmark::DoNotOptimize(idx.find(lease->addr_));
+        }
+    }
+}
+
+// Defines a benchmark that measures IPv4 leases retrieval by hardware address
+// and subnet-id using an ordered index.
+BENCHMARK_DEFINE_F(MemfileLeaseStorageBenchmark, getLease4_hwaddr_subnetid_ordered)(benchmark::State& state) {
+    const size_t lease_count = state.range(0);
+    setUp4(lease_count);
+    const auto& idx = ordered4_.get<HWAddressIndexTag>();
+    while (state.KeepRunning()) {
+        for (Lease4Ptr const& lease : leases4_) {
+            benchmark::DoNotOptimize(idx.find(boost::make_tuple(lease->hwaddr_->hwaddr_,
+                                                                lease->subnet_id_)));
+        }
+    }
+}
+
+// Defines a benchmark that measures IPv4 leases retrieval by hardware address
+// and subnet-id using the hashed index.
+BENCHMARK_DEFINE_F(MemfileLeaseStorageBenchmark, getLease4_hwaddr_subnetid_hashed)(benchmark::State& state) {
+    const size_t lease_count = state.range(0);
+    setUp4(lease_count);
+    const auto& idx = storage4_.get<HWAddressIndexTag>();
+    while (state.KeepRunning()) {
+        for (Lease4Ptr const& lease : leases4_) {
+            auto range = idx.equal_range(lease->hwaddr_->hwaddr_);
+            for (auto l = range.first; l != range.second; ++l) {
+                if ((*l)->subnet_id_ == lease->subnet_id_) {
+                    benchmark::DoNotOptimize(l);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Defines a benchmark that measures IPv4 leases retrieval by client-id
+// and subnet-id using an ordered index.
+BENCHMARK_DEFINE_F(MemfileLeaseStorageBenchmark, getLease4_clientid_subnetid_ordered)(benchmark::State& state) {
+    const size_t lease_count = state.range(0);
+    setUp4(lease_count);
+    const auto& idx = ordered4_.get<ClientIdIndexTag>();
+    while (state.KeepRunning()) {
+        for (Lease4Ptr const& lease : leases4_) {
+            benchmark::DoNotOptimize(idx.find(boost::make_tuple(lease->getClientIdVector(),
+                                                                lease->subnet_id_)));
+        }
+    }
+}
+
+// Defines a benchmark that measures IPv4 leases retrieval by client-id
+// and subnet-id using the hashed index.
+BENCHMARK_DEFINE_F(MemfileLeaseStorageBenchmark, getLease4_clientid_subnetid_hashed)(benchmark::State& state) {
+    const size_t lease_count = state.range(0);
+    setUp4(lease_count);
+    const auto& idx = storage4_.get<ClientIdIndexTag>();
+    while (state.KeepRunning()) {
+        for (Lease4Ptr const& lease : leases4_) {
+            auto range = idx.equal_range(lease->getClientIdVector());
+            for (auto l = range.first; l != range.second; ++l) {
+                if ((*l)->subnet_id_ == lease->subnet_id_) {
+                    benchmark::DoNotOptimize(l);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Defines a benchmark that measures IPv6 leases retrieval by address
+// using an ordered index.
+BENCHMARK_DEFINE_F(MemfileLeaseStorageBenchmark, getLease6_address_ordered)(benchmark::State& state) {
+    const size_t lease_count = state.range(0);
+    setUp6(lease_count);
+    const auto& idx = ordered6_.get<AddressIndexTag>();
+    while (state.KeepRunning()) {
+        for (Lease6Ptr const& lease : leases6_) {
+            benchmark::DoNotOptimize(idx.find(lease->addr_));
+        }
+    }
+}
+
+// Defines a benchmark that measures IPv6 leases retrieval by address
+// using the hashed index.
+BENCHMARK_DEFINE_F(MemfileLeaseStorageBenchmark, getLease6_address_hashed)(benchmark::State& state) {
+    const size_t lease_count = state.range(0);
+    setUp6(lease_count);
+    const auto& idx = storage6_.get<HashedAddressIndexTag>();
+    while (state.KeepRunning()) {
+        for (Lease6Ptr const& lease : leases6_) {
+            benchmark::DoNotOptimize(idx.find(lease->addr_));
+        }
+    }
+}
+
+// Defines a benchmark that measures IPv6 leases retrieval by DUID, IAID
+// and lease type using an ordered index.
+BENCHMARK_DEFINE_F(MemfileLeaseStorageBenchmark, getLease6_duid_iaid_type_ordered)(benchmark::State& state) {
+    const size_t lease_count = state.range(0);
+    setUp6(lease_count);
+    const auto& idx = ordered6_.get<DuidIaidTypeIndexTag>();
+    while (state.KeepRunning()) {
+        for (Lease6Ptr const& lease : leases6_) {
+            benchmark::DoNotOptimize(idx.equal_range(boost::make_tuple(lease->getDuidVector(),
+                                                                       lease->iaid_,
+                                                                       lease->type_)));
+        }
+    }
+}
+
+// Defines a benchmark that measures IPv6 leases retrieval by DUID, IAID
+// and lease type using the hashed index.
+BENCHMARK_DEFINE_F(MemfileLeaseStorageBenchmark, getLease6_duid_iaid_type_hashed)(benchmark::State& state) {
+    const size_t lease_count = state.range(0);
+    setUp6(lease_count);
+    const auto& idx = storage6_.get<DuidIaidTypeIndexTag>();
+    while (state.KeepRunning()) {
+        for (Lease6Ptr const& lease : leases6_) {
+            benchmark::DoNotOptimize(idx.equal_range(boost::make_tuple(lease->getDuidVector(),
+                                                                       lease->iaid_,
+                                                                       lease->type_)));
+        }
+    }
+}
+
+/// The following macros define run parameters for previously defined
+/// lease storage benchmarks.
+
+/// A benchmark that measures IPv4 lease retrieval by IP address using an
+/// ordered index.
+BENCHMARK_REGISTER_F(MemfileLeaseStorageBenchmark, getLease4_address_ordered)
+    ->Range(MIN_LEASE_COUNT, MAX_LEASE_COUNT)->Unit(UNIT);
+
+/// A benchmark that measures IPv4 lease retrieval by IP address using the
+/// hashed index.
+BENCHMARK_REGISTER_F(MemfileLeaseStorageBenchmark, getLease4_address_hashed)
+    ->Range(MIN_LEASE_COUNT, MAX_LEASE_COUNT)->Unit(UNIT);
+
+/// A benchmark that measures IPv4 lease retrieval by hardware address and
+/// subnet-id using an ordered index.
+BENCHMARK_REGISTER_F(MemfileLeaseStorageBenchmark, getLease4_hwaddr_subnetid_ordered)
+    ->Range(MIN_LEASE_COUNT, MAX_LEASE_COUNT)->Unit(UNIT);
+
+/// A benchmark that measures IPv4 lease retrieval by hardware address and
+/// subnet-id using the hashed index.
+BENCHMARK_REGISTER_F(MemfileLeaseStorageBenchmark, getLease4_hwaddr_subnetid_hashed)
+    ->Range(MIN_LEASE_COUNT, MAX_LEASE_COUNT)->Unit(UNIT);
+
+/// A benchmark that measures IPv4 lease retrieval by client-id and
+/// subnet-id using an ordered index.
+BENCHMARK_REGISTER_F(MemfileLeaseStorageBenchmark, getLease4_clientid_subnetid_ordered)
+    ->Range(MIN_LEASE_COUNT, MAX_LEASE_COUNT)->Unit(UNIT);
+
+/// A benchmark that measures IPv4 lease retrieval by client-id and
+/// subnet-id using the hashed index.
+BENCHMARK_REGISTER_F(MemfileLeaseStorageBenchmark, getLease4_clientid_subnetid_hashed)
+    ->Range(MIN_LEASE_COUNT, MAX_LEASE_COUNT)->Unit(UNIT);
+
+/// A benchmark that measures IPv6 lease retrieval by IP address using an
+/// ordered index.
+BENCHMARK_REGISTER_F(MemfileLeaseStorageBenchmark, getLease6_address_ordered)
+    ->Range(MIN_LEASE_COUNT, MAX_LEASE_COUNT)->Unit(UNIT);
+
+/// A benchmark that measures IPv6 lease retrieval by IP address using the
+/// hashed index.
+BENCHMARK_REGISTER_F(MemfileLeaseStorageBenchmark, getLease6_address_hashed)
+    ->Range(MIN_LEASE_COUNT, MAX_LEASE_COUNT)->Unit(UNIT);
+
+/// A benchmark that measures IPv6 lease retrieval by DUID, IAID and lease
+/// type using an ordered index.
+BENCHMARK_REGISTER_F(MemfileLeaseStorageBenchmark, getLease6_duid_iaid_type_ordered)
+    ->Range(MIN_LEASE_COUNT, MAX_LEASE_COUNT)->Unit(UNIT);
+
+/// A benchmark that measures IPv6 lease retrieval by DUID, IAID and lease
+/// type using the hashed index.
+BENCHMARK_REGISTER_F(MemfileLeaseStorageBenchmark, getLease6_duid_iaid_type_hashed)
+    ->Range(MIN_LEASE_COUNT, MAX_LEASE_COUNT)->Unit(UNIT);
+
+}  // namespace
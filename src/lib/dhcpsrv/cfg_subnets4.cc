@@ -495,6 +495,9 @@ CfgSubnets4::removeStatistics() {
 
         stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
                                              "reclaimed-leases"));
+
+        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                             "allocation-lock-contention"));
     }
 }
 
@@ -414,6 +414,9 @@ CfgSubnets6::removeStatistics() {
 
         stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
                                              "reclaimed-leases"));
+
+        stats_mgr.del(StatsMgr::generateName("subnet", subnet_id,
+                                             "allocation-lock-contention"));
     }
 }
 
@@ -32,6 +32,9 @@ ClientClassDef::ClientClassDef(const std::string& name,
 
     // We permit an empty expression for now.  This will likely be useful
     // for automatic classes such as vendor class.
+    if (match_expr_) {
+        compiled_match_expr_.reset(new CompiledExpression(*match_expr_));
+    }
 
     // For classes without options, make sure we have an empty collection
     if (!cfg_option_) {
@@ -49,6 +52,9 @@ ClientClassDef::ClientClassDef(const ClientClassDef& rhs)
         *match_expr_ = *(rhs.match_expr_);
     }
 
+    // The compiled expression is immutable so it can be shared.
+    compiled_match_expr_ = rhs.compiled_match_expr_;
+
     if (rhs.cfg_option_def_) {
         rhs.cfg_option_def_->copyTo(*cfg_option_def_);
     }
@@ -85,6 +91,16 @@ ClientClassDef::getMatchExpr() const {
 void
 ClientClassDef::setMatchExpr(const ExpressionPtr& match_expr) {
     match_expr_ = match_expr;
+    if (match_expr_) {
+        compiled_match_expr_.reset(new CompiledExpression(*match_expr_));
+    } else {
+        compiled_match_expr_.reset();
+    }
+}
+
+const CompiledExpressionPtr&
+ClientClassDef::getCompiledMatchExpr() const {
+    return (compiled_match_expr_);
 }
 
 std::string
@@ -11,6 +11,7 @@
 #include <cc/user_context.h>
 #include <dhcpsrv/cfg_option.h>
 #include <dhcpsrv/cfg_option_def.h>
+#include <eval/compiled_expression.h>
 #include <eval/token.h>
 #include <exceptions/exceptions.h>
 
@@ -76,6 +77,14 @@ public:
     /// @param match_expr the expression to assign the class
     void setMatchExpr(const ExpressionPtr& match_expr);
 
+    /// @brief Fetches the class's compiled match expression
+    ///
+    /// The match expression is compiled when it is set. The compiled
+    /// expression is evaluated faster than the expression itself.
+    ///
+    /// @return the compiled match expression (null without expression)
+    const CompiledExpressionPtr& getCompiledMatchExpr() const;
+
     /// @brief Fetches the class's original match expression
     std::string getTest() const;
 
@@ -203,6 +212,9 @@ private:
     /// this class.
     ExpressionPtr match_expr_;
 
+    /// @brief The compiled match expression.
+    CompiledExpressionPtr compiled_match_expr_;
+
     /// @brief The original expression which determines membership in
     /// this class.
     std::string test_;
@@ -102,49 +102,7 @@ CSVLeaseFile4::next(Lease4Ptr& lease) {
             return (true);
         }
 
-        // Get the lease address.
-        IOAddress addr(readAddress(row));
-
-        // Get client id. It is possible that the client id is empty and the
-        // returned pointer is NULL. This is ok, but if the client id is NULL,
-        // we need to be careful to not use the NULL pointer.
-        ClientIdPtr client_id = readClientId(row);
-        std::vector<uint8_t> client_id_vec;
-        if (client_id) {
-            client_id_vec = client_id->getClientId();
-        }
-        size_t client_id_len = client_id_vec.size();
-
-        // Get the HW address. It should never be empty and the readHWAddr checks
-        // that.
-        HWAddr hwaddr = readHWAddr(row);
-        uint32_t state = readState(row);
-
-        if ((hwaddr.hwaddr_.empty()) && (client_id_vec.empty()) &&
-            (state != Lease::STATE_DECLINED)) {
-            isc_throw(BadValue, "Lease4: " << addr.toText() << ", state: "
-                      << Lease::basicStatesToText(state)
-                      << " has neither hardware address or client id");
-        }
-
-        // Get the user context (can be NULL).
-        ConstElementPtr ctx = readContext(row);
-
-        lease.reset(new Lease4(addr,
-                               HWAddrPtr(new HWAddr(hwaddr)),
-                               client_id_vec.empty() ? NULL : &client_id_vec[0],
-                               client_id_len,
-                               readValid(row),
-                               readCltt(row),
-                               readSubnetID(row),
-                               readFqdnFwd(row),
-                               readFqdnRev(row),
-                               readHostname(row)));
-        lease->state_ = state;
-
-        if (ctx) {
-            lease->setContext(ctx);
-        }
+        lease = readLease(row);
 
     } catch (const std::exception& ex) {
         // bump the read error count
@@ -163,6 +121,76 @@ CSVLeaseFile4::next(Lease4Ptr& lease) {
     return (true);
 }
 
+bool
+CSVLeaseFile4::nextRow(CSVRow& row) {
+    // Bump the number of read attempts
+    ++reads_;
+
+    row = CSVRow();
+    VersionedCSVFile::next(row);
+    // The empty row signals EOF.
+    return (row != CSVFile::EMPTY_ROW());
+}
+
+Lease4Ptr
+CSVLeaseFile4::readLease(const CSVRow& row) const {
+    // Get the lease address.
+    IOAddress addr(readAddress(row));
+
+    // Get client id. It is possible that the client id is empty and the
+    // returned pointer is NULL. This is ok, but if the client id is NULL,
+    // we need to be careful to not use the NULL pointer.
+    ClientIdPtr client_id = readClientId(row);
+    std::vector<uint8_t> client_id_vec;
+    if (client_id) {
+        client_id_vec = client_id->getClientId();
+    }
+    size_t client_id_len = client_id_vec.size();
+
+    // Get the HW address. It should never be empty and the readHWAddr checks
+    // that.
+    HWAddr hwaddr = readHWAddr(row);
+    uint32_t state = readState(row);
+
+    if ((hwaddr.hwaddr_.empty()) && (client_id_vec.empty()) &&
+        (state != Lease::STATE_DECLINED)) {
+        isc_throw(BadValue, "Lease4: " << addr.toText() << ", state: "
+                  << Lease::basicStatesToText(state)
+                  << " has neither hardware address or client id");
+    }
+
+    // Get the user context (can be NULL).
+    ConstElementPtr ctx = readContext(row);
+
+    Lease4Ptr lease(new Lease4(addr,
+                               HWAddrPtr(new HWAddr(hwaddr)),
+                               client_id_vec.empty() ? NULL : &client_id_vec[0],
+                               client_id_len,
+                               readValid(row),
+                               readCltt(row),
+                               readSubnetID(row),
+                               readFqdnFwd(row),
+                               readFqdnRev(row),
+                               readHostname(row)));
+    lease->state_ = state;
+
+    if (ctx) {
+        lease->setContext(ctx);
+    }
+
+    return (lease);
+}
+
+void
+CSVLeaseFile4::countRead(const std::string& error) {
+    if (error.empty()) {
+        ++read_leases_;
+    } else {
+        ++read_errs_;
+        setReadMsg(error);
+    }
+}
+
 void
 CSVLeaseFile4::initColumns() {
     addColumn("address", "1.0");
@@ -181,19 +209,19 @@ CSVLeaseFile4::initColumns() {
 }
 
 IOAddress
-CSVLeaseFile4::readAddress(const CSVRow& row) {
+CSVLeaseFile4::readAddress(const CSVRow& row) const {
     IOAddress address(row.readAt(getColumnIndex("address")));
     return (address);
 }
 
 HWAddr
-CSVLeaseFile4::readHWAddr(const CSVRow& row) {
+CSVLeaseFile4::readHWAddr(const CSVRow& row) const {
     HWAddr hwaddr = HWAddr::fromText(row.readAt(getColumnIndex("hwaddr")));
     return (hwaddr);
 }
 
 ClientIdPtr
-CSVLeaseFile4::readClientId(const CSVRow& row) {
+CSVLeaseFile4::readClientId(const CSVRow& row) const {
     std::string client_id = row.readAt(getColumnIndex("client_id"));
     // NULL client ids are allowed in DHCPv4.
     if (client_id.empty()) {
@@ -204,14 +232,14 @@ CSVLeaseFile4::readClientId(const CSVRow& row) {
 }
 
 uint32_t
-CSVLeaseFile4::readValid(const CSVRow& row) {
+CSVLeaseFile4::readValid(const CSVRow& row) const {
     uint32_t valid =
         row.readAndConvertAt<uint32_t>(getColumnIndex("valid_lifetime"));
     return (valid);
 }
 
 time_t
-CSVLeaseFile4::readCltt(const CSVRow& row) {
+CSVLeaseFile4::readCltt(const CSVRow& row) const {
     time_t cltt =
         static_cast<time_t>(row.readAndConvertAt<uint64_t>(getColumnIndex("expire"))
                             - readValid(row));
@@ -219,38 +247,38 @@ CSVLeaseFile4::readCltt(const CSVRow& row) {
 }
 
 SubnetID
-CSVLeaseFile4::readSubnetID(const CSVRow& row) {
+CSVLeaseFile4::readSubnetID(const CSVRow& row) const {
     SubnetID subnet_id =
         row.readAndConvertAt<SubnetID>(getColumnIndex("subnet_id"));
     return (subnet_id);
 }
 
 bool
-CSVLeaseFile4::readFqdnFwd(const CSVRow& row) {
+CSVLeaseFile4::readFqdnFwd(const CSVRow& row) const {
     bool fqdn_fwd = row.readAndConvertAt<bool>(getColumnIndex("fqdn_fwd"));
     return (fqdn_fwd);
 }
 
 bool
-CSVLeaseFile4::readFqdnRev(const CSVRow& row) {
+CSVLeaseFile4::readFqdnRev(const CSVRow& row) const {
     bool fqdn_rev = row.readAndConvertAt<bool>(getColumnIndex("fqdn_rev"));
     return (fqdn_rev);
 }
 
 std::string
-CSVLeaseFile4::readHostname(const CSVRow& row) {
+CSVLeaseFile4::readHostname(const CSVRow& row) const {
     std::string hostname = row.readAtEscaped(getColumnIndex("hostname"));
     return (hostname);
 }
 
 uint32_t
-CSVLeaseFile4::readState(const util::CSVRow& row) {
+CSVLeaseFile4::readState(const util::CSVRow& row) const {
     uint32_t state = row.readAndConvertAt<uint32_t>(getColumnIndex("state"));
     return (state);
 }
 
 ConstElementPtr
-CSVLeaseFile4::readContext(const util::CSVRow& row) {
+CSVLeaseFile4::readContext(const util::CSVRow& row) const {
     std::string user_context = row.readAtEscaped(getColumnIndex("user_context"));
     if (user_context.empty()) {
         return (ConstElementPtr());
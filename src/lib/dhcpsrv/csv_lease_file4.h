@@ -11,7 +11,7 @@
 #include <dhcp/duid.h>
 #include <dhcpsrv/lease.h>
 #include <dhcpsrv/subnet.h>
-#include <dhcpsrv/lease_file_stats.h>
+#include <dhcpsrv/lease_file.h>
 #include <util/versioned_csv_file.h>
 #include <stdint.h>
 #include <string>
@@ -31,9 +31,12 @@ namespace dhcp {
 /// validation (see http://oldkea.isc.org/ticket/2405). However, when #2405
 /// is implemented, the @c next function may need to be updated to use the
 /// validation capablity of @c Lease4.
-class CSVLeaseFile4 : public isc::util::VersionedCSVFile, public LeaseFileStats {
+class CSVLeaseFile4 : public isc::util::VersionedCSVFile, public LeaseFile4 {
 public:
 
+    /// @brief Type of the rows read from the file.
+    typedef util::CSVRow RowType;
+
     /// @brief Constructor.
     ///
     /// Initializes columns of the lease file.
@@ -50,6 +53,37 @@ public:
     /// the base class may do so.
     virtual void open(const bool seek_to_end = false);
 
+    /// @brief Closes the lease file.
+    virtual void close() {
+        VersionedCSVFile::close();
+    }
+
+    /// @brief Checks if the lease file exists.
+    virtual bool exists() const {
+        return (VersionedCSVFile::exists());
+    }
+
+    /// @brief Returns the name of the lease file.
+    virtual std::string getFilename() const {
+        return (VersionedCSVFile::getFilename());
+    }
+
+    /// @brief Checks if the lease file read needs to be converted
+    /// to the current schema.
+    virtual bool needsConversion() const {
+        return (VersionedCSVFile::needsConversion());
+    }
+
+    /// @brief Flushes the lease file.
+    virtual void flush() {
+        VersionedCSVFile::flush();
+    }
+
+    /// @brief Flushes the lease file and forces it to the storage device.
+    virtual void sync() {
+        VersionedCSVFile::sync();
+    }
+
     /// @brief Appends the lease record to the CSV file.
     ///
     /// This function doesn't throw exceptions itself. In theory, exceptions
@@ -60,7 +94,7 @@ public:
     /// @param lease Structure representing a DHCPv4 lease.
     /// @throw BadValue if the lease has no hardware address, no client id and
     /// is not in STATE_DECLINED.
-    void append(const Lease4& lease);
+    virtual void append(const Lease4& lease);
 
     /// @brief Reads next lease from the CSV file.
     ///
@@ -85,6 +119,36 @@ public:
     /// ticket http://oldkea.isc.org/ticket/2405 is implemented.
     bool next(Lease4Ptr& lease);
 
+    /// @brief Reads the next row of the CSV file without parsing it.
+    ///
+    /// This function, @c readLease and @c countRead split @c next so as
+    /// the rows can be read sequentially and parsed by several threads.
+    /// The result of parsing each row must be passed to @c countRead in
+    /// the order of the rows.
+    ///
+    /// @param [out] row Row read from the CSV file.
+    ///
+    /// @return false at the end of the file, true otherwise.
+    bool nextRow(util::CSVRow& row);
+
+    /// @brief Creates a lease from a row of the CSV file.
+    ///
+    /// This function doesn't modify the object so it may be called by
+    /// several threads at the same time.
+    ///
+    /// @param row Row read from the CSV file.
+    ///
+    /// @return Pointer to the lease.
+    /// @throw isc::BadValue or other exception if the row doesn't hold
+    /// a valid lease.
+    Lease4Ptr readLease(const util::CSVRow& row) const;
+
+    /// @brief Accounts the result of parsing a row.
+    ///
+    /// @param error Error message or an empty string if the lease has
+    /// been read.
+    void countRead(const std::string& error);
+
 private:
 
     /// @brief Initializes columns of the CSV file holding leases.
@@ -111,57 +175,57 @@ private:
     /// @brief Reads lease address from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    asiolink::IOAddress readAddress(const util::CSVRow& row);
+    asiolink::IOAddress readAddress(const util::CSVRow& row) const;
 
     /// @brief Reads HW address from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    HWAddr readHWAddr(const util::CSVRow& row);
+    HWAddr readHWAddr(const util::CSVRow& row) const;
 
     /// @brief Reads client identifier from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    ClientIdPtr readClientId(const util::CSVRow& row);
+    ClientIdPtr readClientId(const util::CSVRow& row) const;
 
     /// @brief Reads valid lifetime from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    uint32_t readValid(const util::CSVRow& row);
+    uint32_t readValid(const util::CSVRow& row) const;
 
     /// @brief Reads cltt value from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    time_t readCltt(const util::CSVRow& row);
+    time_t readCltt(const util::CSVRow& row) const;
 
     /// @brief Reads subnet id from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    SubnetID readSubnetID(const util::CSVRow& row);
+    SubnetID readSubnetID(const util::CSVRow& row) const;
 
     /// @brief Reads the FQDN forward flag from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    bool readFqdnFwd(const util::CSVRow& row);
+    bool readFqdnFwd(const util::CSVRow& row) const;
 
     /// @brief Reads the FQDN reverse flag from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    bool readFqdnRev(const util::CSVRow& row);
+    bool readFqdnRev(const util::CSVRow& row) const;
 
     /// @brief Reads hostname from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    std::string readHostname(const util::CSVRow& row);
+    std::string readHostname(const util::CSVRow& row) const;
 
     /// @brief Reads lease state from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    uint32_t readState(const util::CSVRow& row);
+    uint32_t readState(const util::CSVRow& row) const;
 
     /// @brief Reads lease user context from the CSV file row.
     ///
     /// @param row CSV file row holding lease information.
-    data::ConstElementPtr readContext(const util::CSVRow& row);
+    data::ConstElementPtr readContext(const util::CSVRow& row) const;
     //@}
 
 };
@@ -107,6 +107,7 @@ extern const isc::log::MessageID DHCPSRV_LEASE_SANITY_FAIL_DISCARD = "DHCPSRV_LE
 extern const isc::log::MessageID DHCPSRV_LEASE_SANITY_FIXED = "DHCPSRV_LEASE_SANITY_FIXED";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_ADD_ADDR4 = "DHCPSRV_MEMFILE_ADD_ADDR4";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_ADD_ADDR6 = "DHCPSRV_MEMFILE_ADD_ADDR6";
+extern const isc::log::MessageID DHCPSRV_MEMFILE_APPLY_LEASE_CHANGES = "DHCPSRV_MEMFILE_APPLY_LEASE_CHANGES";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_BEGIN_TRANSACTION = "DHCPSRV_MEMFILE_BEGIN_TRANSACTION";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_COMMIT = "DHCPSRV_MEMFILE_COMMIT";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_CONVERTING_LEASE_FILES = "DHCPSRV_MEMFILE_CONVERTING_LEASE_FILES";
@@ -136,7 +137,9 @@ extern const isc::log::MessageID DHCPSRV_MEMFILE_GET_SUBID6 = "DHCPSRV_MEMFILE_G
 extern const isc::log::MessageID DHCPSRV_MEMFILE_GET_SUBID_CLIENTID = "DHCPSRV_MEMFILE_GET_SUBID_CLIENTID";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_GET_SUBID_HWADDR = "DHCPSRV_MEMFILE_GET_SUBID_HWADDR";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_GET_VERSION = "DHCPSRV_MEMFILE_GET_VERSION";
+extern const isc::log::MessageID DHCPSRV_MEMFILE_JOURNAL_TRUNCATED = "DHCPSRV_MEMFILE_JOURNAL_TRUNCATED";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_LEASE_FILE_LOAD = "DHCPSRV_MEMFILE_LEASE_FILE_LOAD";
+extern const isc::log::MessageID DHCPSRV_MEMFILE_LEASE_FILE_LOADED = "DHCPSRV_MEMFILE_LEASE_FILE_LOADED";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_LEASE_LOAD = "DHCPSRV_MEMFILE_LEASE_LOAD";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_LEASE_LOAD_ROW_ERROR = "DHCPSRV_MEMFILE_LEASE_LOAD_ROW_ERROR";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_LFC_EXECUTE = "DHCPSRV_MEMFILE_LFC_EXECUTE";
@@ -157,9 +160,13 @@ extern const isc::log::MessageID DHCPSRV_MEMFILE_WIPE_LEASES4 = "DHCPSRV_MEMFILE
 extern const isc::log::MessageID DHCPSRV_MEMFILE_WIPE_LEASES4_FINISHED = "DHCPSRV_MEMFILE_WIPE_LEASES4_FINISHED";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_WIPE_LEASES6 = "DHCPSRV_MEMFILE_WIPE_LEASES6";
 extern const isc::log::MessageID DHCPSRV_MEMFILE_WIPE_LEASES6_FINISHED = "DHCPSRV_MEMFILE_WIPE_LEASES6_FINISHED";
+extern const isc::log::MessageID DHCPSRV_MEMFILE_WRITE_FAILED = "DHCPSRV_MEMFILE_WRITE_FAILED";
+extern const isc::log::MessageID DHCPSRV_MEMFILE_WRITE_POLICY = "DHCPSRV_MEMFILE_WRITE_POLICY";
 extern const isc::log::MessageID DHCPSRV_MULTIPLE_RAW_SOCKETS_PER_IFACE = "DHCPSRV_MULTIPLE_RAW_SOCKETS_PER_IFACE";
 extern const isc::log::MessageID DHCPSRV_MYSQL_ADD_ADDR4 = "DHCPSRV_MYSQL_ADD_ADDR4";
 extern const isc::log::MessageID DHCPSRV_MYSQL_ADD_ADDR6 = "DHCPSRV_MYSQL_ADD_ADDR6";
+extern const isc::log::MessageID DHCPSRV_MYSQL_APPLY_LEASE_CHANGES = "DHCPSRV_MYSQL_APPLY_LEASE_CHANGES";
+extern const isc::log::MessageID DHCPSRV_MYSQL_APPLY_LEASE_CHANGES_FAILED = "DHCPSRV_MYSQL_APPLY_LEASE_CHANGES_FAILED";
 extern const isc::log::MessageID DHCPSRV_MYSQL_BEGIN_TRANSACTION = "DHCPSRV_MYSQL_BEGIN_TRANSACTION";
 extern const isc::log::MessageID DHCPSRV_MYSQL_COMMIT = "DHCPSRV_MYSQL_COMMIT";
 extern const isc::log::MessageID DHCPSRV_MYSQL_DB = "DHCPSRV_MYSQL_DB";
@@ -201,6 +208,8 @@ extern const isc::log::MessageID DHCPSRV_NO_SOCKETS_OPEN = "DHCPSRV_NO_SOCKETS_O
 extern const isc::log::MessageID DHCPSRV_OPEN_SOCKET_FAIL = "DHCPSRV_OPEN_SOCKET_FAIL";
 extern const isc::log::MessageID DHCPSRV_PGSQL_ADD_ADDR4 = "DHCPSRV_PGSQL_ADD_ADDR4";
 extern const isc::log::MessageID DHCPSRV_PGSQL_ADD_ADDR6 = "DHCPSRV_PGSQL_ADD_ADDR6";
+extern const isc::log::MessageID DHCPSRV_PGSQL_APPLY_LEASE_CHANGES = "DHCPSRV_PGSQL_APPLY_LEASE_CHANGES";
+extern const isc::log::MessageID DHCPSRV_PGSQL_APPLY_LEASE_CHANGES_FAILED = "DHCPSRV_PGSQL_APPLY_LEASE_CHANGES_FAILED";
 extern const isc::log::MessageID DHCPSRV_PGSQL_BEGIN_TRANSACTION = "DHCPSRV_PGSQL_BEGIN_TRANSACTION";
 extern const isc::log::MessageID DHCPSRV_PGSQL_COMMIT = "DHCPSRV_PGSQL_COMMIT";
 extern const isc::log::MessageID DHCPSRV_PGSQL_DB = "DHCPSRV_PGSQL_DB";
@@ -356,6 +365,7 @@ const char* values[] = {
     "DHCPSRV_LEASE_SANITY_FIXED", "The lease %1 with subnet-id %2 failed subnet-id checks, but was corrected to subnet-id %3.",
     "DHCPSRV_MEMFILE_ADD_ADDR4", "adding IPv4 lease with address %1",
     "DHCPSRV_MEMFILE_ADD_ADDR6", "adding IPv6 lease with address %1",
+    "DHCPSRV_MEMFILE_APPLY_LEASE_CHANGES", "applying a batch of %1 lease changes",
     "DHCPSRV_MEMFILE_BEGIN_TRANSACTION", "committing to memory file database",
     "DHCPSRV_MEMFILE_COMMIT", "committing to memory file database",
     "DHCPSRV_MEMFILE_CONVERTING_LEASE_FILES", "running LFC now to convert lease files to the current schema: %1.%2",
@@ -385,7 +395,9 @@ const char* values[] = {
     "DHCPSRV_MEMFILE_GET_SUBID_CLIENTID", "obtaining IPv4 lease for subnet ID %1 and client ID %2",
     "DHCPSRV_MEMFILE_GET_SUBID_HWADDR", "obtaining IPv4 lease for subnet ID %1 and hardware address %2",
     "DHCPSRV_MEMFILE_GET_VERSION", "obtaining schema version information",
+    "DHCPSRV_MEMFILE_JOURNAL_TRUNCATED", "discarding the end of the lease journal %1 at offset %2: %3",
     "DHCPSRV_MEMFILE_LEASE_FILE_LOAD", "loading leases from file %1",
+    "DHCPSRV_MEMFILE_LEASE_FILE_LOADED", "read %1 rows from the lease file %2 in %3 (%4 rows/s) using %5 thread(s)",
     "DHCPSRV_MEMFILE_LEASE_LOAD", "loading lease %1",
     "DHCPSRV_MEMFILE_LEASE_LOAD_ROW_ERROR", "discarding row %1, error: %2",
     "DHCPSRV_MEMFILE_LFC_EXECUTE", "executing Lease File Cleanup using: %1",
@@ -406,9 +418,13 @@ const char* values[] = {
     "DHCPSRV_MEMFILE_WIPE_LEASES4_FINISHED", "removing all IPv4 leases from subnet %1 finished, removed %2 leases",
     "DHCPSRV_MEMFILE_WIPE_LEASES6", "removing all IPv6 leases from subnet %1",
     "DHCPSRV_MEMFILE_WIPE_LEASES6_FINISHED", "removing all IPv6 leases from subnet %1 finished, removed %2 leases",
+    "DHCPSRV_MEMFILE_WRITE_FAILED", "failed to write lease updates to the lease file %1: %2",
+    "DHCPSRV_MEMFILE_WRITE_POLICY", "lease updates are written to %1 using the %2 policy",
     "DHCPSRV_MULTIPLE_RAW_SOCKETS_PER_IFACE", "current configuration will result in opening multiple broadcast capable sockets on some interfaces and some DHCP messages may be duplicated",
     "DHCPSRV_MYSQL_ADD_ADDR4", "adding IPv4 lease with address %1",
     "DHCPSRV_MYSQL_ADD_ADDR6", "adding IPv6 lease with address %1, lease type %2",
+    "DHCPSRV_MYSQL_APPLY_LEASE_CHANGES", "applying a batch of %1 lease changes",
+    "DHCPSRV_MYSQL_APPLY_LEASE_CHANGES_FAILED", "failed to apply a batch of lease changes in a transaction: %1",
     "DHCPSRV_MYSQL_BEGIN_TRANSACTION", "committing to MySQL database",
     "DHCPSRV_MYSQL_COMMIT", "committing to MySQL database",
     "DHCPSRV_MYSQL_DB", "opening MySQL lease database: %1",
@@ -450,6 +466,8 @@ const char* values[] = {
     "DHCPSRV_OPEN_SOCKET_FAIL", "failed to open socket: %1",
     "DHCPSRV_PGSQL_ADD_ADDR4", "adding IPv4 lease with address %1",
     "DHCPSRV_PGSQL_ADD_ADDR6", "adding IPv6 lease with address %1, lease type %2",
+    "DHCPSRV_PGSQL_APPLY_LEASE_CHANGES", "applying a batch of %1 lease changes",
+    "DHCPSRV_PGSQL_APPLY_LEASE_CHANGES_FAILED", "failed to apply a batch of lease changes in a transaction: %1",
     "DHCPSRV_PGSQL_BEGIN_TRANSACTION", "committing to PostgreSQL database",
     "DHCPSRV_PGSQL_COMMIT", "committing to PostgreSQL database",
     "DHCPSRV_PGSQL_DB", "opening PostgreSQL lease database: %1",
@@ -108,6 +108,7 @@ extern const isc::log::MessageID DHCPSRV_LEASE_SANITY_FAIL_DISCARD;
 extern const isc::log::MessageID DHCPSRV_LEASE_SANITY_FIXED;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_ADD_ADDR4;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_ADD_ADDR6;
+extern const isc::log::MessageID DHCPSRV_MEMFILE_APPLY_LEASE_CHANGES;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_BEGIN_TRANSACTION;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_COMMIT;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_CONVERTING_LEASE_FILES;
@@ -137,7 +138,9 @@ extern const isc::log::MessageID DHCPSRV_MEMFILE_GET_SUBID6;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_GET_SUBID_CLIENTID;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_GET_SUBID_HWADDR;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_GET_VERSION;
+extern const isc::log::MessageID DHCPSRV_MEMFILE_JOURNAL_TRUNCATED;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_LEASE_FILE_LOAD;
+extern const isc::log::MessageID DHCPSRV_MEMFILE_LEASE_FILE_LOADED;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_LEASE_LOAD;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_LEASE_LOAD_ROW_ERROR;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_LFC_EXECUTE;
@@ -158,9 +161,13 @@ extern const isc::log::MessageID DHCPSRV_MEMFILE_WIPE_LEASES4;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_WIPE_LEASES4_FINISHED;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_WIPE_LEASES6;
 extern const isc::log::MessageID DHCPSRV_MEMFILE_WIPE_LEASES6_FINISHED;
+extern const isc::log::MessageID DHCPSRV_MEMFILE_WRITE_FAILED;
+extern const isc::log::MessageID DHCPSRV_MEMFILE_WRITE_POLICY;
 extern const isc::log::MessageID DHCPSRV_MULTIPLE_RAW_SOCKETS_PER_IFACE;
 extern const isc::log::MessageID DHCPSRV_MYSQL_ADD_ADDR4;
 extern const isc::log::MessageID DHCPSRV_MYSQL_ADD_ADDR6;
+extern const isc::log::MessageID DHCPSRV_MYSQL_APPLY_LEASE_CHANGES;
+extern const isc::log::MessageID DHCPSRV_MYSQL_APPLY_LEASE_CHANGES_FAILED;
 extern const isc::log::MessageID DHCPSRV_MYSQL_BEGIN_TRANSACTION;
 extern const isc::log::MessageID DHCPSRV_MYSQL_COMMIT;
 extern const isc::log::MessageID DHCPSRV_MYSQL_DB;
@@ -202,6 +209,8 @@ extern const isc::log::MessageID DHCPSRV_NO_SOCKETS_OPEN;
 extern const isc::log::MessageID DHCPSRV_OPEN_SOCKET_FAIL;
 extern const isc::log::MessageID DHCPSRV_PGSQL_ADD_ADDR4;
 extern const isc::log::MessageID DHCPSRV_PGSQL_ADD_ADDR6;
+extern const isc::log::MessageID DHCPSRV_PGSQL_APPLY_LEASE_CHANGES;
+extern const isc::log::MessageID DHCPSRV_PGSQL_APPLY_LEASE_CHANGES_FAILED;
 extern const isc::log::MessageID DHCPSRV_PGSQL_BEGIN_TRANSACTION;
 extern const isc::log::MessageID DHCPSRV_PGSQL_COMMIT;
 extern const isc::log::MessageID DHCPSRV_PGSQL_DB;
@@ -406,6 +406,9 @@ private:
     Ranges ranges_;
 };
 
+/// @brief Pointer to the @c FreeLeaseQueue.
+typedef boost::shared_ptr<FreeLeaseQueue> FreeLeaseQueuePtr;
+
 } // end of namespace isc::dhcp
 } // end of namespace isc
 
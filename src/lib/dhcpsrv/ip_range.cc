@@ -44,10 +44,11 @@ PrefixRange::PrefixRange(const asiolink::IOAddress& prefix, const uint8_t length
                   << " and prefix length " << static_cast<int>(length)
                   << " must not be greater than 128");
     }
-    // Now calculate the last prefix in the range.
-    auto prefixes_num = prefixesInRange(prefix_length_, delegated_length_);
-    uint64_t addrs_in_prefix = static_cast<uint64_t>(1) << (128 - delegated_length_);
-    end_ = offsetAddress(prefix, (prefixes_num - 1) * addrs_in_prefix);
+    // Now calculate the last prefix in the range. The offset between the
+    // first and the last prefix doesn't fit in 64 bits when the delegated
+    // prefixes are shorter than /64, so it is derived from the last address
+    // in the range instead.
+    end_ = firstAddrInPrefix(lastAddrInPrefix(prefix, prefix_length_), delegated_length_);
 }
 
 PrefixRange::PrefixRange(const asiolink::IOAddress& start, const asiolink::IOAddress& end,
@@ -8,7 +8,7 @@
 #include <asiolink/addr_utilities.h>
 #include <dhcpsrv/ip_range_permutation.h>
 
-#include <iostream>
+#include <vector>
 
 using namespace isc::asiolink;
 
@@ -16,16 +16,41 @@ namespace isc {
 namespace dhcp {
 
 IPRangePermutation::IPRangePermutation(const AddressRange& range)
-    : range_start_(range.start_), step_(1), cursor_(addrsInRange(range_start_, range.end_) - 1),
+    : range_start_(range.start_), shift_(0), cursor_(addrsInRange(range_start_, range.end_) - 1),
       state_(), done_(false), generator_() {
     std::random_device rd;
     generator_.seed(rd());
 }
 
 IPRangePermutation::IPRangePermutation(const PrefixRange& range)
-    : range_start_(range.start_), step_(static_cast<uint64_t>(1) << (128 - range.delegated_length_)),
+    : range_start_(range.start_), shift_(128 - range.delegated_length_),
       cursor_(prefixesInRange(range.prefix_length_, range.delegated_length_) - 1),
       state_(), done_(false), generator_() {
+    std::random_device rd;
+    generator_.seed(rd());
+}
+
+IOAddress
+IPRangePermutation::addressAt(const uint64_t position) const {
+    if (shift_ == 0) {
+        return (offsetAddress(range_start_, position));
+    }
+
+    // The offset of a delegated prefix is the position shifted by the
+    // number of bits in the prefix. It may exceed 64 bits, so it is added
+    // to the prefix byte by byte starting from its least significant bits.
+    std::vector<uint8_t> bytes = range_start_.toBytes();
+    uint64_t offset_lo = (shift_ >= 64 ? 0 : position << shift_);
+    uint64_t offset_hi = (shift_ > 64 ? position << (shift_ - 64) :
+                          (shift_ == 64 ? position : position >> (64 - shift_)));
+    unsigned carry = 0;
+    for (int i = 15; i >= 0; --i) {
+        uint64_t offset = (i >= 8 ? offset_lo : offset_hi);
+        unsigned sum = bytes[i] + static_cast<uint8_t>(offset >> (8 * ((15 - i) % 8))) + carry;
+        bytes[i] = static_cast<uint8_t>(sum);
+        carry = sum >> 8;
+    }
+    return (IOAddress::fromBytes(AF_INET6, &bytes[0]));
 }
 
 IOAddress
@@ -37,10 +62,12 @@ IPRangePermutation::next(bool& done) {
         return (range_start_.isV4() ? IOAddress::IPV4_ZERO_ADDRESS() : IOAddress::IPV6_ZERO_ADDRESS());
     }
 
-    // If there is one address left, return this address.
+    // If there is one address left, return this address. It is not in the
+    // state when the range holds a single address.
     if (cursor_ == 0) {
         done = done_ = true;
-        return (state_.at(0));
+        auto last = state_.find(0);
+        return (last != state_.end() ? last->second : addressAt(0));
     }
 
     // We're not done.
@@ -50,7 +77,7 @@ IPRangePermutation::next(bool& done) {
     // addresses between the cursor and the end of the range have been already
     // returned by this function. Therefore we focus on the remaining cursor-1
     // addresses. Let's get random address from this sub-range.
-    std::uniform_int_distribution<int> dist(0, cursor_ - 1);
+    std::uniform_int_distribution<uint64_t> dist(0, cursor_ - 1);
     auto next_loc = dist(generator_);
 
     IOAddress next_loc_address = IOAddress::IPV4_ZERO_ADDRESS();
@@ -68,7 +95,7 @@ IPRangePermutation::next(bool& done) {
         // if the range is 192.0.2.1-192.0.2.10 and the picked random position is
         // 5, the address we get is 192.0.2.6. This random address will be later
         // returned to the caller.
-        next_loc_address = offsetAddress(range_start_, next_loc * step_);
+        next_loc_address = addressAt(next_loc);
     }
 
     // Let's get the address at cursor position in the same way.
@@ -77,7 +104,7 @@ IPRangePermutation::next(bool& done) {
     if (cursor_existing != state_.end()) {
         cursor_address = cursor_existing->second;
     } else {
-        cursor_address = offsetAddress(range_start_, cursor_ * step_);
+        cursor_address = addressAt(cursor_);
     }
 
     // Now we swap them.... in fact we don't swap because as an optimization
@@ -101,13 +101,20 @@ public:
 
 private:
 
+    /// @brief Returns the address or prefix at the given position.
+    ///
+    /// @param position position of the address or prefix in the range.
+    /// @return address or prefix at the position in the initial ordering.
+    asiolink::IOAddress addressAt(const uint64_t position) const;
+
     /// Beginning of the range.
     asiolink::IOAddress range_start_;
 
-    /// Distance between two neighboring addresses or delegated prefixes,
-    /// i.e. 1 for address range and delegated prefix size for delegated
-    /// prefixes.
-    uint64_t step_;
+    /// Base 2 logarithm of the distance between two neighboring addresses
+    /// or delegated prefixes, i.e. 0 for address range and 128 minus the
+    /// delegated length for delegated prefixes. The distance itself does
+    /// not fit in 64 bits for delegated prefixes shorter than /64.
+    uint8_t shift_;
 
     /// Keeps the position of the next address or prefix to be swapped with
     /// a randomly picked address or prefix from the range of 0..cursor-1. The
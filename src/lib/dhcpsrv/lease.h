@@ -176,6 +176,19 @@ struct Lease : public isc::data::UserContext, public isc::data::CfgToElement {
     /// belonging to this class.
     uint32_t state_;
 
+    /// @brief Subnet identifier the lease is counted under
+    ///
+    /// Set by the memfile backend when it counts the stored lease in its
+    /// lease statistics. A caller holding the stored lease object may
+    /// modify its subnet_id_ before updating it, so the lease must be
+    /// uncounted using this value instead.
+    SubnetID stats_subnet_id_;
+
+    /// @brief State the lease is counted under
+    ///
+    /// Set together with @ref stats_subnet_id_.
+    uint32_t stats_state_;
+
     /// @brief Convert Lease to Printable Form
     ///
     /// @return String form of the lease
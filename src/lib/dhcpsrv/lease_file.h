@@ -0,0 +1,81 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_FILE_H
+#define LEASE_FILE_H
+
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_file_stats.h>
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Interface of the files to which the Memfile backend appends
+/// lease updates.
+///
+/// The lease updates are written as CSV rows by the @c CSVLeaseFile4 and
+/// @c CSVLeaseFile6 classes or as binary records by the @c LeaseJournal4
+/// and @c LeaseJournal6 classes. The files are read back using the
+/// @c LeaseFileLoader which is parametrized with the concrete class.
+///
+/// @tparam LeaseType @c Lease4 or @c Lease6.
+template<typename LeaseType>
+class LeaseFile : public LeaseFileStats {
+public:
+
+    /// @brief Destructor.
+    virtual ~LeaseFile() {
+    }
+
+    /// @brief Opens the lease file, creating it if it doesn't exist.
+    ///
+    /// @param seek_to_end A boolean value which indicates if the input
+    /// position should be set to the end of file.
+    virtual void open(const bool seek_to_end = false) = 0;
+
+    /// @brief Closes the lease file.
+    virtual void close() = 0;
+
+    /// @brief Checks if the lease file exists.
+    virtual bool exists() const = 0;
+
+    /// @brief Returns the name of the lease file.
+    virtual std::string getFilename() const = 0;
+
+    /// @brief Appends the lease to the lease file.
+    ///
+    /// @param lease Lease to be written.
+    virtual void append(const LeaseType& lease) = 0;
+
+    /// @brief Checks if the lease file read needs to be converted
+    /// to the current schema.
+    virtual bool needsConversion() const = 0;
+
+    /// @brief Passes the buffered lease updates to the operating system.
+    virtual void flush() = 0;
+
+    /// @brief Forces the lease updates to the storage device.
+    virtual void sync() = 0;
+};
+
+/// @brief Interface of the DHCPv4 lease files.
+typedef LeaseFile<Lease4> LeaseFile4;
+
+/// @brief Pointer to a DHCPv4 lease file.
+typedef boost::shared_ptr<LeaseFile4> LeaseFile4Ptr;
+
+/// @brief Interface of the DHCPv6 lease files.
+typedef LeaseFile<Lease6> LeaseFile6;
+
+/// @brief Pointer to a DHCPv6 lease file.
+typedef boost::shared_ptr<LeaseFile6> LeaseFile6Ptr;
+
+} // namespace isc::dhcp
+} // namespace isc
+
+#endif // LEASE_FILE_H
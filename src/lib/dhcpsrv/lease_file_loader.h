@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,12 +9,21 @@
 
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/memfile_lease_storage.h>
+#include <util/stopwatch.h>
+#include <util/thread_pool.h>
 #include <util/versioned_csv_file.h>
 #include <dhcpsrv/sanity_checker.h>
 
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
 namespace isc {
 namespace dhcp {
 
@@ -35,7 +44,8 @@ namespace dhcp {
 ///
 /// The methods in this class are templated so as they can be used both
 /// with the @c Lease4Storage and @c Lease6Storage to process the DHCPv4
-/// and DHCPv6 leases respectively.
+/// and DHCPv6 leases respectively, and with the CSV lease files and the
+/// binary lease journals.
 ///
 class LeaseFileLoader {
 public:
@@ -43,7 +53,7 @@ public:
     /// @brief Load leases from the lease file into the specified storage.
     ///
     /// This method iterates over the entries in the lease file in the
-    /// CSV format, creates @c Lease4 or @c Lease6 objects and inserts
+    /// CSV or journal format, creates @c Lease4 or @c Lease6 objects and inserts
     /// them into the storage to which reference is specified as an
     /// argument. If there are multiple entries for the particular lease
     /// in the lease file the entries further in the lease file override
@@ -53,6 +63,13 @@ public:
     /// means that the particular lease was released and the method
     /// removes an existing lease from the container.
     ///
+    /// When more than one thread is specified, the rows of the file are
+    /// read in chunks of @c LOAD_CHUNK_SIZE rows by the calling thread
+    /// and parsed into leases by a pool of threads. The leases of each
+    /// chunk are inserted into the storage in the order of the rows by
+    /// the calling thread while the next chunk is parsed, so the result
+    /// is the same as loading the file on a single thread.
+    ///
     /// @param lease_file A reference to the @c CSVLeaseFile4 or
     /// @c CSVLeaseFile6 object representing the lease file. The file
     /// doesn't need to be open because the method re-opens the file.
@@ -67,8 +84,11 @@ public:
     /// One case when the file is not opened is when the server starts
     /// up, reads the leases in the file and then leaves the file open
     /// for writing future lease updates.
+    /// @param thread_count Number of threads parsing the leases. A value
+    /// of 0 or 1 (default) loads the file on the calling thread.
     /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
-    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4, @c CSVLeaseFile6,
+    /// @c LeaseJournal4 or @c LeaseJournal6.
     /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
     ///
     /// @throw isc::util::CSVFileError when the maximum number of errors
@@ -77,11 +97,14 @@ public:
              typename StorageType>
     static void load(LeaseFileType& lease_file, StorageType& storage,
                      const uint32_t max_errors = 0,
-                     const bool close_file_on_exit = true) {
+                     const bool close_file_on_exit = true,
+                     const size_t thread_count = 1) {
 
         LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_FILE_LOAD)
             .arg(lease_file.getFilename());
 
+        util::Stopwatch stopwatch;
+
         // Reopen the file, as we don't know whether the file is open
         // and we also don't know its current state.
         lease_file.close();
@@ -96,83 +119,42 @@ public:
             lease_checker.reset(new SanityChecker());
         }
 
-        boost::shared_ptr<LeaseObjectType> lease;
-        // Track the number of corrupted leases.
-        uint32_t errcnt = 0;
-        while (true) {
-            // Unable to parse the lease.
-            if (!lease_file.next(lease)) {
-                LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_LOAD_ROW_ERROR)
-                            .arg(lease_file.getReads())
-                            .arg(lease_file.getReadMsg());
-
-                // A value of 0 indicates that we don't return
-                // until the whole file is parsed, even if errors occur.
-                // Otherwise, check if we have exceeded the maximum number
-                // of errors and throw an exception if we have.
-                if (max_errors && (++errcnt > max_errors)) {
-                    // If we break parsing the CSV file because of too many
-                    // errors, it doesn't make sense to keep the file open.
-                    // This is because the caller wouldn't know where we
-                    // stopped parsing and where the internal file pointer
-                    // is. So, there are probably no cases when the caller
-                    // would continue to use the open file.
-                    lease_file.close();
-                    isc_throw(util::CSVFileError, "exceeded maximum number of"
-                              " failures " << max_errors << " to read a lease"
-                              " from the lease file "
-                              << lease_file.getFilename());
-                }
-                // Skip the corrupted lease.
-                continue;
-            }
-
-            // Lease was found and we successfully parsed it.
-            if (lease) {
-                LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL_DATA,
-                          DHCPSRV_MEMFILE_LEASE_LOAD)
-                    .arg(lease->toText());
-
-                if (lease_checker)  {
-                    // If the lease is insane the checker will reset the lease pointer.
-                    // As lease file is loaded during the configuration, we have
-                    // to use staging config, rather than current config for this
-                    // (false = staging).
-                    lease_checker->checkLease(lease, false);
-                    if (!lease) {
-                        continue;
-                    }
+        if (thread_count > 1) {
+            loadParallel<LeaseObjectType>(lease_file, storage, max_errors,
+                                          lease_checker.get(), thread_count);
+        } else {
+            boost::shared_ptr<LeaseObjectType> lease;
+            // Track the number of corrupted leases.
+            uint32_t errcnt = 0;
+            while (true) {
+                // Unable to parse the lease.
+                if (!lease_file.next(lease)) {
+                    handleReadError(lease_file, lease_file.getReads(),
+                                    max_errors, errcnt);
+                    // Skip the corrupted lease.
+                    continue;
                 }
 
-                // Check if this lease exists.
-                typename StorageType::iterator lease_it =
-                    storage.find(lease->addr_);
-                // The lease doesn't exist yet. Insert the lease if
-                // it has a positive valid lifetime.
-                if (lease_it == storage.end()) {
-                    if (lease->valid_lft_ > 0) {
-                        storage.insert(lease);
-                    }
-                } else {
-                    // The lease exists. If the new entry has a valid
-                    // lifetime of 0 it is an indication to remove the
-                    // existing entry. Otherwise, we update the lease.
-                    if (lease->valid_lft_ == 0) {
-                        storage.erase(lease_it);
-
-                    } else {
-                        // Use replace to re-index leases on update.
-                        storage.replace(lease_it, lease);
-                    }
-                }
-
-            } else {
                 // Being here means that we hit the end of file.
-                break;
+                if (!lease) {
+                    break;
+                }
 
+                // Lease was found and we successfully parsed it.
+                storeLease(lease, storage, lease_checker.get());
             }
         }
 
+        stopwatch.stop();
+        const uint64_t rows = lease_file.getReadLeases() + lease_file.getReadErrs();
+        const long elapsed = stopwatch.getLastMicroseconds();
+        LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_FILE_LOADED)
+            .arg(rows)
+            .arg(lease_file.getFilename())
+            .arg(stopwatch.logFormatLastDuration())
+            .arg(elapsed > 0 ? rows * 1000000 / elapsed : rows)
+            .arg(std::max(thread_count, static_cast<size_t>(1)));
+
         if (lease_file.needsConversion()) {
             LOG_WARN(dhcpsrv_logger,
                      (lease_file.getInputSchemaState()
@@ -188,6 +170,10 @@ public:
         }
     }
 
+    /// @brief Number of rows of the lease file parsed together when
+    /// the file is loaded by several threads.
+    static const size_t LOAD_CHUNK_SIZE = 4096;
+
     /// @brief Write leases from the storage into a lease file
     ///
     /// This method iterates over the @c Lease4 or @c Lease6 object in the
@@ -212,7 +198,8 @@ public:
     /// should be written.
     ///
     /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
-    /// @tparam LeaseFileType A @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4, @c CSVLeaseFile6,
+    /// @c LeaseJournal4 or @c LeaseJournal6.
     /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
     template<typename LeaseObjectType, typename LeaseFileType,
              typename StorageType>
@@ -238,6 +225,253 @@ public:
         // Close the file
         lease_file.close();
     }
+
+private:
+
+    /// @brief Rows of the lease file parsed together by several threads.
+    ///
+    /// @tparam LeasePtrType A @c Lease4Ptr or @c Lease6Ptr.
+    /// @tparam RowType Type of the rows read from the lease file.
+    template<typename LeasePtrType, typename RowType>
+    struct LoadChunk {
+        /// @brief Constructor.
+        LoadChunk() : first_row_(0), pending_(0) {
+        }
+
+        /// @brief Number of the first row of the chunk in the file.
+        uint32_t first_row_;
+
+        /// @brief Rows read from the lease file.
+        std::vector<RowType> rows_;
+
+        /// @brief Leases parsed from the rows, null for erroneous rows.
+        std::vector<LeasePtrType> leases_;
+
+        /// @brief Errors which occurred when parsing the rows.
+        std::vector<std::string> errors_;
+
+        /// @brief Number of threads still parsing the rows.
+        size_t pending_;
+
+        /// @brief Mutex protecting the number of pending threads.
+        std::mutex mutex_;
+
+        /// @brief Condition variable signaled when the rows are parsed.
+        std::condition_variable cv_;
+    };
+
+    /// @brief Load leases from the lease file using several threads.
+    ///
+    /// @param lease_file A reference to the @c CSVLeaseFile4 or
+    /// @c CSVLeaseFile6 object representing the open lease file.
+    /// @param storage A reference to the container to which leases
+    /// should be inserted.
+    /// @param max_errors Maximum number of corrupted leases in the
+    /// lease file or 0 to disable the limit check.
+    /// @param lease_checker Lease sanity checker or null.
+    /// @param thread_count Number of threads parsing the leases.
+    /// @tparam LeaseObjectType A @c Lease4 or @c Lease6.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4, @c CSVLeaseFile6,
+    /// @c LeaseJournal4 or @c LeaseJournal6.
+    /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
+    ///
+    /// @throw isc::util::CSVFileError when the maximum number of errors
+    /// has been exceeded.
+    template<typename LeaseObjectType, typename LeaseFileType,
+             typename StorageType>
+    static void loadParallel(LeaseFileType& lease_file, StorageType& storage,
+                             const uint32_t max_errors,
+                             SanityChecker* lease_checker,
+                             const size_t thread_count) {
+        typedef boost::shared_ptr<LeaseObjectType> LeasePtrType;
+        typedef typename LeaseFileType::RowType RowType;
+        typedef LoadChunk<LeasePtrType, RowType> LoadChunkType;
+        typedef boost::shared_ptr<LoadChunkType> LoadChunkPtr;
+
+        util::ThreadPool<std::function<void()> > pool;
+        pool.start(thread_count);
+
+        // Reads the next chunk of rows, returns null at the end of file.
+        uint32_t rows_read = 0;
+        bool eof = false;
+        auto read_chunk = [&lease_file, &rows_read, &eof]() {
+            LoadChunkPtr chunk(new LoadChunkType());
+            chunk->first_row_ = rows_read + 1;
+            chunk->rows_.reserve(LOAD_CHUNK_SIZE);
+            RowType row;
+            while (!eof && (chunk->rows_.size() < LOAD_CHUNK_SIZE)) {
+                if (!lease_file.nextRow(row)) {
+                    eof = true;
+                    break;
+                }
+                chunk->rows_.push_back(row);
+            }
+            rows_read += chunk->rows_.size();
+            if (chunk->rows_.empty()) {
+                chunk.reset();
+            }
+            return (chunk);
+        };
+
+        // Splits the rows of a chunk between the threads of the pool.
+        auto parse_chunk = [&lease_file, &pool, thread_count](LoadChunkPtr chunk) {
+            const size_t size = chunk->rows_.size();
+            const size_t slice = (size + thread_count - 1) / thread_count;
+            chunk->leases_.resize(size);
+            chunk->errors_.resize(size);
+            chunk->pending_ = (size + slice - 1) / slice;
+            for (size_t begin = 0; begin < size; begin += slice) {
+                const size_t end = std::min(begin + slice, size);
+                boost::shared_ptr<std::function<void()> > work(
+                    new std::function<void()>([&lease_file, chunk, begin, end]() {
+                    for (size_t i = begin; i < end; ++i) {
+                        try {
+                            chunk->leases_[i] = lease_file.readLease(chunk->rows_[i]);
+                        } catch (const std::exception& ex) {
+                            chunk->errors_[i] = ex.what();
+                        }
+                        // The row is no longer needed.
+                        chunk->rows_[i] = RowType();
+                    }
+                    std::lock_guard<std::mutex> lock(chunk->mutex_);
+                    if (--chunk->pending_ == 0) {
+                        chunk->cv_.notify_all();
+                    }
+                }));
+                pool.add(work);
+            }
+        };
+
+        // Track the number of corrupted leases.
+        uint32_t errcnt = 0;
+        LoadChunkPtr chunk = read_chunk();
+        if (chunk) {
+            parse_chunk(chunk);
+        }
+        while (chunk) {
+            // Read the next chunk while the current one is parsed.
+            LoadChunkPtr next = read_chunk();
+
+            {
+                std::unique_lock<std::mutex> lock(chunk->mutex_);
+                chunk->cv_.wait(lock, [&chunk]() {
+                    return (chunk->pending_ == 0);
+                });
+            }
+
+            if (next) {
+                parse_chunk(next);
+            }
+
+            // Store the leases of the current chunk, in the order of
+            // the rows, while the next one is parsed.
+            for (size_t i = 0; i < chunk->leases_.size(); ++i) {
+                lease_file.countRead(chunk->errors_[i]);
+                if (!chunk->leases_[i]) {
+                    handleReadError(lease_file, chunk->first_row_ + i,
+                                    max_errors, errcnt);
+                    continue;
+                }
+                storeLease(chunk->leases_[i], storage, lease_checker);
+            }
+
+            chunk = next;
+        }
+    }
+
+    /// @brief Inserts a lease read from the lease file into the storage.
+    ///
+    /// The lease replaces the lease with the same address in the storage.
+    /// If its valid lifetime is 0 the existing lease is removed instead.
+    ///
+    /// @param lease Lease read from the lease file.
+    /// @param storage A reference to the container to which leases
+    /// should be inserted.
+    /// @param lease_checker Lease sanity checker or null.
+    /// @tparam LeasePtrType A @c Lease4Ptr or @c Lease6Ptr.
+    /// @tparam StorageType A @c Lease4Storage or @c Lease6Storage.
+    template<typename LeasePtrType, typename StorageType>
+    static void storeLease(LeasePtrType lease, StorageType& storage,
+                           SanityChecker* lease_checker) {
+        LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL_DATA,
+                  DHCPSRV_MEMFILE_LEASE_LOAD)
+            .arg(lease->toText());
+
+        if (lease_checker)  {
+            // If the lease is insane the checker will reset the lease pointer.
+            // As lease file is loaded during the configuration, we have
+            // to use staging config, rather than current config for this
+            // (false = staging).
+            lease_checker->checkLease(lease, false);
+            if (!lease) {
+                return;
+            }
+        }
+
+        // Use the hashed index to look for existing leases.
+        auto& index = storage.template get<HashedAddressIndexTag>();
+
+        // Check if this lease exists.
+        auto lease_it = index.find(lease->addr_);
+        // The lease doesn't exist yet. Insert the lease if
+        // it has a positive valid lifetime.
+        if (lease_it == index.end()) {
+            if (lease->valid_lft_ > 0) {
+                internLeaseIdentifiers(storage, lease);
+                storage.insert(lease);
+            }
+        } else {
+            // The lease exists. If the new entry has a valid
+            // lifetime of 0 it is an indication to remove the
+            // existing entry. Otherwise, we update the lease.
+            if (lease->valid_lft_ == 0) {
+                index.erase(lease_it);
+
+            } else {
+                // Use replace to re-index leases on update.
+                internLeaseIdentifiers(storage, lease);
+                index.replace(lease_it, lease);
+            }
+        }
+    }
+
+    /// @brief Handles a row of the lease file which can't be parsed.
+    ///
+    /// @param lease_file A reference to the lease file.
+    /// @param row Number of the row in the lease file.
+    /// @param max_errors Maximum number of corrupted leases in the
+    /// lease file or 0 to disable the limit check.
+    /// @param [in,out] errcnt Number of corrupted leases.
+    /// @tparam LeaseFileType A @c CSVLeaseFile4, @c CSVLeaseFile6,
+    /// @c LeaseJournal4 or @c LeaseJournal6.
+    ///
+    /// @throw isc::util::CSVFileError when the maximum number of errors
+    /// has been exceeded.
+    template<typename LeaseFileType>
+    static void handleReadError(LeaseFileType& lease_file, const uint32_t row,
+                                const uint32_t max_errors, uint32_t& errcnt) {
+        LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_LEASE_LOAD_ROW_ERROR)
+                    .arg(row)
+                    .arg(lease_file.getReadMsg());
+
+        // A value of 0 indicates that we don't return
+        // until the whole file is parsed, even if errors occur.
+        // Otherwise, check if we have exceeded the maximum number
+        // of errors and throw an exception if we have.
+        if (max_errors && (++errcnt > max_errors)) {
+            // If we break parsing the CSV file because of too many
+            // errors, it doesn't make sense to keep the file open.
+            // This is because the caller wouldn't know where we
+            // stopped parsing and where the internal file pointer
+            // is. So, there are probably no cases when the caller
+            // would continue to use the open file.
+            lease_file.close();
+            isc_throw(util::CSVFileError, "exceeded maximum number of"
+                      " failures " << max_errors << " to read a lease"
+                      " from the lease file "
+                      << lease_file.getFilename());
+        }
+    }
 };
 
 }  // namespace dhcp
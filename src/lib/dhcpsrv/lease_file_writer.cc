@@ -0,0 +1,51 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/lease_file_writer.h>
+#include <exceptions/exceptions.h>
+
+namespace isc {
+namespace dhcp {
+
+const uint32_t LeaseWriteConfig::DEFAULT_INTERVAL;
+const uint32_t LeaseWriteConfig::DEFAULT_BATCH_SIZE;
+const uint32_t LeaseWriteConfig::DEFAULT_QUEUE_SIZE;
+
+LeaseWritePolicy
+LeaseWriteConfig::policyFromText(const std::string& policy) {
+    if (policy == "direct") {
+        return (LEASE_WRITE_DIRECT);
+    } else if (policy == "sync") {
+        return (LEASE_WRITE_SYNC);
+    } else if (policy == "group-commit") {
+        return (LEASE_WRITE_GROUP_COMMIT);
+    } else if (policy == "buffered") {
+        return (LEASE_WRITE_BUFFERED);
+    }
+    isc_throw(BadValue, "invalid lease file write policy '" << policy
+              << "', expected one of: direct, sync, group-commit, buffered");
+}
+
+std::string
+LeaseWriteConfig::policyToText(const LeaseWritePolicy& policy) {
+    switch (policy) {
+    case LEASE_WRITE_DIRECT:
+        return ("direct");
+    case LEASE_WRITE_SYNC:
+        return ("sync");
+    case LEASE_WRITE_GROUP_COMMIT:
+        return ("group-commit");
+    case LEASE_WRITE_BUFFERED:
+        return ("buffered");
+    default:
+        ;
+    }
+    return ("unknown");
+}
+
+} // namespace isc::dhcp
+} // namespace isc
@@ -0,0 +1,428 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_FILE_WRITER_H
+#define LEASE_FILE_WRITER_H
+
+#include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/lease_file.h>
+#include <stats/stats_mgr.h>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Policies of the writes of the lease updates to the lease file.
+enum LeaseWritePolicy {
+    /// The lease update is written by the caller and is left in the
+    /// operating system buffers.
+    LEASE_WRITE_DIRECT,
+    /// The lease update is written by the caller and forced to the
+    /// storage device before the caller proceeds.
+    LEASE_WRITE_SYNC,
+    /// The lease update is queued and written by the writer thread which
+    /// forces the lease updates to the storage device after a batch of
+    /// records is written or after the write interval elapses.
+    LEASE_WRITE_GROUP_COMMIT,
+    /// The lease update is queued and written by the writer thread and
+    /// is left in the operating system buffers.
+    LEASE_WRITE_BUFFERED
+};
+
+/// @brief Parameters of the writes of the lease updates to the lease file.
+struct LeaseWriteConfig {
+
+    /// @brief Default write interval in milliseconds.
+    static const uint32_t DEFAULT_INTERVAL = 10;
+
+    /// @brief Default number of records written between the syncs.
+    static const uint32_t DEFAULT_BATCH_SIZE = 100;
+
+    /// @brief Default maximum number of queued lease updates.
+    static const uint32_t DEFAULT_QUEUE_SIZE = 10000;
+
+    /// @brief Constructor.
+    ///
+    /// Sets the default values: the lease updates are written directly.
+    LeaseWriteConfig()
+        : policy_(LEASE_WRITE_DIRECT), interval_(DEFAULT_INTERVAL),
+          batch_size_(DEFAULT_BATCH_SIZE), queue_size_(DEFAULT_QUEUE_SIZE) {
+    }
+
+    /// @brief Checks if the lease updates are written by a writer thread.
+    bool writeBehind() const {
+        return ((policy_ == LEASE_WRITE_GROUP_COMMIT) ||
+                (policy_ == LEASE_WRITE_BUFFERED));
+    }
+
+    /// @brief Converts the name of a write policy to the policy.
+    ///
+    /// @param policy Name of the policy: "direct", "sync", "group-commit"
+    /// or "buffered".
+    ///
+    /// @return The write policy.
+    /// @throw BadValue if the name is not a valid policy name.
+    static LeaseWritePolicy policyFromText(const std::string& policy);
+
+    /// @brief Returns the name of a write policy.
+    ///
+    /// @param policy The write policy.
+    static std::string policyToText(const LeaseWritePolicy& policy);
+
+    /// @brief The write policy.
+    LeaseWritePolicy policy_;
+
+    /// @brief Maximum time in milliseconds the written lease updates
+    /// wait for the sync with the group commit policy.
+    uint32_t interval_;
+
+    /// @brief Number of records written between the syncs with the group
+    /// commit policy.
+    uint32_t batch_size_;
+
+    /// @brief Maximum number of queued lease updates. The callers wait
+    /// for the writer thread when the queue is full.
+    uint32_t queue_size_;
+};
+
+/// @brief Writes the lease updates to a lease file according to a
+/// write policy.
+///
+/// This class wraps a lease file used by the Memfile backend. With the
+/// "direct" and "sync" policies the lease updates are written by the
+/// caller, the latter also forcing each record to the storage device.
+/// With the "group-commit" and "buffered" policies the lease updates are
+/// copied to a bounded queue and written by a dedicated writer thread so
+/// the packet processing doesn't wait for the disk I/O. The writer thread
+/// takes all queued lease updates at once, writes them, and with the
+/// "group-commit" policy syncs the lease file when @c batch_size_ records
+/// are written or when @c interval_ milliseconds have elapsed since the
+/// first record not synced was written.
+///
+/// With the write-behind policies the lease updates are in memory before
+/// they are written, so the errors can't be reported to the caller: they
+/// are logged by the writer thread.
+///
+/// The writer thread is stopped when the lease file is closed, e.g. by
+/// the lease file cleanup, after the queued lease updates are written and
+/// synced, and is started again when the lease file is opened.
+///
+/// The writer thread sets the following statistics, where the prefix is
+/// e.g. "memfile-lease4":
+/// - prefix-write-queue-depth: number of lease updates taken from the
+///   queue by the last write,
+/// - prefix-write-latency: duration of the last write, including the
+///   flush and the sync.
+///
+/// @tparam LeaseType @c Lease4 or @c Lease6.
+template<typename LeaseType>
+class LeaseFileWriter : public LeaseFile<LeaseType> {
+public:
+
+    /// @brief Pointer to the wrapped lease file.
+    typedef boost::shared_ptr<LeaseFile<LeaseType> > LeaseFilePtr;
+
+    /// @brief Constructor.
+    ///
+    /// Starts the writer thread if the policy requires it.
+    ///
+    /// @param lease_file Open lease file to write the lease updates to.
+    /// @param config Write policy and its parameters.
+    /// @param stats_prefix Prefix of the names of the statistics.
+    LeaseFileWriter(const LeaseFilePtr& lease_file,
+                    const LeaseWriteConfig& config,
+                    const std::string& stats_prefix)
+        : lease_file_(lease_file), config_(config),
+          stats_prefix_(stats_prefix), mutex_(), cv_(), idle_cv_(),
+          queue_(), stopping_(false), busy_(false), file_mutex_(),
+          thread_() {
+        start();
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Writes the queued lease updates and stops the writer thread.
+    virtual ~LeaseFileWriter() {
+        stop();
+    }
+
+    /// @brief Opens the lease file and starts the writer thread.
+    ///
+    /// @param seek_to_end A boolean value which indicates if the input
+    /// position should be set to the end of file.
+    virtual void open(const bool seek_to_end = false) {
+        lease_file_->open(seek_to_end);
+        start();
+    }
+
+    /// @brief Writes the queued lease updates, stops the writer thread
+    /// and closes the lease file.
+    virtual void close() {
+        stop();
+        lease_file_->close();
+    }
+
+    /// @brief Checks if the lease file exists.
+    virtual bool exists() const {
+        return (lease_file_->exists());
+    }
+
+    /// @brief Returns the name of the lease file.
+    virtual std::string getFilename() const {
+        return (lease_file_->getFilename());
+    }
+
+    /// @brief Checks if the lease file read needs to be converted
+    /// to the current schema.
+    virtual bool needsConversion() const {
+        return (lease_file_->needsConversion());
+    }
+
+    /// @brief Writes or queues the lease update.
+    ///
+    /// When the queue is full the caller waits until the writer thread
+    /// takes the queued lease updates.
+    ///
+    /// @param lease Lease to be written.
+    virtual void append(const LeaseType& lease) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (thread_ && !stopping_) {
+                idle_cv_.wait(lock, [this]() {
+                    return (stopping_ || (queue_.size() < config_.queue_size_));
+                });
+                // The lease update is written directly if the writer thread
+                // is being stopped.
+                if (!stopping_) {
+                    queue_.push_back(lease);
+                    lock.unlock();
+                    cv_.notify_one();
+                    return;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> file_lock(file_mutex_);
+        lease_file_->append(lease);
+        if (config_.policy_ == LEASE_WRITE_SYNC) {
+            lease_file_->sync();
+        }
+    }
+
+    /// @brief Waits until the queued lease updates are written and passes
+    /// them to the operating system.
+    virtual void flush() {
+        waitIdle();
+        std::lock_guard<std::mutex> file_lock(file_mutex_);
+        lease_file_->flush();
+    }
+
+    /// @brief Waits until the queued lease updates are written and forces
+    /// them to the storage device.
+    virtual void sync() {
+        waitIdle();
+        std::lock_guard<std::mutex> file_lock(file_mutex_);
+        lease_file_->sync();
+    }
+
+    /// @brief Returns the write policy and its parameters.
+    const LeaseWriteConfig& getConfig() const {
+        return (config_);
+    }
+
+    /// @brief Returns the number of queued lease updates.
+    size_t getQueueSize() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return (queue_.size());
+    }
+
+private:
+
+    /// @brief Starts the writer thread if the policy requires it and it
+    /// is not running.
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!config_.writeBehind() || thread_) {
+            return;
+        }
+        stats::StatsMgr& stats_mgr = stats::StatsMgr::instance();
+        stats_mgr.setValue(stats_prefix_ + "-write-queue-depth",
+                           static_cast<int64_t>(0));
+        stats_mgr.setValue(stats_prefix_ + "-write-latency",
+                           stats::StatsDuration::zero());
+        stopping_ = false;
+        thread_ = boost::make_shared<std::thread>(&LeaseFileWriter::run, this);
+    }
+
+    /// @brief Stops the writer thread after the queued lease updates are
+    /// written.
+    void stop() {
+        boost::shared_ptr<std::thread> thread;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!thread_) {
+                return;
+            }
+            stopping_ = true;
+            thread = thread_;
+        }
+        cv_.notify_all();
+        thread->join();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        thread_.reset();
+        stopping_ = false;
+        idle_cv_.notify_all();
+    }
+
+    /// @brief Waits until the queue is empty and the writer thread is not
+    /// writing.
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this]() {
+            return (!thread_ || (queue_.empty() && !busy_));
+        });
+    }
+
+    /// @brief Body of the writer thread.
+    void run() {
+        typedef std::chrono::steady_clock Clock;
+        // Number of written records which are not synced.
+        size_t unsynced = 0;
+        // Time by which the written records must be synced.
+        Clock::time_point deadline;
+
+        for (;;) {
+            std::deque<LeaseType> batch;
+            bool stopping = false;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                auto ready = [this]() {
+                    return (stopping_ || !queue_.empty());
+                };
+                if (unsynced > 0) {
+                    cv_.wait_until(lock, deadline, ready);
+                } else {
+                    cv_.wait(lock, ready);
+                }
+                batch.swap(queue_);
+                stopping = stopping_;
+                busy_ = true;
+            }
+            // The callers waiting for room in the queue can proceed.
+            idle_cv_.notify_all();
+
+            Clock::time_point start = Clock::now();
+            if (!batch.empty() && (unsynced == 0)) {
+                deadline = start + std::chrono::milliseconds(config_.interval_);
+            }
+            unsynced += batch.size();
+            // With the group commit policy the written records are synced
+            // when enough of them are written, when the oldest of them
+            // waited long enough or when the writer thread is stopped.
+            bool sync = false;
+            if (config_.policy_ == LEASE_WRITE_GROUP_COMMIT) {
+                sync = ((unsynced > 0) &&
+                        (stopping || (unsynced >= config_.batch_size_) ||
+                         (start >= deadline)));
+            } else {
+                unsynced = 0;
+            }
+
+            if (!batch.empty() || sync) {
+                std::lock_guard<std::mutex> file_lock(file_mutex_);
+                for (auto const& lease : batch) {
+                    try {
+                        lease_file_->append(lease);
+                    } catch (const std::exception& ex) {
+                        LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_WRITE_FAILED)
+                            .arg(lease_file_->getFilename())
+                            .arg(ex.what());
+                    }
+                }
+                try {
+                    lease_file_->flush();
+                    if (sync) {
+                        lease_file_->sync();
+                    }
+                } catch (const std::exception& ex) {
+                    LOG_ERROR(dhcpsrv_logger, DHCPSRV_MEMFILE_WRITE_FAILED)
+                        .arg(lease_file_->getFilename())
+                        .arg(ex.what());
+                }
+                if (sync) {
+                    unsynced = 0;
+                }
+
+                stats::StatsMgr& stats_mgr = stats::StatsMgr::instance();
+                stats_mgr.setValue(stats_prefix_ + "-write-queue-depth",
+                                   static_cast<int64_t>(batch.size()));
+                stats_mgr.setValue(stats_prefix_ + "-write-latency",
+                                   std::chrono::duration_cast<
+                                       stats::StatsDuration>(Clock::now() - start));
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                busy_ = false;
+            }
+            idle_cv_.notify_all();
+
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    /// @brief The wrapped lease file.
+    LeaseFilePtr lease_file_;
+
+    /// @brief Write policy and its parameters.
+    LeaseWriteConfig config_;
+
+    /// @brief Prefix of the names of the statistics.
+    std::string stats_prefix_;
+
+    /// @brief Mutex protecting the queue and the state of the writer thread.
+    std::mutex mutex_;
+
+    /// @brief Condition variable signaled when lease updates are queued or
+    /// the writer thread is being stopped.
+    std::condition_variable cv_;
+
+    /// @brief Condition variable signaled when the writer thread takes the
+    /// queued lease updates or finishes writing them.
+    std::condition_variable idle_cv_;
+
+    /// @brief Queued lease updates.
+    std::deque<LeaseType> queue_;
+
+    /// @brief Indicates that the writer thread is being stopped.
+    bool stopping_;
+
+    /// @brief Indicates that the writer thread is writing lease updates.
+    bool busy_;
+
+    /// @brief Mutex serializing the accesses to the wrapped lease file.
+    std::mutex file_mutex_;
+
+    /// @brief The writer thread.
+    boost::shared_ptr<std::thread> thread_;
+};
+
+} // namespace isc::dhcp
+} // namespace isc
+
+#endif // LEASE_FILE_WRITER_H
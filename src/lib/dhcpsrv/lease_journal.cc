@@ -0,0 +1,748 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <cc/data.h>
+#include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/lease_journal.h>
+#include <util/io_utilities.h>
+
+#include <boost/crc.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Size of the buffer used to read the journal.
+const size_t READ_BUFFER_SIZE = 65536;
+
+/// @brief Size of the length and checksum preceding the lease data.
+const size_t RECORD_HEADER_SIZE = 8;
+
+/// @brief Computes the CRC-32 of the data.
+///
+/// @param data Pointer to the data.
+/// @param len Length of the data.
+uint32_t
+checksum(const void* data, const size_t len) {
+    boost::crc_32_type crc;
+    crc.process_bytes(data, len);
+    return (crc.checksum());
+}
+
+/// @brief Writes a 32-bit integer at the given position of the buffer.
+void
+writeUint32At(OutputBuffer& buf, const uint32_t value, const size_t pos) {
+    buf.writeUint16At(static_cast<uint16_t>(value >> 16), pos);
+    buf.writeUint16At(static_cast<uint16_t>(value), pos + sizeof(uint16_t));
+}
+
+/// @brief Writes a time value.
+void
+writeTime(OutputBuffer& buf, const time_t value) {
+    buf.writeUint64(static_cast<uint64_t>(value));
+}
+
+/// @brief Reads a time value.
+time_t
+readTime(InputBuffer& buf) {
+    uint64_t value = static_cast<uint64_t>(buf.readUint32()) << 32;
+    return (static_cast<time_t>(value | buf.readUint32()));
+}
+
+/// @brief Writes binary data preceded by its 16-bit length.
+///
+/// @throw isc::BadValue if the data is too long.
+void
+writeData16(OutputBuffer& buf, const void* data, const size_t len) {
+    if (len > std::numeric_limits<uint16_t>::max()) {
+        isc_throw(isc::BadValue, "unable to write " << len
+                  << " bytes long value to the lease journal");
+    }
+    buf.writeUint16(static_cast<uint16_t>(len));
+    if (len > 0) {
+        buf.writeData(data, len);
+    }
+}
+
+/// @brief Reads binary data preceded by its 16-bit length.
+std::vector<uint8_t>
+readData16(InputBuffer& buf) {
+    std::vector<uint8_t> data;
+    buf.readVector(data, buf.readUint16());
+    return (data);
+}
+
+/// @brief Writes the hostname.
+void
+writeHostname(OutputBuffer& buf, const std::string& hostname) {
+    writeData16(buf, hostname.c_str(), hostname.size());
+}
+
+/// @brief Reads the hostname.
+std::string
+readHostname(InputBuffer& buf) {
+    std::vector<uint8_t> hostname = readData16(buf);
+    return (std::string(hostname.begin(), hostname.end()));
+}
+
+/// @brief Writes the hardware address, which may be null.
+void
+writeHWAddr(OutputBuffer& buf, const isc::dhcp::HWAddrPtr& hwaddr) {
+    if (!hwaddr) {
+        buf.writeUint16(0);
+        buf.writeUint8(0);
+        buf.writeUint32(0);
+        return;
+    }
+    buf.writeUint16(hwaddr->htype_);
+    if (hwaddr->hwaddr_.size() > std::numeric_limits<uint8_t>::max()) {
+        isc_throw(isc::BadValue, "unable to write " << hwaddr->hwaddr_.size()
+                  << " bytes long hardware address to the lease journal");
+    }
+    buf.writeUint8(static_cast<uint8_t>(hwaddr->hwaddr_.size()));
+    if (!hwaddr->hwaddr_.empty()) {
+        buf.writeData(&hwaddr->hwaddr_[0], hwaddr->hwaddr_.size());
+    }
+    buf.writeUint32(hwaddr->source_);
+}
+
+/// @brief Reads the hardware address.
+///
+/// @return Pointer to the hardware address or null if it is empty.
+isc::dhcp::HWAddrPtr
+readHWAddr(InputBuffer& buf) {
+    uint16_t htype = buf.readUint16();
+    std::vector<uint8_t> data;
+    buf.readVector(data, buf.readUint8());
+    uint32_t source = buf.readUint32();
+    if (data.empty()) {
+        return (isc::dhcp::HWAddrPtr());
+    }
+    isc::dhcp::HWAddrPtr hwaddr(new isc::dhcp::HWAddr(data, htype));
+    hwaddr->source_ = source;
+    return (hwaddr);
+}
+
+/// @brief Writes the user context, which may be null.
+void
+writeContext(OutputBuffer& buf, const ConstElementPtr& ctx) {
+    if (!ctx) {
+        buf.writeUint32(0);
+        return;
+    }
+    const std::string text = ctx->str();
+    buf.writeUint32(static_cast<uint32_t>(text.size()));
+    buf.writeData(text.c_str(), text.size());
+}
+
+/// @brief Reads the user context.
+///
+/// @return Pointer to the user context or null.
+/// @throw isc::BadValue if the user context is not a JSON map.
+ConstElementPtr
+readContext(InputBuffer& buf) {
+    std::vector<uint8_t> data;
+    buf.readVector(data, buf.readUint32());
+    if (data.empty()) {
+        return (ConstElementPtr());
+    }
+    std::string user_context(data.begin(), data.end());
+    ConstElementPtr ctx = Element::fromJSON(user_context);
+    if (!ctx || (ctx->getType() != Element::map)) {
+        isc_throw(isc::BadValue, "user context '" << user_context
+                  << "' is not a JSON map");
+    }
+    return (ctx);
+}
+
+/// @brief Writes the FQDN flags.
+void
+writeFqdnFlags(OutputBuffer& buf, const bool fqdn_fwd, const bool fqdn_rev) {
+    buf.writeUint8((fqdn_fwd ? 1 : 0) | (fqdn_rev ? 2 : 0));
+}
+
+} // end of anonymous namespace
+
+namespace isc {
+namespace dhcp {
+
+const char LeaseJournal::MAGIC[8] = { 'K', 'E', 'A', 'L', 'J', 'R', 'N', 'L' };
+const uint8_t LeaseJournal::FORMAT_VERSION;
+const size_t LeaseJournal::HEADER_SIZE;
+const uint32_t LeaseJournal::MAX_RECORD_SIZE;
+const char* LeaseJournal::FILE_SUFFIX = ".journal";
+
+LeaseJournal::LeaseJournal(const std::string& filename, const uint8_t family)
+    : filename_(filename), family_(family), fd_(-1), read_offset_(0),
+      read_buf_(), read_buf_offset_(0), read_buf_pos_(0), read_msg_() {
+}
+
+LeaseJournal::~LeaseJournal() {
+    close();
+}
+
+void
+LeaseJournal::open(const bool seek_to_end) {
+    close();
+
+    fd_ = ::open(filename_.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC,
+                 0666);
+    if (fd_ < 0) {
+        isc_throw(LeaseJournalError, "unable to open lease journal '"
+                  << filename_ << "': " << strerror(errno));
+    }
+
+    try {
+        struct stat st;
+        if (fstat(fd_, &st) != 0) {
+            isc_throw(LeaseJournalError, "unable to get the size of lease journal '"
+                      << filename_ << "': " << strerror(errno));
+        }
+
+        off_t size = st.st_size;
+        if (size == 0) {
+            // New journal: write the header.
+            OutputBuffer header(HEADER_SIZE);
+            header.writeData(MAGIC, sizeof(MAGIC));
+            header.writeUint8(FORMAT_VERSION);
+            header.writeUint8(family_);
+            header.writeUint16(0);
+            if (write(fd_, header.getData(), header.getLength()) !=
+                static_cast<ssize_t>(header.getLength())) {
+                isc_throw(LeaseJournalError, "unable to write the header of"
+                          " lease journal '" << filename_ << "': "
+                          << strerror(errno));
+            }
+            size = HEADER_SIZE;
+
+        } else {
+            uint8_t header[HEADER_SIZE];
+            if ((pread(fd_, header, HEADER_SIZE, 0) !=
+                 static_cast<ssize_t>(HEADER_SIZE)) ||
+                (memcmp(header, MAGIC, sizeof(MAGIC)) != 0)) {
+                isc_throw(LeaseJournalError, "'" << filename_
+                          << "' is not a lease journal");
+            }
+            if (header[sizeof(MAGIC)] != FORMAT_VERSION) {
+                isc_throw(LeaseJournalError, "unsupported format version "
+                          << static_cast<int>(header[sizeof(MAGIC)])
+                          << " of lease journal '" << filename_ << "'");
+            }
+            if (header[sizeof(MAGIC) + 1] != family_) {
+                isc_throw(LeaseJournalError, "lease journal '" << filename_
+                          << "' holds DHCPv"
+                          << static_cast<int>(header[sizeof(MAGIC) + 1])
+                          << " leases");
+            }
+        }
+
+        read_offset_ = (seek_to_end ? size : static_cast<off_t>(HEADER_SIZE));
+        read_buf_.clear();
+        read_buf_pos_ = 0;
+        read_buf_offset_ = read_offset_;
+
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+void
+LeaseJournal::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    read_buf_.clear();
+    read_buf_pos_ = 0;
+}
+
+bool
+LeaseJournal::exists() const {
+    std::ifstream fs(filename_.c_str());
+    return (fs.good());
+}
+
+void
+LeaseJournal::sync() {
+    if (fd_ < 0) {
+        isc_throw(LeaseJournalError, "unable to sync lease journal '"
+                  << filename_ << "' which is not open");
+    }
+    if (fsync(fd_) != 0) {
+        isc_throw(LeaseJournalError, "unable to sync lease journal '"
+                  << filename_ << "': " << strerror(errno));
+    }
+}
+
+bool
+LeaseJournal::isJournal(const std::string& filename) {
+    std::ifstream fs(filename.c_str(), std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    if (!fs.read(magic, sizeof(magic))) {
+        return (false);
+    }
+    return (memcmp(magic, MAGIC, sizeof(MAGIC)) == 0);
+}
+
+bool
+LeaseJournal::useJournal(const std::string& filename) {
+    struct stat st;
+    if ((stat(filename.c_str(), &st) == 0) && (st.st_size > 0)) {
+        return (isJournal(filename));
+    }
+    const std::string suffix(FILE_SUFFIX);
+    return ((filename.size() > suffix.size()) &&
+            (filename.compare(filename.size() - suffix.size(), suffix.size(),
+                              suffix) == 0));
+}
+
+size_t
+LeaseJournal::readData(uint8_t* data, const size_t len) {
+    size_t copied = 0;
+    while (copied < len) {
+        if (read_buf_pos_ == read_buf_.size()) {
+            // Read ahead the data following the data in the buffer.
+            read_buf_offset_ += read_buf_.size();
+            read_buf_.resize(READ_BUFFER_SIZE);
+            read_buf_pos_ = 0;
+            ssize_t count;
+            do {
+                count = pread(fd_, &read_buf_[0], read_buf_.size(),
+                              read_buf_offset_);
+            } while ((count < 0) && (errno == EINTR));
+            if (count < 0) {
+                read_buf_.clear();
+                isc_throw(LeaseJournalError, "unable to read lease journal '"
+                          << filename_ << "': " << strerror(errno));
+            }
+            read_buf_.resize(count);
+            if (count == 0) {
+                break;
+            }
+        }
+        const size_t count = std::min(len - copied,
+                                      read_buf_.size() - read_buf_pos_);
+        memcpy(data + copied, &read_buf_[read_buf_pos_], count);
+        read_buf_pos_ += count;
+        copied += count;
+    }
+    return (copied);
+}
+
+bool
+LeaseJournal::readRecord(RowType& record) {
+    record.clear();
+    if (fd_ < 0) {
+        return (false);
+    }
+
+    uint8_t header[RECORD_HEADER_SIZE];
+    const size_t count = readData(header, RECORD_HEADER_SIZE);
+    if (count == 0) {
+        // End of the journal.
+        return (false);
+    }
+    if (count < RECORD_HEADER_SIZE) {
+        truncate(read_offset_, "incomplete record header");
+        return (false);
+    }
+
+    const uint32_t len = readUint32(header, sizeof(uint32_t));
+    if (len > MAX_RECORD_SIZE) {
+        std::ostringstream reason;
+        reason << "invalid record length " << len;
+        truncate(read_offset_, reason.str());
+        return (false);
+    }
+
+    // The record holds the checksum and the lease data.
+    record.resize(len + sizeof(uint32_t));
+    memcpy(&record[0], header + sizeof(uint32_t), sizeof(uint32_t));
+    if (readData(&record[sizeof(uint32_t)], len) < len) {
+        record.clear();
+        truncate(read_offset_, "incomplete record");
+        return (false);
+    }
+
+    read_offset_ += RECORD_HEADER_SIZE + len;
+    return (true);
+}
+
+void
+LeaseJournal::truncate(const off_t offset, const std::string& reason) {
+    LOG_WARN(dhcpsrv_logger, DHCPSRV_MEMFILE_JOURNAL_TRUNCATED)
+        .arg(filename_)
+        .arg(offset)
+        .arg(reason);
+
+    // Appended records must follow the last complete record.
+    if (ftruncate(fd_, offset) != 0) {
+        isc_throw(LeaseJournalError, "unable to truncate lease journal '"
+                  << filename_ << "': " << strerror(errno));
+    }
+    read_buf_.clear();
+    read_buf_pos_ = 0;
+    read_buf_offset_ = offset;
+}
+
+void
+LeaseJournal::appendRecord(OutputBuffer& record) {
+    if (fd_ < 0) {
+        isc_throw(LeaseJournalError, "unable to write to lease journal '"
+                  << filename_ << "' which is not open");
+    }
+
+    const size_t len = record.getLength() - RECORD_HEADER_SIZE;
+    if (len > MAX_RECORD_SIZE) {
+        isc_throw(LeaseJournalError, "unable to write " << len
+                  << " bytes long record to lease journal '" << filename_
+                  << "'");
+    }
+    const uint8_t* data = static_cast<const uint8_t*>(record.getData());
+    writeUint32At(record, len, 0);
+    writeUint32At(record, checksum(data + RECORD_HEADER_SIZE, len),
+                  sizeof(uint32_t));
+
+    // The file is open in append mode so the record is written at the
+    // end of the journal even if it has been truncated.
+    size_t written = 0;
+    while (written < record.getLength()) {
+        ssize_t count = write(fd_, data + written, record.getLength() - written);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            isc_throw(LeaseJournalError, "unable to write to lease journal '"
+                      << filename_ << "': " << strerror(errno));
+        }
+        written += count;
+    }
+}
+
+void
+LeaseJournal::startRecord(OutputBuffer& record) {
+    record.clear();
+    record.skip(RECORD_HEADER_SIZE);
+}
+
+InputBuffer
+LeaseJournal::getRecordData(const RowType& record) {
+    if (record.size() < sizeof(uint32_t)) {
+        isc_throw(BadValue, "record is too short");
+    }
+    const size_t len = record.size() - sizeof(uint32_t);
+    const uint8_t* data = &record[0] + sizeof(uint32_t);
+    if (readUint32(&record[0], sizeof(uint32_t)) != checksum(data, len)) {
+        isc_throw(BadValue, "record checksum mismatch");
+    }
+    return (InputBuffer(data, len));
+}
+
+LeaseJournal4::LeaseJournal4(const std::string& filename)
+    : LeaseJournal(filename, 4) {
+}
+
+void
+LeaseJournal4::open(const bool seek_to_end) {
+    LeaseJournal::open(seek_to_end);
+    clearStatistics();
+}
+
+std::string
+LeaseJournal4::getSchemaVersion() const {
+    return (boost::lexical_cast<std::string>(static_cast<int>(FORMAT_VERSION)));
+}
+
+void
+LeaseJournal4::append(const Lease4& lease) {
+    // Bump the number of write attempts
+    ++writes_;
+
+    if (((!lease.hwaddr_) || lease.hwaddr_->hwaddr_.empty()) &&
+        ((!lease.client_id_) || (lease.client_id_->getClientId().empty())) &&
+        (lease.state_ != Lease::STATE_DECLINED)) {
+        // Bump the error counter
+        ++write_errs_;
+
+        isc_throw(BadValue, "Lease4: " << lease.addr_.toText() << ", state: "
+                  << Lease::basicStatesToText(lease.state_)
+                  << " has neither hardware address or client id");
+    }
+
+    try {
+        OutputBuffer record(128);
+        startRecord(record);
+        record.writeUint32(lease.addr_.toUint32());
+        writeHWAddr(record, lease.hwaddr_);
+        if (lease.client_id_) {
+            const std::vector<uint8_t>& client_id = lease.client_id_->getClientId();
+            writeData16(record, &client_id[0], client_id.size());
+        } else {
+            writeData16(record, 0, 0);
+        }
+        record.writeUint32(lease.valid_lft_);
+        writeTime(record, lease.cltt_);
+        record.writeUint32(lease.subnet_id_);
+        writeFqdnFlags(record, lease.fqdn_fwd_, lease.fqdn_rev_);
+        writeHostname(record, lease.hostname_);
+        record.writeUint32(lease.state_);
+        writeContext(record, lease.getContext());
+
+        appendRecord(record);
+
+    } catch (const std::exception&) {
+        // Catch any errors so we can bump the error counter than rethrow it
+        ++write_errs_;
+        throw;
+    }
+
+    // Bump the number of leases written
+    ++write_leases_;
+}
+
+bool
+LeaseJournal4::next(Lease4Ptr& lease) {
+    RowType row;
+    if (!nextRow(row)) {
+        // End of the journal.
+        lease.reset();
+        return (true);
+    }
+
+    try {
+        lease = readLease(row);
+
+    } catch (const std::exception& ex) {
+        lease.reset();
+        countRead(ex.what());
+        return (false);
+    }
+
+    countRead("");
+    return (true);
+}
+
+bool
+LeaseJournal4::nextRow(RowType& row) {
+    // Bump the number of read attempts
+    ++reads_;
+
+    setReadMsg("success");
+    return (readRecord(row));
+}
+
+Lease4Ptr
+LeaseJournal4::readLease(const RowType& row) const {
+    InputBuffer data = getRecordData(row);
+
+    IOAddress addr(data.readUint32());
+    HWAddrPtr hwaddr = readHWAddr(data);
+    std::vector<uint8_t> client_id = readData16(data);
+    uint32_t valid_lft = data.readUint32();
+    time_t cltt = readTime(data);
+    SubnetID subnet_id = data.readUint32();
+    uint8_t fqdn_flags = data.readUint8();
+    std::string hostname = readHostname(data);
+    uint32_t state = data.readUint32();
+    ConstElementPtr ctx = readContext(data);
+
+    if (!hwaddr && client_id.empty() && (state != Lease::STATE_DECLINED)) {
+        isc_throw(BadValue, "Lease4: " << addr.toText() << ", state: "
+                  << Lease::basicStatesToText(state)
+                  << " has neither hardware address or client id");
+    }
+
+    Lease4Ptr lease(new Lease4(addr,
+                               hwaddr ? hwaddr : HWAddrPtr(new HWAddr()),
+                               client_id.empty() ? NULL : &client_id[0],
+                               client_id.size(),
+                               valid_lft,
+                               cltt,
+                               subnet_id,
+                               (fqdn_flags & 1) != 0,
+                               (fqdn_flags & 2) != 0,
+                               hostname));
+    lease->state_ = state;
+    if (ctx) {
+        lease->setContext(ctx);
+    }
+
+    return (lease);
+}
+
+void
+LeaseJournal4::countRead(const std::string& error) {
+    if (error.empty()) {
+        ++read_leases_;
+    } else {
+        ++read_errs_;
+        setReadMsg(error);
+    }
+}
+
+LeaseJournal6::LeaseJournal6(const std::string& filename)
+    : LeaseJournal(filename, 6) {
+}
+
+void
+LeaseJournal6::open(const bool seek_to_end) {
+    LeaseJournal::open(seek_to_end);
+    clearStatistics();
+}
+
+std::string
+LeaseJournal6::getSchemaVersion() const {
+    return (boost::lexical_cast<std::string>(static_cast<int>(FORMAT_VERSION)));
+}
+
+void
+LeaseJournal6::append(const Lease6& lease) {
+    // Bump the number of write attempts
+    ++writes_;
+
+    if (((!(lease.duid_)) || (*(lease.duid_) == DUID::EMPTY())) &&
+        (lease.state_ != Lease::STATE_DECLINED)) {
+        ++write_errs_;
+        isc_throw(BadValue, "Lease6: " << lease.addr_.toText() << ", state: "
+                  << Lease::basicStatesToText(lease.state_) << ", has no DUID");
+    }
+
+    try {
+        OutputBuffer record(128);
+        startRecord(record);
+        const std::vector<uint8_t>& addr = lease.addr_.toBytes();
+        record.writeData(&addr[0], addr.size());
+        const std::vector<uint8_t>& duid = (lease.duid_ ? lease.duid_->getDuid() :
+                                            DUID::EMPTY().getDuid());
+        writeData16(record, &duid[0], duid.size());
+        record.writeUint32(lease.valid_lft_);
+        writeTime(record, lease.cltt_);
+        record.writeUint32(lease.subnet_id_);
+        record.writeUint32(lease.preferred_lft_);
+        record.writeUint8(static_cast<uint8_t>(lease.type_));
+        record.writeUint32(lease.iaid_);
+        record.writeUint8(lease.prefixlen_);
+        writeFqdnFlags(record, lease.fqdn_fwd_, lease.fqdn_rev_);
+        writeHostname(record, lease.hostname_);
+        writeHWAddr(record, lease.hwaddr_);
+        record.writeUint32(lease.state_);
+        writeContext(record, lease.getContext());
+
+        appendRecord(record);
+
+    } catch (const std::exception&) {
+        // Catch any errors so we can bump the error counter than rethrow it
+        ++write_errs_;
+        throw;
+    }
+
+    // Bump the number of leases written
+    ++write_leases_;
+}
+
+bool
+LeaseJournal6::next(Lease6Ptr& lease) {
+    RowType row;
+    if (!nextRow(row)) {
+        // End of the journal.
+        lease.reset();
+        return (true);
+    }
+
+    try {
+        lease = readLease(row);
+
+    } catch (const std::exception& ex) {
+        lease.reset();
+        countRead(ex.what());
+        return (false);
+    }
+
+    countRead("");
+    return (true);
+}
+
+bool
+LeaseJournal6::nextRow(RowType& row) {
+    // Bump the number of read attempts
+    ++reads_;
+
+    setReadMsg("success");
+    return (readRecord(row));
+}
+
+Lease6Ptr
+LeaseJournal6::readLease(const RowType& row) const {
+    InputBuffer data = getRecordData(row);
+
+    uint8_t addr[16];
+    data.readData(addr, sizeof(addr));
+    std::vector<uint8_t> duid = readData16(data);
+    uint32_t valid_lft = data.readUint32();
+    time_t cltt = readTime(data);
+    SubnetID subnet_id = data.readUint32();
+    uint32_t preferred_lft = data.readUint32();
+    uint8_t type = data.readUint8();
+    if (type > Lease::TYPE_PD) {
+        isc_throw(BadValue, "invalid lease type " << static_cast<int>(type));
+    }
+    uint32_t iaid = data.readUint32();
+    uint8_t prefixlen = data.readUint8();
+    uint8_t fqdn_flags = data.readUint8();
+    std::string hostname = readHostname(data);
+    HWAddrPtr hwaddr = readHWAddr(data);
+    uint32_t state = data.readUint32();
+    ConstElementPtr ctx = readContext(data);
+
+    Lease6Ptr lease(new Lease6(static_cast<Lease::Type>(type),
+                               IOAddress::fromBytes(AF_INET6, addr),
+                               DuidPtr(new DUID(duid)),
+                               iaid, preferred_lft, valid_lft, subnet_id,
+                               (fqdn_flags & 1) != 0, (fqdn_flags & 2) != 0,
+                               hostname, hwaddr, prefixlen));
+    lease->cltt_ = cltt;
+    lease->updateCurrentExpirationTime();
+    lease->state_ = state;
+    if ((*lease->duid_ == DUID::EMPTY())
+        && lease->state_ != Lease::STATE_DECLINED) {
+        isc_throw(isc::BadValue, "The Empty DUID is"
+                  "only valid for declined leases");
+    }
+    if (ctx) {
+        lease->setContext(ctx);
+    }
+
+    return (lease);
+}
+
+void
+LeaseJournal6::countRead(const std::string& error) {
+    if (error.empty()) {
+        ++read_leases_;
+    } else {
+        ++read_errs_;
+        setReadMsg(error);
+    }
+}
+
+} // namespace isc::dhcp
+} // namespace isc
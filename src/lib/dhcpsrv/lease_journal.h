@@ -0,0 +1,434 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_JOURNAL_H
+#define LEASE_JOURNAL_H
+
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_file.h>
+#include <exceptions/exceptions.h>
+#include <util/buffer.h>
+#include <util/versioned_csv_file.h>
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Exception thrown when the lease journal can't be opened or
+/// written.
+class LeaseJournalError : public Exception {
+public:
+    LeaseJournalError(const char* file, size_t line, const char* what) :
+        isc::Exception(file, line, what) { };
+};
+
+/// @brief Binary append-only file holding lease updates.
+///
+/// The lease journal is an alternative to the CSV lease files which
+/// avoids formatting the leases as text when they are written and
+/// parsing the text when they are read. The file begins with a header
+/// holding the @c MAGIC string, the format version and the protocol
+/// version (4 or 6). The header is followed by records of the following
+/// format:
+/// - length of the lease data (4 bytes),
+/// - CRC-32 of the lease data (4 bytes),
+/// - lease data.
+///
+/// All integers are stored in network byte order. The records are
+/// appended with a single write so the journal can be read back as long
+/// as its writer didn't stop while appending the last record. When the
+/// journal is read, an incomplete record at the end of the journal is
+/// discarded and the journal is truncated after the last complete
+/// record, so as the next appended record is readable. Records which
+/// checksum doesn't match the lease data are reported as read errors.
+///
+/// This class implements the file management and the record framing.
+/// The @c LeaseJournal4 and @c LeaseJournal6 derived classes encode
+/// the leases in the records.
+class LeaseJournal {
+public:
+
+    /// @brief Type of the records read from the journal.
+    ///
+    /// The record holds the checksum followed by the lease data.
+    typedef std::vector<uint8_t> RowType;
+
+    /// @brief String at the beginning of the journal.
+    static const char MAGIC[8];
+
+    /// @brief Version of the journal format.
+    static const uint8_t FORMAT_VERSION = 1;
+
+    /// @brief Size of the journal header.
+    static const size_t HEADER_SIZE = 12;
+
+    /// @brief Maximum size of the lease data in a record.
+    static const uint32_t MAX_RECORD_SIZE = 1024 * 1024;
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the journal.
+    /// @param family Protocol version of the leases: 4 or 6.
+    LeaseJournal(const std::string& filename, const uint8_t family);
+
+    /// @brief Destructor.
+    ///
+    /// Closes the journal.
+    virtual ~LeaseJournal();
+
+    /// @brief Opens the journal.
+    ///
+    /// The journal is created with a header if it doesn't exist or is
+    /// empty. Otherwise, the header of the journal is checked.
+    ///
+    /// @param seek_to_end A boolean value which indicates if the records
+    /// of the journal are skipped.
+    ///
+    /// @throw LeaseJournalError if the journal can't be opened or the
+    /// header is invalid.
+    void open(const bool seek_to_end = false);
+
+    /// @brief Closes the journal.
+    void close();
+
+    /// @brief Checks if the journal exists.
+    bool exists() const;
+
+    /// @brief Forces the records of the journal to the storage device.
+    ///
+    /// @throw LeaseJournalError if the journal is not open or can't be
+    /// synced.
+    void sync();
+
+    /// @brief Returns the name of the journal.
+    std::string getFilename() const {
+        return (filename_);
+    }
+
+    /// @brief Returns the description of the last read error.
+    std::string getReadMsg() const {
+        return (read_msg_);
+    }
+
+    /// @brief Checks if the file is a lease journal.
+    ///
+    /// @param filename Name of the file.
+    ///
+    /// @return true if the file begins with the journal @c MAGIC.
+    static bool isJournal(const std::string& filename);
+
+    /// @brief Checks if the lease updates are to be appended to the file
+    /// as a lease journal.
+    ///
+    /// The format of a non-empty file is detected from its content. The
+    /// journal is used for new or empty files which name ends with
+    /// @c FILE_SUFFIX.
+    ///
+    /// @param filename Name of the file.
+    ///
+    /// @return true if the file is or is to be used as a lease journal.
+    static bool useJournal(const std::string& filename);
+
+    /// @brief Suffix of the names of the new lease files created as
+    /// lease journals.
+    static const char* FILE_SUFFIX;
+
+protected:
+
+    /// @brief Reads the next record of the journal.
+    ///
+    /// @param [out] record Checksum and lease data of the record.
+    ///
+    /// @return false at the end of the journal, true otherwise.
+    bool readRecord(RowType& record);
+
+    /// @brief Prepares a buffer to receive the lease data of a record.
+    ///
+    /// @param [out] record Buffer reserving the space for the length
+    /// and the checksum of the lease data.
+    static void startRecord(util::OutputBuffer& record);
+
+    /// @brief Appends a record to the journal.
+    ///
+    /// @param record Buffer prepared by @c startRecord followed by the
+    /// lease data. The length and the checksum are set by this function.
+    ///
+    /// @throw LeaseJournalError if the record can't be written.
+    void appendRecord(util::OutputBuffer& record);
+
+    /// @brief Returns the lease data of a record.
+    ///
+    /// @param record Record read from the journal.
+    ///
+    /// @return Buffer holding the lease data of the record.
+    /// @throw isc::BadValue if the checksum doesn't match the lease data.
+    static util::InputBuffer getRecordData(const RowType& record);
+
+    /// @brief Sets the description of the last read error.
+    ///
+    /// @param read_msg Description of the error.
+    void setReadMsg(const std::string& read_msg) {
+        read_msg_ = read_msg;
+    }
+
+private:
+
+    /// @brief Reads data from the journal at the read offset.
+    ///
+    /// @param [out] data Buffer receiving the data.
+    /// @param len Number of bytes to read.
+    ///
+    /// @return Number of bytes read, less than @c len at the end of the
+    /// journal.
+    size_t readData(uint8_t* data, const size_t len);
+
+    /// @brief Discards the end of the journal.
+    ///
+    /// @param offset Offset at which the journal is truncated.
+    /// @param reason Reason of the truncation.
+    void truncate(const off_t offset, const std::string& reason);
+
+    /// @brief Name of the journal.
+    std::string filename_;
+
+    /// @brief Protocol version of the leases.
+    uint8_t family_;
+
+    /// @brief File descriptor of the open journal or -1.
+    int fd_;
+
+    /// @brief Offset of the next record to read.
+    off_t read_offset_;
+
+    /// @brief Buffer holding the data read ahead.
+    std::vector<uint8_t> read_buf_;
+
+    /// @brief Offset in the journal of the data in the read buffer.
+    off_t read_buf_offset_;
+
+    /// @brief Position of the next byte to read in the read buffer.
+    size_t read_buf_pos_;
+
+    /// @brief Description of the last read error.
+    std::string read_msg_;
+};
+
+/// @brief Provides methods to access the journal with DHCPv4 leases.
+///
+/// The lease data of the DHCPv4 records holds, in this order: address,
+/// hardware address (type, length, value, source), client identifier
+/// (length, value), valid lifetime, cltt, subnet identifier, FQDN flags,
+/// hostname (length, value), state and user context (length, JSON text).
+class LeaseJournal4 : public LeaseJournal, public LeaseFile4 {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the journal.
+    LeaseJournal4(const std::string& filename);
+
+    /// @brief Opens the journal and clears the statistics.
+    ///
+    /// @param seek_to_end A boolean value which indicates if the records
+    /// of the journal are skipped.
+    virtual void open(const bool seek_to_end = false);
+
+    /// @brief Closes the journal.
+    virtual void close() {
+        LeaseJournal::close();
+    }
+
+    /// @brief Checks if the journal exists.
+    virtual bool exists() const {
+        return (LeaseJournal::exists());
+    }
+
+    /// @brief Returns the name of the journal.
+    virtual std::string getFilename() const {
+        return (LeaseJournal::getFilename());
+    }
+
+    /// @brief Appends the lease record to the journal.
+    ///
+    /// @param lease Structure representing a DHCPv4 lease.
+    /// @throw BadValue if the lease has no hardware address, no client id and
+    /// is not in STATE_DECLINED.
+    /// @throw LeaseJournalError if the record can't be written.
+    virtual void append(const Lease4& lease);
+
+    /// @brief The journal has a single schema so it never needs conversion.
+    virtual bool needsConversion() const {
+        return (false);
+    }
+
+    /// @brief The records are written unbuffered so this is a no-op.
+    virtual void flush() {
+    }
+
+    /// @brief Forces the records of the journal to the storage device.
+    virtual void sync() {
+        LeaseJournal::sync();
+    }
+
+    /// @brief Returns the state of the journal schema, always current.
+    util::VersionedCSVFile::InputSchemaState getInputSchemaState() const {
+        return (util::VersionedCSVFile::CURRENT);
+    }
+
+    /// @brief Returns the version of the journal schema.
+    std::string getSchemaVersion() const;
+
+    /// @brief Reads next lease from the journal.
+    ///
+    /// If this function hits an error during lease read, it sets the error
+    /// message which may be read using @c getReadMsg and returns false.
+    ///
+    /// @param [out] lease Pointer to the lease read from the journal or
+    /// NULL pointer if lease hasn't been read.
+    ///
+    /// @return Boolean value indicating that the new lease has been
+    /// read from the journal (if true), or that the error has occurred
+    /// (false).
+    bool next(Lease4Ptr& lease);
+
+    /// @brief Reads the next record of the journal without decoding it.
+    ///
+    /// @param [out] row Record read from the journal.
+    ///
+    /// @return false at the end of the journal, true otherwise.
+    bool nextRow(RowType& row);
+
+    /// @brief Creates a lease from a record of the journal.
+    ///
+    /// This function doesn't modify the object so it may be called by
+    /// several threads at the same time.
+    ///
+    /// @param row Record read from the journal.
+    ///
+    /// @return Pointer to the lease.
+    /// @throw isc::BadValue or other exception if the record doesn't hold
+    /// a valid lease.
+    Lease4Ptr readLease(const RowType& row) const;
+
+    /// @brief Accounts the result of decoding a record.
+    ///
+    /// @param error Error message or an empty string if the lease has
+    /// been read.
+    void countRead(const std::string& error);
+};
+
+/// @brief Provides methods to access the journal with DHCPv6 leases.
+///
+/// The lease data of the DHCPv6 records holds, in this order: address,
+/// DUID (length, value), valid lifetime, cltt, subnet identifier,
+/// preferred lifetime, lease type, IAID, prefix length, FQDN flags,
+/// hostname (length, value), hardware address (type, length, value,
+/// source), state and user context (length, JSON text).
+class LeaseJournal6 : public LeaseJournal, public LeaseFile6 {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param filename Name of the journal.
+    LeaseJournal6(const std::string& filename);
+
+    /// @brief Opens the journal and clears the statistics.
+    ///
+    /// @param seek_to_end A boolean value which indicates if the records
+    /// of the journal are skipped.
+    virtual void open(const bool seek_to_end = false);
+
+    /// @brief Closes the journal.
+    virtual void close() {
+        LeaseJournal::close();
+    }
+
+    /// @brief Checks if the journal exists.
+    virtual bool exists() const {
+        return (LeaseJournal::exists());
+    }
+
+    /// @brief Returns the name of the journal.
+    virtual std::string getFilename() const {
+        return (LeaseJournal::getFilename());
+    }
+
+    /// @brief Appends the lease record to the journal.
+    ///
+    /// @param lease Structure representing a DHCPv6 lease.
+    /// @throw BadValue if the lease to be written has an empty DUID and
+    /// its state is not STATE_DECLINED.
+    /// @throw LeaseJournalError if the record can't be written.
+    virtual void append(const Lease6& lease);
+
+    /// @brief The journal has a single schema so it never needs conversion.
+    virtual bool needsConversion() const {
+        return (false);
+    }
+
+    /// @brief The records are written unbuffered so this is a no-op.
+    virtual void flush() {
+    }
+
+    /// @brief Forces the records of the journal to the storage device.
+    virtual void sync() {
+        LeaseJournal::sync();
+    }
+
+    /// @brief Returns the state of the journal schema, always current.
+    util::VersionedCSVFile::InputSchemaState getInputSchemaState() const {
+        return (util::VersionedCSVFile::CURRENT);
+    }
+
+    /// @brief Returns the version of the journal schema.
+    std::string getSchemaVersion() const;
+
+    /// @brief Reads next lease from the journal.
+    ///
+    /// If this function hits an error during lease read, it sets the error
+    /// message which may be read using @c getReadMsg and returns false.
+    ///
+    /// @param [out] lease Pointer to the lease read from the journal or
+    /// NULL pointer if lease hasn't been read.
+    ///
+    /// @return Boolean value indicating that the new lease has been
+    /// read from the journal (if true), or that the error has occurred
+    /// (false).
+    bool next(Lease6Ptr& lease);
+
+    /// @brief Reads the next record of the journal without decoding it.
+    ///
+    /// @param [out] row Record read from the journal.
+    ///
+    /// @return false at the end of the journal, true otherwise.
+    bool nextRow(RowType& row);
+
+    /// @brief Creates a lease from a record of the journal.
+    ///
+    /// This function doesn't modify the object so it may be called by
+    /// several threads at the same time.
+    ///
+    /// @param row Record read from the journal.
+    ///
+    /// @return Pointer to the lease.
+    /// @throw isc::BadValue or other exception if the record doesn't hold
+    /// a valid lease.
+    Lease6Ptr readLease(const RowType& row) const;
+
+    /// @brief Accounts the result of decoding a record.
+    ///
+    /// @param error Error message or an empty string if the lease has
+    /// been read.
+    void countRead(const std::string& error);
+};
+
+} // namespace isc::dhcp
+} // namespace isc
+
+#endif // LEASE_JOURNAL_H
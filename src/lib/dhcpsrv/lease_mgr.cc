@@ -61,6 +61,62 @@ LeaseMgr::getLease6(Lease::Type type, const DUID& duid,
     return (*col.begin());
 }
 
+void
+LeaseMgr::applyLeaseChanges(LeaseChange4Collection& changes) {
+    for (auto& change : changes) {
+        applyLeaseChange(change);
+    }
+}
+
+void
+LeaseMgr::applyLeaseChanges(LeaseChange6Collection& changes) {
+    for (auto& change : changes) {
+        applyLeaseChange(change);
+    }
+}
+
+void
+LeaseMgr::applyLeaseChange(LeaseChange4& change) {
+    try {
+        switch (change.type_) {
+        case LeaseChange4::ADD:
+            change.applied_ = addLease(change.lease_);
+            break;
+        case LeaseChange4::UPDATE:
+            updateLease4(change.lease_);
+            change.applied_ = true;
+            break;
+        case LeaseChange4::DELETE:
+            change.applied_ = deleteLease(change.lease_);
+            break;
+        }
+    } catch (const std::exception& ex) {
+        change.applied_ = false;
+        change.error_ = ex.what();
+    }
+}
+
+void
+LeaseMgr::applyLeaseChange(LeaseChange6& change) {
+    try {
+        switch (change.type_) {
+        case LeaseChange6::ADD:
+            change.applied_ = addLease(change.lease_);
+            break;
+        case LeaseChange6::UPDATE:
+            updateLease6(change.lease_);
+            change.applied_ = true;
+            break;
+        case LeaseChange6::DELETE:
+            change.applied_ = deleteLease(change.lease_);
+            break;
+        }
+    } catch (const std::exception& ex) {
+        change.applied_ = false;
+        change.error_ = ex.what();
+    }
+}
+
 void
 LeaseMgr::recountLeaseStats4() {
     using namespace stats;
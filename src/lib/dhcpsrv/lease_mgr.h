@@ -209,6 +209,63 @@ typedef boost::shared_ptr<LeaseStatsQuery> LeaseStatsQueryPtr;
 /// @brief Defines a pointer to a LeaseStatsRow.
 typedef boost::shared_ptr<LeaseStatsRow> LeaseStatsRowPtr;
 
+/// @brief A single change of a lease applied in a batch.
+///
+/// A collection of changes is passed to @c LeaseMgr::applyLeaseChanges
+/// which applies them in order and records the outcome of each change
+/// in the @c applied_ and @c error_ members.
+///
+/// @tparam LeasePtrType Type of the pointer to the lease (@c Lease4Ptr
+/// or @c Lease6Ptr).
+template<typename LeasePtrType>
+struct LeaseChange {
+    /// @brief Type of the change.
+    enum Type {
+        ADD,    ///< Add the lease, as with @c LeaseMgr::addLease.
+        UPDATE, ///< Update the lease, as with @c LeaseMgr::updateLease4/6.
+        DELETE  ///< Delete the lease, as with @c LeaseMgr::deleteLease.
+    };
+
+    /// @brief Constructor.
+    ///
+    /// @param type Type of the change.
+    /// @param lease Pointer to the lease to be added, updated or deleted.
+    LeaseChange(const Type type, const LeasePtrType& lease)
+        : type_(type), lease_(lease), applied_(false), error_() {
+    }
+
+    /// @brief Type of the change.
+    Type type_;
+
+    /// @brief Pointer to the lease.
+    LeasePtrType lease_;
+
+    /// @brief Result of the change.
+    ///
+    /// Set to true when the lease was added, updated or deleted. Set to
+    /// false when the lease to be added already exists or the lease to be
+    /// deleted does not exist, or when the change has failed.
+    bool applied_;
+
+    /// @brief Error message when the change has failed.
+    ///
+    /// Holds the message of the exception thrown when applying the change,
+    /// e.g. when the lease to be updated does not exist. Empty otherwise.
+    std::string error_;
+};
+
+/// @brief A change of a DHCPv4 lease.
+typedef LeaseChange<Lease4Ptr> LeaseChange4;
+
+/// @brief A collection of changes of DHCPv4 leases.
+typedef std::vector<LeaseChange4> LeaseChange4Collection;
+
+/// @brief A change of a DHCPv6 lease.
+typedef LeaseChange<Lease6Ptr> LeaseChange6;
+
+/// @brief A collection of changes of DHCPv6 leases.
+typedef std::vector<LeaseChange6> LeaseChange6Collection;
+
 /// @brief Abstract Lease Manager
 ///
 /// This is an abstract API for lease database backends. It provides unified
@@ -563,6 +620,28 @@ public:
     ///        failed.
     virtual bool deleteLease(const Lease6Ptr& lease) = 0;
 
+    /// @brief Applies a batch of changes of DHCPv4 leases.
+    ///
+    /// The changes are applied in order. The outcome of each change is
+    /// recorded in the change itself: errors are reported through the
+    /// @c LeaseChange::error_ member rather than thrown, so a failure of
+    /// one change does not prevent the other changes from being applied.
+    ///
+    /// The default implementation applies the changes one by one using
+    /// @c addLease, @c updateLease4 and @c deleteLease. Backends override
+    /// it to apply the whole batch at a lower cost, e.g. within a single
+    /// database transaction.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    virtual void applyLeaseChanges(LeaseChange4Collection& changes);
+
+    /// @brief Applies a batch of changes of DHCPv6 leases.
+    ///
+    /// See @c applyLeaseChanges(LeaseChange4Collection&) for details.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    virtual void applyLeaseChanges(LeaseChange6Collection& changes);
+
     /// @brief Deletes all expired and reclaimed DHCPv4 leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
@@ -761,6 +840,21 @@ public:
     /// support transactions, this is a no-op.
     virtual void rollback() = 0;
 
+protected:
+
+    /// @brief Applies a single change of a DHCPv4 lease.
+    ///
+    /// Used by the default implementation of @c applyLeaseChanges and by
+    /// the backends which fall back to it. Exceptions thrown while applying
+    /// the change are caught and their message is stored in the change.
+    ///
+    /// @param [in,out] change The change to be applied.
+    void applyLeaseChange(LeaseChange4& change);
+
+    /// @brief Applies a single change of a DHCPv6 lease.
+    ///
+    /// @param [in,out] change The change to be applied.
+    void applyLeaseChange(LeaseChange6& change);
 };
 
 }  // namespace dhcp
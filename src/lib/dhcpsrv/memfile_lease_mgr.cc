@@ -7,20 +7,24 @@
 #include <config.h>
 #include <database/database_connection.h>
 #include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/cfg_multi_threading.h>
 #include <dhcpsrv/dhcpsrv_exceptions.h>
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/lease_file_loader.h>
 #include <dhcpsrv/memfile_lease_mgr.h>
 #include <dhcpsrv/timer_mgr.h>
 #include <exceptions/exceptions.h>
+#include <stats/stats_mgr.h>
 #include <util/multi_threading_mgr.h>
 #include <util/pid_file.h>
 #include <util/process_spawn.h>
 #include <util/signal_set.h>
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <errno.h>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <sstream>
 
@@ -35,10 +39,53 @@ namespace {
 /// Kea installation directory.
 const char* KEA_LFC_EXECUTABLE_ENV_NAME = "KEA_LFC_EXECUTABLE";
 
+/// @brief Sorts leases by address.
+///
+/// The leases sharing the same key in a hashed index are retrieved in
+/// an unspecified order. They are sorted so the returned collections do
+/// not depend on the order in which the leases were added.
+///
+/// @tparam LeaseCollectionType Type of the collection: @c Lease4Collection
+/// or @c Lease6Collection.
+/// @param collection leases to be sorted.
+template<typename LeaseCollectionType>
+void sortLeasesByAddress(LeaseCollectionType& collection) {
+    std::sort(collection.begin(), collection.end(),
+              [](const typename LeaseCollectionType::value_type& first,
+                 const typename LeaseCollectionType::value_type& second) {
+                  return (first->addr_ < second->addr_);
+              });
+}
+
+/// @brief Returns the lease with the lowest address in the subnet.
+///
+/// It is used to select a single lease among the leases sharing the
+/// same key in a hashed index.
+///
+/// @tparam Iterator Type of the index iterator.
+/// @param first beginning of the range of leases.
+/// @param last end of the range of leases.
+/// @param subnet_id subnet identifier.
+/// @return the lease or null pointer if no lease belongs to the subnet.
+template<typename Iterator>
+typename std::iterator_traits<Iterator>::value_type
+getLowestAddressLease(Iterator first, Iterator last,
+                      const isc::dhcp::SubnetID& subnet_id) {
+    typename std::iterator_traits<Iterator>::value_type lowest;
+    for (auto lease = first; lease != last; ++lease) {
+        if (((*lease)->subnet_id_ == subnet_id) &&
+            (!lowest || ((*lease)->addr_ < lowest->addr_))) {
+            lowest = *lease;
+        }
+    }
+    return (lowest);
+}
+
 }  // namespace
 
 using namespace isc::asiolink;
 using namespace isc::db;
+using namespace isc::stats;
 using namespace isc::util;
 
 namespace isc {
@@ -87,8 +134,8 @@ public:
     /// regardless of the value of lfc_interval.  This is primarily used to
     /// cause lease file schema upgrades upon startup.
     void setup(const uint32_t lfc_interval,
-               const boost::shared_ptr<CSVLeaseFile4>& lease_file4,
-               const boost::shared_ptr<CSVLeaseFile6>& lease_file6,
+               const LeaseFile4Ptr& lease_file4,
+               const LeaseFile6Ptr& lease_file6,
                bool run_once_now = false);
 
     /// @brief Spawns a new process.
@@ -151,8 +198,8 @@ LFCSetup::~LFCSetup() {
 
 void
 LFCSetup::setup(const uint32_t lfc_interval,
-                const boost::shared_ptr<CSVLeaseFile4>& lease_file4,
-                const boost::shared_ptr<CSVLeaseFile6>& lease_file6,
+                const LeaseFile4Ptr& lease_file4,
+                const LeaseFile6Ptr& lease_file6,
                 bool run_once_now) {
 
     // If to nothing to do, punt
@@ -309,6 +356,27 @@ public:
     }
 
 protected:
+    /// @brief Selects the lease counters of the queried subnets
+    ///
+    /// @param counters The counters of the lease storage.
+    /// @return Pair of iterators delimiting the counters of the queried
+    /// subnets.
+    std::pair<LeaseStatsCounters::CounterMap::const_iterator,
+              LeaseStatsCounters::CounterMap::const_iterator>
+    selectCounters(const LeaseStatsCounters& counters) const {
+        switch (getSelectMode()) {
+        case SINGLE_SUBNET:
+            return (counters.getRange(getFirstSubnetID(), getFirstSubnetID()));
+
+        case SUBNET_RANGE:
+            return (counters.getRange(getFirstSubnetID(), getLastSubnetID()));
+
+        default:
+            return (std::make_pair(counters.getAll().begin(),
+                                   counters.getAll().end()));
+        }
+    }
+
     /// @brief A vector containing the "result set"
     std::vector<LeaseStatsRow> rows_;
 
@@ -319,37 +387,39 @@ protected:
 /// @brief Memfile derivation of the IPv4 statistical lease data query
 ///
 /// This class is used to recalculate IPv4 lease statistics for Memfile
-/// lease storage.  It does so by iterating over the given storage,
-/// accumulating counts of leases in each of the monitored lease states
-/// for each subnet and storing these counts in an internal collection.
-/// The populated result set will contain one entry per monitored state
-/// per subnet.
+/// lease storage.  It does so by copying the lease counters maintained
+/// by the backend for the monitored lease states of each subnet into
+/// an internal collection. The populated result set will contain one
+/// entry per monitored state per subnet.
 ///
 class MemfileLeaseStatsQuery4 : public MemfileLeaseStatsQuery {
 public:
     /// @brief Constructor for an all subnets query
     ///
-    /// @param storage4 A pointer to the v4 lease storage to be counted
-    MemfileLeaseStatsQuery4(Lease4Storage& storage4)
-        : MemfileLeaseStatsQuery(), storage4_(storage4) {
+    /// @param counters4 The counters of the v4 lease storage
+    MemfileLeaseStatsQuery4(const LeaseStatsCounters& counters4)
+        : MemfileLeaseStatsQuery(), counters4_(counters4) {
     };
 
     /// @brief Constructor for a single subnet query
     ///
-    /// @param storage4 A pointer to the v4 lease storage to be counted
+    /// @param counters4 The counters of the v4 lease storage
     /// @param subnet_id ID of the desired subnet
-    MemfileLeaseStatsQuery4(Lease4Storage& storage4, const SubnetID& subnet_id)
-        : MemfileLeaseStatsQuery(subnet_id), storage4_(storage4) {
+    MemfileLeaseStatsQuery4(const LeaseStatsCounters& counters4,
+                            const SubnetID& subnet_id)
+        : MemfileLeaseStatsQuery(subnet_id), counters4_(counters4) {
     };
 
     /// @brief Constructor for a subnet range query
     ///
-    /// @param storage4 A pointer to the v4 lease storage to be counted
+    /// @param counters4 The counters of the v4 lease storage
     /// @param first_subnet_id ID of the first subnet in the desired range
     /// @param last_subnet_id ID of the last subnet in the desired range
-    MemfileLeaseStatsQuery4(Lease4Storage& storage4, const SubnetID& first_subnet_id,
+    MemfileLeaseStatsQuery4(const LeaseStatsCounters& counters4,
+                            const SubnetID& first_subnet_id,
                             const SubnetID& last_subnet_id)
-        : MemfileLeaseStatsQuery(first_subnet_id, last_subnet_id), storage4_(storage4) {
+        : MemfileLeaseStatsQuery(first_subnet_id, last_subnet_id),
+          counters4_(counters4) {
     };
 
     /// @brief Destructor
@@ -357,141 +427,71 @@ public:
 
     /// @brief Creates the IPv4 lease statistical data result set
     ///
-    /// The result set is populated by iterating over the IPv4 leases in
-    /// storage, in ascending order by address, accumulating the lease state
-    /// counts per subnet.
-    /// At the completion of all entries for a given subnet, the counts are
-    /// used to create LeaseStatsRow instances which are appended to an
-    /// internal vector.  The process results in a vector containing one entry
-    /// per state per subnet.
+    /// The result set is populated from the lease counters of the
+    /// selected subnets, in ascending order by subnet id. The process
+    /// results in a vector containing one entry per state per subnet.
     ///
     /// Currently the states counted are:
     ///
     /// - Lease::STATE_DEFAULT (i.e. assigned)
     /// - Lease::STATE_DECLINED
     void start() {
-        const Lease4StorageSubnetIdIndex& idx
-            = storage4_.get<SubnetIdIndexTag>();
-
-        // Set lower and upper bounds based on select mode
-        Lease4StorageSubnetIdIndex::const_iterator lower;
-        Lease4StorageSubnetIdIndex::const_iterator upper;
-        switch (getSelectMode()) {
-        case ALL_SUBNETS:
-            lower = idx.begin();
-            upper = idx.end();
-            break;
-
-        case SINGLE_SUBNET:
-            lower = idx.lower_bound(getFirstSubnetID());
-            upper = idx.upper_bound(getFirstSubnetID());
-            break;
-
-        case SUBNET_RANGE:
-            lower = idx.lower_bound(getFirstSubnetID());
-            upper = idx.upper_bound(getLastSubnetID());
-            break;
-        }
-
-        // Return an empty set if there are no rows.
-        if (lower == upper) {
-            return;
-        }
-
-        // Iterate over the leases in order by subnet, accumulating per
-        // subnet counts for each state of interest.  As we finish each
-        // subnet, add the appropriate rows to our result set.
-        SubnetID cur_id = 0;
-        int64_t assigned = 0;
-        int64_t declined = 0;
-        for (Lease4StorageSubnetIdIndex::const_iterator lease = lower;
-             lease != upper; ++lease) {
-            // If we've hit the next subnet, add rows for the current subnet
-            // and wipe the accumulators
-            if ((*lease)->subnet_id_ != cur_id) {
-                if (cur_id > 0) {
-                    if (assigned > 0) {
-                        rows_.push_back(LeaseStatsRow(cur_id,
-                                                      Lease::STATE_DEFAULT,
-                                                      assigned));
-                        assigned = 0;
-                    }
-
-                    if (declined > 0) {
-                        rows_.push_back(LeaseStatsRow(cur_id,
-                                                      Lease::STATE_DECLINED,
-                                                      declined));
-                        declined = 0;
-                    }
-                }
-
-                // Update current subnet id
-                cur_id = (*lease)->subnet_id_;
-            }
-
-            // Bump the appropriate accumulator
-            if ((*lease)->state_ == Lease::STATE_DEFAULT) {
-                ++assigned;
-            } else if ((*lease)->state_ == Lease::STATE_DECLINED) {
-                ++declined;
+        auto range = selectCounters(counters4_);
+        for (auto counter = range.first; counter != range.second; ++counter) {
+            uint32_t state = std::get<2>(counter->first);
+            if ((state == Lease::STATE_DEFAULT) ||
+                (state == Lease::STATE_DECLINED)) {
+                rows_.push_back(LeaseStatsRow(std::get<0>(counter->first),
+                                              state, counter->second));
             }
         }
 
-        // Make the rows for last subnet
-        if (assigned > 0) {
-            rows_.push_back(LeaseStatsRow(cur_id, Lease::STATE_DEFAULT,
-                                          assigned));
-        }
-
-        if (declined > 0) {
-            rows_.push_back(LeaseStatsRow(cur_id, Lease::STATE_DECLINED,
-                                          declined));
-        }
-
         // Reset the next row position back to the beginning of the rows.
         next_pos_ = rows_.begin();
     }
 
 private:
-    /// @brief The Memfile storage containing the IPv4 leases to analyze
-    Lease4Storage& storage4_;
+    /// @brief The counters of the Memfile storage containing the IPv4 leases
+    const LeaseStatsCounters& counters4_;
 };
 
 
 /// @brief Memfile derivation of the IPv6 statistical lease data query
 ///
 /// This class is used to recalculate IPv6 lease statistics for Memfile
-/// lease storage.  It does so by iterating over the given storage,
-/// accumulating counts of leases in each of the monitored lease states
-/// for each subnet and storing these counts in an internal collection.
-/// The populated result set will contain one entry per monitored state
-/// per subnet.
+/// lease storage.  It does so by copying the lease counters maintained
+/// by the backend for the monitored lease states of each subnet into
+/// an internal collection. The populated result set will contain one
+/// entry per monitored state per lease type per subnet.
 ///
 class MemfileLeaseStatsQuery6 : public MemfileLeaseStatsQuery {
 public:
     /// @brief Constructor
     ///
-    /// @param storage6 A pointer to the v6 lease storage to be counted
-    MemfileLeaseStatsQuery6(Lease6Storage& storage6)
-        : MemfileLeaseStatsQuery(), storage6_(storage6) {
+    /// @param counters6 The counters of the v6 lease storage
+    MemfileLeaseStatsQuery6(const LeaseStatsCounters& counters6)
+        : MemfileLeaseStatsQuery(), counters6_(counters6) {
     };
 
     /// @brief Constructor for a single subnet query
     ///
-    /// @param storage6 A pointer to the v6 lease storage to be counted
+    /// @param counters6 The counters of the v6 lease storage
     /// @param subnet_id ID of the desired subnet
-    MemfileLeaseStatsQuery6(Lease6Storage& storage6, const SubnetID& subnet_id)
-        : MemfileLeaseStatsQuery(subnet_id), storage6_(storage6) {
+    MemfileLeaseStatsQuery6(const LeaseStatsCounters& counters6,
+                            const SubnetID& subnet_id)
+        : MemfileLeaseStatsQuery(subnet_id), counters6_(counters6) {
     };
 
     /// @brief Constructor for a subnet range query
     ///
-    /// @param storage6 A pointer to the v6 lease storage to be counted
+    /// @param counters6 The counters of the v6 lease storage
     /// @param first_subnet_id ID of the first subnet in the desired range
     /// @param last_subnet_id ID of the last subnet in the desired range
-    MemfileLeaseStatsQuery6(Lease6Storage& storage6, const SubnetID& first_subnet_id,
+    MemfileLeaseStatsQuery6(const LeaseStatsCounters& counters6,
+                            const SubnetID& first_subnet_id,
                             const SubnetID& last_subnet_id)
-        : MemfileLeaseStatsQuery(first_subnet_id, last_subnet_id), storage6_(storage6) {
+        : MemfileLeaseStatsQuery(first_subnet_id, last_subnet_id),
+          counters6_(counters6) {
     };
 
     /// @brief Destructor
@@ -499,129 +499,38 @@ public:
 
     /// @brief Creates the IPv6 lease statistical data result set
     ///
-    /// The result set is populated by iterating over the IPv6 leases in
-    /// storage, in ascending order by subnet id, accumulating the lease state
-    /// counts per subnet. At the completion of all entries for a given subnet,
-    /// the counts are used to create LeaseStatsRow instances which are appended
-    /// to an internal vector.  The process results in a vector containing one
-    /// entry per state per lease type per subnet.
+    /// The result set is populated from the lease counters of the
+    /// selected subnets, in ascending order by subnet id. The process
+    /// results in a vector containing one entry per state per lease type
+    /// per subnet.
     ///
     /// Currently the states counted are:
     ///
-    /// - Lease::STATE_DEFAULT (i.e. assigned)
-    /// - Lease::STATE_DECLINED
+    /// - Lease::STATE_DEFAULT (i.e. assigned) of NA and PD leases
+    /// - Lease::STATE_DECLINED of NA leases
     virtual void start() {
-        // Get the subnet_id index
-        const Lease6StorageSubnetIdIndex& idx
-            = storage6_.get<SubnetIdIndexTag>();
-
-        // Set lower and upper bounds based on select mode
-        Lease6StorageSubnetIdIndex::const_iterator lower;
-        Lease6StorageSubnetIdIndex::const_iterator upper;
-        switch (getSelectMode()) {
-        case ALL_SUBNETS:
-            lower = idx.begin();
-            upper = idx.end();
-            break;
-
-        case SINGLE_SUBNET:
-            lower = idx.lower_bound(getFirstSubnetID());
-            upper = idx.upper_bound(getFirstSubnetID());
-            break;
-
-        case SUBNET_RANGE:
-            lower = idx.lower_bound(getFirstSubnetID());
-            upper = idx.upper_bound(getLastSubnetID());
-            break;
-        }
-
-        // Return an empty set if there are no rows.
-        if (lower == upper) {
-            return;
-        }
-
-        // Iterate over the leases in order by subnet, accumulating per
-        // subnet counts for each state of interest.  As we finish each
-        // subnet, add the appropriate rows to our result set.
-        SubnetID cur_id = 0;
-        int64_t assigned = 0;
-        int64_t declined = 0;
-        int64_t assigned_pds = 0;
-        for (Lease6StorageSubnetIdIndex::const_iterator lease = lower;
-             lease != upper; ++lease) {
-            // If we've hit the next subnet, add rows for the current subnet
-            // and wipe the accumulators
-            if ((*lease)->subnet_id_ != cur_id) {
-                if (cur_id > 0) {
-                    if (assigned > 0) {
-                        rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_NA,
-                                                      Lease::STATE_DEFAULT,
-                                                      assigned));
-                        assigned = 0;
-                    }
-
-                    if (declined > 0) {
-                        rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_NA,
-                                                      Lease::STATE_DECLINED,
-                                                      declined));
-                        declined = 0;
-                    }
-
-                    if (assigned_pds > 0) {
-                        rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_PD,
-                                                      Lease::STATE_DEFAULT,
-                                                      assigned_pds));
-                        assigned_pds = 0;
-                    }
-                }
-
-                // Update current subnet id
-                cur_id = (*lease)->subnet_id_;
-            }
-
-            // Bump the appropriate accumulator
-            if ((*lease)->state_ == Lease::STATE_DEFAULT) {
-                switch((*lease)->type_) {
-                case Lease::TYPE_NA:
-                    ++assigned;
-                    break;
-                case Lease::TYPE_PD:
-                    ++assigned_pds;
-                    break;
-                default:
-                    break;
-                }
-            } else if ((*lease)->state_ == Lease::STATE_DECLINED) {
-                // In theory only NAs can be declined
-                if (((*lease)->type_) == Lease::TYPE_NA) {
-                    ++declined;
-                }
+        auto range = selectCounters(counters6_);
+        for (auto counter = range.first; counter != range.second; ++counter) {
+            Lease::Type type = std::get<1>(counter->first);
+            uint32_t state = std::get<2>(counter->first);
+            // In theory only NAs can be declined
+            if (((type == Lease::TYPE_NA) &&
+                 ((state == Lease::STATE_DEFAULT) ||
+                  (state == Lease::STATE_DECLINED))) ||
+                ((type == Lease::TYPE_PD) &&
+                 (state == Lease::STATE_DEFAULT))) {
+                rows_.push_back(LeaseStatsRow(std::get<0>(counter->first),
+                                              type, state, counter->second));
             }
         }
 
-        // Make the rows for last subnet, unless there were no rows
-        if (assigned > 0) {
-            rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_NA,
-                                          Lease::STATE_DEFAULT, assigned));
-        }
-
-        if (declined > 0) {
-            rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_NA,
-                                          Lease::STATE_DECLINED, declined));
-        }
-
-        if (assigned_pds > 0) {
-            rows_.push_back(LeaseStatsRow(cur_id, Lease::TYPE_PD,
-                                          Lease::STATE_DEFAULT, assigned_pds));
-        }
-
         // Set the next row position to the beginning of the rows.
         next_pos_ = rows_.begin();
     }
 
 private:
-    /// @brief The Memfile storage containing the IPv6 leases to analyze
-    Lease6Storage& storage6_;
+    /// @brief The counters of the Memfile storage containing the IPv6 leases
+    const LeaseStatsCounters& counters6_;
 };
 
 // Explicit definition of class static constants.  Values are given in the
@@ -638,21 +547,31 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
     if (universe == "4") {
         std::string file4 = initLeaseFilePath(V4);
         if (!file4.empty()) {
-            conversion_needed = loadLeasesFromFiles<Lease4,
-                                                 CSVLeaseFile4>(file4,
-                                                                lease_file4_,
-                                                                storage4_);
+            conversion_needed = loadLeasesFromFiles<Lease4, CSVLeaseFile4,
+                                                    LeaseJournal4>(file4,
+                                                                   lease_file4_,
+                                                                   storage4_);
+            // The lease files are read once so the counters are
+            // maintained incrementally afterwards.
+            counters4_.reset(storage4_);
         }
     } else {
         std::string file6 = initLeaseFilePath(V6);
         if (!file6.empty()) {
-            conversion_needed = loadLeasesFromFiles<Lease6,
-                                                 CSVLeaseFile6>(file6,
-                                                                lease_file6_,
-                                                                storage6_);
+            conversion_needed = loadLeasesFromFiles<Lease6, CSVLeaseFile6,
+                                                    LeaseJournal6>(file6,
+                                                                   lease_file6_,
+                                                                   storage6_);
+            counters6_.reset(storage6_);
         }
     }
 
+    if (lease_file4_) {
+        setupLeaseFileWriter(lease_file4_, "memfile-lease4");
+    } else if (lease_file6_) {
+        setupLeaseFileWriter(lease_file6_, "memfile-lease6");
+    }
+
     // If lease persistence have been disabled for both v4 and v6,
     // issue a warning. It is ok not to write leases to disk when
     // doing testing, but it should not be done in normal server
@@ -665,9 +584,10 @@ Memfile_LeaseMgr::Memfile_LeaseMgr(const DatabaseConnection::ParameterMap& param
                     .arg(MAJOR_VERSION).arg(MINOR_VERSION);
         }
         lfcSetup(conversion_needed);
+        updateMemoryUsageStats();
     }
 
-    mutex_.reset(new std::mutex);
+    mutex_.reset(new ReadWriteMutex());
 }
 
 Memfile_LeaseMgr::~Memfile_LeaseMgr() {
@@ -703,7 +623,9 @@ Memfile_LeaseMgr::addLeaseInternal(const Lease4Ptr& lease) {
         lease_file4_->append(*lease);
     }
 
+    internLeaseIdentifiers(storage4_, lease);
     storage4_.insert(lease);
+    counters4_.insert(*lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -718,7 +640,7 @@ Memfile_LeaseMgr::addLease(const Lease4Ptr& lease) {
               DHCPSRV_MEMFILE_ADD_ADDR4).arg(lease->addr_.toText());
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        WriteLockGuard lock(*mutex_);
         return (addLeaseInternal(lease));
     } else {
         return (addLeaseInternal(lease));
@@ -739,7 +661,9 @@ Memfile_LeaseMgr::addLeaseInternal(const Lease6Ptr& lease) {
         lease_file6_->append(*lease);
     }
 
+    internLeaseIdentifiers(storage6_, lease);
     storage6_.insert(lease);
+    counters6_.insert(*lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -754,7 +678,7 @@ Memfile_LeaseMgr::addLease(const Lease6Ptr& lease) {
               DHCPSRV_MEMFILE_ADD_ADDR6).arg(lease->addr_.toText());
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        WriteLockGuard lock(*mutex_);
         return (addLeaseInternal(lease));
     } else {
         return (addLeaseInternal(lease));
@@ -763,8 +687,9 @@ Memfile_LeaseMgr::addLease(const Lease6Ptr& lease) {
 
 Lease4Ptr
 Memfile_LeaseMgr::getLease4Internal(const isc::asiolink::IOAddress& addr) const {
-    const Lease4StorageAddressIndex& idx = storage4_.get<AddressIndexTag>();
-    Lease4StorageAddressIndex::iterator l = idx.find(addr);
+    const Lease4StorageHashedAddressIndex& idx =
+        storage4_.get<HashedAddressIndexTag>();
+    Lease4StorageHashedAddressIndex::iterator l = idx.find(addr);
     if (l == idx.end()) {
         return (Lease4Ptr());
     } else {
@@ -778,7 +703,7 @@ Memfile_LeaseMgr::getLease4(const isc::asiolink::IOAddress& addr) const {
               DHCPSRV_MEMFILE_GET_ADDR4).arg(addr.toText());
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         return (getLease4Internal(addr));
     } else {
         return (getLease4Internal(addr));
@@ -788,17 +713,18 @@ Memfile_LeaseMgr::getLease4(const isc::asiolink::IOAddress& addr) const {
 void
 Memfile_LeaseMgr::getLease4Internal(const HWAddr& hwaddr,
                                     Lease4Collection& collection) const {
-    // Using composite index by 'hw address' and 'subnet id'. It is
-    // ok to use it for searching by the 'hw address' only.
-    const Lease4StorageHWAddressSubnetIdIndex& idx =
-        storage4_.get<HWAddressSubnetIdIndexTag>();
-    std::pair<Lease4StorageHWAddressSubnetIdIndex::const_iterator,
-              Lease4StorageHWAddressSubnetIdIndex::const_iterator> l
-        = idx.equal_range(boost::make_tuple(hwaddr.hwaddr_));
+    // Get the index by HW Address.
+    const Lease4StorageHWAddressIndex& idx =
+        storage4_.get<HWAddressIndexTag>();
+    std::pair<Lease4StorageHWAddressIndex::const_iterator,
+              Lease4StorageHWAddressIndex::const_iterator> l
+        = idx.equal_range(hwaddr.hwaddr_);
 
     for (auto lease = l.first; lease != l.second; ++lease) {
         collection.push_back(Lease4Ptr(new Lease4(**lease)));
     }
+
+    sortLeasesByAddress(collection);
 }
 
 Lease4Collection
@@ -808,7 +734,7 @@ Memfile_LeaseMgr::getLease4(const HWAddr& hwaddr) const {
 
     Lease4Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLease4Internal(hwaddr, collection);
     } else {
         getLease4Internal(hwaddr, collection);
@@ -820,19 +746,22 @@ Memfile_LeaseMgr::getLease4(const HWAddr& hwaddr) const {
 Lease4Ptr
 Memfile_LeaseMgr::getLease4Internal(const HWAddr& hwaddr,
                                     SubnetID subnet_id) const {
-    // Get the index by HW Address and Subnet Identifier.
-    const Lease4StorageHWAddressSubnetIdIndex& idx =
-        storage4_.get<HWAddressSubnetIdIndexTag>();
+    // Get the index by HW Address.
+    const Lease4StorageHWAddressIndex& idx =
+        storage4_.get<HWAddressIndexTag>();
+    std::pair<Lease4StorageHWAddressIndex::const_iterator,
+              Lease4StorageHWAddressIndex::const_iterator> l
+        = idx.equal_range(hwaddr.hwaddr_);
+
     // Try to find the lease using HWAddr and subnet id.
-    Lease4StorageHWAddressSubnetIdIndex::const_iterator lease =
-        idx.find(boost::make_tuple(hwaddr.hwaddr_, subnet_id));
-    // Lease was not found. Return empty pointer to the caller.
-    if (lease == idx.end()) {
+    Lease4Ptr lease = getLowestAddressLease(l.first, l.second, subnet_id);
+    if (!lease) {
+        // Lease was not found. Return empty pointer to the caller.
         return (Lease4Ptr());
     }
 
     // Lease was found. Return it to the caller.
-    return (Lease4Ptr(new Lease4(**lease)));
+    return (Lease4Ptr(new Lease4(*lease)));
 }
 
 Lease4Ptr
@@ -843,7 +772,7 @@ Memfile_LeaseMgr::getLease4(const HWAddr& hwaddr,
         .arg(hwaddr.toText());
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         return (getLease4Internal(hwaddr, subnet_id));
     } else {
         return (getLease4Internal(hwaddr, subnet_id));
@@ -853,17 +782,18 @@ Memfile_LeaseMgr::getLease4(const HWAddr& hwaddr,
 void
 Memfile_LeaseMgr::getLease4Internal(const ClientId& client_id,
                                     Lease4Collection& collection) const {
-    // Using composite index by 'client id' and 'subnet id'. It is ok
-    // to use it to search by 'client id' only.
-    const Lease4StorageClientIdSubnetIdIndex& idx =
-        storage4_.get<ClientIdSubnetIdIndexTag>();
-    std::pair<Lease4StorageClientIdSubnetIdIndex::const_iterator,
-              Lease4StorageClientIdSubnetIdIndex::const_iterator> l
-        = idx.equal_range(boost::make_tuple(client_id.getClientId()));
+    // Get the index by client id.
+    const Lease4StorageClientIdIndex& idx =
+        storage4_.get<ClientIdIndexTag>();
+    std::pair<Lease4StorageClientIdIndex::const_iterator,
+              Lease4StorageClientIdIndex::const_iterator> l
+        = idx.equal_range(client_id.getClientId());
 
     for (auto lease = l.first; lease != l.second; ++lease) {
         collection.push_back(Lease4Ptr(new Lease4(**lease)));
     }
+
+    sortLeasesByAddress(collection);
 }
 
 Lease4Collection
@@ -873,7 +803,7 @@ Memfile_LeaseMgr::getLease4(const ClientId& client_id) const {
 
     Lease4Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLease4Internal(client_id, collection);
     } else {
         getLease4Internal(client_id, collection);
@@ -890,17 +820,18 @@ Memfile_LeaseMgr::getLease4Internal(const ClientId& client_id,
     const Lease4StorageClientIdHWAddressSubnetIdIndex& idx =
         storage4_.get<ClientIdHWAddressSubnetIdIndexTag>();
     // Try to get the lease using client id, hardware address and subnet id.
-    Lease4StorageClientIdHWAddressSubnetIdIndex::const_iterator lease =
-        idx.find(boost::make_tuple(client_id.getClientId(), hwaddr.hwaddr_,
-                                   subnet_id));
-
-    if (lease == idx.end()) {
+    std::pair<Lease4StorageClientIdHWAddressSubnetIdIndex::const_iterator,
+              Lease4StorageClientIdHWAddressSubnetIdIndex::const_iterator> l =
+        idx.equal_range(boost::make_tuple(client_id.getClientId(),
+                                          hwaddr.hwaddr_, subnet_id));
+    Lease4Ptr lease = getLowestAddressLease(l.first, l.second, subnet_id);
+    if (!lease) {
         // Lease was not found. Return empty pointer to the caller.
         return (Lease4Ptr());
     }
 
-    // Lease was found. Return it to the caller.
-    return (*lease);
+    // Lease was found. Return a copy to the caller.
+    return (Lease4Ptr(new Lease4(*lease)));
 }
 
 Lease4Ptr
@@ -913,7 +844,7 @@ Memfile_LeaseMgr::getLease4(const ClientId& client_id,
                                                         .arg(subnet_id);
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         return (getLease4Internal(client_id, hwaddr, subnet_id));
     } else {
         return (getLease4Internal(client_id, hwaddr, subnet_id));
@@ -923,18 +854,22 @@ Memfile_LeaseMgr::getLease4(const ClientId& client_id,
 Lease4Ptr
 Memfile_LeaseMgr::getLease4Internal(const ClientId& client_id,
                                     SubnetID subnet_id) const {
-    // Get the index by client and subnet id.
-    const Lease4StorageClientIdSubnetIdIndex& idx =
-        storage4_.get<ClientIdSubnetIdIndexTag>();
+    // Get the index by client id.
+    const Lease4StorageClientIdIndex& idx =
+        storage4_.get<ClientIdIndexTag>();
+    std::pair<Lease4StorageClientIdIndex::const_iterator,
+              Lease4StorageClientIdIndex::const_iterator> l
+        = idx.equal_range(client_id.getClientId());
+
     // Try to get the lease using client id and subnet id.
-    Lease4StorageClientIdSubnetIdIndex::const_iterator lease =
-        idx.find(boost::make_tuple(client_id.getClientId(), subnet_id));
-    // Lease was not found. Return empty pointer to the caller.
-    if (lease == idx.end()) {
+    Lease4Ptr lease = getLowestAddressLease(l.first, l.second, subnet_id);
+    if (!lease) {
+        // Lease was not found. Return empty pointer to the caller.
         return (Lease4Ptr());
     }
+
     // Lease was found. Return it to the caller.
-    return (Lease4Ptr(new Lease4(**lease)));
+    return (Lease4Ptr(new Lease4(*lease)));
 }
 
 Lease4Ptr
@@ -945,7 +880,7 @@ Memfile_LeaseMgr::getLease4(const ClientId& client_id,
               .arg(client_id.toText());
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         return (getLease4Internal(client_id, subnet_id));
     } else {
         return (getLease4Internal(client_id, subnet_id));
@@ -972,7 +907,7 @@ Memfile_LeaseMgr::getLeases4(SubnetID subnet_id) const {
 
     Lease4Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases4Internal(subnet_id, collection);
     } else {
         getLeases4Internal(subnet_id, collection);
@@ -992,6 +927,8 @@ Memfile_LeaseMgr::getLeases4Internal(const std::string& hostname,
     for (auto lease = l.first; lease != l.second; ++lease) {
         collection.push_back(Lease4Ptr(new Lease4(**lease)));
     }
+
+    sortLeasesByAddress(collection);
 }
 
 Lease4Collection
@@ -1001,7 +938,7 @@ Memfile_LeaseMgr::getLeases4(const std::string& hostname) const {
 
     Lease4Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases4Internal(hostname, collection);
     } else {
         getLeases4Internal(hostname, collection);
@@ -1023,7 +960,7 @@ Memfile_LeaseMgr::getLeases4() const {
 
    Lease4Collection collection;
    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases4Internal(collection);
    } else {
         getLeases4Internal(collection);
@@ -1068,7 +1005,7 @@ Memfile_LeaseMgr::getLeases4(const asiolink::IOAddress& lower_bound_address,
 
     Lease4Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases4Internal(lower_bound_address, page_size, collection);
     } else {
         getLeases4Internal(lower_bound_address, page_size, collection);
@@ -1080,8 +1017,10 @@ Memfile_LeaseMgr::getLeases4(const asiolink::IOAddress& lower_bound_address,
 Lease6Ptr
 Memfile_LeaseMgr::getLease6Internal(Lease::Type type,
                                     const isc::asiolink::IOAddress& addr) const {
-    Lease6Storage::iterator l = storage6_.find(addr);
-    if (l == storage6_.end() || !(*l) || ((*l)->type_ != type)) {
+    const Lease6StorageHashedAddressIndex& idx =
+        storage6_.get<HashedAddressIndexTag>();
+    Lease6StorageHashedAddressIndex::iterator l = idx.find(addr);
+    if (l == idx.end() || !(*l) || ((*l)->type_ != type)) {
         return (Lease6Ptr());
     } else {
         return (Lease6Ptr(new Lease6(**l)));
@@ -1097,7 +1036,7 @@ Memfile_LeaseMgr::getLease6(Lease::Type type,
         .arg(Lease::typeToText(type));
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         return (getLease6Internal(type, addr));
     } else {
         return (getLease6Internal(type, addr));
@@ -1120,6 +1059,8 @@ Memfile_LeaseMgr::getLeases6Internal(Lease::Type type,
          l.first; lease != l.second; ++lease) {
         collection.push_back(Lease6Ptr(new Lease6(**lease)));
     }
+
+    sortLeasesByAddress(collection);
 }
 
 Lease6Collection
@@ -1134,7 +1075,7 @@ Memfile_LeaseMgr::getLeases6(Lease::Type type,
 
     Lease6Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases6Internal(type, duid, iaid, collection);
     } else {
         getLeases6Internal(type, duid, iaid, collection);
@@ -1163,6 +1104,8 @@ Memfile_LeaseMgr::getLeases6Internal(Lease::Type type,
             collection.push_back(Lease6Ptr(new Lease6(**lease)));
         }
     }
+
+    sortLeasesByAddress(collection);
 }
 
 Lease6Collection
@@ -1179,7 +1122,7 @@ Memfile_LeaseMgr::getLeases6(Lease::Type type,
 
     Lease6Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases6Internal(type, duid, iaid, subnet_id, collection);
     } else {
         getLeases6Internal(type, duid, iaid, subnet_id, collection);
@@ -1208,7 +1151,7 @@ Memfile_LeaseMgr::getLeases6(SubnetID subnet_id) const {
 
     Lease6Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases6Internal(subnet_id, collection);
     } else {
         getLeases6Internal(subnet_id, collection);
@@ -1228,6 +1171,8 @@ Memfile_LeaseMgr::getLeases6Internal(const std::string& hostname,
     for (auto lease = l.first; lease != l.second; ++lease) {
         collection.push_back(Lease6Ptr(new Lease6(**lease)));
     }
+
+    sortLeasesByAddress(collection);
 }
 
 Lease6Collection
@@ -1237,7 +1182,7 @@ Memfile_LeaseMgr::getLeases6(const std::string& hostname) const {
 
     Lease6Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases6Internal(hostname, collection);
     } else {
         getLeases6Internal(hostname, collection);
@@ -1259,7 +1204,7 @@ Memfile_LeaseMgr::getLeases6() const {
 
    Lease6Collection collection;
    if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases6Internal(collection);
    } else {
         getLeases6Internal(collection);
@@ -1279,6 +1224,8 @@ Memfile_LeaseMgr::getLeases6Internal(const DUID& duid,
     for (auto lease = l.first; lease != l.second; ++lease) {
         collection.push_back(Lease6Ptr(new Lease6(**lease)));
     }
+
+    sortLeasesByAddress(collection);
 }
 
 Lease6Collection
@@ -1288,7 +1235,7 @@ Memfile_LeaseMgr::getLeases6(const DUID& duid) const {
 
     Lease6Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases6Internal(duid, collection);
     } else {
         getLeases6Internal(duid, collection);
@@ -1333,7 +1280,7 @@ Memfile_LeaseMgr::getLeases6(const asiolink::IOAddress& lower_bound_address,
 
     Lease6Collection collection;
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getLeases6Internal(lower_bound_address, page_size, collection);
     } else {
         getLeases6Internal(lower_bound_address, page_size, collection);
@@ -1371,7 +1318,7 @@ Memfile_LeaseMgr::getExpiredLeases4(Lease4Collection& expired_leases,
         .arg(max_leases);
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getExpiredLeases4Internal(expired_leases, max_leases);
     } else {
         getExpiredLeases4Internal(expired_leases, max_leases);
@@ -1407,7 +1354,7 @@ Memfile_LeaseMgr::getExpiredLeases6(Lease6Collection& expired_leases,
         .arg(max_leases);
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        ReadLockGuard lock(*mutex_);
         getExpiredLeases6Internal(expired_leases, max_leases);
     } else {
         getExpiredLeases6Internal(expired_leases, max_leases);
@@ -1417,12 +1364,14 @@ Memfile_LeaseMgr::getExpiredLeases6(Lease6Collection& expired_leases,
 void
 Memfile_LeaseMgr::updateLease4Internal(const Lease4Ptr& lease) {
     // Obtain 'by address' index.
-    Lease4StorageAddressIndex& index = storage4_.get<AddressIndexTag>();
+    Lease4StorageHashedAddressIndex& index =
+        storage4_.get<HashedAddressIndexTag>();
 
     bool persist = persistLeases(V4);
 
     // Lease must exist if it is to be updated.
-    Lease4StorageAddressIndex::const_iterator lease_it = index.find(lease->addr_);
+    Lease4StorageHashedAddressIndex::const_iterator lease_it =
+        index.find(lease->addr_);
     if (lease_it == index.end()) {
         isc_throw(NoSuchLease, "failed to update the lease with address "
                   << lease->addr_ << " - no such lease");
@@ -1445,7 +1394,11 @@ Memfile_LeaseMgr::updateLease4Internal(const Lease4Ptr& lease) {
     lease->updateCurrentExpirationTime();
 
     // Use replace() to re-index leases.
-    index.replace(lease_it, Lease4Ptr(new Lease4(*lease)));
+    Lease4Ptr lease_copy(new Lease4(*lease));
+    internLeaseIdentifiers(storage4_, lease_copy);
+    counters4_.remove(**lease_it);
+    index.replace(lease_it, lease_copy);
+    counters4_.insert(*lease_copy);
 }
 
 void
@@ -1454,7 +1407,7 @@ Memfile_LeaseMgr::updateLease4(const Lease4Ptr& lease) {
               DHCPSRV_MEMFILE_UPDATE_ADDR4).arg(lease->addr_.toText());
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        WriteLockGuard lock(*mutex_);
         updateLease4Internal(lease);
     } else {
         updateLease4Internal(lease);
@@ -1464,12 +1417,14 @@ Memfile_LeaseMgr::updateLease4(const Lease4Ptr& lease) {
 void
 Memfile_LeaseMgr::updateLease6Internal(const Lease6Ptr& lease) {
     // Obtain 'by address' index.
-    Lease6StorageAddressIndex& index = storage6_.get<AddressIndexTag>();
+    Lease6StorageHashedAddressIndex& index =
+        storage6_.get<HashedAddressIndexTag>();
 
     bool persist = persistLeases(V6);
 
     // Lease must exist if it is to be updated.
-    Lease6StorageAddressIndex::const_iterator lease_it = index.find(lease->addr_);
+    Lease6StorageHashedAddressIndex::const_iterator lease_it =
+        index.find(lease->addr_);
     if (lease_it == index.end()) {
         isc_throw(NoSuchLease, "failed to update the lease with address "
                   << lease->addr_ << " - no such lease");
@@ -1492,7 +1447,11 @@ Memfile_LeaseMgr::updateLease6Internal(const Lease6Ptr& lease) {
     lease->updateCurrentExpirationTime();
 
     // Use replace() to re-index leases.
-    index.replace(lease_it, Lease6Ptr(new Lease6(*lease)));
+    Lease6Ptr lease_copy(new Lease6(*lease));
+    internLeaseIdentifiers(storage6_, lease_copy);
+    counters6_.remove(**lease_it);
+    index.replace(lease_it, lease_copy);
+    counters6_.insert(*lease_copy);
 }
 
 void
@@ -1501,7 +1460,7 @@ Memfile_LeaseMgr::updateLease6(const Lease6Ptr& lease) {
               DHCPSRV_MEMFILE_UPDATE_ADDR6).arg(lease->addr_.toText());
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        WriteLockGuard lock(*mutex_);
         updateLease6Internal(lease);
     } else {
         updateLease6Internal(lease);
@@ -1511,8 +1470,10 @@ Memfile_LeaseMgr::updateLease6(const Lease6Ptr& lease) {
 bool
 Memfile_LeaseMgr::deleteLeaseInternal(const Lease4Ptr& lease) {
     const isc::asiolink::IOAddress& addr = lease->addr_;
-    Lease4Storage::iterator l = storage4_.find(addr);
-    if (l == storage4_.end()) {
+    Lease4StorageHashedAddressIndex& index =
+        storage4_.get<HashedAddressIndexTag>();
+    Lease4StorageHashedAddressIndex::iterator l = index.find(addr);
+    if (l == index.end()) {
         // No such lease
         return (false);
     } else {
@@ -1532,7 +1493,8 @@ Memfile_LeaseMgr::deleteLeaseInternal(const Lease4Ptr& lease) {
                 return false;
             }
         }
-        storage4_.erase(l);
+        counters4_.remove(**l);
+        index.erase(l);
         return (true);
     }
 }
@@ -1543,7 +1505,7 @@ Memfile_LeaseMgr::deleteLease(const Lease4Ptr& lease) {
               DHCPSRV_MEMFILE_DELETE_ADDR).arg(lease->addr_.toText());
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        WriteLockGuard lock(*mutex_);
         return (deleteLeaseInternal(lease));
     } else {
         return (deleteLeaseInternal(lease));
@@ -1553,8 +1515,10 @@ Memfile_LeaseMgr::deleteLease(const Lease4Ptr& lease) {
 bool
 Memfile_LeaseMgr::deleteLeaseInternal(const Lease6Ptr& lease) {
     const isc::asiolink::IOAddress& addr = lease->addr_;
-    Lease6Storage::iterator l = storage6_.find(addr);
-    if (l == storage6_.end()) {
+    Lease6StorageHashedAddressIndex& index =
+        storage6_.get<HashedAddressIndexTag>();
+    Lease6StorageHashedAddressIndex::iterator l = index.find(addr);
+    if (l == index.end()) {
         // No such lease
         return (false);
     } else {
@@ -1574,7 +1538,8 @@ Memfile_LeaseMgr::deleteLeaseInternal(const Lease6Ptr& lease) {
                 return false;
             }
         }
-        storage6_.erase(l);
+        counters6_.remove(**l);
+        index.erase(l);
         return (true);
     }
 }
@@ -1585,13 +1550,85 @@ Memfile_LeaseMgr::deleteLease(const Lease6Ptr& lease) {
               DHCPSRV_MEMFILE_DELETE_ADDR).arg(lease->addr_.toText());
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        WriteLockGuard lock(*mutex_);
         return (deleteLeaseInternal(lease));
     } else {
         return (deleteLeaseInternal(lease));
     }
 }
 
+void
+Memfile_LeaseMgr::applyLeaseChangesInternal(LeaseChange4Collection& changes) {
+    for (auto& change : changes) {
+        try {
+            switch (change.type_) {
+            case LeaseChange4::ADD:
+                change.applied_ = addLeaseInternal(change.lease_);
+                break;
+            case LeaseChange4::UPDATE:
+                updateLease4Internal(change.lease_);
+                change.applied_ = true;
+                break;
+            case LeaseChange4::DELETE:
+                change.applied_ = deleteLeaseInternal(change.lease_);
+                break;
+            }
+        } catch (const std::exception& ex) {
+            change.applied_ = false;
+            change.error_ = ex.what();
+        }
+    }
+}
+
+void
+Memfile_LeaseMgr::applyLeaseChanges(LeaseChange4Collection& changes) {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+              DHCPSRV_MEMFILE_APPLY_LEASE_CHANGES).arg(changes.size());
+
+    if (MultiThreadingMgr::instance().getMode()) {
+        WriteLockGuard lock(*mutex_);
+        applyLeaseChangesInternal(changes);
+    } else {
+        applyLeaseChangesInternal(changes);
+    }
+}
+
+void
+Memfile_LeaseMgr::applyLeaseChangesInternal(LeaseChange6Collection& changes) {
+    for (auto& change : changes) {
+        try {
+            switch (change.type_) {
+            case LeaseChange6::ADD:
+                change.applied_ = addLeaseInternal(change.lease_);
+                break;
+            case LeaseChange6::UPDATE:
+                updateLease6Internal(change.lease_);
+                change.applied_ = true;
+                break;
+            case LeaseChange6::DELETE:
+                change.applied_ = deleteLeaseInternal(change.lease_);
+                break;
+            }
+        } catch (const std::exception& ex) {
+            change.applied_ = false;
+            change.error_ = ex.what();
+        }
+    }
+}
+
+void
+Memfile_LeaseMgr::applyLeaseChanges(LeaseChange6Collection& changes) {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+              DHCPSRV_MEMFILE_APPLY_LEASE_CHANGES).arg(changes.size());
+
+    if (MultiThreadingMgr::instance().getMode()) {
+        WriteLockGuard lock(*mutex_);
+        applyLeaseChangesInternal(changes);
+    } else {
+        applyLeaseChangesInternal(changes);
+    }
+}
+
 uint64_t
 Memfile_LeaseMgr::deleteExpiredReclaimedLeases4(const uint32_t secs) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
@@ -1599,14 +1636,14 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases4(const uint32_t secs) {
         .arg(secs);
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        WriteLockGuard lock(*mutex_);
         return (deleteExpiredReclaimedLeases<
                 Lease4StorageExpirationIndex, Lease4
-                >(secs, V4, storage4_, lease_file4_));
+                >(secs, V4, storage4_, counters4_, lease_file4_));
     } else {
         return (deleteExpiredReclaimedLeases<
                 Lease4StorageExpirationIndex, Lease4
-                >(secs, V4, storage4_, lease_file4_));
+                >(secs, V4, storage4_, counters4_, lease_file4_));
     }
 }
 
@@ -1617,14 +1654,14 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases6(const uint32_t secs) {
         .arg(secs);
 
     if (MultiThreadingMgr::instance().getMode()) {
-        std::lock_guard<std::mutex> lock(*mutex_);
+        WriteLockGuard lock(*mutex_);
         return (deleteExpiredReclaimedLeases<
                 Lease6StorageExpirationIndex, Lease6
-                >(secs, V6, storage6_, lease_file6_));
+                >(secs, V6, storage6_, counters6_, lease_file6_));
     } else {
         return (deleteExpiredReclaimedLeases<
                 Lease6StorageExpirationIndex, Lease6
-                >(secs, V6, storage6_, lease_file6_));
+                >(secs, V6, storage6_, counters6_, lease_file6_));
     }
 }
 
@@ -1634,6 +1671,7 @@ uint64_t
 Memfile_LeaseMgr::deleteExpiredReclaimedLeases(const uint32_t secs,
                                                const Universe& universe,
                                                StorageType& storage,
+                                               LeaseStatsCounters& counters,
                                                LeaseFileType& lease_file) const {
     // Obtain the index which segragates leases by state and time.
     IndexType& index = storage.template get<ExpirationIndexTag>();
@@ -1684,6 +1722,10 @@ Memfile_LeaseMgr::deleteExpiredReclaimedLeases(const uint32_t secs,
         }
 
         // Erase leases from memory.
+        for (typename IndexType::const_iterator lease = lower_limit;
+             lease != upper_limit; ++lease) {
+            counters.remove(**lease);
+        }
         index.erase(lower_limit, upper_limit);
     }
     // Return number of leases deleted.
@@ -1765,6 +1807,42 @@ Memfile_LeaseMgr::persistLeases(Universe u) const {
     return (u == V6 && lease_file6_);
 }
 
+size_t
+Memfile_LeaseMgr::getMemoryUsage(Universe u) const {
+    if (MultiThreadingMgr::instance().getMode()) {
+        ReadLockGuard lock(*mutex_);
+        return (u == V4 ? getLeaseStorageMemoryUsage(storage4_) :
+                getLeaseStorageMemoryUsage(storage6_));
+    } else {
+        return (u == V4 ? getLeaseStorageMemoryUsage(storage4_) :
+                getLeaseStorageMemoryUsage(storage6_));
+    }
+}
+
+void
+Memfile_LeaseMgr::updateMemoryUsageStats() {
+    std::string family;
+    size_t count = 0;
+    size_t usage = 0;
+    if (lease_file4_) {
+        family = "lease4";
+        count = storage4_.size();
+        usage = getLeaseStorageMemoryUsage(storage4_);
+    } else if (lease_file6_) {
+        family = "lease6";
+        count = storage6_.size();
+        usage = getLeaseStorageMemoryUsage(storage6_);
+    } else {
+        return;
+    }
+
+    StatsMgr& stats_mgr = StatsMgr::instance();
+    stats_mgr.setValue("memfile-" + family + "-memory",
+                       static_cast<int64_t>(usage));
+    stats_mgr.setValue("memfile-" + family + "-memory-per-lease",
+                       static_cast<int64_t>(count > 0 ? usage / count : 0));
+}
+
 std::string
 Memfile_LeaseMgr::initLeaseFilePath(Universe u) {
     std::string persist_val;
@@ -1794,10 +1872,91 @@ Memfile_LeaseMgr::initLeaseFilePath(Universe u) {
     return (lease_file);
 }
 
-template<typename LeaseObjectType, typename LeaseFileType, typename StorageType>
+LeaseWriteConfig
+Memfile_LeaseMgr::getLeaseWriteConfig() const {
+    LeaseWriteConfig config;
+    std::string policy_str = "direct";
+    try {
+        policy_str = conn_.getParameter("write-policy");
+    } catch (const std::exception&) {
+        // Ignore and default to direct writes.
+    }
+    config.policy_ = LeaseWriteConfig::policyFromText(policy_str);
+
+    std::vector<std::pair<std::string, uint32_t*> > params = {
+        { "write-interval", &config.interval_ },
+        { "write-batch-size", &config.batch_size_ },
+        { "write-queue-size", &config.queue_size_ }
+    };
+    for (auto const& param : params) {
+        std::string value_str;
+        try {
+            value_str = conn_.getParameter(param.first);
+        } catch (const std::exception&) {
+            // Ignore and keep the default.
+            continue;
+        }
+        try {
+            *param.second = boost::lexical_cast<uint32_t>(value_str);
+        } catch (const boost::bad_lexical_cast&) {
+            isc_throw(isc::BadValue, "invalid value of the " << param.first
+                      << " " << value_str << " specified");
+        }
+    }
+
+    if ((config.batch_size_ == 0) || (config.queue_size_ == 0)) {
+        isc_throw(isc::BadValue, "the write-batch-size and write-queue-size"
+                  " must be greater than 0");
+    }
+    return (config);
+}
+
+template<typename LeaseObjectType>
+void
+Memfile_LeaseMgr::setupLeaseFileWriter(boost::shared_ptr<LeaseFile<LeaseObjectType> >& lease_file,
+                                       const std::string& stats_prefix) {
+    LeaseWriteConfig config = getLeaseWriteConfig();
+    if (config.policy_ == LEASE_WRITE_DIRECT) {
+        return;
+    }
+
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_WRITE_POLICY)
+        .arg(lease_file->getFilename())
+        .arg(LeaseWriteConfig::policyToText(config.policy_));
+    lease_file.reset(new LeaseFileWriter<LeaseObjectType>(lease_file, config,
+                                                          stats_prefix));
+}
+
+template<typename LeaseObjectType, typename CSVLeaseFileType,
+         typename LeaseJournalType, typename StorageType>
+boost::shared_ptr<LeaseFile<LeaseObjectType> >
+Memfile_LeaseMgr::loadLeaseFile(const std::string& filename,
+                                StorageType& storage,
+                                const uint32_t max_row_errors,
+                                const bool close_file_on_exit,
+                                const uint32_t thread_count) {
+    if (LeaseJournal::useJournal(filename)) {
+        boost::shared_ptr<LeaseJournalType> journal(new LeaseJournalType(filename));
+        LeaseFileLoader::load<LeaseObjectType>(*journal, storage,
+                                               max_row_errors,
+                                               close_file_on_exit,
+                                               thread_count);
+        return (journal);
+    }
+
+    boost::shared_ptr<CSVLeaseFileType> csv_file(new CSVLeaseFileType(filename));
+    LeaseFileLoader::load<LeaseObjectType>(*csv_file, storage,
+                                           max_row_errors,
+                                           close_file_on_exit,
+                                           thread_count);
+    return (csv_file);
+}
+
+template<typename LeaseObjectType, typename CSVLeaseFileType,
+         typename LeaseJournalType, typename StorageType>
 bool
 Memfile_LeaseMgr::loadLeasesFromFiles(const std::string& filename,
-                                      boost::shared_ptr<LeaseFileType>& lease_file,
+                                      boost::shared_ptr<LeaseFile<LeaseObjectType> >& lease_file,
                                       StorageType& storage) {
     // Check if the instance of the LFC is running right now. If it is
     // running, we refuse to load leases as the LFC may be writing to the
@@ -1828,27 +1987,49 @@ Memfile_LeaseMgr::loadLeasesFromFiles(const std::string& filename,
                   << max_row_errors_str << " specified");
     }
 
-    // Load the leasefile.completed, if exists.
+    // The lease files are loaded during the server configuration, before
+    // the multi-threading settings are applied, so the number of threads
+    // parsing the leases is taken from the staging configuration.
+    bool enabled = false;
+    uint32_t thread_count = 0;
+    uint32_t queue_size = 0;
+    CfgMultiThreading::extract(CfgMgr::instance().getStagingCfg()->getDHCPMultiThreading(),
+                               enabled, thread_count, queue_size);
+    if (!enabled) {
+        thread_count = 1;
+    } else if (thread_count == 0) {
+        thread_count = MultiThreadingMgr::detectThreadCount();
+    }
+
+    // Load the leasefile.completed, if exists. The CSV lease files and
+    // the lease journals may be mixed, e.g. after switching to the lease
+    // journal, so the format of each file is detected separately.
     bool conversion_needed = false;
-    lease_file.reset(new LeaseFileType(std::string(filename + ".completed")));
-    if (lease_file->exists()) {
-        LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
-                                               max_row_errors);
+    std::string completed_file(filename + ".completed");
+    if (CSVFile(completed_file).exists()) {
+        lease_file = loadLeaseFile<LeaseObjectType, CSVLeaseFileType,
+                                   LeaseJournalType>(completed_file, storage,
+                                                     max_row_errors, true,
+                                                     thread_count);
         conversion_needed = conversion_needed || lease_file->needsConversion();
     } else {
         // If the leasefile.completed doesn't exist, let's load the leases
         // from leasefile.2 and leasefile.1, if they exist.
-        lease_file.reset(new LeaseFileType(appendSuffix(filename, FILE_PREVIOUS)));
-        if (lease_file->exists()) {
-            LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
-                                                   max_row_errors);
+        std::string previous_file(appendSuffix(filename, FILE_PREVIOUS));
+        if (CSVFile(previous_file).exists()) {
+            lease_file = loadLeaseFile<LeaseObjectType, CSVLeaseFileType,
+                                       LeaseJournalType>(previous_file, storage,
+                                                         max_row_errors, true,
+                                                         thread_count);
             conversion_needed =  conversion_needed || lease_file->needsConversion();
         }
 
-        lease_file.reset(new LeaseFileType(appendSuffix(filename, FILE_INPUT)));
-        if (lease_file->exists()) {
-            LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
-                                                   max_row_errors);
+        std::string input_file(appendSuffix(filename, FILE_INPUT));
+        if (CSVFile(input_file).exists()) {
+            lease_file = loadLeaseFile<LeaseObjectType, CSVLeaseFileType,
+                                       LeaseJournalType>(input_file, storage,
+                                                         max_row_errors, true,
+                                                         thread_count);
             conversion_needed =  conversion_needed || lease_file->needsConversion();
         }
     }
@@ -1859,9 +2040,10 @@ Memfile_LeaseMgr::loadLeasesFromFiles(const std::string& filename,
     // function causes the function to leave the file open after
     // it is parsed. This file will be used by the backend to record
     // future lease updates.
-    lease_file.reset(new LeaseFileType(filename));
-    LeaseFileLoader::load<LeaseObjectType>(*lease_file, storage,
-                                           max_row_errors, false);
+    lease_file = loadLeaseFile<LeaseObjectType, CSVLeaseFileType,
+                               LeaseJournalType>(filename, storage,
+                                                 max_row_errors, false,
+                                                 thread_count);
     conversion_needed =  conversion_needed || lease_file->needsConversion();
 
     return (conversion_needed);
@@ -1886,9 +2068,11 @@ Memfile_LeaseMgr::lfcCallback() {
     if (lease_file4_) {
         MultiThreadingCriticalSection cs;
         lfcExecute(lease_file4_);
+        updateMemoryUsageStats();
     } else if (lease_file6_) {
         MultiThreadingCriticalSection cs;
         lfcExecute(lease_file6_);
+        updateMemoryUsageStats();
     }
 }
 
@@ -1950,7 +2134,7 @@ Memfile_LeaseMgr::lfcExecute(boost::shared_ptr<LeaseFileType>& lease_file) {
         try {
             lease_file->open(true);
 
-        } catch (const CSVFileError& ex) {
+        } catch (const isc::Exception& ex) {
             // If we're unable to open the lease file this is a serious
             // error because the server will not be able to persist
             // leases.
@@ -1978,47 +2162,77 @@ Memfile_LeaseMgr::lfcExecute(boost::shared_ptr<LeaseFileType>& lease_file) {
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startLeaseStatsQuery4() {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(storage4_));
-    query->start();
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(counters4_));
+    if (MultiThreadingMgr::instance().getMode()) {
+        ReadLockGuard lock(*mutex_);
+        query->start();
+    } else {
+        query->start();
+    }
     return(query);
 }
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetLeaseStatsQuery4(const SubnetID& subnet_id) {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(storage4_, subnet_id));
-    query->start();
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(counters4_, subnet_id));
+    if (MultiThreadingMgr::instance().getMode()) {
+        ReadLockGuard lock(*mutex_);
+        query->start();
+    } else {
+        query->start();
+    }
     return(query);
 }
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetRangeLeaseStatsQuery4(const SubnetID& first_subnet_id,
                                                    const SubnetID& last_subnet_id) {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(storage4_, first_subnet_id,
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery4(counters4_, first_subnet_id,
                                                          last_subnet_id));
-    query->start();
+    if (MultiThreadingMgr::instance().getMode()) {
+        ReadLockGuard lock(*mutex_);
+        query->start();
+    } else {
+        query->start();
+    }
     return(query);
 }
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startLeaseStatsQuery6() {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(storage6_));
-    query->start();
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(counters6_));
+    if (MultiThreadingMgr::instance().getMode()) {
+        ReadLockGuard lock(*mutex_);
+        query->start();
+    } else {
+        query->start();
+    }
     return(query);
 }
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetLeaseStatsQuery6(const SubnetID& subnet_id) {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(storage6_, subnet_id));
-    query->start();
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(counters6_, subnet_id));
+    if (MultiThreadingMgr::instance().getMode()) {
+        ReadLockGuard lock(*mutex_);
+        query->start();
+    } else {
+        query->start();
+    }
     return(query);
 }
 
 LeaseStatsQueryPtr
 Memfile_LeaseMgr::startSubnetRangeLeaseStatsQuery6(const SubnetID& first_subnet_id,
                                                    const SubnetID& last_subnet_id) {
-    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(storage6_, first_subnet_id,
+    LeaseStatsQueryPtr query(new MemfileLeaseStatsQuery6(counters6_, first_subnet_id,
                                                          last_subnet_id));
-    query->start();
+    if (MultiThreadingMgr::instance().getMode()) {
+        ReadLockGuard lock(*mutex_);
+        query->start();
+    } else {
+        query->start();
+    }
     return(query);
 }
 
@@ -12,15 +12,16 @@
 #include <dhcp/hwaddr.h>
 #include <dhcpsrv/csv_lease_file4.h>
 #include <dhcpsrv/csv_lease_file6.h>
+#include <dhcpsrv/lease_file_writer.h>
+#include <dhcpsrv/lease_journal.h>
 #include <dhcpsrv/memfile_lease_storage.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <util/process_spawn.h>
+#include <util/readwrite_mutex.h>
 
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
-#include <mutex>
-
 namespace isc {
 namespace dhcp {
 
@@ -30,7 +31,11 @@ class LFCSetup;
 ///
 /// This class implements a lease database backend using CSV files to store
 /// DHCPv4 and DHCPv6 leases on disk. The format of the files is determined
-/// by the @c CSVLeaseFile4 and @c CSVLeaseFile6 classes.
+/// by the @c CSVLeaseFile4 and @c CSVLeaseFile6 classes. Alternatively,
+/// the leases are stored in binary lease journals implemented by the
+/// @c LeaseJournal4 and @c LeaseJournal6 classes when the name of a new
+/// lease file ends with @c LeaseJournal::FILE_SUFFIX. The format of the
+/// existing lease files is detected from their content.
 ///
 /// In order to obtain good performance, the backend stores leases
 /// incrementally, i.e. updates to leases are appended at the end of the lease
@@ -42,6 +47,12 @@ class LFCSetup;
 /// described on the Kea wiki:
 /// https://gitlab.isc.org/isc-projects/kea/wikis/designs/Lease-File-Cleanup-design.
 ///
+/// By default the lease updates are written to the lease file by the thread
+/// updating the lease. The "write-policy" parameter selects another policy
+/// implemented by the @c LeaseFileWriter: "sync" forces each update to the
+/// disk, "group-commit" and "buffered" hand the updates to a writer thread,
+/// the former forcing them to the disk in batches.
+///
 /// The backend installs an @c asiolink::IntervalTimer to periodically execute
 /// the @c Memfile_LeaseMgr::lfcCallback. This callback function controls
 /// the startup of the background process which removes redundant information
@@ -466,6 +477,22 @@ public:
     /// SELECT and DELETE with different expiration time.
     virtual bool deleteLease(const Lease6Ptr& lease);
 
+    /// @brief Applies a batch of changes of DHCPv4 leases.
+    ///
+    /// The changes are applied holding the lock on the lease storage once
+    /// for the whole batch rather than once per lease.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    virtual void applyLeaseChanges(LeaseChange4Collection& changes);
+
+    /// @brief Applies a batch of changes of DHCPv6 leases.
+    ///
+    /// The changes are applied holding the lock on the lease storage once
+    /// for the whole batch rather than once per lease.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    virtual void applyLeaseChanges(LeaseChange6Collection& changes);
+
     /// @brief Deletes all expired-reclaimed DHCPv4 leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
@@ -508,6 +535,13 @@ private:
 
     /// @name Internal methods called holding the mutex in multi threading
     /// mode.
+    ///
+    /// Methods retrieving leases are called holding the mutex in read mode
+    /// so lookups by address, hardware address or client identifier run
+    /// in parallel. They must not modify the storage and must return copies
+    /// of the stored leases. The leases retrieved from hashed indexes are
+    /// sorted by address. Other methods are called holding the mutex in
+    /// write mode, which also serializes the appends to the lease files.
     ///@{
 
     /// @brief Adds an IPv4 lease,
@@ -757,6 +791,16 @@ private:
     /// SELECT and DELETE with different expiration time.
     bool deleteLeaseInternal(const Lease6Ptr& addr);
 
+    /// @brief Applies a batch of changes of DHCPv4 leases.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    void applyLeaseChangesInternal(LeaseChange4Collection& changes);
+
+    /// @brief Applies a batch of changes of DHCPv6 leases.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    void applyLeaseChangesInternal(LeaseChange6Collection& changes);
+
     /// @brief Removes specified IPv4 leases.
     ///
     /// @param subnet_id identifier of the subnet
@@ -785,6 +829,7 @@ private:
     /// @param universe V4 or V6.
     /// @param storage Reference to the container where leases are held.
     /// Some expired-reclaimed leases will be removed from this container.
+    /// @param counters Reference to the lease counters of the container.
     /// @param lease_file Reference to a DHCPv4 or DHCPv6 lease file
     /// instance where leases should be marked as deleted.
     ///
@@ -803,6 +848,7 @@ private:
     uint64_t deleteExpiredReclaimedLeases(const uint32_t secs,
                                           const Universe& universe,
                                           StorageType& storage,
+                                          LeaseStatsCounters& counters,
                                           LeaseFileType& lease_file) const;
 
 public:
@@ -924,10 +970,30 @@ public:
     /// server shut down.
     bool persistLeases(Universe u) const;
 
+    /// @brief Returns an estimate of the memory used by the leases.
+    ///
+    /// The stored leases share the identifiers of a client holding
+    /// several leases, see @c internLeaseIdentifiers.
+    ///
+    /// @param u Universe (V4 or V6).
+    ///
+    /// @return Estimated number of bytes used by the leases of the
+    /// universe.
+    size_t getMemoryUsage(Universe u) const;
+
     //@}
 
 private:
 
+    /// @brief Updates the statistics of the memory used by the leases.
+    ///
+    /// It sets the "memfile-lease4-memory" and "memfile-lease4-memory-per-lease"
+    /// (or "memfile-lease6-memory" and "memfile-lease6-memory-per-lease")
+    /// global statistics. It is called when the leases have been loaded
+    /// from the lease file and on each %Lease File Cleanup, so it does
+    /// nothing when the leases are not persisted.
+    void updateMemoryUsageStats();
+
 
     /// @brief Initialize the location of the lease file.
     ///
@@ -993,31 +1059,83 @@ private:
     /// the server will store lease updates.
     /// @param storage A storage for leases read from the lease file.
     /// @tparam LeaseObjectType @c Lease4 or @c Lease6.
-    /// @tparam LeaseFileType @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam CSVLeaseFileType @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseJournalType @c LeaseJournal4 or @c LeaseJournal6.
     /// @tparam StorageType @c Lease4Storage or @c Lease6Storage.
     ///
     /// @return Returns true if any of the files loaded need conversion from
     /// an older or newer schema.
     ///
-    /// @throw CSVFileError when parsing any of the lease files fails.
+    /// @throw CSVFileError when parsing any of the CSV lease files fails.
+    /// @throw LeaseJournalError when opening any of the lease journals fails.
     /// @throw DbOpenError when it is found that the LFC is in progress.
-    template<typename LeaseObjectType, typename LeaseFileType,
-             typename StorageType>
+    template<typename LeaseObjectType, typename CSVLeaseFileType,
+             typename LeaseJournalType, typename StorageType>
     bool loadLeasesFromFiles(const std::string& filename,
-                             boost::shared_ptr<LeaseFileType>& lease_file,
+                             boost::shared_ptr<LeaseFile<LeaseObjectType> >& lease_file,
                              StorageType& storage);
 
+    /// @brief Loads leases from a CSV lease file or a lease journal.
+    ///
+    /// The format of the file is selected by @c LeaseJournal::useJournal.
+    ///
+    /// @param filename Name of the lease file.
+    /// @param storage A storage for leases read from the lease file.
+    /// @param max_row_errors Maximum number of errors tolerated while
+    /// reading the file.
+    /// @param close_file_on_exit A boolean flag which indicates if the file
+    /// should be closed after it has been read.
+    /// @param thread_count Number of threads parsing the leases.
+    /// @tparam LeaseObjectType @c Lease4 or @c Lease6.
+    /// @tparam CSVLeaseFileType @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseJournalType @c LeaseJournal4 or @c LeaseJournal6.
+    /// @tparam StorageType @c Lease4Storage or @c Lease6Storage.
+    ///
+    /// @return Pointer to the object representing the lease file.
+    template<typename LeaseObjectType, typename CSVLeaseFileType,
+             typename LeaseJournalType, typename StorageType>
+    static boost::shared_ptr<LeaseFile<LeaseObjectType> >
+    loadLeaseFile(const std::string& filename, StorageType& storage,
+                  const uint32_t max_row_errors, const bool close_file_on_exit,
+                  const uint32_t thread_count);
+
+    /// @brief Returns the lease file write policy and its parameters.
+    ///
+    /// @return The values of the "write-policy", "write-interval",
+    /// "write-batch-size" and "write-queue-size" parameters or their
+    /// defaults.
+    /// @throw BadValue if a parameter has an invalid value.
+    LeaseWriteConfig getLeaseWriteConfig() const;
+
+    /// @brief Applies the write policy to the lease file.
+    ///
+    /// The lease file is replaced with a @c LeaseFileWriter unless the
+    /// lease updates are written directly.
+    ///
+    /// @param [in,out] lease_file Pointer to the open lease file.
+    /// @param stats_prefix Prefix of the names of the writer statistics.
+    /// @tparam LeaseObjectType @c Lease4 or @c Lease6.
+    template<typename LeaseObjectType>
+    void setupLeaseFileWriter(boost::shared_ptr<LeaseFile<LeaseObjectType> >& lease_file,
+                              const std::string& stats_prefix);
+
     /// @brief stores IPv4 leases
     Lease4Storage storage4_;
 
     /// @brief stores IPv6 leases
     Lease6Storage storage6_;
 
+    /// @brief counts IPv4 leases by subnet and state
+    LeaseStatsCounters counters4_;
+
+    /// @brief counts IPv6 leases by subnet, lease type and state
+    LeaseStatsCounters counters6_;
+
     /// @brief Holds the pointer to the DHCPv4 lease file IO.
-    boost::shared_ptr<CSVLeaseFile4> lease_file4_;
+    LeaseFile4Ptr lease_file4_;
 
     /// @brief Holds the pointer to the DHCPv6 lease file IO.
-    boost::shared_ptr<CSVLeaseFile6> lease_file6_;
+    LeaseFile6Ptr lease_file6_;
 
 public:
 
@@ -1164,7 +1282,7 @@ private:
     /// @param lease_file A pointer to the object representing the Current
     /// %Lease File (DHCPv4 or DHCPv6 lease file).
     ///
-    /// @tparam LeaseFileType One of @c CSVLeaseFile4 or @c CSVLeaseFile6.
+    /// @tparam LeaseFileType One of @c LeaseFile4 or @c LeaseFile6.
     template<typename LeaseFileType>
     void lfcExecute(boost::shared_ptr<LeaseFileType>& lease_file);
 
@@ -1179,8 +1297,8 @@ private:
 
     //@}
 
-    /// @brief Manager mutex
-    boost::scoped_ptr<std::mutex> mutex_;
+    /// @brief Manager read-write mutex
+    boost::scoped_ptr<isc::util::ReadWriteMutex> mutex_;
 };
 
 }  // namespace dhcp
@@ -0,0 +1,229 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/memfile_lease_storage.h>
+
+#include <boost/mpl/size.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+using namespace isc::data;
+
+namespace {
+
+/// @brief Estimated size of the reference counter of a shared pointer.
+const size_t SHARED_COUNTER_SIZE = 3 * sizeof(void*);
+
+/// @brief Estimated size of a node of an index, including the bucket
+/// of the hashed indexes.
+const size_t INDEX_NODE_SIZE = 3 * sizeof(void*);
+
+/// @brief Returns the number of bytes allocated by a string.
+///
+/// Short strings are stored within the string object and don't
+/// allocate any memory.
+///
+/// @param str String.
+/// @return Number of bytes allocated outside the string object.
+size_t
+getStringMemoryUsage(const std::string& str) {
+    const uintptr_t data = reinterpret_cast<uintptr_t>(str.data());
+    const uintptr_t object = reinterpret_cast<uintptr_t>(&str);
+    if ((data >= object) && (data < object + sizeof(str))) {
+        return (0);
+    }
+    return (str.capacity() + 1);
+}
+
+/// @brief Returns the share of the memory of an object a pointer holds.
+///
+/// The memory used by the object is divided by the number of pointers
+/// sharing it.
+///
+/// @param object Pointer to the object.
+/// @param size Number of bytes used by the object.
+/// @return Share of the memory used by the object.
+template<typename ObjectPtr>
+double
+getSharedMemoryUsage(const ObjectPtr& object, const size_t size) {
+    if (!object) {
+        return (0.);
+    }
+    return (static_cast<double>(size + SHARED_COUNTER_SIZE) /
+            object.use_count());
+}
+
+/// @brief Returns the share of the memory used by a user context.
+///
+/// @param context User context or null.
+/// @return Share of the memory used by the user context.
+double
+getContextMemoryUsage(const ConstElementPtr& context) {
+    if (!context) {
+        return (0.);
+    }
+    // The textual representation is a fair estimate of the size of
+    // a user context which usually holds a few short strings.
+    return (getSharedMemoryUsage(context, context->str().size()));
+}
+
+/// @brief Returns the share of the memory used by a HW address.
+///
+/// @param hwaddr HW address or null.
+/// @return Share of the memory used by the HW address.
+double
+getHWAddrMemoryUsage(const isc::dhcp::HWAddrPtr& hwaddr) {
+    if (!hwaddr) {
+        return (0.);
+    }
+    return (getSharedMemoryUsage(hwaddr, sizeof(isc::dhcp::HWAddr) +
+                                 hwaddr->hwaddr_.capacity()));
+}
+
+} // end of anonymous namespace
+
+namespace isc {
+namespace dhcp {
+
+void
+internLeaseIdentifiers(const Lease4Storage& storage, const Lease4Ptr& lease) {
+    if (lease->hwaddr_) {
+        const Lease4StorageHWAddressIndex& index =
+            storage.get<HWAddressIndexTag>();
+        auto range = index.equal_range(lease->hwaddr_->hwaddr_);
+        for (auto it = range.first; it != range.second; ++it) {
+            const HWAddrPtr& hwaddr = (*it)->hwaddr_;
+            if (hwaddr && (*hwaddr == *lease->hwaddr_)) {
+                lease->hwaddr_ = hwaddr;
+                break;
+            }
+        }
+    }
+
+    if (lease->client_id_) {
+        const Lease4StorageClientIdIndex& index =
+            storage.get<ClientIdIndexTag>();
+        auto range = index.equal_range(lease->client_id_->getClientId());
+        for (auto it = range.first; it != range.second; ++it) {
+            const ClientIdPtr& client_id = (*it)->client_id_;
+            if (client_id) {
+                lease->client_id_ = client_id;
+                break;
+            }
+        }
+    }
+}
+
+void
+internLeaseIdentifiers(const Lease6Storage& storage, const Lease6Ptr& lease) {
+    if (!lease->duid_) {
+        return;
+    }
+
+    // The HW address is taken from the leases of the same client.
+    bool duid_found = false;
+    bool hwaddr_found = !lease->hwaddr_;
+    const Lease6StorageDuidIndex& index = storage.get<DuidIndexTag>();
+    auto range = index.equal_range(lease->duid_->getDuid());
+    for (auto it = range.first;
+         (it != range.second) && (!duid_found || !hwaddr_found); ++it) {
+        const Lease6Ptr& stored = *it;
+        if (!duid_found && stored->duid_) {
+            lease->duid_ = stored->duid_;
+            duid_found = true;
+        }
+        if (!hwaddr_found && stored->hwaddr_ &&
+            (*stored->hwaddr_ == *lease->hwaddr_)) {
+            lease->hwaddr_ = stored->hwaddr_;
+            hwaddr_found = true;
+        }
+    }
+}
+
+size_t
+getLeaseStorageMemoryUsage(const Lease4Storage& storage) {
+    const size_t node_size = sizeof(Lease4Ptr) + INDEX_NODE_SIZE *
+        boost::mpl::size<Lease4Storage::index_type_list>::value;
+
+    double usage = 0.;
+    for (auto const& lease : storage) {
+        usage += node_size + sizeof(Lease4) + SHARED_COUNTER_SIZE;
+        usage += getStringMemoryUsage(lease->hostname_);
+        usage += getHWAddrMemoryUsage(lease->hwaddr_);
+        if (lease->client_id_) {
+            usage += getSharedMemoryUsage(lease->client_id_, sizeof(ClientId) +
+                                          lease->client_id_->getClientId().capacity());
+        }
+        usage += getContextMemoryUsage(lease->getContext());
+    }
+    return (static_cast<size_t>(usage));
+}
+
+size_t
+getLeaseStorageMemoryUsage(const Lease6Storage& storage) {
+    const size_t node_size = sizeof(Lease6Ptr) + INDEX_NODE_SIZE *
+        boost::mpl::size<Lease6Storage::index_type_list>::value;
+
+    double usage = 0.;
+    for (auto const& lease : storage) {
+        usage += node_size + sizeof(Lease6) + SHARED_COUNTER_SIZE;
+        usage += getStringMemoryUsage(lease->hostname_);
+        usage += getHWAddrMemoryUsage(lease->hwaddr_);
+        if (lease->duid_) {
+            usage += getSharedMemoryUsage(lease->duid_, sizeof(DUID) +
+                                          lease->duid_->getDuid().capacity());
+        }
+        usage += getContextMemoryUsage(lease->getContext());
+    }
+    return (static_cast<size_t>(usage));
+}
+
+void
+LeaseStatsCounters::remove(const Key& key) {
+    auto counter = counters_.find(key);
+    if (counter == counters_.end()) {
+        return;
+    }
+    if (--counter->second <= 0) {
+        counters_.erase(counter);
+    }
+}
+
+void
+LeaseStatsCounters::reset(const Lease4Storage& storage) {
+    counters_.clear();
+    for (auto const& lease : storage) {
+        insert(*lease);
+    }
+}
+
+void
+LeaseStatsCounters::reset(const Lease6Storage& storage) {
+    counters_.clear();
+    for (auto const& lease : storage) {
+        insert(*lease);
+    }
+}
+
+std::pair<LeaseStatsCounters::CounterMap::const_iterator,
+          LeaseStatsCounters::CounterMap::const_iterator>
+LeaseStatsCounters::getRange(const SubnetID& first_subnet_id,
+                             const SubnetID& last_subnet_id) const {
+    // Lease::TYPE_NA and Lease::TYPE_V4 are the lowest and the highest
+    // lease types.
+    return (std::make_pair(counters_.lower_bound(Key(first_subnet_id,
+                                                     Lease::TYPE_NA, 0)),
+                           counters_.upper_bound(Key(last_subnet_id,
+                                                     Lease::TYPE_V4,
+                                                     std::numeric_limits<uint32_t>::max()))));
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,6 +11,8 @@
 #include <dhcpsrv/lease.h>
 #include <dhcpsrv/subnet_id.h>
 
+#include <boost/functional/hash.hpp>
+#include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/indexed_by.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/mem_fun.hpp>
@@ -18,6 +20,8 @@
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/composite_key.hpp>
 
+#include <map>
+#include <tuple>
 #include <vector>
 
 namespace isc {
@@ -27,17 +31,20 @@ namespace dhcp {
 /// @brief Tag for indexes by address.
 struct AddressIndexTag { };
 
+/// @brief Tag for hashed indexes by address.
+struct HashedAddressIndexTag { };
+
 /// @brief Tag for indexes by DUID, IAID, lease type tuple.
 struct DuidIaidTypeIndexTag { };
 
 /// @brief Tag for indexes by expiration time.
 struct ExpirationIndexTag { };
 
-/// @brief Tag for indexes by HW address, subnet identifier tuple.
-struct HWAddressSubnetIdIndexTag { };
+/// @brief Tag for indexes by HW address.
+struct HWAddressIndexTag { };
 
-/// @brief Tag for indexes by client and subnet identifiers.
-struct ClientIdSubnetIdIndexTag { };
+/// @brief Tag for indexes by client identifier.
+struct ClientIdIndexTag { };
 
 /// @brief Tag for indexes by client id, HW address and subnet id.
 struct ClientIdHWAddressSubnetIdIndexTag { };
@@ -58,12 +65,19 @@ struct HostnameIndexTag { };
 /// @brief A multi index container holding DHCPv6 leases.
 ///
 /// The leases in the container may be accessed using different indexes:
-/// - using an IPv6 address,
+/// - using an IPv6 address, ordered or hashed,
 /// - using a composite index: DUID, IAID and lease type.
 /// - using a composite index: boolean flag indicating if the state is
 ///   "expired-reclaimed" and expiration time.
+/// - using a subnet identifier,
+/// - using a DUID,
+/// - using a hostname.
+///
+/// The indexes used for exact match lookups are hashed. Ordered indexes
+/// are kept where range scans are needed: address paging, expiration
+/// time and subnet identifier.
 ///
-/// Indexes can be accessed using the index number (from 0 to 2) or a
+/// Indexes can be accessed using the index number (from 0 to 6) or a
 /// name tag. It is recommended to use the tags to access indexes as
 /// they do not depend on the order of indexes in the container.
 typedef boost::multi_index_container<
@@ -79,7 +93,14 @@ typedef boost::multi_index_container<
         >,
 
         // Specification of the second index starts here.
-        boost::multi_index::ordered_non_unique<
+        // This index is used for exact match lookups by IPv6 address.
+        boost::multi_index::hashed_unique<
+            boost::multi_index::tag<HashedAddressIndexTag>,
+            boost::multi_index::member<Lease, isc::asiolink::IOAddress, &Lease::addr_>
+        >,
+
+        // Specification of the third index starts here.
+        boost::multi_index::hashed_non_unique<
             boost::multi_index::tag<DuidIaidTypeIndexTag>,
             // This is a composite index that will be used to search for
             // the lease using three attributes: DUID, IAID and lease type.
@@ -96,7 +117,7 @@ typedef boost::multi_index_container<
             >
         >,
 
-        // Specification of the third index starts here.
+        // Specification of the fourth index starts here.
         boost::multi_index::ordered_non_unique<
             boost::multi_index::tag<ExpirationIndexTag>,
             // This is a composite index that will be used to search for
@@ -114,7 +135,7 @@ typedef boost::multi_index_container<
             >
         >,
 
-        // Specification of the fourth index starts here.
+        // Specification of the fifth index starts here.
         // This index sorts leases by SubnetID.
         boost::multi_index::ordered_non_unique<
             boost::multi_index::tag<SubnetIdIndexTag>,
@@ -122,18 +143,18 @@ typedef boost::multi_index_container<
             &Lease::subnet_id_>
         >,
 
-        // Specification of the fifth index starts here
+        // Specification of the sixth index starts here.
         // This index is used to retrieve leases for matching duid.
-        boost::multi_index::ordered_non_unique<
+        boost::multi_index::hashed_non_unique<
             boost::multi_index::tag<DuidIndexTag>,
             boost::multi_index::const_mem_fun<Lease6,
                                               const std::vector<uint8_t>&,
                                               &Lease6::getDuidVector>
         >,
 
-        // Specification of the sixth index starts here
+        // Specification of the seventh index starts here.
         // This index is used to retrieve leases for matching hostname.
-        boost::multi_index::ordered_non_unique<
+        boost::multi_index::hashed_non_unique<
             boost::multi_index::tag<HostnameIndexTag>,
             boost::multi_index::member<Lease, std::string, &Lease::hostname_>
         >
@@ -143,14 +164,23 @@ typedef boost::multi_index_container<
 /// @brief A multi index container holding DHCPv4 leases.
 ///
 /// The leases in the container may be accessed using different indexes:
-/// - IPv6 address,
-/// - composite index: HW address and subnet id,
-/// - composite index: client id and subnet id,
+/// - IPv4 address, ordered or hashed,
+/// - HW address,
+/// - client id,
 /// - composite index: HW address, client id and subnet id
 /// - using a composite index: boolean flag indicating if the state is
 ///   "expired-reclaimed" and expiration time.
+/// - subnet id,
+/// - hostname.
+///
+/// The indexes used for exact match lookups are hashed. Ordered indexes
+/// are kept where range scans are needed: address paging, expiration
+/// time and subnet identifier. The HW address and client id indexes do
+/// not include the subnet id because the leases of a client are also
+/// retrieved for all subnets: the lookups within a subnet filter the
+/// few leases sharing the HW address or client id.
 ///
-/// Indexes can be accessed using the index number (from 0 to 4) or a
+/// Indexes can be accessed using the index number (from 0 to 7) or a
 /// name tag. It is recommended to use the tags to access indexes as
 /// they do not depend on the order of indexes in the container.
 typedef boost::multi_index_container<
@@ -169,44 +199,34 @@ typedef boost::multi_index_container<
         >,
 
         // Specification of the second index starts here.
-        boost::multi_index::ordered_non_unique<
-            boost::multi_index::tag<HWAddressSubnetIdIndexTag>,
-            // This is a composite index that combines two attributes of the
-            // Lease4 object: hardware address and subnet id.
-            boost::multi_index::composite_key<
-                Lease4,
-                // The hardware address is held in the hwaddr_ member of the
-                // Lease4 object, which is a HWAddr object. Boost does not
-                // provide a key extractor for getting a member of a member,
-                // so we need a simple method for that.
-                boost::multi_index::const_mem_fun<Lease, const std::vector<uint8_t>&,
-                                                  &Lease::getHWAddrVector>,
-                // The subnet id is held in the subnet_id_ member of Lease4
-                // class. Note that the subnet_id_ is defined in the base
-                // class (Lease) so we have to point to this class rather
-                // than derived class: Lease4.
-                boost::multi_index::member<Lease, SubnetID, &Lease::subnet_id_>
-            >
+        // This index is used for exact match lookups by IPv4 address.
+        boost::multi_index::hashed_unique<
+            boost::multi_index::tag<HashedAddressIndexTag>,
+            boost::multi_index::member<Lease, isc::asiolink::IOAddress, &Lease::addr_>
         >,
 
         // Specification of the third index starts here.
-        boost::multi_index::ordered_non_unique<
-            boost::multi_index::tag<ClientIdSubnetIdIndexTag>,
-            // This is a composite index that uses two values to search for a
-            // lease: client id and subnet id.
-            boost::multi_index::composite_key<
-                Lease4,
-                // The client id can be retrieved from the Lease4 object by
-                // calling getClientIdVector const function.
-                boost::multi_index::const_mem_fun<Lease4, const std::vector<uint8_t>&,
-                                                  &Lease4::getClientIdVector>,
-                // The subnet id is accessed through the subnet_id_ member.
-                boost::multi_index::member<Lease, uint32_t, &Lease::subnet_id_>
-            >
+        boost::multi_index::hashed_non_unique<
+            boost::multi_index::tag<HWAddressIndexTag>,
+            // The hardware address is held in the hwaddr_ member of the
+            // Lease4 object, which is a HWAddr object. Boost does not
+            // provide a key extractor for getting a member of a member,
+            // so we need a simple method for that.
+            boost::multi_index::const_mem_fun<Lease, const std::vector<uint8_t>&,
+                                              &Lease::getHWAddrVector>
         >,
 
         // Specification of the fourth index starts here.
-        boost::multi_index::ordered_non_unique<
+        boost::multi_index::hashed_non_unique<
+            boost::multi_index::tag<ClientIdIndexTag>,
+            // The client id can be retrieved from the Lease4 object by
+            // calling getClientIdVector const function.
+            boost::multi_index::const_mem_fun<Lease4, const std::vector<uint8_t>&,
+                                              &Lease4::getClientIdVector>
+        >,
+
+        // Specification of the fifth index starts here.
+        boost::multi_index::hashed_non_unique<
             boost::multi_index::tag<ClientIdHWAddressSubnetIdIndexTag>,
             // This is a composite index that uses three values to search for a
             // lease: client id, HW address and subnet id.
@@ -227,7 +247,7 @@ typedef boost::multi_index_container<
             >
         >,
 
-        // Specification of the fifth index starts here.
+        // Specification of the sixth index starts here.
         boost::multi_index::ordered_non_unique<
             boost::multi_index::tag<ExpirationIndexTag>,
             // This is a composite index that will be used to search for
@@ -245,7 +265,7 @@ typedef boost::multi_index_container<
             >
         >,
 
-        // Specification of the sixth index starts here.
+        // Specification of the seventh index starts here.
         // This index sorts leases by SubnetID.
         boost::multi_index::ordered_non_unique<
             boost::multi_index::tag<SubnetIdIndexTag>,
@@ -253,9 +273,9 @@ typedef boost::multi_index_container<
         >,
 
 
-        // Specification of the seventh index starts here
+        // Specification of the eighth index starts here.
         // This index is used to retrieve leases for matching hostname.
-        boost::multi_index::ordered_non_unique<
+        boost::multi_index::hashed_non_unique<
             boost::multi_index::tag<HostnameIndexTag>,
             boost::multi_index::member<Lease, std::string, &Lease::hostname_>
         >
@@ -271,6 +291,10 @@ typedef boost::multi_index_container<
 /// @brief DHCPv6 lease storage index by address.
 typedef Lease6Storage::index<AddressIndexTag>::type Lease6StorageAddressIndex;
 
+/// @brief DHCPv6 lease storage hashed index by address.
+typedef Lease6Storage::index<HashedAddressIndexTag>::type
+Lease6StorageHashedAddressIndex;
+
 /// @brief DHCPv6 lease storage index by DUID, IAID, lease type.
 typedef Lease6Storage::index<DuidIaidTypeIndexTag>::type Lease6StorageDuidIaidTypeIndex;
 
@@ -280,7 +304,7 @@ typedef Lease6Storage::index<ExpirationIndexTag>::type Lease6StorageExpirationIn
 /// @brief DHCPv6 lease storage index by Subnet-id.
 typedef Lease6Storage::index<SubnetIdIndexTag>::type Lease6StorageSubnetIdIndex;
 
-/// @brief DHCPv6 lease storage index by Subnet-id.
+/// @brief DHCPv6 lease storage index by DUID.
 typedef Lease6Storage::index<DuidIndexTag>::type Lease6StorageDuidIndex;
 
 /// @brief DHCPv6 lease storage index by hostname.
@@ -289,28 +313,173 @@ typedef Lease6Storage::index<HostnameIndexTag>::type Lease6StorageHostnameIndex;
 /// @brief DHCPv4 lease storage index by address.
 typedef Lease4Storage::index<AddressIndexTag>::type Lease4StorageAddressIndex;
 
+/// @brief DHCPv4 lease storage hashed index by address.
+typedef Lease4Storage::index<HashedAddressIndexTag>::type
+Lease4StorageHashedAddressIndex;
+
 /// @brief DHCPv4 lease storage index by expiration time.
 typedef Lease4Storage::index<ExpirationIndexTag>::type Lease4StorageExpirationIndex;
 
-/// @brief DHCPv4 lease storage index by HW address and subnet identifier.
-typedef Lease4Storage::index<HWAddressSubnetIdIndexTag>::type
-Lease4StorageHWAddressSubnetIdIndex;
+/// @brief DHCPv4 lease storage index by HW address.
+typedef Lease4Storage::index<HWAddressIndexTag>::type Lease4StorageHWAddressIndex;
 
-/// @brief DHCPv4 lease storage index by client and subnet identifier.
-typedef Lease4Storage::index<ClientIdSubnetIdIndexTag>::type
-Lease4StorageClientIdSubnetIdIndex;
+/// @brief DHCPv4 lease storage index by client identifier.
+typedef Lease4Storage::index<ClientIdIndexTag>::type Lease4StorageClientIdIndex;
 
 /// @brief DHCPv4 lease storage index by client id, HW address and subnet id.
 typedef Lease4Storage::index<ClientIdHWAddressSubnetIdIndexTag>::type
 Lease4StorageClientIdHWAddressSubnetIdIndex;
 
-/// @brief DHCPv4 lease storage index by client id, HW address and subnet id.
+/// @brief DHCPv4 lease storage index by subnet identifier.
 typedef Lease4Storage::index<SubnetIdIndexTag>::type Lease4StorageSubnetIdIndex;
 
 /// @brief DHCPv4 lease storage index by hostname.
 typedef Lease4Storage::index<HostnameIndexTag>::type Lease4StorageHostnameIndex;
 
 //@}
+
+/// @name Memory management of the lease storages
+///
+//@{
+
+/// @brief Shares the identifiers of a DHCPv4 lease with the stored leases.
+///
+/// The HW address and the client identifier of the lease are replaced
+/// with equal objects held by the leases already in the storage, if any,
+/// so the storage keeps a single copy of the identifiers of a client
+/// holding several leases. This function must be called before the
+/// lease is inserted into the storage.
+///
+/// @param storage DHCPv4 lease storage.
+/// @param lease Lease to be inserted into the storage.
+void internLeaseIdentifiers(const Lease4Storage& storage,
+                            const Lease4Ptr& lease);
+
+/// @brief Shares the identifiers of a DHCPv6 lease with the stored leases.
+///
+/// The DUID and the HW address of the lease are replaced with equal
+/// objects held by the stored leases of the same client, if any.
+///
+/// @param storage DHCPv6 lease storage.
+/// @param lease Lease to be inserted into the storage.
+void internLeaseIdentifiers(const Lease6Storage& storage,
+                            const Lease6Ptr& lease);
+
+/// @brief Returns an estimate of the memory used by the DHCPv4 leases.
+///
+/// The estimate includes the lease objects, the identifiers, the
+/// hostnames, the user contexts and the index nodes of the container.
+/// The identifiers shared by several leases are accounted once.
+///
+/// @param storage DHCPv4 lease storage.
+/// @return Estimated number of bytes used by the storage.
+size_t getLeaseStorageMemoryUsage(const Lease4Storage& storage);
+
+/// @brief Returns an estimate of the memory used by the DHCPv6 leases.
+///
+/// @param storage DHCPv6 lease storage.
+/// @return Estimated number of bytes used by the storage.
+size_t getLeaseStorageMemoryUsage(const Lease6Storage& storage);
+
+//@}
+
+/// @name Lease statistics of the lease storages
+///
+//@{
+
+/// @brief Counters of the stored leases by subnet, lease type and state.
+///
+/// The Memfile backend updates the counters each time a lease is inserted
+/// into, replaced in or removed from a lease storage, so the lease
+/// statistics can be recounted without iterating over the stored leases.
+class LeaseStatsCounters {
+public:
+
+    /// @brief Key of a counter: subnet identifier, lease type and state.
+    typedef std::tuple<SubnetID, Lease::Type, uint32_t> Key;
+
+    /// @brief Container of the counters ordered by subnet identifier.
+    ///
+    /// Only non-zero counters are held.
+    typedef std::map<Key, int64_t> CounterMap;
+
+    /// @brief Counts a lease inserted into the storage.
+    ///
+    /// Records the subnet identifier and the state the lease is counted
+    /// under in the lease.
+    ///
+    /// @param lease Inserted DHCPv4 lease.
+    void insert(Lease4& lease) {
+        lease.stats_subnet_id_ = lease.subnet_id_;
+        lease.stats_state_ = lease.state_;
+        ++counters_[Key(lease.subnet_id_, Lease::TYPE_V4, lease.state_)];
+    }
+
+    /// @brief Counts a lease inserted into the storage.
+    ///
+    /// Records the subnet identifier and the state the lease is counted
+    /// under in the lease.
+    ///
+    /// @param lease Inserted DHCPv6 lease.
+    void insert(Lease6& lease) {
+        lease.stats_subnet_id_ = lease.subnet_id_;
+        lease.stats_state_ = lease.state_;
+        ++counters_[Key(lease.subnet_id_, lease.type_, lease.state_)];
+    }
+
+    /// @brief Uncounts a lease removed from the storage.
+    ///
+    /// @param lease Removed DHCPv4 lease.
+    void remove(const Lease4& lease) {
+        remove(Key(lease.stats_subnet_id_, Lease::TYPE_V4,
+                   lease.stats_state_));
+    }
+
+    /// @brief Uncounts a lease removed from the storage.
+    ///
+    /// @param lease Removed DHCPv6 lease.
+    void remove(const Lease6& lease) {
+        remove(Key(lease.stats_subnet_id_, lease.type_, lease.stats_state_));
+    }
+
+    /// @brief Recounts the leases of a storage.
+    ///
+    /// @param storage DHCPv4 lease storage.
+    void reset(const Lease4Storage& storage);
+
+    /// @brief Recounts the leases of a storage.
+    ///
+    /// @param storage DHCPv6 lease storage.
+    void reset(const Lease6Storage& storage);
+
+    /// @brief Returns the counters of a range of subnets.
+    ///
+    /// @param first_subnet_id Identifier of the first subnet of the range.
+    /// @param last_subnet_id Identifier of the last subnet of the range.
+    /// @return Pair of iterators delimiting the counters of the subnets
+    /// in ascending order of subnet identifier, lease type and state.
+    std::pair<CounterMap::const_iterator, CounterMap::const_iterator>
+    getRange(const SubnetID& first_subnet_id,
+             const SubnetID& last_subnet_id) const;
+
+    /// @brief Returns all counters.
+    const CounterMap& getAll() const {
+        return (counters_);
+    }
+
+private:
+
+    /// @brief Decrements a counter and removes it when it drops to zero.
+    ///
+    /// @param key Key of the counter.
+    void remove(const Key& key);
+
+    /// @brief The counters.
+    CounterMap counters_;
+};
+
+//@}
+
 } // end of isc::dhcp namespace
 } // end of isc namespace
 
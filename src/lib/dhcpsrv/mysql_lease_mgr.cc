@@ -1857,6 +1857,16 @@ MySqlLeaseMgr::addLeaseCommon(MySqlLeaseContextPtr& ctx,
     return (true);
 }
 
+bool
+MySqlLeaseMgr::addLeaseInternal(MySqlLeaseContextPtr& ctx,
+                                const Lease4Ptr& lease) {
+    // Create the MYSQL_BIND array for the lease
+    std::vector<MYSQL_BIND> bind = ctx->exchange4_->createBindForSend(lease);
+
+    // ... and drop to common code.
+    return (addLeaseCommon(ctx, INSERT_LEASE4, bind));
+}
+
 bool
 MySqlLeaseMgr::addLease(const Lease4Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_ADD_ADDR4)
@@ -1866,11 +1876,7 @@ MySqlLeaseMgr::addLease(const Lease4Ptr& lease) {
     MySqlLeaseContextAlloc get_context(*this);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
 
-    // Create the MYSQL_BIND array for the lease
-    std::vector<MYSQL_BIND> bind = ctx->exchange4_->createBindForSend(lease);
-
-    // ... and drop to common code.
-    auto result = addLeaseCommon(ctx, INSERT_LEASE4, bind);
+    auto result = addLeaseInternal(ctx, lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -1879,6 +1885,16 @@ MySqlLeaseMgr::addLease(const Lease4Ptr& lease) {
     return (result);
 }
 
+bool
+MySqlLeaseMgr::addLeaseInternal(MySqlLeaseContextPtr& ctx,
+                                const Lease6Ptr& lease) {
+    // Create the MYSQL_BIND array for the lease
+    std::vector<MYSQL_BIND> bind = ctx->exchange6_->createBindForSend(lease);
+
+    // ... and drop to common code.
+    return (addLeaseCommon(ctx, INSERT_LEASE6, bind));
+}
+
 bool
 MySqlLeaseMgr::addLease(const Lease6Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_ADD_ADDR6)
@@ -1889,11 +1905,7 @@ MySqlLeaseMgr::addLease(const Lease6Ptr& lease) {
     MySqlLeaseContextAlloc get_context(*this);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
 
-    // Create the MYSQL_BIND array for the lease
-    std::vector<MYSQL_BIND> bind = ctx->exchange6_->createBindForSend(lease);
-
-    // ... and drop to common code.
-    auto result = addLeaseCommon(ctx, INSERT_LEASE6, bind);
+    auto result = addLeaseInternal(ctx, lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -2736,16 +2748,10 @@ MySqlLeaseMgr::updateLeaseCommon(MySqlLeaseContextPtr& ctx,
 }
 
 void
-MySqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
+MySqlLeaseMgr::updateLease4Internal(MySqlLeaseContextPtr& ctx,
+                                    const Lease4Ptr& lease) {
     const StatementIndex stindex = UPDATE_LEASE4;
 
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_UPDATE_ADDR4)
-        .arg(lease->addr_.toText());
-
-    // Get a context
-    MySqlLeaseContextAlloc get_context(*this);
-    MySqlLeaseContextPtr ctx = get_context.ctx_;
-
     // Create the MYSQL_BIND array for the data being updated
     std::vector<MYSQL_BIND> bind = ctx->exchange4_->createBindForSend(lease);
 
@@ -2772,23 +2778,28 @@ MySqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
 
     // Drop to common update code
     updateLeaseCommon(ctx, stindex, &bind[0], lease);
-
-    // Update lease current expiration time.
-    lease->updateCurrentExpirationTime();
 }
 
 void
-MySqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
-    const StatementIndex stindex = UPDATE_LEASE6;
-
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_UPDATE_ADDR6)
-        .arg(lease->addr_.toText())
-        .arg(lease->type_);
+MySqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_UPDATE_ADDR4)
+        .arg(lease->addr_.toText());
 
     // Get a context
     MySqlLeaseContextAlloc get_context(*this);
     MySqlLeaseContextPtr ctx = get_context.ctx_;
 
+    updateLease4Internal(ctx, lease);
+
+    // Update lease current expiration time.
+    lease->updateCurrentExpirationTime();
+}
+
+void
+MySqlLeaseMgr::updateLease6Internal(MySqlLeaseContextPtr& ctx,
+                                    const Lease6Ptr& lease) {
+    const StatementIndex stindex = UPDATE_LEASE6;
+
     // Create the MYSQL_BIND array for the data being updated
     std::vector<MYSQL_BIND> bind = ctx->exchange6_->createBindForSend(lease);
 
@@ -2820,6 +2831,19 @@ MySqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
 
     // Drop to common update code
     updateLeaseCommon(ctx, stindex, &bind[0], lease);
+}
+
+void
+MySqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_UPDATE_ADDR6)
+        .arg(lease->addr_.toText())
+        .arg(lease->type_);
+
+    // Get a context
+    MySqlLeaseContextAlloc get_context(*this);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    updateLease6Internal(ctx, lease);
 
     // Update lease current expiration time.
     lease->updateCurrentExpirationTime();
@@ -2831,13 +2855,9 @@ MySqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
 // handles the common processing.
 
 uint64_t
-MySqlLeaseMgr::deleteLeaseCommon(StatementIndex stindex,
+MySqlLeaseMgr::deleteLeaseCommon(MySqlLeaseContextPtr& ctx,
+                                 StatementIndex stindex,
                                  MYSQL_BIND* bind) {
-
-    // Get a context
-    MySqlLeaseContextAlloc get_context(*this);
-    MySqlLeaseContextPtr ctx = get_context.ctx_;
-
     // Bind the input parameters to the statement
     int status = mysql_stmt_bind_param(ctx->conn_.statements_[stindex], bind);
     checkError(ctx, status, stindex, "unable to bind WHERE clause parameter");
@@ -2852,10 +2872,9 @@ MySqlLeaseMgr::deleteLeaseCommon(StatementIndex stindex,
 }
 
 bool
-MySqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
+MySqlLeaseMgr::deleteLeaseInternal(MySqlLeaseContextPtr& ctx,
+                                   const Lease4Ptr& lease) {
     const IOAddress& addr = lease->addr_;
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_DELETE_ADDR)
-        .arg(addr.toText());
 
     // Set up the WHERE clause value
     MYSQL_BIND inbind[2];
@@ -2875,7 +2894,7 @@ MySqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
     inbind[1].buffer = reinterpret_cast<char*>(&expire);
     inbind[1].buffer_length = sizeof(expire);
 
-    auto affected_rows = deleteLeaseCommon(DELETE_LEASE4, inbind);
+    auto affected_rows = deleteLeaseCommon(ctx, DELETE_LEASE4, inbind);
 
     // Check success case first as it is the most likely outcome.
     if (affected_rows == 1) {
@@ -2894,12 +2913,23 @@ MySqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
 }
 
 bool
-MySqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
+MySqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
     const IOAddress& addr = lease->addr_;
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
-              DHCPSRV_MYSQL_DELETE_ADDR)
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_DELETE_ADDR)
         .arg(addr.toText());
 
+    // Get a context
+    MySqlLeaseContextAlloc get_context(*this);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    return (deleteLeaseInternal(ctx, lease));
+}
+
+bool
+MySqlLeaseMgr::deleteLeaseInternal(MySqlLeaseContextPtr& ctx,
+                                   const Lease6Ptr& lease) {
+    const IOAddress& addr = lease->addr_;
+
     // Set up the WHERE clause value
     MYSQL_BIND inbind[2];
     memset(inbind, 0, sizeof(inbind));
@@ -2922,7 +2952,7 @@ MySqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
     inbind[1].buffer = reinterpret_cast<char*>(&expire);
     inbind[1].buffer_length = sizeof(expire);
 
-    auto affected_rows = deleteLeaseCommon(DELETE_LEASE6, inbind);
+    auto affected_rows = deleteLeaseCommon(ctx, DELETE_LEASE6, inbind);
 
     // Check success case first as it is the most likely outcome.
     if (affected_rows == 1) {
@@ -2940,6 +2970,135 @@ MySqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
               "that had the address " << lease->addr_.toText());
 }
 
+bool
+MySqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
+    const IOAddress& addr = lease->addr_;
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+              DHCPSRV_MYSQL_DELETE_ADDR)
+        .arg(addr.toText());
+
+    // Get a context
+    MySqlLeaseContextAlloc get_context(*this);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+    return (deleteLeaseInternal(ctx, lease));
+}
+
+void
+MySqlLeaseMgr::applyLeaseChangeInternal(MySqlLeaseContextPtr& ctx,
+                                        LeaseChange4& change) {
+    switch (change.type_) {
+    case LeaseChange4::ADD:
+        change.applied_ = addLeaseInternal(ctx, change.lease_);
+        break;
+    case LeaseChange4::UPDATE:
+        try {
+            updateLease4Internal(ctx, change.lease_);
+            change.applied_ = true;
+        } catch (const NoSuchLease& ex) {
+            // The statement has succeeded without updating any row so
+            // the transaction can go on.
+            change.error_ = ex.what();
+        }
+        break;
+    case LeaseChange4::DELETE:
+        change.applied_ = deleteLeaseInternal(ctx, change.lease_);
+        break;
+    }
+}
+
+void
+MySqlLeaseMgr::applyLeaseChangeInternal(MySqlLeaseContextPtr& ctx,
+                                        LeaseChange6& change) {
+    switch (change.type_) {
+    case LeaseChange6::ADD:
+        change.applied_ = addLeaseInternal(ctx, change.lease_);
+        break;
+    case LeaseChange6::UPDATE:
+        try {
+            updateLease6Internal(ctx, change.lease_);
+            change.applied_ = true;
+        } catch (const NoSuchLease& ex) {
+            // The statement has succeeded without updating any row so
+            // the transaction can go on.
+            change.error_ = ex.what();
+        }
+        break;
+    case LeaseChange6::DELETE:
+        change.applied_ = deleteLeaseInternal(ctx, change.lease_);
+        break;
+    }
+}
+
+template <typename LeaseChangeCollection>
+void
+MySqlLeaseMgr::applyLeaseChangesCommon(LeaseChangeCollection& changes) {
+    typedef typename LeaseChangeCollection::value_type LeaseChangeType;
+
+    if (changes.empty()) {
+        return;
+    }
+
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+              DHCPSRV_MYSQL_APPLY_LEASE_CHANGES).arg(changes.size());
+
+    bool committed = false;
+    {
+        // Get a context
+        MySqlLeaseContextAlloc get_context(*this);
+        MySqlLeaseContextPtr ctx = get_context.ctx_;
+
+        // Apply all changes within a single transaction so as the batch
+        // costs one commit rather than one per lease.
+        try {
+            ctx->conn_.startTransaction();
+            for (auto& change : changes) {
+                applyLeaseChangeInternal(ctx, change);
+            }
+            ctx->conn_.commit();
+            committed = true;
+
+        } catch (const std::exception& ex) {
+            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+                      DHCPSRV_MYSQL_APPLY_LEASE_CHANGES_FAILED).arg(ex.what());
+            try {
+                ctx->conn_.rollback();
+            } catch (...) {
+                // The connection is unusable so there is nothing to roll back.
+            }
+        }
+    }
+
+    if (!committed) {
+        // Apply the changes one by one, so the failure of a change does not
+        // affect the other changes.
+        for (auto& change : changes) {
+            change.applied_ = false;
+            change.error_.clear();
+        }
+        LeaseMgr::applyLeaseChanges(changes);
+        return;
+    }
+
+    // Update lease current expiration time of the committed leases.
+    for (auto& change : changes) {
+        if ((change.type_ == LeaseChangeType::ADD) ||
+            ((change.type_ == LeaseChangeType::UPDATE) && change.applied_)) {
+            change.lease_->updateCurrentExpirationTime();
+        }
+    }
+}
+
+void
+MySqlLeaseMgr::applyLeaseChanges(LeaseChange4Collection& changes) {
+    applyLeaseChangesCommon(changes);
+}
+
+void
+MySqlLeaseMgr::applyLeaseChanges(LeaseChange6Collection& changes) {
+    applyLeaseChangesCommon(changes);
+}
+
 uint64_t
 MySqlLeaseMgr::deleteExpiredReclaimedLeases4(const uint32_t secs) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_DELETE_EXPIRED_RECLAIMED4)
@@ -2974,8 +3133,12 @@ MySqlLeaseMgr::deleteExpiredReclaimedLeasesCommon(const uint32_t secs,
     inbind[1].buffer = reinterpret_cast<char*>(&expire_time);
     inbind[1].buffer_length = sizeof(expire_time);
 
+    // Get a context
+    MySqlLeaseContextAlloc get_context(*this);
+    MySqlLeaseContextPtr ctx = get_context.ctx_;
+
     // Get the number of deleted leases and log it.
-    uint64_t deleted_leases = deleteLeaseCommon(statement_index, inbind);
+    uint64_t deleted_leases = deleteLeaseCommon(ctx, statement_index, inbind);
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_DELETED_EXPIRED_RECLAIMED)
         .arg(deleted_leases);
 
@@ -518,6 +518,24 @@ public:
     /// different expiration time.
     virtual bool deleteLease(const Lease6Ptr& lease);
 
+    /// @brief Applies a batch of changes of DHCPv4 leases.
+    ///
+    /// The changes are applied within a single transaction. If the
+    /// transaction fails it is rolled back and the changes are applied
+    /// one by one.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    virtual void applyLeaseChanges(LeaseChange4Collection& changes);
+
+    /// @brief Applies a batch of changes of DHCPv6 leases.
+    ///
+    /// The changes are applied within a single transaction. If the
+    /// transaction fails it is rolled back and the changes are applied
+    /// one by one.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    virtual void applyLeaseChanges(LeaseChange6Collection& changes);
+
     /// @brief Deletes all expired-reclaimed DHCPv4 leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
@@ -732,6 +750,24 @@ private:
     bool addLeaseCommon(MySqlLeaseContextPtr& ctx,
                         StatementIndex stindex, std::vector<MYSQL_BIND>& bind);
 
+    /// @brief Adds an IPv4 lease using the given context.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be added.
+    ///
+    /// @return true if the lease was added, false if a lease with that
+    ///         address already exists in the database.
+    bool addLeaseInternal(MySqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Adds an IPv6 lease using the given context.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be added.
+    ///
+    /// @return true if the lease was added, false if a lease with that
+    ///         address already exists in the database.
+    bool addLeaseInternal(MySqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
     /// @brief Get Lease Collection Common Code
     ///
     /// This method performs the common actions for obtaining multiple leases
@@ -885,6 +921,7 @@ private:
     /// to the prepared statement, executes the statement and checks to
     /// see how many rows were deleted.
     ///
+    /// @param ctx Context
     /// @param stindex Index of prepared statement to be executed
     /// @param bind Array of MYSQL_BIND objects representing the parameters.
     ///        (Note that the number is determined by the number of parameters
@@ -894,9 +931,79 @@ private:
     ///
     /// @throw isc::db::DbOperationError An operation on the open database has
     ///        failed.
-    uint64_t deleteLeaseCommon(StatementIndex stindex,
+    uint64_t deleteLeaseCommon(MySqlLeaseContextPtr& ctx,
+                               StatementIndex stindex,
                                MYSQL_BIND* bind);
 
+    /// @brief Updates an IPv4 lease using the given context.
+    ///
+    /// The current expiration time of the lease is not updated.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be updated.
+    ///
+    /// @throw NoSuchLease Could not update a lease because no lease matches
+    ///        the address and the expiration time given.
+    void updateLease4Internal(MySqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Updates an IPv6 lease using the given context.
+    ///
+    /// The current expiration time of the lease is not updated.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be updated.
+    ///
+    /// @throw NoSuchLease Could not update a lease because no lease matches
+    ///        the address and the expiration time given.
+    void updateLease6Internal(MySqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
+    /// @brief Deletes an IPv4 lease using the given context.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be deleted.
+    ///
+    /// @return true if deletion was successful, false if no such lease exists.
+    bool deleteLeaseInternal(MySqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Deletes an IPv6 lease using the given context.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be deleted.
+    ///
+    /// @return true if deletion was successful, false if no such lease exists.
+    bool deleteLeaseInternal(MySqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
+    /// @brief Applies a change of a DHCPv4 lease within a transaction.
+    ///
+    /// A failed update is recorded in the change. Other errors are thrown
+    /// and abort the transaction.
+    ///
+    /// @param ctx Context
+    /// @param [in,out] change The change to be applied.
+    void applyLeaseChangeInternal(MySqlLeaseContextPtr& ctx,
+                                  LeaseChange4& change);
+
+    /// @brief Applies a change of a DHCPv6 lease within a transaction.
+    ///
+    /// A failed update is recorded in the change. Other errors are thrown
+    /// and abort the transaction.
+    ///
+    /// @param ctx Context
+    /// @param [in,out] change The change to be applied.
+    void applyLeaseChangeInternal(MySqlLeaseContextPtr& ctx,
+                                  LeaseChange6& change);
+
+    /// @brief Apply lease changes common code
+    ///
+    /// Applies the changes within a single transaction and falls back to
+    /// applying them one by one when the transaction fails.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    /// @tparam LeaseChangeCollection @c LeaseChange4Collection or
+    /// @c LeaseChange6Collection.
+    template <typename LeaseChangeCollection>
+    void applyLeaseChangesCommon(LeaseChangeCollection& changes);
+
     /// @brief Delete expired-reclaimed leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
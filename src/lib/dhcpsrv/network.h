@@ -183,7 +183,7 @@ public:
           ddns_replace_client_name_mode_(), ddns_generated_prefix_(), ddns_qualifying_suffix_(),
           hostname_char_set_(), hostname_char_replacement_(), store_extended_info_(),
           cache_threshold_(), cache_max_age_(), ddns_update_on_renew_(),
-          ddns_use_conflict_resolution_() {
+          ddns_use_conflict_resolution_(), allocator_type_() {
     }
 
     /// @brief Virtual destructor.
@@ -696,6 +696,24 @@ public:
         cache_max_age_ = cache_max_age;
     }
 
+    /// @brief Returns the name of the address and prefix allocator.
+    ///
+    /// @param inheritance inheritance mode to be used.
+    util::Optional<std::string>
+    getAllocatorType(const Inheritance& inheritance = Inheritance::ALL) const {
+        return (getProperty<Network>(&Network::getAllocatorType,
+                                     allocator_type_,
+                                     inheritance, "allocator"));
+    }
+
+    /// @brief Sets the name of the address and prefix allocator.
+    ///
+    /// @param allocator_type New allocator name, e.g. "iterative" or
+    /// "free-lease-queue".
+    void setAllocatorType(const util::Optional<std::string>& allocator_type) {
+        allocator_type_ = allocator_type;
+    }
+
     /// @brief Returns ddns-update-on-renew
     ///
     /// @param inheritance inheritance mode to be used.
@@ -1044,6 +1062,9 @@ protected:
     /// @brief Used to to tell kea-dhcp-ddns whether or not to use conflict resolution.
     util::Optional<bool> ddns_use_conflict_resolution_;
 
+    /// @brief Name of the allocator used to pick addresses and prefixes.
+    util::Optional<std::string> allocator_type_;
+
     /// @brief Pointer to another network that this network belongs to.
     ///
     /// The most common case is that this instance is a subnet which belongs
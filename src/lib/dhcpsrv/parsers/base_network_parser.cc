@@ -247,6 +247,22 @@ BaseNetworkParser::parseCacheParams(const ConstElementPtr& network_data,
     }
 }
 
+void
+BaseNetworkParser::parseAllocatorParams(const ConstElementPtr& network_data,
+                                        NetworkPtr& network) {
+    if (network_data->contains("allocator")) {
+        std::string allocator = getString(network_data, "allocator");
+        if ((allocator != "iterative") && (allocator != "random") &&
+            (allocator != "free-lease-queue")) {
+            isc_throw(DhcpConfigError, "allocator: '" << allocator
+                      << "' is invalid, supported allocators are: iterative,"
+                      " random and free-lease-queue ("
+                      << getPosition("allocator", network_data) << ")");
+        }
+        network->setAllocatorType(allocator);
+    }
+}
+
 void
 BaseNetworkParser::parseDdnsParams(const data::ConstElementPtr& network_data,
                                    NetworkPtr& network) {
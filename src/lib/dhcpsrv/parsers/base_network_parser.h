@@ -91,6 +91,20 @@ protected:
     void parseCacheParams(const data::ConstElementPtr& network_data,
                      NetworkPtr& network);
 
+    /// @brief Parses the allocator parameter.
+    ///
+    /// The parsed parameter is:
+    /// - allocator (iterative, random or free-lease-queue).
+    ///
+    /// @param network_data Data element holding network configuration
+    /// to be parsed.
+    /// @param [out] network Pointer to a network in which parsed data is
+    /// to be stored.
+    ///
+    /// @throw DhcpConfigError if the allocator name is unknown.
+    void parseAllocatorParams(const data::ConstElementPtr& network_data,
+                              NetworkPtr& network);
+
     /// @brief Parses parameters pertaining to DDNS behavior.
     ///
     /// The parsed parameters are:
@@ -950,6 +950,9 @@ Subnet4ConfigParser::initSubnet(data::ConstElementPtr params,
 
     // Parse lease cache parameters
     parseCacheParams(params, network);
+
+    // Parse allocator parameters
+    parseAllocatorParams(params, network);
 }
 
 void
@@ -1378,6 +1381,9 @@ Subnet6ConfigParser::initSubnet(data::ConstElementPtr params,
 
     // Parse lease cache parameters
     parseCacheParams(params, network);
+
+    // Parse allocator parameters
+    parseAllocatorParams(params, network);
 }
 
 void
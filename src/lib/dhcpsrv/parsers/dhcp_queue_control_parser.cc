@@ -6,9 +6,11 @@
 
 #include <config.h>
 #include <cc/data.h>
+#include <dhcp/iface_mgr.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/dhcpsrv_log.h>
 #include <dhcpsrv/parsers/dhcp_queue_control_parser.h>
+#include <util/fd_event_handler_factory.h>
 #include <util/multi_threading_mgr.h>
 #include <boost/foreach.hpp>
 #include <string>
@@ -43,6 +45,55 @@ DHCPQueueControlParser::parse(const ConstElementPtr& control_elem) {
         }
     }
 
+    // receive-batch-size is optional and applies regardless of enable-queue.
+    if (control_elem->contains("receive-batch-size")) {
+        int64_t batch_size = getInteger(control_elem, "receive-batch-size");
+        if ((batch_size < 1) ||
+            (batch_size > static_cast<int64_t>(IfaceMgr::MAX_RECEIVE_BATCH_SIZE))) {
+            isc_throw(DhcpConfigError, "receive-batch-size must be in range 1.."
+                      << IfaceMgr::MAX_RECEIVE_BATCH_SIZE << " ("
+                      << control_elem->get("receive-batch-size")->getPosition()
+                      << ")");
+        }
+    }
+
+    // send-batch-size is optional and applies regardless of enable-queue.
+    if (control_elem->contains("send-batch-size")) {
+        int64_t batch_size = getInteger(control_elem, "send-batch-size");
+        if ((batch_size < 1) ||
+            (batch_size > static_cast<int64_t>(IfaceMgr::MAX_SEND_BATCH_SIZE))) {
+            isc_throw(DhcpConfigError, "send-batch-size must be in range 1.."
+                      << IfaceMgr::MAX_SEND_BATCH_SIZE << " ("
+                      << control_elem->get("send-batch-size")->getPosition()
+                      << ")");
+        }
+    }
+
+    // raw-socket-ring is optional and applies regardless of enable-queue.
+    // It is ignored on systems other than Linux.
+    if (control_elem->contains("raw-socket-ring")) {
+        getBoolean(control_elem, "raw-socket-ring");
+    }
+
+    // event-handler is optional and applies regardless of enable-queue.
+    if (control_elem->contains("event-handler")) {
+        std::string name = getString(control_elem, "event-handler");
+        FDEventHandler::HandlerType type = FDEventHandler::TYPE_UNKNOWN;
+        try {
+            type = FDEventHandlerFactory::typeFromText(name);
+        } catch (const std::exception& ex) {
+            isc_throw(DhcpConfigError, ex.what() << " ("
+                      << control_elem->get("event-handler")->getPosition()
+                      << ")");
+        }
+        if (!FDEventHandlerFactory::isSupported(type)) {
+            isc_throw(DhcpConfigError, "event-handler '" << name
+                      << "' is not supported on this system ("
+                      << control_elem->get("event-handler")->getPosition()
+                      << ")");
+        }
+    }
+
     // Return a copy of it.
     ElementPtr result = data::copy(control_elem);
 
@@ -95,7 +95,8 @@ const SimpleKeywords SimpleParser6::GLOBAL6_PARAMETERS = {
     { "cache-max-age",                  Element::integer },
     { "ip-reservations-unique",         Element::boolean },
     { "ddns-update-on-renew",           Element::boolean },
-    { "ddns-use-conflict-resolution",   Element::boolean }
+    { "ddns-use-conflict-resolution",   Element::boolean },
+    { "allocator",                      Element::string }
 };
 
 /// @brief This table defines default global values for DHCPv6
@@ -236,7 +237,8 @@ const SimpleKeywords SimpleParser6::SUBNET6_PARAMETERS = {
     { "cache-threshold",                Element::real },
     { "cache-max-age",                  Element::integer },
     { "ddns-update-on-renew",           Element::boolean },
-    { "ddns-use-conflict-resolution",   Element::boolean }
+    { "ddns-use-conflict-resolution",   Element::boolean },
+    { "allocator",                      Element::string }
 };
 
 /// @brief This table defines default values for each IPv6 subnet.
@@ -371,7 +373,8 @@ const SimpleKeywords SimpleParser6::SHARED_NETWORK6_PARAMETERS = {
     { "cache-threshold",                Element::real },
     { "cache-max-age",                  Element::integer },
     { "ddns-update-on-renew",           Element::boolean },
-    { "ddns-use-conflict-resolution",   Element::boolean }
+    { "ddns-use-conflict-resolution",   Element::boolean },
+    { "allocator",                      Element::string }
 };
 
 /// @brief This table defines default values for each IPv6 subnet.
@@ -1294,6 +1294,14 @@ PgSqlLeaseMgr::addLeaseCommon(PgSqlLeaseContextPtr& ctx,
     return (true);
 }
 
+bool
+PgSqlLeaseMgr::addLeaseInternal(PgSqlLeaseContextPtr& ctx,
+                                const Lease4Ptr& lease) {
+    PsqlBindArray bind_array;
+    ctx->exchange4_->createBindForSend(lease, bind_array);
+    return (addLeaseCommon(ctx, INSERT_LEASE4, bind_array));
+}
+
 bool
 PgSqlLeaseMgr::addLease(const Lease4Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_ADD_ADDR4)
@@ -1303,9 +1311,7 @@ PgSqlLeaseMgr::addLease(const Lease4Ptr& lease) {
     PgSqlLeaseContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
-    PsqlBindArray bind_array;
-    ctx->exchange4_->createBindForSend(lease, bind_array);
-    auto result = addLeaseCommon(ctx, INSERT_LEASE4, bind_array);
+    auto result = addLeaseInternal(ctx, lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -1314,6 +1320,14 @@ PgSqlLeaseMgr::addLease(const Lease4Ptr& lease) {
     return (result);
 }
 
+bool
+PgSqlLeaseMgr::addLeaseInternal(PgSqlLeaseContextPtr& ctx,
+                                const Lease6Ptr& lease) {
+    PsqlBindArray bind_array;
+    ctx->exchange6_->createBindForSend(lease, bind_array);
+    return (addLeaseCommon(ctx, INSERT_LEASE6, bind_array));
+}
+
 bool
 PgSqlLeaseMgr::addLease(const Lease6Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_ADD_ADDR6)
@@ -1324,10 +1338,7 @@ PgSqlLeaseMgr::addLease(const Lease6Ptr& lease) {
     PgSqlLeaseContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
-    PsqlBindArray bind_array;
-    ctx->exchange6_->createBindForSend(lease, bind_array);
-
-    auto result = addLeaseCommon(ctx, INSERT_LEASE6, bind_array);
+    auto result = addLeaseInternal(ctx, lease);
 
     // Update lease current expiration time (allows update between the creation
     // of the Lease up to the point of insertion in the database).
@@ -1967,9 +1978,33 @@ PgSqlLeaseMgr::updateLeaseCommon(PgSqlLeaseContextPtr& ctx,
 }
 
 void
-PgSqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
+PgSqlLeaseMgr::createBindForUpdate(PgSqlLeaseContextPtr& ctx,
+                                   const Lease4Ptr& lease,
+                                   PsqlBindArray& bind_array) {
+    // Create the BIND array for the data being updated
+    ctx->exchange4_->createBindForSend(lease, bind_array);
+
+    // Set up the WHERE clause and append it to the SQL_BIND array
+    bind_array.addTempString(boost::lexical_cast<std::string>(lease->addr_.toUint32()));
+
+    bind_array.addTempString(PgSqlLeaseExchange::convertToDatabaseTime(lease->current_cltt_,
+                                                                       lease->current_valid_lft_));
+}
+
+void
+PgSqlLeaseMgr::updateLease4Internal(PgSqlLeaseContextPtr& ctx,
+                                    const Lease4Ptr& lease) {
     const StatementIndex stindex = UPDATE_LEASE4;
 
+    PsqlBindArray bind_array;
+    createBindForUpdate(ctx, lease, bind_array);
+
+    // Drop to common update code
+    updateLeaseCommon(ctx, stindex, bind_array, lease);
+}
+
+void
+PgSqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_UPDATE_ADDR4)
         .arg(lease->addr_.toText());
 
@@ -1977,29 +2012,40 @@ PgSqlLeaseMgr::updateLease4(const Lease4Ptr& lease) {
     PgSqlLeaseContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
+    updateLease4Internal(ctx, lease);
+
+    // Update lease current expiration time.
+    lease->updateCurrentExpirationTime();
+}
+
+void
+PgSqlLeaseMgr::createBindForUpdate(PgSqlLeaseContextPtr& ctx,
+                                   const Lease6Ptr& lease,
+                                   PsqlBindArray& bind_array) {
     // Create the BIND array for the data being updated
-    PsqlBindArray bind_array;
-    ctx->exchange4_->createBindForSend(lease, bind_array);
+    ctx->exchange6_->createBindForSend(lease, bind_array);
 
-    // Set up the WHERE clause and append it to the SQL_BIND array
-    std::string addr4_str = boost::lexical_cast<std::string>(lease->addr_.toUint32());
-    bind_array.add(addr4_str);
+    // Set up the WHERE clause and append it to the BIND array
+    bind_array.addTempString(lease->addr_.toText());
 
-    std::string expire_str = PgSqlLeaseExchange::convertToDatabaseTime(lease->current_cltt_,
-                                                                       lease->current_valid_lft_);
-    bind_array.add(expire_str);
+    bind_array.addTempString(PgSqlLeaseExchange::convertToDatabaseTime(lease->current_cltt_,
+                                                                       lease->current_valid_lft_));
+}
+
+void
+PgSqlLeaseMgr::updateLease6Internal(PgSqlLeaseContextPtr& ctx,
+                                    const Lease6Ptr& lease) {
+    const StatementIndex stindex = UPDATE_LEASE6;
+
+    PsqlBindArray bind_array;
+    createBindForUpdate(ctx, lease, bind_array);
 
     // Drop to common update code
     updateLeaseCommon(ctx, stindex, bind_array, lease);
-
-    // Update lease current expiration time.
-    lease->updateCurrentExpirationTime();
 }
 
 void
 PgSqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
-    const StatementIndex stindex = UPDATE_LEASE6;
-
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_UPDATE_ADDR6)
         .arg(lease->addr_.toText())
         .arg(lease->type_);
@@ -2008,32 +2054,16 @@ PgSqlLeaseMgr::updateLease6(const Lease6Ptr& lease) {
     PgSqlLeaseContextAlloc get_context(*this);
     PgSqlLeaseContextPtr ctx = get_context.ctx_;
 
-    // Create the BIND array for the data being updated
-    PsqlBindArray bind_array;
-    ctx->exchange6_->createBindForSend(lease, bind_array);
-
-    // Set up the WHERE clause and append it to the BIND array
-    std::string addr_str = lease->addr_.toText();
-    bind_array.add(addr_str);
-
-    std::string expire_str = PgSqlLeaseExchange::convertToDatabaseTime(lease->current_cltt_,
-                                                                       lease->current_valid_lft_);
-    bind_array.add(expire_str);
-
-    // Drop to common update code
-    updateLeaseCommon(ctx, stindex, bind_array, lease);
+    updateLease6Internal(ctx, lease);
 
     // Update lease current expiration time.
     lease->updateCurrentExpirationTime();
 }
 
 uint64_t
-PgSqlLeaseMgr::deleteLeaseCommon(StatementIndex stindex,
+PgSqlLeaseMgr::deleteLeaseCommon(PgSqlLeaseContextPtr& ctx,
+                                 StatementIndex stindex,
                                  PsqlBindArray& bind_array) {
-    // Get a context
-    PgSqlLeaseContextAlloc get_context(*this);
-    PgSqlLeaseContextPtr ctx = get_context.ctx_;
-
     PgSqlResult r(PQexecPrepared(ctx->conn_, tagged_statements[stindex].name,
                                  tagged_statements[stindex].nbparams,
                                  &bind_array.values_[0],
@@ -2046,23 +2076,23 @@ PgSqlLeaseMgr::deleteLeaseCommon(StatementIndex stindex,
     return (affected_rows);
 }
 
-bool
-PgSqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
-    const IOAddress& addr = lease->addr_;
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_DELETE_ADDR)
-        .arg(addr.toText());
-
+void
+PgSqlLeaseMgr::createBindForDelete(const Lease4Ptr& lease,
+                                   PsqlBindArray& bind_array) {
     // Set up the WHERE clause value
-    PsqlBindArray bind_array;
+    bind_array.addTempString(boost::lexical_cast<std::string>(lease->addr_.toUint32()));
 
-    std::string addr4_str = boost::lexical_cast<std::string>(addr.toUint32());
-    bind_array.add(addr4_str);
+    bind_array.addTempString(PgSqlLeaseExchange::convertToDatabaseTime(lease->current_cltt_,
+                                                                       lease->current_valid_lft_));
+}
 
-    std::string expire_str = PgSqlLeaseExchange::convertToDatabaseTime(lease->current_cltt_,
-                                                                       lease->current_valid_lft_);
-    bind_array.add(expire_str);
+bool
+PgSqlLeaseMgr::deleteLeaseInternal(PgSqlLeaseContextPtr& ctx,
+                                   const Lease4Ptr& lease) {
+    PsqlBindArray bind_array;
+    createBindForDelete(lease, bind_array);
 
-    auto affected_rows = deleteLeaseCommon(DELETE_LEASE4, bind_array);
+    auto affected_rows = deleteLeaseCommon(ctx, DELETE_LEASE4, bind_array);
 
     // Check success case first as it is the most likely outcome.
     if (affected_rows == 1) {
@@ -2081,23 +2111,35 @@ PgSqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
 }
 
 bool
-PgSqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
+PgSqlLeaseMgr::deleteLease(const Lease4Ptr& lease) {
     const IOAddress& addr = lease->addr_;
-    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
-              DHCPSRV_PGSQL_DELETE_ADDR)
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_DELETE_ADDR)
         .arg(addr.toText());
 
+    // Get a context
+    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    return (deleteLeaseInternal(ctx, lease));
+}
+
+void
+PgSqlLeaseMgr::createBindForDelete(const Lease6Ptr& lease,
+                                   PsqlBindArray& bind_array) {
     // Set up the WHERE clause value
-    PsqlBindArray bind_array;
+    bind_array.addTempString(lease->addr_.toText());
 
-    std::string addr6_str = addr.toText();
-    bind_array.add(addr6_str);
+    bind_array.addTempString(PgSqlLeaseExchange::convertToDatabaseTime(lease->current_cltt_,
+                                                                       lease->current_valid_lft_));
+}
 
-    std::string expire_str = PgSqlLeaseExchange::convertToDatabaseTime(lease->current_cltt_,
-                                                                       lease->current_valid_lft_);
-    bind_array.add(expire_str);
+bool
+PgSqlLeaseMgr::deleteLeaseInternal(PgSqlLeaseContextPtr& ctx,
+                                   const Lease6Ptr& lease) {
+    PsqlBindArray bind_array;
+    createBindForDelete(lease, bind_array);
 
-    auto affected_rows = deleteLeaseCommon(DELETE_LEASE6, bind_array);
+    auto affected_rows = deleteLeaseCommon(ctx, DELETE_LEASE6, bind_array);
 
     // Check success case first as it is the most likely outcome.
     if (affected_rows == 1) {
@@ -2115,6 +2157,230 @@ PgSqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
               "that had the address " << lease->addr_.toText());
 }
 
+bool
+PgSqlLeaseMgr::deleteLease(const Lease6Ptr& lease) {
+    const IOAddress& addr = lease->addr_;
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+              DHCPSRV_PGSQL_DELETE_ADDR)
+        .arg(addr.toText());
+
+    // Get a context
+    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+    return (deleteLeaseInternal(ctx, lease));
+}
+
+void
+PgSqlLeaseMgr::applyLeaseChangeInternal(PgSqlLeaseContextPtr& ctx,
+                                        LeaseChange4& change) {
+    switch (change.type_) {
+    case LeaseChange4::ADD:
+        change.applied_ = addLeaseInternal(ctx, change.lease_);
+        if (!change.applied_) {
+            // The duplicate key error has aborted the transaction.
+            isc_throw(DuplicateEntry, "lease for address "
+                      << change.lease_->addr_ << " already exists");
+        }
+        break;
+    case LeaseChange4::UPDATE:
+        try {
+            updateLease4Internal(ctx, change.lease_);
+            change.applied_ = true;
+        } catch (const NoSuchLease& ex) {
+            // The statement has succeeded without updating any row so
+            // the transaction can go on.
+            change.error_ = ex.what();
+        }
+        break;
+    case LeaseChange4::DELETE:
+        change.applied_ = deleteLeaseInternal(ctx, change.lease_);
+        break;
+    }
+}
+
+void
+PgSqlLeaseMgr::applyLeaseChangeInternal(PgSqlLeaseContextPtr& ctx,
+                                        LeaseChange6& change) {
+    switch (change.type_) {
+    case LeaseChange6::ADD:
+        change.applied_ = addLeaseInternal(ctx, change.lease_);
+        if (!change.applied_) {
+            // The duplicate key error has aborted the transaction.
+            isc_throw(DuplicateEntry, "lease for address "
+                      << change.lease_->addr_ << " already exists");
+        }
+        break;
+    case LeaseChange6::UPDATE:
+        try {
+            updateLease6Internal(ctx, change.lease_);
+            change.applied_ = true;
+        } catch (const NoSuchLease& ex) {
+            // The statement has succeeded without updating any row so
+            // the transaction can go on.
+            change.error_ = ex.what();
+        }
+        break;
+    case LeaseChange6::DELETE:
+        change.applied_ = deleteLeaseInternal(ctx, change.lease_);
+        break;
+    }
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+PgSqlLeaseMgr::StatementIndex
+PgSqlLeaseMgr::createBindForChange(PgSqlLeaseContextPtr& ctx,
+                                   const LeaseChange4& change,
+                                   PsqlBindArray& bind_array) {
+    switch (change.type_) {
+    case LeaseChange4::ADD:
+        ctx->exchange4_->createBindForSend(change.lease_, bind_array);
+        return (INSERT_LEASE4);
+    case LeaseChange4::UPDATE:
+        createBindForUpdate(ctx, change.lease_, bind_array);
+        return (UPDATE_LEASE4);
+    default:
+        createBindForDelete(change.lease_, bind_array);
+        return (DELETE_LEASE4);
+    }
+}
+
+PgSqlLeaseMgr::StatementIndex
+PgSqlLeaseMgr::createBindForChange(PgSqlLeaseContextPtr& ctx,
+                                   const LeaseChange6& change,
+                                   PsqlBindArray& bind_array) {
+    switch (change.type_) {
+    case LeaseChange6::ADD:
+        ctx->exchange6_->createBindForSend(change.lease_, bind_array);
+        return (INSERT_LEASE6);
+    case LeaseChange6::UPDATE:
+        createBindForUpdate(ctx, change.lease_, bind_array);
+        return (UPDATE_LEASE6);
+    default:
+        createBindForDelete(change.lease_, bind_array);
+        return (DELETE_LEASE6);
+    }
+}
+
+template <typename LeaseChangeCollection>
+void
+PgSqlLeaseMgr::applyLeaseChangesPipeline(PgSqlLeaseContextPtr& ctx,
+                                         LeaseChangeCollection& changes) {
+    typedef typename LeaseChangeCollection::value_type LeaseChangeType;
+
+    // Send all statements without waiting for their results. The exchange
+    // buffers are reused by the next change but libpq copies the
+    // parameters when the statement is sent.
+    PgSqlPipeline pipeline(ctx->conn_);
+    for (auto const& change : changes) {
+        PsqlBindArray bind_array;
+        StatementIndex stindex = createBindForChange(ctx, change, bind_array);
+        pipeline.send(tagged_statements[stindex],
+                      &bind_array.values_[0],
+                      &bind_array.lengths_[0],
+                      &bind_array.formats_[0]);
+    }
+
+    std::vector<PgSqlResultPtr> results;
+    pipeline.commit(results);
+
+    auto result = results.begin();
+    for (auto& change : changes) {
+        if (change.type_ == LeaseChangeType::ADD) {
+            change.applied_ = true;
+        } else {
+            int affected_rows = boost::lexical_cast<int>(PQcmdTuples(**result));
+            change.applied_ = (affected_rows > 0);
+            if (!change.applied_ && (change.type_ == LeaseChangeType::UPDATE)) {
+                std::ostringstream s;
+                s << "unable to update lease for address "
+                  << change.lease_->addr_.toText() << " as it does not exist";
+                change.error_ = s.str();
+            }
+        }
+        ++result;
+    }
+}
+
+#endif // LIBPQ_HAS_PIPELINING
+
+template <typename LeaseChangeCollection>
+void
+PgSqlLeaseMgr::applyLeaseChangesCommon(LeaseChangeCollection& changes) {
+    typedef typename LeaseChangeCollection::value_type LeaseChangeType;
+
+    if (changes.empty()) {
+        return;
+    }
+
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+              DHCPSRV_PGSQL_APPLY_LEASE_CHANGES).arg(changes.size());
+
+    bool committed = false;
+    {
+        // Get a context
+        PgSqlLeaseContextAlloc get_context(*this);
+        PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
+        // Apply all changes within a single transaction so as the batch
+        // costs one commit rather than one per lease.
+        try {
+#ifdef LIBPQ_HAS_PIPELINING
+            // Pipelining the statements also saves a round trip per lease.
+            applyLeaseChangesPipeline(ctx, changes);
+#else
+            ctx->conn_.startTransaction();
+            for (auto& change : changes) {
+                applyLeaseChangeInternal(ctx, change);
+            }
+            ctx->conn_.commit();
+#endif
+            committed = true;
+
+        } catch (const std::exception& ex) {
+            LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
+                      DHCPSRV_PGSQL_APPLY_LEASE_CHANGES_FAILED).arg(ex.what());
+#ifndef LIBPQ_HAS_PIPELINING
+            try {
+                ctx->conn_.rollback();
+            } catch (...) {
+                // The connection is unusable so there is nothing to roll back.
+            }
+#endif
+        }
+    }
+
+    if (!committed) {
+        // Apply the changes one by one, so the failure of a change does not
+        // affect the other changes.
+        for (auto& change : changes) {
+            change.applied_ = false;
+            change.error_.clear();
+        }
+        LeaseMgr::applyLeaseChanges(changes);
+        return;
+    }
+
+    // Update lease current expiration time of the committed leases.
+    for (auto& change : changes) {
+        if ((change.type_ == LeaseChangeType::ADD) ||
+            ((change.type_ == LeaseChangeType::UPDATE) && change.applied_)) {
+            change.lease_->updateCurrentExpirationTime();
+        }
+    }
+}
+
+void
+PgSqlLeaseMgr::applyLeaseChanges(LeaseChange4Collection& changes) {
+    applyLeaseChangesCommon(changes);
+}
+
+void
+PgSqlLeaseMgr::applyLeaseChanges(LeaseChange6Collection& changes) {
+    applyLeaseChangesCommon(changes);
+}
+
 uint64_t
 PgSqlLeaseMgr::deleteExpiredReclaimedLeases4(const uint32_t secs) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_DELETE_EXPIRED_RECLAIMED4)
@@ -2143,8 +2409,12 @@ PgSqlLeaseMgr::deleteExpiredReclaimedLeasesCommon(const uint32_t secs,
         static_cast<time_t>(secs));
     bind_array.add(expiration_str);
 
+    // Get a context
+    PgSqlLeaseContextAlloc get_context(*this);
+    PgSqlLeaseContextPtr ctx = get_context.ctx_;
+
     // Delete leases.
-    return (deleteLeaseCommon(statement_index, bind_array));
+    return (deleteLeaseCommon(ctx, statement_index, bind_array));
 }
 
 LeaseStatsQueryPtr
@@ -493,6 +493,26 @@ public:
     /// different expiration time.
     virtual bool deleteLease(const Lease6Ptr& lease);
 
+    /// @brief Applies a batch of changes of DHCPv4 leases.
+    ///
+    /// The changes are applied within a single transaction. When libpq
+    /// supports pipeline mode the statements are pipelined, so the batch
+    /// costs a single round trip to the server. If the transaction fails
+    /// it is rolled back and the changes are applied one by one.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    virtual void applyLeaseChanges(LeaseChange4Collection& changes);
+
+    /// @brief Applies a batch of changes of DHCPv6 leases.
+    ///
+    /// The changes are applied within a single transaction. When libpq
+    /// supports pipeline mode the statements are pipelined, so the batch
+    /// costs a single round trip to the server. If the transaction fails
+    /// it is rolled back and the changes are applied one by one.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    virtual void applyLeaseChanges(LeaseChange6Collection& changes);
+
     /// @brief Deletes all expired-reclaimed DHCPv4 leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
@@ -708,6 +728,24 @@ private:
                         StatementIndex stindex,
                         db::PsqlBindArray& bind_array);
 
+    /// @brief Adds an IPv4 lease using the given context.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be added.
+    ///
+    /// @return true if the lease was added, false if a lease with that
+    ///         address already exists in the database.
+    bool addLeaseInternal(PgSqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Adds an IPv6 lease using the given context.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be added.
+    ///
+    /// @return true if the lease was added, false if a lease with that
+    ///         address already exists in the database.
+    bool addLeaseInternal(PgSqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
     /// @brief Get Lease Collection Common Code
     ///
     /// This method performs the common actions for obtaining multiple leases
@@ -860,6 +898,7 @@ private:
     /// to the prepared statement, executes the statement and checks to
     /// see how many rows were deleted.
     ///
+    /// @param ctx Context
     /// @param stindex Index of prepared statement to be executed
     /// @param bind_array Array containing lease values and where clause
     /// parameters for the delete
@@ -868,9 +907,154 @@ private:
     ///
     /// @throw isc::db::DbOperationError An operation on the open database has
     ///        failed.
-    uint64_t deleteLeaseCommon(StatementIndex stindex,
+    uint64_t deleteLeaseCommon(PgSqlLeaseContextPtr& ctx,
+                               StatementIndex stindex,
                                db::PsqlBindArray& bind_array);
 
+    /// @brief Creates the bind array for updating an IPv4 lease.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be updated.
+    /// @param [out] bind_array Array containing lease values and where
+    /// clause parameters for the update.
+    void createBindForUpdate(PgSqlLeaseContextPtr& ctx, const Lease4Ptr& lease,
+                             db::PsqlBindArray& bind_array);
+
+    /// @brief Creates the bind array for updating an IPv6 lease.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be updated.
+    /// @param [out] bind_array Array containing lease values and where
+    /// clause parameters for the update.
+    void createBindForUpdate(PgSqlLeaseContextPtr& ctx, const Lease6Ptr& lease,
+                             db::PsqlBindArray& bind_array);
+
+    /// @brief Creates the bind array for deleting an IPv4 lease.
+    ///
+    /// @param lease Lease to be deleted.
+    /// @param [out] bind_array Array containing where clause parameters
+    /// for the delete.
+    void createBindForDelete(const Lease4Ptr& lease,
+                             db::PsqlBindArray& bind_array);
+
+    /// @brief Creates the bind array for deleting an IPv6 lease.
+    ///
+    /// @param lease Lease to be deleted.
+    /// @param [out] bind_array Array containing where clause parameters
+    /// for the delete.
+    void createBindForDelete(const Lease6Ptr& lease,
+                             db::PsqlBindArray& bind_array);
+
+    /// @brief Updates an IPv4 lease using the given context.
+    ///
+    /// The current expiration time of the lease is not updated.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be updated.
+    ///
+    /// @throw NoSuchLease Could not update a lease because no lease matches
+    ///        the address and the expiration time given.
+    void updateLease4Internal(PgSqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Updates an IPv6 lease using the given context.
+    ///
+    /// The current expiration time of the lease is not updated.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be updated.
+    ///
+    /// @throw NoSuchLease Could not update a lease because no lease matches
+    ///        the address and the expiration time given.
+    void updateLease6Internal(PgSqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
+    /// @brief Deletes an IPv4 lease using the given context.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be deleted.
+    ///
+    /// @return true if deletion was successful, false if no such lease exists.
+    bool deleteLeaseInternal(PgSqlLeaseContextPtr& ctx, const Lease4Ptr& lease);
+
+    /// @brief Deletes an IPv6 lease using the given context.
+    ///
+    /// @param ctx Context
+    /// @param lease Lease to be deleted.
+    ///
+    /// @return true if deletion was successful, false if no such lease exists.
+    bool deleteLeaseInternal(PgSqlLeaseContextPtr& ctx, const Lease6Ptr& lease);
+
+    /// @brief Applies a change of a DHCPv4 lease within a transaction.
+    ///
+    /// A failed update is recorded in the change. Other errors are thrown
+    /// and abort the transaction.
+    ///
+    /// @param ctx Context
+    /// @param [in,out] change The change to be applied.
+    void applyLeaseChangeInternal(PgSqlLeaseContextPtr& ctx,
+                                  LeaseChange4& change);
+
+    /// @brief Applies a change of a DHCPv6 lease within a transaction.
+    ///
+    /// A failed update is recorded in the change. Other errors are thrown
+    /// and abort the transaction.
+    ///
+    /// @param ctx Context
+    /// @param [in,out] change The change to be applied.
+    void applyLeaseChangeInternal(PgSqlLeaseContextPtr& ctx,
+                                  LeaseChange6& change);
+
+#ifdef LIBPQ_HAS_PIPELINING
+    /// @brief Creates the bind array for a change of a DHCPv4 lease.
+    ///
+    /// @param ctx Context
+    /// @param change The change to be applied.
+    /// @param [out] bind_array Array containing the statement parameters.
+    ///
+    /// @return Index of the statement applying the change.
+    StatementIndex createBindForChange(PgSqlLeaseContextPtr& ctx,
+                                       const LeaseChange4& change,
+                                       db::PsqlBindArray& bind_array);
+
+    /// @brief Creates the bind array for a change of a DHCPv6 lease.
+    ///
+    /// @param ctx Context
+    /// @param change The change to be applied.
+    /// @param [out] bind_array Array containing the statement parameters.
+    ///
+    /// @return Index of the statement applying the change.
+    StatementIndex createBindForChange(PgSqlLeaseContextPtr& ctx,
+                                       const LeaseChange6& change,
+                                       db::PsqlBindArray& bind_array);
+
+    /// @brief Applies lease changes in pipeline mode.
+    ///
+    /// All statements are sent at once within a transaction and their
+    /// results are collected after the commit, so the batch costs a
+    /// single round trip to the server.
+    ///
+    /// @param ctx Context
+    /// @param [in,out] changes Collection of changes to be applied.
+    /// @tparam LeaseChangeCollection @c LeaseChange4Collection or
+    /// @c LeaseChange6Collection.
+    ///
+    /// @throw isc::db::DbOperationError if any of the statements has failed.
+    /// The transaction is rolled back.
+    template <typename LeaseChangeCollection>
+    void applyLeaseChangesPipeline(PgSqlLeaseContextPtr& ctx,
+                                   LeaseChangeCollection& changes);
+#endif
+
+    /// @brief Apply lease changes common code
+    ///
+    /// Applies the changes within a single transaction and falls back to
+    /// applying them one by one when the transaction fails.
+    ///
+    /// @param [in,out] changes Collection of changes to be applied.
+    /// @tparam LeaseChangeCollection @c LeaseChange4Collection or
+    /// @c LeaseChange6Collection.
+    template <typename LeaseChangeCollection>
+    void applyLeaseChangesCommon(LeaseChangeCollection& changes);
+
     /// @brief Delete expired-reclaimed leases.
     ///
     /// @param secs Number of seconds since expiration of leases before
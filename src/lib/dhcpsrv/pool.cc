@@ -38,6 +38,11 @@ void Pool::allowClientClass(const ClientClass& class_name) {
     client_class_ = class_name;
 }
 
+void
+Pool::resetPermutation() {
+    permutation_.reset(new IPRangePermutation(AddressRange(first_, last_)));
+}
+
 std::string
 Pool::toText() const {
     std::stringstream tmp;
@@ -406,6 +411,16 @@ Pool6::toElement() const {
 }
 
 
+void
+Pool6::resetPermutation() {
+    if (getType() != Lease::TYPE_PD) {
+        Pool::resetPermutation();
+        return;
+    }
+    PrefixRange range(first_, prefixLengthFromRange(first_, last_), prefix_len_);
+    permutation_.reset(new IPRangePermutation(range));
+}
+
 std::string
 Pool6::toText() const {
     std::ostringstream s;
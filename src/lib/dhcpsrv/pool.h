@@ -174,6 +174,12 @@ public:
         return (permutation_);
     }
 
+    /// @brief Creates a new permutation of the pool's addresses.
+    ///
+    /// It replaces the existing permutation, if any, so the addresses
+    /// returned by the previous permutation are walked over again.
+    virtual void resetPermutation();
+
 protected:
 
     /// @brief protected constructor
@@ -461,6 +467,10 @@ public:
     /// @return A pointer to unparsed Pool6 configuration.
     virtual data::ElementPtr toElement() const;
 
+    /// @brief Creates a new permutation of the pool's addresses or
+    /// delegated prefixes.
+    virtual void resetPermutation();
+
     /// @brief returns textual representation of the pool
     ///
     /// @return textual representation
@@ -116,6 +116,18 @@ public:
     void setLastAllocated(Lease::Type type,
                           const isc::asiolink::IOAddress& addr);
 
+    /// @brief Returns the mutex serializing the allocations in this subnet.
+    ///
+    /// The allocators hold it in multi-threading mode while they update
+    /// the allocation state of the subnet and its pools, e.g. the last
+    /// allocated addresses or the pool permutations. The allocations in
+    /// different subnets don't wait for each other.
+    ///
+    /// @return reference to the allocation mutex of the subnet
+    std::mutex& getAllocationMutex() const {
+        return (*allocation_mutex_);
+    }
+
     /// @brief Returns unique ID for that subnet.
     ///
     /// @return unique ID for that subnet
@@ -510,6 +522,9 @@ private:
 
     /// @brief Mutex to protect the internal state.
     boost::scoped_ptr<std::mutex> mutex_;
+
+    /// @brief Mutex to serialize the allocations in the subnet.
+    boost::scoped_ptr<std::mutex> allocation_mutex_;
 };
 
 /// @brief A generic pointer to either Subnet4 or Subnet6 object
@@ -0,0 +1,192 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SUBNET_SELECTION_INDEX_H
+#define SUBNET_SELECTION_INDEX_H
+
+#include <asiolink/addr_utilities.h>
+#include <asiolink/io_address.h>
+#include <dhcp/classify.h>
+#include <boost/functional/hash.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Index of the subnets used by the subnet selection.
+///
+/// The servers select a subnet for each received packet by matching an
+/// address of the packet (giaddr, ciaddr, relay link address...) with
+/// the prefixes of the subnets, the relay address with the relay addresses
+/// of the subnets or the interface name with the interfaces of the
+/// subnets. A full scan of the subnets does not scale to configurations
+/// with thousands of subnets, so the subnets are indexed when the
+/// configuration is committed:
+/// - by prefix: there is a hash table per prefix length in use, so
+///   matching an address takes one lookup per distinct prefix length,
+/// - by relay address,
+/// - by interface name.
+///
+/// Each indexed subnet is recorded with its position in the
+/// configuration. When several subnets match, e.g. overlapping prefixes,
+/// the first one in the configuration which supports the client classes
+/// is returned, i.e. the same subnet as the full scan.
+///
+/// @tparam SubnetPtrType Type of the pointer to the subnets, i.e.
+/// @c Subnet4Ptr or @c Subnet6Ptr.
+template<typename SubnetPtrType>
+class SubnetSelectionIndex {
+public:
+
+    /// @brief Constructor.
+    SubnetSelectionIndex() : prefixes_(), addresses_(), names_() {
+    }
+
+    /// @brief Indexes a subnet by prefix.
+    ///
+    /// @param prefix Prefix of the subnet.
+    /// @param len Length of the prefix.
+    /// @param order Position of the subnet in the configuration.
+    /// @param subnet The subnet.
+    void addPrefix(const asiolink::IOAddress& prefix, uint8_t len,
+                   size_t order, const SubnetPtrType& subnet) {
+        auto it = std::find_if(prefixes_.begin(), prefixes_.end(),
+                               [len](const PrefixMap& map) {
+                                   return (map.first == len);
+                               });
+        if (it == prefixes_.end()) {
+            prefixes_.push_back(PrefixMap(len, AddressMap()));
+            it = prefixes_.end() - 1;
+        }
+        it->second[asiolink::firstAddrInPrefix(prefix, len)].
+            push_back(Entry(order, subnet));
+    }
+
+    /// @brief Indexes a subnet by relay address.
+    ///
+    /// @param address Relay address of the subnet.
+    /// @param order Position of the subnet in the configuration.
+    /// @param subnet The subnet.
+    void addAddress(const asiolink::IOAddress& address, size_t order,
+                    const SubnetPtrType& subnet) {
+        addresses_[address].push_back(Entry(order, subnet));
+    }
+
+    /// @brief Indexes a subnet by interface name.
+    ///
+    /// @param name Interface name of the subnet.
+    /// @param order Position of the subnet in the configuration.
+    /// @param subnet The subnet.
+    void addName(const std::string& name, size_t order,
+                 const SubnetPtrType& subnet) {
+        names_[name].push_back(Entry(order, subnet));
+    }
+
+    /// @brief Returns the first subnet which prefix contains an address.
+    ///
+    /// @param address The address.
+    /// @param client_classes Classes of the client.
+    /// @return The subnet or null pointer.
+    SubnetPtrType selectByPrefix(const asiolink::IOAddress& address,
+                                 const ClientClasses& client_classes) const {
+        const uint8_t max_len = (address.isV4() ? 32 : 128);
+        const Entry* best = 0;
+        for (auto const& map : prefixes_) {
+            if (map.first > max_len) {
+                continue;
+            }
+            auto it = map.second.find(asiolink::firstAddrInPrefix(address,
+                                                                  map.first));
+            if (it != map.second.end()) {
+                const Entry* entry = select(it->second, client_classes);
+                if (entry && (!best || (entry->first < best->first))) {
+                    best = entry;
+                }
+            }
+        }
+        return (best ? best->second : SubnetPtrType());
+    }
+
+    /// @brief Returns the first subnet with a relay address.
+    ///
+    /// @param address The relay address.
+    /// @param client_classes Classes of the client.
+    /// @return The subnet or null pointer.
+    SubnetPtrType selectByAddress(const asiolink::IOAddress& address,
+                                  const ClientClasses& client_classes) const {
+        auto it = addresses_.find(address);
+        if (it == addresses_.end()) {
+            return (SubnetPtrType());
+        }
+        const Entry* entry = select(it->second, client_classes);
+        return (entry ? entry->second : SubnetPtrType());
+    }
+
+    /// @brief Returns the first subnet with an interface name.
+    ///
+    /// @param name The interface name.
+    /// @param client_classes Classes of the client.
+    /// @return The subnet or null pointer.
+    SubnetPtrType selectByName(const std::string& name,
+                               const ClientClasses& client_classes) const {
+        auto it = names_.find(name);
+        if (it == names_.end()) {
+            return (SubnetPtrType());
+        }
+        const Entry* entry = select(it->second, client_classes);
+        return (entry ? entry->second : SubnetPtrType());
+    }
+
+private:
+
+    /// @brief An indexed subnet with its position in the configuration.
+    typedef std::pair<size_t, SubnetPtrType> Entry;
+
+    /// @brief Indexed subnets sharing a key, in the configuration order.
+    typedef std::vector<Entry> EntryList;
+
+    /// @brief Subnets indexed by address.
+    typedef std::unordered_map<asiolink::IOAddress, EntryList,
+                               boost::hash<asiolink::IOAddress> > AddressMap;
+
+    /// @brief Subnets indexed by prefix for a prefix length.
+    typedef std::pair<uint8_t, AddressMap> PrefixMap;
+
+    /// @brief Returns the first subnet of a list supporting client classes.
+    ///
+    /// @param entries The list of subnets.
+    /// @param client_classes Classes of the client.
+    /// @return The entry of the subnet or null pointer.
+    static const Entry* select(const EntryList& entries,
+                               const ClientClasses& client_classes) {
+        for (auto const& entry : entries) {
+            if (entry.second->clientSupported(client_classes)) {
+                return (&entry);
+            }
+        }
+        return (0);
+    }
+
+    /// @brief Subnets indexed by prefix, one map per prefix length.
+    std::vector<PrefixMap> prefixes_;
+
+    /// @brief Subnets indexed by relay address.
+    AddressMap addresses_;
+
+    /// @brief Subnets indexed by interface name.
+    std::unordered_map<std::string, EntryList> names_;
+};
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // SUBNET_SELECTION_INDEX_H
@@ -16,12 +16,16 @@
 #include <hooks/hooks_manager.h>
 #include <hooks/callout_handle.h>
 #include <stats/stats_mgr.h>
+#include <util/multi_threading_mgr.h>
+
+#include <thread>
 
 using namespace std;
 using namespace isc::hooks;
 using namespace isc::asiolink;
 using namespace isc::data;
 using namespace isc::stats;
+using namespace isc::util;
 
 namespace isc {
 namespace dhcp {
@@ -32,11 +36,10 @@ namespace test {
 TEST_F(AllocEngine4Test, constructor) {
     boost::scoped_ptr<AllocEngine> x;
 
-    // Hashed and random allocators are not supported yet
+    // Hashed allocator is not supported yet
     ASSERT_THROW(x.reset(new AllocEngine(AllocEngine::ALLOC_HASHED, 5, false)),
                  NotImplemented);
-    ASSERT_THROW(x.reset(new AllocEngine(AllocEngine::ALLOC_RANDOM, 5, false)),
-                 NotImplemented);
+    ASSERT_NO_THROW(x.reset(new AllocEngine(AllocEngine::ALLOC_RANDOM, 5, false)));
 
     // Create V4 (ipv6=false) Allocation Engine that will try at most
     // 100 attempts to pick up a lease
@@ -911,6 +914,257 @@ TEST_F(AllocEngine4Test, IterativeAllocator_manyPools4) {
 }
 
 
+// This test verifies that the free lease queue allocator picks only the
+// addresses which are not leased and that it follows the lease updates.
+TEST_F(AllocEngine4Test, FreeLeaseQueueAllocator) {
+    NakedAllocEngine::FreeLeaseQueueAllocator alloc(Lease::TYPE_V4);
+
+    // Lease two addresses of the pool and a third one which lease expired.
+    time_t now = time(NULL);
+    for (auto address : { "192.0.2.100", "192.0.2.101", "192.0.2.102" }) {
+        Lease4Ptr lease(new Lease4(IOAddress(address), hwaddr_, clientid_,
+                                   100, now, subnet_->getID()));
+        if (lease->addr_ == IOAddress("192.0.2.102")) {
+            lease->cltt_ = now - 200;
+        }
+        ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease));
+    }
+
+    // The addresses are picked in turn.
+    std::set<IOAddress> picked;
+    for (int i = 0; i < 16; ++i) {
+        IOAddress candidate = alloc.pickAddress(subnet_, cc_, clientid_,
+                                                IOAddress("0.0.0.0"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        EXPECT_NE("192.0.2.100", candidate.toText());
+        EXPECT_NE("192.0.2.101", candidate.toText());
+        picked.insert(candidate);
+    }
+    EXPECT_EQ(8, picked.size());
+
+    // The used addresses are no longer picked.
+    for (int i = 102; i < 110; ++i) {
+        std::ostringstream address;
+        address << "192.0.2." << i;
+        alloc.leaseUsed(subnet_->getID(), IOAddress(address.str()));
+    }
+    EXPECT_EQ("0.0.0.0", alloc.pickAddress(subnet_, cc_, clientid_,
+                                           IOAddress("0.0.0.0")).toText());
+
+    // The freed addresses are picked again.
+    alloc.leaseFreed(subnet_->getID(), IOAddress("192.0.2.101"));
+    EXPECT_EQ("192.0.2.101", alloc.pickAddress(subnet_, cc_, clientid_,
+                                               IOAddress("0.0.0.0")).toText());
+
+    // The addresses out of the pools are ignored.
+    alloc.leaseFreed(subnet_->getID(), IOAddress("192.0.2.1"));
+    alloc.leaseUsed(subnet_->getID(), IOAddress("192.0.2.101"));
+    EXPECT_EQ("0.0.0.0", alloc.pickAddress(subnet_, cc_, clientid_,
+                                           IOAddress("0.0.0.0")).toText());
+}
+
+// This test verifies that the free lease queue allocator picks addresses
+// from the pools allowed for the client classes.
+TEST_F(AllocEngine4Test, FreeLeaseQueueAllocator_class) {
+    NakedAllocEngine::FreeLeaseQueueAllocator alloc(Lease::TYPE_V4);
+
+    // Restrict pool_ to the foo class. Add a second pool with bar class.
+    pool_->allowClientClass("foo");
+    Pool4Ptr pool(new Pool4(IOAddress("192.0.2.200"),
+                            IOAddress("192.0.2.209")));
+    pool->allowClientClass("bar");
+    subnet_->addPool(pool);
+
+    // Clients are in bar
+    cc_.insert("bar");
+
+    for (int i = 0; i < 100; ++i) {
+        IOAddress candidate = alloc.pickAddress(subnet_, cc_, clientid_,
+                                                IOAddress("0.0.0.0"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate, cc_));
+    }
+}
+
+// This test verifies that the allocation engine uses the free lease queue
+// allocator when it is configured for the subnet and that the released and
+// reclaimed leases are allocated again.
+TEST_F(AllocEngine4Test, freeLeaseQueueAlloc4) {
+    AllocEngine engine(AllocEngine::ALLOC_ITERATIVE, 0, false);
+    subnet_->setAllocatorType("free-lease-queue");
+
+    // Lease all addresses of the pool but the last one to another client.
+    uint8_t hwaddr2_data[] = { 0, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe };
+    HWAddrPtr hwaddr2(new HWAddr(hwaddr2_data, sizeof(hwaddr2_data), HTYPE_ETHER));
+    time_t now = time(NULL);
+    for (int i = 100; i < 109; ++i) {
+        std::ostringstream address;
+        address << "192.0.2." << i;
+        Lease4Ptr lease(new Lease4(IOAddress(address.str()), hwaddr2,
+                                   ClientIdPtr(), 100, now, subnet_->getID()));
+        ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease));
+    }
+
+    AllocEngine::ClientContext4 ctx(subnet_, clientid_, hwaddr_,
+                                    IOAddress("0.0.0.0"), false, false,
+                                    "", false);
+    ctx.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+    Lease4Ptr lease = engine.allocateLease4(ctx);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.109", lease->addr_.toText());
+
+    // The pool is exhausted.
+    uint8_t hwaddr3_data[] = { 0, 0xfd, 0xfd, 0xfd, 0xfd, 0xfd };
+    HWAddrPtr hwaddr3(new HWAddr(hwaddr3_data, sizeof(hwaddr3_data), HTYPE_ETHER));
+    AllocEngine::ClientContext4 ctx3(subnet_, ClientIdPtr(), hwaddr3,
+                                     IOAddress("0.0.0.0"), false, false,
+                                     "", false);
+    ctx3.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+    EXPECT_FALSE(engine.allocateLease4(ctx3));
+
+    // Release the lease.
+    ASSERT_TRUE(LeaseMgrFactory::instance().deleteLease(lease));
+    engine.leaseFreed(lease);
+    lease = engine.allocateLease4(ctx3);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.109", lease->addr_.toText());
+
+    // Let a lease of the other client expire and reclaim it.
+    Lease4Ptr expired = LeaseMgrFactory::instance().getLease4(IOAddress("192.0.2.104"));
+    ASSERT_TRUE(expired);
+    expired->cltt_ = now - 200;
+    ASSERT_NO_THROW(LeaseMgrFactory::instance().updateLease4(expired));
+    ASSERT_NO_THROW(engine.reclaimExpiredLeases4(0, 0, false));
+
+    ctx.subnet_ = subnet_;
+    lease = engine.allocateLease4(ctx);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.104", lease->addr_.toText());
+}
+
+// This test verifies that the random allocator picks every address of the
+// pools in a random order before picking them again.
+TEST_F(AllocEngine4Test, RandomAllocator) {
+    NakedAllocEngine::RandomAllocator alloc(Lease::TYPE_V4);
+
+    Pool4Ptr pool(new Pool4(IOAddress("192.0.2.200"), IOAddress("192.0.2.209")));
+    subnet_->addPool(pool);
+
+    // Each address of the two pools is picked once.
+    std::set<IOAddress> picked;
+    for (int i = 0; i < 20; ++i) {
+        IOAddress candidate = alloc.pickAddress(subnet_, cc_, clientid_,
+                                                IOAddress("0.0.0.0"));
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, candidate));
+        picked.insert(candidate);
+    }
+    EXPECT_EQ(20, picked.size());
+
+    // The pools are walked over again when they are exhausted.
+    for (int i = 0; i < 20; ++i) {
+        IOAddress candidate = alloc.pickAddress(subnet_, cc_, clientid_,
+                                                IOAddress("0.0.0.0"));
+        EXPECT_EQ(1, picked.count(candidate));
+    }
+}
+
+// This test verifies that the random allocator picks the addresses from
+// the pools allowed for the client only.
+TEST_F(AllocEngine4Test, RandomAllocator_class) {
+    NakedAllocEngine::RandomAllocator alloc(Lease::TYPE_V4);
+
+    Pool4Ptr pool(new Pool4(IOAddress("192.0.2.200"), IOAddress("192.0.2.209")));
+    pool->allowClientClass("foo");
+    subnet_->addPool(pool);
+
+    for (int i = 0; i < 20; ++i) {
+        IOAddress candidate = alloc.pickAddress(subnet_, cc_, clientid_,
+                                                IOAddress("0.0.0.0"));
+        EXPECT_FALSE(pool->inRange(candidate));
+    }
+
+    // No pool is allowed for the client.
+    pool_->allowClientClass("bar");
+    EXPECT_THROW(alloc.pickAddress(subnet_, cc_, clientid_, IOAddress("0.0.0.0")),
+                 AllocFailed);
+
+    cc_.insert("foo");
+    EXPECT_TRUE(pool->inRange(alloc.pickAddress(subnet_, cc_, clientid_,
+                                                IOAddress("0.0.0.0"))));
+}
+
+// This test verifies that in multi-threading mode the allocations are
+// serialized per subnet and the lock contention is counted.
+TEST_F(AllocEngine4Test, allocatorSubnetLock) {
+    NakedAllocEngine::IterativeAllocator alloc(Lease::TYPE_V4);
+    Subnet4Ptr subnet2(new Subnet4(IOAddress("192.0.3.0"), 24, 1, 2, 3));
+    subnet2->addPool(Pool4Ptr(new Pool4(IOAddress("192.0.3.100"),
+                                        IOAddress("192.0.3.109"))));
+
+    // Returns the value of a statistic or 0 when it does not exist.
+    auto getStat = [](const std::string& name) {
+        ObservationPtr stat = StatsMgr::instance().getObservation(name);
+        return (stat ? stat->getInteger().first : 0);
+    };
+    std::string name = StatsMgr::generateName("subnet", subnet_->getID(),
+                                              "allocation-lock-contention");
+    int64_t global = getStat("allocation-lock-contention");
+
+    MultiThreadingMgr::instance().setMode(true);
+    std::unique_lock<std::mutex> lock(subnet_->getAllocationMutex());
+
+    // The allocations in another subnet don't wait.
+    EXPECT_EQ("192.0.3.100", alloc.pickAddress(subnet2, cc_, clientid_,
+                                               IOAddress("0.0.0.0")).toText());
+    EXPECT_EQ(global, getStat("allocation-lock-contention"));
+
+    // The allocations in the locked subnet wait.
+    IOAddress candidate("0.0.0.0");
+    std::thread thread([&]() {
+        candidate = alloc.pickAddress(subnet_, cc_, clientid_,
+                                      IOAddress("0.0.0.0"));
+    });
+    for (int i = 0; (i < 500) && (getStat(name) == 0); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_TRUE(candidate.isV4Zero());
+    lock.unlock();
+    thread.join();
+    MultiThreadingMgr::instance().setMode(false);
+
+    EXPECT_EQ("192.0.2.100", candidate.toText());
+    EXPECT_EQ(1, getStat(name));
+    EXPECT_EQ(global + 1, getStat("allocation-lock-contention"));
+}
+
+// This test checks that the random allocator can be selected for a subnet
+// and allocates all addresses of the pool.
+TEST_F(AllocEngine4Test, randomAlloc4) {
+    AllocEngine engine(AllocEngine::ALLOC_ITERATIVE, 0, false);
+    subnet_->setAllocatorType("random");
+
+    std::set<IOAddress> allocated;
+    for (uint8_t i = 0; i < 10; ++i) {
+        uint8_t hwaddr_data[] = { 0, 0xfe, 0xfe, 0xfe, 0xfe, i };
+        HWAddrPtr hwaddr(new HWAddr(hwaddr_data, sizeof(hwaddr_data), HTYPE_ETHER));
+        AllocEngine::ClientContext4 ctx(subnet_, ClientIdPtr(), hwaddr,
+                                        IOAddress("0.0.0.0"), false, false,
+                                        "", false);
+        ctx.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+        Lease4Ptr lease = engine.allocateLease4(ctx);
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(subnet_->inPool(Lease::TYPE_V4, lease->addr_));
+        allocated.insert(lease->addr_);
+    }
+    EXPECT_EQ(10, allocated.size());
+
+    // The pool is exhausted.
+    AllocEngine::ClientContext4 ctx(subnet_, clientid_, hwaddr_,
+                                    IOAddress("0.0.0.0"), false, false,
+                                    "", false);
+    ctx.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+    EXPECT_FALSE(engine.allocateLease4(ctx));
+}
+
 // This test checks if really small pools are working
 TEST_F(AllocEngine4Test, smallPool4) {
     boost::scoped_ptr<AllocEngine> engine;
@@ -55,9 +55,9 @@ TEST(ClientContext6Test, addAllocatedResource) {
 TEST_F(AllocEngine6Test, constructor) {
     boost::scoped_ptr<AllocEngine> x;
 
-    // Hashed and random allocators are not supported yet
+    // Hashed allocator is not supported yet
     ASSERT_THROW(x.reset(new AllocEngine(AllocEngine::ALLOC_HASHED, 5)), NotImplemented);
-    ASSERT_THROW(x.reset(new AllocEngine(AllocEngine::ALLOC_RANDOM, 5)), NotImplemented);
+    ASSERT_NO_THROW(x.reset(new AllocEngine(AllocEngine::ALLOC_RANDOM, 5)));
 
     ASSERT_NO_THROW(x.reset(new AllocEngine(AllocEngine::ALLOC_ITERATIVE, 100, true)));
 
@@ -812,6 +812,152 @@ TEST_F(AllocEngine6Test, IterativeAllocator_manyPools6) {
     }
 }
 
+// This test verifies that the free lease queue allocator picks only the
+// prefixes which are not leased and that it follows the lease updates.
+TEST_F(AllocEngine6Test, FreeLeaseQueueAllocatorPrefix) {
+    NakedAllocEngine::FreeLeaseQueueAllocator alloc(Lease::TYPE_PD);
+
+    subnet_.reset(new Subnet6(IOAddress("2001:db8::"), 32, 1, 2, 3, 4));
+
+    Pool6Ptr pool1(new Pool6(Lease::TYPE_PD, IOAddress("2001:db8::"), 56, 60));
+    Pool6Ptr pool2(new Pool6(Lease::TYPE_PD, IOAddress("2001:db8:1::"), 48, 48));
+    subnet_->addPool(pool1);
+    subnet_->addPool(pool2);
+
+    // Lease the first prefix of the first pool.
+    Lease6Ptr lease(new Lease6(Lease::TYPE_PD, IOAddress("2001:db8::"), duid_,
+                               iaid_, 501, 502, subnet_->getID(),
+                               HWAddrPtr(), 60));
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease));
+
+    // The 15 other prefixes of the first pool are picked in turn.
+    std::set<IOAddress> picked;
+    for (int i = 0; i < 30; ++i) {
+        IOAddress candidate = alloc.pickAddress(subnet_, cc_, duid_, IOAddress("::"));
+        EXPECT_TRUE(pool1->inRange(candidate));
+        EXPECT_NE("2001:db8::", candidate.toText());
+        picked.insert(candidate);
+    }
+    EXPECT_EQ(15, picked.size());
+    EXPECT_EQ(1, picked.count(IOAddress("2001:db8:0:f0::")));
+
+    // The second pool is used when the first one is exhausted.
+    for (auto prefix : picked) {
+        alloc.leaseUsed(subnet_->getID(), prefix);
+    }
+    EXPECT_EQ("2001:db8:1::",
+              alloc.pickAddress(subnet_, cc_, duid_, IOAddress("::")).toText());
+    alloc.leaseUsed(subnet_->getID(), IOAddress("2001:db8:1::"));
+    EXPECT_EQ("::",
+              alloc.pickAddress(subnet_, cc_, duid_, IOAddress("::")).toText());
+
+    // The freed prefixes are picked again.
+    alloc.leaseFreed(subnet_->getID(), IOAddress("2001:db8:0:30::"));
+    EXPECT_EQ("2001:db8:0:30::",
+              alloc.pickAddress(subnet_, cc_, duid_, IOAddress("::")).toText());
+}
+
+// This test verifies that the allocation engine uses the free lease queue
+// allocator when it is configured for the subnet.
+TEST_F(AllocEngine6Test, freeLeaseQueueAlloc6) {
+    AllocEngine engine(AllocEngine::ALLOC_ITERATIVE, 0);
+    subnet_->setAllocatorType("free-lease-queue");
+
+    // Lease all addresses of the pool but one to another client.
+    DuidPtr other_duid = DuidPtr(new DUID(vector<uint8_t>(12, 0xff)));
+    for (int i = 0x10; i <= 0x20; ++i) {
+        if (i == 0x18) {
+            continue;
+        }
+        std::ostringstream address;
+        address << "2001:db8:1::" << std::hex << i;
+        Lease6Ptr lease(new Lease6(Lease::TYPE_NA, IOAddress(address.str()),
+                                   other_duid, i, 501, 502, subnet_->getID(),
+                                   HWAddrPtr(), 0));
+        ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease));
+    }
+
+    Pkt6Ptr query(new Pkt6(DHCPV6_REQUEST, 1234));
+    AllocEngine::ClientContext6 ctx(subnet_, duid_, false, false, "", false,
+                                    query);
+    ctx.currentIA().iaid_ = iaid_;
+    Lease6Ptr lease;
+    ASSERT_NO_THROW(lease = expectOneLease(engine.allocateLeases6(ctx)));
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("2001:db8:1::18", lease->addr_.toText());
+
+    // The pool is exhausted.
+    AllocEngine::ClientContext6 ctx2(subnet_, duid_, false, false, "", false,
+                                     query);
+    ctx2.currentIA().iaid_ = iaid_ + 1;
+    Lease6Ptr lease2;
+    ASSERT_NO_THROW(lease2 = expectOneLease(engine.allocateLeases6(ctx2)));
+    EXPECT_FALSE(lease2);
+
+    // Release the lease.
+    ASSERT_TRUE(LeaseMgrFactory::instance().deleteLease(lease));
+    engine.leaseFreed(lease);
+    AllocEngine::ClientContext6 ctx3(subnet_, duid_, false, false, "", false,
+                                     query);
+    ctx3.currentIA().iaid_ = iaid_ + 1;
+    ASSERT_NO_THROW(lease2 = expectOneLease(engine.allocateLeases6(ctx3)));
+    ASSERT_TRUE(lease2);
+    EXPECT_EQ("2001:db8:1::18", lease2->addr_.toText());
+}
+
+// This test verifies that the random allocator picks every delegated
+// prefix of the pools in a random order.
+TEST_F(AllocEngine6Test, RandomAllocatorPrefix) {
+    NakedAllocEngine::RandomAllocator alloc(Lease::TYPE_PD);
+
+    subnet_.reset(new Subnet6(IOAddress("2001:db8::"), 32, 1, 2, 3, 4));
+
+    Pool6Ptr pool1(new Pool6(Lease::TYPE_PD, IOAddress("2001:db8::"), 56, 60));
+    Pool6Ptr pool2(new Pool6(Lease::TYPE_PD, IOAddress("2001:db8:1::"), 48, 48));
+    subnet_->addPool(pool1);
+    subnet_->addPool(pool2);
+
+    std::set<IOAddress> picked;
+    for (int i = 0; i < 17; ++i) {
+        IOAddress candidate = alloc.pickAddress(subnet_, cc_, duid_, IOAddress("::"));
+        EXPECT_TRUE(pool1->inRange(candidate) || pool2->inRange(candidate));
+        picked.insert(candidate);
+    }
+    EXPECT_EQ(17, picked.size());
+    EXPECT_EQ(1, picked.count(IOAddress("2001:db8:0:f0::")));
+    EXPECT_EQ(1, picked.count(IOAddress("2001:db8:1::")));
+}
+
+// This test checks that the random allocator can be selected for a subnet
+// and allocates all addresses of the pool.
+TEST_F(AllocEngine6Test, randomAlloc6) {
+    AllocEngine engine(AllocEngine::ALLOC_ITERATIVE, 0);
+    subnet_->setAllocatorType("random");
+
+    // Lease all addresses of the pool but one to another client.
+    DuidPtr other_duid = DuidPtr(new DUID(vector<uint8_t>(12, 0xff)));
+    for (int i = 0x10; i <= 0x20; ++i) {
+        if (i == 0x18) {
+            continue;
+        }
+        std::ostringstream address;
+        address << "2001:db8:1::" << std::hex << i;
+        Lease6Ptr lease(new Lease6(Lease::TYPE_NA, IOAddress(address.str()),
+                                   other_duid, i, 501, 502, subnet_->getID(),
+                                   HWAddrPtr(), 0));
+        ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease));
+    }
+
+    Pkt6Ptr query(new Pkt6(DHCPV6_REQUEST, 1234));
+    AllocEngine::ClientContext6 ctx(subnet_, duid_, false, false, "", false,
+                                    query);
+    ctx.currentIA().iaid_ = iaid_;
+    Lease6Ptr lease;
+    ASSERT_NO_THROW(lease = expectOneLease(engine.allocateLeases6(ctx)));
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("2001:db8:1::18", lease->addr_.toText());
+}
+
 // This test checks if really small pools are working
 TEST_F(AllocEngine6Test, smallPool6) {
     boost::scoped_ptr<AllocEngine> engine;
@@ -9,6 +9,8 @@
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcp/libdhcp++.h>
 #include <dhcp/option_space.h>
+#include <dhcp/pkt4.h>
+#include <eval/evaluate.h>
 #include <testutils/test_to_element.h>
 #include <exceptions/exceptions.h>
 #include <boost/scoped_ptr.hpp>
@@ -56,6 +58,35 @@ TEST(ClientClassDef, construction) {
     EXPECT_FALSE(cclass->dependOnClass(""));
 }
 
+// Tests that the match expression is compiled.
+TEST(ClientClassDef, compiledMatchExpr) {
+    boost::scoped_ptr<ClientClassDef> cclass;
+    ASSERT_NO_THROW(cclass.reset(new ClientClassDef("class1", ExpressionPtr())));
+    EXPECT_FALSE(cclass->getCompiledMatchExpr());
+
+    // Set an expression: 'foo' == 'foo'
+    ExpressionPtr expr(new Expression());
+    expr->push_back(TokenPtr(new TokenString("foo")));
+    expr->push_back(TokenPtr(new TokenString("foo")));
+    expr->push_back(TokenPtr(new TokenEqual()));
+    cclass->setMatchExpr(expr);
+    ASSERT_TRUE(cclass->getCompiledMatchExpr());
+    Pkt4 pkt(DHCPDISCOVER, 1234);
+    EXPECT_TRUE(evaluateBool(*cclass->getCompiledMatchExpr(), pkt));
+
+    // The copy shares the compiled expression.
+    ClientClassDef copy(*cclass);
+    EXPECT_EQ(cclass->getCompiledMatchExpr(), copy.getCompiledMatchExpr());
+
+    // Classes constructed with an expression have it compiled too.
+    ASSERT_NO_THROW(cclass.reset(new ClientClassDef("class2", expr)));
+    ASSERT_TRUE(cclass->getCompiledMatchExpr());
+
+    // Clear the expression.
+    cclass->setMatchExpr(ExpressionPtr());
+    EXPECT_FALSE(cclass->getCompiledMatchExpr());
+}
+
 // Tests options operations.  Note we just do the basics
 // as CfgOption is heavily tested elsewhere.
 TEST(ClientClassDef, cfgOptionBasics) {
@@ -85,6 +85,34 @@ TEST_F(DHCPQueueControlParserTest, validContent) {
         "   \"foo\": \"bogus\", \n"
         "   \"random-int\" : 1234 \n"
         "} \n"
+        },
+        {
+        "queue disabled, with receive-batch-size",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"receive-batch-size\": 64 \n"
+        "} \n"
+        },
+        {
+        "queue disabled, with send-batch-size",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"send-batch-size\": 32 \n"
+        "} \n"
+        },
+        {
+        "queue disabled, with raw-socket-ring",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"raw-socket-ring\": true \n"
+        "} \n"
+        },
+        {
+        "queue disabled, with select event-handler",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"event-handler\": \"select\" \n"
+        "} \n"
         }
     };
 
@@ -150,6 +178,55 @@ TEST_F(DHCPQueueControlParserTest, invalidContent) {
         "   \"enable-queue\": true, \n"
         "   \"queue-type\": 7777 \n"
         "} \n"
+        },
+        {
+        "receive-batch-size not an integer",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"receive-batch-size\": \"many\" \n"
+        "} \n"
+        },
+        {
+        "receive-batch-size out of range",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"receive-batch-size\": 0 \n"
+        "} \n"
+        },
+        {
+        "send-batch-size not an integer",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"send-batch-size\": true \n"
+        "} \n"
+        },
+        {
+        "send-batch-size out of range",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"send-batch-size\": 1025 \n"
+        "} \n"
+        },
+        {
+        "raw-socket-ring not a boolean",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"raw-socket-ring\": \"yes\" \n"
+        "} \n"
+        },
+        {
+        "event-handler not a string",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"event-handler\": 1 \n"
+        "} \n"
+        },
+        {
+        "unknown event-handler",
+        "{ \n"
+        "   \"enable-queue\": false, \n"
+        "   \"event-handler\": \"kqueue\" \n"
+        "} \n"
         }
     };
 
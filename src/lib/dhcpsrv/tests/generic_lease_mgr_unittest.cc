@@ -2009,6 +2009,168 @@ GenericLeaseMgrTest::testConcurrentUpdateLease6() {
     EXPECT_THROW(lmptr_->updateLease6(initialLease), isc::dhcp::NoSuchLease);
 }
 
+void
+GenericLeaseMgrTest::testApplyLeaseChanges4() {
+    // Get the leases to be used for the test and add two of them.
+    vector<Lease4Ptr> leases = createLeases4();
+    ASSERT_LE(5, leases.size());
+    ASSERT_TRUE(lmptr_->addLease(leases[0]));
+    ASSERT_TRUE(lmptr_->addLease(leases[1]));
+    lmptr_->commit();
+
+    leases[1]->hostname_ = "modified.hostname.";
+
+    LeaseChange4Collection changes;
+    changes.push_back(LeaseChange4(LeaseChange4::ADD, leases[2]));
+    changes.push_back(LeaseChange4(LeaseChange4::ADD, leases[0]));
+    changes.push_back(LeaseChange4(LeaseChange4::UPDATE, leases[1]));
+    changes.push_back(LeaseChange4(LeaseChange4::UPDATE, leases[3]));
+    changes.push_back(LeaseChange4(LeaseChange4::DELETE, leases[0]));
+    changes.push_back(LeaseChange4(LeaseChange4::DELETE, leases[4]));
+    ASSERT_NO_THROW(lmptr_->applyLeaseChanges(changes));
+
+    // The new lease is added, the existing one is not.
+    EXPECT_TRUE(changes[0].applied_);
+    EXPECT_TRUE(changes[0].error_.empty());
+    EXPECT_FALSE(changes[1].applied_);
+    EXPECT_TRUE(changes[1].error_.empty());
+
+    // The existing lease is updated, the missing one fails to be updated.
+    EXPECT_TRUE(changes[2].applied_);
+    EXPECT_TRUE(changes[2].error_.empty());
+    EXPECT_FALSE(changes[3].applied_);
+    EXPECT_FALSE(changes[3].error_.empty());
+
+    // The existing lease is deleted, the missing one is not.
+    EXPECT_TRUE(changes[4].applied_);
+    EXPECT_TRUE(changes[4].error_.empty());
+    EXPECT_FALSE(changes[5].applied_);
+    EXPECT_TRUE(changes[5].error_.empty());
+
+    // Check the lease database.
+    EXPECT_FALSE(lmptr_->getLease4(ioaddress4_[0]));
+    Lease4Ptr l_returned = lmptr_->getLease4(ioaddress4_[1]);
+    ASSERT_TRUE(l_returned);
+    detailCompareLease(leases[1], l_returned);
+    l_returned = lmptr_->getLease4(ioaddress4_[2]);
+    ASSERT_TRUE(l_returned);
+    detailCompareLease(leases[2], l_returned);
+    EXPECT_FALSE(lmptr_->getLease4(ioaddress4_[3]));
+    EXPECT_FALSE(lmptr_->getLease4(ioaddress4_[4]));
+
+    // The updated lease can be updated again.
+    leases[1]->hostname_ = "again.modified.hostname.";
+    EXPECT_NO_THROW(lmptr_->updateLease4(leases[1]));
+
+    // Apply a batch in which no change fails.
+    leases[2]->hostname_ = "modified.hostname.";
+    changes.clear();
+    changes.push_back(LeaseChange4(LeaseChange4::ADD, leases[3]));
+    changes.push_back(LeaseChange4(LeaseChange4::UPDATE, leases[2]));
+    changes.push_back(LeaseChange4(LeaseChange4::DELETE, leases[1]));
+    changes.push_back(LeaseChange4(LeaseChange4::DELETE, leases[4]));
+    ASSERT_NO_THROW(lmptr_->applyLeaseChanges(changes));
+    EXPECT_TRUE(changes[0].applied_);
+    EXPECT_TRUE(changes[1].applied_);
+    EXPECT_TRUE(changes[2].applied_);
+    EXPECT_FALSE(changes[3].applied_);
+    for (auto const& change : changes) {
+        EXPECT_TRUE(change.error_.empty());
+    }
+    EXPECT_FALSE(lmptr_->getLease4(ioaddress4_[1]));
+    l_returned = lmptr_->getLease4(ioaddress4_[2]);
+    ASSERT_TRUE(l_returned);
+    detailCompareLease(leases[2], l_returned);
+    l_returned = lmptr_->getLease4(ioaddress4_[3]);
+    ASSERT_TRUE(l_returned);
+    detailCompareLease(leases[3], l_returned);
+
+    // An empty batch is a no-op.
+    changes.clear();
+    EXPECT_NO_THROW(lmptr_->applyLeaseChanges(changes));
+}
+
+void
+GenericLeaseMgrTest::testApplyLeaseChanges6() {
+    // Get the leases to be used for the test and add two of them.
+    vector<Lease6Ptr> leases = createLeases6();
+    ASSERT_LE(5, leases.size());
+    ASSERT_TRUE(lmptr_->addLease(leases[0]));
+    ASSERT_TRUE(lmptr_->addLease(leases[1]));
+    lmptr_->commit();
+
+    leases[1]->hostname_ = "modified.hostname.";
+
+    LeaseChange6Collection changes;
+    changes.push_back(LeaseChange6(LeaseChange6::ADD, leases[2]));
+    changes.push_back(LeaseChange6(LeaseChange6::ADD, leases[0]));
+    changes.push_back(LeaseChange6(LeaseChange6::UPDATE, leases[1]));
+    changes.push_back(LeaseChange6(LeaseChange6::UPDATE, leases[3]));
+    changes.push_back(LeaseChange6(LeaseChange6::DELETE, leases[0]));
+    changes.push_back(LeaseChange6(LeaseChange6::DELETE, leases[4]));
+    ASSERT_NO_THROW(lmptr_->applyLeaseChanges(changes));
+
+    // The new lease is added, the existing one is not.
+    EXPECT_TRUE(changes[0].applied_);
+    EXPECT_TRUE(changes[0].error_.empty());
+    EXPECT_FALSE(changes[1].applied_);
+    EXPECT_TRUE(changes[1].error_.empty());
+
+    // The existing lease is updated, the missing one fails to be updated.
+    EXPECT_TRUE(changes[2].applied_);
+    EXPECT_TRUE(changes[2].error_.empty());
+    EXPECT_FALSE(changes[3].applied_);
+    EXPECT_FALSE(changes[3].error_.empty());
+
+    // The existing lease is deleted, the missing one is not.
+    EXPECT_TRUE(changes[4].applied_);
+    EXPECT_TRUE(changes[4].error_.empty());
+    EXPECT_FALSE(changes[5].applied_);
+    EXPECT_TRUE(changes[5].error_.empty());
+
+    // Check the lease database.
+    EXPECT_FALSE(lmptr_->getLease6(leasetype6_[0], ioaddress6_[0]));
+    Lease6Ptr l_returned = lmptr_->getLease6(leasetype6_[1], ioaddress6_[1]);
+    ASSERT_TRUE(l_returned);
+    detailCompareLease(leases[1], l_returned);
+    l_returned = lmptr_->getLease6(leasetype6_[2], ioaddress6_[2]);
+    ASSERT_TRUE(l_returned);
+    detailCompareLease(leases[2], l_returned);
+    EXPECT_FALSE(lmptr_->getLease6(leasetype6_[3], ioaddress6_[3]));
+    EXPECT_FALSE(lmptr_->getLease6(leasetype6_[4], ioaddress6_[4]));
+
+    // The updated lease can be updated again.
+    leases[1]->hostname_ = "again.modified.hostname.";
+    EXPECT_NO_THROW(lmptr_->updateLease6(leases[1]));
+
+    // Apply a batch in which no change fails.
+    leases[2]->hostname_ = "modified.hostname.";
+    changes.clear();
+    changes.push_back(LeaseChange6(LeaseChange6::ADD, leases[3]));
+    changes.push_back(LeaseChange6(LeaseChange6::UPDATE, leases[2]));
+    changes.push_back(LeaseChange6(LeaseChange6::DELETE, leases[1]));
+    changes.push_back(LeaseChange6(LeaseChange6::DELETE, leases[4]));
+    ASSERT_NO_THROW(lmptr_->applyLeaseChanges(changes));
+    EXPECT_TRUE(changes[0].applied_);
+    EXPECT_TRUE(changes[1].applied_);
+    EXPECT_TRUE(changes[2].applied_);
+    EXPECT_FALSE(changes[3].applied_);
+    for (auto const& change : changes) {
+        EXPECT_TRUE(change.error_.empty());
+    }
+    EXPECT_FALSE(lmptr_->getLease6(leasetype6_[1], ioaddress6_[1]));
+    l_returned = lmptr_->getLease6(leasetype6_[2], ioaddress6_[2]);
+    ASSERT_TRUE(l_returned);
+    detailCompareLease(leases[2], l_returned);
+    l_returned = lmptr_->getLease6(leasetype6_[3], ioaddress6_[3]);
+    ASSERT_TRUE(l_returned);
+    detailCompareLease(leases[3], l_returned);
+
+    // An empty batch is a no-op.
+    changes.clear();
+    EXPECT_NO_THROW(lmptr_->applyLeaseChanges(changes));
+}
+
 void
 GenericLeaseMgrTest::testRecreateLease4() {
     // Create a lease.
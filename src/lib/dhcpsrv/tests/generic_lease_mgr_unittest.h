@@ -337,6 +337,18 @@ public:
     /// the database.
     void testConcurrentUpdateLease6();
 
+    /// @brief Lease4 batch update test
+    ///
+    /// Checks that a batch of changes of IPv4 leases is applied and that
+    /// the outcome of each change is reported.
+    void testApplyLeaseChanges4();
+
+    /// @brief Lease6 batch update test
+    ///
+    /// Checks that a batch of changes of IPv6 leases is applied and that
+    /// the outcome of each change is reported.
+    void testApplyLeaseChanges6();
+
     /// @brief Check that the IPv6 lease can be added, removed and recreated.
     ///
     /// This test creates a lease, removes it and then recreates it with some
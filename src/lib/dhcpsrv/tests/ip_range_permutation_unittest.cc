@@ -137,4 +137,44 @@ TEST(IPRangePermutationTest, pd) {
     EXPECT_TRUE(addrs.begin()->isV6Zero());
 }
 
+// This test verifies that a permutation of a range holding a single
+// address returns this address.
+TEST(IPRangePermutationTest, singleAddress) {
+    AddressRange range(IOAddress("192.0.2.1"), IOAddress("192.0.2.1"));
+    IPRangePermutation perm(range);
+
+    bool done = false;
+    EXPECT_EQ("192.0.2.1", perm.next(done).toText());
+    EXPECT_TRUE(done);
+    EXPECT_TRUE(perm.exhausted());
+
+    EXPECT_TRUE(perm.next(done).isV4Zero());
+    EXPECT_TRUE(done);
+}
+
+// This test verifies that a permutation of delegated prefixes shorter
+// than /64 can be generated.
+TEST(IPRangePermutationTest, pdShortPrefixes) {
+    PrefixRange range(IOAddress("3000::"), 32, 40);
+    IPRangePermutation perm(range);
+
+    std::set<IOAddress> addrs;
+    bool done = false;
+    for (auto i = 0; i < 256; ++i) {
+        auto next = perm.next(done);
+        ASSERT_FALSE(next.isV6Zero());
+        // Make sure the prefix is within the range and is a /40.
+        EXPECT_LE(range.start_, next);
+        EXPECT_LE(next, range.end_);
+        auto bytes = next.toBytes();
+        for (auto b = 5; b < 16; ++b) {
+            EXPECT_EQ(0, bytes[b]);
+        }
+        addrs.insert(next);
+    }
+    EXPECT_TRUE(done);
+    EXPECT_EQ(256, addrs.size());
+    EXPECT_EQ("3000:0:ff00::", addrs.rbegin()->toText());
+}
+
 } // end of anonymous namespace
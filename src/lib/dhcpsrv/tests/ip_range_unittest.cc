@@ -43,6 +43,10 @@ TEST(PrefixRangeTest, constructor) {
     ASSERT_NO_THROW(range.reset(new PrefixRange(IOAddress("2001:db8:1:2::"), 80, 127)));
     EXPECT_EQ("2001:db8:1:2::", range->start_.toText());
     EXPECT_EQ("2001:db8:1:2:0:ffff:ffff:fffe", range->end_.toText());
+
+    ASSERT_NO_THROW(range.reset(new PrefixRange(IOAddress("2001:db8::"), 32, 48)));
+    EXPECT_EQ("2001:db8::", range->start_.toText());
+    EXPECT_EQ("2001:db8:ffff::", range->end_.toText());
 }
 
 // This test verifies that exception is thrown upon an attempt to
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2019 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2020 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -751,6 +751,157 @@ TEST_F(LeaseFileLoaderTest, loadWriteLeaseWithZeroLifetime) {
     }
 }
 
+// This test verifies that the DHCPv4 leases loaded by several threads
+// are the same as the leases loaded by a single thread when the entries
+// for the leases span several chunks of the lease file.
+TEST_F(LeaseFileLoaderTest, loadParallel4) {
+    // Each lease has several entries spread across the file. Some leases
+    // are released (valid lifetime of 0) and some entries are invalid.
+    std::ostringstream os;
+    os << v4_hdr_;
+    const size_t rows = 3 * LeaseFileLoader::LOAD_CHUNK_SIZE + 17;
+    for (size_t i = 0; i < rows; ++i) {
+        const unsigned host = i % 1000;
+        os << "192.0." << (2 + host / 250) << "." << (1 + host % 250) << ",";
+        if (i % 101 == 0) {
+            // Lacks HW address and client id.
+            os << ",,";
+        } else {
+            os << "06:07:08:09:0a:" << std::hex << (i % 256) << std::dec
+               << ",,";
+        }
+        os << ((i % 37 == 0) ? 0 : 200) << "," << (200 + i)
+           << ",8,1,1,host.example.com,0,\n";
+    }
+    io_.writeFile(os.str());
+
+    boost::scoped_ptr<CSVLeaseFile4> lf(new CSVLeaseFile4(filename_));
+    Lease4Storage storage;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(*lf, storage, 0, true));
+    const uint32_t read_leases = lf->getReadLeases();
+    const uint32_t read_errs = lf->getReadErrs();
+    EXPECT_EQ(rows, read_leases + read_errs);
+    EXPECT_LT(0, read_errs);
+
+    Lease4Storage storage_mt;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(*lf, storage_mt, 0, true, 4));
+
+    {
+    SCOPED_TRACE("Read leases");
+    checkStats(*lf, rows + 1, read_leases, read_errs, 0, 0, 0);
+    }
+
+    // The same leases must have been loaded.
+    ASSERT_FALSE(storage.empty());
+    ASSERT_EQ(storage.size(), storage_mt.size());
+    for (auto lease : storage) {
+        Lease4Ptr lease_mt = getLease<Lease4Ptr>(lease->addr_.toText(), storage_mt);
+        ASSERT_TRUE(lease_mt) << lease->addr_;
+        EXPECT_TRUE(*lease == *lease_mt) << lease->toText();
+    }
+}
+
+// This test verifies that the DHCPv6 leases loaded by several threads
+// are the same as the leases loaded by a single thread when the entries
+// for the leases span several chunks of the lease file.
+TEST_F(LeaseFileLoaderTest, loadParallel6) {
+    std::ostringstream os;
+    os << v6_hdr_;
+    const size_t rows = 2 * LeaseFileLoader::LOAD_CHUNK_SIZE + 5;
+    for (size_t i = 0; i < rows; ++i) {
+        os << "2001:db8:1::" << std::hex << (1 + i % 777) << std::dec << ",";
+        if (i % 89 == 0) {
+            // Invalid DUID.
+            os << "zz";
+        } else {
+            os << "00:01:02:03:04:05:06:0a:0b:0c:0d:0e:" << std::hex
+               << (i % 256) << std::dec;
+        }
+        os << "," << ((i % 41 == 0) ? 0 : 200) << "," << (200 + i)
+           << ",8,100,0,7,0,1,1,host.example.com,,1,\n";
+    }
+    io_.writeFile(os.str());
+
+    boost::scoped_ptr<CSVLeaseFile6> lf(new CSVLeaseFile6(filename_));
+    Lease6Storage storage;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease6>(*lf, storage, 0, true));
+    const uint32_t read_leases = lf->getReadLeases();
+    const uint32_t read_errs = lf->getReadErrs();
+    EXPECT_EQ(rows, read_leases + read_errs);
+    EXPECT_LT(0, read_errs);
+
+    Lease6Storage storage_mt;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease6>(*lf, storage_mt, 0, true, 3));
+
+    {
+    SCOPED_TRACE("Read leases");
+    checkStats(*lf, rows + 1, read_leases, read_errs, 0, 0, 0);
+    }
+
+    ASSERT_FALSE(storage.empty());
+    ASSERT_EQ(storage.size(), storage_mt.size());
+    for (auto lease : storage) {
+        Lease6Ptr lease_mt = getLease<Lease6Ptr>(lease->addr_.toText(), storage_mt);
+        ASSERT_TRUE(lease_mt) << lease->addr_;
+        EXPECT_TRUE(*lease == *lease_mt) << lease->toText();
+    }
+}
+
+// This test verifies that max-row-errors works correctly when the
+// DHCPv4 lease file is loaded by several threads.
+TEST_F(LeaseFileLoaderTest, maxRowErrorsParallel4) {
+    // We have 9 rows: 2 that are good, 7 that are flawed (too few fields).
+    std::vector<std::string> rows = {
+        "192.0.2.100,08:00:27:25:d3:f4,31:31:31:31,3600,1565356064,1,0,0,,0,\n",
+        "192.0.2.101,FF:FF:FF:FF:FF:01,32:32:32:31,3600,1565356073,1,0,0\n",
+        "192.0.2.102,FF:FF:FF:FF:FF:02,32:32:32:32,3600,1565356073,1,0,0\n",
+        "192.0.2.103,FF:FF:FF:FF:FF:03,32:32:32:33,3600,1565356073,1,0,0\n",
+        "192.0.2.104,FF:FF:FF:FF:FF:04,32:32:32:34,3600,1565356073,1,0,0\n",
+        "192.0.2.105,FF:FF:FF:FF:FF:05,32:32:32:35,3600,1565356073,1,0,0\n",
+        "192.0.2.106,FF:FF:FF:FF:FF:06,32:32:32:36,3600,1565356073,1,0,0\n",
+        "192.0.2.107,FF:FF:FF:FF:FF:07,32:32:32:37,3600,1565356073,1,0,0\n",
+        "192.0.2.108,08:00:27:25:d3:f4,32:32:32:32,3600,1565356073,1,0,0,,0,\n"
+    };
+
+    std::ostringstream os;
+    os << v4_hdr_;
+    for (auto row : rows) {
+        os << row;
+    }
+
+    io_.writeFile(os.str());
+
+    boost::scoped_ptr<CSVLeaseFile4> lf(new CSVLeaseFile4(filename_));
+    ASSERT_NO_THROW(lf->open());
+
+    // Let's limit the number of errors to 5 (we have 7 in the data) and
+    // try to load the leases.
+    uint32_t max_errors = 5;
+    Lease4Storage storage;
+    ASSERT_THROW(LeaseFileLoader::load<Lease4>(*lf, storage, max_errors,
+                                               true, 4),
+                 util::CSVFileError);
+
+    // The whole chunk has been read but the leases are processed in
+    // order so the load stops after 1 lease and 6 errors.
+    {
+        SCOPED_TRACE("Failed load stats");
+        checkStats(*lf, 10, 1, 6, 0, 0, 0);
+    }
+
+    // Now let's disable the error limit and try again.
+    max_errors = 0;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(*lf, storage, max_errors,
+                                                  true, 4));
+
+    // We should have made 10 reads, with 2 leases read, and 7 errors.
+    {
+        SCOPED_TRACE("Good load stats");
+        checkStats(*lf, 10, 2, 7, 0, 0, 0);
+    }
+    EXPECT_EQ(2, storage.size());
+}
+
 // This test checks if the lease can be loaded, even though there are no
 // subnets configured that it would match.
 // Scenario: print a warning, there's no subnet,
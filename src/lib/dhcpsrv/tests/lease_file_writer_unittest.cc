@@ -0,0 +1,323 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcpsrv/csv_lease_file4.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_file_loader.h>
+#include <dhcpsrv/lease_file_writer.h>
+#include <dhcpsrv/memfile_lease_storage.h>
+#include <dhcpsrv/testutils/lease_file_io.h>
+#include <stats/stats_mgr.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+using namespace isc::stats;
+
+namespace {
+
+// HWADDR value used by unit tests.
+const uint8_t HWADDR0[] = { 0, 1, 2, 3, 4, 5 };
+
+/// @brief Lease file recording the calls made by the writer.
+class TestLeaseFile4 : public LeaseFile4 {
+public:
+
+    /// @brief Constructor.
+    TestLeaseFile4()
+        : open_(true), syncs_(0), synced_(0), delay_(0), leases_(),
+          mutex_() {
+    }
+
+    /// @brief Opens the file.
+    virtual void open(const bool) {
+        open_ = true;
+    }
+
+    /// @brief Closes the file.
+    virtual void close() {
+        open_ = false;
+    }
+
+    /// @brief The file always exists.
+    virtual bool exists() const {
+        return (true);
+    }
+
+    /// @brief Returns the name of the file.
+    virtual std::string getFilename() const {
+        return ("test-lease-file");
+    }
+
+    /// @brief Records the address of the lease.
+    ///
+    /// @throw BadValue if the file is closed or the lease has the
+    /// 192.0.2.255 address.
+    virtual void append(const Lease4& lease) {
+        if (!open_) {
+            isc_throw(BadValue, "file is closed");
+        }
+        if (lease.addr_ == IOAddress("192.0.2.255")) {
+            isc_throw(BadValue, "invalid lease");
+        }
+        if (delay_ > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_));
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        leases_.push_back(lease.addr_);
+    }
+
+    /// @brief The file never needs conversion.
+    virtual bool needsConversion() const {
+        return (false);
+    }
+
+    /// @brief Does nothing.
+    virtual void flush() {
+    }
+
+    /// @brief Counts the syncs and the leases written before the last one.
+    virtual void sync() {
+        ++syncs_;
+        synced_ = getLeases().size();
+    }
+
+    /// @brief Returns the addresses of the written leases.
+    std::vector<IOAddress> getLeases() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return (leases_);
+    }
+
+    /// @brief Indicates if the file is open.
+    std::atomic<bool> open_;
+
+    /// @brief Number of syncs.
+    std::atomic<size_t> syncs_;
+
+    /// @brief Number of leases written before the last sync.
+    std::atomic<size_t> synced_;
+
+    /// @brief Time in milliseconds taken by each append.
+    unsigned delay_;
+
+private:
+
+    /// @brief Addresses of the written leases.
+    std::vector<IOAddress> leases_;
+
+    /// @brief Mutex protecting the addresses.
+    std::mutex mutex_;
+};
+
+/// @brief Pointer to the test lease file.
+typedef boost::shared_ptr<TestLeaseFile4> TestLeaseFile4Ptr;
+
+/// @brief Test fixture class for @c LeaseFileWriter.
+class LeaseFileWriterTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    LeaseFileWriterTest()
+        : file_(new TestLeaseFile4()), config_() {
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Destructor.
+    virtual ~LeaseFileWriterTest() {
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Creates a writer for the test lease file.
+    ///
+    /// @param policy Write policy.
+    boost::shared_ptr<LeaseFileWriter<Lease4> >
+    createWriter(const LeaseWritePolicy& policy) {
+        config_.policy_ = policy;
+        return (boost::shared_ptr<LeaseFileWriter<Lease4> >(
+            new LeaseFileWriter<Lease4>(file_, config_, "test")));
+    }
+
+    /// @brief Creates a DHCPv4 lease.
+    ///
+    /// @param index Index used as the last byte of the address.
+    static Lease4 createLease(const uint8_t index) {
+        std::ostringstream addr;
+        addr << "192.0.2." << static_cast<unsigned>(index);
+        HWAddrPtr hwaddr(new HWAddr(HWADDR0, sizeof(HWADDR0), HTYPE_ETHER));
+        return (Lease4(IOAddress(addr.str()), hwaddr, NULL, 0, 200, 1000, 1));
+    }
+
+    /// @brief The test lease file.
+    TestLeaseFile4Ptr file_;
+
+    /// @brief Write policy and its parameters.
+    LeaseWriteConfig config_;
+};
+
+// Checks the conversions of the write policies to and from their names.
+TEST_F(LeaseFileWriterTest, policyText) {
+    for (auto policy : { LEASE_WRITE_DIRECT, LEASE_WRITE_SYNC,
+                         LEASE_WRITE_GROUP_COMMIT, LEASE_WRITE_BUFFERED }) {
+        EXPECT_EQ(policy, LeaseWriteConfig::policyFromText(
+                      LeaseWriteConfig::policyToText(policy)));
+    }
+    EXPECT_EQ("group-commit",
+              LeaseWriteConfig::policyToText(LEASE_WRITE_GROUP_COMMIT));
+    EXPECT_THROW(LeaseWriteConfig::policyFromText("fsync"), BadValue);
+
+    LeaseWriteConfig config;
+    EXPECT_EQ(LEASE_WRITE_DIRECT, config.policy_);
+    EXPECT_FALSE(config.writeBehind());
+}
+
+// Checks that the lease updates are written by the caller with the direct
+// and sync policies.
+TEST_F(LeaseFileWriterTest, direct) {
+    auto writer = createWriter(LEASE_WRITE_DIRECT);
+    writer->append(createLease(1));
+    EXPECT_EQ(1, file_->getLeases().size());
+    EXPECT_EQ(0, file_->syncs_.load());
+
+    writer = createWriter(LEASE_WRITE_SYNC);
+    writer->append(createLease(2));
+    writer->append(createLease(3));
+    EXPECT_EQ(3, file_->getLeases().size());
+    EXPECT_EQ(2, file_->syncs_.load());
+
+    // The errors are reported to the caller.
+    EXPECT_THROW(writer->append(createLease(255)), BadValue);
+}
+
+// Checks that the writer thread writes the lease updates in order and
+// syncs them when the file is closed with the group commit policy.
+TEST_F(LeaseFileWriterTest, groupCommit) {
+    config_.batch_size_ = 10;
+    config_.interval_ = 100000;
+    auto writer = createWriter(LEASE_WRITE_GROUP_COMMIT);
+    for (uint8_t i = 1; i <= 25; ++i) {
+        writer->append(createLease(i));
+    }
+    writer->flush();
+    EXPECT_EQ(0, writer->getQueueSize());
+    std::vector<IOAddress> leases = file_->getLeases();
+    ASSERT_EQ(25, leases.size());
+    for (uint8_t i = 1; i <= 25; ++i) {
+        EXPECT_EQ(createLease(i).addr_, leases[i - 1]);
+    }
+
+    writer->close();
+    EXPECT_FALSE(file_->open_.load());
+    EXPECT_LE(1, file_->syncs_.load());
+    EXPECT_EQ(25, file_->synced_.load());
+
+    // The statistics are set by the writer thread.
+    EXPECT_TRUE(StatsMgr::instance().getObservation("test-write-queue-depth"));
+    EXPECT_TRUE(StatsMgr::instance().getObservation("test-write-latency"));
+}
+
+// Checks that the written lease updates are synced when the write
+// interval elapses with the group commit policy.
+TEST_F(LeaseFileWriterTest, groupCommitInterval) {
+    config_.batch_size_ = 1000;
+    config_.interval_ = 10;
+    auto writer = createWriter(LEASE_WRITE_GROUP_COMMIT);
+    writer->append(createLease(1));
+
+    for (unsigned i = 0; (i < 500) && (file_->syncs_.load() == 0); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(1, file_->syncs_.load());
+    EXPECT_EQ(1, file_->synced_.load());
+}
+
+// Checks that the lease updates are never synced with the buffered policy.
+TEST_F(LeaseFileWriterTest, buffered) {
+    auto writer = createWriter(LEASE_WRITE_BUFFERED);
+    for (uint8_t i = 1; i <= 10; ++i) {
+        writer->append(createLease(i));
+    }
+    writer->close();
+    EXPECT_EQ(10, file_->getLeases().size());
+    EXPECT_EQ(0, file_->syncs_.load());
+}
+
+// Checks that the callers wait for the writer thread when the queue is full.
+TEST_F(LeaseFileWriterTest, boundedQueue) {
+    config_.queue_size_ = 2;
+    file_->delay_ = 1;
+    auto writer = createWriter(LEASE_WRITE_BUFFERED);
+    for (uint8_t i = 1; i <= 20; ++i) {
+        writer->append(createLease(i));
+        EXPECT_GE(2, writer->getQueueSize());
+    }
+    writer->flush();
+    EXPECT_EQ(20, file_->getLeases().size());
+}
+
+// Checks that the writer thread is stopped when the file is closed and is
+// started again when the file is opened.
+TEST_F(LeaseFileWriterTest, reopen) {
+    auto writer = createWriter(LEASE_WRITE_BUFFERED);
+    writer->append(createLease(1));
+    writer->close();
+    EXPECT_EQ(1, file_->getLeases().size());
+
+    // The file is closed so the lease update fails.
+    EXPECT_THROW(writer->append(createLease(2)), BadValue);
+
+    writer->open(true);
+    writer->append(createLease(3));
+    writer->flush();
+    EXPECT_EQ(2, file_->getLeases().size());
+}
+
+// Checks that a failed write doesn't stop the writer thread.
+TEST_F(LeaseFileWriterTest, writeError) {
+    auto writer = createWriter(LEASE_WRITE_BUFFERED);
+    writer->append(createLease(1));
+    writer->append(createLease(255));
+    writer->append(createLease(2));
+    writer->flush();
+    EXPECT_EQ(2, file_->getLeases().size());
+}
+
+// Checks that the lease updates written by the writer thread to a CSV
+// lease file can be loaded.
+TEST_F(LeaseFileWriterTest, csvFile) {
+    std::ostringstream filename;
+    filename << DHCP_DATA_DIR << "/leases4_writer.csv";
+    LeaseFileIO io(filename.str());
+    io.removeFile();
+
+    boost::shared_ptr<CSVLeaseFile4> csv_file(new CSVLeaseFile4(filename.str()));
+    csv_file->open();
+    config_.policy_ = LEASE_WRITE_GROUP_COMMIT;
+    LeaseFileWriter<Lease4> writer(csv_file, config_, "test");
+    for (uint8_t i = 1; i <= 50; ++i) {
+        writer.append(createLease(i));
+    }
+    writer.close();
+    EXPECT_EQ(50, csv_file->getWriteLeases());
+
+    CSVLeaseFile4 lf(filename.str());
+    Lease4Storage storage;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(lf, storage, 0));
+    EXPECT_EQ(50, storage.size());
+    io.removeFile();
+}
+
+} // end of anonymous namespace
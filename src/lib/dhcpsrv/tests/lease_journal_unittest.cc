@@ -0,0 +1,352 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <cc/data.h>
+#include <dhcp/duid.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_file_loader.h>
+#include <dhcpsrv/lease_journal.h>
+#include <dhcpsrv/memfile_lease_storage.h>
+#include <dhcpsrv/testutils/lease_file_io.h>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::dhcp::test;
+
+namespace {
+
+// HWADDR values used by unit tests.
+const uint8_t HWADDR0[] = { 0, 1, 2, 3, 4, 5 };
+const uint8_t HWADDR1[] = { 0xd, 0xe, 0xa, 0xd, 0xb, 0xe, 0xe, 0xf };
+
+const uint8_t CLIENTID[] = { 1, 2, 3, 4 };
+
+const uint8_t DUID0[] = { 0, 1, 2, 3, 4, 5, 6, 0xa, 0xb, 0xc, 0xd, 0xe, 0xf };
+
+/// @brief Test fixture class for @c LeaseJournal4 and @c LeaseJournal6.
+class LeaseJournalTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Initializes IO for the journals used by unit tests.
+    LeaseJournalTest();
+
+    /// @brief Prepends the absolute path to the file specified
+    /// as an argument.
+    ///
+    /// @param filename Name of the file.
+    /// @return Absolute path to the test file.
+    static std::string absolutePath(const std::string& filename);
+
+    /// @brief Returns the size of a file.
+    ///
+    /// @param filename Name of the file.
+    static off_t fileSize(const std::string& filename);
+
+    /// @brief Creates sample DHCPv4 leases.
+    std::vector<Lease4Ptr> createLeases4() const;
+
+    /// @brief Creates sample DHCPv6 leases.
+    std::vector<Lease6Ptr> createLeases6() const;
+
+    /// @brief Name of the DHCPv4 test journal.
+    std::string filename4_;
+
+    /// @brief Name of the DHCPv6 test journal.
+    std::string filename6_;
+
+    /// @brief Object providing access to the DHCPv4 journal IO.
+    LeaseFileIO io4_;
+
+    /// @brief Object providing access to the DHCPv6 journal IO.
+    LeaseFileIO io6_;
+};
+
+LeaseJournalTest::LeaseJournalTest()
+    : filename4_(absolutePath("leases4.journal")), filename6_(absolutePath("leases6.journal")),
+      io4_(filename4_), io6_(filename6_) {
+}
+
+std::string
+LeaseJournalTest::absolutePath(const std::string& filename) {
+    std::ostringstream s;
+    s << DHCP_DATA_DIR << "/" << filename;
+    return (s.str());
+}
+
+off_t
+LeaseJournalTest::fileSize(const std::string& filename) {
+    std::ifstream fs(filename.c_str(), std::ios::binary | std::ios::ate);
+    return (static_cast<off_t>(fs.tellg()));
+}
+
+std::vector<Lease4Ptr>
+LeaseJournalTest::createLeases4() const {
+    std::vector<Lease4Ptr> leases;
+    HWAddrPtr hwaddr0(new HWAddr(HWADDR0, sizeof(HWADDR0), HTYPE_ETHER));
+    HWAddrPtr hwaddr1(new HWAddr(HWADDR1, sizeof(HWADDR1), HTYPE_ETHER));
+
+    Lease4Ptr lease(new Lease4(IOAddress("192.0.2.1"), hwaddr0, NULL, 0,
+                               200, 1000, 8, true, true, "host.example.com"));
+    leases.push_back(lease);
+
+    lease.reset(new Lease4(IOAddress("192.0.2.2"), hwaddr1, CLIENTID,
+                           sizeof(CLIENTID), 100, 2000, 7));
+    lease->setContext(Element::fromJSON("{ \"foobar\": true }"));
+    leases.push_back(lease);
+
+    // A declined lease has neither hardware address nor client id.
+    lease.reset(new Lease4(IOAddress("192.0.2.3"), HWAddrPtr(new HWAddr()),
+                           NULL, 0, 300, 3000, 8));
+    lease->state_ = Lease::STATE_DECLINED;
+    leases.push_back(lease);
+
+    return (leases);
+}
+
+std::vector<Lease6Ptr>
+LeaseJournalTest::createLeases6() const {
+    std::vector<Lease6Ptr> leases;
+    DuidPtr duid(new DUID(DUID0, sizeof(DUID0)));
+    HWAddrPtr hwaddr0(new HWAddr(HWADDR0, sizeof(HWADDR0), HTYPE_ETHER));
+
+    Lease6Ptr lease(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::1"),
+                               duid, 128, 100, 200, 8, true, true,
+                               "host.example.com"));
+    lease->cltt_ = 1000;
+    lease->updateCurrentExpirationTime();
+    leases.push_back(lease);
+
+    lease.reset(new Lease6(Lease::TYPE_PD, IOAddress("3000:1::"), duid, 7,
+                           150, 300, 3, false, false, "", hwaddr0, 64));
+    lease->cltt_ = 2000;
+    lease->updateCurrentExpirationTime();
+    lease->setContext(Element::fromJSON("{ \"foobar\": true }"));
+    leases.push_back(lease);
+
+    // A declined lease has an empty DUID.
+    lease.reset(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8:1::2"),
+                           DuidPtr(new DUID(DUID::EMPTY())), 0, 0, 400, 8));
+    lease->cltt_ = 3000;
+    lease->updateCurrentExpirationTime();
+    lease->state_ = Lease::STATE_DECLINED;
+    leases.push_back(lease);
+
+    return (leases);
+}
+
+// This test checks that DHCPv4 leases are appended to the journal and
+// read back.
+TEST_F(LeaseJournalTest, appendAndRead4) {
+    std::vector<Lease4Ptr> leases = createLeases4();
+
+    LeaseJournal4 journal(filename4_);
+    ASSERT_FALSE(journal.exists());
+    ASSERT_NO_THROW(journal.open());
+    EXPECT_TRUE(journal.exists());
+    for (auto lease : leases) {
+        ASSERT_NO_THROW(journal.append(*lease));
+    }
+
+    // A lease without hardware address and client id which is not
+    // declined can't be written.
+    Lease4 invalid(IOAddress("192.0.2.4"), HWAddrPtr(new HWAddr()), NULL, 0,
+                   100, 100, 7);
+    EXPECT_THROW(journal.append(invalid), BadValue);
+    EXPECT_EQ(4, journal.getWrites());
+    EXPECT_EQ(3, journal.getWriteLeases());
+    EXPECT_EQ(1, journal.getWriteErrs());
+    journal.close();
+
+    EXPECT_TRUE(LeaseJournal::isJournal(filename4_));
+
+    ASSERT_NO_THROW(journal.open());
+    Lease4Ptr lease;
+    for (auto expected : leases) {
+        ASSERT_TRUE(journal.next(lease)) << journal.getReadMsg();
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(*expected == *lease) << lease->toText();
+    }
+
+    // Reading past the end of the journal returns a null lease.
+    EXPECT_TRUE(journal.next(lease));
+    EXPECT_FALSE(lease);
+    EXPECT_EQ(4, journal.getReads());
+    EXPECT_EQ(3, journal.getReadLeases());
+    EXPECT_EQ(0, journal.getReadErrs());
+}
+
+// This test checks that DHCPv6 leases are appended to the journal and
+// read back.
+TEST_F(LeaseJournalTest, appendAndRead6) {
+    std::vector<Lease6Ptr> leases = createLeases6();
+
+    LeaseJournal6 journal(filename6_);
+    ASSERT_NO_THROW(journal.open());
+    for (auto lease : leases) {
+        ASSERT_NO_THROW(journal.append(*lease));
+    }
+
+    // A lease with an empty DUID which is not declined can't be written.
+    Lease6 invalid(Lease::TYPE_NA, IOAddress("2001:db8:1::3"),
+                   DuidPtr(new DUID(DUID::EMPTY())), 0, 0, 400, 8);
+    EXPECT_THROW(journal.append(invalid), BadValue);
+    journal.close();
+
+    ASSERT_NO_THROW(journal.open());
+    Lease6Ptr lease;
+    for (auto expected : leases) {
+        ASSERT_TRUE(journal.next(lease)) << journal.getReadMsg();
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(*expected == *lease) << lease->toText();
+    }
+    EXPECT_TRUE(journal.next(lease));
+    EXPECT_FALSE(lease);
+}
+
+// This test checks that an incomplete record at the end of the journal
+// is discarded and that the next records are appended after the last
+// complete record.
+TEST_F(LeaseJournalTest, truncatedRecord) {
+    std::vector<Lease4Ptr> leases = createLeases4();
+
+    LeaseJournal4 journal(filename4_);
+    ASSERT_NO_THROW(journal.open());
+    ASSERT_NO_THROW(journal.append(*leases[0]));
+    const off_t size = fileSize(filename4_);
+    ASSERT_NO_THROW(journal.append(*leases[1]));
+    journal.close();
+
+    // Simulate a crash while the second record was written.
+    ASSERT_EQ(0, truncate(filename4_.c_str(), fileSize(filename4_) - 3));
+
+    ASSERT_NO_THROW(journal.open());
+    Lease4Ptr lease;
+    ASSERT_TRUE(journal.next(lease));
+    ASSERT_TRUE(lease);
+    EXPECT_TRUE(*leases[0] == *lease);
+    EXPECT_TRUE(journal.next(lease));
+    EXPECT_FALSE(lease);
+    EXPECT_EQ(size, fileSize(filename4_));
+
+    // Append the lease again and read the journal.
+    ASSERT_NO_THROW(journal.append(*leases[2]));
+    journal.close();
+    ASSERT_NO_THROW(journal.open());
+    ASSERT_TRUE(journal.next(lease));
+    EXPECT_TRUE(*leases[0] == *lease);
+    ASSERT_TRUE(journal.next(lease));
+    ASSERT_TRUE(lease);
+    EXPECT_TRUE(*leases[2] == *lease);
+    EXPECT_TRUE(journal.next(lease));
+    EXPECT_FALSE(lease);
+}
+
+// This test checks that records which checksum doesn't match are
+// reported as read errors.
+TEST_F(LeaseJournalTest, checksumMismatch) {
+    std::vector<Lease4Ptr> leases = createLeases4();
+
+    LeaseJournal4 journal(filename4_);
+    ASSERT_NO_THROW(journal.open());
+    ASSERT_NO_THROW(journal.append(*leases[0]));
+    const off_t size = fileSize(filename4_);
+    ASSERT_NO_THROW(journal.append(*leases[1]));
+    journal.close();
+
+    // Corrupt the last byte of the first record.
+    {
+        std::fstream fs(filename4_.c_str(), std::ios::in | std::ios::out |
+                        std::ios::binary);
+        fs.seekp(size - 1);
+        fs.put('\xff');
+    }
+
+    ASSERT_NO_THROW(journal.open());
+    Lease4Ptr lease;
+    EXPECT_FALSE(journal.next(lease));
+    EXPECT_FALSE(lease);
+    EXPECT_EQ("record checksum mismatch", journal.getReadMsg());
+    ASSERT_TRUE(journal.next(lease));
+    ASSERT_TRUE(lease);
+    EXPECT_TRUE(*leases[1] == *lease);
+    EXPECT_EQ(1, journal.getReadErrs());
+}
+
+// This test checks that the header of the journal is verified.
+TEST_F(LeaseJournalTest, header) {
+    // A CSV lease file is not a journal.
+    io4_.writeFile("address,hwaddr,client_id,valid_lifetime,expire,subnet_id,"
+                   "fqdn_fwd,fqdn_rev,hostname,state,user_context\n");
+    EXPECT_FALSE(LeaseJournal::isJournal(filename4_));
+    LeaseJournal4 journal4(filename4_);
+    EXPECT_THROW(journal4.open(), LeaseJournalError);
+    io4_.removeFile();
+
+    // A DHCPv4 journal can't be opened as a DHCPv6 journal.
+    ASSERT_NO_THROW(journal4.open());
+    journal4.close();
+    EXPECT_EQ(static_cast<off_t>(LeaseJournal::HEADER_SIZE),
+              fileSize(filename4_));
+    LeaseJournal6 journal6(filename4_);
+    EXPECT_THROW(journal6.open(), LeaseJournalError);
+}
+
+// This test checks the selection of the lease journal from the content
+// and the name of the file.
+TEST_F(LeaseJournalTest, useJournal) {
+    EXPECT_TRUE(LeaseJournal::useJournal(filename4_));
+    EXPECT_FALSE(LeaseJournal::useJournal(absolutePath("leases4.csv")));
+
+    // Existing files are selected from their content.
+    io4_.writeFile("address,hwaddr,client_id,valid_lifetime,expire,subnet_id,"
+                   "fqdn_fwd,fqdn_rev,hostname,state,user_context\n");
+    EXPECT_FALSE(LeaseJournal::useJournal(filename4_));
+    io4_.removeFile();
+
+    LeaseJournal4 journal(filename4_ + ".2");
+    ASSERT_NO_THROW(journal.open());
+    journal.close();
+    EXPECT_TRUE(LeaseJournal::useJournal(filename4_ + ".2"));
+    static_cast<void>(remove((filename4_ + ".2").c_str()));
+}
+
+// This test checks that the leases are loaded from the journal by
+// several threads.
+TEST_F(LeaseJournalTest, loadParallel) {
+    const size_t count = 3 * LeaseFileLoader::LOAD_CHUNK_SIZE + 10;
+    {
+        LeaseJournal4 writer(filename4_);
+        ASSERT_NO_THROW(writer.open());
+        HWAddrPtr hwaddr(new HWAddr(HWADDR0, sizeof(HWADDR0), HTYPE_ETHER));
+        uint32_t addr = IOAddress("10.0.0.1").toUint32();
+        for (size_t i = 0; i < count; ++i) {
+            Lease4 lease(IOAddress(addr + i), hwaddr, NULL, 0, 200, 1000, 8);
+            ASSERT_NO_THROW(writer.append(lease));
+        }
+        // Delete the first lease.
+        Lease4 lease(IOAddress(addr), hwaddr, NULL, 0, 0, 1000, 8);
+        ASSERT_NO_THROW(writer.append(lease));
+    }
+
+    LeaseJournal4 reader(filename4_);
+    Lease4Storage storage;
+    ASSERT_NO_THROW(LeaseFileLoader::load<Lease4>(reader, storage, 0, true, 4));
+    EXPECT_EQ(count - 1, storage.size());
+    EXPECT_EQ(count + 1, reader.getReadLeases());
+    EXPECT_EQ(0, reader.getReadErrs());
+}
+
+} // end of anonymous namespace
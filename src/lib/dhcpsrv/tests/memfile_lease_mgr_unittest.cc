@@ -18,6 +18,7 @@
 #include <dhcpsrv/testutils/lease_file_io.h>
 #include <dhcpsrv/tests/test_utils.h>
 #include <dhcpsrv/tests/generic_lease_mgr_unittest.h>
+#include <stats/stats_mgr.h>
 #include <util/multi_threading_mgr.h>
 #include <util/pid_file.h>
 #include <util/range_utilities.h>
@@ -25,11 +26,14 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <queue>
 #include <sstream>
+#include <thread>
+#include <tuple>
 #include <unistd.h>
 
 using namespace std;
@@ -38,6 +42,7 @@ using namespace isc::asiolink;
 using namespace isc::db;
 using namespace isc::dhcp;
 using namespace isc::dhcp::test;
+using namespace isc::stats;
 using namespace isc::util;
 
 namespace {
@@ -456,6 +461,91 @@ TEST_F(MemfileLeaseMgrTest, persistLeases) {
     EXPECT_FALSE(lease_mgr->persistLeases(Memfile_LeaseMgr::V6));
 }
 
+/// @brief Check that the leases are stored in a lease journal when the
+/// name of the lease file ends with .journal and that the leases are also
+/// read from a CSV lease file produced by the Lease File Cleanup.
+TEST_F(MemfileLeaseMgrTest, leaseJournal4) {
+    std::string journal_file = getLeaseFilePath("leasefile4_0.journal");
+    removeFiles(journal_file);
+
+    // Create the previous lease file in the CSV format, as if the server
+    // switched to the lease journal.
+    LeaseFileIO previous_file(Memfile_LeaseMgr::appendSuffix(journal_file,
+                              Memfile_LeaseMgr::FILE_PREVIOUS));
+    previous_file.writeFile("address,hwaddr,client_id,valid_lifetime,expire,"
+                            "subnet_id,fqdn_fwd,fqdn_rev,hostname,state,"
+                            "user_context\n"
+                            "192.0.2.2,02:02:02:02:02:02,,200,4000000000,8,"
+                            "1,1,host.example.com,0,\n");
+
+    DatabaseConnection::ParameterMap pmap;
+    pmap["type"] = "memfile";
+    pmap["universe"] = "4";
+    pmap["name"] = journal_file;
+    pmap["lfc-interval"] = "0";
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr(new Memfile_LeaseMgr(pmap));
+    EXPECT_TRUE(LeaseJournal::isJournal(journal_file));
+
+    uint8_t hwaddr_data[] = { 1, 1, 1, 1, 1, 1 };
+    HWAddrPtr hwaddr(new HWAddr(hwaddr_data, sizeof(hwaddr_data), HTYPE_ETHER));
+    Lease4Ptr lease(new Lease4(IOAddress("192.0.2.1"), hwaddr, NULL, 0,
+                               200, time(NULL), 8));
+    ASSERT_TRUE(lease_mgr->addLease(lease));
+
+    // Reopen the backend and check that both leases are read.
+    lease_mgr.reset(new Memfile_LeaseMgr(pmap));
+    Lease4Ptr read_lease = lease_mgr->getLease4(IOAddress("192.0.2.1"));
+    ASSERT_TRUE(read_lease);
+    EXPECT_TRUE(*lease == *read_lease);
+    EXPECT_TRUE(lease_mgr->getLease4(IOAddress("192.0.2.2")));
+
+    // Deleted leases are not read.
+    ASSERT_TRUE(lease_mgr->deleteLease(read_lease));
+    lease_mgr.reset(new Memfile_LeaseMgr(pmap));
+    EXPECT_FALSE(lease_mgr->getLease4(IOAddress("192.0.2.1")));
+
+    lease_mgr.reset();
+    removeFiles(journal_file);
+}
+
+/// @brief Checks that the leases written by the writer thread with the
+/// group commit policy are read when the backend is reopened.
+TEST_F(MemfileLeaseMgrTest, writePolicy) {
+    std::string lease_file = getLeaseFilePath("leasefile4_0.csv");
+    DatabaseConnection::ParameterMap pmap;
+    pmap["type"] = "memfile";
+    pmap["universe"] = "4";
+    pmap["name"] = lease_file;
+    pmap["lfc-interval"] = "0";
+    pmap["write-policy"] = "group-commit";
+    pmap["write-batch-size"] = "5";
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr(new Memfile_LeaseMgr(pmap));
+
+    uint8_t hwaddr_data[] = { 1, 1, 1, 1, 1, 1 };
+    HWAddrPtr hwaddr(new HWAddr(hwaddr_data, sizeof(hwaddr_data), HTYPE_ETHER));
+    for (unsigned i = 1; i <= 20; ++i) {
+        std::ostringstream addr;
+        addr << "192.0.2." << i;
+        Lease4Ptr lease(new Lease4(IOAddress(addr.str()), hwaddr, NULL, 0,
+                                   200, time(NULL), 8));
+        ASSERT_TRUE(lease_mgr->addLease(lease));
+    }
+    EXPECT_TRUE(StatsMgr::instance().getObservation("memfile-lease4-write-queue-depth"));
+
+    // Closing the backend writes the queued leases.
+    lease_mgr.reset();
+    lease_mgr.reset(new Memfile_LeaseMgr(pmap));
+    EXPECT_EQ(20, lease_mgr->getLeases4().size());
+
+    // Invalid values are rejected.
+    lease_mgr.reset();
+    pmap["write-policy"] = "always";
+    EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), BadValue);
+    pmap["write-policy"] = "buffered";
+    pmap["write-queue-size"] = "0";
+    EXPECT_THROW(lease_mgr.reset(new Memfile_LeaseMgr(pmap)), BadValue);
+}
+
 /// @brief Check if it is possible to schedule the timer to perform the Lease
 /// File Cleanup periodically.
 TEST_F(MemfileLeaseMgrTest, lfcTimer) {
@@ -853,6 +943,242 @@ TEST_F(MemfileLeaseMgrTest, basicLease4MultiThread) {
     testBasicLease4();
 }
 
+/// @brief Checks that the leases sharing a client identifier, a HW
+/// address or a DUID and IAID are returned sorted by address whatever
+/// the order in which they were added.
+TEST_F(MemfileLeaseMgrTest, getLeasesSortedByAddress) {
+    startBackend(V4);
+
+    HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 0x11), HTYPE_ETHER));
+    ClientIdPtr clientid(new ClientId(std::vector<uint8_t>(7, 0x22)));
+    const std::vector<std::string> addresses4 = {
+        "192.0.2.3", "192.0.2.1", "192.0.2.4", "192.0.2.2"
+    };
+    for (auto const& address : addresses4) {
+        Lease4Ptr lease(new Lease4(IOAddress(address), hwaddr, clientid,
+                                   3600, time(NULL), 1));
+        ASSERT_TRUE(lmptr_->addLease(lease));
+    }
+
+    Lease4Collection by_hwaddr = lmptr_->getLease4(*hwaddr);
+    Lease4Collection by_clientid = lmptr_->getLease4(*clientid);
+    ASSERT_EQ(4, by_hwaddr.size());
+    ASSERT_EQ(4, by_clientid.size());
+    for (size_t i = 0; i < 4; ++i) {
+        std::string expected = "192.0.2." + std::to_string(i + 1);
+        EXPECT_EQ(expected, by_hwaddr[i]->addr_.toText());
+        EXPECT_EQ(expected, by_clientid[i]->addr_.toText());
+    }
+
+    // The single lease lookups return the lease with the lowest address.
+    Lease4Ptr lease = lmptr_->getLease4(*hwaddr, 1);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.1", lease->addr_.toText());
+    lease = lmptr_->getLease4(*clientid, 1);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.1", lease->addr_.toText());
+    EXPECT_FALSE(lmptr_->getLease4(*clientid, 2));
+
+    reopen(V6);
+
+    DuidPtr duid(new DUID(std::vector<uint8_t>(8, 0x33)));
+    const std::vector<std::string> addresses6 = {
+        "2001:db8::3", "2001:db8::1", "2001:db8::2"
+    };
+    for (auto const& address : addresses6) {
+        Lease6Ptr lease6(new Lease6(Lease::TYPE_NA, IOAddress(address), duid,
+                                    7, 1800, 3600, 1));
+        ASSERT_TRUE(lmptr_->addLease(lease6));
+    }
+
+    Lease6Collection leases6 = lmptr_->getLeases6(Lease::TYPE_NA, *duid, 7);
+    ASSERT_EQ(3, leases6.size());
+    EXPECT_EQ("2001:db8::1", leases6[0]->addr_.toText());
+    EXPECT_EQ("2001:db8::2", leases6[1]->addr_.toText());
+    EXPECT_EQ("2001:db8::3", leases6[2]->addr_.toText());
+}
+
+/// @brief Checks that the stored leases share equal identifiers.
+TEST_F(MemfileLeaseMgrTest, internLeaseIdentifiers) {
+    // The DHCPv4 leases share the identifiers with the stored leases.
+    Lease4Storage storage4;
+    std::vector<uint8_t> bytes(6, 0x11);
+    Lease4Ptr lease1(new Lease4(IOAddress("192.0.2.1"),
+                                HWAddrPtr(new HWAddr(bytes, HTYPE_ETHER)),
+                                ClientIdPtr(new ClientId(bytes)),
+                                3600, time(NULL), 1));
+    internLeaseIdentifiers(storage4, lease1);
+    storage4.insert(lease1);
+
+    Lease4Ptr lease2(new Lease4(IOAddress("192.0.2.2"),
+                                HWAddrPtr(new HWAddr(bytes, HTYPE_ETHER)),
+                                ClientIdPtr(new ClientId(bytes)),
+                                3600, time(NULL), 2));
+    internLeaseIdentifiers(storage4, lease2);
+    EXPECT_EQ(lease1->hwaddr_, lease2->hwaddr_);
+    EXPECT_EQ(lease1->client_id_, lease2->client_id_);
+
+    // The HW address type must match too.
+    Lease4Ptr lease3(new Lease4(IOAddress("192.0.2.3"),
+                                HWAddrPtr(new HWAddr(bytes, HTYPE_FDDI)),
+                                ClientIdPtr(), 3600, time(NULL), 3));
+    internLeaseIdentifiers(storage4, lease3);
+    EXPECT_NE(lease1->hwaddr_, lease3->hwaddr_);
+    EXPECT_FALSE(lease3->client_id_);
+
+    // The leases of the same DHCPv6 client share the DUID and HW address.
+    startBackend(V6);
+    std::vector<uint8_t> duid_bytes(8, 0x33);
+    Lease6Ptr lease6(new Lease6(Lease::TYPE_NA, IOAddress("2001:db8::1"),
+                                DuidPtr(new DUID(duid_bytes)), 7, 1800, 3600, 1,
+                                HWAddrPtr(new HWAddr(bytes, HTYPE_ETHER))));
+    ASSERT_TRUE(lmptr_->addLease(lease6));
+    lease6.reset(new Lease6(Lease::TYPE_PD, IOAddress("3000::"),
+                            DuidPtr(new DUID(duid_bytes)), 8, 1800, 3600, 1,
+                            HWAddrPtr(new HWAddr(bytes, HTYPE_ETHER)), 64));
+    ASSERT_TRUE(lmptr_->addLease(lease6));
+
+    Lease6Ptr na = lmptr_->getLease6(Lease::TYPE_NA, IOAddress("2001:db8::1"));
+    Lease6Ptr pd = lmptr_->getLease6(Lease::TYPE_PD, IOAddress("3000::"));
+    ASSERT_TRUE(na && pd);
+    EXPECT_EQ(na->duid_, pd->duid_);
+    EXPECT_EQ(na->hwaddr_, pd->hwaddr_);
+
+    // An update keeps sharing the identifiers.
+    pd->valid_lft_ = 7200;
+    ASSERT_NO_THROW(lmptr_->updateLease6(pd));
+    Lease6Ptr updated = lmptr_->getLease6(Lease::TYPE_PD, IOAddress("3000::"));
+    ASSERT_TRUE(updated);
+    EXPECT_EQ(7200, updated->valid_lft_);
+    EXPECT_EQ(na->duid_, updated->duid_);
+}
+
+/// @brief Checks that the memory used by the leases loaded from the
+/// lease file is reported in the statistics.
+TEST_F(MemfileLeaseMgrTest, memoryUsageStats) {
+    LeaseFileIO io(getLeaseFilePath("leasefile4_0.csv"));
+    io.writeFile("address,hwaddr,client_id,valid_lifetime,expire,subnet_id,"
+                 "fqdn_fwd,fqdn_rev,hostname,state,user_context\n"
+                 "192.0.2.1,01:01:01:01:01:01,,200,200,8,1,1,,1,\n"
+                 "192.0.2.2,01:01:01:01:01:01,,200,200,9,1,1,"
+                 "a-fairly-long-hostname.example.org,1,\n");
+
+    StatsMgr::instance().removeAll();
+    startBackend(V4);
+    Memfile_LeaseMgr* lease_mgr = dynamic_cast<Memfile_LeaseMgr*>(lmptr_);
+    ASSERT_TRUE(lease_mgr);
+
+    ObservationPtr memory = StatsMgr::instance().getObservation("memfile-lease4-memory");
+    ObservationPtr per_lease =
+        StatsMgr::instance().getObservation("memfile-lease4-memory-per-lease");
+    ASSERT_TRUE(memory);
+    ASSERT_TRUE(per_lease);
+    size_t usage = lease_mgr->getMemoryUsage(Memfile_LeaseMgr::V4);
+    EXPECT_EQ(usage, memory->getInteger().first);
+    EXPECT_EQ(usage / 2, per_lease->getInteger().first);
+    EXPECT_GT(per_lease->getInteger().first, sizeof(Lease4));
+
+    // Adding a lease increases the memory usage.
+    HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 0x02), HTYPE_ETHER));
+    Lease4Ptr lease(new Lease4(IOAddress("192.0.2.3"), hwaddr, ClientIdPtr(),
+                               3600, time(NULL), 8));
+    ASSERT_TRUE(lmptr_->addLease(lease));
+    EXPECT_GT(lease_mgr->getMemoryUsage(Memfile_LeaseMgr::V4), usage);
+
+    StatsMgr::instance().removeAll();
+}
+
+/// @brief Checks that leases can be retrieved by several threads while
+/// other threads add and update leases and that all changes are
+/// appended to the lease file.
+TEST_F(MemfileLeaseMgrTest, concurrentReadWrite4MultiThread) {
+    startBackend(V4);
+    MultiThreadingMgr::instance().setMode(true);
+
+    const size_t writers = 2;
+    const size_t readers = 4;
+    const size_t leases_per_writer = 100;
+
+    // Creates the lease number i.
+    auto create_lease = [](size_t i) {
+        std::vector<uint8_t> bytes = { 0x08, 0x00, 0x2b, 0x02,
+                                       static_cast<uint8_t>(i >> 8),
+                                       static_cast<uint8_t>(i) };
+        HWAddrPtr hwaddr(new HWAddr(bytes, HTYPE_ETHER));
+        ClientIdPtr clientid(new ClientId(bytes));
+        IOAddress addr(IOAddress("192.0.2.0").toUint32() + i);
+        return (Lease4Ptr(new Lease4(addr, hwaddr, clientid, 3600,
+                                     time(NULL), 1)));
+    };
+
+    std::atomic<bool> done(false);
+    std::atomic<size_t> errors(0);
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < writers; ++w) {
+        threads.push_back(std::thread([&, w]() {
+            for (size_t i = w * leases_per_writer;
+                 i < (w + 1) * leases_per_writer; ++i) {
+                Lease4Ptr lease = create_lease(i);
+                if (!lmptr_->addLease(lease)) {
+                    ++errors;
+                    continue;
+                }
+                lease->hostname_ = "host.example.org";
+                try {
+                    lmptr_->updateLease4(lease);
+                } catch (...) {
+                    ++errors;
+                }
+            }
+        }));
+    }
+    for (size_t r = 0; r < readers; ++r) {
+        threads.push_back(std::thread([&, r]() {
+            while (!done) {
+                for (size_t i = r; i < writers * leases_per_writer;
+                     i += readers) {
+                    Lease4Ptr expected = create_lease(i);
+                    Lease4Ptr by_addr = lmptr_->getLease4(expected->addr_);
+                    Lease4Collection by_hwaddr =
+                        lmptr_->getLease4(*expected->hwaddr_);
+                    Lease4Collection by_clientid =
+                        lmptr_->getLease4(*expected->client_id_);
+                    if ((by_addr && (by_addr->addr_ != expected->addr_)) ||
+                        (by_hwaddr.size() > 1) || (by_clientid.size() > 1)) {
+                        ++errors;
+                    }
+                }
+            }
+        }));
+    }
+    for (size_t w = 0; w < writers; ++w) {
+        threads[w].join();
+    }
+    done = true;
+    for (size_t r = writers; r < threads.size(); ++r) {
+        threads[r].join();
+    }
+    EXPECT_EQ(0, errors);
+
+    // Returned leases are copies which can be modified by the caller.
+    Lease4Ptr expected = create_lease(0);
+    Lease4Ptr lease = lmptr_->getLease4(*expected->client_id_,
+                                        *expected->hwaddr_, 1);
+    ASSERT_TRUE(lease);
+    lease->hostname_ = "modified.example.org";
+    lease = lmptr_->getLease4(expected->addr_);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("host.example.org", lease->hostname_);
+
+    // The lease file holds the updated version of all leases.
+    reopen(V4);
+    Lease4Collection leases = lmptr_->getLeases4();
+    ASSERT_EQ(writers * leases_per_writer, leases.size());
+    for (auto const& l : leases) {
+        EXPECT_EQ("host.example.org", l->hostname_);
+    }
+}
+
 /// @todo Write more memfile tests
 
 /// @brief Simple test about lease4 retrieval through client id method
@@ -1321,6 +1647,36 @@ TEST_F(MemfileLeaseMgrTest, DISABLED_updateLease6MultiThread) {
     testUpdateLease6();
 }
 
+/// @brief Lease4 batch update tests
+///
+/// Checks that a batch of changes of IPv4 leases is applied.
+TEST_F(MemfileLeaseMgrTest, applyLeaseChanges4) {
+    startBackend(V4);
+    testApplyLeaseChanges4();
+}
+
+/// @brief Lease4 batch update tests
+TEST_F(MemfileLeaseMgrTest, applyLeaseChanges4MultiThread) {
+    startBackend(V4);
+    MultiThreadingMgr::instance().setMode(true);
+    testApplyLeaseChanges4();
+}
+
+/// @brief Lease6 batch update tests
+///
+/// Checks that a batch of changes of IPv6 leases is applied.
+TEST_F(MemfileLeaseMgrTest, applyLeaseChanges6) {
+    startBackend(V6);
+    testApplyLeaseChanges6();
+}
+
+/// @brief Lease6 batch update tests
+TEST_F(MemfileLeaseMgrTest, applyLeaseChanges6MultiThread) {
+    startBackend(V6);
+    MultiThreadingMgr::instance().setMode(true);
+    testApplyLeaseChanges6();
+}
+
 /// @brief DHCPv4 Lease recreation tests
 ///
 /// Checks that the lease can be created, deleted and recreated with
@@ -2269,4 +2625,70 @@ TEST_F(MemfileLeaseMgrTest, leaseStatsQueryAttribution6) {
     testLeaseStatsQueryAttribution6();
 }
 
+/// @brief Checks that the lease stats queries follow the lease changes
+/// without the stored leases being recounted.
+TEST_F(MemfileLeaseMgrTest, leaseStatsQueryIncremental4) {
+    LeaseFileIO io(getLeaseFilePath("leasefile4_0.csv"));
+    io.writeFile("address,hwaddr,client_id,valid_lifetime,expire,subnet_id,"
+                 "fqdn_fwd,fqdn_rev,hostname,state,user_context\n"
+                 "192.0.2.1,01:01:01:01:01:01,,200,200,1,1,1,,0,\n"
+                 "192.0.2.2,01:01:01:01:01:02,,200,200,2,1,1,,1,\n");
+    startBackend(V4);
+
+    // Returns the rows of a query as subnet id, state and count.
+    auto get_rows = [](LeaseStatsQueryPtr query) {
+        std::vector<std::tuple<SubnetID, uint32_t, int64_t> > rows;
+        LeaseStatsRow row;
+        while (query->getNextRow(row)) {
+            rows.push_back(std::make_tuple(row.subnet_id_, row.lease_state_,
+                                           row.state_count_));
+        }
+        return (rows);
+    };
+
+    // The leases loaded from the lease file are counted.
+    auto rows = get_rows(lmptr_->startLeaseStatsQuery4());
+    ASSERT_EQ(2, rows.size());
+    EXPECT_TRUE(std::make_tuple(1, Lease::STATE_DEFAULT, 1) == rows[0]);
+    EXPECT_TRUE(std::make_tuple(2, Lease::STATE_DECLINED, 1) == rows[1]);
+
+    // Add a lease.
+    HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 0x03), HTYPE_ETHER));
+    Lease4Ptr lease(new Lease4(IOAddress("192.0.2.3"), hwaddr, ClientIdPtr(),
+                               3600, time(NULL), 1));
+    ASSERT_TRUE(lmptr_->addLease(lease));
+    rows = get_rows(lmptr_->startSubnetLeaseStatsQuery4(1));
+    ASSERT_EQ(1, rows.size());
+    EXPECT_TRUE(std::make_tuple(1, Lease::STATE_DEFAULT, 2) == rows[0]);
+
+    // Decline a lease.
+    lease = lmptr_->getLease4(IOAddress("192.0.2.1"));
+    ASSERT_TRUE(lease);
+    lease->state_ = Lease::STATE_DECLINED;
+    ASSERT_NO_THROW(lmptr_->updateLease4(lease));
+
+    // Delete a lease.
+    lease = lmptr_->getLease4(IOAddress("192.0.2.2"));
+    ASSERT_TRUE(lease);
+    ASSERT_TRUE(lmptr_->deleteLease(lease));
+
+    rows = get_rows(lmptr_->startSubnetRangeLeaseStatsQuery4(1, 2));
+    ASSERT_EQ(2, rows.size());
+    EXPECT_TRUE(std::make_tuple(1, Lease::STATE_DEFAULT, 1) == rows[0]);
+    EXPECT_TRUE(std::make_tuple(1, Lease::STATE_DECLINED, 1) == rows[1]);
+    EXPECT_TRUE(get_rows(lmptr_->startSubnetLeaseStatsQuery4(2)).empty());
+
+    // Reclaim a lease and remove it.
+    lease = lmptr_->getLease4(IOAddress("192.0.2.3"));
+    ASSERT_TRUE(lease);
+    lease->cltt_ = time(NULL) - 7200;
+    lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+    ASSERT_NO_THROW(lmptr_->updateLease4(lease));
+    EXPECT_EQ(1, lmptr_->deleteExpiredReclaimedLeases4(0));
+
+    rows = get_rows(lmptr_->startLeaseStatsQuery4());
+    ASSERT_EQ(1, rows.size());
+    EXPECT_TRUE(std::make_tuple(1, Lease::STATE_DECLINED, 1) == rows[0]);
+}
+
 }  // namespace
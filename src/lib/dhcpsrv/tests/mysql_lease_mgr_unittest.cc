@@ -805,6 +805,36 @@ TEST_F(MySqlLeaseMgrTest, concurrentUpdateLease6MultiThreading) {
     testConcurrentUpdateLease6();
 }
 
+/// @brief Lease4 batch update tests
+///
+/// Checks that a batch of changes of IPv4 leases is applied.
+TEST_F(MySqlLeaseMgrTest, applyLeaseChanges4) {
+    testApplyLeaseChanges4();
+}
+
+/// @brief Lease4 batch update tests
+///
+/// Checks that a batch of changes of IPv4 leases is applied.
+TEST_F(MySqlLeaseMgrTest, applyLeaseChanges4MultiThreading) {
+    MultiThreadingTest mt(true);
+    testApplyLeaseChanges4();
+}
+
+/// @brief Lease6 batch update tests
+///
+/// Checks that a batch of changes of IPv6 leases is applied.
+TEST_F(MySqlLeaseMgrTest, applyLeaseChanges6) {
+    testApplyLeaseChanges6();
+}
+
+/// @brief Lease6 batch update tests
+///
+/// Checks that a batch of changes of IPv6 leases is applied.
+TEST_F(MySqlLeaseMgrTest, applyLeaseChanges6MultiThreading) {
+    MultiThreadingTest mt(true);
+    testApplyLeaseChanges6();
+}
+
 /// @brief DHCPv4 Lease recreation tests
 ///
 /// Checks that the lease can be created, deleted and recreated with
@@ -179,6 +179,7 @@ TEST_F(NetworkTest, inheritanceSupport4) {
     globals_->set("cache-threshold", Element::create(.25));
     globals_->set("cache-max-age", Element::create(20));
     globals_->set("ddns-update-on-renew", Element::create(true));
+    globals_->set("allocator", Element::create("free-lease-queue"));
     globals_->set("ddns-use-conflict-resolution", Element::create(true));
 
     // For each parameter for which inheritance is supported run
@@ -340,6 +341,12 @@ TEST_F(NetworkTest, inheritanceSupport4) {
                                              &Network::setCacheMaxAge,
                                              10, 20);
     }
+    {
+        SCOPED_TRACE("allocator");
+        testNetworkInheritance<TestNetwork4>(&Network::getAllocatorType,
+                                             &Network::setAllocatorType,
+                                             "iterative", "free-lease-queue");
+    }
     {
         SCOPED_TRACE("ddns-update-on-renew");
         testNetworkInheritance<TestNetwork4>(&Network4::getDdnsUpdateOnRenew,
@@ -344,6 +344,32 @@ TEST_F(SharedNetwork4ParserTest, missingName) {
     ASSERT_THROW(network = parser.parse(config_element), DhcpConfigError);
 }
 
+// This test verifies that the allocator can be specified on shared-network
+// level and that an unknown allocator is rejected.
+TEST_F(SharedNetwork4ParserTest, allocator) {
+    IfaceMgrTestConfig ifmgr(true);
+
+    std::string config = getWorkingConfig();
+    ElementPtr config_element = Element::fromJSON(config);
+    config_element->set("allocator", Element::create("free-lease-queue"));
+
+    // Parse configuration specified above.
+    SharedNetwork4Parser parser;
+    SharedNetwork4Ptr network;
+    ASSERT_NO_THROW_LOG(network = parser.parse(config_element));
+    ASSERT_TRUE(network);
+    EXPECT_EQ("free-lease-queue", network->getAllocatorType().get());
+
+    // The subnets inherit the allocator.
+    Subnet4Ptr subnet = network->getSubnet(SubnetID(1));
+    ASSERT_TRUE(subnet);
+    EXPECT_TRUE(subnet->getAllocatorType(Network::Inheritance::NONE).unspecified());
+    EXPECT_EQ("free-lease-queue", subnet->getAllocatorType().get());
+
+    config_element->set("allocator", Element::create("hashed"));
+    EXPECT_THROW(parser.parse(config_element), DhcpConfigError);
+}
+
 // This test verifies that it's possible to specify client-class,
 // match-client-id, and authoritative on shared-network level.
 TEST_F(SharedNetwork4ParserTest, clientClassMatchClientIdAuthoritative) {
@@ -829,6 +855,32 @@ TEST_F(SharedNetwork6ParserTest, mutuallyExclusiveInterfaceId) {
     EXPECT_THROW(parser.parse(config_element), DhcpConfigError);
 }
 
+// This test verifies that the allocator can be specified on shared-network
+// level and that an unknown allocator is rejected.
+TEST_F(SharedNetwork6ParserTest, allocator) {
+    IfaceMgrTestConfig ifmgr(true);
+
+    std::string config = getWorkingConfig();
+    ElementPtr config_element = Element::fromJSON(config);
+    config_element->set("allocator", Element::create("free-lease-queue"));
+
+    // Parse configuration specified above.
+    SharedNetwork6Parser parser;
+    SharedNetwork6Ptr network;
+    ASSERT_NO_THROW_LOG(network = parser.parse(config_element));
+    ASSERT_TRUE(network);
+    EXPECT_EQ("free-lease-queue", network->getAllocatorType().get());
+
+    // The subnets inherit the allocator.
+    Subnet6Ptr subnet = network->getSubnet(SubnetID(1));
+    ASSERT_TRUE(subnet);
+    EXPECT_TRUE(subnet->getAllocatorType(Network::Inheritance::NONE).unspecified());
+    EXPECT_EQ("free-lease-queue", subnet->getAllocatorType().get());
+
+    config_element->set("allocator", Element::create("hashed"));
+    EXPECT_THROW(parser.parse(config_element), DhcpConfigError);
+}
+
 // This test verifies that it's possible to specify client-class
 // on shared-network level.
 TEST_F(SharedNetwork6ParserTest, clientClass) {
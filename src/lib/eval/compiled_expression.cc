@@ -0,0 +1,836 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <eval/compiled_expression.h>
+#include <eval/eval_log.h>
+#include <eval/evaluate.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/pkt6.h>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <typeinfo>
+
+using namespace isc::dhcp;
+using namespace std;
+
+namespace {
+
+/// @brief Value of the substring length parameter "all".
+const int64_t SUBSTRING_ALL = numeric_limits<int64_t>::max();
+
+/// @brief Textual value of true.
+const char TRUE_TEXT[] = "true";
+
+/// @brief Textual value of false.
+const char FALSE_TEXT[] = "false";
+
+} // end of anonymous namespace
+
+namespace isc {
+namespace dhcp {
+
+/// @brief The stack machine evaluating the bytecode.
+///
+/// A machine is created for each evaluation. The bytes produced by the
+/// evaluation (e.g. option values or concatenations) are appended to a
+/// scratch buffer and referenced by their offset, so they remain valid
+/// when the buffer grows.
+class CompiledExpression::Machine {
+public:
+
+    /// @brief A value on the stack.
+    struct Value {
+        /// @brief Type of the value.
+        enum Type {
+            BOOL,
+            INT,
+            BYTES
+        };
+
+        /// @brief Type of the value.
+        Type type_;
+
+        /// @brief Boolean value.
+        bool bool_;
+
+        /// @brief Integer value.
+        int64_t int_;
+
+        /// @brief Bytes which are not in the scratch buffer (constants or
+        /// packet data), null for bytes in the scratch buffer.
+        const char* data_;
+
+        /// @brief Offset of the bytes in the scratch buffer.
+        size_t offset_;
+
+        /// @brief Length of the bytes.
+        size_t length_;
+    };
+
+    /// @brief Constructor.
+    ///
+    /// @param expr the compiled expression.
+    explicit Machine(const CompiledExpression& expr) : expr_(expr) {
+        stack_.reserve(expr.max_depth_);
+    }
+
+    /// @brief Runs instructions of the bytecode.
+    ///
+    /// @param pkt the packet (null when folding constants).
+    /// @param begin index of the first instruction.
+    /// @param end index after the last instruction.
+    void run(Pkt* pkt, size_t begin, size_t end);
+
+    /// @brief Returns the value on the top of the stack.
+    const Value& top() const {
+        return (stack_.back());
+    }
+
+    /// @brief Converts a value to a boolean.
+    ///
+    /// @param value the value.
+    /// @return the boolean.
+    /// @throw EvalTypeError when the value is not a boolean.
+    bool toBool(const Value& value);
+
+    /// @brief Converts a value to a string.
+    ///
+    /// @param value the value.
+    /// @return the string.
+    string toString(const Value& value);
+
+private:
+
+    /// @brief Returns the bytes of a bytes value.
+    const char* data(const Value& value) const {
+        return (value.data_ ? value.data_ : scratch_.data() + value.offset_);
+    }
+
+    /// @brief Converts a value to bytes.
+    ///
+    /// Booleans are converted to "true" or "false", integers to their
+    /// decimal representation.
+    ///
+    /// @param value the value.
+    /// @return the bytes value.
+    Value toBytes(const Value& value);
+
+    /// @brief Converts a substring parameter to an integer.
+    ///
+    /// @param value the parameter.
+    /// @param name the name of the parameter.
+    /// @return the integer.
+    /// @throw EvalTypeError when the value is not an integer.
+    int64_t toInt(const Value& value, const char* name);
+
+    /// @brief Removes the value on the top of the stack.
+    Value pop() {
+        Value value = stack_.back();
+        stack_.pop_back();
+        return (value);
+    }
+
+    /// @brief Pushes a boolean.
+    void pushBool(bool value) {
+        Value v = { Value::BOOL, value, 0, 0, 0, 0 };
+        stack_.push_back(v);
+    }
+
+    /// @brief Pushes an integer.
+    void pushInt(int64_t value) {
+        Value v = { Value::INT, false, value, 0, 0, 0 };
+        stack_.push_back(v);
+    }
+
+    /// @brief Returns a value for bytes which are not in the scratch buffer.
+    static Value view(const char* data, size_t length) {
+        Value v = { Value::BYTES, false, 0, data, 0, length };
+        return (v);
+    }
+
+    /// @brief Pushes bytes which are not in the scratch buffer.
+    void pushView(const char* data, size_t length) {
+        stack_.push_back(view(data, length));
+    }
+
+    /// @brief Returns a value for the bytes appended to the scratch buffer
+    /// since offset.
+    Value scratch(size_t offset) const {
+        Value v = { Value::BYTES, false, 0, 0, offset,
+                    scratch_.size() - offset };
+        return (v);
+    }
+
+    /// @brief Pushes the bytes appended to the scratch buffer since offset.
+    void pushScratch(size_t offset) {
+        stack_.push_back(scratch(offset));
+    }
+
+    /// @brief Appends bytes to the scratch buffer.
+    ///
+    /// @param value a bytes value, possibly in the scratch buffer.
+    void append(const Value& value) {
+        // Reserve first as appending may reallocate the buffer the value
+        // is in.
+        scratch_.reserve(scratch_.size() + value.length_);
+        scratch_.append(data(value), value.length_);
+    }
+
+    /// @brief Appends an integer in network byte order to the scratch buffer.
+    void appendUint32(uint32_t value) {
+        scratch_.push_back(static_cast<char>((value >> 24) & 0xff));
+        scratch_.push_back(static_cast<char>((value >> 16) & 0xff));
+        scratch_.push_back(static_cast<char>((value >> 8) & 0xff));
+        scratch_.push_back(static_cast<char>(value & 0xff));
+    }
+
+    /// @brief Appends an address to the scratch buffer.
+    void appendAddress(const isc::asiolink::IOAddress& address) {
+        if (address.isV4()) {
+            appendUint32(address.toUint32());
+        } else {
+            vector<uint8_t> binary = address.toBytes();
+            scratch_.append(binary.begin(), binary.end());
+        }
+    }
+
+    /// @brief Executes the OPTION instruction.
+    void option(Pkt& pkt, const Instruction& instr);
+
+    /// @brief Executes the PKT instruction.
+    void pktField(Pkt& pkt, const Instruction& instr);
+
+    /// @brief Executes the PKT4 instruction.
+    void pkt4Field(Pkt& pkt, const Instruction& instr);
+
+    /// @brief Executes the PKT6 instruction.
+    void pkt6Field(Pkt& pkt, const Instruction& instr);
+
+    /// @brief Executes the SUBSTRING instruction.
+    void substring();
+
+    /// @brief Executes the CONCAT instruction.
+    void concat();
+
+    /// @brief Executes the TOHEXSTRING instruction.
+    void toHexString();
+
+    /// @brief The compiled expression.
+    const CompiledExpression& expr_;
+
+    /// @brief The stack.
+    vector<Value> stack_;
+
+    /// @brief The scratch buffer.
+    string scratch_;
+};
+
+void
+CompiledExpression::Machine::run(Pkt* pkt, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        const Instruction& instr = expr_.code_[i];
+        switch (instr.op_) {
+        case PUSH_BOOL:
+            pushBool(instr.arg_ != 0);
+            break;
+
+        case PUSH_INT:
+            pushInt(instr.arg_);
+            break;
+
+        case PUSH_BYTES: {
+            const string& constant = expr_.constants_[instr.arg_];
+            pushView(constant.data(), constant.size());
+            break;
+        }
+
+        case OPTION:
+            option(*pkt, instr);
+            break;
+
+        case PKT:
+            pktField(*pkt, instr);
+            break;
+
+        case PKT4:
+            pkt4Field(*pkt, instr);
+            break;
+
+        case PKT6:
+            pkt6Field(*pkt, instr);
+            break;
+
+        case MEMBER:
+            pushBool(pkt->inClass(expr_.constants_[instr.arg_]));
+            break;
+
+        case TOKEN: {
+            ValueStack values;
+            expr_.leaves_[instr.arg_]->evaluate(*pkt, values);
+            size_t offset = scratch_.size();
+            scratch_.append(values.top());
+            pushScratch(offset);
+            break;
+        }
+
+        case EQUAL: {
+            Value op1 = toBytes(pop());
+            Value op2 = toBytes(pop());
+            pushBool((op1.length_ == op2.length_) &&
+                     (memcmp(data(op1), data(op2), op1.length_) == 0));
+            break;
+        }
+
+        case NOT:
+            pushBool(!toBool(pop()));
+            break;
+
+        case AND: {
+            bool val1 = toBool(pop());
+            bool val2 = toBool(pop());
+            pushBool(val1 && val2);
+            break;
+        }
+
+        case OR: {
+            bool val1 = toBool(pop());
+            bool val2 = toBool(pop());
+            pushBool(val1 || val2);
+            break;
+        }
+
+        case SUBSTRING:
+            substring();
+            break;
+
+        case CONCAT:
+            concat();
+            break;
+
+        case IFELSE: {
+            Value iffalse = pop();
+            Value iftrue = pop();
+            bool cond = toBool(pop());
+            stack_.push_back(cond ? iftrue : iffalse);
+            break;
+        }
+
+        case TOHEXSTRING:
+            toHexString();
+            break;
+        }
+    }
+}
+
+bool
+CompiledExpression::Machine::toBool(const Value& value) {
+    if (value.type_ == Value::BOOL) {
+        return (value.bool_);
+    }
+    return (Token::toBool(toString(value)));
+}
+
+string
+CompiledExpression::Machine::toString(const Value& value) {
+    Value bytes = toBytes(value);
+    return (string(data(bytes), bytes.length_));
+}
+
+CompiledExpression::Machine::Value
+CompiledExpression::Machine::toBytes(const Value& value) {
+    switch (value.type_) {
+    case Value::BOOL:
+        if (value.bool_) {
+            return (view(TRUE_TEXT, sizeof(TRUE_TEXT) - 1));
+        }
+        return (view(FALSE_TEXT, sizeof(FALSE_TEXT) - 1));
+
+    case Value::INT: {
+        size_t offset = scratch_.size();
+        if (value.int_ == SUBSTRING_ALL) {
+            scratch_.append("all");
+        } else {
+            scratch_.append(boost::lexical_cast<string>(value.int_));
+        }
+        return (scratch(offset));
+    }
+
+    default:
+        return (value);
+    }
+}
+
+int64_t
+CompiledExpression::Machine::toInt(const Value& value, const char* name) {
+    if (value.type_ == Value::INT) {
+        return (value.int_);
+    }
+    string text = toString(value);
+    try {
+        return (boost::lexical_cast<int>(text));
+    } catch (const boost::bad_lexical_cast&) {
+        isc_throw(EvalTypeError, "the parameter '" << text
+                  << "' for the " << name << " of the substring "
+                  << "couldn't be converted to an integer.");
+    }
+}
+
+void
+CompiledExpression::Machine::option(Pkt& pkt, const Instruction& instr) {
+    OptionPtr opt = pkt.getOption(static_cast<uint16_t>(instr.arg_));
+    if (instr.type_ == TokenOption::EXISTS) {
+        pushBool(static_cast<bool>(opt));
+        return;
+    }
+    size_t offset = scratch_.size();
+    if (opt) {
+        if (instr.type_ == TokenOption::TEXTUAL) {
+            scratch_.append(opt->toString());
+        } else {
+            vector<uint8_t> binary = opt->toBinary();
+            scratch_.append(binary.begin(), binary.end());
+        }
+    }
+    pushScratch(offset);
+}
+
+void
+CompiledExpression::Machine::pktField(Pkt& pkt, const Instruction& instr) {
+    size_t offset = scratch_.size();
+    switch (instr.type_) {
+    case TokenPkt::IFACE:
+        scratch_.append(pkt.getIface());
+        break;
+    case TokenPkt::SRC:
+        appendAddress(pkt.getRemoteAddr());
+        break;
+    case TokenPkt::DST:
+        appendAddress(pkt.getLocalAddr());
+        break;
+    case TokenPkt::LEN:
+        appendUint32(static_cast<uint32_t>(pkt.len()));
+        break;
+    default:
+        isc_throw(EvalTypeError, "Bad meta data specified: " << instr.type_);
+    }
+    pushScratch(offset);
+}
+
+void
+CompiledExpression::Machine::pkt4Field(Pkt& pkt, const Instruction& instr) {
+    const Pkt4* pkt4 = dynamic_cast<const Pkt4*>(&pkt);
+    if (!pkt4) {
+        isc_throw(EvalTypeError, "Specified packet is not a Pkt4");
+    }
+    size_t offset = scratch_.size();
+    switch (instr.type_) {
+    case TokenPkt4::CHADDR: {
+        HWAddrPtr hwaddr = pkt4->getHWAddr();
+        if (!hwaddr) {
+            // This should never happen. Every Pkt4 should always have
+            // a hardware address.
+            isc_throw(EvalTypeError,
+                      "Packet does not have hardware address");
+        }
+        // The hardware address is owned by the packet.
+        if (hwaddr->hwaddr_.empty()) {
+            pushView("", 0);
+        } else {
+            pushView(reinterpret_cast<const char*>(&hwaddr->hwaddr_[0]),
+                     hwaddr->hwaddr_.size());
+        }
+        return;
+    }
+    case TokenPkt4::GIADDR:
+        appendUint32(pkt4->getGiaddr().toUint32());
+        break;
+    case TokenPkt4::CIADDR:
+        appendUint32(pkt4->getCiaddr().toUint32());
+        break;
+    case TokenPkt4::YIADDR:
+        appendUint32(pkt4->getYiaddr().toUint32());
+        break;
+    case TokenPkt4::SIADDR:
+        appendUint32(pkt4->getSiaddr().toUint32());
+        break;
+    case TokenPkt4::HLEN:
+        appendUint32(pkt4->getHlen());
+        break;
+    case TokenPkt4::HTYPE:
+        appendUint32(pkt4->getHtype());
+        break;
+    case TokenPkt4::MSGTYPE:
+        appendUint32(pkt4->getType());
+        break;
+    case TokenPkt4::TRANSID:
+        appendUint32(pkt4->getTransid());
+        break;
+    default:
+        isc_throw(EvalTypeError, "Bad field specified: " << instr.type_);
+    }
+    pushScratch(offset);
+}
+
+void
+CompiledExpression::Machine::pkt6Field(Pkt& pkt, const Instruction& instr) {
+    const Pkt6* pkt6 = dynamic_cast<const Pkt6*>(&pkt);
+    if (!pkt6) {
+        isc_throw(EvalTypeError, "Specified packet is not Pkt6");
+    }
+    size_t offset = scratch_.size();
+    switch (instr.type_) {
+    case TokenPkt6::MSGTYPE:
+        appendUint32(pkt6->getType());
+        break;
+    case TokenPkt6::TRANSID:
+        appendUint32(pkt6->getTransid());
+        break;
+    default:
+        isc_throw(EvalTypeError, "Bad field specified: " << instr.type_);
+    }
+    pushScratch(offset);
+}
+
+void
+CompiledExpression::Machine::substring() {
+    Value len = pop();
+    Value start = pop();
+    Value str = toBytes(pop());
+
+    // If we have no string to start with we push an empty string.
+    if (str.length_ == 0) {
+        stack_.push_back(str);
+        return;
+    }
+
+    const int64_t string_length = str.length_;
+    int64_t start_pos = toInt(start, "starting position");
+    int64_t length;
+    if (((len.type_ == Value::INT) && (len.int_ == SUBSTRING_ALL)) ||
+        ((len.type_ == Value::BYTES) && (toString(len) == "all"))) {
+        length = string_length;
+    } else {
+        length = toInt(len, "length");
+    }
+
+    // If the starting position is outside of the string push an
+    // empty string.
+    if ((start_pos < -string_length) || (start_pos >= string_length)) {
+        str.length_ = 0;
+        stack_.push_back(str);
+        return;
+    }
+
+    // Adjust the values as TokenSubstring does.
+    if (start_pos < 0) {
+        start_pos = string_length + start_pos;
+    }
+    if (length < 0) {
+        length = -length;
+        if (length <= start_pos) {
+            start_pos -= length;
+        } else {
+            length = start_pos;
+            start_pos = 0;
+        }
+    }
+    length = min(length, string_length - start_pos);
+
+    // The substring is a view on the string.
+    if (str.data_) {
+        str.data_ += start_pos;
+    } else {
+        str.offset_ += start_pos;
+    }
+    str.length_ = length;
+    stack_.push_back(str);
+}
+
+void
+CompiledExpression::Machine::concat() {
+    // The top of the stack was evaluated last so it is the right operand.
+    Value right = toBytes(pop());
+    Value left = toBytes(pop());
+
+    // Nothing to copy when the operands are adjacent in the scratch buffer,
+    // e.g. for nested concatenations.
+    if (!left.data_ && !right.data_ &&
+        (left.offset_ + left.length_ == right.offset_)) {
+        left.length_ += right.length_;
+        stack_.push_back(left);
+        return;
+    }
+    if (right.length_ == 0) {
+        stack_.push_back(left);
+        return;
+    }
+    if (left.length_ == 0) {
+        stack_.push_back(right);
+        return;
+    }
+    size_t offset = scratch_.size();
+    append(left);
+    append(right);
+    pushScratch(offset);
+}
+
+void
+CompiledExpression::Machine::toHexString() {
+    Value separator = toBytes(pop());
+    Value binary = toBytes(pop());
+
+    static const char digits[] = "0123456789abcdef";
+    size_t offset = scratch_.size();
+    if (binary.length_ > 0) {
+        // Reserve first as the operands may be in the scratch buffer.
+        scratch_.reserve(offset + 2 * binary.length_ +
+                         (binary.length_ - 1) * separator.length_);
+        const char* bytes = data(binary);
+        const char* sep = data(separator);
+        for (size_t i = 0; i < binary.length_; ++i) {
+            if (i > 0) {
+                scratch_.append(sep, separator.length_);
+            }
+            uint8_t byte = static_cast<uint8_t>(bytes[i]);
+            scratch_.push_back(digits[byte >> 4]);
+            scratch_.push_back(digits[byte & 0x0f]);
+        }
+    }
+    pushScratch(offset);
+}
+
+CompiledExpression::CompiledExpression(const Expression& expr)
+    : tokens_(expr), max_depth_(0), interpreted_(false) {
+    if (!compile()) {
+        code_.clear();
+        constants_.clear();
+        leaves_.clear();
+        interpreted_ = true;
+    }
+}
+
+bool
+CompiledExpression::compile() {
+    // Index of the first instruction computing each operand on the stack
+    // and whether the operand is a constant.
+    vector<size_t> starts;
+    vector<bool> constants;
+    for (auto const& token : tokens_) {
+        OpCode op;
+        size_t arity;
+        if (getOperator(token, op, arity)) {
+            if (starts.size() < arity) {
+                return (false);
+            }
+            size_t first = starts.size() - arity;
+            bool constant = true;
+            for (size_t i = first; i < starts.size(); ++i) {
+                constant = constant && constants[i];
+            }
+            // The constant substring parameters are converted once.
+            if (op == SUBSTRING) {
+                if (constants[first + 1]) {
+                    setIntegerParameter(starts[first + 1], false);
+                }
+                if (constants[first + 2]) {
+                    setIntegerParameter(starts[first + 2], true);
+                }
+            }
+            code_.push_back(Instruction(op));
+            size_t start = starts[first];
+            starts.resize(first);
+            constants.resize(first);
+            if (constant) {
+                constant = fold(start);
+            }
+            starts.push_back(start);
+            constants.push_back(constant);
+        } else {
+            bool constant = false;
+            if (!compileLeaf(token, constant)) {
+                return (false);
+            }
+            starts.push_back(code_.size() - 1);
+            constants.push_back(constant);
+            max_depth_ = max(max_depth_, starts.size());
+        }
+    }
+    return (starts.size() == 1);
+}
+
+bool
+CompiledExpression::compileLeaf(const TokenPtr& token, bool& constant) {
+    Token* raw = token.get();
+    constant = false;
+
+    // Constants.
+    if (TokenString* str = dynamic_cast<TokenString*>(raw)) {
+        code_.push_back(Instruction(PUSH_BYTES, addConstant(str->getValue())));
+        constant = true;
+        return (true);
+    }
+    if (TokenHexString* hex = dynamic_cast<TokenHexString*>(raw)) {
+        code_.push_back(Instruction(PUSH_BYTES, addConstant(hex->getValue())));
+        constant = true;
+        return (true);
+    }
+    if (TokenIpAddress* addr = dynamic_cast<TokenIpAddress*>(raw)) {
+        code_.push_back(Instruction(PUSH_BYTES, addConstant(addr->getValue())));
+        constant = true;
+        return (true);
+    }
+
+    // The derived option tokens look for the option elsewhere.
+    if (typeid(*raw) == typeid(TokenOption)) {
+        TokenOption* opt = static_cast<TokenOption*>(raw);
+        code_.push_back(Instruction(OPTION, opt->getCode(),
+                                    opt->getRepresentation()));
+        return (true);
+    }
+    if (TokenPkt* pkt = dynamic_cast<TokenPkt*>(raw)) {
+        code_.push_back(Instruction(PKT, 0, pkt->getType()));
+        return (true);
+    }
+    if (TokenPkt4* pkt4 = dynamic_cast<TokenPkt4*>(raw)) {
+        code_.push_back(Instruction(PKT4, 0, pkt4->getType()));
+        return (true);
+    }
+    if (TokenPkt6* pkt6 = dynamic_cast<TokenPkt6*>(raw)) {
+        code_.push_back(Instruction(PKT6, 0, pkt6->getType()));
+        return (true);
+    }
+    if (TokenMember* member = dynamic_cast<TokenMember*>(raw)) {
+        code_.push_back(Instruction(MEMBER,
+                                    addConstant(member->getClientClass())));
+        return (true);
+    }
+
+    // Other tokens pushing a value without popping any.
+    if (dynamic_cast<TokenOption*>(raw) || dynamic_cast<TokenRelay6Field*>(raw)) {
+        code_.push_back(Instruction(TOKEN, leaves_.size()));
+        leaves_.push_back(token);
+        return (true);
+    }
+
+    return (false);
+}
+
+bool
+CompiledExpression::getOperator(const TokenPtr& token, OpCode& op,
+                                size_t& arity) {
+    Token* raw = token.get();
+    if (dynamic_cast<TokenEqual*>(raw)) {
+        op = EQUAL;
+        arity = 2;
+    } else if (dynamic_cast<TokenNot*>(raw)) {
+        op = NOT;
+        arity = 1;
+    } else if (dynamic_cast<TokenAnd*>(raw)) {
+        op = AND;
+        arity = 2;
+    } else if (dynamic_cast<TokenOr*>(raw)) {
+        op = OR;
+        arity = 2;
+    } else if (dynamic_cast<TokenSubstring*>(raw)) {
+        op = SUBSTRING;
+        arity = 3;
+    } else if (dynamic_cast<TokenConcat*>(raw)) {
+        op = CONCAT;
+        arity = 2;
+    } else if (dynamic_cast<TokenIfElse*>(raw)) {
+        op = IFELSE;
+        arity = 3;
+    } else if (dynamic_cast<TokenToHexString*>(raw)) {
+        op = TOHEXSTRING;
+        arity = 2;
+    } else {
+        return (false);
+    }
+    return (true);
+}
+
+bool
+CompiledExpression::fold(size_t start) {
+    Instruction folded(PUSH_BOOL);
+    try {
+        Machine machine(*this);
+        machine.run(0, start, code_.size());
+        const Machine::Value value = machine.top();
+        switch (value.type_) {
+        case Machine::Value::BOOL:
+            folded = Instruction(PUSH_BOOL, value.bool_ ? 1 : 0);
+            break;
+        case Machine::Value::INT:
+            folded = Instruction(PUSH_INT, value.int_);
+            break;
+        default:
+            folded = Instruction(PUSH_BYTES,
+                                 addConstant(machine.toString(value)));
+        }
+    } catch (const std::exception&) {
+        // Keep the instructions so the error is raised at evaluation time.
+        return (false);
+    }
+    code_.erase(code_.begin() + start, code_.end());
+    code_.push_back(folded);
+    return (true);
+}
+
+void
+CompiledExpression::setIntegerParameter(size_t index, bool length) {
+    Instruction& instr = code_[index];
+    if (instr.op_ != PUSH_BYTES) {
+        return;
+    }
+    const string& value = constants_[instr.arg_];
+    if (length && (value == "all")) {
+        instr = Instruction(PUSH_INT, SUBSTRING_ALL);
+        return;
+    }
+    try {
+        instr = Instruction(PUSH_INT, boost::lexical_cast<int>(value));
+    } catch (const boost::bad_lexical_cast&) {
+        // Keep the string so the error is raised at evaluation time.
+    }
+}
+
+size_t
+CompiledExpression::addConstant(const string& value) {
+    auto it = find(constants_.begin(), constants_.end(), value);
+    if (it != constants_.end()) {
+        return (it - constants_.begin());
+    }
+    constants_.push_back(value);
+    return (constants_.size() - 1);
+}
+
+bool
+CompiledExpression::evaluateBool(Pkt& pkt) const {
+    // Walk the tokens when they log what they push and pop.
+    if (interpreted_ || eval_logger.isDebugEnabled(EVAL_DBG_STACK)) {
+        return (isc::dhcp::evaluateBool(tokens_, pkt));
+    }
+    Machine machine(*this);
+    machine.run(&pkt, 0, code_.size());
+    return (machine.toBool(machine.top()));
+}
+
+string
+CompiledExpression::evaluateString(Pkt& pkt) const {
+    if (interpreted_ || eval_logger.isDebugEnabled(EVAL_DBG_STACK)) {
+        return (isc::dhcp::evaluateString(tokens_, pkt));
+    }
+    Machine machine(*this);
+    machine.run(&pkt, 0, code_.size());
+    return (machine.toString(machine.top()));
+}
+
+}; // end of isc::dhcp namespace
+}; // end of isc namespace
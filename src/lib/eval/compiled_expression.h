@@ -0,0 +1,194 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef COMPILED_EXPRESSION_H
+#define COMPILED_EXPRESSION_H
+
+#include <eval/token.h>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Expression compiled to a flat bytecode.
+///
+/// Evaluating an @c Expression walks its tokens, each of them popping and
+/// pushing strings on a @c ValueStack: every boolean, integer and
+/// option value becomes a heap allocated string. A compiled expression
+/// is evaluated by a small stack machine instead:
+/// - the stack slots are typed (boolean, integer or bytes),
+/// - bytes are views on the constants of the expression, on the packet
+///   or on a scratch buffer shared by the whole evaluation, so there is
+///   no allocation per token,
+/// - the sub-expressions which do not depend on the packet are folded
+///   to constants when the expression is compiled, i.e. when the
+///   configuration is parsed.
+///
+/// The values produced by a compiled expression are the same as the
+/// values produced by the evaluation of its tokens. The tokens which
+/// have no bytecode counterpart (e.g. relay or vendor options) are
+/// evaluated by their @c Token::evaluate method. An expression which
+/// can not be compiled (e.g. because it would not leave exactly one
+/// value on the stack) and all expressions when the debug logging of
+/// the evaluation is enabled are evaluated by walking their tokens so
+/// the errors and the log messages remain the same.
+class CompiledExpression {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Compiles the expression.
+    ///
+    /// @param expr the expression.
+    explicit CompiledExpression(const Expression& expr);
+
+    /// @brief Evaluates the expression as a boolean.
+    ///
+    /// @param pkt the packet.
+    /// @return the value of the expression.
+    /// @throw EvalBadStack or EvalTypeError as @ref evaluateBool does.
+    bool evaluateBool(Pkt& pkt) const;
+
+    /// @brief Evaluates the expression as a string.
+    ///
+    /// @param pkt the packet.
+    /// @return the value of the expression.
+    /// @throw EvalBadStack or EvalTypeError as @ref evaluateString does.
+    std::string evaluateString(Pkt& pkt) const;
+
+    /// @brief Returns the number of instructions of the bytecode.
+    ///
+    /// Used in tests to check constant folding.
+    size_t getInstructionCount() const {
+        return (code_.size());
+    }
+
+    /// @brief Checks if the expression is evaluated by walking its tokens.
+    ///
+    /// Used in tests.
+    bool isInterpreted() const {
+        return (interpreted_);
+    }
+
+private:
+
+    /// @brief Operation codes.
+    enum OpCode {
+        PUSH_BOOL,    ///< push the boolean argument
+        PUSH_INT,     ///< push the integer argument
+        PUSH_BYTES,   ///< push the constant at index argument
+        OPTION,       ///< push an option of the packet
+        PKT,          ///< push a packet metadata
+        PKT4,         ///< push a DHCPv4 packet field
+        PKT6,         ///< push a DHCPv6 packet field
+        MEMBER,       ///< push the membership to the class at index argument
+        TOKEN,        ///< push the value of the token at index argument
+        EQUAL,        ///< ==
+        NOT,          ///< not
+        AND,          ///< and
+        OR,           ///< or
+        SUBSTRING,    ///< substring(string, start, length)
+        CONCAT,       ///< concat(left, right)
+        IFELSE,       ///< ifelse(condition, iftrue, iffalse)
+        TOHEXSTRING   ///< hexstring(binary, separator)
+    };
+
+    /// @brief A bytecode instruction.
+    struct Instruction {
+        /// @brief Constructor.
+        ///
+        /// @param op operation code.
+        /// @param arg argument.
+        /// @param type type of an option representation or packet field.
+        Instruction(OpCode op, int64_t arg = 0, int type = 0)
+            : op_(op), arg_(arg), type_(type) {
+        }
+
+        /// @brief Operation code.
+        OpCode op_;
+
+        /// @brief Argument, e.g. the value of the integer or the code of
+        /// the option.
+        int64_t arg_;
+
+        /// @brief Type of the option representation or of the packet field.
+        int type_;
+    };
+
+    /// @brief The stack machine evaluating the bytecode.
+    class Machine;
+
+    /// @brief Compiles the expression.
+    ///
+    /// @return false if the expression can't be compiled.
+    bool compile();
+
+    /// @brief Compiles a constant or a packet token.
+    ///
+    /// @param token the token.
+    /// @param[out] constant true if the token is a constant.
+    /// @return false if it's not a constant nor a packet token.
+    bool compileLeaf(const TokenPtr& token, bool& constant);
+
+    /// @brief Folds the instructions computing a constant.
+    ///
+    /// The instructions from start to the end of the bytecode are
+    /// replaced by an instruction pushing their value.
+    ///
+    /// @param start index of the first instruction to fold.
+    /// @return false if the evaluation of the instructions failed so
+    /// they are kept to raise the error at evaluation time.
+    bool fold(size_t start);
+
+    /// @brief Replaces a constant substring parameter by an integer.
+    ///
+    /// @param index index of the instruction pushing the parameter.
+    /// @param length true for the length parameter which can be "all".
+    void setIntegerParameter(size_t index, bool length);
+
+    /// @brief Returns the operation code and arity of an operator token.
+    ///
+    /// @param token the token.
+    /// @param[out] op the operation code.
+    /// @param[out] arity the number of operands.
+    /// @return false if it's not an operator token.
+    static bool getOperator(const TokenPtr& token, OpCode& op, size_t& arity);
+
+    /// @brief Interns a constant.
+    ///
+    /// @param value the constant.
+    /// @return the index of the constant.
+    size_t addConstant(const std::string& value);
+
+    /// @brief Tokens of the expression.
+    Expression tokens_;
+
+    /// @brief The bytecode.
+    std::vector<Instruction> code_;
+
+    /// @brief The constants: bytes and client class names.
+    std::vector<std::string> constants_;
+
+    /// @brief The tokens evaluated by the @c TOKEN instruction.
+    std::vector<TokenPtr> leaves_;
+
+    /// @brief Maximum depth of the stack.
+    size_t max_depth_;
+
+    /// @brief The expression is evaluated by walking its tokens.
+    bool interpreted_;
+};
+
+/// @brief Pointer to a compiled expression.
+typedef boost::shared_ptr<CompiledExpression> CompiledExpressionPtr;
+
+}; // end of isc::dhcp namespace
+}; // end of isc namespace
+
+#endif
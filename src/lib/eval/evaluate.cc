@@ -37,6 +37,16 @@ evaluateString(const Expression& expr, Pkt& pkt) {
     return (values.top());
 }
 
+bool
+evaluateBool(const CompiledExpression& expr, Pkt& pkt) {
+    return (expr.evaluateBool(pkt));
+}
+
+std::string
+evaluateString(const CompiledExpression& expr, Pkt& pkt) {
+    return (expr.evaluateString(pkt));
+}
+
 
 }; // end of isc::dhcp namespace
 }; // end of isc namespace
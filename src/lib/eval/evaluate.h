@@ -7,6 +7,7 @@
 #ifndef EVALUATE_H
 #define EVALUATE_H
 
+#include <eval/compiled_expression.h>
 #include <eval/token.h>
 #include <string>
 
@@ -28,6 +29,24 @@ bool evaluateBool(const Expression& expr, Pkt& pkt);
 
 std::string evaluateString(const Expression& expr, Pkt& pkt);
 
+/// @brief Evaluate a compiled expression for a v4 or v6 packet and return
+///        a true or false decision
+///
+/// @param expr the compiled expression
+/// @param pkt  The v4 or v6 packet
+/// @return the boolean decision
+/// @throw EvalStackError or EvalTypeError as the evaluation of the RPN
+///        expression
+bool evaluateBool(const CompiledExpression& expr, Pkt& pkt);
+
+/// @brief Evaluate a compiled expression for a v4 or v6 packet and return
+///        a string
+///
+/// @param expr the compiled expression
+/// @param pkt  The v4 or v6 packet
+/// @return the string value
+std::string evaluateString(const CompiledExpression& expr, Pkt& pkt);
+
 }; // end of isc::dhcp namespace
 }; // end of isc namespace
 
@@ -0,0 +1,248 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <eval/compiled_expression.h>
+#include <eval/evaluate.h>
+#include <eval/eval_context.h>
+#include <eval/token.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/pkt6.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/dhcp6.h>
+#include <dhcp/option_string.h>
+
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture for testing compiled expressions.
+class CompiledExpressionTest : public ::testing::Test {
+public:
+
+    /// @brief Initializes the packets.
+    CompiledExpressionTest() {
+        pkt4_.reset(new Pkt4(DHCPDISCOVER, 12345));
+        pkt4_->addOption(OptionPtr(new OptionString(Option::V4, 100,
+                                                    "hundred4")));
+        pkt4_->setIface("eth0");
+        pkt4_->setRemoteAddr(IOAddress("192.0.2.1"));
+        pkt4_->setGiaddr(IOAddress("192.0.2.254"));
+        vector<uint8_t> hw = { 1, 2, 3, 4, 5, 6 };
+        pkt4_->setHWAddr(HTYPE_ETHER, hw.size(), hw);
+        pkt4_->addClass("foo");
+
+        // Add a relay agent information option with a sub-option.
+        OptionPtr rai(new Option(Option::V4, DHO_DHCP_AGENT_OPTIONS));
+        rai->addOption(OptionPtr(new OptionString(Option::V4, 1, "circuit")));
+        pkt4_->addOption(rai);
+
+        pkt6_.reset(new Pkt6(DHCPV6_SOLICIT, 12345));
+        pkt6_->addOption(OptionPtr(new OptionString(Option::V6, 100,
+                                                    "hundred6")));
+        pkt6_->setRemoteAddr(IOAddress("2001:db8::1"));
+    }
+
+    /// @brief Parses and compiles an expression.
+    ///
+    /// @param u universe (V4 or V6)
+    /// @param expr expression to be parsed
+    /// @param type type of the expression
+    /// @return the compiled expression
+    CompiledExpressionPtr
+    compile(Option::Universe u, const string& expr,
+            EvalContext::ParserType type = EvalContext::PARSER_BOOL) {
+        EvalContext eval(u);
+        EXPECT_NO_THROW(eval.parseString(expr, type))
+            << " while parsing expression " << expr;
+        expression_ = eval.expression;
+        CompiledExpressionPtr compiled(new CompiledExpression(expression_));
+        EXPECT_FALSE(compiled->isInterpreted()) << " for expression " << expr;
+        return (compiled);
+    }
+
+    /// @brief Checks that an expression evaluates to the same boolean
+    /// as its tokens.
+    ///
+    /// @param u universe (V4 or V6)
+    /// @param expr expression to be parsed
+    /// @param exp_result expected result
+    void testBool(Option::Universe u, const string& expr, bool exp_result) {
+        CompiledExpressionPtr compiled = compile(u, expr);
+        Pkt& pkt = (u == Option::V4 ? static_cast<Pkt&>(*pkt4_) : *pkt6_);
+        bool result = !exp_result;
+        ASSERT_NO_THROW(result = compiled->evaluateBool(pkt))
+            << " for expression " << expr;
+        EXPECT_EQ(exp_result, result) << " for expression " << expr;
+        EXPECT_EQ(evaluateBool(expression_, pkt), result)
+            << " for expression " << expr;
+    }
+
+    /// @brief Checks that an expression evaluates to the same string
+    /// as its tokens.
+    ///
+    /// @param u universe (V4 or V6)
+    /// @param expr expression to be parsed
+    /// @param exp_result expected result
+    void testString(Option::Universe u, const string& expr,
+                    const string& exp_result) {
+        CompiledExpressionPtr compiled = compile(u, expr,
+                                                 EvalContext::PARSER_STRING);
+        Pkt& pkt = (u == Option::V4 ? static_cast<Pkt&>(*pkt4_) : *pkt6_);
+        string result;
+        ASSERT_NO_THROW(result = compiled->evaluateString(pkt))
+            << " for expression " << expr;
+        EXPECT_EQ(exp_result, result) << " for expression " << expr;
+        EXPECT_EQ(evaluateString(expression_, pkt), result)
+            << " for expression " << expr;
+    }
+
+    Expression expression_; ///< The last parsed expression
+    Pkt4Ptr pkt4_; ///< A stub DHCPv4 packet
+    Pkt6Ptr pkt6_; ///< A stub DHCPv6 packet
+};
+
+// Checks that the sub-expressions which do not depend on the packet are
+// folded to constants.
+TEST_F(CompiledExpressionTest, folding) {
+    CompiledExpressionPtr compiled = compile(Option::V4, "'foo' == 'foo'");
+    EXPECT_EQ(1, compiled->getInstructionCount());
+    EXPECT_TRUE(compiled->evaluateBool(*pkt4_));
+
+    compiled = compile(Option::V4, "substring('foobar', 0, 3) == "
+                       "concat('fo', 'o') and not ('a' == 'b')");
+    EXPECT_EQ(1, compiled->getInstructionCount());
+    EXPECT_TRUE(compiled->evaluateBool(*pkt4_));
+
+    // The option is not a constant but the concatenation is.
+    compiled = compile(Option::V4, "option[100].hex == concat('hun', 'dred4')");
+    EXPECT_EQ(3, compiled->getInstructionCount());
+    EXPECT_TRUE(compiled->evaluateBool(*pkt4_));
+
+    compiled = compile(Option::V4, "hexstring(0x0102, ':')",
+                       EvalContext::PARSER_STRING);
+    EXPECT_EQ(1, compiled->getInstructionCount());
+    EXPECT_EQ("01:02", compiled->evaluateString(*pkt4_));
+}
+
+// Checks the boolean expressions.
+TEST_F(CompiledExpressionTest, evaluateBool) {
+    testBool(Option::V4, "option[100].exists", true);
+    testBool(Option::V4, "option[101].exists", false);
+    testBool(Option::V4, "option[100].text == 'hundred4'", true);
+    testBool(Option::V4, "option[100].hex == 'hundred4'", true);
+    testBool(Option::V4, "option[101].hex == ''", true);
+    testBool(Option::V4, "not option[100].exists or option[101].exists", false);
+    testBool(Option::V4, "option[100].exists and not option[101].exists", true);
+    testBool(Option::V4, "member('foo')", true);
+    testBool(Option::V4, "member('bar')", false);
+    testBool(Option::V4, "pkt4.msgtype == 1", true);
+    testBool(Option::V4, "pkt4.transid == 12345", true);
+    testBool(Option::V4, "pkt4.mac == 0x010203040506", true);
+    testBool(Option::V4, "pkt4.hlen == 6", true);
+    testBool(Option::V4, "pkt4.htype == 1", true);
+    testBool(Option::V4, "pkt4.giaddr == 192.0.2.254", true);
+    testBool(Option::V4, "pkt4.ciaddr == 0.0.0.0", true);
+    testBool(Option::V4, "pkt.iface == 'eth0'", true);
+    testBool(Option::V4, "pkt.src == 192.0.2.1", true);
+    testBool(Option::V4, "relay4[1].hex == 'circuit'", true);
+    testBool(Option::V4, "relay4[2].exists", false);
+    testBool(Option::V4, "substring(option[100].hex, 0, 3) == 'hun'", true);
+    testBool(Option::V4, "substring(option[100].hex, -2, all) == 'd4'", true);
+    testBool(Option::V4, "substring(option[100].hex, -1, -2) == 'ed'", true);
+    testBool(Option::V4, "substring(option[100].hex, 10, 2) == ''", true);
+    testBool(Option::V4, "substring(option[101].hex, 0, 2) == ''", true);
+    testBool(Option::V4, "concat(substring(option[100].hex, 0, 3), "
+             "substring(option[100].hex, 3, all)) == 'hundred4'", true);
+    testBool(Option::V4, "ifelse(option[100].exists, 'a', 'b') == 'a'", true);
+    testBool(Option::V4, "hexstring(pkt4.mac, ':') == '01:02:03:04:05:06'",
+             true);
+
+    testBool(Option::V6, "option[100].hex == 'hundred6'", true);
+    testBool(Option::V6, "pkt6.msgtype == 1", true);
+    testBool(Option::V6, "pkt6.transid == 12345", true);
+    testBool(Option::V6, "pkt.src == 2001:db8::1", true);
+    testBool(Option::V6, "relay6[0].option[100].exists", false);
+    testBool(Option::V6, "vendor[4491].exists", false);
+}
+
+// Checks the string expressions.
+TEST_F(CompiledExpressionTest, evaluateString) {
+    testString(Option::V4, "option[100].hex", "hundred4");
+    testString(Option::V4, "option[101].hex", "");
+    testString(Option::V4, "concat(option[100].hex, concat('-', "
+               "option[100].hex))", "hundred4-hundred4");
+    testString(Option::V4, "concat(concat(option[100].hex, '-'), "
+               "option[100].hex)", "hundred4-hundred4");
+    testString(Option::V4, "ifelse(member('bar'), 'a', option[100].hex)",
+               "hundred4");
+    testString(Option::V4, "hexstring(substring(option[100].hex, 0, 2), '')",
+               "6875");
+    testString(Option::V6, "concat(option[100].hex, pkt6.msgtype)",
+               string("hundred6\0\0\0\1", 12));
+}
+
+// Checks that the errors are the same as with the tokens.
+TEST_F(CompiledExpressionTest, errors) {
+    // The value is not a boolean.
+    Expression expr;
+    expr.push_back(TokenPtr(new TokenString("bad")));
+    CompiledExpression bad(expr);
+    EXPECT_FALSE(bad.isInterpreted());
+    EXPECT_THROW(bad.evaluateBool(*pkt4_), EvalTypeError);
+    EXPECT_EQ("bad", bad.evaluateString(*pkt4_));
+
+    // The substring parameters are not integers.
+    expr.clear();
+    expr.push_back(TokenPtr(new TokenString("foobar")));
+    expr.push_back(TokenPtr(new TokenString("zero")));
+    expr.push_back(TokenPtr(new TokenString("all")));
+    expr.push_back(TokenPtr(new TokenSubstring()));
+    CompiledExpression substring(expr);
+    EXPECT_FALSE(substring.isInterpreted());
+    EXPECT_THROW(substring.evaluateString(*pkt4_), EvalTypeError);
+
+    // A DHCPv4 field in a DHCPv6 packet.
+    CompiledExpressionPtr compiled = compile(Option::V4, "pkt4.msgtype == 1");
+    EXPECT_THROW(compiled->evaluateBool(*pkt6_), EvalTypeError);
+
+    // Bad stacks are detected by the tokens.
+    expr.clear();
+    CompiledExpression empty(expr);
+    EXPECT_TRUE(empty.isInterpreted());
+    EXPECT_THROW(empty.evaluateBool(*pkt4_), EvalBadStack);
+
+    expr.push_back(TokenPtr(new TokenString("foo")));
+    expr.push_back(TokenPtr(new TokenEqual()));
+    CompiledExpression equal(expr);
+    EXPECT_TRUE(equal.isInterpreted());
+    EXPECT_THROW(equal.evaluateBool(*pkt4_), EvalBadStack);
+
+    expr.clear();
+    expr.push_back(TokenPtr(new TokenString("true")));
+    expr.push_back(TokenPtr(new TokenString("true")));
+    CompiledExpression two(expr);
+    EXPECT_TRUE(two.isInterpreted());
+    EXPECT_THROW(two.evaluateBool(*pkt4_), EvalBadStack);
+}
+
+// Checks the evaluation through the evaluate functions.
+TEST_F(CompiledExpressionTest, evaluate) {
+    CompiledExpressionPtr compiled = compile(Option::V4,
+                                             "option[100].exists");
+    EXPECT_TRUE(evaluateBool(*compiled, *pkt4_));
+
+    compiled = compile(Option::V4, "option[100].hex",
+                       EvalContext::PARSER_STRING);
+    EXPECT_EQ("hundred4", evaluateString(*compiled, *pkt4_));
+}
+
+};
@@ -325,6 +325,21 @@ public:
         }
 
         EXPECT_EQ(exp_result, result) << " for expression " << expr;
+
+        // The compiled expression must give the same result.
+        CompiledExpression compiled(eval.expression);
+        result = !exp_result;
+        switch (u) {
+        case Option::V4:
+            ASSERT_NO_THROW(result = evaluateBool(compiled, *pkt4_))
+                << " for compiled expression " << expr;
+            break;
+        case Option::V6:
+            ASSERT_NO_THROW(result = evaluateBool(compiled, *pkt6_))
+                << " for compiled expression " << expr;
+            break;
+        }
+        EXPECT_EQ(exp_result, result) << " for compiled expression " << expr;
     }
 
     /// @brief Checks if expression can be parsed and evaluated to string
@@ -358,6 +373,21 @@ public:
         }
 
         EXPECT_EQ(exp_result, result) << " for expression " << expr;
+
+        // The compiled expression must give the same result.
+        CompiledExpression compiled(eval.expression);
+        result.clear();
+        switch (u) {
+        case Option::V4:
+            ASSERT_NO_THROW(result = evaluateString(compiled, *pkt4_))
+                << " for compiled expression " << expr;
+            break;
+        case Option::V6:
+            ASSERT_NO_THROW(result = evaluateString(compiled, *pkt6_))
+                << " for compiled expression " << expr;
+            break;
+        }
+        EXPECT_EQ(exp_result, result) << " for compiled expression " << expr;
     }
 
     /// @brief Checks that specified expression throws expected exception.
@@ -126,6 +126,13 @@ public:
     /// @param values (represented string will be pushed here)
     void evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns the constant value
+    ///
+    /// @return the constant string
+    const std::string& getValue() const {
+        return (value_);
+    }
+
 protected:
     std::string value_; ///< Constant value
 };
@@ -151,6 +158,13 @@ public:
     /// @param values (represented string will be pushed here)
     void evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns the constant value
+    ///
+    /// @return the decoded string
+    const std::string& getValue() const {
+        return (value_);
+    }
+
 protected:
     std::string value_; ///< Constant value
 };
@@ -202,6 +216,13 @@ public:
     /// @param values (represented IP address will be pushed here)
     void evaluate(Pkt& pkt, ValueStack& values);
 
+    /// @brief Returns the constant value
+    ///
+    /// @return the binary address
+    const std::string& getValue() const {
+        return (value_);
+    }
+
 protected:
     ///< Constant value (empty string if the IP address cannot be converted)
     std::string value_;
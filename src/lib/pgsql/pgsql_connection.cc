@@ -394,5 +394,148 @@ PgSqlConnection::rollback() {
     }
 }
 
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace {
+
+/// @brief Statements delimiting the transaction of a pipelined batch.
+PgSqlTaggedStatement pipeline_statements[] = {
+    { 0, { OID_NONE }, "pipeline_start_transaction", "START TRANSACTION" },
+    { 0, { OID_NONE }, "pipeline_commit", "COMMIT" }
+};
+
+}
+
+PgSqlPipeline::PgSqlPipeline(PgSqlConnection& conn)
+    : conn_(conn), statements_(), finished_(false) {
+    conn_.checkUnusable();
+    if (PQenterPipelineMode(conn_) != 1) {
+        const char* error_message = PQerrorMessage(conn_);
+        isc_throw(DbOperationError, "unable to enter pipeline mode: "
+                  << error_message);
+    }
+    DB_LOG_DEBUG(DB_DBG_TRACE_DETAIL, PGSQL_START_TRANSACTION);
+    try {
+        sendControl(pipeline_statements[0]);
+    } catch (...) {
+        PQexitPipelineMode(conn_);
+        throw;
+    }
+}
+
+PgSqlPipeline::~PgSqlPipeline() {
+    if (finished_) {
+        return;
+    }
+
+    // The statements are discarded by the server after a failure so
+    // there is no point in sending the commit.
+    PQpipelineSync(conn_);
+    std::vector<PgSqlResultPtr> results;
+    size_t failed;
+    finish(results, failed);
+
+    DB_LOG_DEBUG(DB_DBG_TRACE_DETAIL, PGSQL_ROLLBACK);
+    PgSqlResult r(PQexec(conn_, "ROLLBACK"));
+}
+
+void
+PgSqlPipeline::send(PgSqlTaggedStatement& statement, const char* const* values,
+                    const int* lengths, const int* formats) {
+    if (PQsendQueryPrepared(conn_, statement.name, statement.nbparams,
+                            values, lengths, formats, 0) != 1) {
+        const char* error_message = PQerrorMessage(conn_);
+        isc_throw(DbOperationError, "unable to send statement: "
+                  << statement.name << ", reason: " << error_message);
+    }
+    statements_.push_back(&statement);
+}
+
+void
+PgSqlPipeline::sendControl(PgSqlTaggedStatement& statement) {
+    if (PQsendQueryParams(conn_, statement.text, 0, 0, 0, 0, 0, 0) != 1) {
+        const char* error_message = PQerrorMessage(conn_);
+        isc_throw(DbOperationError, "unable to send statement: "
+                  << statement.name << ", reason: " << error_message);
+    }
+    statements_.push_back(&statement);
+}
+
+void
+PgSqlPipeline::commit(std::vector<PgSqlResultPtr>& results) {
+    DB_LOG_DEBUG(DB_DBG_TRACE_DETAIL, PGSQL_COMMIT);
+    sendControl(pipeline_statements[1]);
+    if (PQpipelineSync(conn_) != 1) {
+        const char* error_message = PQerrorMessage(conn_);
+        isc_throw(DbOperationError, "unable to flush pipeline: "
+                  << error_message);
+    }
+
+    std::vector<PgSqlResultPtr> all_results;
+    size_t failed;
+    finish(all_results, failed);
+
+    if (failed < statements_.size()) {
+        try {
+            conn_.checkStatementError(*all_results[failed],
+                                      *statements_[failed]);
+        } catch (...) {
+            // The failure has left the transaction in the aborted state.
+            DB_LOG_DEBUG(DB_DBG_TRACE_DETAIL, PGSQL_ROLLBACK);
+            PgSqlResult r(PQexec(conn_, "ROLLBACK"));
+            throw;
+        }
+    }
+
+    // Strip the results of the transaction control statements.
+    results.assign(all_results.begin() + 1, all_results.end() - 1);
+}
+
+void
+PgSqlPipeline::finish(std::vector<PgSqlResultPtr>& results, size_t& failed) {
+    finished_ = true;
+    failed = statements_.size();
+    results.clear();
+
+    bool lost = false;
+    for (size_t i = 0; i < statements_.size(); ++i) {
+        PgSqlResultPtr r(new PgSqlResult(lost ? 0 : PQgetResult(conn_)));
+        if (*r) {
+            // The results of each statement are terminated by a null
+            // pointer.
+            for (PGresult* extra = PQgetResult(conn_); extra;
+                 extra = PQgetResult(conn_)) {
+                PQclear(extra);
+            }
+        } else {
+            // A null result without a terminated statement means that
+            // the connection is lost.
+            lost = true;
+        }
+
+        int s = PQresultStatus(*r);
+        if ((failed == statements_.size()) &&
+            (s != PGRES_COMMAND_OK) && (s != PGRES_TUPLES_OK)) {
+            failed = i;
+        }
+        results.push_back(r);
+    }
+
+    // Consume the synchronization point.
+    if (!lost) {
+        for (PGresult* res = PQgetResult(conn_); res; res = PQgetResult(conn_)) {
+            int s = PQresultStatus(res);
+            PQclear(res);
+            if (s == PGRES_PIPELINE_SYNC) {
+                break;
+            }
+        }
+    }
+
+    PQexitPipelineMode(conn_);
+}
+
+#endif // LIBPQ_HAS_PIPELINING
+
 }; // end of isc::db namespace
 }; // end of isc namespace
@@ -9,7 +9,9 @@
 #include <database/database_connection.h>
 
 #include <libpq-fe.h>
+#include <boost/noncopyable.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <vector>
 #include <stdint.h>
@@ -436,6 +438,96 @@ public:
 
 };
 
+#ifdef LIBPQ_HAS_PIPELINING
+
+/// @brief Pointer to a result set.
+typedef boost::shared_ptr<PgSqlResult> PgSqlResultPtr;
+
+/// @brief RAII object executing a batch of statements in pipeline mode.
+///
+/// The statements queued with @ref PgSqlPipeline::send are sent to the
+/// server without waiting for the results of the previous statements, so
+/// the whole batch costs a single round trip to the server instead of one
+/// per statement. The batch is executed within a transaction which is
+/// committed by @ref PgSqlPipeline::commit. If the instance is destroyed
+/// before the commit, the pending results are discarded and the
+/// transaction is rolled back.
+///
+/// @note Pipeline mode requires libpq 14 or later.
+class PgSqlPipeline : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Switches the connection to pipeline mode and queues the
+    /// "START TRANSACTION" statement.
+    ///
+    /// @param conn PostgreSQL connection to use for the batch.
+    ///
+    /// @throw DbOperationError if the connection can't enter pipeline mode.
+    PgSqlPipeline(PgSqlConnection& conn);
+
+    /// @brief Destructor.
+    ///
+    /// If the batch has not been committed, the results are discarded,
+    /// the connection leaves pipeline mode and the transaction is
+    /// rolled back.
+    ~PgSqlPipeline();
+
+    /// @brief Queues a prepared statement.
+    ///
+    /// The parameter values are copied by libpq, so they are not required
+    /// to outlive this call.
+    ///
+    /// @param statement Tagged statement to be executed.
+    /// @param values Parameter values.
+    /// @param lengths Parameter lengths.
+    /// @param formats Parameter formats.
+    ///
+    /// @throw DbOperationError if the statement can't be sent.
+    void send(PgSqlTaggedStatement& statement, const char* const* values,
+              const int* lengths, const int* formats);
+
+    /// @brief Commits the batch and collects the results.
+    ///
+    /// Queues the "COMMIT" statement, flushes the pipeline and waits for
+    /// the results of all statements. The connection leaves pipeline mode.
+    ///
+    /// @param [out] results Results of the statements queued with
+    /// @ref PgSqlPipeline::send in the order they were queued.
+    ///
+    /// @throw DbOperationError if any statement has failed. In this case
+    /// the transaction is rolled back. Errors considered fatal by
+    /// @ref PgSqlConnection::checkStatementError are thrown as such.
+    void commit(std::vector<PgSqlResultPtr>& results);
+
+private:
+
+    /// @brief Queues a statement without parameters.
+    ///
+    /// @param statement Tagged statement to be executed.
+    void sendControl(PgSqlTaggedStatement& statement);
+
+    /// @brief Waits for the results and leaves pipeline mode.
+    ///
+    /// @param [out] results Results of all statements in the order they
+    /// were queued.
+    /// @param [out] failed Index of the first failed statement or the number
+    /// of statements if none has failed.
+    void finish(std::vector<PgSqlResultPtr>& results, size_t& failed);
+
+    /// @brief Holds reference to the PostgreSQL database connection.
+    PgSqlConnection& conn_;
+
+    /// @brief Statements queued so far.
+    std::vector<PgSqlTaggedStatement*> statements_;
+
+    /// @brief Boolean flag indicating if the results have been collected.
+    bool finished_;
+};
+
+#endif // LIBPQ_HAS_PIPELINING
+
 }; // end of isc::db namespace
 }; // end of isc namespace
 
@@ -920,4 +920,73 @@ TEST_F(PgSqlBasicsTest, timeStampTest) {
                                                       MAX_DB_TIME), BadValue);
 }
 
+#ifdef LIBPQ_HAS_PIPELINING
+/// @brief Verify that a batch of statements can be executed in pipeline mode
+TEST_F(PgSqlBasicsTest, pipelineTest) {
+    // Create a prepared statement for inserting id and int_col
+    const char* st_name = "id_int_insert";
+    PgSqlTaggedStatement statement[] = {
+     {2, { OID_INT4, OID_INT4 }, st_name,
+      "INSERT INTO BASICS (id, int_col) values ($1, $2)" }
+    };
+
+    ASSERT_NO_THROW(conn_->prepareStatement(statement[0]));
+
+    // Insert three rows in a single batch.
+    std::vector<PgSqlResultPtr> results;
+    {
+        PgSqlPipeline pipeline(*conn_);
+        for (int i = 1; i <= 3; ++i) {
+            PsqlBindArray bind_array;
+            bind_array.add(i);
+            bind_array.add(i * 10);
+            ASSERT_NO_THROW(pipeline.send(statement[0],
+                                          &bind_array.values_[0],
+                                          &bind_array.lengths_[0],
+                                          &bind_array.formats_[0]));
+        }
+        ASSERT_NO_THROW(pipeline.commit(results));
+    }
+
+    // There is one result per statement.
+    ASSERT_EQ(3, results.size());
+    for (auto const& result : results) {
+        EXPECT_EQ(PGRES_COMMAND_OK, PQresultStatus(*result));
+        EXPECT_EQ(std::string("1"), PQcmdTuples(*result));
+    }
+
+    PgSqlResultPtr r;
+    FETCH_ROWS(r, 3);
+
+    // A failing statement rolls back the whole batch.
+    {
+        PgSqlPipeline pipeline(*conn_);
+        for (int i = 4; i >= 3; --i) {
+            PsqlBindArray bind_array;
+            bind_array.add(i);
+            bind_array.add(i * 10);
+            ASSERT_NO_THROW(pipeline.send(statement[0],
+                                          &bind_array.values_[0],
+                                          &bind_array.lengths_[0],
+                                          &bind_array.formats_[0]));
+        }
+        EXPECT_THROW(pipeline.commit(results), DbOperationError);
+    }
+    FETCH_ROWS(r, 3);
+
+    // A batch which is not committed is rolled back.
+    {
+        PgSqlPipeline pipeline(*conn_);
+        PsqlBindArray bind_array;
+        bind_array.add(5);
+        bind_array.add(50);
+        ASSERT_NO_THROW(pipeline.send(statement[0],
+                                      &bind_array.values_[0],
+                                      &bind_array.lengths_[0],
+                                      &bind_array.formats_[0]));
+    }
+    FETCH_ROWS(r, 3);
+}
+#endif
+
 }; // namespace
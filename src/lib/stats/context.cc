@@ -77,6 +77,14 @@ StatContext::getAll() const {
     return (map);
 }
 
+void
+StatContext::getAllBinary(isc::util::OutputBuffer& buf) const {
+    buf.writeUint32(stats_.size());
+    for (auto const& s : stats_) {
+        s.second->getBinary(buf);
+    }
+}
+
 void
 StatContext::setMaxSampleCountAll(uint32_t max_samples) {
     // Let's iterate over all stored statistics...
@@ -75,6 +75,15 @@ public:
     /// @return map with all observations
     isc::data::ConstElementPtr getAll() const;
 
+    /// @brief Appends the compact binary form of all observations to a buffer
+    ///
+    /// The number of observations (32 bits in network byte order) is
+    /// followed by the binary form of each observation, see
+    /// @ref Observation::getBinary.
+    ///
+    /// @param buf buffer the binary form is appended to
+    void getAllBinary(isc::util::OutputBuffer& buf) const;
+
 private:
 
     /// @brief Statistics container
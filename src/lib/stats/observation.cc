@@ -10,11 +10,68 @@
 #include <util/chrono_time_utils.h>
 #include <cc/data.h>
 #include <chrono>
+#include <cstring>
+#include <limits>
 #include <utility>
 
 using namespace std;
 using namespace std::chrono;
 using namespace isc::data;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Writes a timestamp as microseconds since the epoch.
+void
+writeTimestamp(OutputBuffer& buf,
+               const isc::stats::SampleClock::time_point& timestamp) {
+    auto since_epoch = timestamp.time_since_epoch();
+    buf.writeUint64(duration_cast<microseconds>(since_epoch).count());
+}
+
+/// @brief Writes an integer value.
+void
+writeValue(OutputBuffer& buf, const int64_t value) {
+    buf.writeUint64(static_cast<uint64_t>(value));
+}
+
+/// @brief Writes a floating point value as its IEEE 754 representation.
+void
+writeValue(OutputBuffer& buf, const double value) {
+    static_assert(sizeof(double) == sizeof(uint64_t),
+                  "double is not 64 bits");
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    buf.writeUint64(bits);
+}
+
+/// @brief Writes a duration value as microseconds.
+void
+writeValue(OutputBuffer& buf, const isc::stats::StatsDuration& value) {
+    buf.writeUint64(duration_cast<microseconds>(value).count());
+}
+
+/// @brief Writes a string value preceded by its length.
+void
+writeValue(OutputBuffer& buf, const string& value) {
+    buf.writeUint32(value.size());
+    if (!value.empty()) {
+        buf.writeData(value.data(), value.size());
+    }
+}
+
+/// @brief Writes the number of samples followed by the samples.
+template<typename StorageType>
+void
+writeSamples(OutputBuffer& buf, const StorageType& storage) {
+    buf.writeUint32(storage.size());
+    for (size_t i = 0; i < storage.size(); ++i) {
+        writeTimestamp(buf, storage[i].second);
+        writeValue(buf, storage[i].first);
+    }
+}
+
+} // end of anonymous namespace
 
 namespace isc {
 namespace stats {
@@ -30,6 +87,7 @@ Observation::Observation(const std::string& name, const int64_t value) :
     name_(name), type_(STAT_INTEGER),
     max_sample_count_(default_max_sample_count_),
     max_sample_age_(default_max_sample_age_) {
+    setStorageCapacity();
     setValue(value);
 }
 
@@ -37,6 +95,7 @@ Observation::Observation(const std::string& name, const double value) :
     name_(name), type_(STAT_FLOAT),
     max_sample_count_(default_max_sample_count_),
     max_sample_age_(default_max_sample_age_) {
+    setStorageCapacity();
     setValue(value);
 }
 
@@ -44,6 +103,7 @@ Observation::Observation(const std::string& name, const StatsDuration& value) :
     name_(name), type_(STAT_DURATION),
     max_sample_count_(default_max_sample_count_),
     max_sample_age_(default_max_sample_age_) {
+    setStorageCapacity();
     setValue(value);
 }
 
@@ -51,10 +111,12 @@ Observation::Observation(const std::string& name, const std::string& value) :
     name_(name), type_(STAT_STRING),
     max_sample_count_(default_max_sample_count_),
     max_sample_age_(default_max_sample_age_) {
+    setStorageCapacity();
     setValue(value);
 }
 
 void Observation::setMaxSampleAge(const StatsDuration& duration) {
+    collectCounter();
     switch(type_) {
     case STAT_INTEGER: {
         setMaxSampleAgeInternal(integer_samples_, duration, STAT_INTEGER);
@@ -79,6 +141,7 @@ void Observation::setMaxSampleAge(const StatsDuration& duration) {
 }
 
 void Observation::setMaxSampleCount(uint32_t max_samples) {
+    collectCounter();
     switch(type_) {
     case STAT_INTEGER: {
         setMaxSampleCountInternal(integer_samples_, max_samples, STAT_INTEGER);
@@ -102,6 +165,43 @@ void Observation::setMaxSampleCount(uint32_t max_samples) {
     };
 }
 
+void Observation::setStorageCapacity() {
+    size_t capacity = SampleRing<IntegerSample>::UNLIMITED;
+    if (max_sample_count_.first) {
+        capacity = max(max_sample_count_.second, static_cast<uint32_t>(1));
+    }
+    integer_samples_.setCapacity(capacity);
+    float_samples_.setCapacity(capacity);
+    duration_samples_.setCapacity(capacity);
+    string_samples_.setCapacity(capacity);
+}
+
+void Observation::setCounter(const StatCounterPtr& counter) {
+    if (counter && (type_ != STAT_INTEGER)) {
+        isc_throw(InvalidStatType, "Unable to attach a counter to "
+                  << typeToText(type_) << " statistic " << name_);
+    }
+    counter_ = counter;
+}
+
+void Observation::collectCounter() const {
+    if (!counter_) {
+        return;
+    }
+    int64_t value = counter_->collect();
+    if (value == 0) {
+        return;
+    }
+    int64_t current = 0;
+    if (!integer_samples_.empty()) {
+        current = integer_samples_.front().first;
+    }
+    // Observations are never created const.
+    Observation* self = const_cast<Observation*>(this);
+    self->setValueInternal(current + value, self->integer_samples_,
+                           STAT_INTEGER);
+}
+
 void Observation::addValue(const int64_t value) {
     IntegerSample current = getInteger();
     setValue(current.first + value);
@@ -123,6 +223,7 @@ void Observation::addValue(const std::string& value) {
 }
 
 void Observation::setValue(const int64_t value) {
+    collectCounter();
     setValueInternal(value, integer_samples_, STAT_INTEGER);
 }
 
@@ -139,6 +240,7 @@ void Observation::setValue(const std::string& value) {
 }
 
 size_t Observation::getSize() const {
+    collectCounter();
     size_t size = 0;
     switch(type_) {
     case STAT_INTEGER: {
@@ -193,33 +295,25 @@ void Observation::setValueInternal(SampleType value, StorageType& storage,
                   << typeToText(type_));
     }
 
-    if (storage.empty()) {
-        storage.push_back(make_pair(value, SampleClock::now()));
-    } else {
-        // Storing of more than one sample
-        storage.push_front(make_pair(value, SampleClock::now()));
-
-        if (max_sample_count_.first) {
-            // if max_sample_count_ is set to true
-            // and size of storage is equal to max_sample_count_
-            if (storage.size() > max_sample_count_.second) {
-                storage.pop_back(); // removing the last element
-            }
-        } else {
-            StatsDuration range_of_storage =
+    // When the count limit is active the capacity of the storage is the
+    // limit so the oldest sample is overwritten when it is reached.
+    storage.push_front(make_pair(value, SampleClock::now()));
+
+    if (!max_sample_count_.first) {
+        StatsDuration range_of_storage =
+            storage.front().second - storage.back().second;
+        // removing samples until the range_of_storage
+        // stops exceeding the duration limit
+        while (range_of_storage > max_sample_age_.second) {
+            storage.pop_back();
+            range_of_storage =
                 storage.front().second - storage.back().second;
-            // removing samples until the range_of_storage
-            // stops exceeding the duration limit
-            while (range_of_storage > max_sample_age_.second) {
-                storage.pop_back();
-                range_of_storage =
-                    storage.front().second - storage.back().second;
-            }
         }
     }
 }
 
 IntegerSample Observation::getInteger() const {
+    collectCounter();
     return (getValueInternal<IntegerSample>(integer_samples_, STAT_INTEGER));
 }
 
@@ -249,10 +343,11 @@ SampleType Observation::getValueInternal(Storage& storage, Type exp_type) const
         // still be there.
         isc_throw(Unexpected, "Observation storage container empty");
     }
-    return (*storage.begin());
+    return (storage.front());
 }
 
 std::list<IntegerSample> Observation::getIntegers() const {
+    collectCounter();
     return (getValuesInternal<IntegerSample>(integer_samples_, STAT_INTEGER));
 }
 
@@ -283,7 +378,7 @@ std::list<SampleType> Observation::getValuesInternal(Storage& storage,
         // still be there.
         isc_throw(Unexpected, "Observation storage container empty");
     }
-    return (storage);
+    return (storage.toList());
 }
 
 template<typename StorageType>
@@ -300,6 +395,11 @@ void Observation::setMaxSampleAgeInternal(StorageType& storage,
     max_sample_age_.second = duration;
     // deactivating the max_sample_count_ limit
     max_sample_count_.first = false;
+    setStorageCapacity();
+
+    if (storage.empty()) {
+        return;
+    }
 
     StatsDuration range_of_storage =
         storage.front().second - storage.back().second;
@@ -331,6 +431,7 @@ void Observation::setMaxSampleCountInternal(StorageType& storage,
         // deleting elements which are exceeding the max_samples limit
         storage.pop_back();
     }
+    setStorageCapacity();
 }
 
 void Observation::setMaxSampleAgeDefault(const StatsDuration& duration) {
@@ -474,7 +575,37 @@ Observation::getJSON() const {
     return (list);
 }
 
+void
+Observation::getBinary(OutputBuffer& buf) const {
+    if (name_.size() > numeric_limits<uint16_t>::max()) {
+        isc_throw(BadValue, "Statistic name is too long: " << name_.size());
+    }
+    buf.writeUint16(name_.size());
+    buf.writeData(name_.data(), name_.size());
+    buf.writeUint8(static_cast<uint8_t>(type_));
+
+    switch (type_) {
+    case STAT_INTEGER:
+        collectCounter();
+        writeSamples(buf, integer_samples_);
+        break;
+    case STAT_FLOAT:
+        writeSamples(buf, float_samples_);
+        break;
+    case STAT_DURATION:
+        writeSamples(buf, duration_samples_);
+        break;
+    case STAT_STRING:
+        writeSamples(buf, string_samples_);
+        break;
+    default:
+        isc_throw(InvalidStatType, "Unknown statistic type: "
+                  << typeToText(type_));
+    };
+}
+
 void Observation::reset() {
+    collectCounter();
     switch(type_) {
     case STAT_INTEGER: {
         integer_samples_.clear();
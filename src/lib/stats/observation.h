@@ -9,6 +9,9 @@
 
 #include <cc/data.h>
 #include <exceptions/exceptions.h>
+#include <stats/sample_ring.h>
+#include <stats/stat_counter.h>
+#include <util/buffer.h>
 #include <boost/shared_ptr.hpp>
 #include <chrono>
 #include <list>
@@ -81,6 +84,9 @@ typedef std::pair<std::string, SampleClock::time_point> StringSample;
 /// @ref getJSON, which is generic and can be used for all types.
 ///
 /// Since Kea 1.6 multiple samples are stored for the same observation.
+/// The samples are held in a ring buffer which is bounded by the count
+/// limit, so recording a sample does not allocate memory once the buffer
+/// is full.
 class Observation {
 public:
 
@@ -297,6 +303,23 @@ public:
     /// @return JSON structures representing all observations
     isc::data::ConstElementPtr getJSON() const;
 
+    /// @brief Appends the compact binary form of the observation to a buffer
+    ///
+    /// The binary form is much smaller and faster to build than the JSON
+    /// one. All fields are in network byte order:
+    /// - name length (16 bits) followed by the name,
+    /// - type (8 bits, see @ref Type),
+    /// - number of samples (32 bits),
+    /// - the samples from the most recent one, each made of the timestamp
+    ///   in microseconds since the epoch (64 bits) followed by the value:
+    ///   a 64 bits signed integer, an IEEE 754 double, a duration in
+    ///   microseconds (64 bits) or a string length (32 bits) followed by
+    ///   the string.
+    ///
+    /// @param buf buffer the binary form is appended to
+    /// @throw BadValue if the name is too long
+    void getBinary(isc::util::OutputBuffer& buf) const;
+
     /// @brief Converts statistic type to string
     /// @return textual name of statistic type
     static std::string typeToText(Type type);
@@ -306,14 +329,35 @@ public:
         return (name_);
     }
 
+    /// @brief Attaches a counter to an integer statistic.
+    ///
+    /// The pending value of the counter is added to the statistic before
+    /// the statistic is read or modified.
+    ///
+    /// @param counter counter of the statistic (null to detach it)
+    /// @throw InvalidStatType if statistic is not integer
+    void setCounter(const StatCounterPtr& counter);
+
 private:
 
+    /// @brief Sets the capacity of the sample storages from the limits.
+    ///
+    /// The capacity is the count limit (at least one sample) when the
+    /// count limit is active, and it is unlimited otherwise.
+    void setStorageCapacity();
+
+    /// @brief Adds the pending value of the attached counter.
+    ///
+    /// The method is const because it is called by the getters: the
+    /// pending value is logically part of the statistic.
+    void collectCounter() const;
+
     /// @brief Returns size of observed storage
     ///
     /// This method returns size of observed storage.
     /// It is used by public methods to return size of
     /// available storages.
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. SampleRing<IntegerSample>)
     /// @param storage storage which size will be returned
     /// @param exp_type expected observation type (used for sanity checking)
     /// @return size of storage
@@ -327,7 +371,7 @@ private:
     /// available storages.
     ///
     /// @tparam SampleType type of sample (e.g. IntegerSample)
-    /// @tparam StorageType type of storage (e.g. list<IntegerSample>)
+    /// @tparam StorageType type of storage (e.g. SampleRing<IntegerSample>)
     /// @param value observation to be recorded
     /// @param storage observation will be stored here
     /// @param exp_type expected observation type (used for sanity checking)
@@ -339,7 +383,7 @@ private:
     /// @brief Returns a sample (internal version)
     ///
     /// @tparam SampleType type of sample (e.g. IntegerSample)
-    /// @tparam StorageType type of storage (e.g. list<IntegerSample>)
+    /// @tparam StorageType type of storage (e.g. SampleRing<IntegerSample>)
     /// @param observation storage
     /// @param exp_type expected observation type (used for sanity checking)
     /// @throw InvalidStatType if observation type mismatches
@@ -350,7 +394,7 @@ private:
     /// @brief Returns samples (internal version)
     ///
     /// @tparam SampleType type of samples (e.g. IntegerSample)
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. SampleRing<IntegerSample>)
     /// @param observation storage
     /// @param exp_type expected observation type (used for sanity checking)
     /// @throw InvalidStatType if observation type mismatches
@@ -361,7 +405,7 @@ private:
 
     /// @brief Determines maximum age of samples.
     ///
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. SampleRing<IntegerSample>)
     /// @param storage storage on which limit will be set
     /// @param duration determines maximum age of samples
     /// @param exp_type expected observation type (used for sanity checking)
@@ -371,7 +415,7 @@ private:
 
     /// @brief Determines how many samples of a given statistic should be kept.
     ///
-    /// @tparam Storage type of storage (e.g. list<IntegerSample>)
+    /// @tparam Storage type of storage (e.g. SampleRing<IntegerSample>)
     /// @param storage storage on which limit will be set
     /// @param max_samples determines maximum number of samples
     /// @param exp_type expected observation type (used for sanity checking)
@@ -423,16 +467,19 @@ private:
     /// @{
 
     /// @brief Storage for integer samples
-    std::list<IntegerSample> integer_samples_;
+    SampleRing<IntegerSample> integer_samples_;
 
     /// @brief Storage for floating point samples
-    std::list<FloatSample> float_samples_;
+    SampleRing<FloatSample> float_samples_;
 
     /// @brief Storage for time duration samples
-    std::list<DurationSample> duration_samples_;
+    SampleRing<DurationSample> duration_samples_;
 
     /// @brief Storage for string samples
-    std::list<StringSample> string_samples_;
+    SampleRing<StringSample> string_samples_;
+
+    /// @brief Counter attached to an integer statistic
+    StatCounterPtr counter_;
     /// @}
 };
 
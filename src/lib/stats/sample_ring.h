@@ -0,0 +1,180 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <algorithm>
+#include <limits>
+#include <list>
+#include <vector>
+#include <stddef.h>
+
+namespace isc {
+namespace stats {
+
+/// @brief Ring buffer holding the samples of an observation.
+///
+/// The samples are ordered from the most recent (front) to the oldest
+/// (back). The buffer grows geometrically until it reaches its capacity;
+/// from then on adding a sample overwrites the oldest one, so no memory
+/// is allocated per recorded sample. Removed samples keep their slot for
+/// reuse.
+///
+/// @tparam SampleType Type of the samples.
+template<typename SampleType>
+class SampleRing {
+public:
+
+    /// @brief Value of the capacity meaning the number of samples is not
+    /// limited, e.g. when the samples are limited by age.
+    static const size_t UNLIMITED = std::numeric_limits<size_t>::max();
+
+    /// @brief Constructor.
+    ///
+    /// @param capacity Maximum number of held samples.
+    explicit SampleRing(size_t capacity = UNLIMITED)
+        : capacity_(capacity), head_(0), size_(0) {
+    }
+
+    /// @brief Returns the number of held samples.
+    size_t size() const {
+        return (size_);
+    }
+
+    /// @brief Checks if no sample is held.
+    bool empty() const {
+        return (size_ == 0);
+    }
+
+    /// @brief Returns the maximum number of held samples.
+    size_t getCapacity() const {
+        return (capacity_);
+    }
+
+    /// @brief Sets the maximum number of held samples.
+    ///
+    /// The oldest samples exceeding the new capacity are removed and the
+    /// buffer is shrunk when it is larger than the new capacity.
+    ///
+    /// @param capacity Maximum number of held samples.
+    void setCapacity(size_t capacity) {
+        capacity_ = capacity;
+        if (size_ > capacity_) {
+            size_ = capacity_;
+        }
+        if (buffer_.size() > capacity_) {
+            reallocate(capacity_);
+        }
+    }
+
+    /// @brief Returns the most recent sample.
+    ///
+    /// The ring must not be empty.
+    const SampleType& front() const {
+        return (buffer_[head_]);
+    }
+
+    /// @brief Returns the oldest sample.
+    ///
+    /// The ring must not be empty.
+    const SampleType& back() const {
+        return ((*this)[size_ - 1]);
+    }
+
+    /// @brief Returns a sample by its position.
+    ///
+    /// @param index Position of the sample, 0 being the most recent.
+    const SampleType& operator[](size_t index) const {
+        return (buffer_[(head_ + index) % buffer_.size()]);
+    }
+
+    /// @brief Adds a sample as the most recent one.
+    ///
+    /// When the ring is full the oldest sample is overwritten.
+    ///
+    /// @param sample The sample.
+    void push_front(const SampleType& sample) {
+        if (size_ == buffer_.size()) {
+            if (size_ < capacity_) {
+                reallocate(std::min(std::max(size_ * 2, static_cast<size_t>(1)),
+                                    capacity_));
+            } else if (size_ == 0) {
+                // Zero capacity.
+                return;
+            } else {
+                --size_;
+            }
+        }
+        head_ = (head_ + buffer_.size() - 1) % buffer_.size();
+        buffer_[head_] = sample;
+        ++size_;
+    }
+
+    /// @brief Removes the oldest sample.
+    ///
+    /// The ring must not be empty.
+    void pop_back() {
+        --size_;
+    }
+
+    /// @brief Removes all samples.
+    ///
+    /// The buffer is kept for reuse.
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    /// @brief Returns the samples as a list from the most recent one.
+    std::list<SampleType> toList() const {
+        std::list<SampleType> samples;
+        for (size_t i = 0; i < size_; ++i) {
+            samples.push_back((*this)[i]);
+        }
+        return (samples);
+    }
+
+private:
+
+    /// @brief Moves the samples into a new buffer.
+    ///
+    /// The samples are stored from the beginning of the new buffer so the
+    /// free slots are at its end.
+    ///
+    /// @param size Size of the new buffer, not less than the number of
+    /// held samples.
+    void reallocate(size_t size) {
+        std::vector<SampleType> buffer;
+        buffer.reserve(size);
+        for (size_t i = 0; i < size_; ++i) {
+            buffer.push_back((*this)[i]);
+        }
+        buffer.resize(size);
+        buffer_.swap(buffer);
+        head_ = 0;
+    }
+
+    /// @brief Maximum number of held samples.
+    size_t capacity_;
+
+    /// @brief The buffer.
+    std::vector<SampleType> buffer_;
+
+    /// @brief Position of the most recent sample in the buffer.
+    size_t head_;
+
+    /// @brief Number of held samples.
+    size_t size_;
+};
+
+template<typename SampleType>
+const size_t SampleRing<SampleType>::UNLIMITED;
+
+}  // namespace stats
+}  // namespace isc
+
+#endif // SAMPLE_RING_H
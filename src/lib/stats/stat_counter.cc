@@ -0,0 +1,41 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/stat_counter.h>
+#include <functional>
+#include <thread>
+
+using namespace std;
+
+namespace isc {
+namespace stats {
+
+const size_t StatCounter::SHARDS;
+
+StatCounter::StatCounter(const string& name) : name_(name) {
+    for (size_t i = 0; i < SHARDS; ++i) {
+        shards_[i].value_.store(0, memory_order_relaxed);
+    }
+}
+
+int64_t
+StatCounter::collect() {
+    int64_t value = 0;
+    for (size_t i = 0; i < SHARDS; ++i) {
+        value += shards_[i].value_.exchange(0, memory_order_relaxed);
+    }
+    return (value);
+}
+
+size_t
+StatCounter::getShard() {
+    return (hash<thread::id>()(this_thread::get_id()) % SHARDS);
+}
+
+}  // namespace stats
+}  // namespace isc
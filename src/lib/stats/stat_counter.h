@@ -0,0 +1,96 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef STAT_COUNTER_H
+#define STAT_COUNTER_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <string>
+#include <stdint.h>
+
+namespace isc {
+namespace stats {
+
+/// @brief Handle of an integer statistic incremented on a hot path.
+///
+/// Updating a statistic through the @ref StatsMgr takes its mutex, looks
+/// the statistic up by name and records a new timestamped sample. That is
+/// too expensive for statistics updated for each processed packet by many
+/// threads, e.g. pkt4-received.
+///
+/// A counter is obtained once from @ref StatsMgr::getCounter and then
+/// incremented without taking any lock nor allocating memory: the value
+/// is added to one of several atomic shards selected by the calling
+/// thread, so the threads do not fight for the same cache line. The
+/// pending value of the counter is collected into the observation of the
+/// statistic each time the observation is read or modified, so the
+/// statistic has one sample per collection instead of one sample per
+/// increment.
+class StatCounter : public boost::noncopyable {
+public:
+
+    /// @brief Number of shards of a counter.
+    static const size_t SHARDS = 16;
+
+    /// @brief Constructor.
+    ///
+    /// @param name Name of the statistic.
+    explicit StatCounter(const std::string& name);
+
+    /// @brief Returns the name of the statistic.
+    const std::string& getName() const {
+        return (name_);
+    }
+
+    /// @brief Adds a value to the counter.
+    ///
+    /// This method is lock-free and thread safe.
+    ///
+    /// @param value Value to be added.
+    void add(int64_t value = 1) {
+        shards_[getShard()].value_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the pending value of the counter and clears it.
+    ///
+    /// Called to collect the value into the observation of the statistic.
+    ///
+    /// @return Sum of the values added since the last collection.
+    int64_t collect();
+
+private:
+
+    /// @brief Returns the index of the shard of the calling thread.
+    static size_t getShard();
+
+    /// @brief A shard of the counter.
+    ///
+    /// The padding keeps the shards on different cache lines.
+    struct Shard {
+        /// @brief Pending value.
+        std::atomic<int64_t> value_;
+
+        /// @brief Padding up to a (common) cache line size.
+        char padding_[64 - sizeof(std::atomic<int64_t>)];
+    };
+
+    /// @brief Name of the statistic.
+    std::string name_;
+
+    /// @brief The shards.
+    Shard shards_[SHARDS];
+};
+
+/// @brief Pointer to a statistic counter.
+typedef boost::shared_ptr<StatCounter> StatCounterPtr;
+
+}  // namespace stats
+}  // namespace isc
+
+#endif // STAT_COUNTER_H
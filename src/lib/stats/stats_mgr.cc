@@ -11,6 +11,7 @@
 #include <cc/data.h>
 #include <cc/command_interpreter.h>
 #include <util/multi_threading_mgr.h>
+#include <util/encode/base64.h>
 #include <boost/make_shared.hpp>
 #include <chrono>
 
@@ -125,6 +126,7 @@ StatsMgr::getObservation(const string& name) const {
 
 ObservationPtr
 StatsMgr::getObservationInternal(const string& name) const {
+    collectCounterInternal(name);
     /// @todo: Implement contexts.
     // Currently we keep everything in a global context.
     return (global_->get(name));
@@ -145,6 +147,92 @@ StatsMgr::addObservationInternal(const ObservationPtr& stat) {
     /// @todo: Implement contexts.
     // Currently we keep everything in a global context.
     global_->add(stat);
+    if (!counters_.empty() &&
+        (stat->getType() == Observation::STAT_INTEGER)) {
+        auto counter = counters_.find(stat->getName());
+        if (counter != counters_.end()) {
+            stat->setCounter(counter->second);
+        }
+    }
+}
+
+StatCounterPtr
+StatsMgr::getCounter(const string& name) {
+    if (MultiThreadingMgr::instance().getMode()) {
+        lock_guard<mutex> lock(*mutex_);
+        return (getCounterInternal(name));
+    } else {
+        return (getCounterInternal(name));
+    }
+}
+
+StatCounterPtr
+StatsMgr::getCounterInternal(const string& name) {
+    auto existing = counters_.find(name);
+    if (existing != counters_.end()) {
+        return (existing->second);
+    }
+    ObservationPtr obs = global_->get(name);
+    if (obs && (obs->getType() != Observation::STAT_INTEGER)) {
+        isc_throw(InvalidStatType, "Unable to create a counter for "
+                  << Observation::typeToText(obs->getType())
+                  << " statistic " << name);
+    }
+    StatCounterPtr counter = boost::make_shared<StatCounter>(name);
+    counters_.insert(make_pair(name, counter));
+    if (obs) {
+        obs->setCounter(counter);
+    }
+    return (counter);
+}
+
+void
+StatsMgr::collectCounterInternal(const string& name) const {
+    // Avoid the lookup when no counter is used.
+    if (counters_.empty()) {
+        return;
+    }
+    auto counter = counters_.find(name);
+    if (counter != counters_.end()) {
+        collectInternal(counter->second);
+    }
+}
+
+void
+StatsMgr::collectCountersInternal() const {
+    for (auto const& counter : counters_) {
+        collectInternal(counter.second);
+    }
+}
+
+void
+StatsMgr::collectInternal(const StatCounterPtr& counter) const {
+    // An existing observation collects its counter itself.
+    if (global_->get(counter->getName())) {
+        return;
+    }
+    int64_t value = counter->collect();
+    if (value != 0) {
+        // The statistic was removed: recreate it.
+        ObservationPtr obs =
+            boost::make_shared<Observation>(counter->getName(), value);
+        obs->setCounter(counter);
+        global_->add(obs);
+    }
+}
+
+void
+StatsMgr::detachCounterInternal(const string& name) {
+    auto counter = counters_.find(name);
+    if (counter == counters_.end()) {
+        return;
+    }
+    // Discard the pending value.
+    static_cast<void>(counter->second->collect());
+    ObservationPtr obs = global_->get(name);
+    if (obs) {
+        obs->setCounter(StatCounterPtr());
+    }
 }
 
 bool
@@ -159,6 +247,7 @@ StatsMgr::deleteObservation(const string& name) {
 
 bool
 StatsMgr::deleteObservationInternal(const string& name) {
+    detachCounterInternal(name);
     /// @todo: Implement contexts.
     // Currently we keep everything in a global context.
     return (global_->del(name));
@@ -328,6 +417,7 @@ StatsMgr::del(const string& name) {
 
 bool
 StatsMgr::delInternal(const string& name) {
+    detachCounterInternal(name);
     return (global_->del(name));
 }
 
@@ -343,6 +433,9 @@ StatsMgr::removeAll() {
 
 void
 StatsMgr::removeAllInternal() {
+    for (auto const& counter : counters_) {
+        detachCounterInternal(counter.first);
+    }
     global_->clear();
 }
 
@@ -378,9 +471,29 @@ StatsMgr::getAll() const {
 
 ConstElementPtr
 StatsMgr::getAllInternal() const {
+    collectCountersInternal();
     return (global_->getAll());
 }
 
+vector<uint8_t>
+StatsMgr::getAllBinary() const {
+    if (MultiThreadingMgr::instance().getMode()) {
+        lock_guard<mutex> lock(*mutex_);
+        return (getAllBinaryInternal());
+    } else {
+        return (getAllBinaryInternal());
+    }
+}
+
+vector<uint8_t>
+StatsMgr::getAllBinaryInternal() const {
+    collectCountersInternal();
+    OutputBuffer buf(0);
+    global_->getAllBinary(buf);
+    const uint8_t* data = static_cast<const uint8_t*>(buf.getData());
+    return (vector<uint8_t>(data, data + buf.getLength()));
+}
+
 void
 StatsMgr::resetAll() {
     if (MultiThreadingMgr::instance().getMode()) {
@@ -393,6 +506,7 @@ StatsMgr::resetAll() {
 
 void
 StatsMgr::resetAllInternal() {
+    collectCountersInternal();
     global_->resetAll();
 }
 
@@ -427,6 +541,7 @@ StatsMgr::count() const {
 
 size_t
 StatsMgr::countInternal() const {
+    collectCountersInternal();
     return (global_->size());
 }
 
@@ -525,7 +640,29 @@ StatsMgr::statisticRemoveAllHandler(const string& /*name*/,
 
 ConstElementPtr
 StatsMgr::statisticGetAllHandler(const string& /*name*/,
-                                 const ConstElementPtr& /*params*/) {
+                                 const ConstElementPtr& params) {
+    ConstElementPtr format;
+    if (params && (params->getType() == Element::map)) {
+        format = params->get("format");
+    }
+    if (format) {
+        if (format->getType() != Element::string) {
+            return (createAnswer(CONTROL_RESULT_ERROR,
+                                 "'format' parameter expected to be a string."));
+        }
+        if (format->stringValue() == "binary") {
+            ElementPtr answer = Element::createMap();
+            answer->set("format", Element::create(string("binary")));
+            answer->set("data", Element::create(encode::encodeBase64(
+                StatsMgr::instance().getAllBinary())));
+            return (createAnswer(CONTROL_RESULT_SUCCESS, answer));
+        }
+        if (format->stringValue() != "json") {
+            return (createAnswer(CONTROL_RESULT_ERROR,
+                                 "Unsupported format '" +
+                                 format->stringValue() + "'"));
+        }
+    }
     ConstElementPtr all_stats = StatsMgr::instance().getAll();
     return (createAnswer(CONTROL_RESULT_SUCCESS, all_stats));
 }
@@ -9,6 +9,7 @@
 
 #include <stats/observation.h>
 #include <stats/context.h>
+#include <stats/stat_counter.h>
 #include <boost/noncopyable.hpp>
 #include <boost/scoped_ptr.hpp>
 
@@ -128,6 +129,21 @@ public:
     /// @throw InvalidStatType if statistic is not a string
     void addValue(const std::string& name, const std::string& value);
 
+    /// @brief Returns the counter handle of an integer statistic.
+    ///
+    /// The returned counter can be incremented without taking the lock
+    /// of the statistics manager, see @ref StatCounter. Its pending value
+    /// is added to the statistic each time the statistic is read or
+    /// modified, the statistic being created when it does not exist, and
+    /// is discarded when the statistic is removed. The same counter is
+    /// returned for subsequent calls with the same name. The counter
+    /// remains valid when the statistic is removed.
+    ///
+    /// @param name name of the observation
+    /// @return counter handle of the statistic
+    /// @throw InvalidStatType if statistic exists and is not integer
+    StatCounterPtr getCounter(const std::string& name);
+
     /// @brief Determines maximum age of samples.
     ///
     /// Specifies that statistic name should be stored not as a single value,
@@ -243,6 +259,13 @@ public:
     /// @return JSON structures representing all statistics
     isc::data::ConstElementPtr getAll() const;
 
+    /// @brief Returns all statistics in a compact binary form.
+    ///
+    /// See @ref StatContext::getAllBinary for the format.
+    ///
+    /// @return binary form of all statistics
+    std::vector<uint8_t> getAllBinary() const;
+
     /// @}
 
     /// @brief Returns an observation.
@@ -393,10 +416,17 @@ public:
     /// @brief Handles statistic-get-all command
     ///
     /// This method handles statistic-get-all command, which returns values
-    /// of all statistics. Params parameter is ignored.
+    /// of all statistics. When params contains "format" set to "binary"
+    /// the statistics are returned in their compact binary form (see
+    /// @ref getAllBinary) encoded in base64 in the "data" parameter.
+    ///
+    /// Example params structure:
+    /// {
+    ///     "format": "binary"
+    /// }
     ///
     /// @param name name of the command (ignored, should be "statistic-get-all")
-    /// @param params ignored
+    /// @param params optional structure containing "format"
     /// @return answer containing values of all statistic
     static isc::data::ConstElementPtr
     statisticGetAllHandler(const std::string& name,
@@ -552,6 +582,57 @@ private:
 
     /// @private
 
+    /// @brief Returns the counter handle of an integer statistic.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @param name name of the observation
+    /// @return counter handle of the statistic
+    /// @throw InvalidStatType if statistic exists and is not integer
+    StatCounterPtr getCounterInternal(const std::string& name);
+
+    /// @private
+
+    /// @brief Collects the pending value of the counter of a statistic.
+    ///
+    /// Does nothing when there is no counter for the statistic.
+    /// See @ref collectInternal.
+    /// Should be called in a thread safe context.
+    ///
+    /// @param name name of the observation
+    void collectCounterInternal(const std::string& name) const;
+
+    /// @private
+
+    /// @brief Collects the pending values of all counters.
+    ///
+    /// Should be called in a thread safe context.
+    void collectCountersInternal() const;
+
+    /// @private
+
+    /// @brief Collects the pending value of a counter.
+    ///
+    /// The observation of a statistic collects the pending value of its
+    /// counter itself, so this method only recreates the observation of
+    /// a removed statistic with a pending value.
+    /// Should be called in a thread safe context.
+    ///
+    /// @param counter the counter to collect
+    void collectInternal(const StatCounterPtr& counter) const;
+
+    /// @private
+
+    /// @brief Detaches the counter of a removed statistic.
+    ///
+    /// The pending value of the counter is discarded.
+    /// Should be called in a thread safe context.
+    ///
+    /// @param name name of the observation
+    void detachCounterInternal(const std::string& name);
+
+    /// @private
+
     /// @brief Tries to delete an observation.
     ///
     /// Calls @ref deleteObservationInternal() method in a thread safe context.
@@ -717,6 +798,15 @@ private:
 
     /// @private
 
+    /// @brief Returns all statistics in a compact binary form.
+    ///
+    /// Should be called in a thread safe context.
+    ///
+    /// @return binary form of all statistics
+    std::vector<uint8_t> getAllBinaryInternal() const;
+
+    /// @private
+
     /// @brief Utility method that attempts to extract statistic name
     ///
     /// This method attempts to extract statistic name from the params
@@ -779,6 +869,9 @@ private:
     /// @brief This is a global context. All statistics will initially be stored here.
     StatContextPtr global_;
 
+    /// @brief Counter handles of the statistics.
+    std::map<std::string, StatCounterPtr> counters_;
+
     /// @brief The mutex used to protect internal state.
     const boost::scoped_ptr<std::mutex> mutex_;
 };
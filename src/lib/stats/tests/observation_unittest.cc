@@ -8,17 +8,22 @@
 
 #include <stats/observation.h>
 #include <exceptions/exceptions.h>
+#include <util/buffer.h>
 #include <util/chrono_time_utils.h>
 #include <boost/shared_ptr.hpp>
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <iostream>
+#include <list>
 #include <sstream>
+#include <vector>
 
 #include <unistd.h>
 
 using namespace isc;
 using namespace isc::stats;
+using namespace isc::util;
 using namespace std::chrono;
 
 namespace {
@@ -608,6 +613,94 @@ TEST_F(ObservationTest, reset) {
     ASSERT_EQ(d.getSize(), 1);
 }
 
+/// @brief Reads a 64 bit value in network byte order.
+///
+/// @param in buffer to read from
+/// @return the value
+uint64_t readUint64(InputBuffer& in) {
+    uint64_t value = in.readUint32();
+    return ((value << 32) | in.readUint32());
+}
+
+/// @brief Reads the name, the type and the number of samples of a statistic.
+///
+/// @param in buffer to read from
+/// @param name expected name
+/// @param type expected type
+/// @return the number of samples
+uint32_t readHeader(InputBuffer& in, const std::string& name,
+                    Observation::Type type) {
+    size_t name_len = in.readUint16();
+    std::vector<uint8_t> name_data;
+    in.readVector(name_data, name_len);
+    EXPECT_EQ(name, std::string(name_data.begin(), name_data.end()));
+    EXPECT_EQ(type, in.readUint8());
+    return (in.readUint32());
+}
+
+// Checks the binary form of the observations.
+TEST_F(ObservationTest, getBinary) {
+    a.setValue(static_cast<int64_t>(-5));
+    d.setValue("Lorem ipsum");
+
+    OutputBuffer buf(0);
+    ASSERT_NO_THROW(a.getBinary(buf));
+    ASSERT_NO_THROW(b.getBinary(buf));
+    ASSERT_NO_THROW(c.getBinary(buf));
+    ASSERT_NO_THROW(d.getBinary(buf));
+
+    InputBuffer in(buf.getData(), buf.getLength());
+
+    // Integer samples, the most recent first.
+    ASSERT_EQ(2, readHeader(in, "alpha", Observation::STAT_INTEGER));
+    uint64_t timestamp = readUint64(in);
+    EXPECT_EQ(duration_cast<microseconds>(a.getInteger().second.
+                                          time_since_epoch()).count(),
+              timestamp);
+    EXPECT_EQ(-5, static_cast<int64_t>(readUint64(in)));
+    EXPECT_GE(timestamp, readUint64(in));
+    EXPECT_EQ(1234, static_cast<int64_t>(readUint64(in)));
+
+    // Floating point sample.
+    ASSERT_EQ(1, readHeader(in, "beta", Observation::STAT_FLOAT));
+    readUint64(in);
+    uint64_t bits = readUint64(in);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    EXPECT_EQ(12.34, value);
+
+    // Duration sample.
+    ASSERT_EQ(1, readHeader(in, "gamma", Observation::STAT_DURATION));
+    readUint64(in);
+    EXPECT_EQ(duration_cast<microseconds>(dur1234).count(), readUint64(in));
+
+    // String samples.
+    ASSERT_EQ(2, readHeader(in, "delta", Observation::STAT_STRING));
+    readUint64(in);
+    std::vector<uint8_t> data;
+    in.readVector(data, in.readUint32());
+    EXPECT_EQ("Lorem ipsum", std::string(data.begin(), data.end()));
+    readUint64(in);
+    in.readVector(data, in.readUint32());
+    EXPECT_EQ("1234", std::string(data.begin(), data.end()));
+
+    EXPECT_EQ(buf.getLength(), in.getPosition());
+}
+
+// Checks that the count limit is kept while many samples are recorded.
+TEST_F(ObservationTest, manySamples) {
+    ASSERT_NO_THROW(a.setMaxSampleCount(5));
+    for (int64_t i = 0; i < 1000; ++i) {
+        a.setValue(i);
+    }
+    ASSERT_EQ(5, a.getSize());
+    std::list<IntegerSample> samples = a.getIntegers();
+    int64_t expected = 999;
+    for (auto const& sample : samples) {
+        EXPECT_EQ(expected--, sample.first);
+    }
+}
+
 // Checks whether an observation can keep its name.
 TEST_F(ObservationTest, names) {
     EXPECT_EQ("alpha", a.getName());
@@ -616,4 +709,38 @@ TEST_F(ObservationTest, names) {
     EXPECT_EQ("delta", d.getName());
 }
 
+// Checks that the pending value of an attached counter is collected when
+// the observation is read or modified.
+TEST_F(ObservationTest, counter) {
+    StatCounterPtr counter(new StatCounter("alpha"));
+
+    // Only an integer observation can have a counter.
+    EXPECT_THROW(b.setCounter(counter), InvalidStatType);
+    EXPECT_THROW(c.setCounter(counter), InvalidStatType);
+    EXPECT_THROW(d.setCounter(counter), InvalidStatType);
+    ASSERT_NO_THROW(a.setCounter(counter));
+
+    // The pending value is added when the observation is read...
+    counter->add(3);
+    EXPECT_EQ(1237, a.getInteger().first);
+    EXPECT_EQ(2, a.getSize());
+
+    // ... or modified.
+    counter->add(3);
+    a.addValue(static_cast<int64_t>(4));
+    EXPECT_EQ(1244, a.getInteger().first);
+    EXPECT_EQ(4, a.getSize());
+
+    // Reset discards the pending value.
+    counter->add(5);
+    a.reset();
+    EXPECT_EQ(0, a.getInteger().first);
+
+    // Nothing is collected once the counter is detached.
+    ASSERT_NO_THROW(a.setCounter(StatCounterPtr()));
+    counter->add(6);
+    EXPECT_EQ(0, a.getInteger().first);
+    EXPECT_EQ(6, counter->collect());
+}
+
 }
@@ -0,0 +1,109 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/sample_ring.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace isc::stats;
+using namespace std;
+
+namespace {
+
+// Checks that samples are ordered from the most recent one.
+TEST(SampleRingTest, order) {
+    SampleRing<int> ring;
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(SampleRing<int>::UNLIMITED, ring.getCapacity());
+
+    for (int i = 0; i < 10; ++i) {
+        ring.push_front(i);
+        EXPECT_EQ(i, ring.front());
+        EXPECT_EQ(0, ring.back());
+    }
+    ASSERT_EQ(10, ring.size());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(9 - i, ring[i]);
+    }
+
+    // Removing the oldest samples.
+    ring.pop_back();
+    ring.pop_back();
+    ASSERT_EQ(8, ring.size());
+    EXPECT_EQ(9, ring.front());
+    EXPECT_EQ(2, ring.back());
+
+    // Their slots are reused.
+    ring.push_front(10);
+    ASSERT_EQ(9, ring.size());
+    EXPECT_EQ(10, ring.front());
+    EXPECT_EQ(2, ring.back());
+
+    list<int> samples = ring.toList();
+    ASSERT_EQ(9, samples.size());
+    EXPECT_EQ(10, samples.front());
+    EXPECT_EQ(2, samples.back());
+
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    ring.push_front(11);
+    ASSERT_EQ(1, ring.size());
+    EXPECT_EQ(11, ring.front());
+    EXPECT_EQ(11, ring.back());
+}
+
+// Checks that the oldest samples are overwritten when the ring is full.
+TEST(SampleRingTest, capacity) {
+    SampleRing<string> ring(3);
+    EXPECT_EQ(3, ring.getCapacity());
+
+    ring.push_front("a");
+    ring.push_front("b");
+    ring.push_front("c");
+    ring.push_front("d");
+    ASSERT_EQ(3, ring.size());
+    EXPECT_EQ("d", ring[0]);
+    EXPECT_EQ("c", ring[1]);
+    EXPECT_EQ("b", ring[2]);
+
+    for (int i = 0; i < 10; ++i) {
+        ring.push_front(string(1, 'e' + i));
+    }
+    ASSERT_EQ(3, ring.size());
+    EXPECT_EQ("n", ring.front());
+    EXPECT_EQ("l", ring.back());
+
+    // Lowering the capacity removes the oldest samples.
+    ring.setCapacity(2);
+    ASSERT_EQ(2, ring.size());
+    EXPECT_EQ("n", ring.front());
+    EXPECT_EQ("m", ring.back());
+    ring.push_front("o");
+    ASSERT_EQ(2, ring.size());
+    EXPECT_EQ("o", ring.front());
+    EXPECT_EQ("n", ring.back());
+
+    // Raising it keeps the samples.
+    ring.setCapacity(4);
+    ring.push_front("p");
+    ring.push_front("q");
+    ASSERT_EQ(4, ring.size());
+    EXPECT_EQ("q", ring[0]);
+    EXPECT_EQ("p", ring[1]);
+    EXPECT_EQ("o", ring[2]);
+    EXPECT_EQ("n", ring[3]);
+
+    // No sample is held with a zero capacity.
+    ring.setCapacity(0);
+    EXPECT_TRUE(ring.empty());
+    ring.push_front("r");
+    EXPECT_TRUE(ring.empty());
+}
+
+} // end of anonymous namespace
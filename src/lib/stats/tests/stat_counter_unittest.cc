@@ -0,0 +1,62 @@
+// Copyright (C) 2021 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/stat_counter.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace isc::stats;
+using namespace std;
+
+namespace {
+
+// Checks that the values added to a counter are collected once.
+TEST(StatCounterTest, basic) {
+    StatCounter counter("alpha");
+    EXPECT_EQ("alpha", counter.getName());
+
+    // Nothing was added yet.
+    EXPECT_EQ(0, counter.collect());
+
+    counter.add();
+    counter.add(10);
+    counter.add(-3);
+    EXPECT_EQ(8, counter.collect());
+
+    // The collection clears the counter.
+    EXPECT_EQ(0, counter.collect());
+}
+
+// Checks that no value is lost when several threads add to a counter.
+TEST(StatCounterTest, threads) {
+    StatCounter counter("alpha");
+    const int threads = 8;
+    const int iterations = 10000;
+
+    vector<thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.push_back(thread([&counter]() {
+            for (int j = 0; j < iterations; ++j) {
+                counter.add();
+            }
+        }));
+    }
+
+    // Collect concurrently with the increments.
+    int64_t total = counter.collect();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    total += counter.collect();
+
+    EXPECT_EQ(threads * iterations, total);
+}
+
+} // end of anonymous namespace
@@ -10,12 +10,15 @@
 #include <exceptions/exceptions.h>
 #include <cc/data.h>
 #include <cc/command_interpreter.h>
+#include <util/buffer.h>
 #include <util/chrono_time_utils.h>
+#include <util/encode/base64.h>
 #include <boost/shared_ptr.hpp>
 #include <gtest/gtest.h>
 
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 using namespace isc;
 using namespace isc::data;
@@ -521,6 +524,92 @@ TEST_F(StatsMgrTest, removeAll) {
     EXPECT_FALSE(StatsMgr::instance().getObservation("delta"));
 }
 
+// This test checks that the values added to a counter are collected when
+// the statistic is read.
+TEST_F(StatsMgrTest, counter) {
+    StatCounterPtr counter;
+    ASSERT_NO_THROW(counter = StatsMgr::instance().getCounter("counter1"));
+    ASSERT_TRUE(counter);
+
+    // The same counter is returned for the same statistic.
+    EXPECT_EQ(counter, StatsMgr::instance().getCounter("counter1"));
+
+    // The statistic is not created before something is added.
+    EXPECT_FALSE(StatsMgr::instance().getObservation("counter1"));
+    EXPECT_EQ(0, StatsMgr::instance().count());
+
+    counter->add();
+    counter->add(2);
+    ObservationPtr obs = StatsMgr::instance().getObservation("counter1");
+    ASSERT_TRUE(obs);
+    EXPECT_EQ(3, obs->getInteger().first);
+
+    // Values added through the counter and by name are both recorded.
+    counter->add(4);
+    StatsMgr::instance().addValue("counter1", static_cast<int64_t>(5));
+    EXPECT_EQ(12, obs->getInteger().first);
+
+    // Setting the statistic overrides the pending value.
+    counter->add(6);
+    StatsMgr::instance().setValue("counter1", static_cast<int64_t>(1));
+    EXPECT_EQ(1, obs->getInteger().first);
+
+    // Reset discards the pending value.
+    counter->add(7);
+    EXPECT_TRUE(StatsMgr::instance().reset("counter1"));
+    EXPECT_EQ(0, obs->getInteger().first);
+
+    // Pending values are reported by get-all.
+    counter->add(8);
+    ConstElementPtr all = StatsMgr::instance().getAll();
+    ASSERT_TRUE(all);
+    ConstElementPtr samples = all->get("counter1");
+    ASSERT_TRUE(samples);
+    EXPECT_EQ(8, samples->get(0)->get(0)->intValue());
+
+    // Removing the statistic discards the pending value but the counter
+    // remains usable.
+    counter->add(9);
+    EXPECT_TRUE(StatsMgr::instance().del("counter1"));
+    EXPECT_FALSE(StatsMgr::instance().getObservation("counter1"));
+    counter->add(10);
+    obs = StatsMgr::instance().getObservation("counter1");
+    ASSERT_TRUE(obs);
+    EXPECT_EQ(10, obs->getInteger().first);
+
+    // Same after removing all statistics.
+    counter->add(11);
+    StatsMgr::instance().removeAll();
+    EXPECT_EQ(0, StatsMgr::instance().count());
+    counter->add(12);
+    EXPECT_EQ(1, StatsMgr::instance().count());
+    obs = StatsMgr::instance().getObservation("counter1");
+    ASSERT_TRUE(obs);
+    EXPECT_EQ(12, obs->getInteger().first);
+}
+
+// This test checks that a counter can only be used for an integer statistic.
+TEST_F(StatsMgrTest, counterType) {
+    StatsMgr::instance().setValue("counter2", static_cast<int64_t>(1));
+    StatCounterPtr counter;
+    ASSERT_NO_THROW(counter = StatsMgr::instance().getCounter("counter2"));
+    counter->add();
+    EXPECT_EQ(2, StatsMgr::instance().getObservation("counter2")->
+              getInteger().first);
+
+    StatsMgr::instance().setValue("counter3", 12.34);
+    EXPECT_THROW(StatsMgr::instance().getCounter("counter3"), InvalidStatType);
+
+    // The pending value is discarded when the statistic was replaced by
+    // a statistic of another type.
+    counter->add();
+    EXPECT_TRUE(StatsMgr::instance().del("counter2"));
+    StatsMgr::instance().setValue("counter2", 56.78);
+    counter->add();
+    EXPECT_EQ(56.78, StatsMgr::instance().getObservation("counter2")->
+              getFloat().first);
+}
+
 // This is a performance benchmark that checks how long does it take
 // to increment a single statistic million times.
 //
@@ -625,6 +714,26 @@ TEST_F(StatsMgrTest, DISABLED_performanceMultipleSet) {
               << " times took: " << isc::util::durationToText(dur) << std::endl;
 }
 
+// This is a performance benchmark that checks how long does it take
+// to increment a single statistic million times using a counter.
+TEST_F(StatsMgrTest, DISABLED_performanceSingleCounterAdd) {
+    StatsMgr::instance().removeAll();
+
+    uint32_t cycles = 1000000;
+    StatCounterPtr counter = StatsMgr::instance().getCounter("metric2");
+
+    auto before = SampleClock::now();
+    for (uint32_t i = 0; i < cycles; ++i) {
+        counter->add();
+    }
+    auto after = SampleClock::now();
+
+    auto dur = after - before;
+
+    std::cout << "Incrementing a single counter " << cycles << " times took: "
+              << isc::util::durationToText(dur) << std::endl;
+}
+
 // Test checks whether statistics name can be generated using various
 // indexes.
 TEST_F(StatsMgrTest, generateName) {
@@ -742,6 +851,71 @@ TEST_F(StatsMgrTest, commandGetAll) {
     EXPECT_EQ(exp_str_delta, rep_all->get("delta")->str());
 }
 
+// Test checks if statistic-get-all is able to return the binary form of
+// all statistics.
+TEST_F(StatsMgrTest, commandGetAllBinary) {
+    StatsMgr::instance().setValue("alpha", static_cast<int64_t>(1234));
+    StatsMgr::instance().setValue("beta", 12.34);
+
+    // The pending value of a counter is included.
+    StatCounterPtr counter = StatsMgr::instance().getCounter("alpha");
+    counter->add(2);
+
+    ElementPtr params = Element::createMap();
+    params->set("format", Element::create("binary"));
+    ConstElementPtr rsp = StatsMgr::instance().statisticGetAllHandler(
+        "statistic-get-all", params);
+    int status_code;
+    ConstElementPtr rep_all = parseAnswer(status_code, rsp);
+    ASSERT_EQ(CONTROL_RESULT_SUCCESS, status_code);
+    ASSERT_TRUE(rep_all);
+    ASSERT_TRUE(rep_all->get("format"));
+    EXPECT_EQ("binary", rep_all->get("format")->stringValue());
+    ASSERT_TRUE(rep_all->get("data"));
+
+    std::vector<uint8_t> data;
+    ASSERT_NO_THROW(isc::util::encode::decodeBase64(
+        rep_all->get("data")->stringValue(), data));
+    EXPECT_EQ(StatsMgr::instance().getAllBinary(), data);
+
+    // Check the number of statistics and the most recent sample of
+    // the first one.
+    isc::util::InputBuffer in(&data[0], data.size());
+    EXPECT_EQ(2, in.readUint32());
+    size_t name_len = in.readUint16();
+    std::vector<uint8_t> name;
+    in.readVector(name, name_len);
+    EXPECT_EQ("alpha", std::string(name.begin(), name.end()));
+    EXPECT_EQ(Observation::STAT_INTEGER, in.readUint8());
+    EXPECT_EQ(2, in.readUint32());
+    in.readUint32();
+    in.readUint32();
+    EXPECT_EQ(0, in.readUint32());
+    EXPECT_EQ(1236, in.readUint32());
+
+    // The JSON format is the default one.
+    params->set("format", Element::create("json"));
+    rsp = StatsMgr::instance().statisticGetAllHandler("statistic-get-all",
+                                                      params);
+    rep_all = parseAnswer(status_code, rsp);
+    ASSERT_EQ(CONTROL_RESULT_SUCCESS, status_code);
+    ASSERT_TRUE(rep_all);
+    EXPECT_EQ(2, rep_all->size());
+    ASSERT_TRUE(rep_all->get("alpha"));
+
+    // Other formats are rejected.
+    params->set("format", Element::create("xml"));
+    rsp = StatsMgr::instance().statisticGetAllHandler("statistic-get-all",
+                                                      params);
+    parseAnswer(status_code, rsp);
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+    params->set("format", Element::create(1));
+    rsp = StatsMgr::instance().statisticGetAllHandler("statistic-get-all",
+                                                      params);
+    parseAnswer(status_code, rsp);
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+}
+
 // Test checks if statistic-reset handler is able to reset specified statistic.
 TEST_F(StatsMgrTest, commandStatisticReset) {
     StatsMgr::instance().setValue("alpha", static_cast<int64_t>(1234));
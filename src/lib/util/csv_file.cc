@@ -8,10 +8,14 @@
 #include <util/csv_file.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace isc {
 namespace util {
@@ -143,6 +147,23 @@ CSVFile::flush() const {
     fs_->flush();
 }
 
+void
+CSVFile::sync() const {
+    flush();
+    // The file stream doesn't expose its descriptor. Syncing any descriptor
+    // of the file forces the data written through the stream to the disk.
+    int fd = ::open(filename_.c_str(), O_RDONLY);
+    if ((fd < 0) || (fsync(fd) != 0)) {
+        const int err = errno;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        isc_throw(CSVFileError, "unable to sync the file '" << filename_
+                  << "': " << strerror(err));
+    }
+    ::close(fd);
+}
+
 void
 CSVFile::addColumn(const std::string& col_name) {
     // It is not allowed to add a new column when file is open.
@@ -399,6 +399,11 @@ public:
     /// @brief Flushes a file.
     void flush() const;
 
+    /// @brief Flushes a file and forces its content to the storage device.
+    ///
+    /// @throw CSVFileError if the file is not open or can't be synced.
+    void sync() const;
+
     /// @brief Returns the number of columns in the file.
     size_t getColumnCount() const {
         return (cols_.size());
@@ -0,0 +1,120 @@
+// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <util/epoll_event_handler.h>
+
+#include <limits>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace isc {
+namespace util {
+
+EPollEventHandler::EPollEventHandler() : FDEventHandler(TYPE_EPOLL),
+    epollfd_(-1), fds_(), error_(0), events_(), ready_() {
+    open();
+}
+
+EPollEventHandler::~EPollEventHandler() {
+    if (epollfd_ >= 0) {
+        close(epollfd_);
+    }
+}
+
+void
+EPollEventHandler::open() {
+    epollfd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollfd_ < 0) {
+        isc_throw(Unexpected, "failed to create epoll instance: "
+                  << strerror(errno));
+    }
+}
+
+void
+EPollEventHandler::add(int fd) {
+    if (fds_.count(fd)) {
+        return;
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epollfd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+        if ((errno == EBADF) || (errno == EPERM)) {
+            // Report it on the next wait like select() does.
+            error_ = EBADF;
+            return;
+        }
+        isc_throw(Unexpected, "failed to add file descriptor " << fd
+                  << " to epoll instance: " << strerror(errno));
+    }
+    fds_.insert(fd);
+    events_.resize(fds_.size());
+}
+
+int
+EPollEventHandler::waitEvent(uint32_t timeout_sec, uint32_t timeout_usec,
+                             bool use_timeout) {
+    // Sanity check for microsecond timeout.
+    if (timeout_usec >= 1000000) {
+        isc_throw(BadValue, "fractional timeout must be shorter than"
+                  " one million microseconds");
+    }
+
+    ready_.clear();
+
+    if (error_) {
+        errno = error_;
+        return (-1);
+    }
+
+    int timeout = -1;
+    if (use_timeout) {
+        uint64_t timeout_ms = static_cast<uint64_t>(timeout_sec) * 1000 +
+            (timeout_usec + 999) / 1000;
+        if (timeout_ms > std::numeric_limits<int>::max()) {
+            timeout_ms = std::numeric_limits<int>::max();
+        }
+        timeout = static_cast<int>(timeout_ms);
+    }
+
+    // epoll_wait() requires room for at least one event.
+    if (events_.empty()) {
+        events_.resize(1);
+    }
+
+    int result = epoll_wait(epollfd_, &events_[0], events_.size(), timeout);
+    for (int i = 0; i < result; ++i) {
+        ready_.insert(events_[i].data.fd);
+    }
+    return (result);
+}
+
+bool
+EPollEventHandler::readReady(int fd) const {
+    return (ready_.count(fd) > 0);
+}
+
+void
+EPollEventHandler::clear() {
+    // Closing the instance is cheaper than removing the descriptors one by
+    // one and does not fail on descriptors which were already closed.
+    close(epollfd_);
+    epollfd_ = -1;
+    fds_.clear();
+    ready_.clear();
+    error_ = 0;
+    open();
+}
+
+} // end of namespace isc::util
+} // end of namespace isc
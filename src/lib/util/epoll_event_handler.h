@@ -0,0 +1,98 @@
+// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EPOLL_EVENT_HANDLER_H
+#define EPOLL_EVENT_HANDLER_H
+
+#include <util/fd_event_handler.h>
+
+#include <sys/epoll.h>
+
+#include <unordered_set>
+#include <vector>
+
+namespace isc {
+namespace util {
+
+/// @brief File descriptor event handler using epoll().
+///
+/// The registered descriptors form the interest list of an epoll instance
+/// so the kernel does not need to scan all of them on each wait, and there
+/// is no FD_SETSIZE limit on the descriptor values.
+///
+/// A descriptor which can not be registered because it is invalid makes
+/// the next @c waitEvent() calls fail with EBADF until @c clear() is
+/// called, mimicking select(). Note that a descriptor which is closed
+/// after it was registered is silently removed from the interest list by
+/// the kernel: it is the responsibility of the owner to unregister it.
+class EPollEventHandler : public FDEventHandler {
+public:
+    /// @brief Constructor.
+    ///
+    /// @throw Unexpected if the epoll instance can not be created.
+    EPollEventHandler();
+
+    /// @brief Destructor.
+    ///
+    /// Closes the epoll instance.
+    virtual ~EPollEventHandler();
+
+    /// @brief Registers a file descriptor for read events.
+    ///
+    /// Registering the same descriptor twice has no effect.
+    ///
+    /// @param fd The file descriptor.
+    /// @throw Unexpected if the descriptor can not be registered for
+    /// another reason than being invalid.
+    virtual void add(int fd);
+
+    /// @brief Waits for events on the registered file descriptors.
+    ///
+    /// epoll has a millisecond resolution: the timeout is rounded up to
+    /// the next millisecond.
+    ///
+    /// @param timeout_sec The timeout (in seconds).
+    /// @param timeout_usec The timeout (in microseconds).
+    /// @param use_timeout Wait indefinitely when false.
+    /// @return The epoll_wait() result.
+    virtual int waitEvent(uint32_t timeout_sec, uint32_t timeout_usec = 0,
+                          bool use_timeout = true);
+
+    /// @brief Checks if a file descriptor is ready to read.
+    ///
+    /// @param fd The file descriptor.
+    /// @return True if the descriptor is ready to read.
+    virtual bool readReady(int fd) const;
+
+    /// @brief Unregisters all file descriptors.
+    ///
+    /// @throw Unexpected if a new epoll instance can not be created.
+    virtual void clear();
+
+private:
+    /// @brief Creates the epoll instance.
+    void open();
+
+    /// @brief The epoll instance descriptor.
+    int epollfd_;
+
+    /// @brief The registered file descriptors.
+    std::unordered_set<int> fds_;
+
+    /// @brief Last registration error (errno value), 0 when none.
+    int error_;
+
+    /// @brief The events returned by the last epoll_wait() call.
+    std::vector<struct epoll_event> events_;
+
+    /// @brief The descriptors reported as ready by the last wait.
+    std::unordered_set<int> ready_;
+};
+
+} // end of namespace isc::util
+} // end of namespace isc
+
+#endif // EPOLL_EVENT_HANDLER_H
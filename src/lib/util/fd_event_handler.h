@@ -0,0 +1,88 @@
+// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef FD_EVENT_HANDLER_H
+#define FD_EVENT_HANDLER_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <stdint.h>
+
+namespace isc {
+namespace util {
+
+/// @brief File descriptor event handler interface.
+///
+/// An event handler holds a persistent set of file descriptors to be
+/// monitored for read readiness. Descriptors are registered once using
+/// @c add() and stay registered until @c clear() is called, so callers
+/// waiting on the same descriptors repeatedly do not need to rebuild the
+/// set before each wait.
+class FDEventHandler : public boost::noncopyable {
+public:
+    /// @brief Types of the supported event handlers.
+    enum HandlerType {
+        TYPE_UNKNOWN = 0, ///< Unknown or unsupported type.
+        TYPE_SELECT = 1,  ///< select() based handler.
+        TYPE_EPOLL = 2    ///< epoll() based handler (Linux only).
+    };
+
+    /// @brief Constructor.
+    ///
+    /// @param type The type of the handler.
+    FDEventHandler(HandlerType type = TYPE_UNKNOWN) : type_(type) {
+    }
+
+    /// @brief Destructor.
+    virtual ~FDEventHandler() = default;
+
+    /// @brief Registers a file descriptor for read events.
+    ///
+    /// @param fd The file descriptor.
+    virtual void add(int fd) = 0;
+
+    /// @brief Waits for events on the registered file descriptors.
+    ///
+    /// Like select() it returns the number of ready descriptors, 0 on
+    /// timeout or -1 on error with errno set accordingly. In particular
+    /// errno is EINTR when the wait was interrupted by a signal and EBADF
+    /// when an invalid descriptor was registered.
+    ///
+    /// @param timeout_sec The timeout (in seconds).
+    /// @param timeout_usec The timeout (in microseconds).
+    /// @param use_timeout Wait indefinitely when false.
+    /// @return The number of ready descriptors, 0 or -1.
+    virtual int waitEvent(uint32_t timeout_sec, uint32_t timeout_usec = 0,
+                          bool use_timeout = true) = 0;
+
+    /// @brief Checks if a file descriptor was reported as ready to read
+    /// by the last @c waitEvent() call.
+    ///
+    /// @param fd The file descriptor.
+    /// @return True if the descriptor is ready to read.
+    virtual bool readReady(int fd) const = 0;
+
+    /// @brief Unregisters all file descriptors.
+    virtual void clear() = 0;
+
+    /// @brief Returns the type of the handler.
+    HandlerType type() const {
+        return (type_);
+    }
+
+private:
+    /// @brief The type of the handler.
+    HandlerType type_;
+};
+
+/// @brief Pointer to an event handler.
+typedef boost::shared_ptr<FDEventHandler> FDEventHandlerPtr;
+
+} // end of namespace isc::util
+} // end of namespace isc
+
+#endif // FD_EVENT_HANDLER_H
@@ -0,0 +1,72 @@
+// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <exceptions/exceptions.h>
+#include <util/fd_event_handler_factory.h>
+#include <util/select_event_handler.h>
+#if defined (OS_LINUX)
+#include <util/epoll_event_handler.h>
+#endif
+
+namespace isc {
+namespace util {
+
+FDEventHandlerPtr
+FDEventHandlerFactory::factoryFDEventHandler(FDEventHandler::HandlerType type) {
+    switch (type) {
+    case FDEventHandler::TYPE_SELECT:
+        return (FDEventHandlerPtr(new SelectEventHandler()));
+#if defined (OS_LINUX)
+    case FDEventHandler::TYPE_EPOLL:
+        return (FDEventHandlerPtr(new EPollEventHandler()));
+#endif
+    default:
+        isc_throw(NotImplemented, "event handler type '"
+                  << typeToText(type) << "' is not supported on this system");
+    }
+}
+
+bool
+FDEventHandlerFactory::isSupported(FDEventHandler::HandlerType type) {
+    switch (type) {
+    case FDEventHandler::TYPE_SELECT:
+        return (true);
+#if defined (OS_LINUX)
+    case FDEventHandler::TYPE_EPOLL:
+        return (true);
+#endif
+    default:
+        return (false);
+    }
+}
+
+FDEventHandler::HandlerType
+FDEventHandlerFactory::typeFromText(const std::string& name) {
+    if (name == "select") {
+        return (FDEventHandler::TYPE_SELECT);
+    } else if (name == "epoll") {
+        return (FDEventHandler::TYPE_EPOLL);
+    }
+    isc_throw(BadValue, "unknown event handler type '" << name
+              << "', supported types are 'select' and 'epoll'");
+}
+
+std::string
+FDEventHandlerFactory::typeToText(FDEventHandler::HandlerType type) {
+    switch (type) {
+    case FDEventHandler::TYPE_SELECT:
+        return ("select");
+    case FDEventHandler::TYPE_EPOLL:
+        return ("epoll");
+    default:
+        return ("unknown");
+    }
+}
+
+} // end of namespace isc::util
+} // end of namespace isc
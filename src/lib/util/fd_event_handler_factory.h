@@ -0,0 +1,52 @@
+// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef FD_EVENT_HANDLER_FACTORY_H
+#define FD_EVENT_HANDLER_FACTORY_H
+
+#include <util/fd_event_handler.h>
+
+#include <string>
+
+namespace isc {
+namespace util {
+
+/// @brief File descriptor event handler factory.
+class FDEventHandlerFactory {
+public:
+    /// @brief Creates an event handler of the given type.
+    ///
+    /// @param type The type of the handler.
+    /// @return Pointer to the new handler.
+    /// @throw NotImplemented if the type is not supported on this system.
+    static FDEventHandlerPtr
+    factoryFDEventHandler(FDEventHandler::HandlerType type =
+                          FDEventHandler::TYPE_SELECT);
+
+    /// @brief Checks if a handler type is supported on this system.
+    ///
+    /// @param type The type of the handler.
+    /// @return True if handlers of this type can be created.
+    static bool isSupported(FDEventHandler::HandlerType type);
+
+    /// @brief Converts a handler name to a handler type.
+    ///
+    /// @param name The handler name, "select" or "epoll".
+    /// @return The handler type.
+    /// @throw BadValue if the name is not recognized.
+    static FDEventHandler::HandlerType typeFromText(const std::string& name);
+
+    /// @brief Converts a handler type to its name.
+    ///
+    /// @param type The handler type.
+    /// @return The handler name.
+    static std::string typeToText(FDEventHandler::HandlerType type);
+};
+
+} // end of namespace isc::util
+} // end of namespace isc
+
+#endif // FD_EVENT_HANDLER_FACTORY_H
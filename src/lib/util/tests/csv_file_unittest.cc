@@ -380,6 +380,7 @@ TEST_F(CSVFileTest, openReadAllWrite) {
     // Any attempt to read from the file or write to it should now fail.
     EXPECT_FALSE(csv->next(row));
     EXPECT_THROW(csv->append(row_write), CSVFileError);
+    EXPECT_THROW(csv->sync(), CSVFileError);
 
     CSVRow row_write2(3);
     row_write2.writeAt(0, "bird");
@@ -395,7 +396,7 @@ TEST_F(CSVFileTest, openReadAllWrite) {
     EXPECT_EQ(CSVFile::EMPTY_ROW(), row);
     // We should be able to append new data.
     ASSERT_NO_THROW(csv->append(row_write2));
-    ASSERT_NO_THROW(csv->flush());
+    ASSERT_NO_THROW(csv->sync());
     csv->close();
     // Check that new data has been appended.
     EXPECT_EQ("animal,age,color\n"
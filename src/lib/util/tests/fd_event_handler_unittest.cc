@@ -0,0 +1,176 @@
+// Copyright (C) 2020 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <exceptions/exceptions.h>
+#include <util/fd_event_handler_factory.h>
+
+#include <gtest/gtest.h>
+
+#include <errno.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+#include <vector>
+
+using namespace std;
+using namespace isc;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Test fixture for the event handlers.
+///
+/// It opens two pipes whose read ends are monitored by the handlers.
+class FDEventHandlerTest : public ::testing::Test {
+public:
+    /// @brief Constructor.
+    FDEventHandlerTest() {
+        EXPECT_EQ(0, pipe(pipe1_));
+        EXPECT_EQ(0, pipe(pipe2_));
+    }
+
+    /// @brief Destructor.
+    virtual ~FDEventHandlerTest() {
+        close(pipe1_[0]);
+        close(pipe1_[1]);
+        close(pipe2_[0]);
+        close(pipe2_[1]);
+    }
+
+    /// @brief Returns the handler types supported on this system.
+    vector<FDEventHandler::HandlerType> supportedTypes() const {
+        vector<FDEventHandler::HandlerType> types;
+        if (FDEventHandlerFactory::isSupported(FDEventHandler::TYPE_SELECT)) {
+            types.push_back(FDEventHandler::TYPE_SELECT);
+        }
+        if (FDEventHandlerFactory::isSupported(FDEventHandler::TYPE_EPOLL)) {
+            types.push_back(FDEventHandler::TYPE_EPOLL);
+        }
+        return (types);
+    }
+
+    /// @brief First pipe.
+    int pipe1_[2];
+
+    /// @brief Second pipe.
+    int pipe2_[2];
+};
+
+// Verifies the handler type conversions.
+TEST_F(FDEventHandlerTest, typeConversions) {
+    EXPECT_EQ(FDEventHandler::TYPE_SELECT,
+              FDEventHandlerFactory::typeFromText("select"));
+    EXPECT_EQ(FDEventHandler::TYPE_EPOLL,
+              FDEventHandlerFactory::typeFromText("epoll"));
+    EXPECT_THROW(FDEventHandlerFactory::typeFromText("poll"), BadValue);
+    EXPECT_EQ("select",
+              FDEventHandlerFactory::typeToText(FDEventHandler::TYPE_SELECT));
+    EXPECT_EQ("epoll",
+              FDEventHandlerFactory::typeToText(FDEventHandler::TYPE_EPOLL));
+    EXPECT_EQ("unknown",
+              FDEventHandlerFactory::typeToText(FDEventHandler::TYPE_UNKNOWN));
+
+    // select() is supported everywhere.
+    EXPECT_TRUE(FDEventHandlerFactory::isSupported(FDEventHandler::TYPE_SELECT));
+    EXPECT_FALSE(FDEventHandlerFactory::isSupported(FDEventHandler::TYPE_UNKNOWN));
+    EXPECT_THROW(FDEventHandlerFactory::factoryFDEventHandler(FDEventHandler::TYPE_UNKNOWN),
+                 NotImplemented);
+#if defined (OS_LINUX)
+    EXPECT_TRUE(FDEventHandlerFactory::isSupported(FDEventHandler::TYPE_EPOLL));
+#endif
+}
+
+// Verifies that the registered descriptors are reported ready once
+// they have data to read and that they stay registered across waits.
+TEST_F(FDEventHandlerTest, waitEvent) {
+    for (auto type : supportedTypes()) {
+        SCOPED_TRACE(FDEventHandlerFactory::typeToText(type));
+        FDEventHandlerPtr handler;
+        ASSERT_NO_THROW(handler = FDEventHandlerFactory::factoryFDEventHandler(type));
+        ASSERT_TRUE(handler);
+        EXPECT_EQ(type, handler->type());
+
+        handler->add(pipe1_[0]);
+        handler->add(pipe2_[0]);
+
+        // Nothing to read: the wait times out.
+        EXPECT_EQ(0, handler->waitEvent(0, 1000));
+        EXPECT_FALSE(handler->readReady(pipe1_[0]));
+        EXPECT_FALSE(handler->readReady(pipe2_[0]));
+
+        // Write to the second pipe.
+        ASSERT_EQ(1, write(pipe2_[1], "x", 1));
+        EXPECT_EQ(1, handler->waitEvent(1));
+        EXPECT_FALSE(handler->readReady(pipe1_[0]));
+        EXPECT_TRUE(handler->readReady(pipe2_[0]));
+
+        // The set is persistent: the descriptor is still reported.
+        ASSERT_EQ(1, write(pipe1_[1], "x", 1));
+        EXPECT_EQ(2, handler->waitEvent(1));
+        EXPECT_TRUE(handler->readReady(pipe1_[0]));
+        EXPECT_TRUE(handler->readReady(pipe2_[0]));
+
+        // Drain the pipes.
+        char buf;
+        ASSERT_EQ(1, read(pipe1_[0], &buf, 1));
+        ASSERT_EQ(1, read(pipe2_[0], &buf, 1));
+        EXPECT_EQ(0, handler->waitEvent(0, 1000));
+        EXPECT_FALSE(handler->readReady(pipe1_[0]));
+        EXPECT_FALSE(handler->readReady(pipe2_[0]));
+
+        // After clear() nothing is monitored.
+        ASSERT_EQ(1, write(pipe1_[1], "x", 1));
+        handler->clear();
+        EXPECT_EQ(0, handler->waitEvent(0, 1000));
+        EXPECT_FALSE(handler->readReady(pipe1_[0]));
+
+        // Registered again it is reported.
+        handler->add(pipe1_[0]);
+        EXPECT_EQ(1, handler->waitEvent(0, 0, false));
+        EXPECT_TRUE(handler->readReady(pipe1_[0]));
+        ASSERT_EQ(1, read(pipe1_[0], &buf, 1));
+
+        // Fractional timeout must be below one second.
+        EXPECT_THROW(handler->waitEvent(0, 1000000), BadValue);
+    }
+}
+
+// Verifies that an invalid descriptor makes the wait fail with EBADF.
+TEST_F(FDEventHandlerTest, badDescriptor) {
+    for (auto type : supportedTypes()) {
+        SCOPED_TRACE(FDEventHandlerFactory::typeToText(type));
+        FDEventHandlerPtr handler =
+            FDEventHandlerFactory::factoryFDEventHandler(type);
+
+        int fds[2];
+        ASSERT_EQ(0, pipe(fds));
+        close(fds[0]);
+        close(fds[1]);
+
+        handler->add(pipe1_[0]);
+        handler->add(fds[0]);
+        errno = 0;
+        EXPECT_EQ(-1, handler->waitEvent(0, 1000));
+        EXPECT_EQ(EBADF, errno);
+
+        // Clearing the set recovers.
+        handler->clear();
+        handler->add(pipe1_[0]);
+        EXPECT_EQ(0, handler->waitEvent(0, 1000));
+    }
+}
+
+// Verifies that select() refuses descriptors it can not handle.
+TEST_F(FDEventHandlerTest, selectLimits) {
+    FDEventHandlerPtr handler =
+        FDEventHandlerFactory::factoryFDEventHandler(FDEventHandler::TYPE_SELECT);
+    EXPECT_THROW(handler->add(-1), BadValue);
+    EXPECT_THROW(handler->add(FD_SETSIZE), BadValue);
+    EXPECT_FALSE(handler->readReady(FD_SETSIZE));
+}
+
+} // end of anonymous namespace